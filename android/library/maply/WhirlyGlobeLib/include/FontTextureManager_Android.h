@@ -59,12 +59,23 @@ protected:
     // Find the appropriate font manager
     FontManager_AndroidRef findFontManagerForFont(PlatformInfo_Android *threadInfo,jobject typefaceObj,const LabelInfo &labelInfo);
 
+    // Distance field glyphs only depend on the typeface, so that's all we look for
+    FontManager_AndroidRef findSDFFontManagerForFont(PlatformInfo_Android *threadInfo,const LabelInfoAndroid *labelInfo);
+
+    // Lay out a string with distance field glyphs.  Call with the lock held.
+    DrawableString *addStringSDF(PlatformInfo_Android *threadInfo,const std::vector<int> &codePoints,const LabelInfoAndroid *labelInfo,ChangeSet &changes);
+
+    // Render the given glyphs at the reference size and turn them into distance fields
+    void renderSDFGlyphs(PlatformInfo_Android *threadInfo,FontManager_AndroidRef fm,const LabelInfoAndroid *labelInfo,const std::vector<WKGlyph> &glyphs,ChangeSet &changes);
+
+    virtual Texture *makeGlyphTexture(RawData *data,int width,int height);
+
     // Render the glyph with the given font manager
 //    RawDataRef renderGlyph(WKGlyph glyph,FontManageriOS *fm,Point2f &size,Point2f &glyphSize,Point2f &offset,Point2f &textureOffset);
 
     // Java object that can do the character rendering for us
     jobject charRenderObj;
-    jmethodID renderMethodID;
+    jmethodID renderMethodID,renderSDFMethodID,fontKeyMethodID;
     jfieldID bitmapID,sizeXID,sizeYID,glyphSizeXID,glyphSizeYID,offsetXID,offsetYID,textureOffsetXID,textureOffsetYID;
 };
 
@@ -46,7 +46,7 @@ public:
     virtual Texture *buildTexture();
 
     // Build and cache the texture for later
-    Texture *prebuildTexture();
+    virtual Texture *prebuildTexture();
 
     /// Stop keeping track of texture if you were
     virtual void clearTexture();
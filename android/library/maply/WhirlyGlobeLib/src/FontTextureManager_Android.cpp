@@ -22,6 +22,7 @@
 #import "LabelInfo_Android.h"
 #import "LabelsAndMarkers_jni.h"
 #import <android/bitmap.h>
+#import <algorithm>
 
 namespace WhirlyKit
 {
@@ -58,6 +59,8 @@ FontTextureManager_Android::FontTextureManager_Android(JNIEnv *env,SceneRenderer
 	charRenderObj = env->NewGlobalRef(inCharRenderObj);
 	jclass charRenderClass =  env->GetObjectClass(charRenderObj);
 	renderMethodID = env->GetMethodID(charRenderClass, "renderChar", "(ILcom/mousebird/maply/LabelInfo;F)Lcom/mousebird/maply/CharRenderer$Glyph;");
+	renderSDFMethodID = env->GetMethodID(charRenderClass, "renderSDFChar", "(ILcom/mousebird/maply/LabelInfo;F)Lcom/mousebird/maply/CharRenderer$Glyph;");
+	fontKeyMethodID = env->GetMethodID(charRenderClass, "fontKey", "(Lcom/mousebird/maply/LabelInfo;F)Ljava/lang/String;");
 	jclass glyphClass = env->FindClass("com/mousebird/maply/CharRenderer$Glyph");
 	bitmapID = env->GetFieldID(glyphClass,"bitmap","Landroid/graphics/Bitmap;");
 	sizeXID = env->GetFieldID(glyphClass,"sizeX","F");
@@ -87,12 +90,20 @@ DrawableString *FontTextureManager_Android::addString(PlatformThreadInfo *inThre
     // If not initialized, set up texture atlas and such
     init();
 
-    DrawableString *drawString = new DrawableString();
-    DrawStringRep *drawStringRep = new DrawStringRep(drawString->getId());
+    if (sdfMode)
+        return addStringSDF(threadInfo,codePoints,labelInfo,changes);
 
     // Look for the font manager that manages the typeface/attribute combo we need
     FontManager_AndroidRef fm = findFontManagerForFont(threadInfo,labelInfo->typefaceObj,*labelInfo);
 
+    // If we've laid this out before, we don't need to go through Java
+    const std::vector<WKGlyph> runKey(codePoints.begin(),codePoints.end());
+    if (DrawableString *cachedString = findGlyphRun(fm,runKey))
+        return cachedString;
+
+    DrawableString *drawString = new DrawableString();
+    DrawStringRep *drawStringRep = new DrawStringRep(drawString->getId());
+
 	JavaIntegerClassInfo *intClassInfo = JavaIntegerClassInfo::getClassInfo(threadInfo->env);
 
     // Work through the characters
@@ -193,10 +204,13 @@ DrawableString *FontTextureManager_Android::addString(PlatformThreadInfo *inThre
         delete drawString;
         delete drawStringRep;
         drawString = NULL;
-    }
+    } else {
+        // We need to track the glyphs we're using
+        drawStringReps.insert(drawStringRep);
 
-    // We need to track the glyphs we're using
-    drawStringReps.insert(drawStringRep);
+        // Keep the layout for the next time we see this string
+        addGlyphRun(fm,runKey,drawString,glyphsUsed,changes);
+    }
 
     return drawString;
 }
@@ -229,4 +243,173 @@ FontTextureManager_Android::FontManager_AndroidRef FontTextureManager_Android::f
 	return fm;
 }
 
+FontTextureManager_Android::FontManager_AndroidRef FontTextureManager_Android::findSDFFontManagerForFont(PlatformInfo_Android *threadInfo,const LabelInfoAndroid *labelInfo)
+{
+	for (auto it : fontManagers)
+	{
+		FontManager_AndroidRef fm = std::dynamic_pointer_cast<FontManager_Android>(it.second);
+		if (labelInfo->typefaceIsSame(threadInfo,fm->typefaceObj))
+			return fm;
+	}
+
+	FontManager_AndroidRef fm(new FontManager_Android(threadInfo->env,labelInfo->typefaceObj));
+	fm->pointSize = sdfRefSize;
+
+	// The cache file is keyed on something that'll be the same next time
+	jstring keyObj = (jstring)threadInfo->env->CallObjectMethod(charRenderObj,fontKeyMethodID,labelInfo->labelInfoObj,sdfRefSize);
+	if (keyObj)
+	{
+		JavaString key(threadInfo->env,keyObj);
+		fm->fontName = key.cStr;
+		threadInfo->env->DeleteLocalRef(keyObj);
+	}
+	fontManagers[fm->getId()] = fm;
+
+	return fm;
+}
+
+void FontTextureManager_Android::renderSDFGlyphs(PlatformInfo_Android *threadInfo,FontManager_AndroidRef fm,const LabelInfoAndroid *labelInfo,const std::vector<WKGlyph> &glyphs,ChangeSet &changes)
+{
+	JNIEnv *env = threadInfo->env;
+
+	// Pull the coverage out of each bitmap.  The fields are then built all at once.
+	std::vector<std::vector<unsigned char> > coverage;
+	std::vector<SDFSource> sources;
+	std::vector<SDFGlyph> sdfGlyphs;
+	std::vector<WKGlyph> sdfGlyphIDs;
+	coverage.reserve(glyphs.size());
+	for (WKGlyph glyph : glyphs)
+	{
+		jobject glyphObj = env->CallObjectMethod(charRenderObj,renderSDFMethodID,(int)glyph,labelInfo->labelInfoObj,sdfRefSize);
+		if (!glyphObj)
+		{
+			wkLogLevel(Warn,"Bad glyph passed into FontTextureManager_Android: %d",glyph);
+			continue;
+		}
+		jobject bitmapObj = env->GetObjectField(glyphObj,bitmapID);
+
+		AndroidBitmapInfo info;
+		void *bitmapPixels = NULL;
+		if (bitmapObj && AndroidBitmap_getInfo(env, bitmapObj, &info) >= 0 &&
+			AndroidBitmap_lockPixels(env, bitmapObj, &bitmapPixels) >= 0)
+		{
+			// RGBA, so alpha is the fourth byte
+			coverage.push_back(std::vector<unsigned char>(info.width*info.height));
+			std::vector<unsigned char> &alpha = coverage.back();
+			for (unsigned int y=0;y<info.height;y++)
+			{
+				const unsigned char *row = (const unsigned char *)bitmapPixels + y*info.stride;
+				for (unsigned int x=0;x<info.width;x++)
+					alpha[y*info.width+x] = row[4*x+3];
+			}
+			AndroidBitmap_unlockPixels(env, bitmapObj);
+
+			SDFSource source;
+			source.coverage = alpha.data();
+			source.width = info.width;
+			source.height = info.height;
+			source.pixelStride = 1;
+			source.rowBytes = info.width;
+			sources.push_back(source);
+
+			SDFGlyph sdfGlyph;
+			sdfGlyph.width = info.width + 2*sdfSpread;
+			sdfGlyph.height = info.height + 2*sdfSpread;
+			sdfGlyph.size = Point2f(env->GetFloatField(glyphObj,glyphSizeXID),env->GetFloatField(glyphObj,glyphSizeYID));
+			sdfGlyph.offset = Point2f(env->GetFloatField(glyphObj,offsetXID),env->GetFloatField(glyphObj,offsetYID));
+			sdfGlyph.textureOffset = Point2f(env->GetFloatField(glyphObj,textureOffsetXID)+sdfSpread,env->GetFloatField(glyphObj,textureOffsetYID)+sdfSpread);
+			sdfGlyphs.push_back(sdfGlyph);
+			sdfGlyphIDs.push_back(glyph);
+		}
+
+		if (bitmapObj)
+			env->DeleteLocalRef(bitmapObj);
+		env->DeleteLocalRef(glyphObj);
+	}
+	if (sources.empty())
+		return;
+
+	std::vector<std::vector<unsigned char> > fields;
+	GenerateSignedDistanceFields(sources, sdfSpread, fields);
+
+	for (unsigned int ii=0;ii<sdfGlyphs.size();ii++)
+	{
+		sdfGlyphs[ii].field.swap(fields[ii]);
+		addSDFGlyph(fm, fm->fontName, sdfGlyphIDs[ii], sdfGlyphs[ii], changes);
+	}
+}
+
+DrawableString *FontTextureManager_Android::addStringSDF(PlatformInfo_Android *threadInfo,const std::vector<int> &codePoints,const LabelInfoAndroid *labelInfo,ChangeSet &changes)
+{
+	FontManager_AndroidRef fm = findSDFFontManagerForFont(threadInfo,labelInfo);
+
+	// Layouts are kept at the reference size and scaled on the way out
+	const std::vector<WKGlyph> runKey(codePoints.begin(),codePoints.end());
+	if (DrawableString *cachedString = findGlyphRun(fm,runKey))
+	{
+		scaleSDFString(cachedString,labelInfo->fontSize);
+		return cachedString;
+	}
+
+	// Take what we can from the distance field cache and render the rest in one go
+	std::vector<WKGlyph> toRender;
+	for (WKGlyph glyph : runKey)
+		if (!fm->findGlyph(glyph) && !addCachedSDFGlyph(fm,fm->fontName,glyph,changes) &&
+			std::find(toRender.begin(),toRender.end(),glyph) == toRender.end())
+			toRender.push_back(glyph);
+	if (!toRender.empty())
+		renderSDFGlyphs(threadInfo,fm,labelInfo,toRender,changes);
+
+	DrawableString *drawString = new DrawableString();
+	GlyphSet glyphsUsed;
+	float offsetX = 0.0;
+	for (WKGlyph glyph : runKey)
+	{
+		FontManager::GlyphInfo *glyphInfo = fm->findGlyph(glyph);
+		if (!glyphInfo)
+			continue;
+
+		DrawableString::Rect rect;
+		Point2f offset(offsetX,0.0);
+		rect.pts[0] = glyphInfo->offset - glyphInfo->textureOffset + offset;
+		rect.texCoords[0] = TexCoord(0.0,1.0);
+		rect.pts[1] = glyphInfo->size + 2*glyphInfo->textureOffset + rect.pts[0];
+		rect.texCoords[1] = TexCoord(1.0,0.0);
+
+		rect.subTex = glyphInfo->subTex;
+		drawString->glyphPolys.push_back(rect);
+		drawString->mbr.addPoint(rect.pts[0]);
+		drawString->mbr.addPoint(rect.pts[1]);
+
+		glyphsUsed.insert(glyphInfo->glyph);
+
+		// The field's padding overlaps the next glyph
+		offsetX += rect.pts[1].x()-rect.pts[0].x() - 2*sdfSpread;
+	}
+
+	if (drawString->glyphPolys.empty())
+	{
+		delete drawString;
+		return NULL;
+	}
+
+	DrawStringRep *drawStringRep = new DrawStringRep(drawString->getId());
+	drawStringRep->addGlyphs(fm->getId(),glyphsUsed);
+	fm->addGlyphRefs(glyphsUsed);
+	drawStringReps.insert(drawStringRep);
+
+	addGlyphRun(fm,runKey,drawString,glyphsUsed,changes);
+	scaleSDFString(drawString,labelInfo->fontSize);
+
+	return drawString;
+}
+
+Texture *FontTextureManager_Android::makeGlyphTexture(RawData *data,int width,int height)
+{
+	TextureGLES *tex = new TextureGLES("FontTextureManager");
+	tex->setRawData(data,width,height);
+
+	return tex;
+}
+
 }
@@ -31,6 +31,22 @@ JNIEXPORT jboolean JNICALL Java_com_mousebird_maply_MapboxVectorTileParser_parse
 JNIEXPORT void JNICALL Java_com_mousebird_maply_MapboxVectorTileParser_setLocalCoords
   (JNIEnv *, jobject, jboolean);
 
+/*
+ * Class:     com_mousebird_maply_MapboxVectorTileParser
+ * Method:    setGeometryCacheNative
+ * Signature: (JJLjava/lang/String;)V
+ */
+JNIEXPORT void JNICALL Java_com_mousebird_maply_MapboxVectorTileParser_setGeometryCacheNative
+  (JNIEnv *, jobject, jlong, jlong, jstring);
+
+/*
+ * Class:     com_mousebird_maply_MapboxVectorTileParser
+ * Method:    getGeometryCacheHitRate
+ * Signature: ()D
+ */
+JNIEXPORT jdouble JNICALL Java_com_mousebird_maply_MapboxVectorTileParser_getGeometryCacheHitRate
+  (JNIEnv *, jobject);
+
 /*
  * Class:     com_mousebird_maply_MapboxVectorTileParser
  * Method:    initialise
@@ -111,6 +111,22 @@ JNIEXPORT jint JNICALL Java_com_mousebird_maply_ParticleSystem_getBatchSize
 JNIEXPORT void JNICALL Java_com_mousebird_maply_ParticleSystem_setContinuousUpdate
   (JNIEnv *, jobject, jboolean);
 
+/*
+ * Class:     com_mousebird_maply_ParticleSystem
+ * Method:    setCPUCalculation
+ * Signature: (Z)V
+ */
+JNIEXPORT void JNICALL Java_com_mousebird_maply_ParticleSystem_setCPUCalculation
+  (JNIEnv *, jobject, jboolean);
+
+/*
+ * Class:     com_mousebird_maply_ParticleSystem
+ * Method:    setCPUThreads
+ * Signature: (I)V
+ */
+JNIEXPORT void JNICALL Java_com_mousebird_maply_ParticleSystem_setCPUThreads
+  (JNIEnv *, jobject, jint);
+
 /*
  * Class:     com_mousebird_maply_ParticleSystem
  * Method:    setDrawPriority
@@ -79,6 +79,22 @@ JNIEXPORT void JNICALL Java_com_mousebird_maply_QuadImageLoaderBase_setRenderTar
 JNIEXPORT void JNICALL Java_com_mousebird_maply_QuadImageLoaderBase_setImageFormatNative
   (JNIEnv *, jobject, jint);
 
+/*
+ * Class:     com_mousebird_maply_QuadImageLoaderBase
+ * Method:    setTextureCompressionNative
+ * Signature: (I)V
+ */
+JNIEXPORT void JNICALL Java_com_mousebird_maply_QuadImageLoaderBase_setTextureCompressionNative
+  (JNIEnv *, jobject, jint);
+
+/*
+ * Class:     com_mousebird_maply_QuadImageLoaderBase
+ * Method:    setTextureMipmaps
+ * Signature: (ZZ)V
+ */
+JNIEXPORT void JNICALL Java_com_mousebird_maply_QuadImageLoaderBase_setTextureMipmaps
+  (JNIEnv *, jobject, jboolean, jboolean);
+
 /*
  * Class:     com_mousebird_maply_QuadImageLoaderBase
  * Method:    setBorderTexel
@@ -71,6 +71,14 @@ JNIEXPORT void JNICALL Java_com_mousebird_maply_QuadLoaderBase_cleanupNative
 JNIEXPORT void JNICALL Java_com_mousebird_maply_QuadLoaderBase_mergeLoaderReturn
   (JNIEnv *, jobject, jobject, jobject);
 
+/*
+ * Class:     com_mousebird_maply_QuadLoaderBase
+ * Method:    prepareLoaderReturn
+ * Signature: (Lcom/mousebird/maply/LoaderReturn;)V
+ */
+JNIEXPORT void JNICALL Java_com_mousebird_maply_QuadLoaderBase_prepareLoaderReturn
+  (JNIEnv *, jobject, jobject);
+
 /*
  * Class:     com_mousebird_maply_QuadLoaderBase
  * Method:    samplingLayerConnectNative
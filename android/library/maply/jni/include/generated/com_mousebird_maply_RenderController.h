@@ -89,6 +89,22 @@ JNIEXPORT jboolean JNICALL Java_com_mousebird_maply_RenderController_hasChanges
 JNIEXPORT void JNICALL Java_com_mousebird_maply_RenderController_setPerfInterval
   (JNIEnv *, jobject, jint);
 
+/*
+ * Class:     com_mousebird_maply_RenderController
+ * Method:    setFrameTrace
+ * Signature: (Z)V
+ */
+JNIEXPORT void JNICALL Java_com_mousebird_maply_RenderController_setFrameTrace
+  (JNIEnv *, jobject, jboolean);
+
+/*
+ * Class:     com_mousebird_maply_RenderController
+ * Method:    writeFrameTrace
+ * Signature: (Ljava/lang/String;)Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_mousebird_maply_RenderController_writeFrameTrace
+  (JNIEnv *, jobject, jstring);
+
 /*
  * Class:     com_mousebird_maply_RenderController
  * Method:    addLight
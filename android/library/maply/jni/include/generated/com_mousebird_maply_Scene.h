@@ -55,6 +55,30 @@ JNIEXPORT void JNICALL Java_com_mousebird_maply_Scene_removeRenderTargetNative
 JNIEXPORT void JNICALL Java_com_mousebird_maply_Scene_teardownGL
   (JNIEnv *, jobject);
 
+/*
+ * Class:     com_mousebird_maply_Scene
+ * Method:    setSDFGlyphs
+ * Signature: (ZFI)V
+ */
+JNIEXPORT void JNICALL Java_com_mousebird_maply_Scene_setSDFGlyphs
+  (JNIEnv *, jobject, jboolean, jfloat, jint);
+
+/*
+ * Class:     com_mousebird_maply_Scene
+ * Method:    setSDFGlyphCacheFile
+ * Signature: (Ljava/lang/String;)V
+ */
+JNIEXPORT void JNICALL Java_com_mousebird_maply_Scene_setSDFGlyphCacheFile
+  (JNIEnv *, jobject, jstring);
+
+/*
+ * Class:     com_mousebird_maply_Scene
+ * Method:    saveSDFGlyphCache
+ * Signature: ()Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_mousebird_maply_Scene_saveSDFGlyphCache
+  (JNIEnv *, jobject);
+
 /*
  * Class:     com_mousebird_maply_Scene
  * Method:    nativeInit
@@ -31,6 +31,14 @@ JNIEXPORT void JNICALL Java_com_mousebird_maply_ShapeInfo_setLineWidth
 JNIEXPORT void JNICALL Java_com_mousebird_maply_ShapeInfo_setInsideOut
   (JNIEnv *, jobject, jboolean);
 
+/*
+ * Class:     com_mousebird_maply_ShapeInfo
+ * Method:    setInstanced
+ * Signature: (Z)V
+ */
+JNIEXPORT void JNICALL Java_com_mousebird_maply_ShapeInfo_setInstanced
+  (JNIEnv *, jobject, jboolean);
+
 /*
  * Class:     com_mousebird_maply_ShapeInfo
  * Method:    setCenter
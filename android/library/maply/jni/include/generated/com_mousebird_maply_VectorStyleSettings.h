@@ -247,6 +247,38 @@ JNIEXPORT jdouble JNICALL Java_com_mousebird_maply_VectorStyleSettings_getWideVe
 JNIEXPORT void JNICALL Java_com_mousebird_maply_VectorStyleSettings_setWideVecCutoff
   (JNIEnv *, jobject, jdouble);
 
+/*
+ * Class:     com_mousebird_maply_VectorStyleSettings
+ * Method:    getSimplifyTolerance
+ * Signature: ()D
+ */
+JNIEXPORT jdouble JNICALL Java_com_mousebird_maply_VectorStyleSettings_getSimplifyTolerance
+  (JNIEnv *, jobject);
+
+/*
+ * Class:     com_mousebird_maply_VectorStyleSettings
+ * Method:    setSimplifyTolerance
+ * Signature: (D)V
+ */
+JNIEXPORT void JNICALL Java_com_mousebird_maply_VectorStyleSettings_setSimplifyTolerance
+  (JNIEnv *, jobject, jdouble);
+
+/*
+ * Class:     com_mousebird_maply_VectorStyleSettings
+ * Method:    getSimplifyMaxLevel
+ * Signature: ()I
+ */
+JNIEXPORT jint JNICALL Java_com_mousebird_maply_VectorStyleSettings_getSimplifyMaxLevel
+  (JNIEnv *, jobject);
+
+/*
+ * Class:     com_mousebird_maply_VectorStyleSettings
+ * Method:    setSimplifyMaxLevel
+ * Signature: (I)V
+ */
+JNIEXPORT void JNICALL Java_com_mousebird_maply_VectorStyleSettings_setSimplifyMaxLevel
+  (JNIEnv *, jobject, jint);
+
 /*
  * Class:     com_mousebird_maply_VectorStyleSettings
  * Method:    getSelectable
@@ -97,6 +97,43 @@ JNIEXPORT void JNICALL Java_com_mousebird_maply_MapboxVectorTileParser_setLocalC
     }
 }
 
+JNIEXPORT void JNICALL Java_com_mousebird_maply_MapboxVectorTileParser_setGeometryCacheNative
+        (JNIEnv *env, jobject obj, jlong memoryBudget, jlong diskBudget, jstring spillDirStr)
+{
+    try {
+        MapboxVectorTileParser *inst = MapboxVectorTileParserClassInfo::getClassInfo()->getObject(env, obj);
+        if (!inst)
+            return;
+        if (memoryBudget <= 0) {
+            inst->setGeometryCache(TileGeometryCacheRef());
+            return;
+        }
+        JavaString spillDir(env,spillDirStr);
+        inst->setGeometryCache(TileGeometryCacheRef(new TileGeometryCache(memoryBudget,diskBudget,spillDir.cStr)));
+    }
+    catch (...) {
+        __android_log_print(ANDROID_LOG_VERBOSE, "Maply",
+                            "Crash in MapboxVectorTileParser::setGeometryCacheNative()");
+    }
+}
+
+JNIEXPORT jdouble JNICALL Java_com_mousebird_maply_MapboxVectorTileParser_getGeometryCacheHitRate
+        (JNIEnv *env, jobject obj)
+{
+    try {
+        MapboxVectorTileParser *inst = MapboxVectorTileParserClassInfo::getClassInfo()->getObject(env, obj);
+        if (!inst || !inst->getGeometryCache())
+            return 0.0;
+        return inst->getGeometryCache()->getStats().hitRate();
+    }
+    catch (...) {
+        __android_log_print(ANDROID_LOG_VERBOSE, "Maply",
+                            "Crash in MapboxVectorTileParser::getGeometryCacheHitRate()");
+    }
+
+    return 0.0;
+}
+
 JNIEXPORT jboolean JNICALL Java_com_mousebird_maply_MapboxVectorTileParser_parseDataNative
         (JNIEnv *env, jobject obj, jbyteArray data, jobject vecTileDataObj)
 {
@@ -552,6 +552,70 @@ JNIEXPORT void JNICALL Java_com_mousebird_maply_VectorStyleSettings_setWideVecCu
     }
 }
 
+JNIEXPORT jdouble JNICALL Java_com_mousebird_maply_VectorStyleSettings_getSimplifyTolerance
+(JNIEnv *env, jobject obj)
+{
+    try
+    {
+        VectorStyleSettingsImplRef *inst = VectorStyleSettingsClassInfo::getClassInfo()->getObject(env,obj);
+        if (inst)
+            return (*inst)->simplifyTolerance;
+    }
+    catch (...)
+    {
+        __android_log_print(ANDROID_LOG_VERBOSE, "Maply", "Crash in VectorStyleSettings::getSimplifyTolerance()");
+    }
+
+    return 0.0;
+}
+
+JNIEXPORT void JNICALL Java_com_mousebird_maply_VectorStyleSettings_setSimplifyTolerance
+(JNIEnv *env, jobject obj, jdouble tolerance)
+{
+    try
+    {
+        VectorStyleSettingsImplRef *inst = VectorStyleSettingsClassInfo::getClassInfo()->getObject(env,obj);
+        if (inst)
+            (*inst)->simplifyTolerance = tolerance;
+    }
+    catch (...)
+    {
+        __android_log_print(ANDROID_LOG_VERBOSE, "Maply", "Crash in VectorStyleSettings::setSimplifyTolerance()");
+    }
+}
+
+JNIEXPORT jint JNICALL Java_com_mousebird_maply_VectorStyleSettings_getSimplifyMaxLevel
+(JNIEnv *env, jobject obj)
+{
+    try
+    {
+        VectorStyleSettingsImplRef *inst = VectorStyleSettingsClassInfo::getClassInfo()->getObject(env,obj);
+        if (inst)
+            return (*inst)->simplifyMaxLevel;
+    }
+    catch (...)
+    {
+        __android_log_print(ANDROID_LOG_VERBOSE, "Maply", "Crash in VectorStyleSettings::getSimplifyMaxLevel()");
+    }
+
+    return -1;
+}
+
+JNIEXPORT void JNICALL Java_com_mousebird_maply_VectorStyleSettings_setSimplifyMaxLevel
+(JNIEnv *env, jobject obj, jint level)
+{
+    try
+    {
+        VectorStyleSettingsImplRef *inst = VectorStyleSettingsClassInfo::getClassInfo()->getObject(env,obj);
+        if (inst)
+            (*inst)->simplifyMaxLevel = level;
+    }
+    catch (...)
+    {
+        __android_log_print(ANDROID_LOG_VERBOSE, "Maply", "Crash in VectorStyleSettings::setSimplifyMaxLevel()");
+    }
+}
+
 JNIEXPORT jboolean JNICALL Java_com_mousebird_maply_VectorStyleSettings_getSelectable
 (JNIEnv *env, jobject obj)
 {
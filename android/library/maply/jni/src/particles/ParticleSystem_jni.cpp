@@ -289,6 +289,38 @@ JNIEXPORT void JNICALL Java_com_mousebird_maply_ParticleSystem_setContinuousUpda
     }
 }
 
+JNIEXPORT void JNICALL Java_com_mousebird_maply_ParticleSystem_setCPUCalculation
+(JNIEnv *env, jobject obj, jboolean newVal)
+{
+    try {
+        ParticleSystemClassInfo *classInfo = ParticleSystemClassInfo::getClassInfo();
+        ParticleSystem *inst = classInfo->getObject(env, obj);
+        if (!inst)
+            return;
+
+        inst->cpuCalculation = newVal;
+    }
+    catch (...) {
+        __android_log_print(ANDROID_LOG_VERBOSE, "Maply", "Crash in ParticleSystem::setCPUCalculation()");
+    }
+}
+
+JNIEXPORT void JNICALL Java_com_mousebird_maply_ParticleSystem_setCPUThreads
+(JNIEnv *env, jobject obj, jint numThreads)
+{
+    try {
+        ParticleSystemClassInfo *classInfo = ParticleSystemClassInfo::getClassInfo();
+        ParticleSystem *inst = classInfo->getObject(env, obj);
+        if (!inst)
+            return;
+
+        inst->cpuThreads = numThreads;
+    }
+    catch (...) {
+        __android_log_print(ANDROID_LOG_VERBOSE, "Maply", "Crash in ParticleSystem::setCPUThreads()");
+    }
+}
+
 
 
 JNIEXPORT void JNICALL Java_com_mousebird_maply_ParticleSystem_setDrawPriority
@@ -179,6 +179,40 @@ JNIEXPORT void JNICALL Java_com_mousebird_maply_QuadImageLoaderBase_setImageForm
 
 }
 
+JNIEXPORT void JNICALL Java_com_mousebird_maply_QuadImageLoaderBase_setTextureCompressionNative
+(JNIEnv *env, jobject obj, jint compression)
+{
+    try {
+        QuadImageFrameLoader_AndroidRef *loader = QuadImageFrameLoaderClassInfo::getClassInfo()->getObject(env,obj);
+        if (!loader)
+            return;
+        // Zero is off, then the ETC2 quality levels
+        if (compression <= 0)
+            (*loader)->setTextureCompression(false,ETC2QualityFast);
+        else
+            (*loader)->setTextureCompression(true,(ETC2Quality)std::min(compression-1,(int)ETC2QualityHigh));
+    }
+    catch (...)
+    {
+        __android_log_print(ANDROID_LOG_VERBOSE, "Maply", "Crash in QuadImageLoaderBase::setTextureCompressionNative()");
+    }
+}
+
+JNIEXPORT void JNICALL Java_com_mousebird_maply_QuadImageLoaderBase_setTextureMipmaps
+(JNIEnv *env, jobject obj, jboolean mipmaps, jboolean sRGB)
+{
+    try {
+        QuadImageFrameLoader_AndroidRef *loader = QuadImageFrameLoaderClassInfo::getClassInfo()->getObject(env,obj);
+        if (!loader)
+            return;
+        (*loader)->setTextureMipmaps(mipmaps,sRGB);
+    }
+    catch (...)
+    {
+        __android_log_print(ANDROID_LOG_VERBOSE, "Maply", "Crash in QuadImageLoaderBase::setTextureMipmaps()");
+    }
+}
+
 JNIEXPORT void JNICALL Java_com_mousebird_maply_QuadImageLoaderBase_setBorderTexel
 (JNIEnv *env, jobject obj, jint borderTexel)
 {
@@ -254,6 +254,22 @@ JNIEXPORT void JNICALL Java_com_mousebird_maply_QuadLoaderBase_mergeLoaderReturn
     }
 }
 
+JNIEXPORT void JNICALL Java_com_mousebird_maply_QuadLoaderBase_prepareLoaderReturn
+        (JNIEnv *env, jobject obj, jobject loadRetObj)
+{
+    try {
+        QuadImageFrameLoader_AndroidRef *loader = QuadImageFrameLoaderClassInfo::getClassInfo()->getObject(env,obj);
+        QuadLoaderReturnRef *loadReturn = LoaderReturnClassInfo::getClassInfo()->getObject(env,loadRetObj);
+        if (!loader || !loadReturn)
+            return;
+        (*loader)->prepareLoadedImages(loadReturn->get());
+    }
+    catch (...)
+    {
+        __android_log_print(ANDROID_LOG_VERBOSE, "Maply", "Crash in QuadLoaderBase::prepareLoaderReturn()");
+    }
+}
+
 JNIEXPORT void JNICALL Java_com_mousebird_maply_QuadLoaderBase_samplingLayerConnectNative
         (JNIEnv *env, jobject obj, jobject layerObj, jobject changeObj)
 {
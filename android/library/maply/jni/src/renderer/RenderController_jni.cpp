@@ -266,6 +266,8 @@ JNIEXPORT void JNICALL Java_com_mousebird_maply_RenderController_setupShadersNat
 		// Screen space
 		rendWrap.addShader(MaplyScreenSpaceDefaultMotionShader,ProgramGLESRef(BuildScreenSpaceMotionProgramGLES(MaplyScreenSpaceDefaultMotionShader,renderer)));
 		rendWrap.addShader(MaplyScreenSpaceDefaultShader,ProgramGLESRef(BuildScreenSpaceProgramGLES(MaplyScreenSpaceDefaultShader,renderer)));
+		rendWrap.addShader(MaplyScreenSpaceSDFMotionShader,ProgramGLESRef(BuildScreenSpaceSDFMotionProgramGLES(MaplyScreenSpaceSDFMotionShader,renderer)));
+		rendWrap.addShader(MaplyScreenSpaceSDFShader,ProgramGLESRef(BuildScreenSpaceSDFProgramGLES(MaplyScreenSpaceSDFShader,renderer)));
 		// Particles
 		rendWrap.addShader(MaplyParticleSystemPointDefaultShader,ProgramGLESRef(BuildParticleSystemProgramGLES(MaplyParticleSystemPointDefaultShader,renderer)));
 	}
@@ -488,6 +490,40 @@ JNIEXPORT void JNICALL Java_com_mousebird_maply_RenderController_setPerfInterval
 	}
 }
 
+JNIEXPORT void JNICALL Java_com_mousebird_maply_RenderController_setFrameTrace
+		(JNIEnv *env, jobject obj, jboolean enable)
+{
+	try
+	{
+		FrameTrace::setEnabled(enable);
+	}
+	catch (...)
+	{
+		__android_log_print(ANDROID_LOG_VERBOSE, "Maply", "Crash in RenderController::setFrameTrace()");
+	}
+}
+
+JNIEXPORT jboolean JNICALL Java_com_mousebird_maply_RenderController_writeFrameTrace
+		(JNIEnv *env, jobject obj, jstring jFileName)
+{
+	try
+	{
+		const char *cStr = env->GetStringUTFChars(jFileName,0);
+		if (!cStr)
+			return false;
+		std::string fileName(cStr);
+		env->ReleaseStringUTFChars(jFileName, cStr);
+
+		return FrameTrace::writeChromeTrace(fileName);
+	}
+	catch (...)
+	{
+		__android_log_print(ANDROID_LOG_VERBOSE, "Maply", "Crash in RenderController::writeFrameTrace()");
+	}
+
+	return false;
+}
+
 JNIEXPORT void JNICALL Java_com_mousebird_maply_RenderController_addLight
 		(JNIEnv *env, jobject obj, jobject lightObj)
 {
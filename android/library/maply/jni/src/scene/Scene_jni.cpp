@@ -212,3 +212,60 @@ JNIEXPORT void JNICALL Java_com_mousebird_maply_Scene_removeRenderTargetNative
         __android_log_print(ANDROID_LOG_VERBOSE, "Maply", "Crash in Scene::removeRenderTargetNative()");
     }
 }
+
+JNIEXPORT void JNICALL Java_com_mousebird_maply_Scene_setSDFGlyphs
+        (JNIEnv *env, jobject obj, jboolean enable, jfloat refSize, jint spread)
+{
+    try
+    {
+        SceneClassInfo *classInfo = SceneClassInfo::getClassInfo();
+        Scene *scene = classInfo->getObject(env,obj);
+        if (!scene || !scene->getFontTextureManager())
+            return;
+
+        scene->getFontTextureManager()->setSDFMode(enable,refSize,spread);
+    }
+    catch (...)
+    {
+        __android_log_print(ANDROID_LOG_VERBOSE, "Maply", "Crash in Scene::setSDFGlyphs()");
+    }
+}
+
+JNIEXPORT void JNICALL Java_com_mousebird_maply_Scene_setSDFGlyphCacheFile
+        (JNIEnv *env, jobject obj, jstring fileNameStr)
+{
+    try
+    {
+        SceneClassInfo *classInfo = SceneClassInfo::getClassInfo();
+        Scene *scene = classInfo->getObject(env,obj);
+        if (!scene || !scene->getFontTextureManager())
+            return;
+
+        JavaString fileName(env,fileNameStr);
+        scene->getFontTextureManager()->setSDFCacheFile(fileName.cStr);
+    }
+    catch (...)
+    {
+        __android_log_print(ANDROID_LOG_VERBOSE, "Maply", "Crash in Scene::setSDFGlyphCacheFile()");
+    }
+}
+
+JNIEXPORT jboolean JNICALL Java_com_mousebird_maply_Scene_saveSDFGlyphCache
+        (JNIEnv *env, jobject obj)
+{
+    try
+    {
+        SceneClassInfo *classInfo = SceneClassInfo::getClassInfo();
+        Scene *scene = classInfo->getObject(env,obj);
+        if (!scene || !scene->getFontTextureManager())
+            return false;
+
+        return scene->getFontTextureManager()->saveSDFCache();
+    }
+    catch (...)
+    {
+        __android_log_print(ANDROID_LOG_VERBOSE, "Maply", "Crash in Scene::saveSDFGlyphCache()");
+    }
+
+    return false;
+}
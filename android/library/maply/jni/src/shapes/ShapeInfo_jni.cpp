@@ -125,6 +125,23 @@ JNIEXPORT void JNICALL Java_com_mousebird_maply_ShapeInfo_setInsideOut
     }
 }
 
+JNIEXPORT void JNICALL Java_com_mousebird_maply_ShapeInfo_setInstanced
+(JNIEnv *env, jobject obj, jboolean instanced)
+{
+    try
+    {
+        ShapeInfoClassInfo *classInfo = ShapeInfoClassInfo::getClassInfo();
+        ShapeInfoRef *inst = classInfo->getObject(env, obj);
+        if (!inst)
+            return;
+        (*inst)->instanced = instanced;
+    }
+    catch(...)
+    {
+        __android_log_print(ANDROID_LOG_VERBOSE, "Maply", "Crash in ShapeInfo::setInstanced()");
+    }
+}
+
 JNIEXPORT void JNICALL Java_com_mousebird_maply_ShapeInfo_setCenter
 (JNIEnv *env, jobject obj, jobject ptObj)
 {
@@ -44,7 +44,11 @@ JNIEXPORT void JNICALL Java_com_mousebird_maply_GlobeViewState_initialise
 		if (!globeView || !renderer)
 			return;
 
-		GlobeViewStateRef *globeViewState = new GlobeViewStateRef(new WhirlyGlobe::GlobeViewState(globeView,renderer));
+		// Everyone looking at the same view shares a view state
+		GlobeViewStateRef theViewState = std::dynamic_pointer_cast<WhirlyGlobe::GlobeViewState>(globeView->getViewState(renderer));
+		if (!theViewState)
+			theViewState = GlobeViewStateRef(new WhirlyGlobe::GlobeViewState(globeView,renderer));
+		GlobeViewStateRef *globeViewState = new GlobeViewStateRef(theViewState);
 
 		if (globeViewState)
 			GlobeViewStateRefClassInfo::getClassInfo()->setHandle(env,obj,globeViewState);
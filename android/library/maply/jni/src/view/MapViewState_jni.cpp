@@ -45,7 +45,11 @@ JNIEXPORT void JNICALL Java_com_mousebird_maply_MapViewState_initialise
 		if (!mapView || !renderer)
 			return;
 
-		MapViewStateRef *mapViewState = new MapViewStateRef(new Maply::MapViewState(mapView,renderer));
+		// Everyone looking at the same view shares a view state
+		MapViewStateRef theViewState = std::dynamic_pointer_cast<Maply::MapViewState>(mapView->getViewState(renderer));
+		if (!theViewState)
+			theViewState = MapViewStateRef(new Maply::MapViewState(mapView,renderer));
+		MapViewStateRef *mapViewState = new MapViewStateRef(theViewState);
 
 		if (mapViewState)
 			MapViewStateRefClassInfo::getClassInfo()->setHandle(env,obj,mapViewState);
@@ -23,6 +23,7 @@ package com.mousebird.maply;
 import android.graphics.Bitmap;
 import android.graphics.Canvas;
 import android.graphics.Paint;
+import android.graphics.Typeface;
 
 /**
  * Convenience object used to render a single character for the 
@@ -48,11 +49,44 @@ class CharRenderer
 	}
 	
 	Glyph renderChar(int charInt,LabelInfo labelInfo,float fontSize)
+	{
+		return renderChar(charInt,labelInfo,fontSize,labelInfo.getTextColor(),true);
+	}
+
+	// Render a glyph to turn into a distance field.  Only the coverage matters, so no color or outline.
+	Glyph renderSDFChar(int charInt,LabelInfo labelInfo,float fontSize)
+	{
+		return renderChar(charInt,labelInfo,fontSize,0xFFFFFFFF,false);
+	}
+
+	static final String fontKeySample = "AaGgMmQqWw0@";
+
+	// A key for the typeface that's the same from one run to the next.
+	// Typefaces don't have names, so we use the style, the metrics and the widths of a few characters.
+	String fontKey(LabelInfo labelInfo,float fontSize)
+	{
+		Paint paint = new Paint();
+		paint.setTextSize(fontSize);
+		Typeface typeface = labelInfo.getTypeface();
+		if (typeface != null)
+			paint.setTypeface(typeface);
+		Paint.FontMetrics fm = paint.getFontMetrics();
+		float widths[] = new float[fontKeySample.length()];
+		paint.getTextWidths(fontKeySample, widths);
+
+		StringBuilder key = new StringBuilder();
+		key.append(typeface != null ? typeface.getStyle() : 0);
+		key.append(':').append(fm.ascent).append(':').append(fm.descent);
+		for (float width : widths)
+			key.append(':').append(width);
+		return key.toString();
+	}
+
+	private Glyph renderChar(int charInt,LabelInfo labelInfo,float fontSize,int textColor,boolean withOutline)
 	{
 		Paint textFillPaint = new Paint();
 		String str = new String(Character.toChars(charInt));
 		textFillPaint.setTextSize(fontSize);
-		int textColor = labelInfo.getTextColor();
 		textFillPaint.setColor(textColor);
 		textFillPaint.setAntiAlias(true);
 		if (labelInfo != null)
@@ -70,7 +104,7 @@ class CharRenderer
 
 		//paint for outline
 		Paint textOutlinePaint = null;
-		if(labelInfo.getOutlineSize() > 0) {
+		if(withOutline && labelInfo.getOutlineSize() > 0) {
 			textOutlinePaint = new Paint(textFillPaint);
 			textOutlinePaint.setStyle(Paint.Style.STROKE);
 			textOutlinePaint.setStrokeWidth(labelInfo.getOutlineSize());
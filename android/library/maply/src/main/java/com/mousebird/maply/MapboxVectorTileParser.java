@@ -101,6 +101,27 @@ public class MapboxVectorTileParser
     /// If set, we'll parse into local coordinates as specified by the bounding box, rather than geo coords
     native void setLocalCoords(boolean localCoords);
 
+    /**
+     * Keep the finished geometry for tiles we've parsed so that revisiting them
+     * skips the parsing and building.  Labels, markers and selectable features
+     * are still built each time.  Changing the styles retires what's cached.
+     *
+     * @param memoryBytes Memory budget for the cache.  Zero or less turns it off.
+     * @param diskBytes Budget for tiles spilled to disk.  Zero turns off spilling.
+     * @param spillDir Directory for spilled tiles.  Can be null.
+     */
+    public void setGeometryCache(long memoryBytes,long diskBytes,String spillDir)
+    {
+        setGeometryCacheNative(memoryBytes,diskBytes,spillDir != null ? spillDir : "");
+    }
+
+    native void setGeometryCacheNative(long memoryBytes,long diskBytes,String spillDir);
+
+    /**
+     * Fraction of tiles we found in the geometry cache, in whole or in part.
+     */
+    public native double getGeometryCacheHitRate();
+
     public void finalize()
     {
         dispose();
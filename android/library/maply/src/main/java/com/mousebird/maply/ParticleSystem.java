@@ -175,6 +175,19 @@ public class ParticleSystem {
      */
     public native void setContinuousUpdate(boolean cRender);
 
+    /**
+     * Move the particles on the CPU rather than with a position shader.
+     * Particles move in a straight line from a_position along a_dir (or a_velocity)
+     * and a float a_age attribute, if present, is set to their age from 0 to 1.
+     * Use this on devices that can't run a position shader.  Off by default.
+     */
+    public native void setCPUCalculation(boolean cpuCalc);
+
+    /**
+     * Number of threads to use for CPU calculation.  Defaults to 1.
+     */
+    public native void setCPUThreads(int numThreads);
+
     /**
      * Set the draw priority for the particles
      */
@@ -189,6 +189,36 @@ public class QuadImageLoaderBase extends QuadLoaderBase
 
     protected native void setImageFormatNative(int imageFormat);
 
+    /**
+     *  Texture compression done on the loading threads.
+     *  <br>
+     *  The ETC2 settings compress tiles before they go to the renderer, which takes 4 bits per pixel for opaque tiles and 8 for ones with alpha.
+     *  Fast is usually good enough for imagery.  Normal looks better on smooth gradients and High takes a lot longer for a little more.
+     */
+    public enum TextureCompression {None,ETC2Fast,ETC2Normal,ETC2High};
+
+    /**
+     *  Compress image tiles to ETC2 on the loading threads.
+     *  <br>
+     *  This needs OpenGL ES 3 and only applies to the 32 and 16 bit image formats.
+     *  Be sure to set this at layer creation, it won't do anything later on.
+     */
+    public void setTextureCompression(TextureCompression compression) {
+        setTextureCompressionNative(compression.ordinal());
+    }
+
+    protected native void setTextureCompressionNative(int compression);
+
+    /**
+     *  Build mipmaps for image tiles on the loading threads.
+     *  <br>
+     *  Otherwise the renderer builds them as each tile is uploaded.
+     *  With sRGB on, colors are averaged as light rather than as raw values, which keeps imagery from darkening as it shrinks.
+     *  Compression takes precedence if both are set.
+     *  Be sure to set this at layer creation, it won't do anything later on.
+     */
+    public native void setTextureMipmaps(boolean mipmaps,boolean sRGB);
+
     /**
      *  Number of border texels to set up around image tiles.
      *  <br>
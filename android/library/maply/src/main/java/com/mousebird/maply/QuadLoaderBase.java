@@ -244,6 +244,9 @@ public class QuadLoaderBase implements QuadSamplingLayer.ClientInterface
 
     protected native void mergeLoaderReturn(LoaderReturn loadReturn,ChangeSet changes);
 
+    // Get the images in a loader return ready for the renderer.  Runs on the loading thread.
+    protected native void prepareLoaderReturn(LoaderReturn loadReturn);
+
     /* --- QuadSamplingLayer interface --- */
 
     public void samplingLayerConnect(QuadSamplingLayer layer,ChangeSet changes)
@@ -318,8 +321,10 @@ public class QuadLoaderBase implements QuadSamplingLayer.ClientInterface
                         loadReturn.addTileData(data);
 
                     // We're on an AsyncTask in the background here, so do the loading
-                    if (loadInterp != null)
+                    if (loadInterp != null) {
                         theLoadInterp.dataForTile(loadReturn,loaderBase);
+                        prepareLoaderReturn(loadReturn);
+                    }
 
                     // Merge the data back in on the sampling layer's thread
                     final QuadSamplingLayer layer = samplingLayer.get();
@@ -1949,6 +1949,8 @@ public class RenderController implements RenderControllerInterface
     protected native void render();
     protected native boolean hasChanges();
     public native void setPerfInterval(int perfInterval);
+    public native void setFrameTrace(boolean enable);
+    public native boolean writeFrameTrace(String fileName);
     public native void addLight(DirectionalLight light);
     public native void replaceLights(DirectionalLight[] lights);
     protected native void renderToBitmapNative(Bitmap outBitmap);
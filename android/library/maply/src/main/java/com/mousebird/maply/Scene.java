@@ -43,6 +43,27 @@ public class Scene
 	public native void changeRenderTarget(long renderTargetID,long texID);
 	public native void removeRenderTargetNative(long renderTargetID);
 
+	/**
+	 * Render label glyphs once at a reference size and keep them as signed distance fields.
+	 * Every font size and outline width is then drawn from the same glyphs.
+	 * Call this before adding any labels.
+	 * @param enable Turn distance field glyphs on or off.
+	 * @param refSize Font size the glyphs are rendered at.
+	 * @param spread How far past the glyph edges the field reaches, in pixels at the reference size.  This limits the outline width.
+	 */
+	public native void setSDFGlyphs(boolean enable,float refSize,int spread);
+
+	/**
+	 * Read distance field glyphs from the given file and write new ones back to it.
+	 * This saves rendering the common glyphs again on the next run.
+	 */
+	public native void setSDFGlyphCacheFile(String fileName);
+
+	/**
+	 * Write out any new distance field glyphs now.  This also happens when the scene is torn down.
+	 */
+	public native boolean saveSDFGlyphCache();
+
 	/**
 	 * Tear down the OpenGL resources.  Context needs to be set first.
 	 */
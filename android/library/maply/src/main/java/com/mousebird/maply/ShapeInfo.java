@@ -64,6 +64,12 @@ public class ShapeInfo extends BaseInfo {
      */
     public native void setInsideOut(boolean insideOut);
 
+    /**
+     * If set, spheres, cylinders and circles are drawn as instances of a shared mesh.
+     * This is much cheaper when there are lots of them.
+     */
+    public native void setInstanced(boolean instanced);
+
     /**
      * If set, the center controls the origin for the shapes as they are created.
      * If not set, a center will be calculated for a group of shapes.
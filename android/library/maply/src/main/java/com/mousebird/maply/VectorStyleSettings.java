@@ -79,6 +79,14 @@ public class VectorStyleSettings {
     native public double getWideVecCutoff();
     native public void setWideVecCutoff(double cutoff);
 
+    /// @brief If set, simplify linear and areal features to this many pixels before building them.  Off (0) by default.
+    native public double getSimplifyTolerance();
+    native public void setSimplifyTolerance(double tolerance);
+
+    /// @brief Tiles at or past this level aren't simplified since they'll be overzoomed.  -1 (the default) means no limit.
+    native public int getSimplifyMaxLevel();
+    native public void setSimplifyMaxLevel(int level);
+
     /// @brief If set, we'll make the areal features selectable.  If not, this saves memory.
     native public boolean getSelectable();
     native public void setSelectable(boolean selectable);
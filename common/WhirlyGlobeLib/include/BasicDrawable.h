@@ -45,8 +45,11 @@ class BasicDrawable : virtual public Drawable
 friend class BasicDrawableInstance;
 friend class BasicDrawableInstanceBuilder;
 friend class BasicDrawableBuilder;
+friend class TileGeometryCache;
 
 public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW;
+
     /// Simple triangle.  Can obviously only have 2^16 vertices
     class Triangle
     {
@@ -63,6 +66,8 @@ public:
     
     /// We're allowed to turn drawables off completely
     virtual bool isOn(RendererFrameInfo *frameInfo) const;
+    /// Visible height range and enable time window
+    virtual void getVisibilityRanges(double &minHeight,double &maxHeight,TimeInterval &startTime,TimeInterval &endTime) const;
     /// True to turn it on, false to turn it off
     void setOnOff(bool onOff);
     
@@ -72,6 +77,10 @@ public:
     /// Return the local MBR, if we're working in a non-geo coordinate system
     virtual Mbr getLocalMbr() const;
 
+    /// Copy out the points and triangles if they haven't been handed to the renderer yet.
+    /// Returns false if they're gone or this drawable doesn't keep them around.
+    virtual bool getGeometry(std::vector<Eigen::Vector3f> &pts,std::vector<Triangle> &tris) const;
+
     /// Return the Matrix if there is an active one (ideally not)
     virtual const Eigen::Matrix4d *getMatrix() const;
 
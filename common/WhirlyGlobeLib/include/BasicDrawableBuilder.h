@@ -36,6 +36,7 @@ namespace WhirlyKit
  */
 class BasicDrawableBuilder
 {
+friend class TileGeometryCache;
 public:
     /// Construct empty
     BasicDrawableBuilder(const std::string &name);
@@ -43,6 +44,10 @@ public:
     
     /// Reserve the given amount of space (cuts down on reallocs)
     void reserve(int numPoints,int numTris);
+    
+    /// Reserve room for this many more points and triangles, along with
+    ///  every vertex attribute set up so far.  Call after the attributes are added.
+    virtual void reserveLayout(int numPoints,int numTris);
         
     /// True to turn it on, false to turn it off
     void setOnOff(bool onOff);
@@ -169,6 +174,32 @@ public:
     virtual void addNormal(const Point3f &norm);
     virtual void addNormal(const Point3d &norm);
     
+    /// Add a run of points.  Returns the index of the first one.
+    virtual unsigned int addPoints(const Point3f *pts,unsigned int numPts);
+    virtual unsigned int addPoints(const Point3d *pts,unsigned int numPts);
+    
+    /// Add a run of texture coordinates.  -1 adds them to all the texture coordinate sets.
+    virtual void addTexCoords(int which,const TexCoord *coords,unsigned int numCoords);
+    
+    /// Add a run of colors
+    virtual void addColors(const RGBAColor *colors,unsigned int numColors);
+    /// Add the same color for a run of points
+    virtual void addColors(const RGBAColor &color,unsigned int numColors);
+    
+    /// Add a run of normals
+    virtual void addNormals(const Point3f *norms,unsigned int numNorms);
+    /// Add the same normal for a run of points
+    virtual void addNormals(const Point3f &norm,unsigned int numNorms);
+    
+    /// Typed handle on the given attribute, for adding values without checking each one.
+    /// Invalid if there's no such attribute or T isn't its type.
+    template<typename T> VertexAttributeHandle<T> getAttributeHandle(int attrId)
+    {
+        if (attrId < 0 || attrId >= (int)basicDraw->vertexAttributes.size())
+            return VertexAttributeHandle<T>();
+        return VertexAttributeHandle<T>(basicDraw->vertexAttributes[attrId]);
+    }
+    
     /// Decide if the given list of vertex attributes is the same as the one we have
     bool compareVertexAttributes(const SingleVertexAttributeSet &attrs);
     
@@ -196,6 +227,9 @@ public:
     /// Add a triangle.  Should point to the vertex IDs.
     virtual void addTriangle(BasicDrawable::Triangle tri);
     
+    /// Add a run of triangles
+    virtual void addTriangles(const BasicDrawable::Triangle *tris,unsigned int numTris);
+    
     /// Set the uniforms applied to the Program before rendering
     virtual void setUniforms(const SingleVertexAttributeSet &uniforms);
     
@@ -40,9 +40,15 @@ namespace WhirlyKit
 class BasicDrawableGLES : virtual public BasicDrawable, virtual public DrawableGLES
 {
 public:
+    // Both bases have their own aligned new/delete
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW;
+
     BasicDrawableGLES(const std::string &name);
     virtual ~BasicDrawableGLES();
 
+    /// Build the interleaved vertex and triangle data.  No GL, so this can run on any thread.
+    virtual void prepareForRenderer(const RenderSetupInfo *setupInfo);
+    
     /// Set up local rendering structures (e.g. VBOs)
     virtual void setupForRenderer(const RenderSetupInfo *setupInfo);
     
@@ -60,6 +66,9 @@ public:
     
     /// Check if this has been set up and (more importantly) hasn't been torn down
     virtual bool isSetupInGL();
+
+    /// Copy out the points and triangles, if we haven't set up the buffers yet
+    virtual bool getGeometry(std::vector<Eigen::Vector3f> &pts,std::vector<Triangle> &tris) const;
     
     /// Size of a single vertex used in creating an interleaved buffer.
     virtual unsigned int singleVertexSize();
@@ -90,7 +99,12 @@ public:
     // Size for a single vertex w/ all its data.  Used by shared buffer
     int vertexSize;
     GLuint pointBuffer,triBuffer,sharedBuffer;
+    // If we're packed into a shared buffer, this is where.  Vertices start at sharedBufferOffset.
+    BufferArenaAlloc bufferAlloc;
+    GLuint sharedBufferOffset;
     GLuint vertArrayObj;
+    // Interleaved vertices, then triangles, waiting to go into the buffer
+    std::vector<unsigned char> preparedData;
 };
     
 }
@@ -66,6 +66,8 @@ public:
     
     /// We're allowed to turn drawables off completely
     virtual bool isOn(WhirlyKit::RendererFrameInfo *frameInfo) const;
+    /// Visible height range and enable time window
+    virtual void getVisibilityRanges(double &minHeight,double &maxHeight,TimeInterval &startTime,TimeInterval &endTime) const;
         
     /// We can ask to use the z buffer
     virtual void setRequestZBuffer(bool val);
@@ -86,6 +88,12 @@ public:
     
     /// Set the time range for enable
     void setEnableTimeRange(TimeInterval inStartEnable,TimeInterval inEndEnable);
+
+    /// Set the fade in and out
+    void setFade(TimeInterval inFadeDown,TimeInterval inFadeUp);
+
+    /// Fade value for the current frame, from the fade times
+    float calcFade(RendererFrameInfo *frameInfo);
     
     /// Set the min/max visible range
     void setVisibleRange(float inMinVis,float inMaxVis);
@@ -118,6 +126,8 @@ public:
     class SingleInstance
     {
     public:
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW;
+
         SingleInstance() : colorOverride(false) { }
         
         bool colorOverride;
@@ -170,6 +180,7 @@ protected:
     BasicDrawableRef basicDraw;
     bool enable;
     TimeInterval startEnable,endEnable;
+    TimeInterval fadeUp,fadeDown;
     bool hasDrawPriority;
     int drawPriority;
     bool hasColor;
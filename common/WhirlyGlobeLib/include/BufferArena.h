@@ -0,0 +1,165 @@
+/*
+ *  BufferArena.h
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <stddef.h>
+#import <map>
+#import <set>
+
+namespace WhirlyKit
+{
+
+/** Where a buffer arena gets its big buffers from.
+ 
+    OpenGLMemManager hands out GL buffers.  Anything else (say, a test harness)
+    just needs to hand back a non-zero ID for each one.
+  */
+class BufferArenaSource
+{
+public:
+    virtual ~BufferArenaSource() { }
+
+    /// Create a buffer of the given size and return its ID, or 0 on failure
+    virtual unsigned int createArenaBuffer(size_t size) = 0;
+
+    /// Done with the given buffer
+    virtual void releaseArenaBuffer(unsigned int bufferID) = 0;
+};
+
+/// A piece of one of the arena buffers
+class BufferArenaAlloc
+{
+public:
+    BufferArenaAlloc() : bufferID(0), offset(0), size(0), requestedSize(0) { }
+
+    /// True if this refers to an actual allocation
+    bool valid() const { return bufferID != 0; }
+
+    /// Buffer the allocation lives in
+    unsigned int bufferID;
+    /// Offset within the buffer and number of bytes reserved (which may be more than asked for)
+    size_t offset,size;
+    /// Number of bytes asked for
+    size_t requestedSize;
+};
+
+/// How full the arenas are
+class BufferArenaStats
+{
+public:
+    BufferArenaStats();
+
+    /// Fraction of the arena space that's handed out
+    double utilization() const;
+
+    int numArenas;
+    int numAllocs;
+    /// Total size of all the arenas
+    size_t arenaBytes;
+    /// Bytes handed out, after rounding up to the size classes
+    size_t usedBytes;
+    /// Bytes actually asked for
+    size_t requestedBytes;
+    int numFreeBlocks;
+    size_t largestFreeBlock;
+    /// Arenas created and released over the lifetime of the allocator
+    int arenasCreated,arenasReleased;
+};
+
+/** Packs lots of small allocations into a few big buffers.
+ 
+    Requests are rounded up to a size class (eight per power of two) so a freed
+    block tends to fit the next drawable of similar size.  Free space is kept per
+    arena and coalesced with its neighbors on free.  Allocation takes the best fit,
+    preferring the oldest arena, so new data piles into the older arenas and the
+    newer ones drain.  Nothing is ever moved.  Instead, as tiles unload their arenas
+    empty out and are given back, keeping one spare.
+ 
+    This does no locking of its own.
+  */
+class BufferArenaAllocator
+{
+public:
+    BufferArenaAllocator(BufferArenaSource *source,size_t arenaSize = 4*1024*1024,size_t alignment = 16);
+    /// Doesn't hand the arenas back to the source.  Call clear() for that.
+    ~BufferArenaAllocator();
+
+    /// Largest allocation we'll take.  Anything bigger should get its own buffer.
+    size_t maxAllocSize() const { return arenaSize/4; }
+
+    /// Size an allocation will actually take up
+    size_t sizeClass(size_t size) const;
+
+    /// Reserve the given number of bytes.  Returns an invalid allocation if it's too big
+    ///  or the source couldn't give us a new arena.
+    BufferArenaAlloc allocate(size_t size);
+
+    /// Give back an allocation
+    void free(const BufferArenaAlloc &alloc);
+
+    /// Release any empty arenas, including the spare
+    void trim();
+
+    /// Release all the arenas.  Anything still allocated is invalid after this.
+    void clear();
+
+    /// Current usage
+    BufferArenaStats getStats() const;
+
+protected:
+    class Arena
+    {
+    public:
+        unsigned int bufferID;
+        // Order of creation, older first
+        unsigned int seq;
+        size_t used;
+        int numAllocs;
+        // Free blocks by offset, for coalescing
+        std::map<size_t,size_t> freeBlocks;
+    };
+
+    // Free block sorted by size, then by arena age
+    class FreeBlock
+    {
+    public:
+        bool operator < (const FreeBlock &that) const;
+
+        size_t size;
+        unsigned int seq;
+        size_t offset;
+        Arena *arena;
+    };
+
+    void addFreeBlock(Arena *arena,size_t offset,size_t size);
+    void removeFreeBlock(Arena *arena,size_t offset,size_t size);
+    Arena *newArena();
+    void releaseArena(Arena *arena);
+
+    BufferArenaSource *source;
+    size_t arenaSize,alignment;
+    std::map<unsigned int,Arena *> arenas;
+    std::set<FreeBlock> freeBySize;
+    unsigned int nextSeq;
+    int numEmpty;
+    size_t requestedBytes;
+    int arenasCreated,arenasReleased;
+};
+
+}
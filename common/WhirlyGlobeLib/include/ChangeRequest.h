@@ -57,7 +57,16 @@ public:
     /// Fill this in to set up whatever resources we need on the GL side
     virtual void setupForRenderer(const RenderSetupInfo *);
     
+    /// Return true if there's CPU work to do in prepare() before we execute
+    virtual bool needsPrepare();
+    
+    /// Do the CPU side of the change, such as building vertex buffers or converting textures.
+    /// This may run on a worker thread, so no GL calls and don't touch the scene.
+    /// It runs once, before execute().
+    virtual void prepare(Scene *scene,const RenderSetupInfo *setupInfo);
+    
     /// Make a change to the scene.  For the renderer.  Never call this.
+    /// This should be short.  Anything that doesn't need the renderer goes in prepare().
     virtual void execute(Scene *scene,SceneRenderer *renderer,View *view) = 0;
     
     /// Set this if you need to be run before the active models are run
@@ -65,6 +74,10 @@ public:
     
     /// If non-zero we'll execute this request after the given absolute time
     TimeInterval when;
+    
+    typedef enum {PrepareNone,PrepareQueued,PrepareRunning,PrepareDone} PrepareState;
+    /// Where we are with prepare().  The Scene manages this under its prepare lock.
+    PrepareState prepareState;
 };
 
 /// Representation of a list of changes.  Might get more complex in the future.
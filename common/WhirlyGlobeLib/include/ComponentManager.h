@@ -44,6 +44,8 @@ class ComponentObject : public Identifiable
 {
     friend class ComponentManager;
 public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW;
+
     virtual ~ComponentObject();
     
     SimpleIDSet markerIDs;
@@ -58,6 +60,8 @@ public:
     SimpleIDSet partSysIDs;
     SimpleIDSet selectIDs;
     SimpleIDSet drawStringIDs;
+    // Drawables we manage directly, rather than through another manager
+    SimpleIDSet drawIDs;
     
     // Vectors objects associated with this component object
     std::vector<VectorObjectRef> vecObjs;
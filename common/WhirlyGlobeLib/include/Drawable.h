@@ -65,6 +65,11 @@ public:
     /// We're allowed to turn drawables off completely
     virtual bool isOn(RendererFrameInfo *frameInfo) const = 0;
 
+    /// Heights and times outside of which isOn() is always false.
+    /// The scene uses these to skip drawables without asking them.
+    /// By default there are no limits.
+    virtual void getVisibilityRanges(double &minHeight,double &maxHeight,TimeInterval &startTime,TimeInterval &endTime) const;
+
     /// Return the local MBR, if we're working in a non-geo coordinate system
     virtual Mbr getLocalMbr() const = 0;
 
@@ -93,6 +98,10 @@ public:
     /// For instance, set up VBOs.
     virtual void setupForRenderer(const RenderSetupInfo *setupInfo) = 0;
     
+    /// Do the CPU side of setupForRenderer() ahead of time, such as building buffers.
+    /// This may be called on a worker thread.  No rendering calls.
+    virtual void prepareForRenderer(const RenderSetupInfo *setupInfo);
+    
     /// Clean up any rendering objects you may have (e.g. VBOs).
     virtual void teardownForRenderer(const RenderSetupInfo *setupInfo,Scene *scene) = 0;
 
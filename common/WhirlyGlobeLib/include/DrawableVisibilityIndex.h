@@ -0,0 +1,108 @@
+/*
+ *  DrawableVisibilityIndex.h
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <map>
+#import <unordered_map>
+#import <vector>
+#import "Drawable.h"
+
+namespace WhirlyKit
+{
+
+/** Index of drawables by the heights and times they can be visible.
+
+    Drawables report the height range (minVisible/maxVisible) and time window
+    (startEnable/endEnable) outside of which they're always off.
+    Heights are sorted into buckets, a factor of two apart, and a drawable goes
+    into every bucket its range overlaps.  Time windows that haven't started
+    or are over keep a drawable out of the buckets entirely.
+
+    A query returns every drawable that could be on at the given height and time,
+    which is usually far fewer than are in the scene.  It's up to the caller
+    to ask those with isOn() for the rest (on/off, viewer distance and so on).
+
+    This isn't thread safe.  The scene only touches it on the render thread.
+  */
+class DrawableVisibilityIndex
+{
+public:
+    DrawableVisibilityIndex();
+    ~DrawableVisibilityIndex();
+
+    /// Add a drawable, picking up its current ranges
+    void addDrawable(const DrawableRef &draw);
+
+    /// Remove a drawable, if it's in here
+    void removeDrawable(SimpleIdentity drawID);
+
+    /// The ranges may have changed, so look at them again
+    void updateDrawable(const DrawableRef &draw);
+
+    /// Drawables that could be on at this height and time.  Appends to draws.
+    void findDrawables(double height,TimeInterval now,std::vector<DrawableRef> &draws);
+
+    /// Number of drawables in the index
+    int numDrawables() const { return (int)entries.size(); }
+
+    /// Remove everything
+    void clear();
+
+protected:
+    static const int NumBuckets = 64;
+
+    typedef enum {TimePending,TimeActive,TimeExpired} TimeState;
+
+    class Entry
+    {
+    public:
+        DrawableRef draw;
+        double minHeight,maxHeight;
+        TimeInterval startTime,endTime;
+        // Range of height buckets we're in, or -1 for the unbounded list
+        int startBucket,endBucket;
+        // Where we are in each of those buckets
+        std::vector<int> slots;
+        TimeState timeState;
+        std::multimap<TimeInterval,Entry *>::iterator timeIt;
+        bool hasTimeIt;
+    };
+
+    int bucketForHeight(double height) const;
+    void readRanges(Entry *entry);
+    void insertEntry(Entry *entry);
+    void eraseEntry(Entry *entry);
+    void addToBuckets(Entry *entry);
+    void removeFromBuckets(Entry *entry);
+    void addToList(std::vector<Entry *> &list,Entry *entry,int &slot);
+    void removeFromList(std::vector<Entry *> &list,int slot,int bucket);
+    void updateTime(TimeInterval now);
+
+    std::unordered_map<SimpleIdentity,Entry *> entries;
+    // Drawables with no height limits
+    std::vector<Entry *> unbounded;
+    std::vector<Entry *> buckets[NumBuckets];
+    // Waiting for their start time, keyed by it
+    std::multimap<TimeInterval,Entry *> pending;
+    // Visible until their end time, keyed by it
+    std::multimap<TimeInterval,Entry *> ending;
+    TimeInterval lastTime;
+};
+
+}
@@ -0,0 +1,73 @@
+/*
+ *  ETC2Encoder.h
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <stddef.h>
+#import <vector>
+#import "RawData.h"
+
+namespace WhirlyKit
+{
+
+/// How hard the ETC2 encoder looks for a good block
+typedef enum {
+    /// Differential blocks only, base colors straight from the averages
+    ETC2QualityFast = 0,
+    /// Adds individual and planar blocks, which helps a lot on smooth imagery
+    ETC2QualityNormal,
+    /// Also searches around the base colors.  Roughly ten times slower than normal.
+    ETC2QualityHigh
+} ETC2Quality;
+
+/** Encode a 4x4 block of RGBA pixels as a 64 bit ETC2 RGB block.
+ 
+    The block is 16 pixels, row by row.  Alpha is ignored.
+    The table search uses SSE2 or NEON where we have it.
+    Pass allowSIMD=false to force the scalar version, which is there for comparison.
+  */
+void ETC2EncodeRGBBlock(const unsigned char *rgba,unsigned char *out,ETC2Quality quality,bool allowSIMD = true);
+
+/// Encode the alpha of a 4x4 block of RGBA pixels as a 64 bit EAC block
+void ETC2EncodeAlphaBlock(const unsigned char *rgba,unsigned char *out,ETC2Quality quality);
+
+/** Encode a width x height RGBA image as a PKM file, which Texture::setPKMData() takes.
+ 
+    If withAlpha is set, this is ETC2 RGBA (8 bits per pixel), otherwise ETC2 RGB (4 bits per pixel).
+    Sizes that aren't a multiple of 4 are padded out by repeating the edge pixels.
+    Rows of blocks are split into bands across numThreads workers, including the calling thread.
+  */
+RawDataRef ETC2EncodePKM(const unsigned char *rgba,int width,int height,bool withAlpha,ETC2Quality quality,int numThreads = 1);
+
+/// True if every alpha value in the RGBA image is 255
+bool ETC2IsOpaque(const unsigned char *rgba,int width,int height);
+
+/** Decode a 64 bit ETC2 RGB block into 16 RGBA pixels, row by row.
+ 
+    This handles the individual, differential and planar blocks the encoder writes.
+    Returns false for T and H blocks, which it doesn't.  It's here to measure the encoder.
+  */
+bool ETC2DecodeRGBBlock(const unsigned char *in,unsigned char *rgba);
+
+/// Decode a 64 bit EAC alpha block into the alpha of 16 RGBA pixels
+void ETC2DecodeAlphaBlock(const unsigned char *in,unsigned char *rgba);
+
+/// Decode a PKM file from ETC2EncodePKM back to width x height RGBA
+bool ETC2DecodePKM(RawDataRef pkmData,std::vector<unsigned char> &rgba,int &width,int &height);
+
+}
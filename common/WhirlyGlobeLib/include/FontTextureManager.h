@@ -20,10 +20,13 @@
 #import <math.h>
 #import <set>
 #import <map>
+#import <list>
+#import <unordered_map>
 #import "Identifiable.h"
 #import "BasicDrawable.h"
 #import "TextureAtlas.h"
 #import "DynamicTextureAtlas.h"
+#import "SignedDistanceField.h"
 
 namespace WhirlyKit
 {
@@ -112,7 +115,7 @@ typedef std::map<SimpleIdentity,GlyphSet> SimpleIDGlyphMap;
 class DrawableString : public Identifiable
 {
 public:
-    DrawableString() { }
+    DrawableString() : sdfRange(0.0) { }
     
     /// A rectangle describing the placement of a single glyph and
     ///  the texture piece used to represent it
@@ -127,6 +130,10 @@ public:
     
     /// Bounding box of the string in coordinates related to the font size
     Mbr mbr;
+    
+    /// If the glyphs are signed distance fields, how much the field value changes
+    ///  over one unit of the string's coordinates.  Zero for regular glyphs.
+    float sdfRange;
 };
 
 /** Used to manage a dynamic texture set containing glyphs from
@@ -172,8 +179,96 @@ public:
     // Tear down everything we've built
     void clear(ChangeSet &changes);
     
-protected:    
+    /// Number of laid out strings we keep around for reuse.  0 turns the cache off.
+    void setGlyphRunCacheSize(int numRuns);
+    
+    /** Render glyphs once at the reference size and keep them as signed distance fields.
+        Every font size and outline width is then drawn from the same atlas entry.
+        The spread is how far the field reaches past the glyph edges, in pixels at the
+        reference size, which also limits how wide an outline can be.
+        Call this before adding any strings.  Platforms without support ignore it.
+      */
+    void setSDFMode(bool enable,float refSize = 32.0,int spread = 8);
+    
+    /// True if we're producing distance field glyphs
+    bool getSDFMode() const { return sdfMode; }
+    
+    /// Read distance field glyphs from the given file and write them back out as we go.
+    /// This saves rasterizing the common glyphs again on the next run.
+    void setSDFCacheFile(const std::string &fileName);
+    
+    /// Write out the distance field glyphs now, if there's anything new
+    bool saveSDFCache();
+    
+protected:
+    /// A string we've laid out before in a given font.
+    /// It holds references to its glyphs, so they stay in the atlas.
+    class GlyphRun
+    {
+    public:
+        SimpleIdentity fontID;
+        std::vector<WKGlyph> codePoints;
+        std::vector<DrawableString::Rect> glyphPolys;
+        Mbr mbr;
+        GlyphSet glyphs;
+    };
+    typedef std::list<GlyphRun> GlyphRunList;
+    
+    class GlyphRunKey
+    {
+    public:
+        GlyphRunKey(SimpleIdentity fontID,const std::vector<WKGlyph> *codePoints) : fontID(fontID), codePoints(codePoints) { }
+        bool operator == (const GlyphRunKey &that) const
+            { return fontID == that.fontID && *codePoints == *that.codePoints; }
+        
+        SimpleIdentity fontID;
+        // Points into the GlyphRun, or the caller's string for a lookup
+        const std::vector<WKGlyph> *codePoints;
+    };
+    
+    class GlyphRunKeyHash
+    {
+    public:
+        size_t operator () (const GlyphRunKey &key) const;
+    };
+    
+    /// Look for a string we've already laid out in this font.
+    /// If it's there we return a new DrawableString that holds its own glyph references.
+    /// Call with the lock held.
+    DrawableString *findGlyphRun(FontManagerRef fm,const std::vector<WKGlyph> &codePoints);
+    
+    /// Keep the layout of a new string around for next time.
+    /// This may push out an older one, releasing its glyphs.  Call with the lock held.
+    void addGlyphRun(FontManagerRef fm,const std::vector<WKGlyph> &codePoints,const DrawableString *drawString,const GlyphSet &glyphs,ChangeSet &changes);
+    
+    /// Drop references to the glyphs in a font, clearing out anything no longer used
+    void releaseGlyphs(SimpleIdentity fontID,const GlyphSet &glyphs,ChangeSet &changes,TimeInterval when);
+    
     void init();
+    
+    /// Put a glyph from the distance field cache into the atlas, if we have it.  Call with the lock held.
+    FontManager::GlyphInfo *addCachedSDFGlyph(FontManagerRef fm,const std::string &fontKey,WKGlyph glyph,ChangeSet &changes);
+    
+    /// Keep a new distance field glyph in the cache and put it in the atlas.  Call with the lock held.
+    FontManager::GlyphInfo *addSDFGlyph(FontManagerRef fm,const std::string &fontKey,WKGlyph glyph,const SDFGlyph &sdfGlyph,ChangeSet &changes);
+    
+    /// Scale a string laid out at the reference size to the given font size
+    void scaleSDFString(DrawableString *drawString,float fontSize);
+    
+    /// Wrap RGBA pixels in a texture the atlas can use.  The texture takes the data.
+    /// Platforms that support distance field glyphs fill this in.
+    virtual Texture *makeGlyphTexture(RawData *data,int width,int height) { delete data; return NULL; }
+    
+    // Most recently used runs are at the front
+    GlyphRunList glyphRuns;
+    std::unordered_map<GlyphRunKey,GlyphRunList::iterator,GlyphRunKeyHash> glyphRunMap;
+    int maxGlyphRuns;
+
+    bool sdfMode;
+    float sdfRefSize;
+    int sdfSpread;
+    std::string sdfCacheFile;
+    SDFGlyphCache sdfCache;
 
     FontManagerMap fontManagers;
 
@@ -0,0 +1,143 @@
+/*
+ *  FrameTrace.h
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <atomic>
+#import <string>
+#import <stdint.h>
+
+namespace WhirlyKit
+{
+
+/// Zones we time out of the box.  More can be added with FrameTrace::registerZone().
+typedef enum {
+    // Render thread
+    TraceRenderFrame = 0,
+    TraceRenderSetup,
+    TraceScenePreprocess,
+    TraceActiveModels,
+    TraceSceneChanges,
+    TraceCalcShaders,
+    TraceDrawExecution,
+    TracePresent,
+    // Layer thread
+    TraceLoaderBuild,
+    TraceLoaderMerge,
+    TraceLayerFlush,
+    // Loader threads
+    TraceTileParse,
+    TraceTexturePrepare,
+    TraceNumBuiltInZones
+} FrameTraceZone;
+
+/// Counters we track out of the box.  More can be added with FrameTrace::registerCounter().
+typedef enum {
+    TraceChangeQueue = 0,
+    TraceDrawablesDrawn,
+    TraceTilesLoading,
+    TraceNumBuiltInCounters
+} FrameTraceCounter;
+
+/** Low overhead timeline tracing.
+
+    This records begin/end events for timed zones and values for counters
+    into a fixed size ring buffer per thread.  Recording doesn't lock or allocate
+    (past the first event on a thread), so it can stay in the render, layer
+    and loader threads.  When tracing is off, each call is a single relaxed load.
+
+    Zones and counters are identified by small integers registered up front,
+    rather than strings built every frame as PerformanceTimer does.
+
+    The contents can be written out as Chrome trace event JSON at any time,
+    from any thread, and loaded into chrome://tracing or Perfetto.
+  */
+class FrameTrace
+{
+public:
+    /// Turn recording on or off.  Turning it on clears anything recorded before.
+    static void setEnabled(bool enable);
+
+    /// True if we're recording
+    static inline bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    /// Number of events kept per thread.  Rounded up to a power of two.
+    /// Only affects threads that haven't recorded anything yet.
+    static void setBufferSize(int numEvents);
+
+    /// Register a new zone name and get back its ID.  Do this once, not per frame.
+    /// Returns -1 if we've run out of room.
+    static int registerZone(const std::string &name);
+
+    /// Register a new counter name and get back its ID.  Do this once, not per frame.
+    static int registerCounter(const std::string &name);
+
+    /// Name the calling thread in the output
+    static void setThreadName(const std::string &name);
+
+    /// Start a zone on the calling thread
+    static inline void begin(int zone) { if (isEnabled()) record(zone,EventBegin,0); }
+
+    /// End a zone on the calling thread
+    static inline void end(int zone) { if (isEnabled()) record(zone,EventEnd,0); }
+
+    /// Record the current value of a counter
+    static inline void setCount(int counter,int64_t value) { if (isEnabled()) record(counter,EventCounter,value); }
+
+    /// Adjust a counter shared by several sources and record the new total.
+    /// This keeps track of the total even when tracing is off.
+    static void addCount(int counter,int64_t delta);
+
+    /// Forget everything recorded so far
+    static void clear();
+
+    /// Build the Chrome trace event JSON for everything in the buffers
+    static std::string chromeTraceJSON();
+
+    /// Write the Chrome trace event JSON to the given file
+    static bool writeChromeTrace(const std::string &fileName);
+
+    typedef enum {EventBegin,EventEnd,EventCounter} EventType;
+
+    /// Record an event on the calling thread.  Use the inline versions above.
+    static void record(int which,EventType type,int64_t value);
+
+protected:
+    static std::atomic<bool> enabled;
+};
+
+/// Times a zone for the lifetime of the object
+class FrameTraceScope
+{
+public:
+    FrameTraceScope(int zone) : zone(FrameTrace::isEnabled() ? zone : -1)
+    {
+        if (this->zone >= 0)
+            FrameTrace::record(zone,FrameTrace::EventBegin,0);
+    }
+    ~FrameTraceScope()
+    {
+        if (zone >= 0)
+            FrameTrace::record(zone,FrameTrace::EventEnd,0);
+    }
+
+protected:
+    int zone;
+};
+
+}
@@ -0,0 +1,102 @@
+/*
+ *  GeoJSONStreamParser.h
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <functional>
+#import "VectorData.h"
+
+namespace WhirlyKit
+{
+
+/** Called with the shapes for each feature as it's parsed.
+    The shapes in a single feature share an attribute dictionary.
+    Return false to stop parsing.
+  */
+typedef std::function<bool(ShapeSet &shapes)> GeoJSONFeatureCallback;
+
+/** Streaming GeoJSON parser.
+    This reads GeoJSON straight out of the source text without building
+    a JSON tree and hands back the shapes one feature at a time.
+    The output is the same as VectorParseGeoJSON().
+
+    You can restrict the results to a bounding box and a set of property names.
+    Features outside the bounding box never have their properties parsed.
+
+    A parser can be reused, but not from more than one thread at once.
+  */
+class GeoJSONStreamParser
+{
+public:
+    GeoJSONStreamParser();
+
+    /// Only return shapes overlapping this bounding box (in radians)
+    void setBoundingBox(const GeoMbr &mbr);
+
+    /// Only copy these properties into the attributes.  Others are skipped.
+    void setPropertyFilter(const StringSet &names);
+
+    /// Parse GeoJSON text in memory.  Returns false on a parse failure.
+    /// Features before the failure will already have been passed to the callback.
+    bool parse(const char *data,size_t len,const GeoJSONFeatureCallback &callback);
+
+    /// Parse GeoJSON in a string
+    bool parse(const std::string &str,const GeoJSONFeatureCallback &callback);
+
+    /// Parse a GeoJSON file.  It's mapped into memory rather than read in.
+    bool parseFile(const std::string &fileName,const GeoJSONFeatureCallback &callback);
+
+    /// Name of the coordinate system, if the last parse found one
+    const std::string &getCRS() const { return crs; }
+
+    /// Number of features passed to the callback in the last parse
+    unsigned int getNumFeatures() const { return numFeatures; }
+
+    /// Number of features dropped by the bounding box in the last parse
+    unsigned int getNumFiltered() const { return numFiltered; }
+
+protected:
+    class Scanner;
+
+    bool parseTop(Scanner &scan);
+    bool parseFeatures(Scanner &scan);
+    bool parseFeature(Scanner &scan);
+    bool filterShapes(ShapeSet &shapes);
+    bool parseGeometry(Scanner &scan,ShapeSet &shapes,int depth);
+    bool parseLoops(Scanner &scan,VectorArealRef ar);
+    bool parseCoordinates(Scanner &scan,VectorRing &pts,int depth);
+    bool parseProperties(Scanner &scan,MutableDictionaryRef dict);
+    bool parseCRS(Scanner &scan);
+
+    bool useBBox;
+    GeoMbr bbox;
+    bool useFilter;
+    StringSet filter;
+
+    const GeoJSONFeatureCallback *callback;
+    bool stopped;
+    std::string crs;
+    unsigned int numFeatures,numFiltered;
+};
+
+/** Parse GeoJSON into a collection of vectors with the streaming parser.
+    This is a drop in replacement for VectorParseGeoJSON().
+  */
+bool VectorParseGeoJSONStream(ShapeSet &shapes,const std::string &str,std::string &crs);
+
+}
@@ -33,5 +33,34 @@ bool ClipLoopToGrid(const VectorRing &ring,Point2f org,Point2f spacing,std::vect
 bool ClipLoopsToGrid(const std::vector<VectorRing> &rings,Point2f org,Point2f spacing,std::vector<VectorRing> &rets);
 bool ClipLoopToMbr(const VectorRing &ring,const Mbr &mbr, bool closed,std::vector<VectorRing> &rets);
 bool ClipLoopsToMbr(const std::vector<VectorRing> &rings,const Mbr &mbr, bool closed,std::vector<VectorRing> &rets);
+
+/** Clips areal loops to a regular grid in a single pass.
+    The loops are converted to integer coordinates once and each column of the grid is
+    clipped out and then split into cells without going back to floating point.
+    Only the cells a piece actually overlaps are visited.
+
+    The clipper and its working storage are kept between calls, so reuse one
+    for a batch of shapes.  Not thread safe.
+  */
+class GridClipper
+{
+public:
+    GridClipper(Point2f org,Point2f spacing);
+    ~GridClipper();
+
+    /// Clip a single loop.  Results are the same as ClipLoopToGrid().
+    bool clipLoop(const VectorRing &ring,std::vector<VectorRing> &rets);
+
+    /// Clip a group of loops.  The first one is the outer, the rest inner.
+    bool clipLoops(const std::vector<VectorRing> &rings,std::vector<VectorRing> &rets);
+
+protected:
+    class ClipState;
+
+    bool clipPaths(std::vector<VectorRing> &rets);
+
+    Point2f org,spacing;
+    ClipState *state;
+};
     
 }
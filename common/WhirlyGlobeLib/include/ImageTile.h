@@ -40,6 +40,9 @@ public:
     /// Construct and return a texture, if possible.
     virtual Texture *buildTexture() = 0;
     
+    /// Build the texture and hang on to it, so buildTexture() hands back the same one
+    virtual Texture *prebuildTexture() = 0;
+    
     /// Stop keeping track of texture if you were
     virtual void clearTexture() = 0;
     
@@ -28,6 +28,7 @@
 #import "ScreenSpaceBuilder.h"
 #import "SelectionManager.h"
 #import "OverlapHelper.h"
+#import "ScreenProjectionCache.h"
 
 namespace WhirlyKit
 {
@@ -86,6 +87,8 @@ public:
 class LayoutObjectEntry : public Identifiable
 {
 public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW;
+
     LayoutObjectEntry(SimpleIdentity theId);
     
     // The layout objects as passed in by the original caller
@@ -105,6 +108,9 @@ public:
     WhirlyKit::Point2d offset;
     // Set if we changed something during evaluation
     bool changed;
+
+    // Index into the screen projection cache, if we're in there
+    int projIndex;
 };
 
 typedef std::set<LayoutObjectEntry *,IdentifiableSorter> LayoutEntrySet;
@@ -130,6 +136,8 @@ public:
     class ClusterClassParams
     {
     public:
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW;
+
         SimpleIdentity motionShaderID;
         bool selectable;
         double markerAnimationTime;
@@ -147,6 +155,8 @@ public:
 class ClusterEntry
 {
 public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW;
+
     // The layout object for the cluster itself
     LayoutObject layoutObj;
     // Object IDs for all the objects clustered together
@@ -213,6 +223,8 @@ public:
     
 protected:
     bool calcScreenPt(Point2f &objPt,LayoutObject *layoutObj,ViewStateRef viewState,const Mbr &screenMbr,const Point2f &frameBufferSize);
+    bool calcScreenPt(Point2f &objPt,LayoutObjectEntry *entry,const Mbr &screenMbr);
+    void updateProjections(ViewStateRef viewState,const Point2f &frameBufferSize,bool isGlobe);
     Eigen::Matrix2d calcScreenRot(float &screenRot,ViewStateRef viewState,WhirlyGlobe::GlobeViewState *globeViewState,ScreenSpaceObject *ssObj,const Point2f &objPt,const Eigen::Matrix4d &modelTrans,const Eigen::Matrix4d &normalMat,const Point2f &frameBufferSize);
     bool runLayoutRules(ViewStateRef viewState,std::vector<ClusterEntry> &clusterEntries,std::vector<ClusterGenerator::ClusterClassParams> &clusterParams);
     
@@ -233,6 +245,10 @@ protected:
     ClusterGenerator *clusterGen;
     /// Features we'll force to always display
     std::set<std::string> overrideUUIDs;
+    /// Screen locations for the layout objects, projected once per view state.  Selection reads these too.
+    ScreenProjectionCache projCache;
+    /// Set if the layout objects have changed since we filled in the projection cache
+    bool projCacheDirty;
 };
 
 }
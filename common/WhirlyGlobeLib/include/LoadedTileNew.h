@@ -72,6 +72,8 @@ class TileGeomManager;
 class LoadedTileNew
 {
 public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW;
+
     LoadedTileNew(const QuadTreeNew::ImportantNode &ident,const MbrD &mbr);
     
     // Make sure the tile exists in space
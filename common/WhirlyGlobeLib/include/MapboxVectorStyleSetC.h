@@ -148,6 +148,9 @@ public:
     /// @brief Generates a unique ID for a style
     long long generateID();
 
+    /// @brief Call this after changing the layers or settings so nothing built with the old ones is reused
+    void stylesChanged();
+
     /// @brief Return an integer value for the given name, taking the constants into account.
     int intValue(const std::string &name,DictionaryRef dict,int defVal);
 
@@ -187,6 +190,9 @@ public:
     /// @brief Scale the color by the given opacity
     RGBAColor color(RGBAColor color,double opacity);
 
+    /// @brief Simplify the shapes for display at the tile's level, if the settings ask for it
+    void simplifyShapes(const VectorTileData *tileInfo,ShapeSet &shapes);
+
     /// @brief Check for and report an unsupported field
     void unsupportedCheck(const char *field,const char *what,DictionaryRef styleEntry);
     
@@ -252,6 +258,10 @@ public:
     /// @brief Version number from the style
     int version;
 
+    /// @brief Changes whenever the styles do and is never shared between style sets.
+    /// Anything cached from what the styles built should be keyed on this.
+    int generation;
+
     /// @brief Layers parsed from the style sheet
     std::vector<MapboxVectorStyleLayerRef> layers;
 
@@ -23,6 +23,7 @@
 #import "QuadTreeNew.h"
 #import "ImageTile.h"
 #import "ComponentManager.h"
+#import "TileGeometryCache.h"
 
 namespace WhirlyKit
 {
@@ -52,6 +53,8 @@ class PlatformThreadInfo;
 class VectorTileData
 {
 public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW;
+
     VectorTileData();
     // Construct by just taking the outline information.  No data.
     VectorTileData(const VectorTileData &);
@@ -72,6 +75,9 @@ public:
     /// Bounding box in geographic
     MbrD geoBBox;
 
+    /// Set if the shapes are in the local coordinates of bbox, rather than geographic
+    bool localCoords;
+
     /// Component objects already added to the display, but not yet visible.
     std::vector<ComponentObjectRef> compObjs;
     
@@ -135,6 +141,15 @@ public:
     
     // If set, we'll put an outline around the tile
     bool debugOutline;
+    
+    /// Set a cache for the finished geometry.  Styles we've built for a tile before
+    ///  will be rebuilt from the cache rather than parsed and styled again.
+    ///  Entries follow the style set's generation, so changed styles won't see stale geometry.
+    /// Don't share a cache between parsers with different settings.
+    void setGeometryCache(TileGeometryCacheRef cache);
+    
+    /// Return the geometry cache, if there is one
+    TileGeometryCacheRef getGeometryCache() { return geomCache; }
 
 public:
     // Used for feature inclusion.  Only keep the features that have this attribute and one of the UUIDs.
@@ -143,6 +158,16 @@ public:
     
     VectorStyleDelegateImplRef styleDelegate;
     std::map<long long,std::string> styleCategories;
+    
+    TileGeometryCacheRef geomCache;
+
+protected:
+    // Rebuild the styles the cache kept for this tile into the tile data
+    void restoreCachedStyles(PlatformThreadInfo *styleInst,MapboxVectorStyleSetImpl *styleSet,
+                             TileGeometryCache::TileEntryRef cacheEntry,VectorTileData *tileData);
+
+    // Sort a style's results into categories and merge them into the tile data
+    void mergeForStyle(long long styleID,VectorTileDataRef styleData,VectorTileData *tileData);
 };
 
 typedef std::shared_ptr<MapboxVectorTileParser> MapboxVectorTileParserRef;
@@ -80,6 +80,13 @@ public:
     /// If we're using widened vectors, only activate them for strokes wider than this.  Defaults to zero.
     float wideVecCuttoff;
 
+    /// If set, linear and areal features are simplified to this many screen pixels at the tile's level.  Defaults to zero (off).
+    float simplifyTolerance;
+
+    /// Tiles at this level and below are left alone, since they'll be shown overzoomed.
+    /// Set it to the source's maximum zoom level.  Defaults to -1 (no limit).
+    int simplifyMaxLevel;
+
     /// If set, this is the shader we'll use on the areal features.
     std::string arealShaderName;
 
@@ -69,7 +69,7 @@ public:
     double heightAboveSurface();
     
     /// Put together one or more offset matrices to express wrapping
-    virtual void getOffsetMatrices(std::vector<Eigen::Matrix4d> &offsetMatrices,const WhirlyKit::Point2f &frameBufferSize,float bufferX);
+    virtual void getOffsetMatrices(WhirlyKit::Matrix4dVector &offsetMatrices,const WhirlyKit::Point2f &frameBufferSize,float bufferX);
 
     /// Minimum valid height above plane
     double minHeightAboveSurface();
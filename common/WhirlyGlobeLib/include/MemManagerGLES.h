@@ -20,6 +20,7 @@
 
 #import "WrapperGLES.h"
 #import "ChangeRequest.h"
+#import "BufferArena.h"
 #import <vector>
 #import <set>
 #import <map>
@@ -39,7 +40,8 @@ namespace WhirlyKit
 /// Used to manage OpenGL buffer IDs and such.
 /// They're expensive to create and delete, so we try to do it
 ///  outside the renderer.
-class OpenGLMemManager
+/// Small static buffers can also be packed into a few big ones with getSubBuffer().
+class OpenGLMemManager : public BufferArenaSource
 {
 public:
     OpenGLMemManager();
@@ -61,12 +63,36 @@ public:
     /// Clear out any and all texture IDs that we have sitting around
     void clearTextureIDs();
     
+    /// Reserve part of a shared static buffer.
+    /// Returns false if it's too big or sub-allocation is off, in which case use getBufferID().
+    bool getSubBuffer(unsigned int size,BufferArenaAlloc &alloc);
+    /// Give back part of a shared buffer
+    void removeSubBuffer(const BufferArenaAlloc &alloc);
+    
+    /// Release all the shared buffers.  Anything still using them is out of luck.
+    void clearSubBuffers();
+    
+    /// Turn sub-allocation of shared buffers on or off.  On by default.
+    void setUseSubBuffers(bool useSubBuffers);
+    
+    /// How full the shared buffers are
+    BufferArenaStats getSubBufferStats();
+    
     /// Print out stats about what's in the cache
     void dumpStats();
     
+    /// BufferArenaSource: Create one of the big shared buffers
+    virtual unsigned int createArenaBuffer(size_t size);
+    /// BufferArenaSource: Done with a shared buffer
+    virtual void releaseArenaBuffer(unsigned int bufferID);
+    
 protected:
     std::mutex idLock;
     
+    std::mutex subBufferLock;
+    BufferArenaAllocator subBuffers;
+    bool useSubBuffers;
+    
     std::set<GLuint> buffIDs;
     std::set<GLuint> texIDs;
 };
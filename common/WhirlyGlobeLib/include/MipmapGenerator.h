@@ -0,0 +1,54 @@
+/*
+ *  MipmapGenerator.h
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <vector>
+#import "Texture.h"
+
+namespace WhirlyKit
+{
+
+/// Number of levels in a full mipmap chain, base included
+int MipmapNumLevels(int width,int height);
+
+/// Size of a given mipmap level
+inline int MipmapLevelSize(int size,int level) { return std::max(1,size >> level); }
+
+/// Row length we use for a level of converted data.  Rows are padded out to 32 bits for GL.
+int MipmapRowBytes(TextureType format,int width);
+
+/** Shrink an RGBA image to half size with a 2x2 box filter.
+ 
+    Odd sizes drop the last row or column, the way GL sizes the levels.
+    With sRGB set, color is averaged in linear space and alpha as is.
+    This uses SSE2 or NEON where we have it.  Pass allowSIMD=false to force the scalar version.
+  */
+void DownsampleRGBA(const unsigned char *rgba,int width,int height,unsigned char *out,bool sRGB,bool allowSIMD = true);
+
+/** Build a full mipmap chain from an RGBA image, converting each level to the given format.
+ 
+    Each level is converted in the same pass that shrinks it to the next one,
+    so the pixels are only brought in once.  Levels come back base first,
+    with rows laid out as MipmapRowBytes() says.  For TexTypeUnsignedByte the
+    base level comes back empty, since it's the image we were given.
+    Returns false if we can't convert to the format.
+  */
+bool BuildMipmapChain(const unsigned char *rgba,int width,int height,TextureType format,WKSingleByteSource source,bool sRGB,std::vector<RawDataRef> &levels);
+
+}
@@ -80,6 +80,8 @@ public:
     class ObjectWithBounds
     {
     public:
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW;
+
         ObjectWithBounds();
         Point2dVector pts;
         Point2d center;
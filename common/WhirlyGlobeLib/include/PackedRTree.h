@@ -0,0 +1,143 @@
+/*
+ *  PackedRTree.h
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <stdint.h>
+#import <algorithm>
+#import <utility>
+#import <vector>
+
+namespace WhirlyKit
+{
+
+/** Packed R-trees are one flat array of nodes that can go straight to and from disk.
+    Leaves come first, in whatever order the caller sorted them, then each level up
+    with the root on its own at the very end.
+
+    A node is anything with an mbr[4] (min x, min y, max x, max y) and an index.
+    For leaves the index is the caller's record; for the rest it's the first child.
+    Each level's end, one past its last node, goes in a separate list.
+  */
+
+/// Distance along a 2^16 x 2^16 Hilbert curve
+uint32_t HilbertIndex(uint32_t x,uint32_t y);
+
+/// Distance along the Hilbert curve for a position given as a fraction [0,1] of the bounds
+uint32_t HilbertIndexFraction(double fracX,double fracY);
+
+/// True if the two bounding boxes touch
+template<typename T> bool PackedRTreeOverlaps(const T *a,const T *b)
+{
+    return !(a[2] < b[0] || a[0] > b[2] || a[3] < b[1] || a[1] > b[3]);
+}
+
+/// Grow the first bounding box to take in the second
+template<typename T> void PackedRTreeExpand(T *a,const T *b)
+{
+    a[0] = std::min(a[0],b[0]);  a[1] = std::min(a[1],b[1]);
+    a[2] = std::max(a[2],b[2]);  a[3] = std::max(a[3],b[3]);
+}
+
+/// Add the levels above the leaves already in nodes until there's just the root
+template<typename NodeType> void PackedRTreeBuild(std::vector<NodeType> &nodes,std::vector<uint32_t> &levelEnds,uint32_t nodeSize)
+{
+    levelEnds.clear();
+    if (nodes.empty())
+        return;
+
+    size_t start = 0, end = nodes.size();
+    levelEnds.push_back((uint32_t)end);
+    while (end - start > 1)
+    {
+        for (size_t ii=start;ii<end;ii+=nodeSize)
+        {
+            NodeType parent = nodes[ii];
+            parent.index = (uint32_t)ii;
+            const size_t childEnd = std::min(ii+nodeSize,end);
+            for (size_t ci=ii+1;ci<childEnd;ci++)
+                PackedRTreeExpand(parent.mbr,nodes[ci].mbr);
+            nodes.push_back(parent);
+        }
+        start = end;
+        end = nodes.size();
+        levelEnds.push_back((uint32_t)end);
+    }
+}
+
+/// Make sure the level ends, usually from a file, describe a tree with a single root
+bool PackedRTreeCheckLevels(const uint32_t *levelEnds,uint32_t numLevels,uint32_t numNodes);
+
+/// Make sure every node points at a record or at children on the level below.
+/// Check the levels first.  This looks at every node, so it's for trees already in memory.
+template<typename NodeType> bool PackedRTreeCheckNodes(const NodeType *nodes,const uint32_t *levelEnds,uint32_t numLevels,uint32_t numRecords)
+{
+    for (uint32_t ii=0;ii<levelEnds[0];ii++)
+        if (nodes[ii].index >= numRecords)
+            return false;
+    for (uint32_t level=1;level<numLevels;level++)
+    {
+        const uint32_t childStart = level >= 2 ? levelEnds[level-2] : 0;
+        for (uint32_t ii=levelEnds[level-1];ii<levelEnds[level];ii++)
+            if (nodes[ii].index < childStart || nodes[ii].index >= levelEnds[level-1])
+                return false;
+    }
+
+    return true;
+}
+
+/** Add the records whose leaves overlap the query box.
+    The levels have to have passed PackedRTreeCheckLevels, but the nodes themselves
+    are checked as we go, so they can come straight from a mapped file.
+  */
+template<typename NodeType,typename T> void PackedRTreeQuery(const NodeType *nodes,const uint32_t *levelEnds,uint32_t numLevels,uint32_t nodeSize,uint32_t numRecords,const T *query,std::vector<unsigned int> &indices)
+{
+    if (numLevels == 0)
+        return;
+
+    // Work down from the root, which is the very last node
+    std::vector<std::pair<uint32_t,uint32_t> > stack;
+    stack.push_back(std::make_pair(levelEnds[numLevels-1]-1,numLevels-1));
+    while (!stack.empty())
+    {
+        const uint32_t nodeIdx = stack.back().first;
+        const uint32_t level = stack.back().second;
+        stack.pop_back();
+
+        const NodeType &node = nodes[nodeIdx];
+        if (!PackedRTreeOverlaps(node.mbr,query))
+            continue;
+        if (level == 0)
+        {
+            if (node.index < numRecords)
+                indices.push_back(node.index);
+            continue;
+        }
+
+        // Children have to be on the level below
+        const uint32_t childStart = level >= 2 ? levelEnds[level-2] : 0;
+        const uint32_t childLevelEnd = levelEnds[level-1];
+        if (node.index < childStart || node.index >= childLevelEnd)
+            continue;
+        const uint32_t childEnd = node.index + std::min(nodeSize,childLevelEnd - node.index);
+        for (uint32_t ci=node.index;ci<childEnd;ci++)
+            stack.push_back(std::make_pair(ci,level-1));
+    }
+}
+
+}
@@ -0,0 +1,126 @@
+/*
+ *  ParticleSystemCPU.h
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <vector>
+#import <mutex>
+#import <functional>
+#import "VertexAttribute.h"
+#import "WhirlyTypes.h"
+#import "WorkerPool.h"
+
+namespace WhirlyKit
+{
+
+/** CPU side particle simulation.
+    This stands in for the calculation shader on renderers that can't run one
+    (no transform feedback or no GPU at all).
+
+    Particles are kept as a structure of arrays and moved with a fixed model.
+    Each frame we integrate position by velocity and work out the normalized age.
+    The vertex attributes are interpreted by name:
+      a_position (float3) is the current position and is updated every frame.
+      a_dir or a_velocity (float3) is the velocity in units per second.
+      a_startTime (float), if present, is the particle's start relative to the base time.
+        Otherwise particles start when their batch is added.
+      a_age (float), if present, is filled in with the age from 0 to 1.
+    Anything else is passed through untouched.
+
+    The results land in an interleaved copy of the vertex data, laid out just
+    like the drawable's buffer, which is then uploaded as plain vertex attributes.
+
+    Batches can be split up over several worker threads, which are started
+    the first time there's enough to do and kept for the next update.
+    This is thread safe.
+  */
+class ParticleSystemCPU
+{
+public:
+    /// Set up storage for the given attributes.  Check isValid() afterward.
+    ParticleSystemCPU(const std::vector<SingleVertexAttributeInfo> &vertAttrs,int vertexSize,
+                      int totalParticles,int batchSize,
+                      TimeInterval lifetime,TimeInterval baseTime,int numThreads);
+    virtual ~ParticleSystemCPU();
+
+    /// True if we found a position attribute and the sizes made sense
+    bool isValid() const { return valid; }
+
+    /// Number of worker threads used by update(), including the caller
+    void setNumThreads(int numThreads);
+
+    /// Use the SSE/NEON kernels where we have them.  Off runs the scalar loops, for comparison.
+    void setAllowSIMD(bool allowSIMD);
+
+    /// Load the data for a new batch.  One entry per vertex attribute, as in ParticleBatch.
+    void addBatch(unsigned int batchID,const std::vector<const void *> &attrData,TimeInterval startTime);
+
+    /// Called with a range of vertex data to upload, in bytes
+    typedef std::function<void(int offset,const void *data,int len)> UploadFunc;
+
+    /// Move everything forward to the given time and pass the live vertex data to upload
+    /// in as few contiguous runs as possible.  Returns the number of live particles.
+    int update(TimeInterval now,const UploadFunc &upload);
+
+    /// Number of particles moved in the last update
+    int getNumLive() const { return numLive; }
+
+protected:
+    // A batch of particles occupying a contiguous range
+    class Batch
+    {
+    public:
+        Batch() : active(false), startTime(0.0), lastTime(0.0) { }
+
+        bool active;
+        // Relative to the base time
+        float startTime;
+        float lastTime;
+    };
+
+    // Run the kernels over the given batches.  Returns the number of live particles.
+    int updateBatches(const int *which,int numBatches,float now);
+
+    // Copy the simulated values back into the interleaved vertex data
+    void writeBatch(int batchID);
+
+    std::mutex lock;
+    bool valid;
+    int vertexSize,totalParticles,batchSize;
+    float lifetime;
+    TimeInterval baseTime;
+    int numThreads;
+    WorkerPoolRef workers;
+    bool allowSIMD;
+    int numLive;
+
+    // Byte offsets within a vertex, or -1 if not present
+    int posOffset,velOffset,startOffset,ageOffset;
+    std::vector<int> attrSizes;
+
+    // Structure of arrays storage
+    std::vector<float> posX,posY,posZ;
+    std::vector<float> velX,velY,velZ;
+    std::vector<float> startTime,age;
+
+    std::vector<Batch> batches;
+    std::vector<unsigned char> vertexData;
+};
+typedef std::shared_ptr<ParticleSystemCPU> ParticleSystemCPURef;
+
+}
@@ -21,6 +21,7 @@
 #import "BasicDrawable.h"
 #import "Program.h"
 #import "CoordSystem.h"
+#import "ParticleSystemCPU.h"
 
 namespace WhirlyKit
 {
@@ -74,6 +75,9 @@ public:
     virtual SimpleIdentity getCalculationProgram() const;
     virtual void setCalculationProgram(SimpleIdentity newProgId);
 
+    /// If set, we move the particles on the CPU and upload them each frame
+    void setCPUSimulation(const ParticleSystemCPURef &inCPUSim);
+
     /// Program to use for rendering
     virtual SimpleIdentity getProgram() const;
     virtual void setProgram(SimpleIdentity newProgId);
@@ -138,6 +142,7 @@ protected:
     TimeInterval baseTime;
     bool usingContinuousRender;
     SimpleIdentity renderTargetID;
+    ParticleSystemCPURef cpuSim;
 
     // The vertex attributes we're representing in the buffers
     std::vector<VertexAttribute> vertexAttributes;
@@ -26,6 +26,7 @@
 #import "Scene.h"
 #import "SelectionManager.h"
 #import "ParticleSystemDrawableBuilder.h"
+#import "ParticleSystemCPU.h"
 
 namespace WhirlyKit
 {
@@ -55,6 +56,11 @@ public:
     std::vector<SingleVertexAttributeInfo> vertAttrs;
     std::vector<SingleVertexAttributeInfo> varyingAttrs;
     std::vector<SimpleIdentity> texIDs;
+    /// If set, particles are moved on the CPU rather than with calcShaderID.
+    /// See ParticleSystemCPU for the attributes it understands.
+    bool cpuCalculation;
+    /// Number of threads to use for CPU calculation
+    int cpuThreads;
 };
 
 /// Holds the data for a batch of particles
@@ -85,6 +91,8 @@ public:
     
     ParticleSystem partSys;
     std::set<ParticleSystemDrawable *> draws;
+    // Set if we're moving the particles on the CPU
+    ParticleSystemCPURef cpuSim;
 };
     
 typedef std::set<ParticleSystemSceneRep *,IdentifiableSorter> ParticleSystemSceneRepSet;
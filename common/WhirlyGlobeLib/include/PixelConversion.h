@@ -0,0 +1,50 @@
+/*
+ *  PixelConversion.h
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <stddef.h>
+#import "Texture.h"
+
+namespace WhirlyKit
+{
+
+/// Bytes per pixel for the formats we can convert RGBA into.  0 if we can't convert to it.
+int PixelConversionBytesPerPixel(TextureType format);
+
+/** Convert a run of 8 bit RGBA pixels into the given format.
+ 
+    This uses SSE2 or NEON where we have it, with a scalar loop for the tail.
+    Pass allowSIMD=false to force the scalar version, which is there for comparison.
+ 
+    The output can be the same buffer as the input.  We never write past what we've read.
+  */
+void ConvertRGBAPixelRun(TextureType format,WKSingleByteSource source,const unsigned char *rgba,unsigned char *out,size_t numPixels,bool allowSIMD = true);
+
+/** Convert a width x height RGBA image into the given format, row by row.
+ 
+    Output rows are outRowBytes apart, which must be at least width times the output pixel size.
+    Any padding at the end of a row is zeroed.
+ 
+    Rows are split into bands across numThreads workers, including the calling thread.
+    Converting in place (out == rgba) only works with a single thread.
+    Returns false if we can't convert to the format.
+  */
+bool ConvertRGBAPixels(TextureType format,WKSingleByteSource source,const unsigned char *rgba,int width,int height,unsigned char *out,int outRowBytes,int numThreads = 1);
+
+}
@@ -377,6 +377,18 @@ public:
     /// In-memory texture type
     void setTexType(TextureType texType);
     
+    /// Compress RGBA images to ETC2 on the loader threads.  Off by default.
+    /// The renderer has to take ETC2, which means OpenGL ES 3.
+    void setTextureCompression(bool compress,ETC2Quality quality);
+    
+    /// Build mipmaps for the images on the loader threads, rather than in the renderer.  Off by default.
+    /// With sRGB set, colors are averaged in linear space.  Compression wins if both are on.
+    void setTextureMipmaps(bool mipmaps,bool sRGB);
+    
+    /// Run on a loader thread once the images are in.  Gets the textures ready for the renderer,
+    ///  compressing them or building their mipmaps if we're set up to.
+    void prepareLoadedImages(QuadLoaderReturn *loadReturn);
+    
     /// Control draw priority assigned to basic drawable instances
     void setBaseDrawPriority(int newPrior);
     void setDrawPriorityPerLevel(int newPrior);
@@ -539,6 +551,10 @@ protected:
     bool requiringTopTilesLoaded;
     
     TextureType texType;
+    
+    bool compressTextures;
+    ETC2Quality compressQuality;
+    bool mipmapTextures,mipmapSRGB;
 
     // Number of focus points (1 by default)
     int numFocus;
@@ -587,6 +603,9 @@ protected:
     // True if we're trying to load something, false if we're not
     bool loadingStatus;
     
+    // Tiles we last reported to the trace counter as loading
+    int numTilesLoading;
+    
     // Default load priority values.  Used to assign loading priorities
     int topPriority;        // Top nodes, if they're special.  -1 if not
     int nearFramePriority;  // Frames next to the current one, -1 if not
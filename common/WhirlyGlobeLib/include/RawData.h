@@ -109,6 +109,11 @@ public:
     // Add a string
     virtual void addString(const std::string &str);
     
+    // Writable pointer to the data, for converting it in place
+    unsigned char *getMutableRawData();
+    // Change the length, keeping what's there.  Shrinking doesn't reallocate.
+    void resize(unsigned long size);
+    
 protected:
     std::vector<unsigned char> data;
 };
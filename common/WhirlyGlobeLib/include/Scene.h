@@ -21,10 +21,14 @@
 #import <vector>
 #import <set>
 #import <unordered_map>
+#import <deque>
+#import <thread>
+#import <condition_variable>
 #import "WhirlyVector.h"
 #import "Texture.h"
 #import "Program.h"
 #import "BasicDrawableInstance.h"
+#import "DrawableVisibilityIndex.h"
 #import "ActiveModel.h"
 #import "CoordSystem.h"
 
@@ -57,6 +61,10 @@ public:
     
     /// Create the texture on its native thread
     virtual void setupForRenderer(const RenderSetupInfo *setupInfo);
+    
+    /// Convert the texture data ahead of time
+    virtual bool needsPrepare();
+    virtual void prepare(Scene *scene,const RenderSetupInfo *setupInfo);
 
 	/// Add to the renderer.  Never call this.
 	void execute(Scene *scene,SceneRenderer *renderer,View *view);
@@ -99,9 +107,16 @@ public:
     
     /// Create the drawable on its native thread
     virtual void setupForRenderer(const RenderSetupInfo *);
+    
+    /// Build the drawable's buffers ahead of time
+    virtual bool needsPrepare();
+    virtual void prepare(Scene *scene,const RenderSetupInfo *setupInfo);
 
 	/// Add to the renderer.  Never call this
 	void execute(Scene *scene,SceneRenderer *renderer,View *view);
+    
+    /// The drawable we'll be adding
+    DrawableRef getDrawable() const { return drawRef; }
 	
 protected:
     DrawableRef drawRef;
@@ -257,6 +272,14 @@ public:
     /// True if there are pending updates
     bool hasChanges(TimeInterval now);
     
+    /// Run ChangeRequest::prepare() on this many worker threads as changes come in.
+    /// With zero, the default, changes are prepared on the render thread right before they execute.
+    /// Call this after the renderer is set.  Changes still execute in the order they were added.
+    void setPrepareThreads(int numThreads);
+    
+    /// Number of changes prepared on the workers and on the render thread since the last call
+    void getPrepareStats(int &numAhead,int &numInline,bool reset);
+    
     /// Add sub texture mappings.
     /// These are mappings from images to parts of texture atlases.
     /// They're here so we can use SimpleIdentity's to point into larger
@@ -282,6 +305,13 @@ public:
     /// Remove a drawable from the scene
     virtual void remDrawable(DrawableRef drawable);
 
+    /// Look at a drawable's visible heights and time window again, after a change
+    void updateDrawable(DrawableRef drawable);
+
+    /// Drawables that could be on at this height and time.  The rest are definitely off.
+    /// Only call this on the main thread.
+    void findVisibleDrawables(double height,TimeInterval now,std::vector<DrawableRef> &draws);
+
     /// Called once by the renderer so we can reset any managers that care
     void setRenderer(SceneRenderer *renderer);
     
@@ -346,6 +376,9 @@ public:
     
     /// All the drawables we've been handed, sorted by ID
     DrawableRefSet drawables;
+
+    /// The same drawables, sorted by when and where they can be seen
+    DrawableVisibilityIndex visibilityIndex;
     
     typedef std::unordered_map<SimpleIdentity,TextureBaseRef> TextureRefSet;
     /// Textures, sorted by ID
@@ -360,6 +393,21 @@ public:
     ChangeSet changeRequests;
     SortedChangeSet timedChangeRequests;
     
+    /// Hand changes that need it to the prepare threads.  Do this before they can execute.
+    void queuePrepare(const ChangeSet &changes);
+    /// Make sure a change is prepared, doing it here or waiting on a worker
+    void prepareChange(ChangeRequest *req);
+    void prepareThreadMain();
+    void stopPrepareThreads();
+    
+    /// Changes waiting on the prepare threads, in the order they were added
+    std::mutex prepareLock;
+    std::condition_variable prepareCond,prepareDoneCond;
+    std::deque<ChangeRequest *> prepareQueue;
+    std::vector<std::thread> prepareThreads;
+    bool prepareShutdown;
+    int numPreparedAhead,numPreparedInline;
+    
     std::mutex subTexLock;
     typedef std::set<SubTexture> SubTextureSet;
     /// Mappings from images to parts of texture atlases
@@ -80,7 +80,7 @@ public:
     Eigen::Matrix4d pvMat4d;
     Eigen::Matrix4f pvMat;
     /// If the visual view supports wrapping, these are the available offset matrices
-    std::vector<Eigen::Matrix4d> offsetMatrices;
+    Matrix4dVector offsetMatrices;
     /// Scene itself.  Don't mess with this
     Scene *scene;
     /// Expected length of the current frame
@@ -95,8 +95,9 @@ public:
     Eigen::Vector3d eyePos;
     /// Location of the middle of the screen in display coordinates
     Eigen::Vector3d dispCenter;
-    /// Height above surface, if that makes sense
-    float heightAboveSurface;
+    /// Height above surface, if that makes sense.
+    /// Computed once per frame, so use this rather than asking the view.
+    double heightAboveSurface;
     /// Screen size in display coordinates
     Point2d screenSizeInDisplayCoords;
     /// Lights, if applicable
@@ -0,0 +1,99 @@
+/*
+ *  ScreenProjectionCache.h
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <vector>
+#import "WhirlyVector.h"
+#import "WhirlyKitView.h"
+#import "WorkerPool.h"
+
+namespace WhirlyKit
+{
+
+/** The screen projection cache holds a batch of world (display space) locations
+    and projects them to the screen once for a given view state.
+
+    The locations are kept as a structure of arrays so the projection kernel
+    can run straight through them (and vectorize), optionally split across
+    a few threads.  Layout, clustering and selection add their locations,
+    project once and then read back the screen positions.
+
+    The threads are only started once there are enough points to split up
+    and then stick around with the cache, so keep the cache around too.
+
+    This isn't thread safe.  The owner is expected to protect it.
+  */
+class ScreenProjectionCache
+{
+public:
+    ScreenProjectionCache();
+
+    /// Clear out the world locations and any projections
+    void clear();
+
+    /// Reserve space for the given number of locations
+    void reserve(size_t num);
+
+    /// Add a world location in display space.  Returns the index to look it up with.
+    int addWorldLoc(const Point3d &worldLoc);
+
+    /// Number of world locations
+    size_t size() const { return worldX.size(); }
+
+    /// Project all the world locations for the given view state and frame size.
+    /// If checkFacing is set we'll also do the globe's back facing test.
+    /// This is a no-op if we've already projected for this view state.
+    void project(ViewStateRef viewState,const Point2f &frameSize,bool checkFacing);
+
+    /// True if we've got valid projections for the given view state
+    bool isProjectedFor(const ViewState *viewState,const Point2f &frameSize) const;
+
+    /// Number of offset matrices we projected against
+    int getNumOffsets() const { return numOffsets; }
+
+    /// Screen location of the given world location for the given offset matrix
+    Point2f getScreenPt(int idx,int offi) const;
+
+    /// True if the given world location faces the viewer for the given offset matrix.
+    /// Always true if we didn't do the facing check.
+    bool isFacing(int idx,int offi) const;
+
+    /// Maximum number of threads we'll split projection across.  Defaults to 4.
+    /// We won't use more than the device has.
+    void setMaxThreads(int maxThreads);
+
+protected:
+    // World locations
+    std::vector<double> worldX,worldY,worldZ;
+    // Screen locations, one run of size() per offset matrix
+    std::vector<float> screenX,screenY;
+    // Set if the location is facing the viewer, again one run per offset matrix
+    std::vector<unsigned char> facing;
+
+    // What we projected against
+    ViewStateRef viewState;
+    Point2f frameSize;
+    int numOffsets;
+    bool projected;
+    int maxThreads;
+    // Started the first time we've got enough points to split up
+    WorkerPoolRef workers;
+};
+
+}
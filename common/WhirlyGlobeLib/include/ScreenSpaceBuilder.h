@@ -250,6 +250,10 @@ public:
     Point2dVector pts;
     // Bounding box, for quick testing
     Mbr mbr;
+    // Set if whoever made this already projected it.  Then we use screenLocs instead of dispLoc.
+    bool projected;
+    // Screen locations for each offset matrix, stopping at the first one facing away
+    Point2fVector screenLocs;
 };
     
 }
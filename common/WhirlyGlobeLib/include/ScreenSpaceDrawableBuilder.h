@@ -78,6 +78,8 @@ protected:
     int offsetIndex;
     int dirIndex;
     int rotIndex;
+    VertexAttributeHandle<Eigen::Vector2f> offsetAttr;
+    VertexAttributeHandle<Eigen::Vector3f> dirAttr,rotAttr;
     TimeInterval startTime;
 };
     
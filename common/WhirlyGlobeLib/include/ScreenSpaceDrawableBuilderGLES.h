@@ -35,6 +35,9 @@ ProgramGLES *BuildScreenSpaceProgramGLES(const std::string &name,SceneRenderer *
 ProgramGLES *BuildScreenSpaceMotionProgramGLES(const std::string &name,SceneRenderer *render);
 ProgramGLES *BuildScreenSpace2DProgramGLES(const std::string &name,SceneRenderer *render);
 ProgramGLES *BuildScreenSpaceMotion2DProgramGLES(const std::string &name,SceneRenderer *render);
+/// Screen space shaders for glyphs rendered as signed distance fields
+ProgramGLES *BuildScreenSpaceSDFProgramGLES(const std::string &name,SceneRenderer *render);
+ProgramGLES *BuildScreenSpaceSDFMotionProgramGLES(const std::string &name,SceneRenderer *render);
     
 /// The OpenGL version sets uniforms
 class ScreenSpaceTweakerGLES : public ScreenSpaceTweaker
@@ -29,6 +29,7 @@
 #import "Scene.h"
 #import "ScreenSpaceBuilder.h"
 #import "VectorObject.h"
+#import "ScreenProjectionCache.h"
 
 namespace WhirlyKit
 {
@@ -293,6 +294,10 @@ protected:
     static Eigen::Matrix2d calcScreenRot(float &screenRot,ViewStateRef viewState,WhirlyGlobe::GlobeViewState *globeViewState,ScreenSpaceObjectLocation *ssObj,const Point2f &objPt,const Eigen::Matrix4d &modelTrans,const Eigen::Matrix4d &normalMat,const Point2f &frameBufferSize);
     // Projects a world coordinate to one or more points on the screen (wrapping)
     void projectWorldPointToScreen(const Point3d &worldLoc,const PlacementInfo &pInfo,Point2dVector &screenPts,float scale);
+    // Same as above, but the projections have already been done
+    void projectWorldPointToScreen(const ScreenProjectionCache &projCache,int projIndex,const PlacementInfo &pInfo,Point2dVector &screenPts,float scale);
+    // Keep the screen locations that are near the frame, scaled
+    void addScreenPoint(const Point2f &screenPt,const PlacementInfo &pInfo,Point2dVector &screenPts,float scale);
     // Convert rect selectables into more generic screen space objects
     void getScreenSpaceObjects(const PlacementInfo &pInfo,std::vector<ScreenSpaceObjectLocation> &screenObjs,TimeInterval now);
     // Internal object picking method
@@ -308,6 +313,8 @@ protected:
     WhirlyKit::MovingPolytopeSelectableSet movingPolytopeSelectables;
     WhirlyKit::LinearSelectableSet linearSelectables;
     WhirlyKit::BillboardSelectableSet billboardSelectables;
+    // Reused for each pick so its threads stick around.  Protected by the mutex.
+    ScreenProjectionCache projCache;
 };
  
 }
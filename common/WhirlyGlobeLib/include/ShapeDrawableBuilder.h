@@ -42,6 +42,8 @@ public:
     RGBAColor color;
     float lineWidth;
     bool insideOut;
+    /// If set, spheres, cylinders and circles are drawn as instances of a shared unit mesh
+    bool instanced;
     bool hasCenter;
     WhirlyKit::Point3d center;
 };
@@ -22,14 +22,36 @@
 #import "SelectionManager.h"
 #import "Scene.h"
 #import "ShapeDrawableBuilder.h"
+#import "BasicDrawableInstance.h"
 #include <vector>
 #include <set>
+#include <map>
 
 
 namespace WhirlyKit {
     
 class GeometryRaw;
 
+/// Shapes we can draw as instances of a shared unit mesh
+typedef enum {ShapeMeshCircle=1,ShapeMeshSphere,ShapeMeshCylinder} ShapeMeshType;
+
+/** Identifies a unit mesh that can be shared between shapes.
+    Shapes of the same type and tesselation use the same one.
+  */
+class ShapeMeshKey
+{
+public:
+    ShapeMeshKey() : type(ShapeMeshCircle), sampleX(0), sampleY(0), insideOut(false) { }
+    ShapeMeshKey(ShapeMeshType type,int sampleX,int sampleY,bool insideOut)
+    : type(type), sampleX(sampleX), sampleY(sampleY), insideOut(insideOut) { }
+
+    bool operator < (const ShapeMeshKey &that) const;
+
+    ShapeMeshType type;
+    int sampleX,sampleY;
+    bool insideOut;
+};
+
 /// Used internally to track shape related resources
 class ShapeSceneRep : public Identifiable
 {
@@ -46,6 +68,7 @@ public:
 
     SimpleIDSet drawIDs;  // Drawables created for this
     SimpleIDSet selectIDs;  // IDs in the selection layer
+    std::vector<ShapeMeshKey> meshKeys;  // Unit meshes our instances refer to
     float fade;  // Time to fade away for removal
 };
     
@@ -64,6 +87,10 @@ public:
 	virtual void makeGeometryWithBuilder(WhirlyKit::ShapeDrawableBuilder *regBuilder, WhirlyKit::ShapeDrawableBuilderTri *triBuilder, WhirlyKit::Scene *scene, SelectionManager *selectManager, ShapeSceneRep *sceneRep);
     virtual Point3d displayCenter(CoordSystemDisplayAdapter *coordAdapter, const ShapeInfo &shapeInfo);
 
+    /// Shapes that can be drawn as a scaled and rotated copy of a unit mesh fill in
+    ///  the mesh they want and the placement.  Returns false if we need real geometry.
+    virtual bool makeInstance(WhirlyKit::Scene *scene, const ShapeInfo &shapeInfo, SelectionManager *selectManager, ShapeSceneRep *sceneRep, ShapeMeshKey &meshKey, BasicDrawableInstance::SingleInstance &inst);
+
 public:
     bool isSelectable;
     WhirlyKit::SimpleIdentity selectID;
@@ -83,6 +110,7 @@ public:
     
     virtual void makeGeometryWithBuilder(WhirlyKit::ShapeDrawableBuilder *regBuilder, WhirlyKit::ShapeDrawableBuilderTri *triBuilder, WhirlyKit::Scene *scene, SelectionManager *selectManager, ShapeSceneRep *sceneRep);
     virtual Point3d displayCenter(CoordSystemDisplayAdapter *coordAdapter, const ShapeInfo &shapeInfo);
+    virtual bool makeInstance(WhirlyKit::Scene *scene, const ShapeInfo &shapeInfo, SelectionManager *selectManager, ShapeSceneRep *sceneRep, ShapeMeshKey &meshKey, BasicDrawableInstance::SingleInstance &inst);
     
 public:
     /// The location for the origin of the shape
@@ -93,6 +121,10 @@ public:
     double height;
     /// Number of samples to use in the circle
     int sampleX;
+
+protected:
+    // Selection box in local coordinates
+    void addSelectionBox(const Point3d &bot,const Point3d &top,const ShapeInfo &shapeInfo,SelectionManager *selectManager,ShapeSceneRep *sceneRep);
 };
 
 /// This puts a sphere around the location
@@ -106,12 +138,17 @@ public:
 
     virtual void makeGeometryWithBuilder(WhirlyKit::ShapeDrawableBuilder *regBuilder, WhirlyKit::ShapeDrawableBuilderTri *triBuilder, WhirlyKit::Scene *scene, SelectionManager *selectManager, ShapeSceneRep *sceneRep);
     virtual Point3d displayCenter(CoordSystemDisplayAdapter *coordAdapter, const ShapeInfo &shapeInfo);
+    virtual bool makeInstance(WhirlyKit::Scene *scene, const ShapeInfo &shapeInfo, SelectionManager *selectManager, ShapeSceneRep *sceneRep, ShapeMeshKey &meshKey, BasicDrawableInstance::SingleInstance &inst);
 
 public:
     WhirlyKit::GeoCoord loc;
     float height;
     float radius;
     int sampleX, sampleY;
+
+protected:
+    // Selection box around the center
+    void addSelectionBox(const Point3d &dispPt,const ShapeInfo &shapeInfo,SelectionManager *selectManager,ShapeSceneRep *sceneRep);
 };
     
 /// This puts a cylinder with its base at the locaton
@@ -125,6 +162,7 @@ public:
     
     virtual void makeGeometryWithBuilder(WhirlyKit::ShapeDrawableBuilder *regBuilder, WhirlyKit::ShapeDrawableBuilderTri *triBuilder, WhirlyKit::Scene *scene, SelectionManager *selectManager, ShapeSceneRep *sceneRep);
     virtual Point3d displayCenter(CoordSystemDisplayAdapter *coordAdapter, const ShapeInfo &shapeInfo);
+    virtual bool makeInstance(WhirlyKit::Scene *scene, const ShapeInfo &shapeInfo, SelectionManager *selectManager, ShapeSceneRep *sceneRep, ShapeMeshKey &meshKey, BasicDrawableInstance::SingleInstance &inst);
 
 public:
     /// The location for the origin of the shape
@@ -137,6 +175,10 @@ public:
     double height;
     /// Samples around the outside
     int sampleX;
+
+protected:
+    // Selection box around the base and up by the height
+    void addSelectionBox(const Point3d &dispPt,const Point3d &norm,const Point3d &xAxis,const Point3d &yAxis,const ShapeInfo &shapeInfo,SelectionManager *selectManager,ShapeSceneRep *sceneRep);
 };
 
 /** A linear feature (with width) that we'll draw on
@@ -221,6 +263,12 @@ public:
 
 /** The Shape Manager is used to create and destroy geometry for shapes like circles, cylinders,
  and so forth.  It's entirely thread safe (except for destruction).
+ 
+ If ShapeInfo::instanced is set, spheres, cylinders and circles are drawn as instances of
+ a unit mesh shared by every shape with the same tesselation.  Each shape is then just a
+ center, a matrix and a color.  Those instances use the default model shader.
+ The unit mesh goes into the change set of the first group that needs it, so those change
+ sets should be flushed in the order they were made.
  */
 class ShapeManager : public SceneManager
 {
@@ -244,8 +292,29 @@ public:
     void setUniformBlock(const SimpleIDSet &shapeIDs,const RawDataRef &uniBlock,int bufferID,ChangeSet &changes);
 
 protected:
+    /// A hidden drawable holding a unit mesh and the number of shape groups using it
+    class UnitMesh
+    {
+    public:
+        UnitMesh() : drawID(EmptyIdentity), refs(0) { }
+
+        SimpleIdentity drawID;
+        int refs;
+    };
+    typedef std::map<ShapeMeshKey,UnitMesh> UnitMeshMap;
+
+    // Add the shapes that can be instanced.  Returns the ones that need their own geometry.
+    std::vector<Shape*> addShapeInstances(const std::vector<Shape*> &shapes,const ShapeInfo &shapeInfo,SelectionManager *selectManager,ShapeSceneRep *sceneRep,ChangeSet &changes);
+
+    // Build the geometry for a unit mesh.  Returns NULL if it won't fit in a drawable.
+    BasicDrawableBuilderRef buildUnitMesh(const ShapeMeshKey &meshKey);
+
+    // Release the unit meshes used by a scene rep.  Need to be locked.
+    void releaseUnitMeshesLocked(ShapeSceneRep *sceneRep,ChangeSet &changes,TimeInterval when);
+
     std::mutex shapeLock;
     ShapeSceneRepSet shapeReps;
+    UnitMeshMap unitMeshes;
 };
 
 }
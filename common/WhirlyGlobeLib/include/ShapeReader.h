@@ -19,6 +19,7 @@
  */
 
 #import <math.h>
+#import <stdint.h>
 #import "VectorData.h"
 #import "GlobeMath.h"
 
@@ -27,6 +28,13 @@ namespace WhirlyKit
 
 /** Shape File Reader.
 	Open a shapefile and return the features as requested.
+ 
+    For bounding box queries we use a spatial index.  If there's a .qix
+    next to the shapefile (as written by shptree or mapserver) we'll use that.
+    Otherwise we build a packed Hilbert R-tree from the record bounds and try
+    to save it next to the shapefile as a .wkix for the next time.
+ 
+    A reader is not thread safe.
  */
 class ShapeReader : public VectorReader
 {
@@ -50,11 +58,58 @@ public:
     /// Fetch an object by the index
     virtual VectorShapeRef getObjectByIndex(unsigned int vecIndex,const StringSet *filter);
     
+    /// Load or build the spatial index.  This happens on the first query if you don't call it.
+    /// If indexFile is set, we'll read our own index from there (or write it there).
+    bool loadSpatialIndex(const std::string &indexFile = std::string());
+
+    /// Return the indices of the shapes whose bounding boxes overlap the given one (in radians)
+    void queryMbr(const Mbr &mbr,std::vector<unsigned int> &indices);
+
+    /// Read the shapes overlapping the given bounding box (in radians).
+    /// Only the attributes in filterAttrs are read, if it's set.
+    void getObjectsInMbr(const Mbr &mbr,const StringSet *filterAttrs,ShapeSet &shapes);
+
 protected:
+    /// A single DBF field we'll be reading
+    class Column
+    {
+    public:
+        int field;
+        int type;
+        std::string name;
+    };
+
+    // A node in the packed R-tree.  Leaves point to records, the rest to their first child.
+    typedef struct
+    {
+        double mbr[4];
+        uint32_t index;
+        uint32_t pad;
+    } IndexNode;
+
+    // Build the DBF columns we want for the given filter
+    void setupColumns(const StringSet *filterAttrs,std::vector<Column> &cols);
+    // Read a shape and the given columns from its attribute record
+    VectorShapeRef readObject(unsigned int vecIndex,const std::vector<Column> &cols);
+    // Read a record's bounding box (in degrees) straight out of the SHP file
+    bool readRecordMbr(unsigned int vecIndex,double *mbr);
+    // Build the packed R-tree from the record bounds
+    void buildIndex();
+    bool readIndex(const std::string &indexFile);
+    bool writeIndex(const std::string &indexFile);
+
 	void *shp;
 	void *dbf;
 	int where,numEntity,shapeType;
 	double minBound[4], maxBound[4];
+    std::string baseName;
+    // All the DBF fields, for when there's no filter
+    std::vector<Column> allCols;
+
+    bool indexLoaded;
+    void *qixTree;
+    std::vector<IndexNode> indexNodes;
+    std::vector<uint32_t> indexLevels;
 };
 
 }
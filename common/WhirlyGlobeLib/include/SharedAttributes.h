@@ -105,6 +105,8 @@
 
 #define MaplyScreenSpaceDefaultMotionShader WKString("Default Screenspace Motion")
 #define MaplyScreenSpaceDefaultShader WKString("Default Screenspace")
+#define MaplyScreenSpaceSDFMotionShader WKString("Default Screenspace SDF Motion")
+#define MaplyScreenSpaceSDFShader WKString("Default Screenspace SDF")
 
 #define MaplyParticleSystemPointDefaultShader WKString("Default Part Sys (Point)")
 
@@ -258,6 +260,17 @@
 /// Clip features along a grid of the given size
 #define MaplySubdivGrid WKString("grid")
 
+/// If set, simplify the vectors to this many screen pixels at the simplification level
+#define MaplyVecSimplifyTolerance WKString("simplifytolerance")
+/// Zoom level the simplification tolerance is measured at
+#define MaplyVecSimplifyLevel WKString("simplifylevel")
+/// Simplification algorithm.  Douglas-Peucker is the default.
+#define MaplyVecSimplifyType WKString("simplifytype")
+/// Douglas-Peucker line simplification
+#define MaplyVecSimplifyDouglasPeucker WKString("douglaspeucker")
+/// Visvalingam-Whyatt line simplification
+#define MaplyVecSimplifyVisvalingam WKString("visvalingam")
+
 /// These are used for stickers
 
 /// Sampling size along one dimension
@@ -313,6 +326,8 @@
 
 /// Turn the shape inside out (used for spheres and atmosphere)
 #define MaplyShapeInsideOut WKString("shapeinsideout")
+/// Draw spheres, cylinders and circles as instances of a shared unit mesh
+#define MaplyShapeInstanced WKString("shapeinstanced")
 #define MaplyShapeCenterX WKString("shapecenterx")
 #define MaplyShapeCenterY WKString("shapecentery")
 #define MaplyShapeCenterZ WKString("shapecenterz")
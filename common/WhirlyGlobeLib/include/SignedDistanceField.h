@@ -0,0 +1,117 @@
+/*
+ *  SignedDistanceField.h
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <map>
+#import <string>
+#import <vector>
+#import <stdint.h>
+#import "WhirlyVector.h"
+
+namespace WhirlyKit
+{
+
+/** Turn 8 bit coverage into a signed distance field.
+ 
+    This is the exact Euclidean distance transform from Felzenszwalb and Huttenlocher,
+    run once for the inside and once for the outside of the shape.  The output is
+    padded by spread on every side, so it's (width+2*spread) by (height+2*spread).
+    Values are 128 on the edge, 255 at spread pixels inside and 0 at spread pixels outside.
+ 
+    Coverage is read every pixelStride bytes, with rowBytes between rows.
+    The column and row passes are split across numThreads workers for larger inputs.
+    Pass 0 to use the number of cores.
+  */
+void GenerateSignedDistanceField(const unsigned char *coverage,int width,int height,int pixelStride,int rowBytes,int spread,std::vector<unsigned char> &field,int numThreads = 0);
+
+/// Input for one of a batch of distance fields
+class SDFSource
+{
+public:
+    const unsigned char *coverage;
+    int width,height;
+    int pixelStride,rowBytes;
+};
+
+/// Generate a batch of distance fields, spreading the sources across numThreads workers.
+/// This is the better way to go for glyphs, which are too small to split up individually.
+void GenerateSignedDistanceFields(const std::vector<SDFSource> &sources,int spread,std::vector<std::vector<unsigned char> > &fields,int numThreads = 0);
+
+/// A glyph's distance field at the reference size, along with its metrics
+class SDFGlyph
+{
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW;
+
+    SDFGlyph() : width(0), height(0), size(0,0), offset(0,0), textureOffset(0,0) { }
+
+    // Size of the field, including the padding
+    int width,height;
+    // Metrics at the reference size.  The texture offset includes the padding.
+    Point2f size,offset,textureOffset;
+    std::vector<unsigned char> field;
+};
+
+/** Distance fields for glyphs, keyed by font and glyph.
+ 
+    A distance field doesn't depend on the size, color or outline it's drawn with,
+    so one of these covers every variant of a font.  That also makes it worth
+    saving to disk, so we don't have to rasterize the common glyphs on the next run.
+  */
+class SDFGlyphCache
+{
+public:
+    SDFGlyphCache();
+
+    /// Set the reference size and spread.  Clears out anything built with different ones.
+    void setParams(float refSize,int spread);
+
+    /// Look for a glyph's distance field.  Returns NULL if we haven't got it.
+    const SDFGlyph *findGlyph(const std::string &fontKey,uint32_t glyph) const;
+
+    /// Add a glyph's distance field, replacing any that's there
+    const SDFGlyph *addGlyph(const std::string &fontKey,uint32_t glyph,const SDFGlyph &sdfGlyph);
+
+    /// Read in glyphs saved with writeToFile().
+    /// Files written with a different reference size or spread are ignored.
+    bool readFromFile(const std::string &fileName);
+
+    /// Write out all the glyphs.  We write to a temporary file and move it over at the end.
+    bool writeToFile(const std::string &fileName);
+
+    /// True if there are glyphs we haven't written out
+    bool isDirty() const { return dirty; }
+
+    /// Number of glyphs in the cache
+    int numGlyphs() const { return (int)glyphs.size(); }
+
+    /// Forget all the glyphs
+    void clear();
+
+protected:
+    typedef std::pair<std::string,uint32_t> GlyphKey;
+    typedef std::map<GlyphKey,SDFGlyph,std::less<GlyphKey>,Eigen::aligned_allocator<std::pair<const GlyphKey,SDFGlyph> > > GlyphMap;
+
+    float refSize;
+    int spread;
+    bool dirty;
+    GlyphMap glyphs;
+};
+
+}
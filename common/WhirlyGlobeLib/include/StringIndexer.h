@@ -22,6 +22,8 @@
 #import <unordered_map>
 #import <string>
 #import <mutex>
+#import <atomic>
+#import <memory>
 
 namespace WhirlyKit
 {
@@ -87,11 +89,16 @@ extern StringIdentity a_modelCenterNameID;
 extern StringIdentity a_useInstanceColorNameID;
 extern StringIdentity a_instanceColorNameID;
 extern StringIdentity a_modelDirNameID;
+extern StringIdentity a_sdfParamsNameID;
 
 /** Globally indexes strings by ID.  This lets us use an ID rather
  than a string in certain high performance unordered maps and such.
  
  Only adds strings.  Never removes them.
+ 
+ Looking up strings and IDs that already exist doesn't lock.
+ Strings are kept in an append only table that's never moved, so
+ the references from getString() are good forever.
  */
 class StringIndexer
 {
@@ -99,21 +106,63 @@ public:
     // Return or make up a string identity
     static StringIdentity getStringID(const std::string &);
     
-    // Return the string for a string identity
-    static std::string getString(StringIdentity);
+    // Return the string for a string identity.  Empty if it's not a valid ID.
+    static const std::string &getString(StringIdentity);
+    
+    // Return the identity for the first element of an array with the given name.
+    // That is, "name[0]" for "name".  Only works the string out once per name.
+    static StringIdentity getIndexedStringID(StringIdentity);
     
 public:
     StringIndexer(StringIndexer const&)     = delete;
     void operator=(StringIndexer const&)    = delete;
     
 protected:
-    StringIndexer() { }
+    StringIndexer();
+    ~StringIndexer();
     
     static StringIndexer &getInstance();
     
+    // A single string and the things we work out from it
+    class Entry
+    {
+    public:
+        Entry();
+        
+        std::string str;
+        std::atomic<StringIdentity> indexedID;
+    };
+    
+    // Open addressing table from string hash to ID.
+    // Replaced with a bigger one when it fills up, never resized in place.
+    class HashTable
+    {
+    public:
+        HashTable(unsigned int size);
+        
+        unsigned int mask;
+        // Hash in the high bits, ID+1 in the low bits.  Zero is empty.
+        std::unique_ptr<std::atomic<uint64_t>[]> slots;
+    };
+    
+    static uint32_t hashString(const std::string &str);
+    
+    // Look for the string in the current table
+    bool lookup(const std::string &str,uint32_t hash,StringIdentity &strID);
+    // Add an entry to the given hash table.  Need the lock.
+    void insertLocked(HashTable *table,uint32_t hash,StringIdentity strID);
+    // Entry for the given ID, which must be valid
+    Entry *getEntry(StringIdentity strID);
+    
+    // Only taken for adding strings
     std::mutex mutex;
-    std::unordered_map<std::string,StringIdentity> stringToIdent;
-    std::vector<std::string> identToString;
+    std::atomic<unsigned int> numStrings;
+    // Each segment is twice the size of the last
+    static const int NumSegments = 26;
+    std::atomic<Entry *> segments[NumSegments];
+    std::atomic<HashTable *> table;
+    // Readers may still be looking at old tables, so we keep them
+    std::vector<std::unique_ptr<HashTable> > tables;
 };
 
 }
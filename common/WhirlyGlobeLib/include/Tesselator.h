@@ -31,8 +31,20 @@ void TesselateRing(const WhirlyKit::VectorRing &ring,VectorTrianglesRef tris);
 
 /** Tesselate the given areal feature.  The first ring is the outer,
     all others are meant to be holes.
+    We try the ear clipper first and fall back to libtess if that fails.
   */
 void TesselateLoops(const std::vector<VectorRing> &loops,VectorTrianglesRef tris);
 
+/** Tesselate the given areal feature with the ear clipper.
+    Returns false, adding nothing, if the result doesn't cover the right area.
+    That happens with self-intersections and holes outside the outer loop.
+  */
+bool TesselateLoopsEarcut(const std::vector<VectorRing> &loops,VectorTrianglesRef tris);
+
+/** Tesselate the given areal feature with libtess.
+    Slower, but handles self-intersecting and overlapping loops.
+  */
+void TesselateLoopsLibtess(const std::vector<VectorRing> &loops,VectorTrianglesRef tris);
+
 
 }
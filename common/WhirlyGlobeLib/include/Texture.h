@@ -20,6 +20,7 @@
 
 #import "Platform.h"
 #import "RawData.h"
+#import "ETC2Encoder.h"
 #import "Identifiable.h"
 #import "WhirlyVector.h"
 #import "BasicDrawable.h"
@@ -41,6 +42,9 @@ public:
     
     /// Render side only.  Don't call this.  Create the openGL version
     virtual bool createInRenderer(const RenderSetupInfo *setupInfo) = 0;
+    
+    /// Do the CPU side of createInRenderer() ahead of time.  This may be called on a worker thread.
+    virtual void prepareForRenderer(const RenderSetupInfo *setupInfo);
 	
 	/// Render side only.  Don't call this.  Destroy the openGL version
     virtual void destroyInRenderer(const RenderSetupInfo *setupInfo,Scene *scene) = 0;
@@ -90,10 +94,18 @@ public:
     void setRawData(RawData *rawData,int width,int height);
 	    
     /// Process the data for display based on the format.
+    /// If we're the only one holding the RGBA data, it's converted in place and kept.
     RawDataRef processData();
     
+    /// Split format conversion across this many threads.  More than one turns off in place conversion.
+    void setConvertThreads(int numThreads) { convertThreads = numThreads; }
+    
     /// Set up from raw PKM (ETC2/EAC) data
     void setPKMData(RawDataRef data);
+    
+    /// Compress RGBA data to ETC2 and use that instead.  Fully opaque images lose their alpha.
+    /// Returns false if the data isn't width x height RGBA or we're using mipmaps, which GLES won't build for us.
+    bool compressETC2(ETC2Quality quality,int numThreads = 1);
 	
     /// Set the texture width
     void setWidth(unsigned int newWidth) { width = newWidth; }
@@ -105,6 +117,13 @@ public:
     int getHeight() { return height; }
     /// Set this to have a mipmap generated and used for minification
     void setUsesMipmaps(bool use) { usesMipmaps = use; }
+    
+    /// Build the mipmap levels here, rather than leaving it to the renderer.
+    /// Converts to the format along the way.  With sRGB set, colors are averaged in linear space.
+    /// Returns false if the data isn't width x height RGBA or the format isn't one we can convert to.
+    bool buildMipmaps(bool sRGB);
+    /// Mipmap levels past the base, if we built them
+    const std::vector<RawDataRef> &getMipLevels() { return mipLevels; }
     /// Set this to let the texture wrap in the appropriate directions
     void setWrap(bool inWrapU,bool inWrapV) { wrapU = inWrapU;  wrapV = inWrapV; }
     
@@ -115,10 +134,16 @@ public:
 
     /// Raw texture data
     RawDataRef texData;
+    /// Mipmap levels below texData, already converted
+    std::vector<RawDataRef> mipLevels;
 
 protected:
     /// Used by subclass
     Texture();
+    
+    /// Convert RGBA data to the texture format with the pixel conversion kernels.
+    /// Returns nothing if the data doesn't look like width x height RGBA.
+    RawDataRef convertRGBA();
 
     /// Need to know how we're going to load it
 	bool isPVRTC;
@@ -135,6 +160,9 @@ protected:
     bool usesMipmaps;
     bool wrapU,wrapV;
     bool isEmptyTexture;
+    /// Set if texData has already been converted to the format
+    bool texDataConverted;
+    int convertThreads;
 };
     
 typedef std::shared_ptr<Texture> TextureRef;
@@ -63,6 +63,9 @@ public:
     /// Render side only.  Don't call this.  Create the openGL version
     virtual bool createInRenderer(const RenderSetupInfo *setupInfo);
     
+    /// Convert the data to the texture format now, rather than in createInRenderer()
+    virtual void prepareForRenderer(const RenderSetupInfo *setupInfo);
+    
     /// Render side only.  Don't call this.  Destroy the openGL version
     virtual void destroyInRenderer(const RenderSetupInfo *setupInfo,Scene *scene);
 
@@ -71,6 +74,8 @@ public:
     static unsigned char *ResolvePKM(RawDataRef texData,int &pkmType,int &size,int &width,int &height);
 
 protected:
+    /// Upload one level of uncompressed data in our format
+    void uploadLevel(int level,int levelWidth,int levelHeight,const void *data);
 };
     
 typedef std::shared_ptr<TextureGLES> TextureGLESRef;
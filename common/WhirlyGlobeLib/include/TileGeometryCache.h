@@ -0,0 +1,294 @@
+/*
+ *  TileGeometryCache.h
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <stdio.h>
+#import <list>
+#import <set>
+#import <map>
+#import <mutex>
+#import "WhirlyVector.h"
+#import "QuadTreeNew.h"
+#import "BasicDrawable.h"
+#import "RawData.h"
+
+namespace WhirlyKit
+{
+
+class VectorTileData;
+class VectorManager;
+class WideVectorManager;
+class ComponentManager;
+class MapboxVectorStyleSetImpl;
+class PlatformThreadInfo;
+class SceneRenderer;
+
+/** The Tile Geometry Cache holds the finished drawables for vector tiles
+    so that a tile we've seen before can skip parsing, styling and building.
+
+    Entries are keyed by tile ID, the style set's generation and a hash of
+    the source data.  For each style we keep the vertex, triangle and attribute
+    arrays of its drawables along with enough of the component objects to
+    rebuild them.  Revisiting a tile creates fresh drawables straight from
+    those arrays.
+
+    The cache is an LRU with a memory budget.  If a spill directory is set,
+    entries pushed out of memory are written there and read back on demand.
+    Spilled files are only good for this run, since they refer to
+    string, program and texture IDs.
+
+    Only styles whose output is entirely basic drawables owned by regular and
+    wide vectors are cached.  The rest (labels, markers, selectable features)
+    are left out of the entry and rebuilt from the source data each time,
+    as is any tile with images.
+
+    This is thread safe.
+  */
+class TileGeometryCache
+{
+public:
+    /// Construct with a memory budget in bytes.  If spillDir is set we'll
+    ///  write evicted tiles there, up to diskBudget bytes.
+    TileGeometryCache(size_t memoryBudget,size_t diskBudget = 0,const std::string &spillDir = std::string());
+    virtual ~TileGeometryCache();
+
+    /// Hit rate and size statistics
+    class Stats
+    {
+    public:
+        Stats();
+
+        /// Fraction of lookups that were found in memory or on disk
+        double hitRate() const;
+
+        // Partial hits still had to build some of their styles
+        unsigned long long hits,diskHits,partialHits,misses;
+        // Partial stores left out some of their styles
+        unsigned long long stores,partialStores,evictions,spills;
+        size_t memoryUsed,diskUsed;
+        int numInMemory,numOnDisk;
+    };
+
+    /// Change the memory budget.  Evicts immediately if we're over.
+    void setMemoryBudget(size_t memoryBudget);
+
+    /// Change the on-disk budget.  Zero turns off spilling.
+    void setDiskBudget(size_t diskBudget);
+
+    /// Return the current statistics
+    Stats getStats();
+
+    /// Reset the hit/miss counts, but not the contents
+    void resetStats();
+
+    /// Throw out everything, including anything we've spilled to disk
+    void clear();
+
+    /// Hash the raw tile data.  Part of the key.
+    static unsigned long long hashData(RawData *rawData);
+
+    /// Raw contents of a single vertex attribute
+    class AttributeData
+    {
+    public:
+        BDAttributeDataType dataType;
+        StringIdentity nameID;
+        unsigned char defaultData[16];
+        int numElements;
+        std::vector<unsigned char> data;
+    };
+
+    /// Everything we need to rebuild a basic drawable
+    class DrawableData
+    {
+    public:
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW;
+
+        DrawableData();
+
+        /// Copy the state and data out of an unprocessed drawable
+        bool copyFrom(BasicDrawable *draw);
+
+        /// Approximate memory used
+        size_t getSize() const;
+
+        std::string name;
+        GeometryType type;
+        bool on;
+        TimeInterval startEnable,endEnable;
+        TimeInterval fadeUp,fadeDown;
+        float minVisible,maxVisible;
+        float minVisibleFadeBand,maxVisibleFadeBand;
+        double minViewerDist,maxViewerDist;
+        Point3d viewerCenter;
+        unsigned int drawPriority;
+        float drawOffset;
+        bool isAlpha;
+        bool motion;
+        int extraFrames;
+        SimpleIdentity programId;
+        SimpleIdentity renderTargetID;
+        Mbr localMbr;
+        float lineWidth;
+        bool requestZBuffer,writeZBuffer;
+        bool hasMatrix;
+        Eigen::Matrix4d mat;
+        RGBAColor color;
+        bool hasOverrideColor;
+        bool clipCoords;
+        int colorEntry,normalEntry;
+        std::vector<BasicDrawable::TexInfo> texInfo;
+        SingleVertexAttributeSet uniforms;
+
+        std::vector<Eigen::Vector3f> points;
+        std::vector<BasicDrawable::Triangle> tris;
+        std::vector<AttributeData> attrs;
+
+        // Wide vectors carry their settings in a tweaker
+        bool hasWideTweaker;
+        bool realWidthSet;
+        float realWidth,edgeSize,tweakLineWidth,texRepeat;
+        RGBAColor tweakColor;
+        // Any tweakers, if we're still in memory
+        DrawableTweakerRefSet tweakers;
+    };
+
+    /// What we need to rebuild a single component object
+    class ComponentData
+    {
+    public:
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW;
+
+        ComponentData();
+
+        std::vector<int> drawables;
+        Point2d vectorOffset;
+        bool enable;
+    };
+
+    /// Everything a single style built for a tile
+    class StyleEntry
+    {
+    public:
+        StyleEntry();
+
+        /// Approximate memory used
+        size_t getSize() const;
+
+        long long styleID;
+        std::vector<DrawableData,Eigen::aligned_allocator<DrawableData> > drawables;
+        std::vector<ComponentData,Eigen::aligned_allocator<ComponentData> > compObjs;
+    };
+
+    /// A single cached tile
+    class TileEntry
+    {
+    public:
+        TileEntry();
+
+        /// Capture the drawables and component objects a style built into its own tile data.
+        /// Returns false, leaving the style out, if it built anything we can't reproduce.
+        bool addStyle(long long styleID,MapboxVectorStyleSetImpl *styleSet,VectorTileData *styleData);
+
+        /// Return the given style's contents, if we have them
+        const StyleEntry *findStyle(long long styleID) const;
+
+        /// Approximate memory used
+        size_t getSize() const;
+
+        /// Write to an open file.  Returns false on failure.
+        bool write(FILE *fp) const;
+
+        /// Read from an open file.  Returns false on failure.
+        bool read(FILE *fp);
+
+        // Sorted by style ID
+        std::vector<StyleEntry> styles;
+        // False if some of the styles, or images, have to be built from the source data
+        bool complete;
+        // False if we've got tweakers we can't write out
+        bool canSpill;
+        size_t size;
+    };
+    typedef std::shared_ptr<TileEntry> TileEntryRef;
+
+    /// Look for the given tile.  Returns NULL on a miss.
+    TileEntryRef findTile(const QuadTreeIdentifier &ident,int styleGeneration,unsigned long long dataHash);
+
+    /// Rebuild the drawables and component objects for one of a tile's styles into that style's tile data.
+    /// The style set's vector manager has to have a renderer.
+    void restoreStyle(PlatformThreadInfo *inst,const StyleEntry &styleEntry,
+                      MapboxVectorStyleSetImpl *styleSet,VectorTileData *styleData);
+
+    /// Keep a tile built up with TileEntry::addStyle() around for next time
+    void addTile(const QuadTreeIdentifier &ident,int styleGeneration,unsigned long long dataHash,TileEntryRef entry);
+
+protected:
+    // Cache key
+    class Key
+    {
+    public:
+        Key(const QuadTreeIdentifier &ident,int styleGeneration,unsigned long long dataHash)
+        : ident(ident), styleGeneration(styleGeneration), dataHash(dataHash) { }
+
+        bool operator < (const Key &that) const;
+
+        QuadTreeIdentifier ident;
+        int styleGeneration;
+        unsigned long long dataHash;
+    };
+
+    // What we keep for a given key, either in memory or on disk
+    class Slot
+    {
+    public:
+        Slot() : diskSize(0) { }
+
+        TileEntryRef entry;
+        std::list<Key>::iterator memIt;
+        std::list<Key>::iterator diskIt;
+        size_t diskSize;
+    };
+    typedef std::map<Key,Slot> SlotMap;
+
+    // Build a drawable from the cached version
+    BasicDrawable *buildDrawable(SceneRenderer *renderer,const DrawableData &drawData);
+
+    // Push things out of memory and disk until we fit.  Need to be locked.
+    void enforceBudgetsLocked();
+    // Remove the disk version of the given slot.  Need to be locked.
+    void removeDiskLocked(SlotMap::iterator it);
+
+    // File name for a given key
+    std::string fileNameForKey(const Key &key) const;
+
+    std::mutex lock;
+    size_t memoryBudget,diskBudget;
+    std::string spillDir;
+    // Distinguishes our spill files from any other run's
+    std::string sessionName;
+
+    SlotMap slots;
+    // Most recently used at the front
+    std::list<Key> memLRU,diskLRU;
+    Stats stats;
+};
+typedef std::shared_ptr<TileGeometryCache> TileGeometryCacheRef;
+
+}
@@ -288,7 +288,9 @@ public:
     virtual VectorShapeRef getObjectByIndex(unsigned int vecIndex,const StringSet *filter)  { return VectorShapeRef(); }
 };
 
+/// Read a whole vector file into memory.  See VectorIndexedFile for random and spatial access.
 bool VectorReadFile(const std::string &fileName,ShapeSet &shapes);
+/// Write shapes to an indexed vector file.  See VectorWriteIndexedFile.
 bool VectorWriteFile(const std::string &fileName,ShapeSet &shapes);
 
 /** Helper routine to parse geoJSON into a collection of vectors.
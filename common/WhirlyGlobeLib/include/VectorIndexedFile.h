@@ -0,0 +1,191 @@
+/*
+ *  VectorIndexedFile.h
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <stdint.h>
+#import "VectorData.h"
+
+namespace WhirlyKit
+{
+
+/// Current version of the indexed vector file format
+#define VectorIndexedFileVersion 1
+
+/// Shape types stored in an indexed vector file
+typedef enum {VectorIndexedPoints=1,VectorIndexedLinear,VectorIndexedAreal,VectorIndexedTriangles} VectorIndexedShapeType;
+
+/** Write a group of shapes to an indexed vector file.
+    Features are sorted along a Hilbert curve and indexed with a packed R-tree.
+    Attributes are stored by column.  Returns false on failure.
+  */
+bool VectorWriteIndexedFile(const std::string &fileName,const ShapeSet &shapes);
+
+class VectorIndexedFile;
+
+/** A zero copy view of a single feature in an indexed vector file.
+    The pointers refer to the mapped file and are only good while it's open.
+  */
+class VectorShapeView
+{
+public:
+    VectorShapeView();
+
+    /// True if this refers to an actual feature
+    bool isValid() const { return file != NULL; }
+
+    /// Index of the feature within the file
+    unsigned int getIndex() const { return index; }
+
+    /// Type of the feature
+    VectorIndexedShapeType getType() const;
+
+    /// Bounding box in the file's coordinates (usually radians)
+    Mbr getMbr() const;
+
+    /// Number of rings.  Areals have one per loop, points and linears have one.
+    unsigned int getNumRings() const;
+
+    /// Number of points in the given ring
+    unsigned int getRingSize(unsigned int which) const;
+
+    /// Points for the given ring
+    const Point2f *getRingPoints(unsigned int which) const;
+
+    /// Number of points in a triangle mesh
+    unsigned int getNumMeshPoints() const;
+
+    /// Points for a triangle mesh
+    const Point3f *getMeshPoints() const;
+
+    /// Number of triangles in a triangle mesh
+    unsigned int getNumTriangles() const;
+
+    /// Triangles in a triangle mesh, three indices apiece
+    const int32_t *getTriangles() const;
+
+protected:
+    friend class VectorIndexedFile;
+
+    const VectorIndexedFile *file;
+    unsigned int index;
+};
+
+/** Reads an indexed vector file by mapping it into memory.
+    You can query by bounding box and look at features through
+    VectorShapeView without copying, or ask for regular vector shapes.
+
+    Reading is thread safe, other than getNextObject().
+  */
+class VectorIndexedFile : public VectorReader
+{
+public:
+    /// Map the given file.  Check isValid() afterward.
+    VectorIndexedFile(const std::string &fileName);
+    virtual ~VectorIndexedFile();
+
+    /// True if we mapped the file and the header made sense
+    virtual bool isValid();
+
+    /// Return the next feature in file order
+    virtual VectorShapeRef getNextObject(const StringSet *filter);
+
+    /// We can do random access
+    virtual bool canReadByIndex() { return true; }
+
+    /// Total number of features
+    virtual unsigned int getNumObjects();
+
+    /// Build a vector shape for the given feature.
+    /// If filter is set, only those attributes are copied.
+    virtual VectorShapeRef getObjectByIndex(unsigned int vecIndex,const StringSet *filter);
+
+    /// Bounds of all the features
+    Mbr getBounds() const;
+
+    /// Return the indices of the features whose bounding boxes overlap the given one
+    void queryMbr(const Mbr &mbr,std::vector<unsigned int> &indices) const;
+
+    /// Build vector shapes for everything overlapping the given bounding box
+    void getObjectsInMbr(const Mbr &mbr,const StringSet *filter,ShapeSet &shapes);
+
+    /// View of a single feature
+    VectorShapeView getShapeView(unsigned int which) const;
+
+    /// Number of attribute columns
+    unsigned int getNumColumns() const;
+
+    /// Name of the given column
+    const char *getColumnName(unsigned int col) const;
+
+    /// Look for a column by name.  Returns -1 if it's not there.
+    int findColumn(const std::string &name) const;
+
+    /// Data type of the given column (string, int, identity or double)
+    DictionaryType getColumnType(unsigned int col) const;
+
+    /// True if the feature has a value in the given column
+    bool hasValue(unsigned int col,unsigned int which) const;
+
+    /// Integer value for the given column and feature
+    int getInt(unsigned int col,unsigned int which) const;
+
+    /// Identity value for the given column and feature
+    SimpleIdentity getIdentity(unsigned int col,unsigned int which) const;
+
+    /// Double value for the given column and feature
+    double getDouble(unsigned int col,unsigned int which) const;
+
+    /// String value for the given column and feature.  Points into the file.
+    const char *getString(unsigned int col,unsigned int which) const;
+
+protected:
+    friend class VectorShapeView;
+
+    // Points into the mapped file
+    const unsigned char *dataAt(uint64_t offset) const { return (const unsigned char *)mapData + offset; }
+
+    // Make sure a feature's rings, points and triangles are all in the file
+    bool checkFeature(unsigned int which) const;
+
+    // String from the pool, or an empty one if the offset is bad
+    const char *stringAt(uint32_t offset) const;
+
+    void *mapData;
+    size_t mapSize;
+    bool valid;
+    unsigned int where;
+
+    // Sections within the file
+    const void *header;
+    const void *features;
+    const void *rings;
+    const Point2f *points;
+    const Point3f *meshPoints;
+    const int32_t *tris;
+    const uint32_t *levelBounds;
+    const void *nodes;
+    const void *columns;
+    const char *strings;
+
+    // Number of records that fit in each section
+    uint64_t maxRings,maxPoints,maxMeshPoints,maxTris;
+    uint64_t stringsLen;
+};
+
+}
@@ -26,6 +26,7 @@
 #import "BasicDrawableBuilder.h"
 #import "BasicDrawableInstanceBuilder.h"
 #import "VectorData.h"
+#import "VectorSimplify.h"
 #import "GlobeMath.h"
 #import "Dictionary.h"
 #import "Scene.h"
@@ -83,6 +84,10 @@ public:
     bool                        centered;
     bool                        vecCenterSet;
     Point2f                     vecCenter;
+    /// If set, simplify to this many pixels at simplifyLevel
+    float                       simplifyTolerance;
+    int                         simplifyLevel;
+    VectorSimplifyType          simplifyType;
 };
 typedef std::shared_ptr<VectorInfo> VectorInfoRef;
 
@@ -112,6 +117,9 @@ public:
     /// Enable/disable vector data
     void enableVectors(SimpleIDSet &vecIDs,bool enable,ChangeSet &changes);
     
+    /// Return the drawables (and instances) that make up the given vectors
+    void getDrawIDs(const SimpleIDSet &vecIDs,SimpleIDSet &drawIDs);
+    
 protected:
     std::mutex vectorLock;
     VectorSceneRepSet vectorReps;
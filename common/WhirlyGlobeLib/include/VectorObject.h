@@ -20,6 +20,7 @@
 
 #import "VectorData.h"
 #import "WhirlyKitView.h"
+#import "VectorSimplify.h"
 
 namespace WhirlyKit
 {
@@ -125,6 +126,21 @@ public:
     /// Tesselate areal features and return a new vector object
     VectorObjectRef tesselate();
 
+    /**
+     Simplify the linear and areal features to the given tolerance (in radians) and return a new vector object.
+     
+     Features are simplified together, so boundaries shared between them stay shared.
+     Anything on the edge of keepMbr (if valid) is left alone so tiles still line up.
+     */
+    VectorObjectRef simplify(double tolerance,VectorSimplifyType type = VectorSimplifyDouglasPeucker,const Mbr &keepMbr = Mbr());
+
+    /**
+     Simplify for display at the given zoom level and return a new vector object.
+     
+     The tolerance is in screen pixels at that level, assuming a spherical mercator tiling.
+     */
+    VectorObjectRef simplifyForLevel(float pixels,int level,VectorSimplifyType type = VectorSimplifyDouglasPeucker,const Mbr &keepMbr = Mbr());
+
     /**
      Clip the given (presumably areal) feature(s) to a grid in radians of the given size.
      
@@ -0,0 +1,57 @@
+/*
+ *  VectorSimplify.h
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import "WhirlyVector.h"
+#import "VectorData.h"
+
+namespace WhirlyKit
+{
+
+/// Line simplification algorithms
+typedef enum {VectorSimplifyDouglasPeucker,VectorSimplifyVisvalingam} VectorSimplifyType;
+
+/** Convert a tolerance in screen pixels at the given zoom level into radians.
+    This assumes a spherical mercator tiling of the given tile size.
+  */
+double VectorSimplifyToleranceForLevel(float pixels,int level,int tileSize = 256);
+
+/** Simplify a run of points to the given tolerance, always keeping the first and last.
+    Douglas-Peucker drops points closer than the tolerance to the simplified line.
+    Visvalingam drops points whose triangle with their neighbors is smaller than tolerance^2 / 2.
+  */
+void VectorSimplifyPoints(const VectorRing &inPts,VectorRing &outPts,double tolerance,VectorSimplifyType type);
+
+/** Simplify the linear and areal features in a group of shapes together.
+
+    Points shared between features where the boundaries come together or split apart
+    are kept and the runs between them are simplified the same way in every feature
+    that uses them.  Adjacent polygons still line up exactly afterward.
+
+    If geographic is set, the coordinates are radians and the tolerance (in radians at the equator)
+    is scaled down by latitude to match what a mercator map shows.
+    Anything on the edge of keepMbr (if valid) is kept, so tiles still meet at their edges.
+
+    New shapes are returned for anything we changed, sharing attributes with the originals.
+    Other shapes are passed through and loops that collapse entirely are dropped.
+  */
+void VectorSimplifyShapes(const ShapeSet &inShapes,ShapeSet &outShapes,double tolerance,VectorSimplifyType type,
+                          bool geographic = true,const Mbr &keepMbr = Mbr());
+
+}
@@ -40,6 +40,21 @@ typedef enum {
     BDDataTypeMax
 } BDAttributeDataType;
 
+/// Data type and storage for each kind of attribute value
+template<typename T> class VertexAttributeType { };
+template<> class VertexAttributeType<Eigen::Vector4f>
+    { public: typedef Vector4fVector Storage; static const BDAttributeDataType dataType = BDFloat4Type; };
+template<> class VertexAttributeType<Eigen::Vector3f>
+    { public: typedef std::vector<Eigen::Vector3f> Storage; static const BDAttributeDataType dataType = BDFloat3Type; };
+template<> class VertexAttributeType<RGBAColor>
+    { public: typedef std::vector<RGBAColor> Storage; static const BDAttributeDataType dataType = BDChar4Type; };
+template<> class VertexAttributeType<Eigen::Vector2f>
+    { public: typedef std::vector<Eigen::Vector2f> Storage; static const BDAttributeDataType dataType = BDFloat2Type; };
+template<> class VertexAttributeType<float>
+    { public: typedef std::vector<float> Storage; static const BDAttributeDataType dataType = BDFloatType; };
+template<> class VertexAttributeType<int>
+    { public: typedef std::vector<int> Storage; static const BDAttributeDataType dataType = BDIntType; };
+
 /// Used to keep track of attributes (other than points)
 class VertexAttribute
 {
@@ -79,6 +94,9 @@ public:
     /// Reserve size in the data array
     void reserve(int size);
     
+    /// Resize the data array.  New elements are uninitialized.
+    void resize(int size);
+    
     /// Number of elements in our array
     int numElements() const;
     
@@ -91,6 +109,17 @@ public:
     /// Return a pointer to the given element
     void *addressForElement(int which);
     
+    /// The data array as its actual type, set up if it isn't there yet.
+    /// Returns NULL if T isn't our data type.
+    template<typename T> typename VertexAttributeType<T>::Storage *getTypedData()
+    {
+        if (dataType != VertexAttributeType<T>::dataType)
+            return NULL;
+        if (!data)
+            data = new typename VertexAttributeType<T>::Storage();
+        return (typename VertexAttributeType<T>::Storage *)data;
+    }
+    
 public:
     /// Data type for the attribute data
     BDAttributeDataType dataType;
@@ -109,6 +138,40 @@ public:
     void *data;
 };
 
+/** Typed access to a vertex attribute's data.
+ 
+    The type is checked once, when the handle is made, rather than on every
+    value added.  Don't add to an invalid handle.  The handle is good until
+    the attribute is cleared.
+  */
+template<typename T> class VertexAttributeHandle
+{
+public:
+    VertexAttributeHandle() : vec(NULL) { }
+    VertexAttributeHandle(VertexAttribute *attr) : vec(attr ? attr->getTypedData<T>() : NULL) { }
+    
+    /// True if we're hooked up to an attribute of the right type
+    bool valid() const { return vec != NULL; }
+    
+    /// Add a single value
+    void add(const T &val) { vec->push_back(val); }
+    
+    /// Add a run of values
+    template<typename Iter> void add(Iter begin,Iter end) { vec->insert(vec->end(),begin,end); }
+    
+    /// Add the same value a number of times
+    void add(const T &val,unsigned int num) { vec->insert(vec->end(),num,val); }
+    
+    /// Number of values so far
+    unsigned int size() const { return vec ? (unsigned int)vec->size() : 0; }
+    
+    /// Make room for this many more values
+    void reserveMore(unsigned int num) { vec->reserve(vec->size()+num); }
+    
+protected:
+    typename VertexAttributeType<T>::Storage *vec;
+};
+
 /** Base class for the single vertex attribute that provides
  the name and type of a vertex attribute.
  */
@@ -30,9 +30,11 @@
 #import "CoordSystem.h"
 #import "Dictionary.h"
 #import "Drawable.h"
+#import "DrawableVisibilityIndex.h"
 #import "DynamicTextureAtlas.h"
 #import "FlatMath.h"
 #import "FontTextureManager.h"
+#import "GeoJSONStreamParser.h"
 #import "GeometryManager.h"
 #import "GeometryOBJReader.h"
 #import "GlobeAnimateHeight.h"
@@ -70,7 +72,14 @@
 #import "ParticleSystemDrawable.h"
 #import "ParticleSystemDrawableBuilder.h"
 #import "ParticleSystemManager.h"
+#import "ParticleSystemCPU.h"
 #import "PerformanceTimer.h"
+#import "FrameTrace.h"
+#import "SignedDistanceField.h"
+#import "PixelConversion.h"
+#import "ETC2Encoder.h"
+#import "MipmapGenerator.h"
+#import "BufferArena.h"
 #import "Platform.h"
 #import "Program.h"
 #import "Proj4CoordSystem.h"
@@ -88,6 +97,7 @@
 #import "SceneRenderer.h"
 #import "ScreenImportance.h"
 #import "ScreenObject.h"
+#import "ScreenProjectionCache.h"
 #import "ScreenSpaceBuilder.h"
 #import "ScreenSpaceDrawableBuilder.h"
 #import "SelectionManager.h"
@@ -102,9 +112,12 @@
 #import "Tesselator.h"
 #import "Texture.h"
 #import "TextureAtlas.h"
+#import "TileGeometryCache.h"
 #import "VectorData.h"
+#import "VectorIndexedFile.h"
 #import "VectorManager.h"
 #import "VectorObject.h"
+#import "VectorSimplify.h"
 #import "WhirlyGeometry.h"
 #import "WhirlyKitLog.h"
 #import "WhirlyKitView.h"
@@ -89,7 +89,7 @@ public:
     virtual Eigen::Vector3d eyePos();
     
     /// Put together one or more offset matrices to express wrapping
-    virtual void getOffsetMatrices(std::vector<Eigen::Matrix4d> &offsetMatrices,const WhirlyKit::Point2f &frameBufferSize,float bufferX);
+    virtual void getOffsetMatrices(Matrix4dVector &offsetMatrices,const WhirlyKit::Point2f &frameBufferSize,float bufferX);
 
     /// If we're wrapping, we may need a non-wrapped coordinate
     WhirlyKit::Point2f unwrapCoordinate(const WhirlyKit::Point2f &pt);
@@ -114,6 +114,10 @@ public:
     
     /// Generate a ViewState corresponding to this view
     virtual ViewStateRef makeViewState(SceneRenderer *renderer) = 0;
+    
+    /// Return a ViewState for where we are right now.  This is shared with anyone else who asks,
+    ///  so treat it as read only.  It's only rebuilt when the matrices or frame buffer change.
+    ViewStateRef getViewState(SceneRenderer *renderer);
 
     /// Add a watcher delegate.  Call this on the main thread.
     virtual void addWatcher(ViewWatcher *delegate);
@@ -126,7 +130,7 @@ public:
     
     double fieldOfView,imagePlaneSize,nearPlane,farPlane;
     Point2d centerOffset;
-    std::vector<Eigen::Matrix4d> offsetMatrices;
+    Matrix4dVector offsetMatrices;
     /// The last time the position was changed
     TimeInterval lastChangedTime;
     /// Display adapter and coordinate system we're working in
@@ -137,6 +141,28 @@ public:
     /// Called when positions are updated
     ViewWatcherSet watchers;
     std::mutex watcherLock;
+    
+protected:
+    /// What the last shared view state was built from
+    class ViewStateInputs
+    {
+    public:
+        ViewStateInputs() : renderer(NULL), frameSize(0,0), fieldOfView(0), imagePlaneSize(0), nearPlane(0), farPlane(0) { }
+        bool operator == (const ViewStateInputs &that) const;
+        
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW;
+        
+        SceneRenderer *renderer;
+        Point2f frameSize;
+        Eigen::Matrix4d modelMatrix,viewMatrix;
+        Matrix4dVector offsetMatrices;
+        double fieldOfView,imagePlaneSize,nearPlane,farPlane;
+    };
+    
+    std::mutex viewStateLock;
+    ViewStateInputs viewStateInputs;
+    ViewStateRef viewState;
+    unsigned int viewStateVersion;
 };
     
 typedef std::shared_ptr<View> ViewRef;
@@ -148,7 +174,7 @@ typedef std::shared_ptr<View> ViewRef;
 class ViewState
 {
 public:
-    ViewState() : near(0), far(0) { }
+    ViewState() : near(0), far(0), version(0) { }
     ViewState(View *view,WhirlyKit::SceneRenderer *renderer);
     virtual ~ViewState();
     
@@ -176,7 +202,7 @@ public:
     void log();
     
     Eigen::Matrix4d modelMatrix,projMatrix;
-    std::vector<Eigen::Matrix4d> viewMatrices,invViewMatrices,fullMatrices,fullNormalMatrices,invFullMatrices;
+    Matrix4dVector viewMatrices,invViewMatrices,fullMatrices,fullNormalMatrices,invFullMatrices;
     Eigen::Matrix4d invModelMatrix,invProjMatrix;
     double fieldOfView;
     double imagePlaneSize;
@@ -190,6 +216,9 @@ public:
     
     /// Calculate where the eye is in model coordinates
     Point3d eyePos;
+    
+    /// Counts up each time View::getViewState() builds a new one.  Zero if it came from somewhere else.
+    unsigned int version;
 };
 
 }
@@ -19,7 +19,11 @@
  */
 
 // Note: This works around a problem in compilation for the iphone
+// Define WHIRLYKIT_VECTORIZE_MATH to let Eigen use SSE/NEON.  Fixed size
+//  Eigen types kept in containers must then use aligned_allocator (see below).
+#ifndef WHIRLYKIT_VECTORIZE_MATH
 #define EIGEN_DONT_VECTORIZE 1
+#endif
 //#define EIGEN_DISABLE_UNALIGNED_ARRAY_ASSERT 1
 
 #import <Eigen/Eigen>
@@ -39,6 +43,8 @@ typedef std::vector<Point3f,Eigen::aligned_allocator<Point3f> > Point3fVector;
 typedef std::vector<Point3d,Eigen::aligned_allocator<Point3d> > Point3dVector;
 typedef std::vector<Eigen::Vector4f,Eigen::aligned_allocator<Eigen::Vector4f> > Vector4fVector;
 typedef std::vector<Eigen::Vector4d,Eigen::aligned_allocator<Eigen::Vector4d> > Vector4dVector;
+typedef std::vector<Eigen::Matrix4f,Eigen::aligned_allocator<Eigen::Matrix4f> > Matrix4fVector;
+typedef std::vector<Eigen::Matrix4d,Eigen::aligned_allocator<Eigen::Matrix4d> > Matrix4dVector;
 	
 /// Convenience wrapper for texture coordinate
 class TexCoord : public Eigen::Vector2f
@@ -443,6 +449,14 @@ Eigen::Matrix4d Matrix4fToMatrix4d(const Eigen::Matrix4f &inMat);
 
 /// Convert a 4d matrix to a 4f matrix
 Eigen::Matrix4f Matrix4dToMatrix4f(const Eigen::Matrix4d &inMat);
+
+/// Invert a matrix with no projective part (bottom row of 0,0,0,1) by inverting the 3x3 and
+///  running the translation back through it.  Anything else gets a general inverse.
+Eigen::Matrix4d AffineInverse(const Eigen::Matrix4d &inMat);
+
+/// Invert a perspective projection of the sort View::calcProjectionMatrix() makes in closed form.
+/// Anything else gets a general inverse.
+Eigen::Matrix4d PerspectiveInverse(const Eigen::Matrix4d &inMat);
     
 /// Floats to doubles
 Eigen::Vector2d Vector2fToVector2d(const Eigen::Vector2f &inVec);
@@ -56,6 +56,7 @@ public:
     virtual void Init(unsigned int numVert,unsigned int numTri,bool globeMode);
     
     virtual unsigned int addPoint(const Point3f &pt);
+    virtual unsigned int addPoints(const Point3f *pts,unsigned int numPts);
     // Next point, for calculating p1 - p0
     void add_p1(const Point3f &vec);
     // Texture calculation parameters
@@ -67,6 +68,7 @@ public:
     // Optional normal
     void addNormal(const Point3f &norm);
     void addNormal(const Point3d &norm);
+    void addNormals(const Point3f &norm,unsigned int numNorms);
     
     // We set color globally
     void setColor(RGBAColor inColor);
@@ -102,6 +104,10 @@ protected:
     int n0_index;
     int c0_index;
     int tex_index;
+    // Typed versions of the above, so we don't check the type on every vertex
+    VertexAttributeHandle<Eigen::Vector3f> p1_attr,n0_attr;
+    VertexAttributeHandle<float> c0_attr;
+    VertexAttributeHandle<Eigen::Vector4f> tex_attr;
     
 #ifdef WIDEVECDEBUG
     Point3fVector locPts;
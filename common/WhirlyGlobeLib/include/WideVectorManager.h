@@ -27,6 +27,7 @@
 #import "Scene.h"
 #import "SelectionManager.h"
 #import "VectorData.h"
+#import "VectorSimplify.h"
 #import "Dictionary.h"
 #import "BaseInfo.h"
 
@@ -60,6 +61,10 @@ public:
     WideVectorLineCapType capType;
     SimpleIdentity texID;
     float miterLimit;
+    /// If set, simplify to this many pixels at simplifyLevel
+    float simplifyTolerance;
+    int simplifyLevel;
+    VectorSimplifyType simplifyType;
 };
 typedef std::shared_ptr<WideVectorInfo> WideVectorInfoRef;
     
@@ -104,6 +109,9 @@ public:
     /// Remove a gruop of vectors named by the given ID
     void removeVectors(SimpleIDSet &vecIDs,ChangeSet &changes);
     
+    /// Return the drawables (and instances) that make up the given vectors
+    void getDrawIDs(const SimpleIDSet &vecIDs,SimpleIDSet &drawIDs);
+    
 protected:
     std::mutex vecLock;
     WideVectorSceneRepSet sceneReps;
@@ -0,0 +1,67 @@
+/*
+ *  WorkerPool.h
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <condition_variable>
+#import <functional>
+#import <memory>
+#import <mutex>
+#import <thread>
+#import <vector>
+
+namespace WhirlyKit
+{
+
+/** A fixed set of worker threads for splitting up short, CPU bound jobs
+    such as the per frame particle update or screen projection.
+
+    The threads are started once and wait between jobs, so a job costs a
+    wakeup rather than a thread start.  The calling thread does its share of
+    the work too.  One job runs at a time; other callers wait their turn.
+  */
+class WorkerPool
+{
+public:
+    /// Start numThreads-1 worker threads.  The caller makes up the last one.
+    WorkerPool(int numThreads);
+    ~WorkerPool();
+
+    /// Number of threads a job is spread across, including the caller
+    int getNumThreads() const { return (int)workers.size()+1; }
+
+    /// Call func(0) through func(numTasks-1) across the threads and wait for all of them
+    void run(int numTasks,const std::function<void(int)> &func);
+
+protected:
+    // Work through tasks from the current job until there are none left
+    void runTasks();
+    void workerMain();
+
+    std::mutex runLock;
+    std::mutex lock;
+    std::condition_variable workCond,doneCond;
+    std::vector<std::thread> workers;
+    const std::function<void(int)> *job;
+    int numTasks,nextTask,tasksDone;
+    unsigned int generation;
+    bool shutdown;
+};
+typedef std::shared_ptr<WorkerPool> WorkerPoolRef;
+
+}
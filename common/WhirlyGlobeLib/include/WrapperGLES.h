@@ -18,7 +18,12 @@
  *
  */
 
-#ifdef __ANDROID__ 
+#if defined(WHIRLYKIT_HEADLESS)
+
+// Desktop builds with no GL driver, see linux/
+#import "GLES_Headless.h"
+
+#elif defined(__ANDROID__)
 
 #import <jni.h>
 #import <android/log.h>
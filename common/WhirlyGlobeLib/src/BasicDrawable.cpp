@@ -79,6 +79,24 @@ unsigned int BasicDrawable::getDrawPriority() const
     return drawPriority;
 }
 
+void BasicDrawable::getVisibilityRanges(double &minHeight,double &maxHeight,TimeInterval &startTime,TimeInterval &endTime) const
+{
+    Drawable::getVisibilityRanges(minHeight, maxHeight, startTime, endTime);
+
+    // Same rules as isOn()
+    if (minVisible != DrawVisibleInvalid && maxVisible != DrawVisibleInvalid)
+    {
+        minHeight = std::min(minVisible,maxVisible);
+        maxHeight = std::max(minVisible,maxVisible);
+    }
+    if (startEnable != endEnable)
+    {
+        startTime = startEnable;
+        if (endEnable != 0.0)
+            endTime = endEnable;
+    }
+}
+
 bool BasicDrawable::isOn(RendererFrameInfo *frameInfo) const
 {
     if (startEnable != endEnable)
@@ -92,7 +110,7 @@ bool BasicDrawable::isOn(RendererFrameInfo *frameInfo) const
     if (!on)
         return false;
     
-    double visVal = frameInfo->theView->heightAboveSurface();
+    double visVal = frameInfo->heightAboveSurface;
 
     // Height based check
     if (minVisible != DrawVisibleInvalid && maxVisible != DrawVisibleInvalid)
@@ -129,6 +147,11 @@ Mbr BasicDrawable::getLocalMbr() const
     return localMbr;
 }
 
+bool BasicDrawable::getGeometry(std::vector<Eigen::Vector3f> &pts,std::vector<Triangle> &tris) const
+{
+    return false;
+}
+
 void BasicDrawable::setDrawPriority(unsigned int newPriority)
 {
     drawPriority = newPriority;
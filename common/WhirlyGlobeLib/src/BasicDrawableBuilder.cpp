@@ -46,6 +46,14 @@ void BasicDrawableBuilder::reserve(int numVert,int numTri)
     points.reserve(numVert);
     tris.reserve(numTri);
 }
+
+void BasicDrawableBuilder::reserveLayout(int numVert,int numTri)
+{
+    points.reserve(points.size()+numVert);
+    tris.reserve(tris.size()+numTri);
+    for (VertexAttribute *attr : basicDraw->vertexAttributes)
+        attr->reserve(attr->numElements()+numVert);
+}
     
 void BasicDrawableBuilder::Init()
 {
@@ -377,6 +385,62 @@ void BasicDrawableBuilder::addNormal(const Point3d &norm)
     basicDraw->vertexAttributes[basicDraw->normalEntry]->addVector3f(Point3f(norm.x(),norm.y(),norm.z()));
 }
 
+unsigned int BasicDrawableBuilder::addPoints(const Point3f *pts,unsigned int numPts)
+{
+    const unsigned int first = (unsigned int)points.size();
+    points.insert(points.end(),pts,pts+numPts);
+    return first;
+}
+
+unsigned int BasicDrawableBuilder::addPoints(const Point3d *pts,unsigned int numPts)
+{
+    const unsigned int first = (unsigned int)points.size();
+    points.resize(first+numPts);
+    for (unsigned int ii=0;ii<numPts;ii++)
+        points[first+ii] = pts[ii].cast<float>();
+    return first;
+}
+
+void BasicDrawableBuilder::addTexCoords(int which,const TexCoord *coords,unsigned int numCoords)
+{
+    if (which == -1)
+    {
+        for (unsigned int ii=0;ii<basicDraw->texInfo.size();ii++)
+            getAttributeHandle<Eigen::Vector2f>(basicDraw->texInfo[ii].texCoordEntry).add(coords,coords+numCoords);
+    } else {
+        setupTexCoordEntry(which, numCoords);
+        getAttributeHandle<Eigen::Vector2f>(basicDraw->texInfo[which].texCoordEntry).add(coords,coords+numCoords);
+    }
+}
+
+void BasicDrawableBuilder::addColors(const RGBAColor *colors,unsigned int numColors)
+{
+    VertexAttributeHandle<RGBAColor> colorAttr = getAttributeHandle<RGBAColor>(basicDraw->colorEntry);
+    if (colorAttr.valid())
+        colorAttr.add(colors,colors+numColors);
+}
+
+void BasicDrawableBuilder::addColors(const RGBAColor &color,unsigned int numColors)
+{
+    VertexAttributeHandle<RGBAColor> colorAttr = getAttributeHandle<RGBAColor>(basicDraw->colorEntry);
+    if (colorAttr.valid())
+        colorAttr.add(color,numColors);
+}
+
+void BasicDrawableBuilder::addNormals(const Point3f *norms,unsigned int numNorms)
+{
+    VertexAttributeHandle<Eigen::Vector3f> normAttr = getAttributeHandle<Eigen::Vector3f>(basicDraw->normalEntry);
+    if (normAttr.valid())
+        normAttr.add(norms,norms+numNorms);
+}
+
+void BasicDrawableBuilder::addNormals(const Point3f &norm,unsigned int numNorms)
+{
+    VertexAttributeHandle<Eigen::Vector3f> normAttr = getAttributeHandle<Eigen::Vector3f>(basicDraw->normalEntry);
+    if (normAttr.valid())
+        normAttr.add(norm,numNorms);
+}
+
 bool BasicDrawableBuilder::compareVertexAttributes(const SingleVertexAttributeSet &attrs)
 {
     for (SingleVertexAttributeSet::iterator it = attrs.begin();
@@ -490,6 +554,9 @@ void BasicDrawableBuilder::addAttributeValue(int attrId,float val)
 void BasicDrawableBuilder::addTriangle(BasicDrawable::Triangle tri)
 { tris.push_back(tri); }
 
+void BasicDrawableBuilder::addTriangles(const BasicDrawable::Triangle *inTris,unsigned int numTris)
+{ tris.insert(tris.end(),inTris,inTris+numTris); }
+
 void BasicDrawableBuilder::setUniforms(const SingleVertexAttributeSet &uniforms)
 {
     basicDraw->uniforms = uniforms;
@@ -28,7 +28,7 @@ namespace WhirlyKit
     
 BasicDrawableGLES::BasicDrawableGLES(const std::string &name)
 : BasicDrawable(name), Drawable(name), isSetupGL(false), usingBuffers(false), vertexSize(-1),
-    pointBuffer(0), triBuffer(0), sharedBuffer(0), vertArrayObj(0)
+    pointBuffer(0), triBuffer(0), sharedBuffer(0), sharedBufferOffset(0), vertArrayObj(0)
 {
 }
 
@@ -92,19 +92,15 @@ void BasicDrawableGLES::addPointToBuffer(unsigned char *basePtr,int which,const
     }
 }
 
-// Create VBOs and such
-void BasicDrawableGLES::setupForRenderer(const RenderSetupInfo *inSetupInfo)
+// Build the interleaved buffer, which doesn't need GL
+void BasicDrawableGLES::prepareForRenderer(const RenderSetupInfo *inSetupInfo)
 {
     RenderSetupInfoGLES *setupInfo = (RenderSetupInfoGLES *)inSetupInfo;
     
     // If we're already setup, don't do it twice
-    if (pointBuffer || sharedBuffer)
+    if (pointBuffer || sharedBuffer || !preparedData.empty())
         return;
     
-    //    if ([NSThread currentThread] == [NSThread mainThread]) {
-    //        NSLog(@"Hey why are we doing setupGL on the main thread? %s",name.c_str());
-    //    }
-    
     // Offset the geometry upward by minZres units along the normals
     // Only do this once, obviously
     if (drawOffset != 0 && (points.size() == vertexAttributes[normalEntry]->numElements()))
@@ -119,63 +115,63 @@ void BasicDrawableGLES::setupForRenderer(const RenderSetupInfo *inSetupInfo)
         }
     }
     
-    pointBuffer = triBuffer = 0;
-    sharedBuffer = 0;
-    
     // We'll set up a single buffer for everything.
     // The other buffer pointers are now strides
-    // Size of a single vertex entry
     int numVerts = (int)points.size();
+    preparedData.resize(vertexSize*numVerts+tris.size()*sizeof(Triangle));
+    unsigned char *basePtr = preparedData.data();
+    for (int ii=0;ii<numVerts;ii++,basePtr+=vertexSize)
+        addPointToBuffer(basePtr,ii,NULL);
     
-    // Set up the buffer
-    int bufferSize = vertexSize*numVerts;
+    // Now the element buffer
     if (!tris.empty())
+        memcpy(basePtr, &tris[0], tris.size()*sizeof(Triangle));
+}
+
+// Create VBOs and such
+void BasicDrawableGLES::setupForRenderer(const RenderSetupInfo *inSetupInfo)
+{
+    RenderSetupInfoGLES *setupInfo = (RenderSetupInfoGLES *)inSetupInfo;
+    
+    // If we're already setup, don't do it twice
+    if (pointBuffer || sharedBuffer)
+        return;
+    
+    //    if ([NSThread currentThread] == [NSThread mainThread]) {
+    //        NSLog(@"Hey why are we doing setupGL on the main thread? %s",name.c_str());
+    //    }
+    
+    // Usually this was done ahead of time
+    prepareForRenderer(setupInfo);
+    
+    pointBuffer = triBuffer = 0;
+    sharedBuffer = 0;
+    sharedBufferOffset = 0;
+    
+    int numVerts = (int)points.size();
+    int bufferSize = (int)preparedData.size();
+    // Small ones get packed in with other drawables
+    if (setupInfo->memManager->getSubBuffer(bufferSize,bufferAlloc))
     {
-        bufferSize += tris.size()*sizeof(Triangle);
-    }
-    sharedBuffer = setupInfo->memManager->getBufferID(bufferSize,GL_STATIC_DRAW);
+        sharedBuffer = bufferAlloc.bufferID;
+        sharedBufferOffset = (GLuint)bufferAlloc.offset;
+    } else
+        sharedBuffer = setupInfo->memManager->getBufferID(bufferSize,GL_STATIC_DRAW);
     if (!sharedBuffer)
         wkLogLevel(Error, "Empty buffer in BasicDrawable::setupGL()");
     
-    // Now copy in the data
+    // The vertices and triangles are already interleaved, so this is just a copy
     glBindBuffer(GL_ARRAY_BUFFER, sharedBuffer);
-    if (hasMapBufferSupport) {
-        void *glMem = NULL;
-        glMem = glMapBufferRange(GL_ARRAY_BUFFER, 0, bufferSize, GL_MAP_WRITE_BIT);
-        unsigned char *basePtr = (unsigned char *)glMem;
-        for (unsigned int ii=0;ii<numVerts;ii++,basePtr+=vertexSize)
-            addPointToBuffer(basePtr,ii,NULL);
-        
-        // And copy in the element buffer
-        if (tris.size())
-        {
-            triBuffer = vertexSize*numVerts;
-            unsigned char *basePtr = (unsigned char *)glMem + triBuffer;
-            for (unsigned int ii=0;ii<tris.size();ii++,basePtr+=sizeof(Triangle))
-                memcpy(basePtr, &tris[ii], sizeof(Triangle));
-        }
-        glUnmapBuffer(GL_ARRAY_BUFFER);
-    } else {
-        bufferSize = numVerts*vertexSize+tris.size()*sizeof(Triangle);
-        
-        // Gotta do this the hard way
-        unsigned char *glMem = (unsigned char *)malloc(bufferSize);
-        unsigned char *basePtr = glMem;
-        for (unsigned int ii=0;ii<numVerts;ii++,basePtr+=vertexSize)
-            addPointToBuffer(basePtr, ii,NULL);
-        
-        // Now the element buffer
-        triBuffer = numVerts*vertexSize;
-        for (unsigned int ii=0;ii<tris.size();ii++,basePtr+=sizeof(Triangle))
-            memcpy(basePtr, &tris[ii], sizeof(Triangle));
-        
-        glBufferData(GL_ARRAY_BUFFER, bufferSize, glMem, GL_STATIC_DRAW);
-        free(glMem);
-    }
-    
+    if (!tris.empty())
+        triBuffer = sharedBufferOffset + numVerts*vertexSize;
+    if (bufferAlloc.valid())
+        glBufferSubData(GL_ARRAY_BUFFER, sharedBufferOffset, bufferSize, preparedData.data());
+    else
+        glBufferData(GL_ARRAY_BUFFER, bufferSize, preparedData.data(), GL_STATIC_DRAW);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     
     // Clear out the arrays, since we won't need them again
+    std::vector<unsigned char>().swap(preparedData);
     numPoints = (int)points.size();
     points.clear();
     numTris = (int)tris.size();
@@ -197,7 +193,12 @@ void BasicDrawableGLES::teardownForRenderer(const RenderSetupInfo *inSetupInfo,S
         glDeleteVertexArrays(1,&vertArrayObj);
     vertArrayObj = 0;
     
-    if (sharedBuffer)
+    if (bufferAlloc.valid())
+    {
+        setupInfo->memManager->removeSubBuffer(bufferAlloc);
+        bufferAlloc = BufferArenaAlloc();
+        sharedBuffer = 0;
+    } else if (sharedBuffer)
     {
         setupInfo->memManager->removeBufferID(sharedBuffer);
         sharedBuffer = 0;
@@ -209,6 +210,7 @@ void BasicDrawableGLES::teardownForRenderer(const RenderSetupInfo *inSetupInfo,S
     }
     pointBuffer = 0;
     triBuffer = 0;
+    sharedBufferOffset = 0;
     for (unsigned int ii=0;ii<vertexAttributes.size();ii++)
         ((VertexAttributeGLES *)vertexAttributes[ii])->buffer = 0;
 }
@@ -236,7 +238,7 @@ GLuint BasicDrawableGLES::setupVAO(ProgramGLES *prog)
     // Vertex array
     if (vertAttr)
     {
-        glVertexAttribPointer(vertAttr->index, 3, GL_FLOAT, GL_FALSE, vertexSize, 0);
+        glVertexAttribPointer(vertAttr->index, 3, GL_FLOAT, GL_FALSE, vertexSize, CALCBUFOFF(sharedBufferOffset,0));
         glEnableVertexAttribArray ( vertAttr->index );
     }
     
@@ -250,7 +252,7 @@ GLuint BasicDrawableGLES::setupVAO(ProgramGLES *prog)
         if (thisAttr) {
             if (attr->buffer != 0 || attr->numElements() != 0) {
                 glEnableVertexAttribArray(thisAttr->index);
-                glVertexAttribPointer(thisAttr->index, attr->glEntryComponents(), attr->glType(), attr->glNormalize(), vertexSize, CALCBUFOFF(0,attr->buffer));
+                glVertexAttribPointer(thisAttr->index, attr->glEntryComponents(), attr->glType(), attr->glNormalize(), vertexSize, CALCBUFOFF(sharedBufferOffset,attr->buffer));
                 progAttrs[ii] = thisAttr;
             } else {
                 VertAttrDefault attrDef(thisAttr->index,*attr);
@@ -289,6 +291,16 @@ bool BasicDrawableGLES::isSetupInGL()
     return isSetupGL;
 }
 
+bool BasicDrawableGLES::getGeometry(std::vector<Eigen::Vector3f> &pts,std::vector<Triangle> &inTris) const
+{
+    if (isSetupGL || points.empty())
+        return false;
+
+    pts = points;
+    inTris = tris;
+    return true;
+}
+
 // Draw Vertex Buffer Objects, OpenGL 2.0+
 void BasicDrawableGLES::draw(RendererFrameInfoGLES *frameInfo,Scene *inScene)
 {
@@ -512,7 +524,7 @@ void BasicDrawableGLES::draw(RendererFrameInfoGLES *frameInfo,Scene *inScene)
         {
             glBindBuffer(GL_ARRAY_BUFFER,sharedBuffer);
             CheckGLError("BasicDrawable::drawVBO2() shared glBindBuffer");
-            glVertexAttribPointer(vertAttr->index, 3, GL_FLOAT, GL_FALSE, vertexSize, 0);
+            glVertexAttribPointer(vertAttr->index, 3, GL_FLOAT, GL_FALSE, vertexSize, CALCBUFOFF(sharedBufferOffset,0));
         } else {
             glVertexAttribPointer(vertAttr->index, 3, GL_FLOAT, GL_FALSE, 0, &points[0]);
         }
@@ -531,7 +543,7 @@ void BasicDrawableGLES::draw(RendererFrameInfoGLES *frameInfo,Scene *inScene)
                 if (attr->buffer != 0 || attr->numElements() != 0)
                 {
                     if (attr->buffer)
-                        glVertexAttribPointer(thisAttr->index, attr->glEntryComponents(), attr->glType(), attr->glNormalize(), vertexSize, CALCBUFOFF(0,attr->buffer));
+                        glVertexAttribPointer(thisAttr->index, attr->glEntryComponents(), attr->glType(), attr->glNormalize(), vertexSize, CALCBUFOFF(sharedBufferOffset,attr->buffer));
                     else
                         glVertexAttribPointer(thisAttr->index, attr->glEntryComponents(), attr->glType(), attr->glNormalize(), 0, attr->addressForElement(0));
                     glEnableVertexAttribArray(thisAttr->index);
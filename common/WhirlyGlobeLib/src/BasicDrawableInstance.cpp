@@ -29,7 +29,7 @@ namespace WhirlyKit
 {
 
 BasicDrawableInstance::BasicDrawableInstance(const std::string &name)
-: Drawable(name), instanceTexSource(EmptyIdentity), instanceTexProg(EmptyIdentity)
+: Drawable(name), fadeUp(0.0), fadeDown(0.0), instanceTexSource(EmptyIdentity), instanceTexProg(EmptyIdentity)
 {
 }
     
@@ -83,6 +83,24 @@ SimpleIdentity BasicDrawableInstance::getProgram() const
     programID = progID;
 }
 
+void BasicDrawableInstance::getVisibilityRanges(double &minHeight,double &maxHeight,TimeInterval &startTime,TimeInterval &endTime) const
+{
+    Drawable::getVisibilityRanges(minHeight, maxHeight, startTime, endTime);
+
+    // Same rules as isOn()
+    if (minVis != DrawVisibleInvalid && maxVis != DrawVisibleInvalid)
+    {
+        minHeight = std::min(minVis,maxVis);
+        maxHeight = std::max(minVis,maxVis);
+    }
+    if (startEnable != endEnable)
+    {
+        startTime = startEnable;
+        if (endEnable != 0.0)
+            endTime = endEnable;
+    }
+}
+
 bool BasicDrawableInstance::isOn(WhirlyKit::RendererFrameInfo *frameInfo) const
 {
     if (startEnable != endEnable)
@@ -96,7 +114,7 @@ bool BasicDrawableInstance::isOn(WhirlyKit::RendererFrameInfo *frameInfo) const
     if (!enable)
         return false;
     
-    double visVal = frameInfo->theView->heightAboveSurface();
+    double visVal = frameInfo->heightAboveSurface;
     
     // Height based check
     if (minVis != DrawVisibleInvalid && maxVis != DrawVisibleInvalid)
@@ -145,7 +163,10 @@ void BasicDrawableInstance::updateRenderer(WhirlyKit::SceneRenderer *renderer)
         // Motion requires continuous rendering
         renderer->addContinuousRenderRequest(getId());
     }
-    
+
+    renderer->setRenderUntil(fadeUp);
+    renderer->setRenderUntil(fadeDown);
+
     return basicDraw->updateRenderer(renderer);
 }
     
@@ -164,6 +185,34 @@ void BasicDrawableInstance::setEnableTimeRange(TimeInterval inStartEnable,TimeIn
     startEnable = inStartEnable;  endEnable = inEndEnable;
 }
 
+void BasicDrawableInstance::setFade(TimeInterval inFadeDown,TimeInterval inFadeUp)
+{
+    fadeUp = inFadeUp;  fadeDown = inFadeDown;
+}
+
+// Same as BasicDrawable's time based fade
+float BasicDrawableInstance::calcFade(RendererFrameInfo *frameInfo)
+{
+    if (fadeDown < fadeUp)
+    {
+        // Heading to 1
+        if (frameInfo->currentTime < fadeDown)
+            return 0.0;
+        if (frameInfo->currentTime > fadeUp)
+            return 1.0;
+        return (frameInfo->currentTime - fadeDown)/(fadeUp - fadeDown);
+    } else if (fadeUp < fadeDown) {
+        // Heading to 0
+        if (frameInfo->currentTime < fadeUp)
+            return 1.0;
+        if (frameInfo->currentTime > fadeDown)
+            return 0.0;
+        return 1.0-(frameInfo->currentTime - fadeUp)/(fadeDown - fadeUp);
+    }
+
+    return 1.0;
+}
+
 void BasicDrawableInstance::setVisibleRange(float inMinVis,float inMaxVis)
 {
     minVis = inMinVis;   maxVis = inMaxVis;
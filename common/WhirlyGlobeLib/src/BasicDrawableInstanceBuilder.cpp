@@ -74,6 +74,11 @@ void BasicDrawableInstanceBuilder::setEnableTimeRange(TimeInterval inStartEnable
     drawInst->endEnable = inEndEnable;
 }
 
+void BasicDrawableInstanceBuilder::setFade(TimeInterval inFadeDown,TimeInterval inFadeUp)
+{
+    drawInst->setFade(inFadeDown,inFadeUp);
+}
+
 void BasicDrawableInstanceBuilder::setViewerVisibility(double minViewerDist,double maxViewerDist,const Point3d &viewerCenter)
 {
     drawInst->minViewerDist = minViewerDist;
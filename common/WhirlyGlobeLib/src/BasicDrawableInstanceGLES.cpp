@@ -222,8 +222,7 @@ void BasicDrawableInstanceGLES::draw(RendererFrameInfoGLES *frameInfo,Scene *inS
         }
 
         // Figure out if we're fading in or out
-        float fade = 1.0;
-        // Note: Time based fade isn't represented in the instance.  Probably should be.
+        float fade = calcFade(frameInfo);
 
         // Deal with the range based fade
         if (frameInfo->heightAboveSurface > 0.0)
@@ -385,7 +384,7 @@ void BasicDrawableInstanceGLES::draw(RendererFrameInfoGLES *frameInfo,Scene *inS
             if (basicDrawGL->sharedBuffer) {
                 glBindBuffer(GL_ARRAY_BUFFER,basicDrawGL->sharedBuffer);
                 CheckGLError("BasicDrawable::drawVBO2() shared glBindBuffer");
-                glVertexAttribPointer(vertAttr->index, 3, GL_FLOAT, GL_FALSE, basicDrawGL->vertexSize, 0);
+                glVertexAttribPointer(vertAttr->index, 3, GL_FLOAT, GL_FALSE, basicDrawGL->vertexSize, CALCBUFOFF(basicDrawGL->sharedBufferOffset,0));
                 glEnableVertexAttribArray ( vertAttr->index );
             } else if (basicDrawGL->pointBuffer) {
                 glBindBuffer(GL_ARRAY_BUFFER,basicDrawGL->pointBuffer);
@@ -428,7 +427,7 @@ void BasicDrawableInstanceGLES::draw(RendererFrameInfoGLES *frameInfo,Scene *inS
                     } else {
                         // Just need to wire these up
                         glEnableVertexAttribArray(progAttr->index);
-                        glVertexAttribPointer(progAttr->index, attr->glEntryComponents(), attr->glType(), attr->glNormalize(), basicDrawGL->vertexSize, CALCBUFOFF(0,attr->buffer));
+                        glVertexAttribPointer(progAttr->index, attr->glEntryComponents(), attr->glType(), attr->glNormalize(), basicDrawGL->vertexSize, CALCBUFOFF(basicDrawGL->sharedBufferOffset,attr->buffer));
                     }
                 }
             }
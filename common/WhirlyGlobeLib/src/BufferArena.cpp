@@ -0,0 +1,251 @@
+/*
+ *  BufferArena.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <algorithm>
+#import <iterator>
+#import <vector>
+#import "BufferArena.h"
+
+namespace WhirlyKit
+{
+
+BufferArenaStats::BufferArenaStats()
+: numArenas(0), numAllocs(0), arenaBytes(0), usedBytes(0), requestedBytes(0),
+  numFreeBlocks(0), largestFreeBlock(0), arenasCreated(0), arenasReleased(0)
+{
+}
+
+double BufferArenaStats::utilization() const
+{
+    return arenaBytes > 0 ? (double)usedBytes / arenaBytes : 0.0;
+}
+
+bool BufferArenaAllocator::FreeBlock::operator < (const FreeBlock &that) const
+{
+    if (size != that.size)
+        return size < that.size;
+    if (seq != that.seq)
+        return seq < that.seq;
+    return offset < that.offset;
+}
+
+BufferArenaAllocator::BufferArenaAllocator(BufferArenaSource *source,size_t arenaSize,size_t alignment)
+: source(source), arenaSize(arenaSize), alignment(alignment), nextSeq(0), numEmpty(0),
+  requestedBytes(0), arenasCreated(0), arenasReleased(0)
+{
+}
+
+BufferArenaAllocator::~BufferArenaAllocator()
+{
+    // The source may not be in a state to release anything by now
+    for (auto it : arenas)
+        delete it.second;
+}
+
+size_t BufferArenaAllocator::sizeClass(size_t size) const
+{
+    size = (size + alignment - 1) / alignment * alignment;
+    // Small ones are only rounded to the alignment
+    if (size <= 8*alignment)
+        return size;
+
+    // Everything else goes up to the next of eight steps between powers of two
+    size_t pow2 = 8*alignment;
+    while (pow2*2 <= size)
+        pow2 *= 2;
+    const size_t step = pow2 / 8;
+    return (size + step - 1) / step * step;
+}
+
+void BufferArenaAllocator::addFreeBlock(Arena *arena,size_t offset,size_t size)
+{
+    arena->freeBlocks[offset] = size;
+    FreeBlock block;
+    block.size = size;  block.seq = arena->seq;  block.offset = offset;  block.arena = arena;
+    freeBySize.insert(block);
+}
+
+void BufferArenaAllocator::removeFreeBlock(Arena *arena,size_t offset,size_t size)
+{
+    arena->freeBlocks.erase(offset);
+    FreeBlock block;
+    block.size = size;  block.seq = arena->seq;  block.offset = offset;  block.arena = arena;
+    freeBySize.erase(block);
+}
+
+BufferArenaAllocator::Arena *BufferArenaAllocator::newArena()
+{
+    const unsigned int bufferID = source->createArenaBuffer(arenaSize);
+    if (bufferID == 0)
+        return NULL;
+
+    Arena *arena = new Arena();
+    arena->bufferID = bufferID;
+    arena->seq = nextSeq++;
+    arena->used = 0;
+    arena->numAllocs = 0;
+    arenas[bufferID] = arena;
+    addFreeBlock(arena, 0, arenaSize);
+    arenasCreated++;
+    numEmpty++;
+
+    return arena;
+}
+
+void BufferArenaAllocator::releaseArena(Arena *arena)
+{
+    for (auto it : arena->freeBlocks)
+    {
+        FreeBlock block;
+        block.size = it.second;  block.seq = arena->seq;  block.offset = it.first;  block.arena = arena;
+        freeBySize.erase(block);
+    }
+    source->releaseArenaBuffer(arena->bufferID);
+    arenas.erase(arena->bufferID);
+    delete arena;
+    arenasReleased++;
+}
+
+BufferArenaAlloc BufferArenaAllocator::allocate(size_t size)
+{
+    BufferArenaAlloc alloc;
+    if (size == 0)
+        return alloc;
+    const size_t allocSize = sizeClass(size);
+    if (allocSize > maxAllocSize())
+        return alloc;
+
+    // Smallest block that'll fit, in the oldest arena
+    FreeBlock key;
+    key.size = allocSize;  key.seq = 0;  key.offset = 0;  key.arena = NULL;
+    auto it = freeBySize.lower_bound(key);
+    if (it == freeBySize.end())
+    {
+        if (!newArena())
+            return alloc;
+        it = freeBySize.lower_bound(key);
+    }
+    const FreeBlock block = *it;
+    Arena *arena = block.arena;
+
+    // Take it off the front and put the rest back
+    removeFreeBlock(arena, block.offset, block.size);
+    if (block.size > allocSize)
+        addFreeBlock(arena, block.offset + allocSize, block.size - allocSize);
+
+    if (arena->used == 0)
+        numEmpty--;
+    arena->used += allocSize;
+    arena->numAllocs++;
+    requestedBytes += size;
+
+    alloc.bufferID = arena->bufferID;
+    alloc.offset = block.offset;
+    alloc.size = allocSize;
+    alloc.requestedSize = size;
+
+    return alloc;
+}
+
+void BufferArenaAllocator::free(const BufferArenaAlloc &alloc)
+{
+    auto ait = arenas.find(alloc.bufferID);
+    if (ait == arenas.end())
+        return;
+    Arena *arena = ait->second;
+
+    // Merge with the free space after and before us
+    size_t offset = alloc.offset, size = alloc.size;
+    auto next = arena->freeBlocks.lower_bound(offset);
+    if (next != arena->freeBlocks.end() && next->first == offset + size)
+    {
+        const size_t nextOffset = next->first, nextSize = next->second;
+        removeFreeBlock(arena, nextOffset, nextSize);
+        size += nextSize;
+    }
+    next = arena->freeBlocks.lower_bound(offset);
+    if (next != arena->freeBlocks.begin())
+    {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset)
+        {
+            const size_t prevOffset = prev->first, prevSize = prev->second;
+            removeFreeBlock(arena, prevOffset, prevSize);
+            offset = prevOffset;
+            size += prevSize;
+        }
+    }
+    addFreeBlock(arena, offset, size);
+
+    arena->used -= alloc.size;
+    arena->numAllocs--;
+    requestedBytes -= alloc.requestedSize;
+
+    // Hang on to one empty arena so tiles coming and going don't thrash the buffers
+    if (arena->used == 0)
+    {
+        if (numEmpty > 0)
+            releaseArena(arena);
+        else
+            numEmpty++;
+    }
+}
+
+void BufferArenaAllocator::trim()
+{
+    std::vector<Arena *> toRelease;
+    for (auto it : arenas)
+        if (it.second->used == 0)
+            toRelease.push_back(it.second);
+    for (Arena *arena : toRelease)
+        releaseArena(arena);
+    numEmpty = 0;
+}
+
+void BufferArenaAllocator::clear()
+{
+    while (!arenas.empty())
+        releaseArena(arenas.begin()->second);
+    freeBySize.clear();
+    numEmpty = 0;
+    requestedBytes = 0;
+}
+
+BufferArenaStats BufferArenaAllocator::getStats() const
+{
+    BufferArenaStats stats;
+    stats.numArenas = (int)arenas.size();
+    stats.arenaBytes = arenas.size() * arenaSize;
+    for (auto it : arenas)
+    {
+        stats.numAllocs += it.second->numAllocs;
+        stats.usedBytes += it.second->used;
+        stats.numFreeBlocks += (int)it.second->freeBlocks.size();
+    }
+    if (!freeBySize.empty())
+        stats.largestFreeBlock = freeBySize.rbegin()->size;
+    stats.requestedBytes = requestedBytes;
+    stats.arenasCreated = arenasCreated;
+    stats.arenasReleased = arenasReleased;
+
+    return stats;
+}
+
+}
@@ -23,7 +23,7 @@
 namespace WhirlyKit
 {
 
-ChangeRequest::ChangeRequest() : when(0.0) { }
+ChangeRequest::ChangeRequest() : when(0.0), prepareState(PrepareNone) { }
 
 ChangeRequest::~ChangeRequest()
 {
@@ -33,6 +33,10 @@ bool ChangeRequest::needsFlush() { return false; }
 
 void ChangeRequest::setupForRenderer(const RenderSetupInfo *) { }
 
+bool ChangeRequest::needsPrepare() { return false; }
+
+void ChangeRequest::prepare(Scene *scene,const RenderSetupInfo *setupInfo) { }
+
 bool ChangeRequest::needPreExecute() { return false; }
 
 }
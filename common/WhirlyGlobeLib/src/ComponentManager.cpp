@@ -47,6 +47,7 @@ void ComponentObject::clear()
     partSysIDs.clear();
     selectIDs.clear();
     drawStringIDs.clear();
+    drawIDs.clear();
 }
 
 ComponentManager::ComponentManager()
@@ -172,6 +173,8 @@ void ComponentManager::removeComponentObjects(PlatformThreadInfo *threadInfo,con
             for (SimpleIdentity partSysID : compObj->partSysIDs)
                 partSysManager->removeParticleSystem(partSysID, changes);
         }
+        for (SimpleIdentity drawID : compObj->drawIDs)
+            changes.push_back(new RemDrawableReq(drawID));
     }
 }
     
@@ -242,6 +245,8 @@ void ComponentManager::enableComponentObjects(const SimpleIDSet &compIDs,bool en
                  it != compObj->partSysIDs.end(); ++it)
                 partSysManager->enableParticleSystem(*it, enable, changes);
         }
+        for (SimpleIdentity drawID : compObj->drawIDs)
+            changes.push_back(new OnOffChangeRequest(drawID,enable));
     }
 }
     
@@ -18,6 +18,7 @@
  *
  */
 
+#import <float.h>
 #import "Drawable.h"
 #import "Scene.h"
 #import "WhirlyKitLog.h"
@@ -40,6 +41,16 @@ Drawable::~Drawable()
 {
 }
     
+void Drawable::prepareForRenderer(const RenderSetupInfo *setupInfo)
+{
+}
+
+void Drawable::getVisibilityRanges(double &minHeight,double &maxHeight,TimeInterval &startTime,TimeInterval &endTime) const
+{
+    minHeight = -DBL_MAX;  maxHeight = DBL_MAX;
+    startTime = -DBL_MAX;  endTime = DBL_MAX;
+}
+
 void Drawable::runTweakers(RendererFrameInfo *frame)
 {
     for (DrawableTweakerRefSet::iterator it = tweakers.begin();
@@ -51,7 +62,11 @@ void DrawableChangeRequest::execute(Scene *scene,SceneRenderer *renderer,WhirlyK
 {
 	DrawableRef theDrawable = scene->getDrawable(drawId);
 	if (theDrawable)
+	{
 		execute2(scene,renderer,theDrawable);
+		// Visibility may have changed
+		scene->updateDrawable(theDrawable);
+	}
 }
     
 }
@@ -0,0 +1,253 @@
+/*
+ *  DrawableVisibilityIndex.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <float.h>
+#import <math.h>
+#import "DrawableVisibilityIndex.h"
+
+namespace WhirlyKit
+{
+
+DrawableVisibilityIndex::DrawableVisibilityIndex()
+: lastTime(-DBL_MAX)
+{
+}
+
+DrawableVisibilityIndex::~DrawableVisibilityIndex()
+{
+    clear();
+}
+
+void DrawableVisibilityIndex::clear()
+{
+    for (auto it : entries)
+        delete it.second;
+    entries.clear();
+    unbounded.clear();
+    for (int ii=0;ii<NumBuckets;ii++)
+        buckets[ii].clear();
+    pending.clear();
+    ending.clear();
+}
+
+int DrawableVisibilityIndex::bucketForHeight(double height) const
+{
+    if (height <= 0.0)
+        return 0;
+    // Display units put the heights we care about between about 2^-30 and 2^10
+    int exp;
+    frexp(height, &exp);
+    return std::max(0,std::min(exp + 40,NumBuckets-1));
+}
+
+void DrawableVisibilityIndex::readRanges(Entry *entry)
+{
+    entry->draw->getVisibilityRanges(entry->minHeight, entry->maxHeight, entry->startTime, entry->endTime);
+}
+
+void DrawableVisibilityIndex::addToList(std::vector<Entry *> &list,Entry *entry,int &slot)
+{
+    slot = (int)list.size();
+    list.push_back(entry);
+}
+
+void DrawableVisibilityIndex::removeFromList(std::vector<Entry *> &list,int slot,int bucket)
+{
+    // Move the last one into the hole
+    Entry *last = list.back();
+    list[slot] = last;
+    if (bucket < 0)
+        last->slots[0] = slot;
+    else
+        last->slots[bucket - last->startBucket] = slot;
+    list.pop_back();
+}
+
+void DrawableVisibilityIndex::addToBuckets(Entry *entry)
+{
+    entry->startBucket = -1;
+    entry->endBucket = -1;
+    if (entry->minHeight > -DBL_MAX || entry->maxHeight < DBL_MAX)
+    {
+        const int startBucket = bucketForHeight(entry->minHeight);
+        const int endBucket = bucketForHeight(entry->maxHeight);
+        // Ranges this wide aren't worth copying around
+        if (endBucket - startBucket < NumBuckets/2)
+        {
+            entry->startBucket = startBucket;
+            entry->endBucket = endBucket;
+        }
+    }
+
+    if (entry->startBucket < 0)
+    {
+        entry->slots.resize(1);
+        addToList(unbounded, entry, entry->slots[0]);
+    } else {
+        entry->slots.resize(entry->endBucket - entry->startBucket + 1);
+        for (int bucket=entry->startBucket;bucket<=entry->endBucket;bucket++)
+            addToList(buckets[bucket], entry, entry->slots[bucket - entry->startBucket]);
+    }
+}
+
+void DrawableVisibilityIndex::removeFromBuckets(Entry *entry)
+{
+    if (entry->startBucket < 0)
+        removeFromList(unbounded, entry->slots[0], -1);
+    else
+        for (int bucket=entry->startBucket;bucket<=entry->endBucket;bucket++)
+            removeFromList(buckets[bucket], entry->slots[bucket - entry->startBucket], bucket);
+    entry->slots.clear();
+}
+
+void DrawableVisibilityIndex::insertEntry(Entry *entry)
+{
+    entry->hasTimeIt = false;
+    if (lastTime < entry->startTime)
+    {
+        entry->timeState = TimePending;
+        entry->timeIt = pending.insert(std::make_pair(entry->startTime,entry));
+        entry->hasTimeIt = true;
+    } else if (entry->endTime < lastTime) {
+        entry->timeState = TimeExpired;
+    } else {
+        entry->timeState = TimeActive;
+        addToBuckets(entry);
+        if (entry->endTime < DBL_MAX)
+        {
+            entry->timeIt = ending.insert(std::make_pair(entry->endTime,entry));
+            entry->hasTimeIt = true;
+        }
+    }
+}
+
+void DrawableVisibilityIndex::eraseEntry(Entry *entry)
+{
+    switch (entry->timeState)
+    {
+        case TimePending:
+            pending.erase(entry->timeIt);
+            break;
+        case TimeActive:
+            removeFromBuckets(entry);
+            if (entry->hasTimeIt)
+                ending.erase(entry->timeIt);
+            break;
+        case TimeExpired:
+            break;
+    }
+    entry->hasTimeIt = false;
+}
+
+void DrawableVisibilityIndex::addDrawable(const DrawableRef &draw)
+{
+    if (entries.find(draw->getId()) != entries.end())
+    {
+        updateDrawable(draw);
+        return;
+    }
+
+    Entry *entry = new Entry();
+    entry->draw = draw;
+    readRanges(entry);
+    insertEntry(entry);
+    entries[draw->getId()] = entry;
+}
+
+void DrawableVisibilityIndex::removeDrawable(SimpleIdentity drawID)
+{
+    auto it = entries.find(drawID);
+    if (it == entries.end())
+        return;
+
+    eraseEntry(it->second);
+    delete it->second;
+    entries.erase(it);
+}
+
+void DrawableVisibilityIndex::updateDrawable(const DrawableRef &draw)
+{
+    auto it = entries.find(draw->getId());
+    if (it == entries.end())
+        return;
+    Entry *entry = it->second;
+
+    double minHeight,maxHeight;
+    TimeInterval startTime,endTime;
+    draw->getVisibilityRanges(minHeight, maxHeight, startTime, endTime);
+    if (minHeight == entry->minHeight && maxHeight == entry->maxHeight &&
+        startTime == entry->startTime && endTime == entry->endTime)
+        return;
+
+    eraseEntry(entry);
+    entry->minHeight = minHeight;  entry->maxHeight = maxHeight;
+    entry->startTime = startTime;  entry->endTime = endTime;
+    insertEntry(entry);
+}
+
+void DrawableVisibilityIndex::updateTime(TimeInterval now)
+{
+    // Time went backwards, so sort everything out again
+    if (now < lastTime)
+    {
+        lastTime = now;
+        for (auto it : entries)
+        {
+            eraseEntry(it.second);
+            insertEntry(it.second);
+        }
+        return;
+    }
+    lastTime = now;
+
+    // Windows that have opened
+    while (!pending.empty() && pending.begin()->first <= now)
+    {
+        Entry *entry = pending.begin()->second;
+        pending.erase(pending.begin());
+        entry->hasTimeIt = false;
+        insertEntry(entry);
+    }
+
+    // And closed
+    while (!ending.empty() && ending.begin()->first < now)
+    {
+        Entry *entry = ending.begin()->second;
+        ending.erase(ending.begin());
+        entry->hasTimeIt = false;
+        removeFromBuckets(entry);
+        entry->timeState = TimeExpired;
+    }
+}
+
+void DrawableVisibilityIndex::findDrawables(double height,TimeInterval now,std::vector<DrawableRef> &draws)
+{
+    updateTime(now);
+
+    for (Entry *entry : unbounded)
+        if (entry->minHeight <= height && height <= entry->maxHeight)
+            draws.push_back(entry->draw);
+
+    for (Entry *entry : buckets[bucketForHeight(height)])
+        if (entry->minHeight <= height && height <= entry->maxHeight)
+            draws.push_back(entry->draw);
+}
+
+}
@@ -0,0 +1,842 @@
+/*
+ *  ETC2Encoder.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <limits.h>
+#import <math.h>
+#import <stdlib.h>
+#import <string.h>
+#import <algorithm>
+#import <thread>
+#import <vector>
+#import "ETC2Encoder.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#import <emmintrin.h>
+#define WK_ETC_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#import <arm_neon.h>
+#define WK_ETC_NEON 1
+#endif
+
+namespace WhirlyKit
+{
+
+// Modifier tables for individual and differential blocks
+static const int ETCModifiers[8][2] = {{2,8},{5,17},{9,29},{13,42},{18,60},{24,80},{33,106},{47,183}};
+
+// Modifier tables for EAC alpha
+static const int EACModifiers[16][8] = {
+    {-3,-6,-9,-15,2,5,8,14},
+    {-3,-7,-10,-13,2,6,9,12},
+    {-2,-5,-8,-13,1,4,7,12},
+    {-2,-4,-6,-13,1,3,5,12},
+    {-3,-6,-8,-12,2,5,7,11},
+    {-3,-7,-9,-11,2,6,8,10},
+    {-4,-7,-8,-11,3,6,7,10},
+    {-3,-5,-8,-11,2,4,7,10},
+    {-2,-6,-8,-10,1,5,7,9},
+    {-2,-5,-8,-10,1,4,7,9},
+    {-2,-4,-8,-10,1,3,7,9},
+    {-2,-5,-7,-10,1,4,6,9},
+    {-3,-4,-7,-10,2,3,6,9},
+    {-1,-2,-3,-10,0,1,2,9},
+    {-4,-6,-8,-9,3,5,7,8},
+    {-3,-5,-7,-9,2,4,6,8}
+};
+
+static inline int ETCClamp(int val)
+{
+    return val < 0 ? 0 : (val > 255 ? 255 : val);
+}
+
+// Expand 4, 5, 6 and 7 bit colors out to 8
+static inline int ETCExpand4(int val) { return (val << 4) | val; }
+static inline int ETCExpand5(int val) { return (val << 3) | (val >> 2); }
+static inline int ETCExpand6(int val) { return (val << 2) | (val >> 4); }
+static inline int ETCExpand7(int val) { return (val << 1) | (val >> 6); }
+
+// Quantize an 8 bit value to the given number of bits
+static inline int ETCQuantize(float val,int bits)
+{
+    const int maxVal = (1 << bits) - 1;
+    return std::max(0,std::min(maxVal,(int)(val * maxVal / 255.f + 0.5f)));
+}
+
+// Pixels in half a block, split out by channel, along with where they sit in the block.
+// Pixels are numbered down the columns, the way the index bits are.
+class ETCSubblock
+{
+public:
+    int16_t r[8],g[8],b[8];
+    int pos[8];
+    float avg[3];
+};
+
+// Split the block into halves, side by side or (flipped) one over the other
+static void ETCSplitBlock(const unsigned char *rgba,bool flip,ETCSubblock sub[2])
+{
+    int count[2] = {0,0};
+    float sum[2][3] = {{0,0,0},{0,0,0}};
+    for (int y=0;y<4;y++)
+        for (int x=0;x<4;x++)
+        {
+            const int which = flip ? (y >= 2) : (x >= 2);
+            const unsigned char *pix = &rgba[(y*4+x)*4];
+            ETCSubblock &s = sub[which];
+            const int ii = count[which]++;
+            s.r[ii] = pix[0];  s.g[ii] = pix[1];  s.b[ii] = pix[2];
+            s.pos[ii] = x*4+y;
+            for (int c=0;c<3;c++)
+                sum[which][c] += pix[c];
+        }
+    for (int which=0;which<2;which++)
+        for (int c=0;c<3;c++)
+            sub[which].avg[c] = sum[which][c] / 8.f;
+}
+
+// The four colors a table gives us around a base color, in index order
+static void ETCTableColors(const int base[3],int table,int colors[4][3])
+{
+    const int a = ETCModifiers[table][0], b = ETCModifiers[table][1];
+    const int mods[4] = {a,b,-a,-b};
+    for (int k=0;k<4;k++)
+        for (int c=0;c<3;c++)
+            colors[k][c] = ETCClamp(base[c] + mods[k]);
+}
+
+// Squared error for half a block with one table, picking the best index for each pixel
+static int ETCTableErrorScalar(const ETCSubblock &sub,const int base[3],int table,int idx[8])
+{
+    int colors[4][3];
+    ETCTableColors(base, table, colors);
+
+    int total = 0;
+    for (int ii=0;ii<8;ii++)
+    {
+        int best = INT_MAX, bestK = 0;
+        for (int k=0;k<4;k++)
+        {
+            const int dr = sub.r[ii] - colors[k][0], dg = sub.g[ii] - colors[k][1], db = sub.b[ii] - colors[k][2];
+            const int err = dr*dr + dg*dg + db*db;
+            if (err < best)
+            {
+                best = err;
+                bestK = k;
+            }
+        }
+        idx[ii] = bestK;
+        total += best;
+    }
+
+    return total;
+}
+
+#if WK_ETC_SSE
+// Same thing, all eight pixels at once
+static int ETCTableErrorSIMD(const ETCSubblock &sub,const int base[3],int table,int idx[8])
+{
+    int colors[4][3];
+    ETCTableColors(base, table, colors);
+
+    const __m128i r = _mm_loadu_si128((const __m128i *)sub.r);
+    const __m128i g = _mm_loadu_si128((const __m128i *)sub.g);
+    const __m128i b = _mm_loadu_si128((const __m128i *)sub.b);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i bestLo = _mm_set1_epi32(INT_MAX), bestHi = bestLo;
+    __m128i idxLo = zero, idxHi = zero;
+    for (int k=0;k<4;k++)
+    {
+        const __m128i dr = _mm_sub_epi16(r, _mm_set1_epi16(colors[k][0]));
+        const __m128i dg = _mm_sub_epi16(g, _mm_set1_epi16(colors[k][1]));
+        const __m128i db = _mm_sub_epi16(b, _mm_set1_epi16(colors[k][2]));
+        // Squares summed up in 32 bits, since they don't fit in 16
+        const __m128i rgLo = _mm_unpacklo_epi16(dr, dg), rgHi = _mm_unpackhi_epi16(dr, dg);
+        const __m128i bLo = _mm_unpacklo_epi16(db, zero), bHi = _mm_unpackhi_epi16(db, zero);
+        const __m128i errLo = _mm_add_epi32(_mm_madd_epi16(rgLo, rgLo), _mm_madd_epi16(bLo, bLo));
+        const __m128i errHi = _mm_add_epi32(_mm_madd_epi16(rgHi, rgHi), _mm_madd_epi16(bHi, bHi));
+        const __m128i which = _mm_set1_epi32(k);
+        const __m128i maskLo = _mm_cmplt_epi32(errLo, bestLo), maskHi = _mm_cmplt_epi32(errHi, bestHi);
+        bestLo = _mm_or_si128(_mm_and_si128(maskLo, errLo), _mm_andnot_si128(maskLo, bestLo));
+        bestHi = _mm_or_si128(_mm_and_si128(maskHi, errHi), _mm_andnot_si128(maskHi, bestHi));
+        idxLo = _mm_or_si128(_mm_and_si128(maskLo, which), _mm_andnot_si128(maskLo, idxLo));
+        idxHi = _mm_or_si128(_mm_and_si128(maskHi, which), _mm_andnot_si128(maskHi, idxHi));
+    }
+
+    int32_t errs[8];
+    _mm_storeu_si128((__m128i *)&errs[0], bestLo);
+    _mm_storeu_si128((__m128i *)&errs[4], bestHi);
+    _mm_storeu_si128((__m128i *)&idx[0], idxLo);
+    _mm_storeu_si128((__m128i *)&idx[4], idxHi);
+
+    int total = 0;
+    for (int ii=0;ii<8;ii++)
+        total += errs[ii];
+    return total;
+}
+#elif WK_ETC_NEON
+// Same thing, all eight pixels at once
+static int ETCTableErrorSIMD(const ETCSubblock &sub,const int base[3],int table,int idx[8])
+{
+    int colors[4][3];
+    ETCTableColors(base, table, colors);
+
+    const int16x8_t r = vld1q_s16(sub.r), g = vld1q_s16(sub.g), b = vld1q_s16(sub.b);
+    int32x4_t bestLo = vdupq_n_s32(INT_MAX), bestHi = bestLo;
+    int32x4_t idxLo = vdupq_n_s32(0), idxHi = idxLo;
+    for (int k=0;k<4;k++)
+    {
+        const int16x8_t dr = vsubq_s16(r, vdupq_n_s16(colors[k][0]));
+        const int16x8_t dg = vsubq_s16(g, vdupq_n_s16(colors[k][1]));
+        const int16x8_t db = vsubq_s16(b, vdupq_n_s16(colors[k][2]));
+        int32x4_t errLo = vmull_s16(vget_low_s16(dr), vget_low_s16(dr));
+        errLo = vmlal_s16(errLo, vget_low_s16(dg), vget_low_s16(dg));
+        errLo = vmlal_s16(errLo, vget_low_s16(db), vget_low_s16(db));
+        int32x4_t errHi = vmull_s16(vget_high_s16(dr), vget_high_s16(dr));
+        errHi = vmlal_s16(errHi, vget_high_s16(dg), vget_high_s16(dg));
+        errHi = vmlal_s16(errHi, vget_high_s16(db), vget_high_s16(db));
+        const int32x4_t which = vdupq_n_s32(k);
+        const uint32x4_t maskLo = vcltq_s32(errLo, bestLo), maskHi = vcltq_s32(errHi, bestHi);
+        bestLo = vbslq_s32(maskLo, errLo, bestLo);
+        bestHi = vbslq_s32(maskHi, errHi, bestHi);
+        idxLo = vbslq_s32(maskLo, which, idxLo);
+        idxHi = vbslq_s32(maskHi, which, idxHi);
+    }
+
+    int32_t errs[8];
+    vst1q_s32(&errs[0], bestLo);
+    vst1q_s32(&errs[4], bestHi);
+    vst1q_s32(&idx[0], idxLo);
+    vst1q_s32(&idx[4], idxHi);
+
+    int total = 0;
+    for (int ii=0;ii<8;ii++)
+        total += errs[ii];
+    return total;
+}
+#endif
+
+// Best table and indices for half a block around a given base color
+class ETCFit
+{
+public:
+    ETCFit() : err(INT_MAX), table(0) { }
+
+    int err;
+    int table;
+    int idx[8];
+};
+
+static void ETCFitSubblock(const ETCSubblock &sub,const int base[3],bool allowSIMD,ETCFit &fit)
+{
+    fit.err = INT_MAX;
+    int idx[8];
+    for (int table=0;table<8;table++)
+    {
+#if WK_ETC_SSE || WK_ETC_NEON
+        const int err = allowSIMD ? ETCTableErrorSIMD(sub, base, table, idx) : ETCTableErrorScalar(sub, base, table, idx);
+#else
+        const int err = ETCTableErrorScalar(sub, base, table, idx);
+#endif
+        if (err < fit.err)
+        {
+            fit.err = err;
+            fit.table = table;
+            memcpy(fit.idx, idx, sizeof(idx));
+        }
+    }
+}
+
+// An individual or differential block we're considering
+class ETCCandidate
+{
+public:
+    ETCCandidate() : diff(false), flip(false), err(INT_MAX) { }
+
+    bool diff,flip;
+    // Quantized base colors, 4 or 5 bits
+    int c1[3],c2[3];
+    ETCFit fit[2];
+    int err;
+};
+
+static void ETCBaseColor(const int quant[3],bool diff,int base[3])
+{
+    for (int c=0;c<3;c++)
+        base[c] = diff ? ETCExpand5(quant[c]) : ETCExpand4(quant[c]);
+}
+
+// Nudges to the base color we try when searching.  One channel at a time, then all together.
+static const int ETCSearchSteps[9][3] = {{0,0,0},{-1,0,0},{1,0,0},{0,-1,0},{0,1,0},{0,0,-1},{0,0,1},{-1,-1,-1},{1,1,1}};
+
+// Fit half a block, optionally trying the quantized colors around the one we're given.
+// In differential mode the second half has to stay within reach of the first.
+static void ETCSearchSubblock(const ETCSubblock &sub,const int start[3],bool diff,const int *anchor,bool search,bool allowSIMD,int quant[3],ETCFit &fit)
+{
+    const int maxVal = diff ? 31 : 15;
+    const int numSteps = search ? 9 : 1;
+    fit.err = INT_MAX;
+    for (int step=0;step<numSteps;step++)
+    {
+        int q[3];
+        bool valid = true;
+        for (int c=0;c<3;c++)
+        {
+            q[c] = start[c] + ETCSearchSteps[step][c];
+            if (q[c] < 0 || q[c] > maxVal)
+                valid = false;
+            if (anchor && (q[c] - anchor[c] < -4 || q[c] - anchor[c] > 3))
+                valid = false;
+        }
+        if (!valid)
+            continue;
+
+        int base[3];
+        ETCBaseColor(q, diff, base);
+        ETCFit thisFit;
+        ETCFitSubblock(sub, base, allowSIMD, thisFit);
+        if (thisFit.err < fit.err)
+        {
+            fit = thisFit;
+            memcpy(quant, q, sizeof(q));
+        }
+    }
+}
+
+static void ETCFitCandidate(const ETCSubblock sub[2],bool diff,bool search,bool allowSIMD,ETCCandidate &cand)
+{
+    const int bits = diff ? 5 : 4;
+    int q1[3],q2[3];
+    for (int c=0;c<3;c++)
+    {
+        q1[c] = ETCQuantize(sub[0].avg[c], bits);
+        q2[c] = ETCQuantize(sub[1].avg[c], bits);
+    }
+
+    cand.diff = diff;
+    ETCSearchSubblock(sub[0], q1, diff, NULL, search, allowSIMD, cand.c1, cand.fit[0]);
+    if (diff)
+    {
+        // Pull the second color in range of the first if need be
+        for (int c=0;c<3;c++)
+            q2[c] = std::max(cand.c1[c]-4,std::min(cand.c1[c]+3,q2[c]));
+        ETCSearchSubblock(sub[1], q2, diff, cand.c1, search, allowSIMD, cand.c2, cand.fit[1]);
+    } else
+        ETCSearchSubblock(sub[1], q2, diff, NULL, search, allowSIMD, cand.c2, cand.fit[1]);
+    cand.err = cand.fit[0].err + cand.fit[1].err;
+}
+
+static void ETCWriteBits(uint64_t bits,unsigned char *out)
+{
+    for (int ii=0;ii<8;ii++)
+        out[ii] = (unsigned char)(bits >> (56 - 8*ii));
+}
+
+static uint64_t ETCReadBits(const unsigned char *in)
+{
+    uint64_t bits = 0;
+    for (int ii=0;ii<8;ii++)
+        bits = (bits << 8) | in[ii];
+    return bits;
+}
+
+static uint64_t ETCPackCandidate(const ETCCandidate &cand,const ETCSubblock sub[2])
+{
+    uint64_t bits = 0;
+    for (int c=0;c<3;c++)
+    {
+        if (cand.diff)
+        {
+            bits |= (uint64_t)cand.c1[c] << (59 - 8*c);
+            bits |= (uint64_t)((cand.c2[c] - cand.c1[c]) & 0x7) << (56 - 8*c);
+        } else {
+            bits |= (uint64_t)cand.c1[c] << (60 - 8*c);
+            bits |= (uint64_t)cand.c2[c] << (56 - 8*c);
+        }
+    }
+    bits |= (uint64_t)cand.fit[0].table << 37;
+    bits |= (uint64_t)cand.fit[1].table << 34;
+    bits |= (uint64_t)(cand.diff ? 1 : 0) << 33;
+    bits |= (uint64_t)(cand.flip ? 1 : 0) << 32;
+    // Index bits are split into most and least significant halves
+    for (int which=0;which<2;which++)
+        for (int ii=0;ii<8;ii++)
+        {
+            const int k = cand.fit[which].idx[ii];
+            const int pos = sub[which].pos[ii];
+            bits |= (uint64_t)(k >> 1) << (pos + 16);
+            bits |= (uint64_t)(k & 1) << pos;
+        }
+
+    return bits;
+}
+
+// Planar blocks are a gradient across the block, stored as the colors at three corners
+class ETCPlanar
+{
+public:
+    // Origin, horizontal and vertical colors for red, green and blue.  6, 7 and 6 bits.
+    int o[3],h[3],v[3];
+    int err;
+};
+
+static inline int ETCPlanarExpand(int val,int c)
+{
+    return c == 1 ? ETCExpand7(val) : ETCExpand6(val);
+}
+
+static inline int ETCPlanarValue(int o,int h,int v,int x,int y)
+{
+    return ETCClamp((x*(h-o) + y*(v-o) + 4*o + 2) >> 2);
+}
+
+// Error for one channel of a planar block
+static int ETCPlanarChannelError(const unsigned char *rgba,int c,int o,int h,int v)
+{
+    const int oe = ETCPlanarExpand(o,c), he = ETCPlanarExpand(h,c), ve = ETCPlanarExpand(v,c);
+    int err = 0;
+    for (int y=0;y<4;y++)
+        for (int x=0;x<4;x++)
+        {
+            const int diff = rgba[(y*4+x)*4+c] - ETCPlanarValue(oe, he, ve, x, y);
+            err += diff*diff;
+        }
+    return err;
+}
+
+// Least squares fit of a plane to each channel.  The channels are independent, so searching is cheap.
+static void ETCFitPlanar(const unsigned char *rgba,bool search,ETCPlanar &planar)
+{
+    planar.err = 0;
+    for (int c=0;c<3;c++)
+    {
+        float mean = 0.f, sx = 0.f, sy = 0.f;
+        for (int y=0;y<4;y++)
+            for (int x=0;x<4;x++)
+            {
+                const float val = rgba[(y*4+x)*4+c];
+                mean += val;
+                sx += (x-1.5f) * val;
+                sy += (y-1.5f) * val;
+            }
+        mean /= 16.f;  sx /= 20.f;  sy /= 20.f;
+        const float o = mean - 1.5f*(sx+sy);
+        const int bits = c == 1 ? 7 : 6;
+        int qo = ETCQuantize(o, bits), qh = ETCQuantize(o + 4.f*sx, bits), qv = ETCQuantize(o + 4.f*sy, bits);
+
+        int best = ETCPlanarChannelError(rgba, c, qo, qh, qv);
+        if (search)
+        {
+            const int maxVal = (1 << bits) - 1;
+            const int startO = qo, startH = qh, startV = qv;
+            for (int dO=-1;dO<=1;dO++)
+                for (int dH=-1;dH<=1;dH++)
+                    for (int dV=-1;dV<=1;dV++)
+                    {
+                        const int to = startO+dO, th = startH+dH, tv = startV+dV;
+                        if (to < 0 || th < 0 || tv < 0 || to > maxVal || th > maxVal || tv > maxVal)
+                            continue;
+                        const int err = ETCPlanarChannelError(rgba, c, to, th, tv);
+                        if (err < best)
+                        {
+                            best = err;
+                            qo = to;  qh = th;  qv = tv;
+                        }
+                    }
+        }
+        planar.o[c] = qo;  planar.h[c] = qh;  planar.v[c] = qv;
+        planar.err += best;
+    }
+}
+
+static uint64_t ETCPackPlanar(const ETCPlanar &planar)
+{
+    uint64_t bits = 0;
+    bits |= (uint64_t)planar.o[0] << 57;
+    bits |= (uint64_t)(planar.o[1] >> 6) << 56;
+    bits |= (uint64_t)(planar.o[1] & 0x3f) << 49;
+    bits |= (uint64_t)(planar.o[2] >> 5) << 48;
+    bits |= (uint64_t)((planar.o[2] >> 3) & 0x3) << 43;
+    bits |= (uint64_t)(planar.o[2] & 0x7) << 39;
+    bits |= (uint64_t)(planar.h[0] >> 1) << 34;
+    bits |= (uint64_t)(planar.h[0] & 0x1) << 32;
+    bits |= (uint64_t)1 << 33;
+    bits |= (uint64_t)planar.h[1] << 25;
+    bits |= (uint64_t)planar.h[2] << 19;
+    bits |= (uint64_t)planar.v[0] << 13;
+    bits |= (uint64_t)planar.v[1] << 6;
+    bits |= (uint64_t)planar.v[2];
+
+    // Planar blocks are marked by red and green fitting in differential mode and blue not.
+    // The unused bits are there to make that happen.
+    const int r1 = (bits >> 59) & 0x1f, dr = ((int)((bits >> 56) & 0x7) ^ 4) - 4;
+    if (r1 + dr < 0 || r1 + dr > 31)
+        bits |= (uint64_t)1 << 63;
+    const int g1 = (bits >> 51) & 0x1f, dg = ((int)((bits >> 48) & 0x7) ^ 4) - 4;
+    if (g1 + dg < 0 || g1 + dg > 31)
+        bits |= (uint64_t)1 << 55;
+    const int bu = (bits >> 43) & 0x3, bv = (bits >> 40) & 0x3;
+    if (bu + bv >= 4)
+        bits |= (uint64_t)0x7 << 45;
+    else
+        bits |= (uint64_t)1 << 42;
+
+    return bits;
+}
+
+void ETC2EncodeRGBBlock(const unsigned char *rgba,unsigned char *out,ETC2Quality quality,bool allowSIMD)
+{
+    const bool search = quality >= ETC2QualityHigh;
+
+    ETCCandidate best;
+    ETCSubblock bestSub[2];
+    for (int flip=0;flip<2;flip++)
+    {
+        ETCSubblock sub[2];
+        ETCSplitBlock(rgba, flip, sub);
+
+        ETCCandidate diffCand;
+        diffCand.flip = flip;
+        ETCFitCandidate(sub, true, search, allowSIMD, diffCand);
+        if (diffCand.err < best.err)
+        {
+            best = diffCand;
+            bestSub[0] = sub[0];  bestSub[1] = sub[1];
+        }
+
+        // Individual blocks help when the halves are far apart in color.
+        // For the fast version only bother if differential had to clamp.
+        bool tryIndividual = quality >= ETC2QualityNormal;
+        if (!tryIndividual)
+            for (int c=0;c<3;c++)
+            {
+                const int d = ETCQuantize(sub[1].avg[c], 5) - ETCQuantize(sub[0].avg[c], 5);
+                if (d < -4 || d > 3)
+                    tryIndividual = true;
+            }
+        if (tryIndividual)
+        {
+            ETCCandidate indCand;
+            indCand.flip = flip;
+            ETCFitCandidate(sub, false, search, allowSIMD, indCand);
+            if (indCand.err < best.err)
+            {
+                best = indCand;
+                bestSub[0] = sub[0];  bestSub[1] = sub[1];
+            }
+        }
+    }
+
+    if (quality >= ETC2QualityNormal)
+    {
+        ETCPlanar planar;
+        ETCFitPlanar(rgba, search, planar);
+        if (planar.err < best.err)
+        {
+            ETCWriteBits(ETCPackPlanar(planar), out);
+            return;
+        }
+    }
+
+    ETCWriteBits(ETCPackCandidate(best, bestSub), out);
+}
+
+// Error for one alpha table, multiplier and base, with the best index for each pixel
+static int EACAlphaError(const int alpha[16],int base,int mult,int table,int idx[16])
+{
+    int vals[8];
+    for (int k=0;k<8;k++)
+        vals[k] = ETCClamp(base + EACModifiers[table][k] * mult);
+
+    int total = 0;
+    for (int ii=0;ii<16;ii++)
+    {
+        int best = INT_MAX, bestK = 0;
+        for (int k=0;k<8;k++)
+        {
+            const int diff = alpha[ii] - vals[k];
+            if (diff*diff < best)
+            {
+                best = diff*diff;
+                bestK = k;
+            }
+        }
+        idx[ii] = bestK;
+        total += best;
+    }
+
+    return total;
+}
+
+void ETC2EncodeAlphaBlock(const unsigned char *rgba,unsigned char *out,ETC2Quality quality)
+{
+    // Pixels go down the columns
+    int alpha[16];
+    int minA = 255, maxA = 0;
+    for (int y=0;y<4;y++)
+        for (int x=0;x<4;x++)
+        {
+            const int val = rgba[(y*4+x)*4+3];
+            alpha[x*4+y] = val;
+            minA = std::min(minA,val);
+            maxA = std::max(maxA,val);
+        }
+
+    // A multiplier of zero gives us the base everywhere
+    int bestBase = minA, bestMult = 0, bestTable = 0;
+    int bestIdx[16];
+    memset(bestIdx, 0, sizeof(bestIdx));
+
+    if (minA != maxA)
+    {
+        const int multRange = quality >= ETC2QualityNormal ? 1 : 0;
+        const int baseRange = quality >= ETC2QualityHigh ? 2 : (quality >= ETC2QualityNormal ? 1 : 0);
+        int bestErr = INT_MAX;
+        int idx[16];
+        for (int table=0;table<16;table++)
+        {
+            // Stretch the table over the range we've got
+            const int lo = EACModifiers[table][3], hi = EACModifiers[table][7];
+            const int mult = std::max(1,std::min(15,(int)((maxA - minA) / (float)(hi - lo) + 0.5f)));
+            const int base = ETCClamp((int)((minA + maxA) / 2.f - (lo + hi) * mult / 2.f + 0.5f));
+            for (int dm=-multRange;dm<=multRange;dm++)
+                for (int db=-baseRange;db<=baseRange;db++)
+                {
+                    const int thisMult = mult + dm, thisBase = base + db;
+                    if (thisMult < 1 || thisMult > 15 || thisBase < 0 || thisBase > 255)
+                        continue;
+                    const int err = EACAlphaError(alpha, thisBase, thisMult, table, idx);
+                    if (err < bestErr)
+                    {
+                        bestErr = err;
+                        bestBase = thisBase;  bestMult = thisMult;  bestTable = table;
+                        memcpy(bestIdx, idx, sizeof(idx));
+                    }
+                }
+            if (bestErr == 0)
+                break;
+        }
+    }
+
+    uint64_t bits = 0;
+    bits |= (uint64_t)bestBase << 56;
+    bits |= (uint64_t)bestMult << 52;
+    bits |= (uint64_t)bestTable << 48;
+    for (int ii=0;ii<16;ii++)
+        bits |= (uint64_t)bestIdx[ii] << (45 - 3*ii);
+    ETCWriteBits(bits, out);
+}
+
+bool ETC2DecodeRGBBlock(const unsigned char *in,unsigned char *rgba)
+{
+    const uint64_t bits = ETCReadBits(in);
+    const bool diff = (bits >> 33) & 1;
+    const bool flip = (bits >> 32) & 1;
+
+    int base[2][3];
+    if (diff)
+    {
+        int c1[3],c2[3];
+        for (int c=0;c<3;c++)
+        {
+            c1[c] = (bits >> (59 - 8*c)) & 0x1f;
+            c2[c] = c1[c] + ((int)((bits >> (56 - 8*c)) & 0x7) ^ 4) - 4;
+        }
+        // Red or green out of range are the T and H blocks
+        if (c2[0] < 0 || c2[0] > 31 || c2[1] < 0 || c2[1] > 31)
+            return false;
+        if (c2[2] < 0 || c2[2] > 31)
+        {
+            ETCPlanar planar;
+            planar.o[0] = (bits >> 57) & 0x3f;
+            planar.o[1] = (int)(((bits >> 56) & 0x1) << 6 | ((bits >> 49) & 0x3f));
+            planar.o[2] = (int)(((bits >> 48) & 0x1) << 5 | ((bits >> 43) & 0x3) << 3 | ((bits >> 39) & 0x7));
+            planar.h[0] = (int)(((bits >> 34) & 0x1f) << 1 | ((bits >> 32) & 0x1));
+            planar.h[1] = (bits >> 25) & 0x7f;
+            planar.h[2] = (bits >> 19) & 0x3f;
+            planar.v[0] = (bits >> 13) & 0x3f;
+            planar.v[1] = (bits >> 6) & 0x7f;
+            planar.v[2] = bits & 0x3f;
+            for (int y=0;y<4;y++)
+                for (int x=0;x<4;x++)
+                    for (int c=0;c<3;c++)
+                        rgba[(y*4+x)*4+c] = ETCPlanarValue(ETCPlanarExpand(planar.o[c],c), ETCPlanarExpand(planar.h[c],c),
+                                                           ETCPlanarExpand(planar.v[c],c), x, y);
+            return true;
+        }
+        for (int c=0;c<3;c++)
+        {
+            base[0][c] = ETCExpand5(c1[c]);
+            base[1][c] = ETCExpand5(c2[c]);
+        }
+    } else {
+        for (int c=0;c<3;c++)
+        {
+            base[0][c] = ETCExpand4((bits >> (60 - 8*c)) & 0xf);
+            base[1][c] = ETCExpand4((bits >> (56 - 8*c)) & 0xf);
+        }
+    }
+
+    const int tables[2] = {(int)((bits >> 37) & 0x7), (int)((bits >> 34) & 0x7)};
+    for (int y=0;y<4;y++)
+        for (int x=0;x<4;x++)
+        {
+            const int which = flip ? (y >= 2) : (x >= 2);
+            const int pos = x*4+y;
+            const int k = (int)(((bits >> (pos + 16)) & 1) << 1 | ((bits >> pos) & 1));
+            int colors[4][3];
+            ETCTableColors(base[which], tables[which], colors);
+            for (int c=0;c<3;c++)
+                rgba[(y*4+x)*4+c] = colors[k][c];
+        }
+
+    return true;
+}
+
+void ETC2DecodeAlphaBlock(const unsigned char *in,unsigned char *rgba)
+{
+    const uint64_t bits = ETCReadBits(in);
+    const int base = (bits >> 56) & 0xff;
+    const int mult = (bits >> 52) & 0xf;
+    const int table = (bits >> 48) & 0xf;
+    for (int y=0;y<4;y++)
+        for (int x=0;x<4;x++)
+        {
+            const int k = (bits >> (45 - 3*(x*4+y))) & 0x7;
+            rgba[(y*4+x)*4+3] = ETCClamp(base + EACModifiers[table][k] * mult);
+        }
+}
+
+bool ETC2IsOpaque(const unsigned char *rgba,int width,int height)
+{
+    const size_t numPixels = (size_t)width*height;
+    for (size_t ii=0;ii<numPixels;ii++)
+        if (rgba[ii*4+3] != 255)
+            return false;
+    return true;
+}
+
+// PKM header values we write
+static const int PKMTypeRGB = 1;
+static const int PKMTypeRGBA = 3;
+static const int PKMHeaderSize = 16;
+
+RawDataRef ETC2EncodePKM(const unsigned char *rgba,int width,int height,bool withAlpha,ETC2Quality quality,int numThreads)
+{
+    if (width <= 0 || height <= 0 || width > 0xffff || height > 0xffff)
+        return RawDataRef();
+
+    const int blocksWide = (width+3)/4, blocksHigh = (height+3)/4;
+    const int blockSize = withAlpha ? 16 : 8;
+    const size_t len = PKMHeaderSize + (size_t)blocksWide*blocksHigh*blockSize;
+    unsigned char *data = (unsigned char *)malloc(len);
+    if (!data)
+        return RawDataRef();
+
+    // Sizes are big endian, padded out to the blocks and then the original
+    const int extWidth = blocksWide*4, extHeight = blocksHigh*4;
+    const int type = withAlpha ? PKMTypeRGBA : PKMTypeRGB;
+    const unsigned char header[PKMHeaderSize] = {'P','K','M',' ','2','0',
+        (unsigned char)(type >> 8), (unsigned char)type,
+        (unsigned char)(extWidth >> 8), (unsigned char)extWidth, (unsigned char)(extHeight >> 8), (unsigned char)extHeight,
+        (unsigned char)(width >> 8), (unsigned char)width, (unsigned char)(height >> 8), (unsigned char)height};
+    memcpy(data, header, PKMHeaderSize);
+
+    auto encodeRows = [&](int startRow,int endRow)
+    {
+        unsigned char block[64];
+        for (int by=startRow;by<endRow;by++)
+            for (int bx=0;bx<blocksWide;bx++)
+            {
+                // Repeat the edges for partial blocks
+                for (int y=0;y<4;y++)
+                {
+                    const int sy = std::min(by*4+y,height-1);
+                    for (int x=0;x<4;x++)
+                    {
+                        const int sx = std::min(bx*4+x,width-1);
+                        memcpy(&block[(y*4+x)*4], &rgba[((size_t)sy*width+sx)*4], 4);
+                    }
+                }
+                unsigned char *out = data + PKMHeaderSize + ((size_t)by*blocksWide+bx)*blockSize;
+                if (withAlpha)
+                {
+                    ETC2EncodeAlphaBlock(block, out, quality);
+                    out += 8;
+                }
+                ETC2EncodeRGBBlock(block, out, quality);
+            }
+    };
+
+    // Bands of block rows, one per thread
+    numThreads = std::max(1,std::min(numThreads,blocksHigh));
+    const int band = (blocksHigh + numThreads - 1) / numThreads;
+    std::vector<std::thread> threads;
+    for (int startRow = band;startRow < blocksHigh;startRow += band)
+        threads.emplace_back(encodeRows,startRow,std::min(startRow+band,blocksHigh));
+    encodeRows(0,std::min(band,blocksHigh));
+    for (auto &thread : threads)
+        thread.join();
+
+    return RawDataRef(new RawDataWrapper(data,len,true));
+}
+
+bool ETC2DecodePKM(RawDataRef pkmData,std::vector<unsigned char> &rgba,int &width,int &height)
+{
+    if (!pkmData || pkmData->getLen() < PKMHeaderSize)
+        return false;
+    const unsigned char *header = pkmData->getRawData();
+    if (strncmp((const char *)header, "PKM ", 4))
+        return false;
+    const int type = (header[6] << 8) | header[7];
+    if (type != PKMTypeRGB && type != PKMTypeRGBA)
+        return false;
+    const bool withAlpha = type == PKMTypeRGBA;
+    const int extWidth = (header[8] << 8) | header[9], extHeight = (header[10] << 8) | header[11];
+    width = (header[12] << 8) | header[13];
+    height = (header[14] << 8) | header[15];
+    const int blocksWide = extWidth/4, blocksHigh = extHeight/4;
+    const int blockSize = withAlpha ? 16 : 8;
+    if (width > extWidth || height > extHeight ||
+        pkmData->getLen() < PKMHeaderSize + (size_t)blocksWide*blocksHigh*blockSize)
+        return false;
+
+    rgba.resize((size_t)width*height*4);
+    unsigned char block[64];
+    for (int by=0;by<blocksHigh;by++)
+        for (int bx=0;bx<blocksWide;bx++)
+        {
+            const unsigned char *in = header + PKMHeaderSize + ((size_t)by*blocksWide+bx)*blockSize;
+            memset(block, 255, sizeof(block));
+            if (withAlpha)
+            {
+                ETC2DecodeAlphaBlock(in, block);
+                in += 8;
+            }
+            if (!ETC2DecodeRGBBlock(in, block))
+                return false;
+            for (int y=0;y<4 && by*4+y < height;y++)
+                for (int x=0;x<4 && bx*4+x < width;x++)
+                    memcpy(&rgba[((size_t)(by*4+y)*width+bx*4+x)*4], &block[(y*4+x)*4], 4);
+        }
+
+    return true;
+}
+
+}
@@ -20,6 +20,8 @@
 
 #import "FontTextureManager.h"
 #import "WhirlyVector.h"
+#import "Scene.h"
+#import "WhirlyKitLog.h"
 
 using namespace Eigen;
 using namespace WhirlyKit;
@@ -119,12 +121,15 @@ void FontManager::removeGlyphRefs(const GlyphSet &usedGlyphs,std::vector<SubText
 
                 
 FontTextureManager::FontTextureManager(SceneRenderer *sceneRender,Scene *scene)
-: sceneRender(sceneRender), scene(scene), texAtlas(NULL)
+: sceneRender(sceneRender), scene(scene), texAtlas(NULL), maxGlyphRuns(2048),
+  sdfMode(false), sdfRefSize(32.0), sdfSpread(8)
 {
 }
 
 FontTextureManager::~FontTextureManager()
 {
+    if (!sdfCacheFile.empty() && sdfCache.isDirty())
+        sdfCache.writeToFile(sdfCacheFile);
     if (texAtlas)
         delete texAtlas;
     texAtlas = NULL;
@@ -150,6 +155,9 @@ void FontTextureManager::clear(ChangeSet &changes)
 {
     std::lock_guard<std::mutex> guardLock(lock);
     
+    if (!sdfCacheFile.empty() && sdfCache.isDirty())
+        sdfCache.writeToFile(sdfCacheFile);
+
     if (texAtlas)
     {
         texAtlas->teardown(changes);
@@ -159,9 +167,35 @@ void FontTextureManager::clear(ChangeSet &changes)
     for (DrawStringRepSet::iterator it = drawStringReps.begin();
          it != drawStringReps.end(); ++it)
         delete *it;
+    drawStringReps.clear();
+    glyphRunMap.clear();
+    glyphRuns.clear();
     fontManagers.clear();
 }
 
+void FontTextureManager::releaseGlyphs(SimpleIdentity fontID,const GlyphSet &glyphs,ChangeSet &changes,TimeInterval when)
+{
+    auto fmIt = fontManagers.find(fontID);
+    if (fmIt == fontManagers.end())
+        return;
+
+    // Decrement the glyph references
+    FontManagerRef fm = fmIt->second;
+    std::vector<SubTexture> texRemove;
+    fm->removeGlyphRefs(glyphs,texRemove);
+
+    // And possibly remove some sub textures
+    if (!texRemove.empty())
+        for (unsigned int ii=0;ii<texRemove.size();ii++)
+            texAtlas->removeTexture(texRemove[ii], changes, when);
+
+    // Also see if we're done with the font
+    if (fm->refCount <= 0)
+    {
+        fontManagers.erase(fmIt);
+    }
+}
+
 void FontTextureManager::removeString(SimpleIdentity drawStringId,ChangeSet &changes,TimeInterval when)
 {
     std::lock_guard<std::mutex> guardLock(lock);
@@ -179,29 +213,177 @@ void FontTextureManager::removeString(SimpleIdentity drawStringId,ChangeSet &cha
     // Work through the fonts we're using
     for (SimpleIDGlyphMap::iterator fit = theRep->fontGlyphs.begin();
          fit != theRep->fontGlyphs.end(); ++fit)
-    {
-        auto fmIt = fontManagers.find(fit->first);
-        if (fmIt != fontManagers.end())
-        {
-            // Decrement the glyph references
-            FontManagerRef fm = fmIt->second;
-            std::vector<SubTexture> texRemove;
-            fm->removeGlyphRefs(fit->second,texRemove);
-
-            // And possibly remove some sub textures
-            if (!texRemove.empty())
-                for (unsigned int ii=0;ii<texRemove.size();ii++)
-                    texAtlas->removeTexture(texRemove[ii], changes, when);
-
-            // Also see if we're done with the font
-            if (fm->refCount <= 0)
-            {
-                fontManagers.erase(fmIt);
-            }
-        }
-    }
+        releaseGlyphs(fit->first, fit->second, changes, when);
     
     delete theRep;
 }
 
+size_t FontTextureManager::GlyphRunKeyHash::operator () (const GlyphRunKey &key) const
+{
+    // FNV-1a over the font and code points
+    uint64_t hash = 14695981039346656037ULL ^ key.fontID;
+    for (WKGlyph glyph : *key.codePoints)
+    {
+        hash ^= glyph;
+        hash *= 1099511628211ULL;
+    }
+    return (size_t)hash;
+}
+
+void FontTextureManager::setGlyphRunCacheSize(int numRuns)
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+
+    maxGlyphRuns = std::max(numRuns,0);
+
+    // The glyphs may still be in use, so we can only clean up if there are no references left
+    ChangeSet changes;
+    while ((int)glyphRuns.size() > maxGlyphRuns)
+    {
+        GlyphRun &run = glyphRuns.back();
+        glyphRunMap.erase(GlyphRunKey(run.fontID,&run.codePoints));
+        releaseGlyphs(run.fontID, run.glyphs, changes, 0.0);
+        glyphRuns.pop_back();
+    }
+    if (!changes.empty() && scene)
+        scene->addChangeRequests(changes);
+}
+
+DrawableString *FontTextureManager::findGlyphRun(FontManagerRef fm,const std::vector<WKGlyph> &codePoints)
+{
+    auto it = glyphRunMap.find(GlyphRunKey(fm->getId(),&codePoints));
+    if (it == glyphRunMap.end())
+        return NULL;
+
+    // Most recently used goes to the front
+    glyphRuns.splice(glyphRuns.begin(), glyphRuns, it->second);
+    const GlyphRun &run = *it->second;
+
+    DrawableString *drawString = new DrawableString();
+    drawString->glyphPolys = run.glyphPolys;
+    drawString->mbr = run.mbr;
+
+    // This string holds its own references, the same as a new one
+    DrawStringRep *drawStringRep = new DrawStringRep(drawString->getId());
+    drawStringRep->addGlyphs(fm->getId(),run.glyphs);
+    fm->addGlyphRefs(run.glyphs);
+    drawStringReps.insert(drawStringRep);
+
+    return drawString;
+}
+
+void FontTextureManager::addGlyphRun(FontManagerRef fm,const std::vector<WKGlyph> &codePoints,const DrawableString *drawString,const GlyphSet &glyphs,ChangeSet &changes)
+{
+    if (maxGlyphRuns <= 0 || !drawString)
+        return;
+    if (glyphRunMap.find(GlyphRunKey(fm->getId(),&codePoints)) != glyphRunMap.end())
+        return;
+
+    glyphRuns.push_front(GlyphRun());
+    GlyphRun &run = glyphRuns.front();
+    run.fontID = fm->getId();
+    run.codePoints = codePoints;
+    run.glyphPolys = drawString->glyphPolys;
+    run.mbr = drawString->mbr;
+    run.glyphs = glyphs;
+    fm->addGlyphRefs(glyphs);
+    glyphRunMap[GlyphRunKey(run.fontID,&run.codePoints)] = glyphRuns.begin();
+
+    // Push out the least recently used
+    while ((int)glyphRuns.size() > maxGlyphRuns)
+    {
+        GlyphRun &oldRun = glyphRuns.back();
+        glyphRunMap.erase(GlyphRunKey(oldRun.fontID,&oldRun.codePoints));
+        releaseGlyphs(oldRun.fontID, oldRun.glyphs, changes, 0.0);
+        glyphRuns.pop_back();
+    }
+}
+
+void FontTextureManager::setSDFMode(bool enable,float refSize,int spread)
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+
+    if (!fontManagers.empty())
+    {
+        wkLogLevel(Warn,"FontTextureManager: Distance field mode must be set before adding strings.");
+        return;
+    }
+
+    sdfMode = enable;
+    sdfRefSize = refSize;
+    sdfSpread = std::max(spread,1);
+    sdfCache.setParams(sdfRefSize, sdfSpread);
+    if (sdfMode && !sdfCacheFile.empty())
+        sdfCache.readFromFile(sdfCacheFile);
+}
+
+void FontTextureManager::setSDFCacheFile(const std::string &fileName)
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+
+    sdfCacheFile = fileName;
+    sdfCache.setParams(sdfRefSize, sdfSpread);
+    if (sdfMode && !sdfCacheFile.empty())
+        sdfCache.readFromFile(sdfCacheFile);
+}
+
+bool FontTextureManager::saveSDFCache()
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+
+    if (sdfCacheFile.empty())
+        return false;
+    if (!sdfCache.isDirty())
+        return true;
+
+    return sdfCache.writeToFile(sdfCacheFile);
+}
+
+FontManager::GlyphInfo *FontTextureManager::addCachedSDFGlyph(FontManagerRef fm,const std::string &fontKey,WKGlyph glyph,ChangeSet &changes)
+{
+    const SDFGlyph *sdfGlyph = sdfCache.findGlyph(fontKey, glyph);
+    if (!sdfGlyph)
+        return NULL;
+
+    // The atlas is RGBA, so the field goes in alpha
+    const int numPixels = sdfGlyph->width * sdfGlyph->height;
+    std::vector<unsigned char> pixels(numPixels*4,255);
+    for (int ii=0;ii<numPixels;ii++)
+        pixels[4*ii+3] = sdfGlyph->field[ii];
+    Texture *tex = makeGlyphTexture(new MutableRawData(pixels.data(),(unsigned int)pixels.size()), sdfGlyph->width, sdfGlyph->height);
+    if (!tex)
+        return NULL;
+
+    FontManager::GlyphInfo *glyphInfo = NULL;
+    SubTexture subTex;
+    Point2f realSize(sdfGlyph->size.x()+2*sdfGlyph->textureOffset.x(),sdfGlyph->size.y()+2*sdfGlyph->textureOffset.y());
+    std::vector<Texture *> texs;
+    texs.push_back(tex);
+    if (texAtlas->addTexture(sceneRender, texs, -1, &realSize, NULL, subTex, changes, 0, 0, NULL))
+        glyphInfo = fm->addGlyph(glyph, subTex, sdfGlyph->size, sdfGlyph->offset, sdfGlyph->textureOffset);
+    delete tex;
+
+    return glyphInfo;
+}
+
+FontManager::GlyphInfo *FontTextureManager::addSDFGlyph(FontManagerRef fm,const std::string &fontKey,WKGlyph glyph,const SDFGlyph &sdfGlyph,ChangeSet &changes)
+{
+    sdfCache.addGlyph(fontKey, glyph, sdfGlyph);
+
+    return addCachedSDFGlyph(fm, fontKey, glyph, changes);
+}
+
+void FontTextureManager::scaleSDFString(DrawableString *drawString,float fontSize)
+{
+    const float scale = fontSize / sdfRefSize;
+    for (DrawableString::Rect &rect : drawString->glyphPolys)
+    {
+        rect.pts[0] *= scale;
+        rect.pts[1] *= scale;
+    }
+    drawString->mbr.ll() *= scale;
+    drawString->mbr.ur() *= scale;
+    drawString->sdfRange = 1.0 / (2.0 * sdfSpread * scale);
+}
+
 }
@@ -0,0 +1,346 @@
+/*
+ *  FrameTrace.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <stdio.h>
+#import <chrono>
+#import <mutex>
+#import <vector>
+#import "FrameTrace.h"
+
+namespace WhirlyKit
+{
+
+static const int MaxTraceZones = 256;
+static const int MaxTraceCounters = 64;
+
+// A single begin, end, or counter value
+class TraceEvent
+{
+public:
+    int64_t time;
+    int64_t value;
+    int32_t which;
+    int32_t type;
+};
+
+// Events for a single thread.  Only the owning thread writes to it.
+class TraceThreadBuffer
+{
+public:
+    TraceThreadBuffer(int size) : events(size), mask(size-1), head(0), start(0), tid(0), inUse(true) { }
+
+    std::vector<TraceEvent> events;
+    uint64_t mask;
+    // Total number of events ever written and where the current recording starts
+    std::atomic<uint64_t> head,start;
+    int tid;
+    std::string name;
+    std::atomic<bool> inUse;
+};
+
+// Shared state.  The lock covers registration and buffer setup, not recording.
+class TraceRegistry
+{
+public:
+    TraceRegistry()
+    : bufferSize(1<<14), nextTid(1), epoch(0)
+    {
+        zoneNames = {"Render Frame","Render Setup","Scene Preprocessing","Active Model Runs",
+                     "Scene Changes","Calculation Shaders","Draw Execution","Present Renderbuffer",
+                     "Loader Build","Loader Merge","Layer Flush","Tile Parse","Texture Prepare"};
+        counterNames = {"Change Queue","Drawables Drawn","Tiles Loading"};
+        for (int ii=0;ii<MaxTraceCounters;ii++)
+            counterTotals[ii] = 0;
+    }
+
+    std::mutex lock;
+    std::vector<std::string> zoneNames,counterNames;
+    std::vector<TraceThreadBuffer *> buffers;
+    int bufferSize;
+    int nextTid;
+    std::atomic<int64_t> epoch;
+    std::atomic<int64_t> counterTotals[MaxTraceCounters];
+};
+
+// Never torn down, since threads may still be recording on the way out
+static TraceRegistry &GetTraceRegistry()
+{
+    static TraceRegistry *registry = new TraceRegistry();
+    return *registry;
+}
+
+// Hands the buffer back when the thread goes away so the next thread can use it
+class TraceThreadHolder
+{
+public:
+    TraceThreadHolder() : buffer(NULL) { }
+    ~TraceThreadHolder()
+    {
+        if (buffer)
+            buffer->inUse.store(false);
+    }
+
+    TraceThreadBuffer *buffer;
+    // Set before we have a buffer
+    std::string name;
+};
+
+static thread_local TraceThreadHolder traceThread;
+
+static inline int64_t TraceNow()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Set up a buffer for the calling thread, reusing one from a thread that's gone if we can
+static TraceThreadBuffer *AcquireTraceBuffer()
+{
+    TraceRegistry &reg = GetTraceRegistry();
+    std::lock_guard<std::mutex> guardLock(reg.lock);
+
+    TraceThreadBuffer *buf = NULL;
+    for (auto oldBuf : reg.buffers)
+    {
+        bool expected = false;
+        if (oldBuf->inUse.compare_exchange_strong(expected, true))
+        {
+            buf = oldBuf;
+            // Events from the old thread aren't ours
+            buf->start.store(buf->head.load());
+            break;
+        }
+    }
+    if (!buf)
+    {
+        buf = new TraceThreadBuffer(reg.bufferSize);
+        reg.buffers.push_back(buf);
+    }
+    buf->tid = reg.nextTid++;
+    buf->name = traceThread.name.empty() ? "Thread " + std::to_string(buf->tid) : traceThread.name;
+
+    traceThread.buffer = buf;
+    return buf;
+}
+
+std::atomic<bool> FrameTrace::enabled(false);
+
+void FrameTrace::setEnabled(bool enable)
+{
+    if (enable && !isEnabled())
+    {
+        clear();
+        GetTraceRegistry().epoch.store(TraceNow());
+    }
+    enabled.store(enable);
+}
+
+void FrameTrace::setBufferSize(int numEvents)
+{
+    int size = 1;
+    while (size < numEvents)
+        size <<= 1;
+
+    TraceRegistry &reg = GetTraceRegistry();
+    std::lock_guard<std::mutex> guardLock(reg.lock);
+    reg.bufferSize = size;
+}
+
+int FrameTrace::registerZone(const std::string &name)
+{
+    TraceRegistry &reg = GetTraceRegistry();
+    std::lock_guard<std::mutex> guardLock(reg.lock);
+    if (reg.zoneNames.size() >= MaxTraceZones)
+        return -1;
+    reg.zoneNames.push_back(name);
+    return (int)reg.zoneNames.size()-1;
+}
+
+int FrameTrace::registerCounter(const std::string &name)
+{
+    TraceRegistry &reg = GetTraceRegistry();
+    std::lock_guard<std::mutex> guardLock(reg.lock);
+    if (reg.counterNames.size() >= MaxTraceCounters)
+        return -1;
+    reg.counterNames.push_back(name);
+    return (int)reg.counterNames.size()-1;
+}
+
+void FrameTrace::setThreadName(const std::string &name)
+{
+    // Threads don't get a buffer until they record something
+    traceThread.name = name;
+    TraceThreadBuffer *buf = traceThread.buffer;
+    if (!buf)
+        return;
+
+    TraceRegistry &reg = GetTraceRegistry();
+    std::lock_guard<std::mutex> guardLock(reg.lock);
+    buf->name = name;
+}
+
+void FrameTrace::record(int which,EventType type,int64_t value)
+{
+    TraceThreadBuffer *buf = traceThread.buffer;
+    if (!buf)
+        buf = AcquireTraceBuffer();
+
+    // Only this thread writes, so we just need to publish the new head
+    const uint64_t head = buf->head.load(std::memory_order_relaxed);
+    TraceEvent &ev = buf->events[head & buf->mask];
+    ev.time = TraceNow();
+    ev.value = value;
+    ev.which = which;
+    ev.type = type;
+    buf->head.store(head+1, std::memory_order_release);
+}
+
+void FrameTrace::addCount(int counter,int64_t delta)
+{
+    if (counter < 0 || counter >= MaxTraceCounters)
+        return;
+
+    const int64_t total = GetTraceRegistry().counterTotals[counter].fetch_add(delta) + delta;
+    setCount(counter, total);
+}
+
+void FrameTrace::clear()
+{
+    TraceRegistry &reg = GetTraceRegistry();
+    std::lock_guard<std::mutex> guardLock(reg.lock);
+    for (auto buf : reg.buffers)
+        buf->start.store(buf->head.load());
+}
+
+// Names only come from us, but they might have quotes in them
+static void AppendTraceString(std::string &str,const std::string &what)
+{
+    str += '"';
+    for (char c : what)
+    {
+        if (c == '"' || c == '\\')
+            str += '\\';
+        if ((unsigned char)c >= 0x20)
+            str += c;
+    }
+    str += '"';
+}
+
+static void AppendTraceTime(std::string &str,int64_t nanos)
+{
+    // Chrome wants microseconds
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.3f", nanos / 1000.0);
+    str += buf;
+}
+
+std::string FrameTrace::chromeTraceJSON()
+{
+    TraceRegistry &reg = GetTraceRegistry();
+    std::lock_guard<std::mutex> guardLock(reg.lock);
+    const int64_t epoch = reg.epoch.load();
+
+    std::string str = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    std::vector<TraceEvent> events;
+    std::vector<const TraceEvent *> openZones;
+
+    for (auto buf : reg.buffers)
+    {
+        // Copy out what's there, then throw away anything the thread may have
+        //  written over while we were copying
+        const uint64_t size = buf->events.size();
+        uint64_t head = buf->head.load(std::memory_order_acquire);
+        uint64_t start = std::max(buf->start.load(),head > size ? head - size : 0);
+        events.resize(head-start);
+        for (uint64_t ii=start;ii<head;ii++)
+            events[ii-start] = buf->events[ii & buf->mask];
+        const uint64_t newHead = buf->head.load(std::memory_order_acquire);
+        if (newHead > size && newHead - size > start)
+        {
+            const uint64_t lost = std::min(newHead - size - start,(uint64_t)events.size());
+            events.erase(events.begin(),events.begin()+lost);
+        }
+
+        const std::string tid = std::to_string(buf->tid);
+        if (!first)
+            str += ",";
+        first = false;
+        str += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":";
+        AppendTraceString(str, buf->name);
+        str += "}}";
+
+        // Begin and end are matched up into complete events.
+        // Anything cut off by the start of the buffer or still open is skipped.
+        openZones.clear();
+        for (const TraceEvent &ev : events)
+        {
+            switch (ev.type)
+            {
+                case EventBegin:
+                    openZones.push_back(&ev);
+                    break;
+                case EventEnd:
+                {
+                    int which = (int)openZones.size()-1;
+                    while (which >= 0 && openZones[which]->which != ev.which)
+                        which--;
+                    if (which < 0)
+                        break;
+                    const TraceEvent *beginEv = openZones[which];
+                    openZones.resize(which);
+
+                    str += ",{\"ph\":\"X\",\"pid\":1,\"tid\":" + tid + ",\"name\":";
+                    AppendTraceString(str, beginEv->which < (int)reg.zoneNames.size() ? reg.zoneNames[beginEv->which] : "Zone " + std::to_string(beginEv->which));
+                    str += ",\"ts\":";
+                    AppendTraceTime(str, beginEv->time - epoch);
+                    str += ",\"dur\":";
+                    AppendTraceTime(str, ev.time - beginEv->time);
+                    str += "}";
+                }
+                    break;
+                case EventCounter:
+                    str += ",{\"ph\":\"C\",\"pid\":1,\"tid\":" + tid + ",\"name\":";
+                    AppendTraceString(str, ev.which < (int)reg.counterNames.size() ? reg.counterNames[ev.which] : "Counter " + std::to_string(ev.which));
+                    str += ",\"ts\":";
+                    AppendTraceTime(str, ev.time - epoch);
+                    str += ",\"args\":{\"value\":" + std::to_string(ev.value) + "}}";
+                    break;
+            }
+        }
+    }
+    str += "]}";
+
+    return str;
+}
+
+bool FrameTrace::writeChromeTrace(const std::string &fileName)
+{
+    const std::string json = chromeTraceJSON();
+
+    FILE *fp = fopen(fileName.c_str(), "w");
+    if (!fp)
+        return false;
+    const bool ret = fwrite(json.c_str(), 1, json.size(), fp) == json.size();
+    fclose(fp);
+
+    return ret;
+}
+
+}
@@ -0,0 +1,850 @@
+/*
+ *  GeoJSONStreamParser.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <stdlib.h>
+#import <fcntl.h>
+#import <unistd.h>
+#import <sys/mman.h>
+#import <sys/stat.h>
+#import "GeoJSONStreamParser.h"
+#import "WhirlyKitLog.h"
+
+namespace WhirlyKit
+{
+
+// Deepest we'll go in nested coordinates or geometry collections
+static const int MaxGeoJSONDepth = 32;
+
+// Powers of ten we can represent exactly
+static const double ExactPowersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* Walks through JSON text in place.
+   Values we don't care about are skipped without being parsed.
+ */
+class GeoJSONStreamParser::Scanner
+{
+public:
+    Scanner(const char *pos,const char *end) : pos(pos), end(end) { }
+
+    void skipWS()
+    {
+        while (pos < end && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t'))
+            pos++;
+    }
+
+    char peek()
+    {
+        skipWS();
+        return pos < end ? *pos : 0;
+    }
+
+    bool expect(char c)
+    {
+        if (peek() != c)
+            return false;
+        pos++;
+        return true;
+    }
+
+    static bool isNumberStart(char c)
+    {
+        return c == '-' || (c >= '0' && c <= '9');
+    }
+
+    // Run through the members of an object, calling func with the scanner sitting on each value
+    template<typename F> bool forEachMember(F func)
+    {
+        if (!expect('{'))
+            return false;
+        if (peek() == '}')
+        {
+            pos++;
+            return true;
+        }
+        std::string key;
+        while (true)
+        {
+            if (!parseString(key) || !expect(':'))
+                return false;
+            skipWS();
+            if (!func(key))
+                return false;
+            const char c = peek();
+            pos++;
+            if (c == '}')
+                return true;
+            if (c != ',')
+                return false;
+        }
+    }
+
+    // Run through the elements of an array, calling func with the scanner sitting on each one
+    template<typename F> bool forEachElement(F func)
+    {
+        if (!expect('['))
+            return false;
+        if (peek() == ']')
+        {
+            pos++;
+            return true;
+        }
+        while (true)
+        {
+            skipWS();
+            if (!func())
+                return false;
+            const char c = peek();
+            pos++;
+            if (c == ']')
+                return true;
+            if (c != ',')
+                return false;
+        }
+    }
+
+    bool parseString(std::string &str)
+    {
+        if (!expect('"'))
+            return false;
+
+        // Most strings have no escapes and can be copied in one go
+        const char *start = pos;
+        while (pos < end && *pos != '"' && *pos != '\\')
+            pos++;
+        str.assign(start,pos);
+        if (pos >= end)
+            return false;
+        if (*pos == '"')
+        {
+            pos++;
+            return true;
+        }
+
+        while (pos < end)
+        {
+            const char c = *pos++;
+            if (c == '"')
+                return true;
+            if (c != '\\')
+            {
+                str.push_back(c);
+                continue;
+            }
+            if (pos >= end)
+                return false;
+            switch (*pos++)
+            {
+                case '"':  str.push_back('"');  break;
+                case '\\':  str.push_back('\\');  break;
+                case '/':  str.push_back('/');  break;
+                case 'b':  str.push_back('\b');  break;
+                case 'f':  str.push_back('\f');  break;
+                case 'n':  str.push_back('\n');  break;
+                case 'r':  str.push_back('\r');  break;
+                case 't':  str.push_back('\t');  break;
+                case 'u':
+                {
+                    unsigned int code;
+                    if (!parseHex4(code))
+                        return false;
+                    // Surrogate pair
+                    if (code >= 0xD800 && code <= 0xDBFF && end - pos >= 6 && pos[0] == '\\' && pos[1] == 'u')
+                    {
+                        pos += 2;
+                        unsigned int low;
+                        if (!parseHex4(low))
+                            return false;
+                        if (low >= 0xDC00 && low <= 0xDFFF)
+                            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUTF8(str,code);
+                }
+                    break;
+                default:
+                    return false;
+            }
+        }
+
+        return false;
+    }
+
+    bool skipString()
+    {
+        if (!expect('"'))
+            return false;
+        while (pos < end)
+        {
+            const char c = *pos++;
+            if (c == '"')
+                return true;
+            if (c == '\\')
+                pos++;
+        }
+        return false;
+    }
+
+    // Parse a number in place.  Short ones are converted directly, the rest go through strtod.
+    bool parseNumber(double &val)
+    {
+        skipWS();
+        const char *start = pos;
+        bool neg = false;
+        if (pos < end && *pos == '-')
+        {
+            neg = true;
+            pos++;
+        }
+        if (pos >= end || *pos < '0' || *pos > '9')
+            return false;
+
+        uint64_t mant = 0;
+        int sigDigits = 0, exp10 = 0;
+        bool overflow = false, inFraction = false;
+        for (;pos < end;pos++)
+        {
+            const char c = *pos;
+            if (c == '.' && !inFraction)
+            {
+                inFraction = true;
+                continue;
+            }
+            if (c < '0' || c > '9')
+                break;
+            const int digit = c - '0';
+            if (mant == 0 && digit == 0)
+            {
+                if (inFraction)
+                    exp10--;
+                continue;
+            }
+            if (sigDigits < 19)
+            {
+                mant = mant * 10 + digit;
+                sigDigits++;
+                if (inFraction)
+                    exp10--;
+            } else {
+                overflow = true;
+                if (!inFraction)
+                    exp10++;
+            }
+        }
+        if (pos < end && (*pos == 'e' || *pos == 'E'))
+        {
+            pos++;
+            bool expNeg = false;
+            if (pos < end && (*pos == '+' || *pos == '-'))
+                expNeg = *pos++ == '-';
+            if (pos >= end || *pos < '0' || *pos > '9')
+                return false;
+            int expVal = 0;
+            for (;pos < end && *pos >= '0' && *pos <= '9';pos++)
+                if (expVal < 100000)
+                    expVal = expVal * 10 + (*pos - '0');
+            exp10 += expNeg ? -expVal : expVal;
+        }
+
+        // Exact when both the mantissa and the power of ten fit in a double
+        if (!overflow && mant <= (1ULL << 53) && exp10 >= -22 && exp10 <= 22)
+        {
+            val = (double)mant;
+            if (exp10 < 0)
+                val /= ExactPowersOfTen[-exp10];
+            else
+                val *= ExactPowersOfTen[exp10];
+            if (neg)
+                val = -val;
+            return true;
+        }
+
+        char buf[64];
+        const size_t len = pos - start;
+        if (len < sizeof(buf))
+        {
+            memcpy(buf,start,len);
+            buf[len] = 0;
+            val = strtod(buf,NULL);
+        } else
+            val = strtod(std::string(start,len).c_str(),NULL);
+
+        return true;
+    }
+
+    bool parseBool(bool &val)
+    {
+        skipWS();
+        if (end - pos >= 4 && !strncmp(pos,"true",4))
+        {
+            pos += 4;
+            val = true;
+            return true;
+        }
+        if (end - pos >= 5 && !strncmp(pos,"false",5))
+        {
+            pos += 5;
+            val = false;
+            return true;
+        }
+        return false;
+    }
+
+    // Skip over a whole value without looking at it
+    bool skipValue()
+    {
+        const char c = peek();
+        if (c == '"')
+            return skipString();
+        if (c != '{' && c != '[')
+        {
+            const char *start = pos;
+            while (pos < end && *pos != ',' && *pos != '}' && *pos != ']' &&
+                   *pos != ' ' && *pos != '\n' && *pos != '\r' && *pos != '\t')
+                pos++;
+            return pos > start;
+        }
+
+        int depth = 0;
+        while (pos < end)
+        {
+            const char c = *pos;
+            if (c == '"')
+            {
+                if (!skipString())
+                    return false;
+                continue;
+            }
+            if (c == '{' || c == '[')
+                depth++;
+            else if (c == '}' || c == ']')
+            {
+                if (--depth == 0)
+                {
+                    pos++;
+                    return true;
+                }
+            }
+            pos++;
+        }
+
+        return false;
+    }
+
+    const char *pos,*end;
+
+protected:
+    bool parseHex4(unsigned int &code)
+    {
+        if (end - pos < 4)
+            return false;
+        code = 0;
+        for (unsigned int ii=0;ii<4;ii++)
+        {
+            const char c = *pos++;
+            code <<= 4;
+            if (c >= '0' && c <= '9')
+                code |= c - '0';
+            else if (c >= 'a' && c <= 'f')
+                code |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F')
+                code |= c - 'A' + 10;
+            else
+                return false;
+        }
+        return true;
+    }
+
+    static void appendUTF8(std::string &str,unsigned int code)
+    {
+        if (code < 0x80)
+            str.push_back((char)code);
+        else if (code < 0x800)
+        {
+            str.push_back((char)(0xC0 | (code >> 6)));
+            str.push_back((char)(0x80 | (code & 0x3F)));
+        } else if (code < 0x10000)
+        {
+            str.push_back((char)(0xE0 | (code >> 12)));
+            str.push_back((char)(0x80 | ((code >> 6) & 0x3F)));
+            str.push_back((char)(0x80 | (code & 0x3F)));
+        } else {
+            str.push_back((char)(0xF0 | (code >> 18)));
+            str.push_back((char)(0x80 | ((code >> 12) & 0x3F)));
+            str.push_back((char)(0x80 | ((code >> 6) & 0x3F)));
+            str.push_back((char)(0x80 | (code & 0x3F)));
+        }
+    }
+};
+
+GeoJSONStreamParser::GeoJSONStreamParser()
+: useBBox(false), useFilter(false), callback(NULL), stopped(false), numFeatures(0), numFiltered(0)
+{
+}
+
+void GeoJSONStreamParser::setBoundingBox(const GeoMbr &mbr)
+{
+    bbox = mbr;
+    useBBox = true;
+}
+
+void GeoJSONStreamParser::setPropertyFilter(const StringSet &names)
+{
+    filter = names;
+    useFilter = true;
+}
+
+bool GeoJSONStreamParser::parse(const char *data,size_t len,const GeoJSONFeatureCallback &inCallback)
+{
+    callback = &inCallback;
+    stopped = false;
+    crs.clear();
+    numFeatures = 0;
+    numFiltered = 0;
+
+    Scanner scan(data,data+len);
+    bool ret = parseTop(scan);
+    callback = NULL;
+
+    return ret;
+}
+
+bool GeoJSONStreamParser::parse(const std::string &str,const GeoJSONFeatureCallback &inCallback)
+{
+    return parse(str.data(),str.size(),inCallback);
+}
+
+bool GeoJSONStreamParser::parseFile(const std::string &fileName,const GeoJSONFeatureCallback &inCallback)
+{
+    int fd = open(fileName.c_str(),O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat fileStat;
+    if (fstat(fd,&fileStat) != 0 || fileStat.st_size == 0)
+    {
+        close(fd);
+        return false;
+    }
+    size_t len = fileStat.st_size;
+    void *data = mmap(NULL,len,PROT_READ,MAP_PRIVATE,fd,0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        wkLogLevel(Warn,"GeoJSONStreamParser: Failed to map %s",fileName.c_str());
+        return false;
+    }
+    // We go through it front to back
+    madvise(data,len,MADV_SEQUENTIAL);
+
+    bool ret = parse((const char *)data,len,inCallback);
+    munmap(data,len);
+
+    return ret;
+}
+
+// Top level is a feature collection, a single feature or bare geometry
+bool GeoJSONStreamParser::parseTop(Scanner &scan)
+{
+    if (scan.peek() != '{')
+        return false;
+    const char *topStart = scan.pos;
+
+    std::string type;
+    bool haveType = false, featsDone = false;
+    const char *featPos = NULL, *crsPos = NULL;
+    bool ok = scan.forEachMember([&](const std::string &key) -> bool
+    {
+        if (key == "type")
+        {
+            haveType = true;
+            if (scan.peek() == '"')
+                return scan.parseString(type);
+            type.clear();
+            return scan.skipValue();
+        } else if (key == "features")
+        {
+            // Usually we know what we've got by now and can parse in place
+            if (haveType && type == "FeatureCollection")
+            {
+                featsDone = true;
+                return parseFeatures(scan);
+            }
+            featPos = scan.pos;
+            return scan.skipValue();
+        } else if (key == "crs")
+            crsPos = scan.pos;
+
+        return scan.skipValue();
+    });
+    if (stopped)
+        return true;
+    if (!ok || !haveType)
+        return false;
+
+    if (type == "FeatureCollection")
+    {
+        if (!featsDone)
+        {
+            if (!featPos)
+                return false;
+            Scanner featScan(featPos,scan.end);
+            if (!parseFeatures(featScan) && !stopped)
+                return false;
+        }
+    } else if (type == "Feature")
+    {
+        Scanner featScan(topStart,scan.end);
+        if (!parseFeature(featScan) && !stopped)
+            return false;
+    } else {
+        ShapeSet shapes;
+        Scanner geomScan(topStart,scan.end);
+        if (!parseGeometry(geomScan,shapes,0))
+            return false;
+        if (filterShapes(shapes))
+        {
+            numFeatures++;
+            if (!(*callback)(shapes))
+                stopped = true;
+        }
+    }
+
+    if (crsPos)
+    {
+        Scanner crsScan(crsPos,scan.end);
+        parseCRS(crsScan);
+    }
+
+    return true;
+}
+
+// Features in a collection, each one handed off as it's done
+bool GeoJSONStreamParser::parseFeatures(Scanner &scan)
+{
+    if (scan.peek() != '[')
+        return false;
+
+    return scan.forEachElement([&]() -> bool
+    {
+        if (scan.peek() != '{')
+            return false;
+        return parseFeature(scan);
+    });
+}
+
+// Remove the shapes outside our bounding box.  Returns false if there's nothing left.
+bool GeoJSONStreamParser::filterShapes(ShapeSet &shapes)
+{
+    if (useBBox)
+    {
+        for (auto it = shapes.begin(); it != shapes.end();)
+        {
+            if (!(*it)->calcGeoMbr().overlaps(bbox))
+                it = shapes.erase(it);
+            else
+                ++it;
+        }
+    }
+    if (shapes.empty())
+    {
+        numFiltered++;
+        return false;
+    }
+
+    return true;
+}
+
+bool GeoJSONStreamParser::parseFeature(Scanner &scan)
+{
+    // Geometry and properties can come in any order, so note where they are
+    const char *geomPos = NULL, *propPos = NULL;
+    bool ok = scan.forEachMember([&](const std::string &key) -> bool
+    {
+        if (key == "geometry")
+            geomPos = scan.pos;
+        else if (key == "properties")
+            propPos = scan.pos;
+        return scan.skipValue();
+    });
+    if (!ok || !geomPos)
+        return false;
+
+    ShapeSet newShapes;
+    Scanner geomScan(geomPos,scan.end);
+    if (!parseGeometry(geomScan,newShapes,0))
+        return false;
+
+    // Don't bother with the properties if we're not keeping any of it
+    if (!filterShapes(newShapes))
+        return true;
+
+    // Properties are optional
+    if (propPos)
+    {
+        MutableDictionaryRef properties = MutableDictionaryMake();
+        Scanner propScan(propPos,scan.end);
+        if (propScan.peek() == '{' && !parseProperties(propScan,properties))
+            return false;
+        for (auto shape : newShapes)
+            shape->setAttrDict(properties);
+    }
+
+    numFeatures++;
+    if (!(*callback)(newShapes))
+    {
+        stopped = true;
+        return false;
+    }
+
+    return true;
+}
+
+bool GeoJSONStreamParser::parseGeometry(Scanner &scan,ShapeSet &shapes,int depth)
+{
+    if (depth > MaxGeoJSONDepth || scan.peek() != '{')
+        return false;
+
+    std::string type;
+    bool haveType = false;
+    const char *coordPos = NULL, *geomsPos = NULL;
+    bool ok = scan.forEachMember([&](const std::string &key) -> bool
+    {
+        if (key == "type")
+        {
+            haveType = true;
+            if (scan.peek() == '"')
+                return scan.parseString(type);
+            type.clear();
+        } else if (key == "coordinates")
+            coordPos = scan.pos;
+        else if (key == "geometries")
+            geomsPos = scan.pos;
+        return scan.skipValue();
+    });
+    if (!ok || !haveType)
+        return false;
+
+    if (type == "GeometryCollection")
+    {
+        if (!geomsPos)
+            return false;
+        Scanner geomsScan(geomsPos,scan.end);
+        if (geomsScan.peek() != '[')
+            return false;
+        return geomsScan.forEachElement([&]() -> bool
+        {
+            return parseGeometry(geomsScan,shapes,depth+1);
+        });
+    }
+
+    // Everything else needs an array of coordinates
+    if (!coordPos)
+        return false;
+    Scanner coordScan(coordPos,scan.end);
+    if (coordScan.peek() != '[')
+        return false;
+
+    if (type == "Point" || type == "MultiPoint")
+    {
+        VectorPointsRef pts = VectorPoints::createPoints();
+        if (!parseCoordinates(coordScan,pts->pts,0))
+            return false;
+        pts->initGeoMbr();
+        shapes.insert(pts);
+    } else if (type == "LineString")
+    {
+        VectorLinearRef lin = VectorLinear::createLinear();
+        if (!parseCoordinates(coordScan,lin->pts,0))
+            return false;
+        lin->initGeoMbr();
+        shapes.insert(lin);
+    } else if (type == "Polygon")
+    {
+        VectorArealRef ar = VectorAreal::createAreal();
+        if (!parseLoops(coordScan,ar))
+            return false;
+        ar->initGeoMbr();
+        shapes.insert(ar);
+    } else if (type == "MultiLineString")
+    {
+        return coordScan.forEachElement([&]() -> bool
+        {
+            if (coordScan.peek() != '[')
+                return false;
+            VectorLinearRef lin = VectorLinear::createLinear();
+            if (!parseCoordinates(coordScan,lin->pts,0))
+                return false;
+            lin->initGeoMbr();
+            shapes.insert(lin);
+            return true;
+        });
+    } else if (type == "MultiPolygon")
+    {
+        return coordScan.forEachElement([&]() -> bool
+        {
+            VectorArealRef ar = VectorAreal::createAreal();
+            if (coordScan.peek() == '[')
+            {
+                if (!parseLoops(coordScan,ar))
+                    return false;
+            } else if (!coordScan.skipValue())
+                return false;
+            ar->initGeoMbr();
+            shapes.insert(ar);
+            return true;
+        });
+    } else
+        return false;
+
+    return true;
+}
+
+// An array of rings, as for a polygon
+bool GeoJSONStreamParser::parseLoops(Scanner &scan,VectorArealRef ar)
+{
+    return scan.forEachElement([&]() -> bool
+    {
+        if (scan.peek() != '[')
+            return false;
+        ar->loops.resize(ar->loops.size()+1);
+        return parseCoordinates(scan,ar->loops.back(),0);
+    });
+}
+
+// Arrays of numbers are coordinates and we take the first two.
+// Arrays of arrays are flattened into the one list of points.
+bool GeoJSONStreamParser::parseCoordinates(Scanner &scan,VectorRing &pts,int depth)
+{
+    if (depth > MaxGeoJSONDepth)
+        return false;
+
+    int numVals = 0;
+    float lon = 0.0;
+    bool ok = scan.forEachElement([&]() -> bool
+    {
+        const char c = scan.peek();
+        if (c == '[')
+            return parseCoordinates(scan,pts,depth+1);
+        if (!Scanner::isNumberStart(c))
+            return false;
+
+        double val;
+        if (!scan.parseNumber(val))
+            return false;
+        if (numVals == 0)
+            lon = val;
+        else if (numVals == 1)
+            pts.push_back(GeoCoord::CoordFromDegrees(lon,(float)val));
+        numVals++;
+        return true;
+    });
+
+    return ok && numVals != 1;
+}
+
+bool GeoJSONStreamParser::parseProperties(Scanner &scan,MutableDictionaryRef dict)
+{
+    std::string strVal;
+    return scan.forEachMember([&](const std::string &key) -> bool
+    {
+        if (key.empty() || (useFilter && filter.find(key) == filter.end()))
+            return scan.skipValue();
+
+        const char c = scan.peek();
+        if (c == '"')
+        {
+            if (!scan.parseString(strVal))
+                return false;
+            dict->setString(key,strVal);
+        } else if (Scanner::isNumberStart(c))
+        {
+            double val;
+            if (!scan.parseNumber(val))
+                return false;
+            dict->setDouble(key,val);
+        } else if (c == 't' || c == 'f')
+        {
+            bool val;
+            if (!scan.parseBool(val))
+                return false;
+            dict->setInt(key,(int)val);
+        } else
+            return scan.skipValue();
+
+        return true;
+    });
+}
+
+// Just the name out of a named CRS
+bool GeoJSONStreamParser::parseCRS(Scanner &scan)
+{
+    if (scan.peek() != '{')
+        return false;
+
+    std::string type;
+    const char *propPos = NULL;
+    bool ok = scan.forEachMember([&](const std::string &key) -> bool
+    {
+        if (key == "type" && scan.peek() == '"')
+            return scan.parseString(type);
+        else if (key == "properties")
+            propPos = scan.pos;
+        return scan.skipValue();
+    });
+    if (!ok || type != "name" || !propPos)
+        return false;
+
+    Scanner propScan(propPos,scan.end);
+    if (propScan.peek() != '{')
+        return false;
+    std::string crsName;
+    bool found = false;
+    propScan.forEachMember([&](const std::string &key) -> bool
+    {
+        if (!found && key == "name" && propScan.peek() == '"')
+        {
+            found = true;
+            return propScan.parseString(crsName);
+        }
+        return propScan.skipValue();
+    });
+    if (!found || crsName.empty())
+        return false;
+    crs = crsName;
+
+    return true;
+}
+
+bool VectorParseGeoJSONStream(ShapeSet &shapes,const std::string &str,std::string &crs)
+{
+    GeoJSONStreamParser parser;
+    bool ret = parser.parse(str,[&shapes](ShapeSet &featShapes) -> bool
+    {
+        shapes.insert(featShapes.begin(),featShapes.end());
+        return true;
+    });
+    if (ret && !parser.getCRS().empty())
+        crs = parser.getCRS();
+
+    return ret;
+}
+
+}
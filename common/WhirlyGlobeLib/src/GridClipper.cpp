@@ -57,15 +57,33 @@ bool ClipLoopToMbr(const VectorRing &ring,const Mbr &mbr, bool closed,std::vecto
 {
     if(!closed)
     {
+        if (ring.size() < 2)
+            return true;
+
+        // Lines that are entirely inside or outside don't need to be looked at
+        const Mbr ringMbr(ring);
+        if (ringMbr.ur().x() < mbr.ll().x() || ringMbr.ur().y() < mbr.ll().y() ||
+            ringMbr.ll().x() > mbr.ur().x() || ringMbr.ll().y() > mbr.ur().y())
+            return true;
+        if (ringMbr.ll().x() >= mbr.ll().x() && ringMbr.ll().y() >= mbr.ll().y() &&
+            ringMbr.ur().x() <= mbr.ur().x() && ringMbr.ur().y() <= mbr.ur().y())
+        {
+            rets.push_back(ring);
+            return true;
+        }
+
         //Cohen-sutherland algorithm based on example implementation from wikipedia
         //https://en.wikipedia.org/wiki/Cohen%E2%80%93Sutherland_algorithm#Example_C.2FC.2B.2B_implementation
-        VectorRing outRing;
+        // Output goes straight into the return vector and the out codes are only worked out once per point
+        VectorRing *outRing = NULL;
+        OutCode nextCode = ComputeOutCode(ring[0].x(), ring[0].y(), mbr);
         for (unsigned int ii=1;ii<ring.size();ii++)
         {
             Point2f p0 = ring[ii - 1];
             Point2f p1 = ring[ii];
-            OutCode outcode0 = ComputeOutCode(p0.x(), p0.y(), mbr);
+            OutCode outcode0 = nextCode;
             OutCode outcode1 = ComputeOutCode(p1.x(), p1.y(), mbr);
+            nextCode = outcode1;
             bool accept = false;
             
             while (true) {
@@ -110,20 +128,17 @@ bool ClipLoopToMbr(const VectorRing &ring,const Mbr &mbr, bool closed,std::vecto
                 }
             }
             if (accept) {
-                if (outRing.size() > 1 && outRing[outRing.size() - 1] != p0)
-                {
-                    rets.push_back(outRing);
-                    outRing = VectorRing();
-                }
-                if(outRing.size() == 0) {
-                    outRing.push_back(p0);
+                // Start a new line if this segment doesn't pick up where the last one left off
+                if (outRing && outRing->back() != p0)
+                    outRing = NULL;
+                if (!outRing) {
+                    rets.resize(rets.size()+1);
+                    outRing = &rets.back();
+                    outRing->push_back(p0);
                 }
-                outRing.push_back(p1);
+                outRing->push_back(p1);
             }
         }
-        
-        if (outRing.size() > 1)
-            rets.push_back(outRing);
     } else
     {
         Path subject(ring.size());
@@ -210,90 +225,192 @@ bool ClipLoopsToMbr(const std::vector<VectorRing> &rings,const Mbr &mbr, bool cl
     return true;
 }
 
-// Clip the given loop to the given grid (org and spacing)
-// Return true on success and the new polygons in the rets
-bool ClipLoopToGrid(const VectorRing &ring,Point2f org,Point2f spacing,std::vector<VectorRing> &rets)
+class GridClipper::ClipState
 {
-    Mbr mbr(ring);
-    int startRet = (int)(rets.size());
-    
-    int ll_ix = (int)std::floor((mbr.ll().x()-org.x())/spacing.x());
-    int ll_iy = (int)std::floor((mbr.ll().y()-org.y())/spacing.y());
-    int ur_ix = (int)std::ceil((mbr.ur().x()-org.x())/spacing.x());
-    int ur_iy = (int)std::ceil((mbr.ur().y()-org.y())/spacing.y());
-    
-    // Clip in strips from left to right
-    for (int ix=ll_ix;ix<=ur_ix;ix++)
-    {
-        Point2f l0(ix*spacing.x()+org.x(),mbr.ll().y());
-        Point2f l1((ix+1)*spacing.x()+org.x(),mbr.ur().y());
-        Mbr left(l0,l1);
-        
-        std::vector<VectorRing> leftStrip;
-        ClipLoopToMbr(ring,left, true, leftStrip);
-        
-        // Now clip the left strip vertically
-        for (int iy=ll_iy;iy<=ur_iy;iy++)
+public:
+    Clipper clipper;
+    // Input loops, converted once
+    Paths subject;
+    // Pieces of the current column
+    Paths strip;
+    // Output for a single cell
+    Paths cell;
+    Path rect;
+};
+
+GridClipper::GridClipper(Point2f org,Point2f spacing)
+    : org(org), spacing(spacing), state(new ClipState())
+{
+    state->rect.resize(4);
+}
+
+GridClipper::~GridClipper()
+{
+    delete state;
+    state = NULL;
+}
+
+// Bounding box of a group of integer paths
+static bool PathsBounds(const Paths &paths,IntPoint &ll,IntPoint &ur)
+{
+    bool valid = false;
+    for (const auto &path : paths)
+        for (const auto &pt : path)
         {
-            
-            Point2f b0(mbr.ll().x(),iy*spacing.y()+org.y());
-            Point2f b1(mbr.ur().x(),(iy+1)*spacing.y()+org.y());
-            Mbr bot(b0,b1);
-            for (unsigned int ic=0;ic<leftStrip.size();ic++)
-                ClipLoopToMbr(leftStrip[ic], bot, true, rets);
+            if (!valid)
+            {
+                ll = ur = pt;
+                valid = true;
+            } else {
+                ll.X = std::min(ll.X,pt.X);  ll.Y = std::min(ll.Y,pt.Y);
+                ur.X = std::max(ur.X,pt.X);  ur.Y = std::max(ur.Y,pt.Y);
+            }
         }
-    }
     
-    for (unsigned int ii=startRet;ii<rets.size();ii++)
+    return valid;
+}
+
+static void SetRect(Path &rect,cInt x0,cInt y0,cInt x1,cInt y1)
+{
+    rect[0] = IntPoint(x0,y0);
+    rect[1] = IntPoint(x1,y0);
+    rect[2] = IntPoint(x1,y1);
+    rect[3] = IntPoint(x0,y1);
+}
+
+bool GridClipper::clipLoop(const VectorRing &ring,std::vector<VectorRing> &rets)
+{
+    Paths &subject = state->subject;
+    subject.resize(1);
+    Path &path = subject[0];
+    path.resize(ring.size());
+    for (unsigned int ii=0;ii<ring.size();ii++)
     {
-        VectorRing &theRing = rets[ii];
-        std::reverse(theRing.begin(),theRing.end());
+        const Point2f &pt = ring[ii];
+        path[ii] = IntPoint(pt.x()*PolyScale,pt.y()*PolyScale);
     }
     
-    return true;
+    return clipPaths(rets);
 }
-    
-bool ClipLoopsToGrid(const std::vector<VectorRing> &rings,Point2f org,Point2f spacing,std::vector<VectorRing> &rets)
+
+bool GridClipper::clipLoops(const std::vector<VectorRing> &rings,std::vector<VectorRing> &rets)
 {
-    Mbr mbr;
-    for (const auto &ring : rings)
-        mbr.addPoints(ring);
-    int startRet = (int)(rets.size());
+    Paths &subject = state->subject;
+    subject.resize(rings.size());
+    for (unsigned int ri=0;ri<rings.size();ri++)
+    {
+        const VectorRing &ring = rings[ri];
+        Path &path = subject[ri];
+        path.resize(ring.size());
+        for (unsigned int ii=0;ii<ring.size();ii++)
+        {
+            const Point2f &pt = ring[ii];
+            path[ii] = IntPoint(pt.x()*PolyScale,pt.y()*PolyScale);
+        }
+    }
     
-    int ll_ix = (int)std::floor((mbr.ll().x()-org.x())/spacing.x());
-    int ll_iy = (int)std::floor((mbr.ll().y()-org.y())/spacing.y());
-    int ur_ix = (int)std::ceil((mbr.ur().x()-org.x())/spacing.x());
-    int ur_iy = (int)std::ceil((mbr.ur().y()-org.y())/spacing.y());
+    return clipPaths(rets);
+}
+
+bool GridClipper::clipPaths(std::vector<VectorRing> &rets)
+{
+    Clipper &c = state->clipper;
+    Path &rect = state->rect;
+
+    IntPoint ll,ur;
+    if (!PathsBounds(state->subject,ll,ur))
+        return true;
     
-    // Clip in strips from left to right
-    for (int ix=ll_ix;ix<=ur_ix;ix++)
+    // Grid lines are worked out in floating point, as they always have been, so shapes
+    //  clipped separately still line up.  We pad the range by a cell to allow for rounding
+    //  and skip anything that turns out not to overlap.
+    const int ll_ix = (int)std::floor((ll.X/PolyScale-org.x())/spacing.x()) - 1;
+    const int ur_ix = (int)std::floor((ur.X/PolyScale-org.x())/spacing.x()) + 1;
+    std::vector<cInt> colEdges;
+    colEdges.reserve(ur_ix-ll_ix+2);
+    for (int ix=ll_ix;ix<=ur_ix+1;ix++)
+        colEdges.push_back((float)(ix*spacing.x()+org.x())*PolyScale);
+    int numCols = 0;
+    for (int ic=0;ic<(int)colEdges.size()-1;ic++)
+        if (colEdges[ic] < ur.X && colEdges[ic+1] > ll.X)
+            numCols++;
+
+    std::vector<cInt> rowEdges;
+    for (int ic=0;ic<(int)colEdges.size()-1;ic++)
     {
-        Point2f l0(ix*spacing.x()+org.x(),mbr.ll().y());
-        Point2f l1((ix+1)*spacing.x()+org.x(),mbr.ur().y());
-        Mbr left(l0,l1);
+        const cInt x0 = colEdges[ic], x1 = colEdges[ic+1];
+        if (x0 >= ur.X || x1 <= ll.X)
+            continue;
         
-        std::vector<VectorRing> leftStrip;
-        ClipLoopsToMbr(rings,left, true, leftStrip);
-        
-        // Now clip the left strip vertically
-        for (int iy=ll_iy;iy<=ur_iy;iy++)
+        // Clip out the column, unless the whole thing is in it
+        const Paths *strip = &state->subject;
+        IntPoint sll = ll, sur = ur;
+        if (numCols > 1)
+        {
+            SetRect(rect, x0, ll.Y, x1, ur.Y);
+            c.Clear();
+            c.AddPaths(state->subject, ptSubject, true);
+            c.AddPath(rect, ptClip, true);
+            state->strip.clear();
+            if (!c.Execute(ctIntersection, state->strip))
+                return false;
+            strip = &state->strip;
+            if (!PathsBounds(state->strip,sll,sur))
+                continue;
+        }
+
+        // Now split the column into cells
+        const int ll_iy = (int)std::floor((sll.Y/PolyScale-org.y())/spacing.y()) - 1;
+        const int ur_iy = (int)std::floor((sur.Y/PolyScale-org.y())/spacing.y()) + 1;
+        rowEdges.clear();
+        for (int iy=ll_iy;iy<=ur_iy+1;iy++)
+            rowEdges.push_back((float)(iy*spacing.y()+org.y())*PolyScale);
+        for (int ir=0;ir<(int)rowEdges.size()-1;ir++)
         {
+            const cInt y0 = rowEdges[ir], y1 = rowEdges[ir+1];
+            if (y0 >= sur.Y || y1 <= sll.Y)
+                continue;
             
-            Point2f b0(mbr.ll().x(),iy*spacing.y()+org.y());
-            Point2f b1(mbr.ur().x(),(iy+1)*spacing.y()+org.y());
-            Mbr bot(b0,b1);
-            for (unsigned int ic=0;ic<leftStrip.size();ic++)
-                ClipLoopToMbr(leftStrip[ic], bot, true, rets);
+            SetRect(rect, x0, y0, x1, y1);
+            c.Clear();
+            c.AddPaths(*strip, ptSubject, true);
+            c.AddPath(rect, ptClip, true);
+            state->cell.clear();
+            if (!c.Execute(ctIntersection, state->cell))
+                return false;
+            
+            // Convert back, reversing as we go
+            for (const Path &outPoly : state->cell)
+            {
+                if (outPoly.size() < 3)
+                    continue;
+                rets.resize(rets.size()+1);
+                VectorRing &outRing = rets.back();
+                outRing.reserve(outPoly.size());
+                for (int jj=(int)outPoly.size()-1;jj>=0;jj--)
+                {
+                    const IntPoint &outPt = outPoly[jj];
+                    outRing.push_back(Point2f(outPt.X/PolyScale,outPt.Y/PolyScale));
+                }
+            }
         }
     }
     
-    for (unsigned int ii=startRet;ii<rets.size();ii++)
-    {
-        VectorRing &theRing = rets[ii];
-        std::reverse(theRing.begin(),theRing.end());
-    }
-    
     return true;
 }
 
+// Clip the given loop to the given grid (org and spacing)
+// Return true on success and the new polygons in the rets
+bool ClipLoopToGrid(const VectorRing &ring,Point2f org,Point2f spacing,std::vector<VectorRing> &rets)
+{
+    GridClipper clipper(org,spacing);
+    return clipper.clipLoop(ring, rets);
+}
+    
+bool ClipLoopsToGrid(const std::vector<VectorRing> &rings,Point2f org,Point2f spacing,std::vector<VectorRing> &rets)
+{
+    GridClipper clipper(org,spacing);
+    return clipper.clipLoops(rings, rets);
+}
+
 }
@@ -124,6 +124,16 @@ void LabelRenderer::render(PlatformThreadInfo *threadInfo,std::vector<SingleLabe
     // Drawables we build up as we go
     DrawableIDMap drawables;
 
+    // Shaders for distance field glyphs, if the renderer has them
+    SimpleIdentity sdfProgID = EmptyIdentity, sdfMotionProgID = EmptyIdentity;
+    if (fontTexManager && fontTexManager->getSDFMode())
+    {
+        if (Program *prog = scene->findProgramByName(MaplyScreenSpaceSDFShader))
+            sdfProgID = prog->getId();
+        if (Program *prog = scene->findProgramByName(MaplyScreenSpaceSDFMotionShader))
+            sdfMotionProgID = prog->getId();
+    }
+
     for (unsigned int si=0;si<labels.size();si++)
     {
         SingleLabel *label = labels[si];
@@ -144,6 +154,15 @@ void LabelRenderer::render(PlatformThreadInfo *threadInfo,std::vector<SingleLabe
         
         // We set this if the color is embedded in the "font"
         bool embeddedColor = labelInfo->outlineSize > 0.0 || (label->infoOverride && label->infoOverride->outlineSize > 0.0);
+        // Distance field glyphs draw the outline themselves
+        RGBAColor theOutlineColor = labelInfo->outlineColor;
+        float theOutlineSize = labelInfo->outlineSize;
+        if (label->infoOverride && label->infoOverride->outlineSize > 0.0)
+        {
+            theOutlineColor = label->infoOverride->outlineColor;
+            theOutlineSize = label->infoOverride->outlineSize;
+        }
+        const SimpleIdentity labelSDFProgID = label->hasMotion ? sdfMotionProgID : sdfProgID;
 
         // Ask the label to build the strings.  There are OS specific things in there
         // We also need the real line height back (because it's in the font)
@@ -392,19 +411,37 @@ void LabelRenderer::render(PlatformThreadInfo *threadInfo,std::vector<SingleLabe
                         break;
                 }
                 
+                // Distance field glyphs are drawn with an edge value and some smoothing around it.
+                // Moving the edge out gives us the outline.
+                const bool sdfGlyphs = drawStr->sdfRange > 0.0 && labelSDFProgID != EmptyIdentity;
+                const bool sdfOutline = sdfGlyphs && theOutlineSize > 0.0;
+                const float sdfSmooth = std::min(0.7f * drawStr->sdfRange,0.25f);
+                const float sdfOutlineEdge = std::max(0.5f - theOutlineSize * drawStr->sdfRange,sdfSmooth);
+
                 // Turn the glyph polys into simple geometry
                 // We do this in a weird order to stick the shadow underneath
-                for (int ss=((theShadowSize > 0.0) ? 0: 1);ss<2;ss++)
+                // Passes are shadow, distance field outline, then the text
+                for (int ss=((theShadowSize > 0.0) ? 0: 1);ss<3;ss++)
                 {
+                    if (ss == 1 && !sdfOutline)
+                        continue;
+
                     Point2d soff;
                     RGBAColor color;
-                    if (ss == 1)
+                    float sdfEdge = 0.5;
+                    if (ss == 2)
                     {
                         soff = Point2d(0,0);
-                        color = embeddedColor ? RGBAColor(255,255,255,255) : theTextColor;
+                        color = (embeddedColor && !sdfGlyphs) ? RGBAColor(255,255,255,255) : theTextColor;
+                    } else if (ss == 1) {
+                        soff = Point2d(0,0);
+                        color = theOutlineColor;
+                        sdfEdge = sdfOutlineEdge;
                     } else {
                         soff = Point2d(theShadowSize,theShadowSize);
                         color = theShadowColor;
+                        if (sdfOutline)
+                            sdfEdge = sdfOutlineEdge;
                     }
                     for (unsigned int ii=0;ii<drawStr->glyphPolys.size();ii++)
                     {
@@ -426,6 +463,11 @@ void LabelRenderer::render(PlatformThreadInfo *threadInfo,std::vector<SingleLabe
                         
                         smGeom.texIDs.push_back(poly.subTex.texId);
                         smGeom.color = color;
+                        if (sdfGlyphs)
+                        {
+                            smGeom.progID = labelSDFProgID;
+                            smGeom.vertexAttrs.insert(SingleVertexAttribute(a_sdfParamsNameID,sdfEdge,sdfSmooth));
+                        }
                         poly.subTex.processTexCoords(smGeom.texCoords);
                         screenShape->addGeometry(smGeom);
                     }
@@ -68,10 +68,11 @@ LayoutObjectEntry::LayoutObjectEntry(SimpleIdentity theId)
     currentCluster = newCluster = -1;
     offset = Point2d(MAXFLOAT,MAXFLOAT);
     changed = true;
+    projIndex = -1;
 }
     
 LayoutManager::LayoutManager()
-    : maxDisplayObjects(0), hasUpdates(false), clusterGen(NULL)
+    : maxDisplayObjects(0), hasUpdates(false), clusterGen(NULL), projCacheDirty(true)
 {
 }
     
@@ -109,6 +110,7 @@ void LayoutManager::addLayoutObjects(const std::vector<LayoutObject> &newObjects
         layoutObjects.insert(entry);
     }
     hasUpdates = true;
+    projCacheDirty = true;
 }
 
 void LayoutManager::addLayoutObjects(const std::vector<LayoutObject *> &newObjects)
@@ -123,6 +125,7 @@ void LayoutManager::addLayoutObjects(const std::vector<LayoutObject *> &newObjec
         layoutObjects.insert(entry);
     }
     hasUpdates = true;
+    projCacheDirty = true;
 }
 
 /// Enable/disable layout objects
@@ -165,6 +168,7 @@ void LayoutManager::removeLayoutObjects(const SimpleIDSet &oldObjects)
         }
     }
     hasUpdates = true;
+    projCacheDirty = true;
 }
     
 bool LayoutManager::hasChanges()
@@ -183,6 +187,9 @@ void LayoutManager::getScreenSpaceObjects(const SelectionManager::PlacementInfo
 {
     std::lock_guard<std::mutex> guardLock(layoutLock);
 
+    // Layout has usually projected everything for this view state already
+    updateProjections(pInfo.viewState,pInfo.frameSize,pInfo.globeViewState != NULL);
+
     // First the regular screen space objects
     for (LayoutEntrySet::iterator it = layoutObjects.begin();
          it != layoutObjects.end(); ++it)
@@ -193,6 +200,13 @@ void LayoutManager::getScreenSpaceObjects(const SelectionManager::PlacementInfo
             ScreenSpaceObjectLocation ssObj;
             ssObj.shapeIDs.push_back(entry->obj.getId());
             ssObj.dispLoc = entry->obj.worldLoc;
+            ssObj.projected = true;
+            for (int offi=0;offi<projCache.getNumOffsets();offi++)
+            {
+                if (!projCache.isFacing(entry->projIndex,offi))
+                    break;
+                ssObj.screenLocs.push_back(projCache.getScreenPt(entry->projIndex,offi));
+            }
             ssObj.rotation = entry->obj.rotation;
             ssObj.keepUpright = entry->obj.keepUpright;
             ssObj.offset = entry->offset;
@@ -273,6 +287,38 @@ bool LayoutManager::calcScreenPt(Point2f &objPt,LayoutObject *layoutObj,ViewStat
     return isInside;
 }
 
+// Same as above, but we look up the projections from the cache
+bool LayoutManager::calcScreenPt(Point2f &objPt,LayoutObjectEntry *entry,const Mbr &screenMbr)
+{
+    bool isInside = false;
+    for (int offi=0;offi<projCache.getNumOffsets();offi++)
+    {
+        Point2f thisObjPt = projCache.getScreenPt(entry->projIndex,offi);
+        if (screenMbr.inside(thisObjPt))
+        {
+            isInside = true;
+            objPt = thisObjPt;
+        }
+    }
+
+    return isInside;
+}
+
+// Project all the layout objects at once, if we haven't already for this view state
+void LayoutManager::updateProjections(ViewStateRef viewState,const Point2f &frameBufferSize,bool isGlobe)
+{
+    if (projCacheDirty)
+    {
+        projCache.clear();
+        projCache.reserve(layoutObjects.size());
+        for (auto entry : layoutObjects)
+            entry->projIndex = projCache.addWorldLoc(entry->obj.worldLoc);
+        projCacheDirty = false;
+    }
+
+    projCache.project(viewState,frameBufferSize,isGlobe);
+}
+
 Matrix2d LayoutManager::calcScreenRot(float &screenRot,ViewStateRef viewState,WhirlyGlobe::GlobeViewState *globeViewState,ScreenSpaceObject *ssObj,const Point2f &objPt,const Matrix4d &modelTrans,const Matrix4d &normalMat,const Point2f &frameBufferSize)
 {
     // Switch from counter-clockwise to clockwise
@@ -355,9 +401,16 @@ bool LayoutManager::runLayoutRules(ViewStateRef viewState,std::vector<ClusterEnt
 
     // View related matrix stuff
     Matrix4d modelTrans = viewState->fullMatrices[0];
-    Matrix4f fullMatrix4f = Matrix4dToMatrix4f(viewState->fullMatrices[0]);
-    Matrix4f fullNormalMatrix4f = Matrix4dToMatrix4f(viewState->fullNormalMatrices[0]);
     Matrix4d normalMat = viewState->fullMatrices[0].inverse().transpose();
+
+    // Extents for the layout helpers
+    Point2f frameBufferSize;
+    frameBufferSize.x() = renderer->framebufferWidth;
+    frameBufferSize.y() = renderer->framebufferHeight;
+    Mbr screenMbr(Point2f(-ScreenBuffer * frameBufferSize.x(),-ScreenBuffer * frameBufferSize.y()),frameBufferSize * (1.0 + ScreenBuffer));
+
+    // Project everything to the screen in one go
+    updateProjections(viewState,frameBufferSize,globeViewState != NULL);
     
     // Turn everything off and sort by importance
     for (LayoutEntrySet::iterator it = layoutObjects.begin();
@@ -383,7 +436,7 @@ bool LayoutManager::runLayoutRules(ViewStateRef viewState,std::vector<ClusterEnt
                 if (globeViewState)
                 {
                     // Make sure this one is facing toward the viewer
-                    use = CheckPointAndNormFacing(Vector3dToVector3f(layoutObj->obj.worldLoc),Vector3dToVector3f(layoutObj->obj.worldLoc.normalized()),fullMatrix4f,fullNormalMatrix4f) > 0.0;
+                    use = projCache.isFacing(layoutObj->projIndex,0);
                 }
 
                 if (use)
@@ -441,12 +494,6 @@ bool LayoutManager::runLayoutRules(ViewStateRef viewState,std::vector<ClusterEnt
         }
     }
     
-    // Extents for the layout helpers
-    Point2f frameBufferSize;
-    frameBufferSize.x() = renderer->framebufferWidth;
-    frameBufferSize.y() = renderer->framebufferHeight;
-    Mbr screenMbr(Point2f(-ScreenBuffer * frameBufferSize.x(),-ScreenBuffer * frameBufferSize.y()),frameBufferSize * (1.0 + ScreenBuffer));
-
     // Need to scale for retina displays
     float resScale = renderer->getScale();
 
@@ -472,7 +519,7 @@ bool LayoutManager::runLayoutRules(ViewStateRef viewState,std::vector<ClusterEnt
                 // Project the point and figure out the rotation
                 bool isActive = true;
                 Point2f objPt;
-                bool isInside = calcScreenPt(objPt,&entry->obj,viewState,screenMbr,frameBufferSize);
+                bool isInside = calcScreenPt(objPt,entry,screenMbr);
                 
                 isActive &= isInside;
                 
@@ -635,7 +682,7 @@ bool LayoutManager::runLayoutRules(ViewStateRef viewState,std::vector<ClusterEnt
             if (isActive)
             {
                 Point2f objPt;
-                bool isInside = calcScreenPt(objPt,&layoutObj->obj,viewState,screenMbr,frameBufferSize);
+                bool isInside = calcScreenPt(objPt,layoutObj,screenMbr);
                 
                 isActive &= isInside;
                 
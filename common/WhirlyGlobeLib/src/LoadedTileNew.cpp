@@ -124,9 +124,9 @@ void LoadedTileNew::makeDrawables(SceneRenderer *sceneRender,TileGeomManager *ge
     GeoCoord geoUR(geomManage->coordSys->localToGeographic(Point3d(chunkUR.x(),chunkUR.y(),0.0)));
     
     BasicDrawableBuilderRef chunk = sceneRender->makeBasicDrawableBuilder("LoadedTileNew chunk");
-    chunk->reserve((sphereTessX+1)*(sphereTessY+1),2*sphereTessX*sphereTessY);
     // Note: Make this flexible
     chunk->setupTexCoordEntry(0, 0);
+    chunk->reserveLayout((sphereTessX+1)*(sphereTessY+1),2*sphereTessX*sphereTessY);
     
     std::vector<BasicDrawableBuilderRef> drawables;
     drawables.push_back(chunk);
@@ -223,43 +223,43 @@ void LoadedTileNew::makeDrawables(SceneRenderer *sceneRender,TileGeomManager *ge
         }
         
         // Without elevation data we can share the vertices
-        for (unsigned int iy=0;iy<sphereTessY+1;iy++)
+        const unsigned int numVerts = (sphereTessX+1)*(sphereTessY+1);
+        Point3fVector pts(numVerts),norms(numVerts);
+        for (unsigned int ii=0;ii<numVerts;ii++)
         {
-            for (unsigned int ix=0;ix<sphereTessX+1;ix++)
-            {
-                Point3d &loc3D = locs[iy*(sphereTessX+1)+ix];
-                
-                // And the normal
-                Point3d norm3D;
-                if (geomManage->coordAdapter->isFlat())
-                    norm3D = geomManage->coordAdapter->normalForLocal(loc3D);
-                else
-                    norm3D = loc3D;
-                
-                TexCoord &texCoord = texCoords[iy*(sphereTessX+1)+ix];
-                
-                chunk->addPoint(Point3d(loc3D-chunkMidDisp));
-                chunk->addNormal(norm3D);
-                chunk->addTexCoord(-1,texCoord);
-            }
+            Point3d &loc3D = locs[ii];
+            
+            // And the normal
+            Point3d norm3D;
+            if (geomManage->coordAdapter->isFlat())
+                norm3D = geomManage->coordAdapter->normalForLocal(loc3D);
+            else
+                norm3D = loc3D;
+            
+            pts[ii] = Vector3dToVector3f(loc3D-chunkMidDisp);
+            norms[ii] = Vector3dToVector3f(norm3D);
         }
+        chunk->addPoints(pts.data(),numVerts);
+        chunk->addNormals(norms.data(),numVerts);
+        chunk->addTexCoords(-1,texCoords.data(),numVerts);
         
         // Two triangles per cell
+        std::vector<BasicDrawable::Triangle> tris(2*sphereTessX*sphereTessY);
         for (unsigned int iy=0;iy<sphereTessY;iy++)
         {
             for (unsigned int ix=0;ix<sphereTessX;ix++)
             {
-                BasicDrawable::Triangle triA,triB;
+                BasicDrawable::Triangle &triA = tris[2*(iy*sphereTessX+ix)];
+                BasicDrawable::Triangle &triB = tris[2*(iy*sphereTessX+ix)+1];
                 triA.verts[0] = (iy+1)*(sphereTessX+1)+ix;
                 triA.verts[1] = iy*(sphereTessX+1)+ix;
                 triA.verts[2] = (iy+1)*(sphereTessX+1)+(ix+1);
                 triB.verts[0] = triA.verts[2];
                 triB.verts[1] = triA.verts[1];
                 triB.verts[2] = iy*(sphereTessX+1)+(ix+1);
-                chunk->addTriangle(triA);
-                chunk->addTriangle(triB);
             }
         }
+        chunk->addTriangles(tris.data(),(unsigned int)tris.size());
         
         if (geomManage->buildSkirts && !geomManage->coordAdapter->isFlat())
         {
@@ -438,20 +438,18 @@ void LoadedTileNew::buildSkirt(BasicDrawableBuilderRef &draw,Point3dVector &pts,
                         corners[3] = pts[ii] * skirtFactor;
                         cornerTex[3] = texCoords[ii];
         
-                        // Toss in the points, but point the normal up
-                        int base = draw->getNumPoints();
-                        for (unsigned int jj=0;jj<4;jj++)
-                        {
-                            draw->addPoint(Point3d(corners[jj]-theCenter));
-                            Point3d norm = (pts[ii]+pts[ii+1])/2.f;
-                            draw->addNormal(norm);
-                            TexCoord texCoord = cornerTex[jj];
-                            draw->addTexCoord(-1,texCoord);
-                        }
+        // Toss in the points, but point the normal up
+        Point3f cornerPts[4];
+        for (unsigned int jj=0;jj<4;jj++)
+            cornerPts[jj] = Vector3dToVector3f(corners[jj]-theCenter);
+        int base = draw->addPoints(cornerPts,4);
+        draw->addNormals(Vector3dToVector3f((pts[ii]+pts[ii+1])/2.f),4);
+        draw->addTexCoords(-1,cornerTex,4);
         
         // Add two triangles
-        draw->addTriangle(BasicDrawable::Triangle(base+3,base+2,base+0));
-        draw->addTriangle(BasicDrawable::Triangle(base+0,base+2,base+1));
+        BasicDrawable::Triangle tris[2] = {BasicDrawable::Triangle(base+3,base+2,base+0),
+                                           BasicDrawable::Triangle(base+0,base+2,base+1)};
+        draw->addTriangles(tris,2);
     }
 }
     
@@ -490,6 +490,7 @@ SimpleIdentity LoftManager::addLoftedPolys(WhirlyKit::ShapeSet *shapes,const Lof
     VectorTrianglesRef triMesh(VectorTriangles::createTriangles());
     GeoMbr shapeMbr;
     std::vector<WhirlyKit::VectorRing> outlines;
+    GridClipper gridClipper(Point2f(0.f,0.f),Point2f(polyInfo.gridSize,polyInfo.gridSize));
     
     for (ShapeSet::iterator it = shapes->begin();it != shapes->end(); ++it)
     {
@@ -510,7 +511,7 @@ SimpleIdentity LoftManager::addLoftedPolys(WhirlyKit::ShapeSet *shapes,const Lof
                 } else {
                     // Clip the polys for the top
                     std::vector<VectorRing> clippedMesh;
-                    ClipLoopToGrid(ring,Point2f(0.f,0.f),Point2f(polyInfo.gridSize,polyInfo.gridSize),clippedMesh);
+                    gridClipper.clipLoop(ring,clippedMesh);
                     
                     // May need to add the outline as well
                     if (polyInfo.outline)
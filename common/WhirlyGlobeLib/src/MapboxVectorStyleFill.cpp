@@ -76,17 +76,19 @@ void MapboxVectorLayerFill::buildObjects(PlatformThreadInfo *inst,
     
     ComponentObjectRef compObj = styleSet->makeComponentObject(inst);
 
-    // Filled polygons
-    if (paint.color) {
-        ShapeSet shapes;
-
-        // Gather all the areal features
+    // Gather all the areal features, simplified once for both the fill and outline
+    ShapeSet shapes;
+    if (paint.color || paint.outlineColor) {
         for (auto vecObj : vecObjs) {
             if (vecObj->getVectorType() == VectorArealType) {
                 shapes.insert(vecObj->shapes.begin(),vecObj->shapes.end());
             }
         }
-        
+        styleSet->simplifyShapes(tileInfo.get(),shapes);
+    }
+
+    // Filled polygons
+    if (paint.color) {
         ShapeSet tessShapes;
         for (ShapeSet::iterator it = shapes.begin();it!=shapes.end();it++)
         {
@@ -137,15 +139,6 @@ void MapboxVectorLayerFill::buildObjects(PlatformThreadInfo *inst,
     
     // Outlines
     if (paint.outlineColor) {
-        ShapeSet shapes;
-
-        // Gather all the areal features
-        for (auto vecObj : vecObjs) {
-            if (vecObj->getVectorType() == VectorArealType) {
-                shapes.insert(vecObj->shapes.begin(),vecObj->shapes.end());
-            }
-        }
-        
         // Set up the description for constructing vectors
         VectorInfo vecInfo;
         bool include = true;
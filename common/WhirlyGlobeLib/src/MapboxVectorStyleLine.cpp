@@ -206,6 +206,7 @@ void MapboxVectorLayerLine::buildObjects(PlatformThreadInfo *inst,
                 shapes.insert(vecObj->shapes.begin(),vecObj->shapes.end());
             }
         }
+        styleSet->simplifyShapes(tileInfo.get(),shapes);
         
         SimpleIdentity wideVecID = styleSet->wideVecManage->addVectors(&shapes, vecInfo, tileInfo->changes);
         if (wideVecID != EmptyIdentity)
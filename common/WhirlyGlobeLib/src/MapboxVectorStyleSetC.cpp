@@ -24,6 +24,7 @@
 #import "WhirlyKitLog.h"
 #import "MapboxVectorStyleBackground.h"
 #import <regex>
+#import <atomic>
 
 namespace WhirlyKit
 {
@@ -220,8 +221,11 @@ RGBAColor MapboxTransColor::colorForZoom(double zoom)
     return theColor;
 }
 
+// Handed out to style sets as their styles change
+static std::atomic<int> StyleSetGeneration(0);
+
 MapboxVectorStyleSetImpl::MapboxVectorStyleSetImpl(Scene *inScene,CoordSystem *coordSys,VectorStyleSettingsImplRef settings)
-: scene(inScene), currentID(0), tileStyleSettings(settings), coordSys(coordSys)
+: scene(inScene), currentID(0), tileStyleSettings(settings), coordSys(coordSys), version(0), generation(++StyleSetGeneration)
 {
     vecManage = (VectorManager *)scene->getManager(kWKVectorManager);
     wideVecManage = (WideVectorManager *)scene->getManager(kWKWideVectorManager);
@@ -251,6 +255,7 @@ bool MapboxVectorStyleSetImpl::parse(PlatformThreadInfo *inst,DictionaryRef styl
 {
     name = styleDict->getString("name");
     version = styleDict->getInt("version");
+    stylesChanged();
     
     // Layers are where the action is
     std::vector<DictionaryEntryRef> layerStyles = styleDict->getArray("layers");
@@ -288,6 +293,11 @@ long long MapboxVectorStyleSetImpl::generateID()
     return currentID++;
 }
 
+void MapboxVectorStyleSetImpl::stylesChanged()
+{
+    generation = ++StyleSetGeneration;
+}
+
 int MapboxVectorStyleSetImpl::intValue(const std::string &name,DictionaryRef dict,int defVal)
 {
     DictionaryEntryRef thing = dict->getEntry(name);
@@ -645,6 +655,28 @@ RGBAColor MapboxVectorStyleSetImpl::color(RGBAColor color,double opacity)
     return RGBAColor(vals[0]*opacity*255,vals[1]*opacity*255,vals[2]*opacity*255,vals[3]*opacity*255);
 }
 
+void MapboxVectorStyleSetImpl::simplifyShapes(const VectorTileData *tileInfo,ShapeSet &shapes)
+{
+    const float tolerance = tileStyleSettings->simplifyTolerance;
+    const int level = tileInfo->ident.level;
+    if (tolerance <= 0.0 || shapes.empty() ||
+        (tileStyleSettings->simplifyMaxLevel >= 0 && level >= tileStyleSettings->simplifyMaxLevel))
+        return;
+
+    // Keep the tile edges where they are so neighboring tiles still meet
+    ShapeSet simpleShapes;
+    if (tileInfo->localCoords)
+    {
+        // Local coordinates are spherical mercator, so a pixel is the same size across the tile
+        const double localTolerance = tolerance * (tileInfo->bbox.ur().x() - tileInfo->bbox.ll().x()) / 256.0;
+        VectorSimplifyShapes(shapes, simpleShapes, localTolerance,
+                             VectorSimplifyDouglasPeucker, false, Mbr(tileInfo->bbox));
+    } else
+        VectorSimplifyShapes(shapes, simpleShapes, VectorSimplifyToleranceForLevel(tolerance, level),
+                             VectorSimplifyDouglasPeucker, true, Mbr(tileInfo->geoBBox));
+    shapes.swap(simpleShapes);
+}
+
 MapboxVectorStyleLayerRef MapboxVectorStyleSetImpl::getLayer(const std::string &name)
 {
     auto it = layersByName.find(name);
@@ -20,7 +20,9 @@
 
 #import "MapboxVectorTileParser.h"
 #import "MaplyVectorStyleC.h"
+#import "MapboxVectorStyleSetC.h"
 #import "VectorObject.h"
+#import "FrameTrace.h"
 #import "vector_tile.pb.h"
 #import <vector>
 
@@ -32,11 +34,12 @@ namespace WhirlyKit
 {
     
 VectorTileData::VectorTileData()
+    : localCoords(false)
 {
 }
     
 VectorTileData::VectorTileData(const VectorTileData &that)
-    : ident(that.ident), bbox(that.bbox), geoBBox(that.geoBBox)
+    : ident(that.ident), bbox(that.bbox), geoBBox(that.geoBBox), localCoords(that.localCoords)
 {
 }
     
@@ -111,9 +114,42 @@ void MapboxVectorTileParser::addCategory(const std::string &category,long long s
 {
     styleCategories[styleID] = category;
 }
+
+void MapboxVectorTileParser::setGeometryCache(TileGeometryCacheRef cache)
+{
+    geomCache = cache;
+}
     
 bool MapboxVectorTileParser::parse(PlatformThreadInfo *styleInst,RawData *rawData,VectorTileData *tileData)
 {
+    FrameTraceScope traceScope(TraceTileParse);
+
+    // If we've built this one before, we can skip the parsing and building for the styles we kept
+    MapboxVectorStyleSetImpl *cacheStyleSet = NULL;
+    TileGeometryCache::TileEntryRef cacheEntry,newCacheEntry;
+    int styleGeneration = 0;
+    unsigned long long dataHash = 0;
+    if (geomCache && !keepVectors)
+    {
+        cacheStyleSet = dynamic_cast<MapboxVectorStyleSetImpl *>(styleDelegate.get());
+        // Rebuilding the drawables takes a renderer
+        if (cacheStyleSet && cacheStyleSet->vecManage && cacheStyleSet->vecManage->getSceneRenderer())
+        {
+            styleGeneration = cacheStyleSet->generation;
+            dataHash = TileGeometryCache::hashData(rawData);
+            cacheEntry = geomCache->findTile(tileData->ident,styleGeneration,dataHash);
+            if (!cacheEntry)
+                newCacheEntry = TileGeometryCache::TileEntryRef(new TileGeometryCache::TileEntry());
+            else if (cacheEntry->complete) {
+                restoreCachedStyles(styleInst,cacheStyleSet,cacheEntry,tileData);
+                return true;
+            }
+        }
+    }
+
+    // The styles need to know what coordinates the shapes are in
+    tileData->localCoords = localCoords;
+
     //calulate tile bounds and coordinate shift
     int tileSize = 256;
     double sx = tileSize / (tileData->bbox.ur().x() - tileData->bbox.ll().x());
@@ -214,6 +250,9 @@ bool MapboxVectorTileParser::parse(PlatformThreadInfo *styleInst,RawData *rawDat
                 }
                 std::vector<VectorStyleImplRef> styles = styleDelegate->stylesForFeature(attributes, tileData->ident, tileLayer.name());
                 for (auto style: styles) {
+                    // Already restored from the cache
+                    if (cacheEntry && cacheEntry->findStyle(style->getUuid()))
+                        continue;
                     styleIDs.insert(style->getUuid());
                 }
                 if (styleIDs.empty() && !parseAll)
@@ -420,6 +459,10 @@ bool MapboxVectorTileParser::parse(PlatformThreadInfo *styleInst,RawData *rawDat
         return false;
     }
     
+    // Bring back what the cache has, then build the rest
+    if (cacheEntry)
+        restoreCachedStyles(styleInst,cacheStyleSet,cacheEntry,tileData);
+
     // Run the styles over their assembled data
     for (auto it : tileData->vecObjsByStyle) {
         std::vector<VectorObjectRef> *vecs = it.second;
@@ -429,20 +472,11 @@ bool MapboxVectorTileParser::parse(PlatformThreadInfo *styleInst,RawData *rawDat
         // Ask the subclass to run the style and fill in the VectorTileData
         buildForStyle(styleInst,it.first,*vecs,styleData);
         
-        // Sort the results into categories if needed
-        auto catIt = styleCategories.find(it.first);
-        if (catIt != styleCategories.end() && !styleData->compObjs.empty()) {
-            std::string category = catIt->second;
-            auto compObjs = styleData->compObjs;
-            auto categoryIt = tileData->categories.find(category);
-            if (categoryIt != tileData->categories.end()) {
-                compObjs.insert(compObjs.end(), categoryIt->second.begin(), categoryIt->second.end());
-            }
-            tileData->categories[category] = compObjs;
-        }
-        
-        // Merge this into the general return data
-        tileData->mergeFrom(styleData.get());
+        // Keep what it built for next time, if we can
+        if (newCacheEntry && !newCacheEntry->addStyle(it.first,cacheStyleSet,styleData.get()))
+            newCacheEntry->complete = false;
+
+        mergeForStyle(it.first,styleData,tileData);
     }
     
     // These are layered on top for debugging
@@ -489,9 +523,41 @@ bool MapboxVectorTileParser::parse(PlatformThreadInfo *styleInst,RawData *rawDat
 //        }
 //    }
     
+    // Keep the results around for the next time we see this tile
+    if (newCacheEntry)
+        geomCache->addTile(tileData->ident,styleGeneration,dataHash,newCacheEntry);
+    
     return true;
 }
 
+void MapboxVectorTileParser::restoreCachedStyles(PlatformThreadInfo *styleInst,MapboxVectorStyleSetImpl *styleSet,
+                                                 TileGeometryCache::TileEntryRef cacheEntry,VectorTileData *tileData)
+{
+    for (const TileGeometryCache::StyleEntry &styleEntry : cacheEntry->styles) {
+        auto styleData = VectorTileDataRef(new VectorTileData(*tileData));
+        geomCache->restoreStyle(styleInst,styleEntry,styleSet,styleData.get());
+        mergeForStyle(styleEntry.styleID,styleData,tileData);
+    }
+}
+
+void MapboxVectorTileParser::mergeForStyle(long long styleID,VectorTileDataRef styleData,VectorTileData *tileData)
+{
+    // Sort the results into categories if needed
+    auto catIt = styleCategories.find(styleID);
+    if (catIt != styleCategories.end() && !styleData->compObjs.empty()) {
+        std::string category = catIt->second;
+        auto compObjs = styleData->compObjs;
+        auto categoryIt = tileData->categories.find(category);
+        if (categoryIt != tileData->categories.end()) {
+            compObjs.insert(compObjs.end(), categoryIt->second.begin(), categoryIt->second.end());
+        }
+        tileData->categories[category] = compObjs;
+    }
+    
+    // Merge this into the general return data
+    tileData->mergeFrom(styleData.get());
+}
+
 void MapboxVectorTileParser::buildForStyle(PlatformThreadInfo *styleInst,
                                            long long styleID,
                                            std::vector<VectorObjectRef> &vecObjs,
@@ -39,6 +39,8 @@ VectorStyleSettingsImpl::VectorStyleSettingsImpl(double scale)
     useWideVectors = false;
     oldVecWidthScale = 1.0;
     wideVecCuttoff = 0.0;
+    simplifyTolerance = 0.0;
+    simplifyMaxLevel = -1;
     selectable = false;
     settingsArealShaderID = EmptyIdentity;
 }
@@ -73,7 +73,7 @@ Eigen::Matrix4d MapView::calcViewMatrix()
     return rot.matrix();
 }
 
-void MapView::getOffsetMatrices(std::vector<Eigen::Matrix4d> &offsetMatrices,const WhirlyKit::Point2f &frameBufferSize,float bufferSizeX)
+void MapView::getOffsetMatrices(Matrix4dVector &offsetMatrices,const WhirlyKit::Point2f &frameBufferSize,float bufferSizeX)
 {
     Point3d scale = coordAdapter->getScale();
     
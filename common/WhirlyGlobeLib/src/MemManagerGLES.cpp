@@ -44,6 +44,7 @@ RenderSetupInfoGLES::RenderSetupInfoGLES(Scene *inScene)
 }
 
 OpenGLMemManager::OpenGLMemManager()
+: subBuffers(this), useSubBuffers(true)
 {
 }
 
@@ -193,10 +194,60 @@ void OpenGLMemManager::clearTextureIDs()
     texIDs.clear();
 }
 
+bool OpenGLMemManager::getSubBuffer(unsigned int size,BufferArenaAlloc &alloc)
+{
+    std::lock_guard<std::mutex> guardLock(subBufferLock);
+    if (!useSubBuffers)
+        return false;
+    
+    alloc = subBuffers.allocate(size);
+    return alloc.valid();
+}
+
+void OpenGLMemManager::removeSubBuffer(const BufferArenaAlloc &alloc)
+{
+    std::lock_guard<std::mutex> guardLock(subBufferLock);
+    subBuffers.free(alloc);
+}
+
+void OpenGLMemManager::clearSubBuffers()
+{
+    std::lock_guard<std::mutex> guardLock(subBufferLock);
+    subBuffers.clear();
+}
+
+void OpenGLMemManager::setUseSubBuffers(bool inUseSubBuffers)
+{
+    std::lock_guard<std::mutex> guardLock(subBufferLock);
+    useSubBuffers = inUseSubBuffers;
+    // Anything already handed out stays where it is
+    if (!useSubBuffers)
+        subBuffers.trim();
+}
+
+BufferArenaStats OpenGLMemManager::getSubBufferStats()
+{
+    std::lock_guard<std::mutex> guardLock(subBufferLock);
+    return subBuffers.getStats();
+}
+
+unsigned int OpenGLMemManager::createArenaBuffer(size_t size)
+{
+    return getBufferID((unsigned int)size,GL_STATIC_DRAW);
+}
+
+void OpenGLMemManager::releaseArenaBuffer(unsigned int bufferID)
+{
+    removeBufferID(bufferID);
+}
+
 void OpenGLMemManager::dumpStats()
 {
     wkLogLevel(Verbose,"MemCache: %ld buffers",(long int)buffIDs.size());
     wkLogLevel(Verbose,"MemCache: %ld textures",(long int)texIDs.size());
+    
+    const BufferArenaStats stats = getSubBufferStats();
+    wkLogLevel(Verbose,"MemCache: %d shared buffers holding %d drawables, %.1f%% used",stats.numArenas,stats.numAllocs,100.0*stats.utilization());
 }
 
 }
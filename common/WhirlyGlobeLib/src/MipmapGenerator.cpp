@@ -0,0 +1,286 @@
+/*
+ *  MipmapGenerator.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <math.h>
+#import <stdlib.h>
+#import <string.h>
+#import <algorithm>
+#import <vector>
+#import "MipmapGenerator.h"
+#import "PixelConversion.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#import <emmintrin.h>
+#define WK_MIP_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#import <arm_neon.h>
+#define WK_MIP_NEON 1
+#endif
+
+namespace WhirlyKit
+{
+
+// Linear values are 14 bits, so four of them still add up in 16
+static const int MipLinearBits = 14;
+static const int MipLinearMax = (1 << MipLinearBits) - 1;
+// Rows we shrink and convert together.  Even, so row pairs don't straddle bands.
+static const int MipBandRows = 16;
+
+// sRGB to linear and back again
+class MipSRGBTables
+{
+public:
+    MipSRGBTables()
+    {
+        for (int ii=0;ii<256;ii++)
+        {
+            const double val = ii / 255.0;
+            const double lin = val <= 0.04045 ? val / 12.92 : pow((val + 0.055) / 1.055, 2.4);
+            toLinear[ii] = (uint16_t)(lin * MipLinearMax + 0.5);
+        }
+        for (int ii=0;ii<=MipLinearMax;ii++)
+        {
+            const double lin = ii / (double)MipLinearMax;
+            const double val = lin <= 0.0031308 ? lin * 12.92 : 1.055 * pow(lin, 1.0/2.4) - 0.055;
+            toSRGB[ii] = (uint8_t)std::min(255.0,val * 255.0 + 0.5);
+        }
+    }
+
+    uint16_t toLinear[256];
+    uint8_t toSRGB[MipLinearMax+1];
+};
+
+static const MipSRGBTables &GetSRGBTables()
+{
+    static MipSRGBTables tables;
+    return tables;
+}
+
+int MipmapNumLevels(int width,int height)
+{
+    int size = std::max(width,height);
+    int numLevels = 1;
+    while (size > 1)
+    {
+        size >>= 1;
+        numLevels++;
+    }
+    return numLevels;
+}
+
+int MipmapRowBytes(TextureType format,int width)
+{
+    return (width * PixelConversionBytesPerPixel(format) + 3) & ~3;
+}
+
+// Scratch space for the sRGB version, so we're not allocating per row
+class MipRowScratch
+{
+public:
+    std::vector<uint16_t> lin0,lin1,sum;
+};
+
+// Straight box filter of two rows into one
+static void DownsampleRowBox(const unsigned char *row0,const unsigned char *row1,int width,unsigned char *out,bool allowSIMD)
+{
+    const int outWidth = std::max(1,width/2);
+    int x = 0;
+#if WK_MIP_SSE
+    if (allowSIMD)
+    {
+        const __m128i zero = _mm_setzero_si128(), two = _mm_set1_epi16(2);
+        // Four pixels in, two out
+        for (;x+2 <= outWidth && 2*x+4 <= width;x+=2)
+        {
+            const __m128i a = _mm_loadu_si128((const __m128i *)(row0 + 8*x));
+            const __m128i b = _mm_loadu_si128((const __m128i *)(row1 + 8*x));
+            __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+            __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+            lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+            hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+            __m128i sum = _mm_unpacklo_epi64(lo, hi);
+            sum = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+            _mm_storel_epi64((__m128i *)(out + 4*x), _mm_packus_epi16(sum, sum));
+        }
+    }
+#elif WK_MIP_NEON
+    if (allowSIMD)
+    {
+        // Four pixels in, two out
+        for (;x+2 <= outWidth && 2*x+4 <= width;x+=2)
+        {
+            const uint8x16_t a = vld1q_u8(row0 + 8*x);
+            const uint8x16_t b = vld1q_u8(row1 + 8*x);
+            const uint16x8_t lo = vaddl_u8(vget_low_u8(a), vget_low_u8(b));
+            const uint16x8_t hi = vaddl_u8(vget_high_u8(a), vget_high_u8(b));
+            const uint16x8_t sum = vcombine_u16(vadd_u16(vget_low_u16(lo), vget_high_u16(lo)),
+                                                vadd_u16(vget_low_u16(hi), vget_high_u16(hi)));
+            vst1_u8(out + 4*x, vmovn_u16(vrshrq_n_u16(sum, 2)));
+        }
+    }
+#endif
+    for (;x<outWidth;x++)
+    {
+        const int x0 = 2*x, x1 = std::min(2*x+1,width-1);
+        for (int c=0;c<4;c++)
+            out[4*x+c] = (row0[4*x0+c] + row0[4*x1+c] + row1[4*x0+c] + row1[4*x1+c] + 2) >> 2;
+    }
+}
+
+// Box filter in linear space.  Alpha is carried along at the same precision so it can share the sums.
+static void DownsampleRowSRGB(const unsigned char *row0,const unsigned char *row1,int width,unsigned char *out,bool allowSIMD,MipRowScratch &scratch)
+{
+    const MipSRGBTables &tables = GetSRGBTables();
+    const int outWidth = std::max(1,width/2);
+    const int alphaShift = MipLinearBits - 8;
+
+    // Widths of one get the one pixel twice
+    const int inWidth = std::max(2,width);
+    scratch.lin0.resize(4*inWidth);
+    scratch.lin1.resize(4*inWidth);
+    scratch.sum.resize(4*outWidth);
+    for (int x=0;x<inWidth;x++)
+    {
+        const int sx = std::min(x,width-1);
+        for (int c=0;c<3;c++)
+        {
+            scratch.lin0[4*x+c] = tables.toLinear[row0[4*sx+c]];
+            scratch.lin1[4*x+c] = tables.toLinear[row1[4*sx+c]];
+        }
+        scratch.lin0[4*x+3] = row0[4*sx+3] << alphaShift;
+        scratch.lin1[4*x+3] = row1[4*sx+3] << alphaShift;
+    }
+
+    const uint16_t *lin0 = &scratch.lin0[0], *lin1 = &scratch.lin1[0];
+    uint16_t *sum = &scratch.sum[0];
+    int x = 0;
+#if WK_MIP_SSE
+    if (allowSIMD)
+    {
+        const __m128i two = _mm_set1_epi16(2);
+        for (;x<outWidth;x++)
+        {
+            __m128i s = _mm_add_epi16(_mm_loadu_si128((const __m128i *)(lin0 + 8*x)), _mm_loadu_si128((const __m128i *)(lin1 + 8*x)));
+            s = _mm_add_epi16(s, _mm_srli_si128(s, 8));
+            _mm_storel_epi64((__m128i *)(sum + 4*x), _mm_srli_epi16(_mm_add_epi16(s, two), 2));
+        }
+    }
+#elif WK_MIP_NEON
+    if (allowSIMD)
+    {
+        for (;x<outWidth;x++)
+        {
+            const uint16x8_t s = vaddq_u16(vld1q_u16(lin0 + 8*x), vld1q_u16(lin1 + 8*x));
+            vst1_u16(sum + 4*x, vrshr_n_u16(vadd_u16(vget_low_u16(s), vget_high_u16(s)), 2));
+        }
+    }
+#endif
+    for (;x<outWidth;x++)
+        for (int c=0;c<4;c++)
+            sum[4*x+c] = (lin0[8*x+c] + lin0[8*x+4+c] + lin1[8*x+c] + lin1[8*x+4+c] + 2) >> 2;
+
+    for (x=0;x<outWidth;x++)
+    {
+        for (int c=0;c<3;c++)
+            out[4*x+c] = tables.toSRGB[sum[4*x+c]];
+        out[4*x+3] = (sum[4*x+3] + (1 << (alphaShift-1))) >> alphaShift;
+    }
+}
+
+static void DownsampleRow(const unsigned char *row0,const unsigned char *row1,int width,unsigned char *out,bool sRGB,bool allowSIMD,MipRowScratch &scratch)
+{
+    if (sRGB)
+        DownsampleRowSRGB(row0, row1, width, out, allowSIMD, scratch);
+    else
+        DownsampleRowBox(row0, row1, width, out, allowSIMD);
+}
+
+void DownsampleRGBA(const unsigned char *rgba,int width,int height,unsigned char *out,bool sRGB,bool allowSIMD)
+{
+    const int outWidth = std::max(1,width/2), outHeight = std::max(1,height/2);
+    MipRowScratch scratch;
+    for (int y=0;y<outHeight;y++)
+    {
+        const unsigned char *row0 = rgba + (size_t)2*y*width*4;
+        const unsigned char *row1 = rgba + (size_t)std::min(2*y+1,height-1)*width*4;
+        DownsampleRow(row0, row1, width, out + (size_t)y*outWidth*4, sRGB, allowSIMD, scratch);
+    }
+}
+
+bool BuildMipmapChain(const unsigned char *rgba,int width,int height,TextureType format,WKSingleByteSource source,bool sRGB,std::vector<RawDataRef> &levels)
+{
+    const int bytesPerPixel = PixelConversionBytesPerPixel(format);
+    if (bytesPerPixel == 0 || width <= 0 || height <= 0)
+        return false;
+    const bool keepRGBA = format == TexTypeUnsignedByte;
+
+    const int numLevels = MipmapNumLevels(width,height);
+    levels.assign(numLevels,RawDataRef());
+    MipRowScratch scratch;
+
+    const unsigned char *cur = rgba;
+    for (int level=0;level<numLevels;level++)
+    {
+        const int w = MipmapLevelSize(width,level), h = MipmapLevelSize(height,level);
+        const int nextWidth = std::max(1,w/2), nextHeight = std::max(1,h/2);
+        unsigned char *next = level < numLevels-1 ? (unsigned char *)malloc((size_t)nextWidth*nextHeight*4) : NULL;
+        const int rowBytes = MipmapRowBytes(format,w);
+        const int padBytes = rowBytes - w*bytesPerPixel;
+        unsigned char *converted = keepRGBA ? NULL : (unsigned char *)malloc((size_t)rowBytes*h);
+
+        // A band of rows at a time, shrunk and then converted while they're still in cache
+        for (int bandY=0;bandY<h;bandY+=MipBandRows)
+        {
+            const int bandEnd = std::min(bandY+MipBandRows,h);
+            if (next)
+                for (int y=bandY;y<bandEnd && y/2 < nextHeight;y+=2)
+                {
+                    const unsigned char *row0 = cur + (size_t)y*w*4;
+                    const unsigned char *row1 = cur + (size_t)std::min(y+1,h-1)*w*4;
+                    DownsampleRow(row0, row1, w, next + (size_t)(y/2)*nextWidth*4, sRGB, true, scratch);
+                }
+            if (!converted)
+                continue;
+            if (padBytes == 0)
+                ConvertRGBAPixelRun(format, source, cur + (size_t)bandY*w*4, converted + (size_t)bandY*rowBytes, w*(bandEnd-bandY));
+            else
+                for (int y=bandY;y<bandEnd;y++)
+                {
+                    unsigned char *outRow = converted + (size_t)y*rowBytes;
+                    ConvertRGBAPixelRun(format, source, cur + (size_t)y*w*4, outRow, w);
+                    memset(outRow + w*bytesPerPixel, 0, padBytes);
+                }
+        }
+
+        if (converted)
+        {
+            levels[level] = RawDataRef(new RawDataWrapper(converted,(unsigned long)rowBytes*h,true));
+            // Intermediate levels were ours
+            if (cur != rgba)
+                free((void *)cur);
+        } else if (cur != rgba)
+            levels[level] = RawDataRef(new RawDataWrapper(cur,(unsigned long)w*h*4,true));
+        cur = next;
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,73 @@
+/*
+ *  PackedRTree.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import "PackedRTree.h"
+
+namespace WhirlyKit
+{
+
+uint32_t HilbertIndex(uint32_t x,uint32_t y)
+{
+    const uint32_t n = 1<<16;
+    uint32_t d = 0;
+    for (uint32_t s=n/2;s>0;s/=2)
+    {
+        uint32_t rx = (x & s) > 0;
+        uint32_t ry = (y & s) > 0;
+        d += s * s * ((3 * rx) ^ ry);
+        if (ry == 0)
+        {
+            if (rx == 1)
+            {
+                x = n-1 - x;
+                y = n-1 - y;
+            }
+            std::swap(x,y);
+        }
+    }
+
+    return d;
+}
+
+uint32_t HilbertIndexFraction(double fracX,double fracY)
+{
+    const uint32_t hx = (uint32_t)std::min(std::max(fracX * 65535.0,0.0),65535.0);
+    const uint32_t hy = (uint32_t)std::min(std::max(fracY * 65535.0,0.0),65535.0);
+
+    return HilbertIndex(hx,hy);
+}
+
+bool PackedRTreeCheckLevels(const uint32_t *levelEnds,uint32_t numLevels,uint32_t numNodes)
+{
+    if (numNodes == 0)
+        return numLevels == 0;
+    if (numLevels == 0 || levelEnds[0] == 0 || levelEnds[numLevels-1] != numNodes)
+        return false;
+    for (uint32_t ii=1;ii<numLevels;ii++)
+        if (levelEnds[ii] <= levelEnds[ii-1])
+            return false;
+    // Only the root is on the top level
+    if ((numLevels > 1 ? levelEnds[numLevels-2] : 0) != numNodes-1)
+        return false;
+
+    return true;
+}
+
+}
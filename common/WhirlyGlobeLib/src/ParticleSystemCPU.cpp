@@ -0,0 +1,357 @@
+/*
+ *  ParticleSystemCPU.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <string.h>
+#import "ParticleSystemCPU.h"
+#import "StringIndexer.h"
+#import "WhirlyKitLog.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#import <emmintrin.h>
+#define WK_PARTICLE_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#import <arm_neon.h>
+#define WK_PARTICLE_NEON 1
+#endif
+
+namespace WhirlyKit
+{
+
+// Below this many particles we don't bother with extra threads
+static const int kMinParticlesPerThread = 16384;
+
+// pos += vel * dt
+static void ParticleIntegrateKernel(float *pos,const float *vel,float dt,int num,bool allowSIMD)
+{
+    int ii = 0;
+#if defined(WK_PARTICLE_SSE)
+    if (allowSIMD)
+    {
+        const __m128 dt4 = _mm_set1_ps(dt);
+        for (;ii+4<=num;ii+=4)
+            _mm_storeu_ps(pos+ii,_mm_add_ps(_mm_loadu_ps(pos+ii),_mm_mul_ps(_mm_loadu_ps(vel+ii),dt4)));
+    }
+#elif defined(WK_PARTICLE_NEON)
+    if (allowSIMD)
+    {
+        const float32x4_t dt4 = vdupq_n_f32(dt);
+        for (;ii+4<=num;ii+=4)
+            vst1q_f32(pos+ii,vmlaq_f32(vld1q_f32(pos+ii),vld1q_f32(vel+ii),dt4));
+    }
+#endif
+    for (;ii<num;ii++)
+        pos[ii] += vel[ii] * dt;
+}
+
+// age = (now - startTime) / lifetime
+// Returns the number of particles with an age less than 1
+static int ParticleAgeKernel(float *age,const float *startTime,float now,float invLifetime,int num,bool allowSIMD)
+{
+    int numLive = 0;
+    int ii = 0;
+#if defined(WK_PARTICLE_SSE)
+    if (allowSIMD)
+    {
+        static const int bitCount[16] = {0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4};
+        const __m128 now4 = _mm_set1_ps(now);
+        const __m128 inv4 = _mm_set1_ps(invLifetime);
+        const __m128 one4 = _mm_set1_ps(1.0f);
+        for (;ii+4<=num;ii+=4)
+        {
+            const __m128 val = _mm_mul_ps(_mm_sub_ps(now4,_mm_loadu_ps(startTime+ii)),inv4);
+            _mm_storeu_ps(age+ii,val);
+            numLive += bitCount[_mm_movemask_ps(_mm_cmplt_ps(val,one4))];
+        }
+    }
+#elif defined(WK_PARTICLE_NEON)
+    if (allowSIMD)
+    {
+        const float32x4_t now4 = vdupq_n_f32(now);
+        const float32x4_t inv4 = vdupq_n_f32(invLifetime);
+        const float32x4_t one4 = vdupq_n_f32(1.0f);
+        uint32x4_t live4 = vdupq_n_u32(0);
+        for (;ii+4<=num;ii+=4)
+        {
+            const float32x4_t val = vmulq_f32(vsubq_f32(now4,vld1q_f32(startTime+ii)),inv4);
+            vst1q_f32(age+ii,val);
+            live4 = vaddq_u32(live4,vshrq_n_u32(vcltq_f32(val,one4),31));
+        }
+        numLive += vgetq_lane_u32(live4,0) + vgetq_lane_u32(live4,1) + vgetq_lane_u32(live4,2) + vgetq_lane_u32(live4,3);
+    }
+#endif
+    for (;ii<num;ii++)
+    {
+        age[ii] = (now - startTime[ii]) * invLifetime;
+        if (age[ii] < 1.0f)
+            numLive++;
+    }
+
+    return numLive;
+}
+
+ParticleSystemCPU::ParticleSystemCPU(const std::vector<SingleVertexAttributeInfo> &vertAttrs,int vertexSize,
+                                     int totalParticles,int batchSize,
+                                     TimeInterval lifetime,TimeInterval baseTime,int numThreads)
+: valid(false), vertexSize(vertexSize), totalParticles(totalParticles), batchSize(batchSize),
+  lifetime(lifetime), baseTime(baseTime), numThreads(std::max(numThreads,1)), allowSIMD(true), numLive(0),
+  posOffset(-1), velOffset(-1), startOffset(-1), ageOffset(-1)
+{
+    if (batchSize <= 0 || totalParticles < batchSize)
+    {
+        wkLogLevel(Warn,"ParticleSystemCPU: Batch size must be smaller than the total number of particles.");
+        return;
+    }
+    if (lifetime <= 0.0)
+    {
+        wkLogLevel(Warn,"ParticleSystemCPU: Need a lifetime for particles.");
+        return;
+    }
+
+    // Find the attributes we know how to simulate
+    const StringIdentity a_velocityNameID = StringIndexer::getStringID("a_velocity");
+    const StringIdentity a_startTimeNameID = StringIndexer::getStringID("a_startTime");
+    const StringIdentity a_ageNameID = StringIndexer::getStringID("a_age");
+    int offset = 0;
+    for (const auto &attr : vertAttrs)
+    {
+        if (attr.nameID == a_PositionNameID && attr.type == BDFloat3Type)
+            posOffset = offset;
+        else if ((attr.nameID == a_dirNameID || attr.nameID == a_velocityNameID) && attr.type == BDFloat3Type)
+            velOffset = offset;
+        else if (attr.nameID == a_startTimeNameID && attr.type == BDFloatType)
+            startOffset = offset;
+        else if (attr.nameID == a_ageNameID && attr.type == BDFloatType)
+            ageOffset = offset;
+        attrSizes.push_back(attr.size());
+        offset += attr.size();
+    }
+    if (offset > vertexSize)
+    {
+        wkLogLevel(Warn,"ParticleSystemCPU: Vertex size is smaller than the attributes.");
+        return;
+    }
+    if (posOffset < 0)
+    {
+        wkLogLevel(Warn,"ParticleSystemCPU: Need a float3 a_position attribute.");
+        return;
+    }
+
+    // Round down to whole batches, like the drawable does
+    const int numBatches = totalParticles / batchSize;
+    this->totalParticles = numBatches * batchSize;
+    batches.resize(numBatches);
+
+    const size_t num = this->totalParticles;
+    posX.resize(num,0.0);  posY.resize(num,0.0);  posZ.resize(num,0.0);
+    velX.resize(num,0.0);  velY.resize(num,0.0);  velZ.resize(num,0.0);
+    startTime.resize(num,0.0);  age.resize(num,0.0);
+    vertexData.resize(num * vertexSize,0);
+
+    valid = true;
+}
+
+ParticleSystemCPU::~ParticleSystemCPU()
+{
+}
+
+void ParticleSystemCPU::setNumThreads(int inNumThreads)
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+    numThreads = std::max(inNumThreads,1);
+}
+
+void ParticleSystemCPU::setAllowSIMD(bool inAllowSIMD)
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+    allowSIMD = inAllowSIMD;
+}
+
+void ParticleSystemCPU::addBatch(unsigned int batchID,const std::vector<const void *> &attrData,TimeInterval inStartTime)
+{
+    if (!valid || batchID >= batches.size())
+        return;
+    if (attrData.size() != attrSizes.size())
+    {
+        wkLogLevel(Warn,"ParticleSystemCPU: Batch doesn't match the vertex attributes.");
+        return;
+    }
+
+    std::lock_guard<std::mutex> guardLock(lock);
+
+    Batch &batch = batches[batchID];
+    batch.active = true;
+    batch.startTime = inStartTime - baseTime;
+    batch.lastTime = batch.startTime;
+
+    // Interleave the attributes, just like the drawable will
+    const int start = batchID * batchSize;
+    unsigned char *vertStart = &vertexData[(size_t)start * vertexSize];
+    int attrOffset = 0;
+    for (unsigned int ai=0;ai<attrData.size();ai++)
+    {
+        const int attrSize = attrSizes[ai];
+        const unsigned char *rawAttrData = (const unsigned char *)attrData[ai];
+        if (rawAttrData)
+        {
+            unsigned char *ptr = vertStart + attrOffset;
+            for (int ii=0;ii<batchSize;ii++)
+            {
+                memcpy(ptr, rawAttrData, attrSize);
+                ptr += vertexSize;
+                rawAttrData += attrSize;
+            }
+        }
+        attrOffset += attrSize;
+    }
+
+    // Then pull out the values we simulate
+    for (int ii=0;ii<batchSize;ii++)
+    {
+        const unsigned char *vert = vertStart + (size_t)ii * vertexSize;
+        const int which = start + ii;
+        float vals[3];
+        memcpy(vals, vert + posOffset, sizeof(vals));
+        posX[which] = vals[0];  posY[which] = vals[1];  posZ[which] = vals[2];
+        if (velOffset >= 0)
+        {
+            memcpy(vals, vert + velOffset, sizeof(vals));
+            velX[which] = vals[0];  velY[which] = vals[1];  velZ[which] = vals[2];
+        } else {
+            velX[which] = 0.0;  velY[which] = 0.0;  velZ[which] = 0.0;
+        }
+        if (startOffset >= 0)
+            memcpy(&startTime[which], vert + startOffset, sizeof(float));
+        else
+            startTime[which] = batch.startTime;
+        age[which] = 0.0;
+    }
+}
+
+void ParticleSystemCPU::writeBatch(int batchID)
+{
+    const int start = batchID * batchSize;
+    unsigned char *vert = &vertexData[(size_t)start * vertexSize];
+    for (int ii=0;ii<batchSize;ii++,vert += vertexSize)
+    {
+        const int which = start + ii;
+        const float pos[3] = {posX[which],posY[which],posZ[which]};
+        memcpy(vert + posOffset, pos, sizeof(pos));
+        if (ageOffset >= 0)
+            memcpy(vert + ageOffset, &age[which], sizeof(float));
+    }
+}
+
+int ParticleSystemCPU::updateBatches(const int *which,int numBatches,float now)
+{
+    const float invLifetime = 1.0 / lifetime;
+    int live = 0;
+    for (int bi=0;bi<numBatches;bi++)
+    {
+        const int batchID = which[bi];
+        Batch &batch = batches[batchID];
+        const int start = batchID * batchSize;
+
+        const float dt = now - batch.lastTime;
+        if (dt > 0.0 && velOffset >= 0)
+        {
+            ParticleIntegrateKernel(&posX[start], &velX[start], dt, batchSize, allowSIMD);
+            ParticleIntegrateKernel(&posY[start], &velY[start], dt, batchSize, allowSIMD);
+            ParticleIntegrateKernel(&posZ[start], &velZ[start], dt, batchSize, allowSIMD);
+        }
+        batch.lastTime = now;
+
+        live += ParticleAgeKernel(&age[start], &startTime[start], now, invLifetime, batchSize, allowSIMD);
+
+        writeBatch(batchID);
+    }
+
+    return live;
+}
+
+int ParticleSystemCPU::update(TimeInterval inNow,const UploadFunc &upload)
+{
+    if (!valid)
+        return 0;
+
+    std::lock_guard<std::mutex> guardLock(lock);
+
+    const float now = inNow - baseTime;
+
+    // Retire old batches the same way the drawable does
+    std::vector<int> active;
+    active.reserve(batches.size());
+    for (unsigned int bi=0;bi<batches.size();bi++)
+    {
+        Batch &batch = batches[bi];
+        if (!batch.active)
+            continue;
+        if (batch.startTime + lifetime < now)
+            batch.active = false;
+        else
+            active.push_back(bi);
+    }
+    if (active.empty())
+    {
+        numLive = 0;
+        return 0;
+    }
+
+    // Split the batches up between the threads
+    int useThreads = std::min(numThreads,(int)(active.size() * batchSize / kMinParticlesPerThread));
+    useThreads = std::max(std::min(useThreads,(int)active.size()),1);
+    std::vector<int> liveCounts(useThreads,0);
+    if (useThreads > 1)
+    {
+        // The workers stick around, so this is a wakeup rather than a thread start
+        if (!workers || workers->getNumThreads() != numThreads)
+            workers = std::make_shared<WorkerPool>(numThreads);
+        const int perThread = (active.size() + useThreads - 1) / useThreads;
+        workers->run(useThreads,[this,&active,&liveCounts,perThread,now](int ti)
+        {
+            const int start = ti * perThread;
+            const int num = std::min(perThread,(int)active.size() - start);
+            if (num > 0)
+                liveCounts[ti] = updateBatches(&active[start], num, now);
+        });
+    } else
+        liveCounts[0] = updateBatches(&active[0], active.size(), now);
+
+    numLive = 0;
+    for (int count : liveCounts)
+        numLive += count;
+
+    // Hand back the data in contiguous runs of batches
+    if (upload)
+    {
+        const int batchBytes = batchSize * vertexSize;
+        for (unsigned int ii=0;ii<active.size();)
+        {
+            unsigned int end = ii+1;
+            for (;end < active.size() && active[end] == active[end-1]+1;end++);
+            const int offset = active[ii] * batchBytes;
+            upload(offset, &vertexData[offset], (end-ii) * batchBytes);
+            ii = end;
+        }
+    }
+
+    return numLive;
+}
+
+}
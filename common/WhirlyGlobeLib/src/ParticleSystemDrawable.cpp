@@ -90,6 +90,9 @@ SimpleIdentity ParticleSystemDrawable::getCalculationProgram() const
 void ParticleSystemDrawable::setCalculationProgram(SimpleIdentity newProgId)
     { calculateProgramId = newProgId; }
 
+void ParticleSystemDrawable::setCPUSimulation(const ParticleSystemCPURef &inCPUSim)
+    { cpuSim = inCPUSim; }
+
 SimpleIdentity ParticleSystemDrawable::getProgram() const
     { return renderProgramId; }
     
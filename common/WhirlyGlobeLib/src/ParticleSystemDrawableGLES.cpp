@@ -431,6 +431,16 @@ void ParticleSystemDrawableGLES::calculate(RendererFrameInfoGLES *frameInfo,Scen
 void ParticleSystemDrawableGLES::draw(RendererFrameInfoGLES *frameInfo,Scene *scene)
 {
     if (lastUpdateTime < frameInfo->currentTime) {
+        // Move the particles ourselves and upload the results
+        if (cpuSim && pointBuffer) {
+            glBindBuffer(GL_ARRAY_BUFFER, pointBuffer);
+            cpuSim->update(frameInfo->currentTime,[](int offset,const void *data,int len)
+                           {
+                               glBufferSubData(GL_ARRAY_BUFFER, offset, len, data);
+                           });
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            CheckGLError("ParticleSystemDrawable::draw() glBufferSubData");
+        }
         updateBatches(frameInfo->currentTime);
         updateChunks();
         lastUpdateTime = frameInfo->currentTime;
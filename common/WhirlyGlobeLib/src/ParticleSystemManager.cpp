@@ -20,6 +20,7 @@
 
 #import "ParticleSystemManager.h"
 #import "ParticleSystemDrawable.h"
+#import "WhirlyKitLog.h"
 
 namespace WhirlyKit
 {
@@ -31,7 +32,8 @@ ParticleSystem::ParticleSystem()
     totalParticles(0), batchSize(0), vertexSize(0),
     continuousUpdate(true),
     zBufferRead(false), zBufferWrite(false),
-    renderTargetID(EmptyIdentity)
+    renderTargetID(EmptyIdentity),
+    cpuCalculation(false), cpuThreads(1)
 {
 }
     
@@ -97,9 +99,27 @@ SimpleIdentity ParticleSystemManager::addParticleSystem(const ParticleSystem &ne
     // Note: There are devices where this won't work
     bool useInstancing = useRectangles;
     int totalParticles = newSystem.totalParticles;
+
+    // Moving the particles on the CPU replaces the calculation shader and its varyings
+    SimpleIdentity calcShaderID = sceneRep->partSys.calcShaderID;
+    std::vector<SingleVertexAttributeInfo> varyingAttrs = sceneRep->partSys.varyingAttrs;
+    if (newSystem.cpuCalculation)
+    {
+        ParticleSystemCPURef cpuSim(new ParticleSystemCPU(newSystem.vertAttrs,newSystem.vertexSize,
+                                                          totalParticles,newSystem.batchSize,
+                                                          newSystem.lifetime,newSystem.baseTime,newSystem.cpuThreads));
+        if (cpuSim->isValid())
+        {
+            sceneRep->cpuSim = cpuSim;
+            calcShaderID = EmptyIdentity;
+            varyingAttrs.clear();
+        } else
+            wkLogLevel(Warn,"ParticleSystemManager: Can't do CPU calculation for particle system %s.  Using the calculation shader.",newSystem.name.c_str());
+    }
+
     ParticleSystemDrawableBuilderRef draw = renderer->makeParticleSystemDrawableBuilder(newSystem.name);
     draw->setup(sceneRep->partSys.vertAttrs,
-                sceneRep->partSys.varyingAttrs,
+                varyingAttrs,
                 totalParticles,
                 sceneRep->partSys.batchSize,
                 newSystem.vertexSize,
@@ -108,7 +128,8 @@ SimpleIdentity ParticleSystemManager::addParticleSystem(const ParticleSystem &ne
     draw->getDrawable()->setOnOff(newSystem.enable);
     draw->getDrawable()->setPointSize(sceneRep->partSys.pointSize);
     draw->getDrawable()->setProgram(sceneRep->partSys.renderShaderID);
-    draw->getDrawable()->setCalculationProgram(sceneRep->partSys.calcShaderID);
+    draw->getDrawable()->setCalculationProgram(calcShaderID);
+    draw->getDrawable()->setCPUSimulation(sceneRep->cpuSim);
     draw->getDrawable()->setDrawPriority(sceneRep->partSys.drawPriority);
     draw->getDrawable()->setBaseTime(newSystem.baseTime);
     draw->getDrawable()->setLifetime(sceneRep->partSys.lifetime);
@@ -187,6 +208,8 @@ void ParticleSystemManager::addParticleBatch(SimpleIdentity sysID,const Particle
                     }
                     // Note: Should pick this up from the batch
                     theBatch.startTime = scene->getCurrentTime();
+                    if (sceneRep->cpuSim)
+                        sceneRep->cpuSim->addBatch(theBatch.batchID,batch.attrData,theBatch.startTime);
                     draw->addAttributeData(renderer->getRenderSetupInfo(),attrData,theBatch);
                 } else {
                     // For Metal, we just pass a block of data through
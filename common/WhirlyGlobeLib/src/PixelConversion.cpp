@@ -0,0 +1,375 @@
+/*
+ *  PixelConversion.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <string.h>
+#import <algorithm>
+#import <functional>
+#import <thread>
+#import <vector>
+#import "PixelConversion.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#import <emmintrin.h>
+#define WK_PIXEL_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#import <arm_neon.h>
+#define WK_PIXEL_NEON 1
+#endif
+
+namespace WhirlyKit
+{
+
+int PixelConversionBytesPerPixel(TextureType format)
+{
+    switch (format)
+    {
+        case TexTypeUnsignedByte:
+            return 4;
+        case TexTypeShort565:
+        case TexTypeShort4444:
+        case TexTypeShort5551:
+        case TexTypeDoubleChannel:
+            return 2;
+        case TexTypeSingleChannel:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+// Scalar versions.  These are also what handles the tail of each run.
+
+static inline uint16_t PixelTo565(uint32_t p)
+{
+    return ((p & 0xF8) << 8) | ((p >> 5) & 0x7E0) | ((p >> 19) & 0x1F);
+}
+
+static inline uint16_t PixelTo4444(uint32_t p)
+{
+    return ((p & 0xF0) << 8) | ((p >> 4) & 0xF00) | ((p >> 16) & 0xF0) | (p >> 28);
+}
+
+static inline uint16_t PixelTo5551(uint32_t p)
+{
+    return ((p & 0xF8) << 8) | ((p >> 5) & 0x7C0) | ((p >> 18) & 0x3E) | (p >> 31);
+}
+
+static inline uint8_t PixelTo8(uint32_t p,WKSingleByteSource source)
+{
+    switch (source)
+    {
+        case WKSingleRed:
+            return p & 0xFF;
+        case WKSingleGreen:
+            return (p >> 8) & 0xFF;
+        case WKSingleBlue:
+            return (p >> 16) & 0xFF;
+        case WKSingleRGB:
+            return ((p & 0xFF) + ((p >> 8) & 0xFF) + ((p >> 16) & 0xFF)) / 3;
+        case WKSingleAlpha:
+        default:
+            return p >> 24;
+    }
+}
+
+// Pixels are read one at a time and written after, so this works in place
+static void ConvertRGBAPixelRunScalar(TextureType format,WKSingleByteSource source,const unsigned char *rgba,unsigned char *out,size_t start,size_t numPixels)
+{
+    for (size_t ii=start;ii<numPixels;ii++)
+    {
+        uint32_t p;
+        memcpy(&p, rgba + 4*ii, 4);
+        uint16_t val16;
+        switch (format)
+        {
+            case TexTypeShort565:
+                val16 = PixelTo565(p);
+                memcpy(out + 2*ii, &val16, 2);
+                break;
+            case TexTypeShort4444:
+                val16 = PixelTo4444(p);
+                memcpy(out + 2*ii, &val16, 2);
+                break;
+            case TexTypeShort5551:
+                val16 = PixelTo5551(p);
+                memcpy(out + 2*ii, &val16, 2);
+                break;
+            case TexTypeDoubleChannel:
+                val16 = p & 0xFFFF;
+                memcpy(out + 2*ii, &val16, 2);
+                break;
+            case TexTypeSingleChannel:
+                out[ii] = PixelTo8(p, source);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+#if defined(WK_PIXEL_SSE)
+
+// Narrow 32 bit lanes holding 16 bit values without the signed saturation getting in the way
+static inline __m128i PixelPack32To16(__m128i a,__m128i b)
+{
+    a = _mm_srai_epi32(_mm_slli_epi32(a,16),16);
+    b = _mm_srai_epi32(_mm_slli_epi32(b,16),16);
+    return _mm_packs_epi32(a,b);
+}
+
+static inline __m128i PixelSSETo16(TextureType format,__m128i p)
+{
+    switch (format)
+    {
+        case TexTypeShort565:
+            return _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(p,_mm_set1_epi32(0xF8)),8),
+                                             _mm_and_si128(_mm_srli_epi32(p,5),_mm_set1_epi32(0x7E0))),
+                                _mm_and_si128(_mm_srli_epi32(p,19),_mm_set1_epi32(0x1F)));
+        case TexTypeShort4444:
+            return _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(p,_mm_set1_epi32(0xF0)),8),
+                                             _mm_and_si128(_mm_srli_epi32(p,4),_mm_set1_epi32(0xF00))),
+                                _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p,16),_mm_set1_epi32(0xF0)),
+                                             _mm_srli_epi32(p,28)));
+        case TexTypeShort5551:
+            return _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(p,_mm_set1_epi32(0xF8)),8),
+                                             _mm_and_si128(_mm_srli_epi32(p,5),_mm_set1_epi32(0x7C0))),
+                                _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p,18),_mm_set1_epi32(0x3E)),
+                                             _mm_srli_epi32(p,31)));
+        case TexTypeDoubleChannel:
+        default:
+            return _mm_and_si128(p,_mm_set1_epi32(0xFFFF));
+    }
+}
+
+// One channel or the RGB sum, in 32 bit lanes
+static inline __m128i PixelSSETo8(WKSingleByteSource source,__m128i p)
+{
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    switch (source)
+    {
+        case WKSingleRed:
+            return _mm_and_si128(p,mask);
+        case WKSingleGreen:
+            return _mm_and_si128(_mm_srli_epi32(p,8),mask);
+        case WKSingleBlue:
+            return _mm_and_si128(_mm_srli_epi32(p,16),mask);
+        case WKSingleRGB:
+            return _mm_add_epi32(_mm_add_epi32(_mm_and_si128(p,mask),_mm_and_si128(_mm_srli_epi32(p,8),mask)),
+                                 _mm_and_si128(_mm_srli_epi32(p,16),mask));
+        case WKSingleAlpha:
+        default:
+            return _mm_srli_epi32(p,24);
+    }
+}
+
+// Sums of up to 765 divided by 3.  (n * 0xAAAB) >> 17 is exact in that range.
+static inline __m128i PixelSSEDiv3(__m128i sum16)
+{
+    return _mm_srli_epi16(_mm_mulhi_epu16(sum16,_mm_set1_epi16((short)0xAAAB)),1);
+}
+
+static size_t ConvertRGBAPixelRunSSE(TextureType format,WKSingleByteSource source,const unsigned char *rgba,unsigned char *out,size_t numPixels)
+{
+    size_t ii = 0;
+    if (format == TexTypeSingleChannel)
+    {
+        // 16 pixels in, 16 bytes out
+        for (;ii+16<=numPixels;ii+=16)
+        {
+            const __m128i p0 = _mm_loadu_si128((const __m128i *)(rgba + 4*ii));
+            const __m128i p1 = _mm_loadu_si128((const __m128i *)(rgba + 4*ii + 16));
+            const __m128i p2 = _mm_loadu_si128((const __m128i *)(rgba + 4*ii + 32));
+            const __m128i p3 = _mm_loadu_si128((const __m128i *)(rgba + 4*ii + 48));
+            __m128i lo = _mm_packs_epi32(PixelSSETo8(source,p0),PixelSSETo8(source,p1));
+            __m128i hi = _mm_packs_epi32(PixelSSETo8(source,p2),PixelSSETo8(source,p3));
+            if (source == WKSingleRGB)
+            {
+                lo = PixelSSEDiv3(lo);
+                hi = PixelSSEDiv3(hi);
+            }
+            _mm_storeu_si128((__m128i *)(out + ii),_mm_packus_epi16(lo,hi));
+        }
+    } else {
+        // 8 pixels in, 16 bytes out
+        for (;ii+8<=numPixels;ii+=8)
+        {
+            const __m128i p0 = _mm_loadu_si128((const __m128i *)(rgba + 4*ii));
+            const __m128i p1 = _mm_loadu_si128((const __m128i *)(rgba + 4*ii + 16));
+            _mm_storeu_si128((__m128i *)(out + 2*ii),PixelPack32To16(PixelSSETo16(format,p0),PixelSSETo16(format,p1)));
+        }
+    }
+
+    return ii;
+}
+
+#elif defined(WK_PIXEL_NEON)
+
+static inline uint16x8_t PixelNEONTo16(TextureType format,uint8x8_t r,uint8x8_t g,uint8x8_t b,uint8x8_t a)
+{
+    switch (format)
+    {
+        case TexTypeShort565:
+            return vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(r,3)),11),
+                                       vshlq_n_u16(vmovl_u8(vshr_n_u8(g,2)),5)),
+                             vmovl_u8(vshr_n_u8(b,3)));
+        case TexTypeShort4444:
+            return vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(r,4)),12),
+                                       vshlq_n_u16(vmovl_u8(vshr_n_u8(g,4)),8)),
+                             vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(b,4)),4),
+                                       vmovl_u8(vshr_n_u8(a,4))));
+        case TexTypeShort5551:
+        default:
+            return vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(r,3)),11),
+                                       vshlq_n_u16(vmovl_u8(vshr_n_u8(g,3)),6)),
+                             vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(b,3)),1),
+                                       vmovl_u8(vshr_n_u8(a,7))));
+    }
+}
+
+// Sums of up to 765 divided by 3.  (n * 0xAAAB) >> 17 is exact in that range.
+static inline uint8x8_t PixelNEONDiv3(uint16x8_t sum)
+{
+    const uint16x4_t k = vdup_n_u16(0xAAAB);
+    const uint16x8_t q = vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(sum),k),16),
+                                      vshrn_n_u32(vmull_u16(vget_high_u16(sum),k),16));
+    return vmovn_u16(vshrq_n_u16(q,1));
+}
+
+static size_t ConvertRGBAPixelRunNEON(TextureType format,WKSingleByteSource source,const unsigned char *rgba,unsigned char *out,size_t numPixels)
+{
+    size_t ii = 0;
+    // 16 pixels at a time, split out by channel
+    for (;ii+16<=numPixels;ii+=16)
+    {
+        const uint8x16x4_t px = vld4q_u8(rgba + 4*ii);
+        switch (format)
+        {
+            case TexTypeShort565:
+            case TexTypeShort4444:
+            case TexTypeShort5551:
+                vst1q_u16((uint16_t *)(out + 2*ii),PixelNEONTo16(format,vget_low_u8(px.val[0]),vget_low_u8(px.val[1]),vget_low_u8(px.val[2]),vget_low_u8(px.val[3])));
+                vst1q_u16((uint16_t *)(out + 2*ii + 16),PixelNEONTo16(format,vget_high_u8(px.val[0]),vget_high_u8(px.val[1]),vget_high_u8(px.val[2]),vget_high_u8(px.val[3])));
+                break;
+            case TexTypeDoubleChannel:
+            {
+                uint8x16x2_t rg;
+                rg.val[0] = px.val[0];
+                rg.val[1] = px.val[1];
+                vst2q_u8(out + 2*ii,rg);
+            }
+                break;
+            case TexTypeSingleChannel:
+            default:
+                switch (source)
+                {
+                    case WKSingleRed:
+                        vst1q_u8(out + ii,px.val[0]);
+                        break;
+                    case WKSingleGreen:
+                        vst1q_u8(out + ii,px.val[1]);
+                        break;
+                    case WKSingleBlue:
+                        vst1q_u8(out + ii,px.val[2]);
+                        break;
+                    case WKSingleRGB:
+                    {
+                        const uint16x8_t sumLo = vaddw_u8(vaddl_u8(vget_low_u8(px.val[0]),vget_low_u8(px.val[1])),vget_low_u8(px.val[2]));
+                        const uint16x8_t sumHi = vaddw_u8(vaddl_u8(vget_high_u8(px.val[0]),vget_high_u8(px.val[1])),vget_high_u8(px.val[2]));
+                        vst1q_u8(out + ii,vcombine_u8(PixelNEONDiv3(sumLo),PixelNEONDiv3(sumHi)));
+                    }
+                        break;
+                    case WKSingleAlpha:
+                    default:
+                        vst1q_u8(out + ii,px.val[3]);
+                        break;
+                }
+                break;
+        }
+    }
+
+    return ii;
+}
+
+#endif
+
+void ConvertRGBAPixelRun(TextureType format,WKSingleByteSource source,const unsigned char *rgba,unsigned char *out,size_t numPixels,bool allowSIMD)
+{
+    if (format == TexTypeUnsignedByte)
+    {
+        if (out != rgba)
+            memmove(out, rgba, 4*numPixels);
+        return;
+    }
+
+    size_t done = 0;
+    if (allowSIMD)
+    {
+#if defined(WK_PIXEL_SSE)
+        done = ConvertRGBAPixelRunSSE(format, source, rgba, out, numPixels);
+#elif defined(WK_PIXEL_NEON)
+        done = ConvertRGBAPixelRunNEON(format, source, rgba, out, numPixels);
+#endif
+    }
+    ConvertRGBAPixelRunScalar(format, source, rgba, out, done, numPixels);
+}
+
+bool ConvertRGBAPixels(TextureType format,WKSingleByteSource source,const unsigned char *rgba,int width,int height,unsigned char *out,int outRowBytes,int numThreads)
+{
+    const int bytesPerPixel = PixelConversionBytesPerPixel(format);
+    if (bytesPerPixel == 0 || width <= 0 || height <= 0 || outRowBytes < width*bytesPerPixel)
+        return false;
+    // In place, each row has to land at or before where it started
+    const bool inPlace = out == rgba;
+    if (inPlace && outRowBytes > 4*width)
+        return false;
+    if (inPlace)
+        numThreads = 1;
+
+    const int padBytes = outRowBytes - width*bytesPerPixel;
+    auto convertRows = [&](int startY,int endY)
+    {
+        for (int y=startY;y<endY;y++)
+        {
+            unsigned char *outRow = out + (size_t)y*outRowBytes;
+            ConvertRGBAPixelRun(format, source, rgba + (size_t)y*width*4, outRow, width);
+            if (padBytes > 0)
+                memset(outRow + width*bytesPerPixel, 0, padBytes);
+        }
+    };
+
+    // Bands of rows, one per thread
+    numThreads = std::max(1,std::min(numThreads,height));
+    if (numThreads == 1)
+    {
+        convertRows(0,height);
+        return true;
+    }
+    const int band = (height + numThreads - 1) / numThreads;
+    std::vector<std::thread> threads;
+    for (int startY = band;startY < height;startY += band)
+        threads.emplace_back(convertRows,startY,std::min(startY+band,height));
+    convertRows(0,std::min(band,height));
+    for (auto &thread : threads)
+        thread.join();
+
+    return true;
+}
+
+}
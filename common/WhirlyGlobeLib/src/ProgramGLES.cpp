@@ -62,8 +62,7 @@ bool ProgramGLES::setUniform(StringIdentity nameID,float val)
 
 bool ProgramGLES::setUniform(StringIdentity nameID,float val,int index)
 {
-    std::string name = StringIndexer::getString(nameID) + "[0]";
-    OpenGLESUniform *uni = findUniform(StringIndexer::getStringID(name));
+    OpenGLESUniform *uni = findUniform(StringIndexer::getIndexedStringID(nameID));
     if (!uni)
         return false;
 
@@ -182,8 +181,7 @@ bool ProgramGLES::setUniform(StringIdentity nameID,const Eigen::Vector4f &vec)
 
 bool ProgramGLES::setUniform(StringIdentity nameID,const Eigen::Vector4f &vec,int index)
 {
-    std::string name = StringIndexer::getString(nameID) + "[0]";
-    OpenGLESUniform *uni = findUniform(StringIndexer::getStringID(name));
+    OpenGLESUniform *uni = findUniform(StringIndexer::getIndexedStringID(nameID));
     if (!uni)
         return false;
     
@@ -20,6 +20,7 @@
 
 #import "QuadImageFrameLoader.h"
 #import "WhirlyKitLog.h"
+#import "FrameTrace.h"
 
 namespace WhirlyKit
 {
@@ -685,7 +686,7 @@ QuadImageFrameLoader::QuadImageFrameLoader(const SamplingParams &params,Mode mod
 : mode(mode), loadMode(Narrow), debugMode(false),
     params(params),
     requiringTopTilesLoaded(true),
-    texType(TexTypeUnsignedByte), flipY(true),
+    texType(TexTypeUnsignedByte), compressTextures(false), compressQuality(ETC2QualityFast), mipmapTextures(false), mipmapSRGB(false), flipY(true),
     baseDrawPriority(100), drawPriorityPerLevel(1),
     colorChanged(false),
     color(RGBAColor(255,255,255,255)),
@@ -694,7 +695,7 @@ QuadImageFrameLoader::QuadImageFrameLoader(const SamplingParams &params,Mode mod
     compManager(NULL),
     generation(0),
     targetLevel(-1), curOvlLevel(-1),
-    lastRunReqFlag(NULL), loadingStatus(true)
+    lastRunReqFlag(NULL), loadingStatus(true), numTilesLoading(0)
 {
     lastRunReqFlag = new bool();
     *lastRunReqFlag = true;
@@ -729,6 +730,7 @@ QuadImageFrameLoader::Mode QuadImageFrameLoader::getMode()
     
 QuadImageFrameLoader::~QuadImageFrameLoader()
 {
+    FrameTrace::addCount(TraceTilesLoading, -numTilesLoading);
 }
     
 void QuadImageFrameLoader::setSamplingParams(const SamplingParams &inParams)
@@ -875,6 +877,49 @@ void QuadImageFrameLoader::setTexType(TextureType inTexType)
 {
     texType = inTexType;
 }
+
+void QuadImageFrameLoader::setTextureCompression(bool compress,ETC2Quality quality)
+{
+    compressTextures = compress;
+    compressQuality = quality;
+}
+
+void QuadImageFrameLoader::setTextureMipmaps(bool mipmaps,bool sRGB)
+{
+    mipmapTextures = mipmaps;
+    mipmapSRGB = sRGB;
+}
+
+void QuadImageFrameLoader::prepareLoadedImages(QuadLoaderReturn *loadReturn)
+{
+    if (!loadReturn || loadReturn->hasError)
+        return;
+    // Data formats stay as they are
+    const bool canCompress = compressTextures &&
+        (texType == TexTypeUnsignedByte || texType == TexTypeShort565 ||
+         texType == TexTypeShort4444 || texType == TexTypeShort5551);
+    if (!canCompress && !mipmapTextures)
+        return;
+
+    FrameTraceScope traceScope(TraceTexturePrepare);
+
+    // The texture sticks around in the image until we merge
+    for (auto image : loadReturn->images)
+        if (image)
+        {
+            Texture *tex = image->prebuildTexture();
+            if (!tex)
+                continue;
+            if (canCompress && tex->compressETC2(compressQuality))
+                continue;
+            if (mipmapTextures)
+            {
+                // Levels are converted as they're built, so the format has to be set now
+                tex->setFormat(texType);
+                tex->buildMipmaps(mipmapSRGB);
+            }
+        }
+}
     
 void QuadImageFrameLoader::setBaseDrawPriority(int newPrior)
 {
@@ -1002,6 +1047,8 @@ void QuadImageFrameLoader::removeTile(PlatformThreadInfo *threadInfo,const QuadT
     
 void QuadImageFrameLoader::mergeLoadedTile(PlatformThreadInfo *threadInfo,QuadLoaderReturn *loadReturn,ChangeSet &changes)
 {
+    FrameTraceScope traceScope(TraceLoaderMerge);
+
     changesSinceLastFlush = true;
 
     bool failed = false;
@@ -1361,6 +1408,8 @@ void QuadImageFrameLoader::builderLoad(PlatformThreadInfo *threadInfo,
     if (!this->builder)
         return;
     
+    FrameTraceScope traceScope(TraceLoaderBuild);
+
     // Only handling loads and unloads for now
     if (updates.loadTiles.empty() && updates.unloadTiles.empty())
         return;
@@ -1425,6 +1474,13 @@ void QuadImageFrameLoader::updateLoadingStatus()
             numTilesLoading++;
         }
     this->loadingStatus = numTilesLoading != 0;
+
+    // The counter is shared between loaders, so we report the difference
+    if (numTilesLoading != this->numTilesLoading)
+    {
+        FrameTrace::addCount(TraceTilesLoading, numTilesLoading - this->numTilesLoading);
+        this->numTilesLoading = numTilesLoading;
+    }
 }
 
 /// Called right before the layer thread flushes all its current changes
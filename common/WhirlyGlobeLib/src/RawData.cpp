@@ -43,8 +43,9 @@ RawDataWrapper::RawDataWrapper(const void *inData,unsigned long dataLen,bool fre
 
 RawDataWrapper::~RawDataWrapper()
 {
+    // Everyone hands us malloc'ed memory
     if (freeWhenDone)
-        delete data;
+        free((void *)data);
     data = NULL;
 }
 
@@ -137,6 +138,18 @@ unsigned long MutableRawData::getLen() const
     return data.size();
 }
 
+unsigned char *MutableRawData::getMutableRawData()
+{
+    if (data.empty())
+        return NULL;
+    return &data[0];
+}
+
+void MutableRawData::resize(unsigned long size)
+{
+    data.resize(size);
+}
+
 void MutableRawData::addInt(int iVal)
 {
     size_t len = sizeof(int);
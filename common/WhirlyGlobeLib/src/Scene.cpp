@@ -46,7 +46,7 @@ namespace WhirlyKit
 {
     
 Scene::Scene(CoordSystemDisplayAdapter *adapter)
-    : fontTextureManager(NULL), setupInfo(NULL), currentTime(0.0)
+    : fontTextureManager(NULL), setupInfo(NULL), currentTime(0.0), prepareShutdown(false), numPreparedAhead(0), numPreparedInline(0)
 {
     SetupDrawableStrings();
     
@@ -88,6 +88,9 @@ Scene::~Scene()
 {
 //    wkLogLevel(Verbose,"Shutting down scene");
     
+    // Workers might be looking at the change requests
+    stopPrepareThreads();
+    
     textures.clear();
     
     for (std::map<std::string,SceneManager *>::iterator it = managers.begin();
@@ -126,6 +129,8 @@ void Scene::setDisplayAdapter(CoordSystemDisplayAdapter *newCoordAdapter)
 // Add change requests to our list
 void Scene::addChangeRequests(const ChangeSet &newChanges)
 {
+    queuePrepare(newChanges);
+    
     std::lock_guard<std::mutex> guardLock(changeRequestLock);
     
     for (ChangeRequest *change : newChanges)
@@ -140,6 +145,9 @@ void Scene::addChangeRequests(const ChangeSet &newChanges)
 // Add a single change request
 void Scene::addChangeRequest(ChangeRequest *newChange)
 {
+    if (newChange)
+        queuePrepare(ChangeSet{newChange});
+    
     std::lock_guard<std::mutex> guardLock(changeRequestLock);
 
     if (newChange && newChange->when > 0.0)
@@ -284,6 +292,7 @@ int Scene::preProcessChanges(WhirlyKit::View *view,SceneRenderer *renderer,TimeI
 
     // Run these outside of the lock, since they might use the lock
     for (auto req : preRequests) {
+        prepareChange(req);
         req->execute(this,renderer,view);
         delete req;
     }
@@ -315,6 +324,7 @@ int Scene::processChanges(WhirlyKit::View *view,SceneRenderer *renderer,TimeInte
     {
         ChangeRequest *req = changeRequests[ii];
         if (req) {
+            prepareChange(req);
             req->execute(this,renderer,view);
             delete req;
         }
@@ -324,6 +334,131 @@ int Scene::processChanges(WhirlyKit::View *view,SceneRenderer *renderer,TimeInte
     
     return numChanges;
 }
+
+void Scene::setPrepareThreads(int numThreads)
+{
+    stopPrepareThreads();
+    
+    prepareShutdown = false;
+    for (int ii=0;ii<numThreads;ii++)
+        prepareThreads.push_back(std::thread(&Scene::prepareThreadMain,this));
+}
+
+void Scene::stopPrepareThreads()
+{
+    {
+        std::lock_guard<std::mutex> guardLock(prepareLock);
+        prepareShutdown = true;
+    }
+    prepareCond.notify_all();
+    for (auto &thread : prepareThreads)
+        thread.join();
+    prepareThreads.clear();
+    
+    // Anything left in the queue gets done on the render thread
+}
+
+void Scene::getPrepareStats(int &numAhead,int &numInline,bool reset)
+{
+    std::lock_guard<std::mutex> guardLock(prepareLock);
+    numAhead = numPreparedAhead;
+    numInline = numPreparedInline;
+    if (reset)
+        numPreparedAhead = numPreparedInline = 0;
+}
+
+void Scene::queuePrepare(const ChangeSet &changes)
+{
+    if (prepareThreads.empty())
+        return;
+    
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> guardLock(prepareLock);
+        for (ChangeRequest *req : changes)
+            if (req && req->prepareState == ChangeRequest::PrepareNone && req->needsPrepare())
+            {
+                req->prepareState = ChangeRequest::PrepareQueued;
+                prepareQueue.push_back(req);
+                queued = true;
+            }
+    }
+    if (queued)
+        prepareCond.notify_all();
+}
+
+void Scene::prepareChange(ChangeRequest *req)
+{
+    // Nobody else can be looking at it
+    if (prepareThreads.empty() && req->prepareState == ChangeRequest::PrepareNone)
+    {
+        if (req->needsPrepare())
+        {
+            req->prepare(this,setupInfo);
+            req->prepareState = ChangeRequest::PrepareDone;
+            numPreparedInline++;
+        }
+        return;
+    }
+    
+    {
+        std::unique_lock<std::mutex> guardLock(prepareLock);
+        switch (req->prepareState)
+        {
+            case ChangeRequest::PrepareDone:
+                return;
+            case ChangeRequest::PrepareRunning:
+                // A worker has it, which should be quick
+                prepareDoneCond.wait(guardLock,[req]{ return req->prepareState == ChangeRequest::PrepareDone; });
+                return;
+            case ChangeRequest::PrepareQueued:
+            {
+                // We got here first, so take it back.  Changes run in order, so it's usually at the front.
+                auto it = std::find(prepareQueue.begin(),prepareQueue.end(),req);
+                if (it != prepareQueue.end())
+                    prepareQueue.erase(it);
+            }
+                break;
+            case ChangeRequest::PrepareNone:
+                if (!req->needsPrepare())
+                    return;
+                break;
+        }
+        req->prepareState = ChangeRequest::PrepareRunning;
+        numPreparedInline++;
+    }
+    
+    req->prepare(this,setupInfo);
+    
+    std::lock_guard<std::mutex> guardLock(prepareLock);
+    req->prepareState = ChangeRequest::PrepareDone;
+}
+
+void Scene::prepareThreadMain()
+{
+    while (true)
+    {
+        ChangeRequest *req = NULL;
+        {
+            std::unique_lock<std::mutex> guardLock(prepareLock);
+            prepareCond.wait(guardLock,[this]{ return prepareShutdown || !prepareQueue.empty(); });
+            if (prepareShutdown)
+                return;
+            req = prepareQueue.front();
+            prepareQueue.pop_front();
+            req->prepareState = ChangeRequest::PrepareRunning;
+        }
+        
+        req->prepare(this,setupInfo);
+        
+        {
+            std::lock_guard<std::mutex> guardLock(prepareLock);
+            req->prepareState = ChangeRequest::PrepareDone;
+            numPreparedAhead++;
+        }
+        prepareDoneCond.notify_all();
+    }
+}
     
 bool Scene::hasChanges(TimeInterval now)
 {
@@ -407,6 +542,7 @@ SubTexture Scene::getSubTexture(SimpleIdentity subTexId)
 void Scene::addDrawable(DrawableRef draw)
 {
     drawables[draw->getId()] = draw;
+    visibilityIndex.addDrawable(draw);
 }
     
 void Scene::remDrawable(DrawableRef draw)
@@ -414,6 +550,17 @@ void Scene::remDrawable(DrawableRef draw)
     auto it = drawables.find(draw->getId());
     if (it != drawables.end())
         drawables.erase(it);
+    visibilityIndex.removeDrawable(draw->getId());
+}
+
+void Scene::updateDrawable(DrawableRef draw)
+{
+    visibilityIndex.updateDrawable(draw);
+}
+
+void Scene::findVisibleDrawables(double height,TimeInterval now,std::vector<DrawableRef> &draws)
+{
+    visibilityIndex.findDrawables(height, now, draws);
 }
     
 void Scene::dumpStats()
@@ -485,6 +632,16 @@ void AddTextureReq::setupForRenderer(const RenderSetupInfo *setupInfo)
     if (texRef)
         texRef->createInRenderer(setupInfo);
 }
+
+bool AddTextureReq::needsPrepare()
+{
+    return texRef.get() != NULL;
+}
+
+void AddTextureReq::prepare(Scene *scene,const RenderSetupInfo *setupInfo)
+{
+    texRef->prepareForRenderer(setupInfo);
+}
     
 TextureBase *AddTextureReq::getTex()
 {
@@ -522,6 +679,16 @@ void AddDrawableReq::setupForRenderer(const RenderSetupInfo *setupInfo)
         drawRef->setupForRenderer(setupInfo);
 }
 
+bool AddDrawableReq::needsPrepare()
+{
+    return drawRef.get() != NULL;
+}
+
+void AddDrawableReq::prepare(Scene *scene,const RenderSetupInfo *setupInfo)
+{
+    drawRef->prepareForRenderer(setupInfo);
+}
+
 AddDrawableReq::~AddDrawableReq()
 {
     drawRef = NULL;
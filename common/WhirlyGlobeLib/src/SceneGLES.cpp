@@ -53,11 +53,13 @@ void SceneGLES::teardown()
     for (auto it : drawables)
         it.second->teardownForRenderer(setupInfo,this);
     drawables.clear();
+    visibilityIndex.clear();
     for (auto it : textures) {
         it.second->destroyInRenderer(setupInfo,this);
     }
     textures.clear();
     
+    memManager.clearSubBuffers();
     memManager.clearBufferIDs();
     memManager.clearTextureIDs();
 }
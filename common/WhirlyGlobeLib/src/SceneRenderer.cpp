@@ -232,9 +232,15 @@ void SceneRenderer::removeDrawable(DrawableRef draw,bool teardown)
 
 void SceneRenderer::updateWorkGroups(RendererFrameInfo *frameInfo)
 {
-    // Look at drawables to move into the active set
+    // Look at drawables to move into the active set.
+    // Only the ones that could be on at this height and time are worth asking.
+    std::vector<DrawableRef> visibleDrawables;
+    if (scene)
+        scene->findVisibleDrawables(frameInfo->heightAboveSurface, frameInfo->currentTime, visibleDrawables);
     std::vector<DrawableRef> drawsToMoveIn;
-    for (auto draw : offDrawables) {
+    for (auto draw : visibleDrawables) {
+        if (offDrawables.find(draw) == offDrawables.end())
+            continue;
         if (draw->isOn(frameInfo)) {
             bool keep = false;
             // If there's a render target, we need that too
@@ -31,6 +31,7 @@
 #import "DynamicTextureAtlasGLES.h"
 #import "MaplyView.h"
 #import "WhirlyKitLog.h"
+#import "FrameTrace.h"
 
 using namespace Eigen;
 using namespace WhirlyKit;
@@ -83,6 +84,9 @@ bool SceneRendererGLES::setup(int apiVersion,int sizeX,int sizeY,float inScale)
     
     setupInfo.glesVersion = apiVersion;
     
+    // Setup happens on the thread we'll render on.  The name sticks if tracing starts later.
+    FrameTrace::setThreadName("Render");
+
     // We need a texture to draw to in this case
     if (framebufferWidth > 0)
     {
@@ -228,9 +232,13 @@ void SceneRendererGLES::render(TimeInterval duration)
     if (perfInterval > 0)
         perfTimer.startTiming("Render Frame");
     
+    FrameTrace::begin(TraceRenderFrame);
+    
     if (perfInterval > 0)
         perfTimer.startTiming("Render Setup");
     
+    FrameTrace::begin(TraceRenderSetup);
+    
     //    if (!renderSetup)
     {
         // Turn on blending
@@ -291,6 +299,8 @@ void SceneRendererGLES::render(TimeInterval duration)
     if (perfInterval > 0)
         perfTimer.stopTiming("Render Setup");
     
+    FrameTrace::end(TraceRenderSetup);
+    
     if (scene)
     {
         int numDrawables = 0;
@@ -341,6 +351,8 @@ void SceneRendererGLES::render(TimeInterval duration)
         if (perfInterval > 0)
             perfTimer.startTiming("Scene preprocessing");
         
+        FrameTrace::begin(TraceScenePreprocess);
+        
         // Run the preprocess for the changes.  These modify things the active models need.
         int numPreProcessChanges = scene->preProcessChanges(theView, this, now);
         
@@ -350,9 +362,13 @@ void SceneRendererGLES::render(TimeInterval duration)
         if (perfInterval > 0)
             perfTimer.stopTiming("Scene preprocessing");
         
+        FrameTrace::end(TraceScenePreprocess);
+        
         if (perfInterval > 0)
             perfTimer.startTiming("Active Model Runs");
         
+        FrameTrace::begin(TraceActiveModels);
+        
         // Let the active models to their thing
         // That thing had better not take too long
         for (auto activeModel : scene->activeModels) {
@@ -365,28 +381,39 @@ void SceneRendererGLES::render(TimeInterval duration)
         if (perfInterval > 0)
             perfTimer.stopTiming("Active Model Runs");
         
+        FrameTrace::end(TraceActiveModels);
+        
         if (perfInterval > 0)
             perfTimer.addCount("Scene changes", (int)scene->changeRequests.size());
+        FrameTrace::setCount(TraceChangeQueue, scene->changeRequests.size());
         
         if (perfInterval > 0)
             perfTimer.startTiming("Scene processing");
         
+        FrameTrace::begin(TraceSceneChanges);
+        
         // Merge any outstanding changes into the scenegraph
         scene->processChanges(theView,this,now);
         
         if (perfInterval > 0)
             perfTimer.stopTiming("Scene processing");
         
+        FrameTrace::end(TraceSceneChanges);
+        
+        // Only the drawables that could be on at this height and time
+        std::vector<DrawableRef> visibleDrawables;
+        scene->findVisibleDrawables(baseFrameInfo.heightAboveSurface, baseFrameInfo.currentTime, visibleDrawables);
+
         // Work through the available offset matrices (only 1 if we're not wrapping)
-        std::vector<Matrix4d> &offsetMats = baseFrameInfo.offsetMatrices;
+        Matrix4dVector &offsetMats = baseFrameInfo.offsetMatrices;
         // Turn these drawables in to a vector
         std::vector<DrawableContainer> drawList;
         std::vector<DrawableRef> screenDrawables;
         std::vector<DrawableRef> generatedDrawables;
-        std::vector<Matrix4d> mvpMats;
-        std::vector<Matrix4d> mvpInvMats;
-        std::vector<Matrix4f> mvpMats4f;
-        std::vector<Matrix4f> mvpInvMats4f;
+        Matrix4dVector mvpMats;
+        Matrix4dVector mvpInvMats;
+        Matrix4fVector mvpMats4f;
+        Matrix4fVector mvpInvMats4f;
         mvpMats.resize(offsetMats.size());
         mvpInvMats.resize(offsetMats.size());
         mvpMats4f.resize(offsetMats.size());
@@ -417,10 +444,9 @@ void SceneRendererGLES::render(TimeInterval duration)
             offFrameInfo.pvMat = pvMat4f;
             offFrameInfo.pvMat4d = pvMat;
             
-            const DrawableRefSet &rawDrawables = scene->getDrawables();
-            for (auto it : rawDrawables)
+            for (const DrawableRef &draw : visibleDrawables)
             {
-                DrawableGLESRef theDrawable = std::dynamic_pointer_cast<DrawableGLES>(it.second);
+                DrawableGLES *theDrawable = dynamic_cast<DrawableGLES *>(draw.get());
                 if (theDrawable->isOn(&offFrameInfo))
                 {
                     const Matrix4d *localMat = theDrawable->getMatrix();
@@ -429,9 +455,9 @@ void SceneRendererGLES::render(TimeInterval duration)
                         Eigen::Matrix4d newMvpMat = thisMvpMat * (*localMat);
                         Eigen::Matrix4d newMvMat = modelAndViewMat4d * (*localMat);
                         Eigen::Matrix4d newMvNormalMat = newMvMat.inverse().transpose();
-                        drawList.push_back(DrawableContainer(theDrawable.get(),newMvpMat,newMvMat,newMvNormalMat));
+                        drawList.push_back(DrawableContainer(theDrawable,newMvpMat,newMvMat,newMvNormalMat));
                     } else
-                        drawList.push_back(DrawableContainer(theDrawable.get(),thisMvpMat,modelAndViewMat4d,modelAndViewNormalMat4d));
+                        drawList.push_back(DrawableContainer(theDrawable,thisMvpMat,modelAndViewMat4d,modelAndViewNormalMat4d));
                 }
             }
         }
@@ -443,6 +469,8 @@ void SceneRendererGLES::render(TimeInterval duration)
         if (perfInterval > 0)
             perfTimer.startTiming("Calculation Shaders");
         
+        FrameTrace::begin(TraceCalcShaders);
+        
         // Run any calculation shaders
         // These should be independent of screen space, so we only run them once and ignore offsets.
         if (!calcPassDone) {
@@ -491,9 +519,13 @@ void SceneRendererGLES::render(TimeInterval duration)
         if (perfInterval > 0)
             perfTimer.stopTiming("Calculation Shaders");
         
+        FrameTrace::end(TraceCalcShaders);
+        
         if (perfInterval > 0)
             perfTimer.startTiming("Draw Execution");
         
+        FrameTrace::begin(TraceDrawExecution);
+        
         SimpleIdentity curProgramId = EmptyIdentity;
         
         // Iterate through rendering targets here
@@ -595,10 +627,13 @@ void SceneRendererGLES::render(TimeInterval duration)
         
         if (perfInterval > 0)
             perfTimer.addCount("Drawables drawn", numDrawables);
+        FrameTrace::setCount(TraceDrawablesDrawn, numDrawables);
         
         if (perfInterval > 0)
             perfTimer.stopTiming("Draw Execution");
         
+        FrameTrace::end(TraceDrawExecution);
+        
         // Anything generated needs to be cleaned up
         generatedDrawables.clear();
         drawList.clear();
@@ -615,6 +650,8 @@ void SceneRendererGLES::render(TimeInterval duration)
     
     if (perfInterval > 0)
         perfTimer.startTiming("Present Renderbuffer");
+    
+    FrameTrace::begin(TracePresent);
 
 #ifndef __ANDROID__
     // Explicitly discard the depth buffer
@@ -632,9 +669,13 @@ void SceneRendererGLES::render(TimeInterval duration)
     if (perfInterval > 0)
         perfTimer.stopTiming("Present Renderbuffer");
     
+    FrameTrace::end(TracePresent);
+    
     if (perfInterval > 0)
         perfTimer.stopTiming("Render Frame");
     
+    FrameTrace::end(TraceRenderFrame);
+    
     // Update the frames per sec
     if (perfInterval > 0 && frameCount > perfInterval)
     {
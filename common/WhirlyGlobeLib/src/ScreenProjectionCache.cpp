@@ -0,0 +1,224 @@
+/*
+ *  ScreenProjectionCache.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <thread>
+#import "ScreenProjectionCache.h"
+
+using namespace Eigen;
+
+namespace WhirlyKit
+{
+
+// Don't bother splitting across threads for fewer than this many points per thread
+static const size_t MinPointsPerThread = 4096;
+
+// Everything the projection kernel needs for a single offset matrix
+typedef struct
+{
+    // Full and full normal matrices, column major
+    double mat[16],normMat[16];
+    double nearPlane;
+    double llX,llY,spanX,spanY;
+    double frameX,frameY;
+} ProjectionParams;
+
+// Project a run of world points to the screen.
+// This mirrors ViewState::pointOnScreenFromDisplay, but is written as a straight
+//  run through the arrays with no branches so the compiler can vectorize it.
+static void ProjectPointsKernel(const ProjectionParams &params,
+                                const double * __restrict x,const double * __restrict y,const double * __restrict z,
+                                float * __restrict outX,float * __restrict outY,
+                                size_t start,size_t end)
+{
+    const double *m = params.mat;
+    for (size_t ii=start;ii<end;ii++)
+    {
+        const double px = x[ii], py = y[ii], pz = z[ii];
+        const double sx = m[0]*px + m[4]*py + m[8]*pz + m[12];
+        const double sy = m[1]*px + m[5]*py + m[9]*pz + m[13];
+        const double sz = m[2]*px + m[6]*py + m[10]*pz + m[14];
+        const double sw = m[3]*px + m[7]*py + m[11]*pz + m[15];
+
+        // Intersection with near gives us the same plane as the screen
+        const double rz = sz / sw;
+        const double scale = -params.nearPlane / rz;
+        const double rayX = sx / sw * scale;
+        const double rayY = sy / sw * scale;
+        const double rayZ = rz * scale;
+
+        // Now scale that to the frame
+        const double u = (rayX - params.llX) / params.spanX;
+        const double v = 1.0 - (rayY - params.llY) / params.spanY;
+
+        const bool valid = rayZ < 0.0;
+        outX[ii] = valid ? (float)(u * params.frameX) : -100000.0f;
+        outY[ii] = valid ? (float)(v * params.frameY) : -100000.0f;
+    }
+}
+
+// Globe back facing test for a run of world points.  Same logic as CheckPointAndNormFacing.
+static void FacingKernel(const ProjectionParams &params,
+                         const double * __restrict x,const double * __restrict y,const double * __restrict z,
+                         unsigned char * __restrict outFacing,
+                         size_t start,size_t end)
+{
+    const double *m = params.mat;
+    const double *n = params.normMat;
+    for (size_t ii=start;ii<end;ii++)
+    {
+        const double px = x[ii], py = y[ii], pz = z[ii];
+        const double sx = m[0]*px + m[4]*py + m[8]*pz + m[12];
+        const double sy = m[1]*px + m[5]*py + m[9]*pz + m[13];
+        const double sz = m[2]*px + m[6]*py + m[10]*pz + m[14];
+        const double sw = m[3]*px + m[7]*py + m[11]*pz + m[15];
+
+        // The normal on the globe is just the normalized location
+        const double len = sqrt(px*px + py*py + pz*pz);
+        const double invLen = len > 0.0 ? 1.0/len : 0.0;
+        const double nx = px*invLen, ny = py*invLen, nz = pz*invLen;
+        const double tx = n[0]*nx + n[4]*ny + n[8]*nz;
+        const double ty = n[1]*nx + n[5]*ny + n[9]*nz;
+        const double tz = n[2]*nx + n[6]*ny + n[10]*nz;
+
+        const double dot = -(sx*tx + sy*ty + sz*tz) / sw;
+        outFacing[ii] = dot >= 0.0;
+    }
+}
+
+ScreenProjectionCache::ScreenProjectionCache()
+: frameSize(0,0), numOffsets(0), projected(false), maxThreads(4)
+{
+}
+
+void ScreenProjectionCache::clear()
+{
+    worldX.clear();  worldY.clear();  worldZ.clear();
+    screenX.clear();  screenY.clear();
+    facing.clear();
+    viewState.reset();
+    numOffsets = 0;
+    projected = false;
+}
+
+void ScreenProjectionCache::reserve(size_t num)
+{
+    worldX.reserve(num);  worldY.reserve(num);  worldZ.reserve(num);
+}
+
+int ScreenProjectionCache::addWorldLoc(const Point3d &worldLoc)
+{
+    worldX.push_back(worldLoc.x());
+    worldY.push_back(worldLoc.y());
+    worldZ.push_back(worldLoc.z());
+    projected = false;
+
+    return (int)(worldX.size()-1);
+}
+
+bool ScreenProjectionCache::isProjectedFor(const ViewState *inViewState,const Point2f &inFrameSize) const
+{
+    return projected && viewState.get() == inViewState && frameSize == inFrameSize;
+}
+
+void ScreenProjectionCache::setMaxThreads(int inMaxThreads)
+{
+    maxThreads = std::max(inMaxThreads,1);
+}
+
+void ScreenProjectionCache::project(ViewStateRef inViewState,const Point2f &inFrameSize,bool checkFacing)
+{
+    if (isProjectedFor(inViewState.get(),inFrameSize))
+        return;
+
+    viewState = inViewState;
+    frameSize = inFrameSize;
+    numOffsets = (int)viewState->fullMatrices.size();
+    const size_t numPts = worldX.size();
+    screenX.resize(numPts*numOffsets);
+    screenY.resize(numPts*numOffsets);
+    facing.resize(numPts*numOffsets);
+
+    // Same lazy setup pointOnScreenFromDisplay does
+    if (viewState->ll.x() == viewState->ur.x())
+        viewState->calcFrustumWidth(frameSize.x(),frameSize.y());
+
+    std::vector<ProjectionParams> allParams(numOffsets);
+    for (int offi=0;offi<numOffsets;offi++)
+    {
+        ProjectionParams &params = allParams[offi];
+        memcpy(params.mat,viewState->fullMatrices[offi].data(),sizeof(double)*16);
+        memcpy(params.normMat,viewState->fullNormalMatrices[offi].data(),sizeof(double)*16);
+        params.nearPlane = viewState->nearPlane;
+        params.llX = viewState->ll.x();  params.llY = viewState->ll.y();
+        params.spanX = viewState->ur.x() - viewState->ll.x();
+        params.spanY = viewState->ur.y() - viewState->ll.y();
+        params.frameX = frameSize.x();  params.frameY = frameSize.y();
+    }
+
+    // Runs all the offset matrices over a range of points
+    auto projectRange = [&](size_t start,size_t end)
+    {
+        for (int offi=0;offi<numOffsets;offi++)
+        {
+            const size_t base = offi*numPts;
+            ProjectPointsKernel(allParams[offi],&worldX[0],&worldY[0],&worldZ[0],&screenX[base],&screenY[base],start,end);
+            if (checkFacing)
+                FacingKernel(allParams[offi],&worldX[0],&worldY[0],&worldZ[0],&facing[base],start,end);
+            else
+                memset(&facing[base+start],1,end-start);
+        }
+    };
+
+    if (numPts > 0)
+    {
+        // Splitting up just adds overhead if there's nowhere for the threads to run
+        static const size_t hardwareThreads = std::max(std::thread::hardware_concurrency(),1u);
+        const size_t numThreads = std::min(std::min((size_t)maxThreads,hardwareThreads),
+                                           std::max(numPts / MinPointsPerThread,(size_t)1));
+        if (numThreads <= 1)
+            projectRange(0,numPts);
+        else {
+            if (!workers || workers->getNumThreads() != maxThreads)
+                workers = std::make_shared<WorkerPool>(maxThreads);
+
+            // Split into chunks, one per task
+            const size_t chunkSize = (numPts + numThreads - 1) / numThreads;
+            workers->run((int)numThreads,[&](int ti)
+                         {
+                             projectRange(std::min(ti*chunkSize,numPts),std::min((ti+1)*chunkSize,numPts));
+                         });
+        }
+    }
+
+    projected = true;
+}
+
+Point2f ScreenProjectionCache::getScreenPt(int idx,int offi) const
+{
+    const size_t which = offi*worldX.size() + idx;
+    return Point2f(screenX[which],screenY[which]);
+}
+
+bool ScreenProjectionCache::isFacing(int idx,int offi) const
+{
+    return facing[offi*worldX.size() + idx];
+}
+
+}
@@ -478,7 +478,7 @@ int ScreenSpaceObject::getDrawPriority()
 }
 
 ScreenSpaceObjectLocation::ScreenSpaceObjectLocation()
-: isCluster(false), dispLoc(0,0,0), offset(0,0), keepUpright(false), rotation(0.0)
+: isCluster(false), dispLoc(0,0,0), offset(0,0), keepUpright(false), rotation(0.0), projected(false)
 {
     
 }
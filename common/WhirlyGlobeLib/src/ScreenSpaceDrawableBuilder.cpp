@@ -41,6 +41,9 @@ void ScreenSpaceDrawableBuilder::Init(bool hasMotion,bool hasRotation,bool build
         rotIndex = addAttribute(BDFloat3Type, a_rotNameID);
     if (hasMotion || buildAnyway)
         dirIndex = addAttribute(BDFloat3Type, a_dirNameID);
+    offsetAttr = getAttributeHandle<Eigen::Vector2f>(offsetIndex);
+    rotAttr = getAttributeHandle<Eigen::Vector3f>(rotIndex);
+    dirAttr = getAttributeHandle<Eigen::Vector3f>(dirIndex);
 }
     
 void ScreenSpaceDrawableBuilder::setKeepUpright(bool newVal)
@@ -56,22 +59,22 @@ TimeInterval ScreenSpaceDrawableBuilder::getStartTime()
 
 void ScreenSpaceDrawableBuilder::addOffset(const Point2f &offset)
 {
-    addAttributeValue(offsetIndex, offset);
+    offsetAttr.add(offset);
 }
 
 void ScreenSpaceDrawableBuilder::addOffset(const Point2d &offset)
 {
-    addAttributeValue(offsetIndex, Point2f(offset.x(),offset.y()));
+    offsetAttr.add(Point2f(offset.x(),offset.y()));
 }
     
 void ScreenSpaceDrawableBuilder::addDir(const Point3d &dir)
 {
-    addAttributeValue(dirIndex, Point3f(dir.x(),dir.y(),dir.z()));
+    dirAttr.add(Point3f(dir.x(),dir.y(),dir.z()));
 }
 
 void ScreenSpaceDrawableBuilder::addDir(const Point3f &dir)
 {
-    addAttributeValue(dirIndex, dir);
+    dirAttr.add(dir);
 }
     
 void ScreenSpaceDrawableBuilder::addRot(const Point3d &rotDir)
@@ -81,7 +84,7 @@ void ScreenSpaceDrawableBuilder::addRot(const Point3d &rotDir)
 
 void ScreenSpaceDrawableBuilder::addRot(const Point3f &rotDir)
 {
-    addAttributeValue(rotIndex, rotDir);
+    rotAttr.add(rotDir);
 }
     
 void ScreenSpaceDrawableBuilder::setupTweaker(BasicDrawable *theDraw)
@@ -84,10 +84,18 @@ attribute vec3 a_rot;
 varying vec2 v_texCoord;
 varying vec4 v_color;
 
+#ifdef SDF_GLYPHS
+attribute vec2 a_sdfParams;
+varying vec2 v_sdfParams;
+#endif
+
 void main()
 {
     v_texCoord = a_texCoord0;
     v_color = a_color * u_fade;
+#ifdef SDF_GLYPHS
+    v_sdfParams = a_sdfParams;
+#endif
     
     // Convert from model space into display space
     vec4 pt = u_mvMatrix * vec4(a_position,1.0);
@@ -170,10 +178,18 @@ attribute vec3 a_rot;
 varying vec2 v_texCoord;
 varying vec4 v_color;
 
+#ifdef SDF_GLYPHS
+attribute vec2 a_sdfParams;
+varying vec2 v_sdfParams;
+#endif
+
 void main()
 {
     v_texCoord = a_texCoord0;
     v_color = a_color * u_fade;
+#ifdef SDF_GLYPHS
+    v_sdfParams = a_sdfParams;
+#endif
     
     // Position can be modified over time
     vec3 thePos = a_position + u_time * a_dir;
@@ -255,6 +271,26 @@ void main()
 }
 )";
 
+// Glyphs as distance fields.  The params are the edge value and the smoothing around it.
+static const char *fragmentShaderSDF = R"(
+precision highp float;
+
+uniform sampler2D s_baseMap0;
+
+varying vec2      v_texCoord;
+varying vec4      v_color;
+varying vec2      v_sdfParams;
+
+void main()
+{
+    float dist = texture2D(s_baseMap0, v_texCoord).a;
+    float alpha = smoothstep(v_sdfParams.x - v_sdfParams.y, v_sdfParams.x + v_sdfParams.y, dist);
+    gl_FragColor = v_color * alpha;
+}
+)";
+
+static const char *defineSDF = "#define SDF_GLYPHS 1\n";
+
 ProgramGLES *BuildScreenSpaceProgramGLES(const std::string &name,SceneRenderer *render)
 {
     ProgramGLES *shader = new ProgramGLES(name,vertexShaderTri,fragmentShaderTri);
@@ -315,4 +351,34 @@ ProgramGLES *BuildScreenSpaceMotion2DProgramGLES(const std::string &name,SceneRe
     return shader;
 }
 
+ProgramGLES *BuildScreenSpaceSDFProgramGLES(const std::string &name,SceneRenderer *render)
+{
+    ProgramGLES *shader = new ProgramGLES(name,std::string(defineSDF) + vertexShaderTri,fragmentShaderSDF);
+    if (!shader->isValid())
+    {
+        delete shader;
+        shader = NULL;
+    }
+    
+    if (shader)
+        glUseProgram(shader->getProgram());
+    
+    return shader;
+}
+
+ProgramGLES *BuildScreenSpaceSDFMotionProgramGLES(const std::string &name,SceneRenderer *render)
+{
+    ProgramGLES *shader = new ProgramGLES(name,std::string(defineSDF) + vertexShaderMotionTri,fragmentShaderSDF);
+    if (!shader->isValid())
+    {
+        delete shader;
+        shader = NULL;
+    }
+    
+    if (shader)
+        glUseProgram(shader->getProgram());
+    
+    return shader;
+}
+
 }
@@ -781,6 +781,28 @@ void SelectionManager::projectWorldPointToScreen(const Point3d &worldLoc,const P
     }
 }
 
+void SelectionManager::projectWorldPointToScreen(const ScreenProjectionCache &projCache,int projIndex,const PlacementInfo &pInfo,Point2dVector &screenPts,float scale)
+{
+    for (int offi=0;offi<projCache.getNumOffsets();offi++)
+    {
+        // Make sure this one is facing toward the viewer
+        if (!projCache.isFacing(projIndex,offi))
+            return;
+
+        addScreenPoint(projCache.getScreenPt(projIndex,offi),pInfo,screenPts,scale);
+    }
+}
+
+void SelectionManager::addScreenPoint(const Point2f &screenPt,const PlacementInfo &pInfo,Point2dVector &screenPts,float scale)
+{
+    // Isn't on the screen
+    if (screenPt.x() < pInfo.frameMbr.ll().x() || screenPt.y() < pInfo.frameMbr.ll().y() ||
+        screenPt.x() > pInfo.frameMbr.ur().x() || screenPt.y() > pInfo.frameMbr.ur().y())
+        return;
+
+    screenPts.push_back(Point2d(screenPt.x()/scale,screenPt.y()/scale));
+}
+
 // Sorter for selected objects
 struct selectedsorter
 {
@@ -888,6 +910,16 @@ void SelectionManager::pickObjects(Point2f touchPt,float maxDist,ViewStateRef vi
     getScreenSpaceObjects(pInfo,ssObjs,now);
     if (layoutManager)
         layoutManager->getScreenSpaceObjects(pInfo,ssObjs);
+
+    // Layout objects come back projected from the layout manager's cache.
+    // The rest we project here, all at once.
+    projCache.clear();
+    std::vector<int> projIndices(ssObjs.size(),-1);
+    for (unsigned int ii=0;ii<ssObjs.size();ii++)
+        if (!ssObjs[ii].projected)
+            projIndices[ii] = projCache.addWorldLoc(ssObjs[ii].dispLoc);
+    if (projCache.size() > 0)
+        projCache.project(pInfo.viewState,pInfo.frameSize,pInfo.globeViewState != NULL);
     
     // Work through the 2D rectangles
     for (unsigned int ii=0;ii<ssObjs.size();ii++)
@@ -895,7 +927,12 @@ void SelectionManager::pickObjects(Point2f touchPt,float maxDist,ViewStateRef vi
         ScreenSpaceObjectLocation &screenObj = ssObjs[ii];
         
         Point2dVector projPts;
-        projectWorldPointToScreen(screenObj.dispLoc, pInfo, projPts, renderer->getScale());
+        if (screenObj.projected)
+        {
+            for (const Point2f &screenLoc : screenObj.screenLocs)
+                addScreenPoint(screenLoc, pInfo, projPts, renderer->getScale());
+        } else
+            projectWorldPointToScreen(projCache, projIndices[ii], pInfo, projPts, renderer->getScale());
         
         float closeDist2 = MAXFLOAT;
         // Work through the possible locations of the projected point
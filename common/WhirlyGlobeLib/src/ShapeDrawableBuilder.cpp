@@ -34,7 +34,7 @@ using namespace WhirlyKit;
 namespace WhirlyKit
 {
 ShapeInfo::ShapeInfo()
-    : color(RGBAColor(255,255,255,255)), lineWidth(1.0), insideOut(false), hasCenter(false), center(0.0,0.0,0.0)
+    : color(RGBAColor(255,255,255,255)), lineWidth(1.0), insideOut(false), instanced(false), hasCenter(false), center(0.0,0.0,0.0)
 {
     zBufferRead = true;
 }
@@ -47,6 +47,7 @@ ShapeInfo::ShapeInfo(const Dictionary &dict)
     color = dict.getColor(MaplyColor,RGBAColor(255,255,255,255));
     lineWidth = dict.getDouble(MaplyVecWidth,1.0);
     insideOut = dict.getBool(MaplyShapeInsideOut,false);
+    instanced = dict.getBool(MaplyShapeInstanced,false);
     hasCenter = false;
     center = Point3d(0.0,0.0,0.0);
     if (dict.hasField(MaplyShapeCenterX) || dict.hasField(MaplyShapeCenterY) || dict.hasField(MaplyShapeCenterZ))
@@ -338,21 +339,22 @@ void ShapeDrawableBuilderTri::addTriangles(Point3dVector &pts,Point3dVector &nor
         setupNewDrawable();
     }
 
-    int baseVert = drawable->getNumPoints();
-    for (unsigned int ii=0;ii<pts.size();ii++)
-    {
-        const Point3d &pt = pts[ii];
-        drawable->addPoint(Point3d(pt.x()-center.x(),pt.y()-center.y(),pt.z()-center.z()));
-        drawable->addNormal(norms[ii]);
-        drawable->addColor(colors[ii]);
-	}
-    for (unsigned int ii=0;ii<tris.size();ii++)
+    const int numPts = (int)pts.size();
+    Point3fVector locPts(numPts),locNorms(numPts);
+    for (int ii=0;ii<numPts;ii++)
     {
-        BasicDrawable::Triangle tri = tris[ii];
+        locPts[ii] = (pts[ii]-center).cast<float>();
+        locNorms[ii] = norms[ii].cast<float>();
+    }
+    int baseVert = drawable->addPoints(locPts.data(), numPts);
+    drawable->addNormals(locNorms.data(), numPts);
+    drawable->addColors(colors.data(), numPts);
+
+    std::vector<BasicDrawable::Triangle> locTris(tris);
+    for (auto &tri : locTris)
         for (unsigned int jj=0;jj<3;jj++)
             tri.verts[jj] += baseVert;
-        drawable->addTriangle(tri);
-    }
+    drawable->addTriangles(locTris.data(), (int)locTris.size());
 }
 
 // Add a convex outline, triangulated
@@ -29,12 +29,51 @@
 #import "GeometryManager.h"
 #import "FlatMath.h"
 #import "WhirlyKitLog.h"
+#import "SharedAttributes.h"
+#import "BasicDrawableInstanceBuilder.h"
 
 using namespace Eigen;
 using namespace WhirlyKit;
 
 namespace WhirlyKit {
 
+bool ShapeMeshKey::operator < (const ShapeMeshKey &that) const
+{
+    if (type != that.type)
+        return type < that.type;
+    if (sampleX != that.sampleX)
+        return sampleX < that.sampleX;
+    if (sampleY != that.sampleY)
+        return sampleY < that.sampleY;
+    return insideOut < that.insideOut;
+}
+
+// Construct a set of axes to build a shape around
+static void ShapeAxes(CoordSystemDisplayAdapter *coordAdapter,const Point3d &up,Point3d &xAxis,Point3d &yAxis)
+{
+    if (coordAdapter->isFlat())
+    {
+        xAxis = Point3d(1,0,0);
+        yAxis = Point3d(0,1,0);
+    } else {
+        Point3d north(0,0,1);
+        // Note: Also check if we're at a pole
+        xAxis = north.cross(up);  xAxis.normalize();
+        yAxis = up.cross(xAxis);  yAxis.normalize();
+    }
+}
+
+// Matrix that takes a unit mesh onto the given axes
+static Matrix4d ShapeInstanceMatrix(const Point3d &xAxis,const Point3d &yAxis,const Point3d &zAxis)
+{
+    Matrix4d mat = Matrix4d::Identity();
+    mat.block<3,1>(0,0) = xAxis;
+    mat.block<3,1>(0,1) = yAxis;
+    mat.block<3,1>(0,2) = zAxis;
+
+    return mat;
+}
+
 void ShapeSceneRep::enableContents(WhirlyKit::SelectionManager *selectManager, bool enable, ChangeSet &changes)
 {
     for (const SimpleIdentity idIt : drawIDs){
@@ -74,6 +113,12 @@ Point3d Shape::displayCenter(WhirlyKit::CoordSystemDisplayAdapter *coordAdapter,
 	return Point3d(0,0,0);
 }
 
+// Base shape can't be instanced
+bool Shape::makeInstance(WhirlyKit::Scene *scene, const ShapeInfo &shapeInfo, WhirlyKit::SelectionManager *selectManager, WhirlyKit::ShapeSceneRep *sceneRep, ShapeMeshKey &meshKey, BasicDrawableInstance::SingleInstance &inst)
+{
+    return false;
+}
+
 Circle::Circle()
 : loc(0,0), radius(0.0), height(0.0), sampleX(10)    {
 }
@@ -107,18 +152,8 @@ void Circle::makeGeometryWithBuilder(WhirlyKit::ShapeDrawableBuilder *regBuilder
     Point3d norm = coordAdapter->normalForLocal(localPt);
     
     // Construct a set of axes to build the circle around
-    Point3d up = norm;
     Point3d xAxis,yAxis;
-    if (coordAdapter->isFlat())
-    {
-        xAxis = Point3d(1,0,0);
-        yAxis = Point3d(0,1,0);
-    } else {
-        Point3d north(0,0,1);
-        // Note: Also check if we're at a pole
-        xAxis = north.cross(up);  xAxis.normalize();
-        yAxis = up.cross(xAxis);  yAxis.normalize();
-    }
+    ShapeAxes(coordAdapter,norm,xAxis,yAxis);
     
     // Calculate the locations, using the axis from the center
     Point3dVector samples;
@@ -150,20 +185,64 @@ void Circle::makeGeometryWithBuilder(WhirlyKit::ShapeDrawableBuilder *regBuilder
     triBuilder->addConvexOutline(samples,norm,theColor,shapeMbr);
     
     // Add a selection region
+    if (isSelectable && selectManager && sceneRep)
+        addSelectionBox(bot,top,*triBuilder->getShapeInfo(),selectManager,sceneRep);
+}
+
+void Circle::addSelectionBox(const Point3d &bot,const Point3d &top,const ShapeInfo &shapeInfo,WhirlyKit::SelectionManager *selectManager,WhirlyKit::ShapeSceneRep *sceneRep)
+{
+    Point3d pts[8];
+    pts[0] = Point3d(bot.x(),bot.y(),bot.z());
+    pts[1] = Point3d(top.x(),bot.y(),bot.z());
+    pts[2] = Point3d(top.x(),top.y(),bot.z());
+    pts[3] = Point3d(bot.x(),top.y(),bot.z());
+    pts[4] = Point3d(bot.x(),bot.y(),top.z());
+    pts[5] = Point3d(top.x(),bot.y(),top.z());
+    pts[6] = Point3d(top.x(),top.y(),top.z());
+    pts[7] = Point3d(bot.x(),top.y(),top.z());
+    selectManager->addSelectableRectSolid(selectID,pts,shapeInfo.minVis,shapeInfo.maxVis,shapeInfo.enable);
+    sceneRep->selectIDs.insert(selectID);
+}
+
+bool Circle::makeInstance(WhirlyKit::Scene *scene, const ShapeInfo &shapeInfo, WhirlyKit::SelectionManager *selectManager, WhirlyKit::ShapeSceneRep *sceneRep, ShapeMeshKey &meshKey, BasicDrawableInstance::SingleInstance &inst)
+{
+    if (clipCoords || sampleX < 3 || sampleX > (int)MaxDrawablePoints)
+        return false;
+
+    CoordSystemDisplayAdapter *coordAdapter = scene->getCoordAdapter();
+
+    Point3d localPt = coordAdapter->getCoordSystem()->geographicToLocal3d(loc);
+    Point3d norm = coordAdapter->normalForLocal(localPt);
+    Point3d dispPt = coordAdapter->localToDisplay(localPt) + norm * height;
+    Point3d xAxis,yAxis;
+    ShapeAxes(coordAdapter,norm,xAxis,yAxis);
+
+    meshKey = ShapeMeshKey(ShapeMeshCircle,sampleX,0,false);
+    inst.center = dispPt;
+    inst.mat = ShapeInstanceMatrix(xAxis * radius,yAxis * radius,norm);
+    inst.colorOverride = true;
+    inst.color = useColor ? color : shapeInfo.color;
+
+    // The selection box is the same as for the full geometry
     if (isSelectable && selectManager && sceneRep)
     {
-        Point3d pts[8];
-        pts[0] = Point3d(bot.x(),bot.y(),bot.z());
-        pts[1] = Point3d(top.x(),bot.y(),bot.z());
-        pts[2] = Point3d(top.x(),top.y(),bot.z());
-        pts[3] = Point3d(bot.x(),top.y(),bot.z());
-        pts[4] = Point3d(bot.x(),bot.y(),top.z());
-        pts[5] = Point3d(top.x(),bot.y(),top.z());
-        pts[6] = Point3d(top.x(),top.y(),top.z());
-        pts[7] = Point3d(bot.x(),top.y(),top.z());
-        selectManager->addSelectableRectSolid(selectID,pts,triBuilder->getShapeInfo()->minVis,triBuilder->getShapeInfo()->maxVis,regBuilder->getShapeInfo()->enable);
-        sceneRep->selectIDs.insert(selectID);
+        Point3d bot,top;
+        for (int ii=0;ii<sampleX;ii++)
+        {
+            Point3d samplePt = xAxis * radius * sinf(2*M_PI*ii/(float)(sampleX-1)) + radius * yAxis * cosf(2*M_PI*ii/(float)(sampleX-1)) + dispPt;
+            Point3d thisLocalPt = coordAdapter->displayToLocal(samplePt);
+            if (ii==0)
+            {
+                bot = top = thisLocalPt;
+            } else {
+                bot = bot.cwiseMin(thisLocalPt);
+                top = top.cwiseMax(thisLocalPt);
+            }
+        }
+        addSelectionBox(bot,top,shapeInfo,selectManager,sceneRep);
     }
+
+    return true;
 }
     
 Sphere::Sphere()
@@ -255,20 +334,49 @@ void Sphere::makeGeometryWithBuilder(WhirlyKit::ShapeDrawableBuilder *regBuilder
     triBuilder->addTriangles(locs,norms,colors,tris);
 
     // Add a selection region
-    if (isSelectable && selectManager && sceneRep) {
-        Point3d pts[8];
-        float dist = radius * sqrt2;
-        pts[0] = dispPt + dist * Point3d(-1,-1,-1);
-        pts[1] = dispPt + dist * Point3d(1,-1,-1);
-        pts[2] = dispPt + dist * Point3d(1,1,-1);
-        pts[3] = dispPt + dist * Point3d(-1,1,-1);
-        pts[4] = dispPt + dist * Point3d(-1,-1,1);
-        pts[5] = dispPt + dist * Point3d(1,-1,1);
-        pts[6] = dispPt + dist * Point3d(1,1,1);
-        pts[7] = dispPt + dist * Point3d(-1,1,1);
-        selectManager->addSelectableRectSolid(selectID,pts,triBuilder->getShapeInfo()->minVis,triBuilder->getShapeInfo()->maxVis,regBuilder->getShapeInfo()->enable);
-        sceneRep->selectIDs.insert(selectID);
-    }
+    if (isSelectable && selectManager && sceneRep)
+        addSelectionBox(dispPt,*triBuilder->getShapeInfo(),selectManager,sceneRep);
+}
+
+void Sphere::addSelectionBox(const Point3d &dispPt,const ShapeInfo &shapeInfo,WhirlyKit::SelectionManager *selectManager,WhirlyKit::ShapeSceneRep *sceneRep)
+{
+    Point3d pts[8];
+    float dist = radius * sqrt2;
+    pts[0] = dispPt + dist * Point3d(-1,-1,-1);
+    pts[1] = dispPt + dist * Point3d(1,-1,-1);
+    pts[2] = dispPt + dist * Point3d(1,1,-1);
+    pts[3] = dispPt + dist * Point3d(-1,1,-1);
+    pts[4] = dispPt + dist * Point3d(-1,-1,1);
+    pts[5] = dispPt + dist * Point3d(1,-1,1);
+    pts[6] = dispPt + dist * Point3d(1,1,1);
+    pts[7] = dispPt + dist * Point3d(-1,1,1);
+    selectManager->addSelectableRectSolid(selectID,pts,shapeInfo.minVis,shapeInfo.maxVis,shapeInfo.enable);
+    sceneRep->selectIDs.insert(selectID);
+}
+
+bool Sphere::makeInstance(WhirlyKit::Scene *scene, const ShapeInfo &shapeInfo, WhirlyKit::SelectionManager *selectManager, WhirlyKit::ShapeSceneRep *sceneRep, ShapeMeshKey &meshKey, BasicDrawableInstance::SingleInstance &inst)
+{
+    if (clipCoords || sampleX < 1 || sampleY < 1 ||
+        (sampleX+1)*(sampleY+1) > (int)MaxDrawablePoints || 2*sampleX*sampleY > (int)MaxDrawableTriangles)
+        return false;
+
+    CoordSystemDisplayAdapter *coordAdapter = scene->getCoordAdapter();
+
+    Point3d localPt = coordAdapter->getCoordSystem()->geographicToLocal3d(loc);
+    Point3d norm = coordAdapter->normalForLocal(localPt);
+    Point3d dispPt = coordAdapter->localToDisplay(localPt) + norm * height;
+
+    // The sphere isn't oriented to the surface, so this is just a scale
+    meshKey = ShapeMeshKey(ShapeMeshSphere,sampleX,sampleY,shapeInfo.insideOut);
+    inst.center = dispPt;
+    inst.mat = ShapeInstanceMatrix(Point3d(radius,0,0),Point3d(0,radius,0),Point3d(0,0,radius));
+    inst.colorOverride = true;
+    inst.color = useColor ? color : shapeInfo.color;
+
+    if (isSelectable && selectManager && sceneRep)
+        addSelectionBox(dispPt,shapeInfo,selectManager,sceneRep);
+
+    return true;
 }
     
 Cylinder::Cylinder()
@@ -304,18 +412,8 @@ void Cylinder::makeGeometryWithBuilder(WhirlyKit::ShapeDrawableBuilder *regBuild
     dispPt += norm * baseHeight;
     
     // Construct a set of axes to build the circle around
-    Point3d up = norm;
     Point3d xAxis,yAxis;
-    if (coordAdapter->isFlat())
-    {
-        xAxis = Point3d(1,0,0);
-        yAxis = Point3d(0,1,0);
-    } else {
-        Point3d north(0,0,1);
-        // Note: Also check if we're at a pole
-        xAxis = north.cross(up);  xAxis.normalize();
-        yAxis = up.cross(xAxis);  yAxis.normalize();
-    }
+    ShapeAxes(coordAdapter,norm,xAxis,yAxis);
 
     // Generate the circle based on the axes
     Point3dVector circleSamples(sampleX);
@@ -364,20 +462,48 @@ void Cylinder::makeGeometryWithBuilder(WhirlyKit::ShapeDrawableBuilder *regBuild
     
     // Add a selection region
     if (isSelectable && selectManager && sceneRep)
-    {
-        Point3d pts[8];
-        float dist1 = radius * sqrt2;
-        pts[0] = dispPt - dist1 * xAxis - dist1 * yAxis;
-        pts[1] = dispPt + dist1 * xAxis - dist1 * yAxis;
-        pts[2] = dispPt + dist1 * xAxis + dist1 * yAxis;
-        pts[3] = dispPt - dist1 * xAxis + dist1 * yAxis;
-        pts[4] = pts[0] + height * norm;
-        pts[5] = pts[1] + height * norm;
-        pts[6] = pts[2] + height * norm;
-        pts[7] = pts[3] + height * norm;
-        selectManager->addSelectableRectSolid(selectID,pts,triBuilder->getShapeInfo()->minVis,triBuilder->getShapeInfo()->maxVis,triBuilder->getShapeInfo()->enable);
-        sceneRep->selectIDs.insert(selectID);
-    }
+        addSelectionBox(dispPt,norm,xAxis,yAxis,*triBuilder->getShapeInfo(),selectManager,sceneRep);
+}
+
+void Cylinder::addSelectionBox(const Point3d &dispPt,const Point3d &norm,const Point3d &xAxis,const Point3d &yAxis,const ShapeInfo &shapeInfo,WhirlyKit::SelectionManager *selectManager,WhirlyKit::ShapeSceneRep *sceneRep)
+{
+    Point3d pts[8];
+    float dist1 = radius * sqrt2;
+    pts[0] = dispPt - dist1 * xAxis - dist1 * yAxis;
+    pts[1] = dispPt + dist1 * xAxis - dist1 * yAxis;
+    pts[2] = dispPt + dist1 * xAxis + dist1 * yAxis;
+    pts[3] = dispPt - dist1 * xAxis + dist1 * yAxis;
+    pts[4] = pts[0] + height * norm;
+    pts[5] = pts[1] + height * norm;
+    pts[6] = pts[2] + height * norm;
+    pts[7] = pts[3] + height * norm;
+    selectManager->addSelectableRectSolid(selectID,pts,shapeInfo.minVis,shapeInfo.maxVis,shapeInfo.enable);
+    sceneRep->selectIDs.insert(selectID);
+}
+
+bool Cylinder::makeInstance(WhirlyKit::Scene *scene, const ShapeInfo &shapeInfo, WhirlyKit::SelectionManager *selectManager, WhirlyKit::ShapeSceneRep *sceneRep, ShapeMeshKey &meshKey, BasicDrawableInstance::SingleInstance &inst)
+{
+    if (clipCoords || sampleX < 3 || 5*sampleX > (int)MaxDrawablePoints)
+        return false;
+
+    CoordSystemDisplayAdapter *coordAdapter = scene->getCoordAdapter();
+
+    Point3d localPt = coordAdapter->getCoordSystem()->geographicToLocal3d(loc);
+    Point3d norm = coordAdapter->normalForLocal(localPt);
+    Point3d dispPt = coordAdapter->localToDisplay(localPt) + norm * baseHeight;
+    Point3d xAxis,yAxis;
+    ShapeAxes(coordAdapter,norm,xAxis,yAxis);
+
+    meshKey = ShapeMeshKey(ShapeMeshCylinder,sampleX,0,false);
+    inst.center = dispPt;
+    inst.mat = ShapeInstanceMatrix(xAxis * radius,yAxis * radius,norm * height);
+    inst.colorOverride = true;
+    inst.color = useColor ? color : shapeInfo.color;
+
+    if (isSelectable && selectManager && sceneRep)
+        addSelectionBox(dispPt,norm,xAxis,yAxis,shapeInfo,selectManager,sceneRep);
+
+    return true;
 }
     
 Linear::Linear()
@@ -686,6 +812,205 @@ void ShapeManager::convertShape(Shape &shape,std::vector<WhirlyKit::GeometryRaw>
     }
 }
 
+// Unit circle in the XY plane, fanned out the same way as addConvexOutline
+static void BuildUnitCircle(int sampleX,Point3dVector &pts,Point3dVector &norms,std::vector<BasicDrawable::Triangle> &tris)
+{
+    for (int ii=0;ii<sampleX;ii++)
+    {
+        pts.push_back(Point3d(sinf(2*M_PI*ii/(float)(sampleX-1)),cosf(2*M_PI*ii/(float)(sampleX-1)),0.0));
+        norms.push_back(Point3d(0,0,1));
+    }
+    for (int ii=2;ii<sampleX;ii++)
+        tris.push_back(BasicDrawable::Triangle(0,ii,ii-1));
+}
+
+// Unit sphere around the origin, tesselated by lat/lon
+static void BuildUnitSphere(int sampleX,int sampleY,bool insideOut,Point3dVector &pts,Point3dVector &norms,std::vector<BasicDrawable::Triangle> &tris)
+{
+    Point2f geoIncr(2*M_PI/sampleX,M_PI/sampleY);
+    for (int iy=0;iy<sampleY+1;iy++)
+        for (int ix=0;ix<sampleX+1;ix++)
+        {
+            GeoCoord geoLoc(-M_PI+ix*geoIncr.x(),-M_PI/2.0 + iy*geoIncr.y());
+            geoLoc.x() = std::max(std::min(geoLoc.x(),(float)M_PI),(float)-M_PI);
+            geoLoc.y() = std::max(std::min(geoLoc.y(),(float)(M_PI/2.0)),(float)(-M_PI/2.0));
+
+            Point3d spherePt = FakeGeocentricDisplayAdapter::LocalToDisplay(Point3d(geoLoc.lon(),geoLoc.lat(),0.0));
+            pts.push_back(spherePt);
+            norms.push_back(spherePt);
+        }
+
+    for (int iy=0;iy<sampleY;iy++)
+        for (int ix=0;ix<sampleX;ix++)
+        {
+            int v0 = iy*(sampleX+1)+ix, v1 = iy*(sampleX+1)+(ix+1);
+            int v2 = (iy+1)*(sampleX+1)+(ix+1), v3 = (iy+1)*(sampleX+1)+ix;
+            if (insideOut)
+            {
+                tris.push_back(BasicDrawable::Triangle(v0,v2,v1));
+                tris.push_back(BasicDrawable::Triangle(v0,v3,v2));
+            } else {
+                tris.push_back(BasicDrawable::Triangle(v0,v1,v2));
+                tris.push_back(BasicDrawable::Triangle(v0,v2,v3));
+            }
+        }
+}
+
+// Unit cylinder with its base on the XY plane, a top cap and sides
+static void BuildUnitCylinder(int sampleX,Point3dVector &pts,Point3dVector &norms,std::vector<BasicDrawable::Triangle> &tris)
+{
+    Point3dVector bot(sampleX),top(sampleX);
+    for (int ii=0;ii<sampleX;ii++)
+    {
+        bot[ii] = Point3d(sinf(2*M_PI*ii/(float)(sampleX-1)),cosf(2*M_PI*ii/(float)(sampleX-1)),0.0);
+        top[ii] = bot[ii] + Point3d(0,0,1);
+    }
+
+    // Top is a fan
+    for (int ii=0;ii<sampleX;ii++)
+    {
+        pts.push_back(top[ii]);
+        norms.push_back(Point3d(0,0,1));
+    }
+    for (int ii=2;ii<sampleX;ii++)
+        tris.push_back(BasicDrawable::Triangle(0,ii,ii-1));
+
+    // Sides run bottom to top, each with its own normal
+    for (int ii=0;ii<sampleX;ii++)
+    {
+        Point3d quad[4];
+        quad[0] = bot[ii];
+        quad[1] = bot[(ii+1)%sampleX];
+        quad[2] = top[(ii+1)%sampleX];
+        quad[3] = top[ii];
+        Point3d thisNorm = (quad[0]-quad[1]).cross(quad[2]-quad[1]);
+        thisNorm.normalize();
+        int baseVert = (int)pts.size();
+        for (unsigned int jj=0;jj<4;jj++)
+        {
+            pts.push_back(quad[jj]);
+            norms.push_back(thisNorm);
+        }
+        tris.push_back(BasicDrawable::Triangle(baseVert,baseVert+2,baseVert+1));
+        tris.push_back(BasicDrawable::Triangle(baseVert,baseVert+3,baseVert+2));
+    }
+}
+
+BasicDrawableBuilderRef ShapeManager::buildUnitMesh(const ShapeMeshKey &meshKey)
+{
+    Point3dVector pts,norms;
+    std::vector<BasicDrawable::Triangle> tris;
+    switch (meshKey.type)
+    {
+        case ShapeMeshCircle:
+            BuildUnitCircle(meshKey.sampleX,pts,norms,tris);
+            break;
+        case ShapeMeshSphere:
+            BuildUnitSphere(meshKey.sampleX,meshKey.sampleY,meshKey.insideOut,pts,norms,tris);
+            break;
+        case ShapeMeshCylinder:
+            BuildUnitCylinder(meshKey.sampleX,pts,norms,tris);
+            break;
+    }
+
+    // Only the instances draw, so this stays off
+    BasicDrawableBuilderRef draw = renderer->makeBasicDrawableBuilder("Shape Manager Unit Mesh");
+    draw->setType(Triangles);
+    draw->setOnOff(false);
+    draw->setColor(RGBAColor::white());
+    draw->reserve((int)pts.size(),(int)tris.size());
+    Mbr mbr;
+    for (unsigned int ii=0;ii<pts.size();ii++)
+    {
+        draw->addPoint(pts[ii]);
+        draw->addNormal(norms[ii]);
+        draw->addColor(RGBAColor::white());
+        mbr.addPoint(Point2f(pts[ii].x(),pts[ii].y()));
+    }
+    for (const auto &tri : tris)
+        draw->addTriangle(tri);
+    draw->setLocalMbr(mbr);
+
+    return draw;
+}
+
+std::vector<Shape*> ShapeManager::addShapeInstances(const std::vector<Shape*> &shapes,const ShapeInfo &shapeInfo,SelectionManager *selectManager,ShapeSceneRep *sceneRep,ChangeSet &changes)
+{
+    // The instances need a shader that applies the per-instance matrix
+    Program *prog = scene->findProgramByName(MaplyDefaultModelTriShader);
+    if (!prog)
+    {
+        wkLogLevel(Warn, "ShapeManager: No model shader, so can't instance shapes.");
+        return shapes;
+    }
+
+    // Sort the shapes by the unit mesh they use
+    typedef std::map<ShapeMeshKey,std::vector<BasicDrawableInstance::SingleInstance> > InstanceMap;
+    InstanceMap instMap;
+    std::vector<Shape*> remaining;
+    for (auto shape : shapes)
+    {
+        ShapeMeshKey meshKey;
+        BasicDrawableInstance::SingleInstance inst;
+        if (shape->makeInstance(scene, shapeInfo, selectManager, sceneRep, meshKey, inst))
+            instMap[meshKey].push_back(inst);
+        else
+            remaining.push_back(shape);
+    }
+
+    TimeInterval curTime = scene->getCurrentTime();
+    for (const auto &it : instMap)
+    {
+        // The unit mesh is shared by everyone using the same tesselation
+        SimpleIdentity baseDrawID = EmptyIdentity;
+        {
+            std::lock_guard<std::mutex> guardLock(shapeLock);
+            UnitMesh &unitMesh = unitMeshes[it.first];
+            if (unitMesh.drawID == EmptyIdentity)
+            {
+                BasicDrawableBuilderRef draw = buildUnitMesh(it.first);
+                unitMesh.drawID = draw->getDrawableID();
+                // Other threads can use the ID as soon as we unlock and may flush their changes before
+                //  we flush ours.  So this goes straight to the scene, ahead of any instances.
+                scene->addChangeRequest(new AddDrawableReq(draw->getDrawable()));
+            }
+            unitMesh.refs++;
+            baseDrawID = unitMesh.drawID;
+        }
+        sceneRep->meshKeys.push_back(it.first);
+
+        // One drawable for all the shapes using this mesh
+        BasicDrawableInstanceBuilderRef drawInst = renderer->makeBasicDrawableInstanceBuilder("Shape Manager");
+        drawInst->setMasterID(baseDrawID,BasicDrawableInstance::LocalStyle);
+        shapeInfo.setupBasicDrawableInstance(drawInst);
+        drawInst->setProgram(prog->getId());
+        if (shapeInfo.fade > 0.0)
+            drawInst->setFade(curTime,curTime+shapeInfo.fade);
+        drawInst->addInstances(it.second);
+
+        sceneRep->drawIDs.insert(drawInst->getDrawableID());
+        changes.push_back(new AddDrawableReq(drawInst->getDrawable()));
+    }
+
+    return remaining;
+}
+
+void ShapeManager::releaseUnitMeshesLocked(ShapeSceneRep *sceneRep,ChangeSet &changes,TimeInterval when)
+{
+    for (const auto &meshKey : sceneRep->meshKeys)
+    {
+        auto it = unitMeshes.find(meshKey);
+        if (it == unitMeshes.end())
+            continue;
+        if (--it->second.refs <= 0)
+        {
+            changes.push_back(new RemDrawableReq(it->second.drawID,when));
+            unitMeshes.erase(it);
+        }
+    }
+    sceneRep->meshKeys.clear();
+}
+
 /// Add an array of shapes.  The returned ID can be used to remove or modify the group of shapes.
 SimpleIdentity ShapeManager::addShapes(std::vector<Shape*> shapes, const ShapeInfo &shapeInfo, ChangeSet &changes)
 {
@@ -694,6 +1019,10 @@ SimpleIdentity ShapeManager::addShapes(std::vector<Shape*> shapes, const ShapeIn
     ShapeSceneRep *sceneRep = new ShapeSceneRep();
     sceneRep->fade = shapeInfo.fade;
 
+    // Shapes that can share a unit mesh are done as instances, the rest get real geometry
+    if (shapeInfo.instanced)
+        shapes = addShapeInstances(shapes, shapeInfo, selectManager, sceneRep, changes);
+
     // Figure out a good center
     Point3d center(0,0,0);
     int numObjects = 0;
@@ -768,6 +1097,7 @@ void ShapeManager::removeShapes(SimpleIDSet &shapeIDs,ChangeSet &changes)
             }
             
 			shapeRep->clearContents(selectManager, changes, removeTime);
+            releaseUnitMeshesLocked(shapeRep, changes, removeTime);
 			shapeReps.erase(sit);
 			delete shapeRep;
         }
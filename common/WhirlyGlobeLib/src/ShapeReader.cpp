@@ -18,15 +18,20 @@
  *
  */
 
+#import <stdio.h>
+#import <string.h>
+#import <algorithm>
 #import "ShapeReader.h"
+#import "PackedRTree.h"
 #import "shapefil.h"
 #import "GlobeMath.h"
+#import "WhirlyKitLog.h"
 
 namespace WhirlyKit
 {
 
 ShapeReader::ShapeReader(const std::string &fileName)
-    : shp(NULL), dbf(NULL)
+    : shp(NULL), dbf(NULL), where(0), numEntity(0), shapeType(0), indexLoaded(false), qixTree(NULL)
 {
 	const char *cFile =  fileName.c_str();
 	shp = SHPOpen(cFile, "rb");
@@ -37,6 +42,27 @@ ShapeReader::ShapeReader(const std::string &fileName)
         return;
 	where = 0;	
 	SHPGetInfo((SHPInfo *)shp, &numEntity, &shapeType, minBound, maxBound);
+
+    // The index files sit next to the shapefile
+    baseName = fileName;
+    size_t dot = baseName.find_last_of('.');
+    size_t slash = baseName.find_last_of('/');
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+        baseName.resize(dot);
+
+    // Look up the fields once rather than for every record
+	DBFHandle dbfHandle = (DBFHandle)dbf;
+    const int numFields = DBFGetFieldCount(dbfHandle);
+    for (int ii = 0; ii < numFields; ii++)
+    {
+        char attrTitle[12];
+        int attrWidth, numDecimals;
+        Column col;
+        col.field = ii;
+        col.type = DBFGetFieldInfo(dbfHandle, ii, attrTitle, &attrWidth, &numDecimals);
+        col.name = attrTitle;
+        allCols.push_back(col);
+    }
 }
 	
 ShapeReader::~ShapeReader()
@@ -45,6 +71,8 @@ ShapeReader::~ShapeReader()
 		SHPClose((SHPHandle)shp);
 	if (dbf)
 		DBFClose((DBFHandle)dbf);
+    if (qixTree)
+        SHPCloseDiskTree((SHPTreeDiskHandle)qixTree);
 }
 	
 bool ShapeReader::isValid()
@@ -72,11 +100,35 @@ unsigned int ShapeReader::getNumObjects()
     SHPT_MULTIPATCH     no
  */ 
     
+void ShapeReader::setupColumns(const StringSet *filterAttrs,std::vector<Column> &cols)
+{
+    if (!filterAttrs)
+    {
+        cols = allCols;
+        return;
+    }
+
+    // If we have a set of filter attrs, we only read those
+    for (const Column &col : allCols)
+        if (filterAttrs->find(col.name) != filterAttrs->end())
+            cols.push_back(col);
+}
+
 // Return a single shape by index
 VectorShapeRef ShapeReader::getObjectByIndex(unsigned int vecIndex,const StringSet *filterAttrs)
+{
+    std::vector<Column> cols;
+    setupColumns(filterAttrs, cols);
+
+    return readObject(vecIndex, cols);
+}
+
+VectorShapeRef ShapeReader::readObject(unsigned int vecIndex,const std::vector<Column> &cols)
 {
     // Read from disk
 	SHPObject *thisShape = SHPReadObject((SHPInfo *)shp, vecIndex);
+    if (!thisShape)
+        return VectorShapeRef();
     
     VectorShapeRef theShape;
 	
@@ -148,41 +200,36 @@ VectorShapeRef ShapeReader::getObjectByIndex(unsigned int vecIndex,const StringS
     }
 	
 	SHPDestroyObject(thisShape);
+    if (!theShape)
+        return VectorShapeRef();
 	
 	// Attributes
-	char attrTitle[12];
-	int attrWidth, numDecimals;
     MutableDictionaryRef attrDict = theShape->getAttrDict();
 	DBFHandle dbfHandle = (DBFHandle)dbf;
 	int numDbfRecord = DBFGetRecordCount(dbfHandle);
 	if (vecIndex < numDbfRecord)
 	{
-		for (unsigned int ii = 0; ii < DBFGetFieldCount(dbfHandle); ii++)
+		for (const Column &col : cols)
 		{
-			DBFFieldType attrType = DBFGetFieldInfo(dbfHandle, ii, attrTitle, &attrWidth, &numDecimals);
-            // If we have a set of filter attrs, skip this one if it's not there
-            if (filterAttrs && (filterAttrs->find(attrTitle) == filterAttrs->end()))
-                continue;
-			
-			if (!DBFIsAttributeNULL(dbfHandle, vecIndex, ii))
+			if (!DBFIsAttributeNULL(dbfHandle, vecIndex, col.field))
 			{
-				switch (attrType)
+				switch (col.type)
 				{
 					case FTString:
 					{
-						const char *str = DBFReadStringAttribute(dbfHandle, vecIndex, ii);
+						const char *str = DBFReadStringAttribute(dbfHandle, vecIndex, col.field);
                         if (str)
-                            attrDict->setString(attrTitle, str);
+                            attrDict->setString(col.name, str);
 					}
 						break;
 					case FTInteger:
 					{
-                        attrDict->setInt(attrTitle, DBFReadIntegerAttribute(dbfHandle, vecIndex, ii));
+                        attrDict->setInt(col.name, DBFReadIntegerAttribute(dbfHandle, vecIndex, col.field));
 					}
 						break;
 					case FTDouble:
 					{
-                        attrDict->setDouble(attrTitle, DBFReadDoubleAttribute(dbfHandle, vecIndex, ii));
+                        attrDict->setDouble(col.name, DBFReadDoubleAttribute(dbfHandle, vecIndex, col.field));
 					}
 						break;
                     default:
@@ -211,4 +258,275 @@ VectorShapeRef ShapeReader::getNextObject(const StringSet *filterAttrs)
     return retShape;
 }
 	
+
+/* Our own index file is a header, the level boundaries and then the nodes of a
+   packed R-tree in the native byte order.  Leaves are the records sorted along
+   a Hilbert curve, then each level up, with the root last.
+ */
+
+// Number of children per R-tree node
+static const uint32_t ShapeIndexNodeSize = 16;
+
+static const char ShapeIndexMagic[4] = {'W','K','S','I'};
+static const uint32_t ShapeIndexVersion = 1;
+
+typedef struct
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t numRecords;
+    uint32_t nodeSize;
+    uint32_t numNodes;
+    uint32_t numLevels;
+    uint64_t shpFileSize;
+} ShapeIndexHeader;
+
+// Shapefile records are little endian
+static double ShapeReadDouble(const unsigned char *data)
+{
+    uint64_t bits = 0;
+    for (int ii=7;ii>=0;ii--)
+        bits = (bits << 8) | data[ii];
+    double val;
+    memcpy(&val,&bits,sizeof(val));
+    return val;
+}
+
+bool ShapeReader::readRecordMbr(unsigned int vecIndex,double *mbr)
+{
+    SHPHandle hSHP = (SHPHandle)shp;
+    if (vecIndex >= (unsigned int)hSHP->nRecords || hSHP->panRecSize[vecIndex] < 4)
+        return false;
+
+    // Record header, shape type and then either a point or a bounding box
+    unsigned char buf[44];
+    const size_t len = std::min((size_t)hSHP->panRecSize[vecIndex] + 8,sizeof(buf));
+    if (hSHP->sHooks.FSeek(hSHP->fpSHP, hSHP->panRecOffset[vecIndex], 0) != 0 ||
+        hSHP->sHooks.FRead(buf, len, 1, hSHP->fpSHP) != 1)
+        return false;
+    const int recType = buf[8] | (buf[9] << 8) | (buf[10] << 16) | (buf[11] << 24);
+    switch (recType)
+    {
+        case SHPT_NULL:
+            return false;
+        case SHPT_POINT:
+        case SHPT_POINTZ:
+        case SHPT_POINTM:
+            if (len < 28)
+                return false;
+            mbr[0] = mbr[2] = ShapeReadDouble(&buf[12]);
+            mbr[1] = mbr[3] = ShapeReadDouble(&buf[20]);
+            break;
+        default:
+            if (len < 44)
+                return false;
+            for (unsigned int ii=0;ii<4;ii++)
+                mbr[ii] = ShapeReadDouble(&buf[12+8*ii]);
+            break;
+    }
+
+    return true;
+}
+
+void ShapeReader::buildIndex()
+{
+    indexNodes.clear();
+    indexLevels.clear();
+
+    // Leaves are the records with bounds, sorted along the curve
+    const double spanX = std::max(maxBound[0] - minBound[0],1e-12);
+    const double spanY = std::max(maxBound[1] - minBound[1],1e-12);
+    std::vector<std::pair<uint32_t,IndexNode> > leaves;
+    leaves.reserve(numEntity);
+    for (int ii=0;ii<numEntity;ii++)
+    {
+        IndexNode node;
+        if (!readRecordMbr(ii,node.mbr))
+            continue;
+        node.index = ii;
+        node.pad = 0;
+        const double cx = ((node.mbr[0] + node.mbr[2]) / 2.0 - minBound[0]) / spanX;
+        const double cy = ((node.mbr[1] + node.mbr[3]) / 2.0 - minBound[1]) / spanY;
+        leaves.push_back(std::make_pair(HilbertIndexFraction(cx,cy),node));
+    }
+    std::stable_sort(leaves.begin(),leaves.end(),
+                     [](const std::pair<uint32_t,IndexNode> &a,const std::pair<uint32_t,IndexNode> &b)
+                     { return a.first < b.first; });
+    if (leaves.empty())
+        return;
+
+    indexNodes.reserve(leaves.size() + leaves.size()/(ShapeIndexNodeSize-1) + 1);
+    for (const auto &leaf : leaves)
+        indexNodes.push_back(leaf.second);
+
+    // Then each level up until there's just the root
+    PackedRTreeBuild(indexNodes,indexLevels,ShapeIndexNodeSize);
+}
+
+bool ShapeReader::readIndex(const std::string &indexFile)
+{
+    FILE *fp = fopen(indexFile.c_str(),"rb");
+    if (!fp)
+        return false;
+
+    bool success = true;
+    try
+    {
+        ShapeIndexHeader header;
+        if (fread(&header,sizeof(header),1,fp) != 1)
+            throw 1;
+        // Rebuild if it's not ours or the shapefile changed under it
+        if (memcmp(header.magic,ShapeIndexMagic,4) || header.version != ShapeIndexVersion ||
+            header.nodeSize != ShapeIndexNodeSize || header.numRecords != (uint32_t)numEntity ||
+            header.shpFileSize != ((SHPHandle)shp)->nFileSize ||
+            header.numLevels == 0 || header.numNodes == 0)
+            throw 1;
+        // The counts have to match the file before we trust them for anything
+        if (fseek(fp,0,SEEK_END) != 0 ||
+            ftell(fp) != (long)(sizeof(header) + (uint64_t)header.numLevels*sizeof(uint32_t) + (uint64_t)header.numNodes*sizeof(IndexNode)) ||
+            fseek(fp,sizeof(header),SEEK_SET) != 0)
+            throw 1;
+        indexLevels.resize(header.numLevels);
+        indexNodes.resize(header.numNodes);
+        if (fread(&indexLevels[0],sizeof(uint32_t),header.numLevels,fp) != header.numLevels ||
+            fread(&indexNodes[0],sizeof(IndexNode),header.numNodes,fp) != header.numNodes)
+            throw 1;
+        // Every node has to point at a record or at children on the level below
+        if (!PackedRTreeCheckLevels(&indexLevels[0],header.numLevels,header.numNodes) ||
+            !PackedRTreeCheckNodes(&indexNodes[0],&indexLevels[0],header.numLevels,(uint32_t)numEntity))
+            throw 1;
+    }
+    catch (...)
+    {
+        indexLevels.clear();
+        indexNodes.clear();
+        success = false;
+    }
+    fclose(fp);
+
+    return success;
+}
+
+bool ShapeReader::writeIndex(const std::string &indexFile)
+{
+    FILE *fp = fopen(indexFile.c_str(),"wb");
+    if (!fp)
+        return false;
+
+    bool success = true;
+    try
+    {
+        ShapeIndexHeader header;
+        memset(&header,0,sizeof(header));
+        memcpy(header.magic,ShapeIndexMagic,4);
+        header.version = ShapeIndexVersion;
+        header.numRecords = numEntity;
+        header.nodeSize = ShapeIndexNodeSize;
+        header.numNodes = (uint32_t)indexNodes.size();
+        header.numLevels = (uint32_t)indexLevels.size();
+        header.shpFileSize = ((SHPHandle)shp)->nFileSize;
+        if (fwrite(&header,sizeof(header),1,fp) != 1)
+            throw 1;
+        if (!indexNodes.empty())
+        {
+            if (fwrite(&indexLevels[0],sizeof(uint32_t),indexLevels.size(),fp) != indexLevels.size() ||
+                fwrite(&indexNodes[0],sizeof(IndexNode),indexNodes.size(),fp) != indexNodes.size())
+                throw 1;
+        }
+    }
+    catch (...)
+    {
+        success = false;
+    }
+    fclose(fp);
+    if (!success)
+        remove(indexFile.c_str());
+
+    return success;
+}
+
+bool ShapeReader::loadSpatialIndex(const std::string &indexFile)
+{
+    if (!shp)
+        return false;
+    if (indexLoaded)
+        return true;
+    indexLoaded = true;
+
+    // Our own index, if it's there and up to date
+    const std::string ourIndexFile = indexFile.empty() ? baseName + ".wkix" : indexFile;
+    if (readIndex(ourIndexFile))
+        return true;
+
+    // Then a quadtree from shptree or mapserver
+    if (indexFile.empty())
+    {
+        const std::string qixFile = baseName + ".qix";
+        qixTree = SHPOpenDiskTree(qixFile.c_str(), NULL);
+        if (qixTree)
+            return true;
+    }
+
+    // Build our own and save it for later.  It's fine if we can't write it.
+    buildIndex();
+    if (!writeIndex(ourIndexFile))
+        wkLogLevel(Debug, "ShapeReader: Couldn't write spatial index to %s",ourIndexFile.c_str());
+
+    return true;
+}
+
+void ShapeReader::queryMbr(const Mbr &mbr,std::vector<unsigned int> &indices)
+{
+    if (!loadSpatialIndex() || !mbr.valid())
+        return;
+
+    // Shapefiles are in degrees
+    double query[4] = {RadToDeg<double>(mbr.ll().x()),RadToDeg<double>(mbr.ll().y()),
+                       RadToDeg<double>(mbr.ur().x()),RadToDeg<double>(mbr.ur().y())};
+
+    if (qixTree)
+    {
+        // The quadtree only narrows it down by node, so check the records too
+        double boundsMin[4] = {query[0],query[1],0.0,0.0};
+        double boundsMax[4] = {query[2],query[3],0.0,0.0};
+        int numFound = 0;
+        int *found = SHPSearchDiskTreeEx((SHPTreeDiskHandle)qixTree, boundsMin, boundsMax, &numFound);
+        for (int ii=0;ii<numFound;ii++)
+        {
+            double recMbr[4];
+            if (found[ii] >= 0 && found[ii] < numEntity &&
+                readRecordMbr(found[ii],recMbr) && PackedRTreeOverlaps(recMbr,query))
+                indices.push_back(found[ii]);
+        }
+        if (found)
+            free(found);
+        return;
+    }
+
+    if (indexNodes.empty())
+        return;
+
+    PackedRTreeQuery(&indexNodes[0],&indexLevels[0],(uint32_t)indexLevels.size(),ShapeIndexNodeSize,(uint32_t)numEntity,query,indices);
+
+    // Reading in file order keeps the seeks going forward
+    std::sort(indices.begin(),indices.end());
+}
+
+void ShapeReader::getObjectsInMbr(const Mbr &mbr,const StringSet *filterAttrs,ShapeSet &shapes)
+{
+    std::vector<unsigned int> indices;
+    queryMbr(mbr,indices);
+    if (indices.empty())
+        return;
+
+    std::vector<Column> cols;
+    setupColumns(filterAttrs, cols);
+    for (unsigned int which : indices)
+    {
+        VectorShapeRef shape = readObject(which, cols);
+        if (shape)
+            shapes.insert(shape);
+    }
+}
+
 }
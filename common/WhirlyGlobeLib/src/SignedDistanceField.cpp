@@ -0,0 +1,347 @@
+/*
+ *  SignedDistanceField.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <stdio.h>
+#import <string.h>
+#import <math.h>
+#import <algorithm>
+#import <functional>
+#import <thread>
+#import "SignedDistanceField.h"
+
+namespace WhirlyKit
+{
+
+static const float SDFInfinity = 1e20f;
+// Below this many pixels per worker, starting threads costs more than it saves
+static const int SDFMinPixelsPerThread = 128*128;
+
+static int SDFNumThreads(int numThreads)
+{
+    if (numThreads <= 0)
+        numThreads = std::thread::hardware_concurrency();
+    return std::max(1,std::min(numThreads,8));
+}
+
+// Run the work in chunks of [start,end) on up to numThreads threads, including this one
+static void SDFParallelFor(int count,int numThreads,const std::function<void(int,int)> &work)
+{
+    numThreads = std::max(1,std::min(numThreads,count));
+    if (numThreads == 1)
+    {
+        work(0,count);
+        return;
+    }
+
+    const int chunk = (count + numThreads - 1) / numThreads;
+    std::vector<std::thread> threads;
+    for (int start = chunk;start < count;start += chunk)
+        threads.emplace_back(work,start,std::min(start+chunk,count));
+    work(0,std::min(chunk,count));
+    for (auto &thread : threads)
+        thread.join();
+}
+
+// Squared distance transform of a sampled function in one dimension.
+// v, z are scratch of n and n+1 entries.
+static void DistanceTransform1D(const float *f,int n,float *d,int *v,float *z)
+{
+    int k = 0;
+    v[0] = 0;
+    z[0] = -SDFInfinity;
+    z[1] = SDFInfinity;
+    for (int q=1;q<n;q++)
+    {
+        float s = ((f[q]+q*q) - (f[v[k]]+v[k]*v[k])) / (2*q - 2*v[k]);
+        while (s <= z[k])
+        {
+            k--;
+            s = ((f[q]+q*q) - (f[v[k]]+v[k]*v[k])) / (2*q - 2*v[k]);
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k+1] = SDFInfinity;
+    }
+
+    k = 0;
+    for (int q=0;q<n;q++)
+    {
+        while (z[k+1] < q)
+            k++;
+        d[q] = (q-v[k])*(q-v[k]) + f[v[k]];
+    }
+}
+
+// Squared distance transform of a grid, in place.  Columns first, then rows.
+static void DistanceTransform2D(std::vector<float> &grid,int width,int height,int numThreads)
+{
+    SDFParallelFor(width, numThreads, [&](int startX,int endX)
+    {
+        std::vector<float> f(height),d(height),z(height+1);
+        std::vector<int> v(height);
+        for (int x=startX;x<endX;x++)
+        {
+            for (int y=0;y<height;y++)
+                f[y] = grid[y*width+x];
+            DistanceTransform1D(&f[0], height, &d[0], &v[0], &z[0]);
+            for (int y=0;y<height;y++)
+                grid[y*width+x] = d[y];
+        }
+    });
+
+    SDFParallelFor(height, numThreads, [&](int startY,int endY)
+    {
+        std::vector<float> d(width),z(width+1);
+        std::vector<int> v(width);
+        for (int y=startY;y<endY;y++)
+        {
+            float *row = &grid[y*width];
+            DistanceTransform1D(row, width, &d[0], &v[0], &z[0]);
+            std::copy(d.begin(), d.end(), row);
+        }
+    });
+}
+
+static void GenerateSignedDistanceFieldThreads(const unsigned char *coverage,int width,int height,int pixelStride,int rowBytes,int spread,std::vector<unsigned char> &field,int numThreads)
+{
+    const int fieldWidth = width + 2*spread, fieldHeight = height + 2*spread;
+    const int numPixels = fieldWidth*fieldHeight;
+    field.resize(numPixels);
+    if (numPixels == 0)
+        return;
+
+    // Distance to the nearest inside pixel and to the nearest outside pixel
+    std::vector<float> toInside(numPixels,SDFInfinity),toOutside(numPixels,0.0);
+    std::vector<float> partial(numPixels,-1.0);
+    for (int y=0;y<height;y++)
+    {
+        const unsigned char *row = coverage + y*rowBytes;
+        for (int x=0;x<width;x++)
+        {
+            const unsigned char val = row[x*pixelStride];
+            const int which = (y+spread)*fieldWidth + x+spread;
+            if (val >= 128)
+            {
+                toInside[which] = 0.0;
+                toOutside[which] = SDFInfinity;
+            }
+            // Anti-aliased pixels tell us where the edge is better than the transform can
+            if (val > 0 && val < 255)
+                partial[which] = 0.5 - val/255.0;
+        }
+    }
+
+    DistanceTransform2D(toInside, fieldWidth, fieldHeight, numThreads);
+    DistanceTransform2D(toOutside, fieldWidth, fieldHeight, numThreads);
+
+    // Positive outside, negative inside, with the edge half way between pixels
+    const float scale = 1.0 / (2.0*spread);
+    for (int ii=0;ii<numPixels;ii++)
+    {
+        float dist;
+        if (partial[ii] > -1.0)
+            dist = partial[ii];
+        else if (toInside[ii] > 0.0)
+            dist = sqrtf(toInside[ii]) - 0.5;
+        else
+            dist = 0.5 - sqrtf(toOutside[ii]);
+        const float val = std::min(std::max(0.5f - dist*scale,0.f),1.f);
+        field[ii] = (unsigned char)(val * 255.0 + 0.5);
+    }
+}
+
+void GenerateSignedDistanceField(const unsigned char *coverage,int width,int height,int pixelStride,int rowBytes,int spread,std::vector<unsigned char> &field,int numThreads)
+{
+    const int numPixels = (width + 2*spread) * (height + 2*spread);
+    numThreads = std::min(SDFNumThreads(numThreads),std::max(1,numPixels / SDFMinPixelsPerThread));
+
+    GenerateSignedDistanceFieldThreads(coverage, width, height, pixelStride, rowBytes, spread, field, numThreads);
+}
+
+void GenerateSignedDistanceFields(const std::vector<SDFSource> &sources,int spread,std::vector<std::vector<unsigned char> > &fields,int numThreads)
+{
+    fields.resize(sources.size());
+
+    SDFParallelFor((int)sources.size(), SDFNumThreads(numThreads), [&](int start,int end)
+    {
+        for (int ii=start;ii<end;ii++)
+        {
+            const SDFSource &source = sources[ii];
+            GenerateSignedDistanceFieldThreads(source.coverage, source.width, source.height, source.pixelStride, source.rowBytes, spread, fields[ii], 1);
+        }
+    });
+}
+
+SDFGlyphCache::SDFGlyphCache()
+: refSize(0.0), spread(0), dirty(false)
+{
+}
+
+void SDFGlyphCache::setParams(float inRefSize,int inSpread)
+{
+    if (refSize == inRefSize && spread == inSpread)
+        return;
+
+    refSize = inRefSize;
+    spread = inSpread;
+    glyphs.clear();
+}
+
+const SDFGlyph *SDFGlyphCache::findGlyph(const std::string &fontKey,uint32_t glyph) const
+{
+    auto it = glyphs.find(GlyphKey(fontKey,glyph));
+    if (it == glyphs.end())
+        return NULL;
+
+    return &it->second;
+}
+
+const SDFGlyph *SDFGlyphCache::addGlyph(const std::string &fontKey,uint32_t glyph,const SDFGlyph &sdfGlyph)
+{
+    dirty = true;
+    SDFGlyph &entry = glyphs[GlyphKey(fontKey,glyph)];
+    entry = sdfGlyph;
+
+    return &entry;
+}
+
+void SDFGlyphCache::clear()
+{
+    glyphs.clear();
+    dirty = false;
+}
+
+// File layout, in native byte order:
+//   header:  magic, version, reference size, spread, number of glyphs
+//   glyphs:  font key length and bytes, glyph, width, height,
+//            size, offset and texture offset, then width*height field bytes
+static const char SDFCacheMagic[8] = {'W','K','S','D','F','G','L','Y'};
+static const uint32_t SDFCacheVersion = 1;
+
+template<typename T> static bool SDFRead(FILE *fp,T &val)
+{
+    return fread(&val, sizeof(T), 1, fp) == 1;
+}
+
+template<typename T> static bool SDFWrite(FILE *fp,const T &val)
+{
+    return fwrite(&val, sizeof(T), 1, fp) == 1;
+}
+
+bool SDFGlyphCache::readFromFile(const std::string &fileName)
+{
+    FILE *fp = fopen(fileName.c_str(), "rb");
+    if (!fp)
+        return false;
+
+    bool ret = false;
+    GlyphMap newGlyphs;
+    try
+    {
+        char magic[8];
+        uint32_t version,numGlyphs;
+        float fileRefSize;
+        int32_t fileSpread;
+        if (fread(magic, 1, sizeof(magic), fp) != sizeof(magic) || memcmp(magic, SDFCacheMagic, sizeof(magic)) ||
+            !SDFRead(fp,version) || version != SDFCacheVersion ||
+            !SDFRead(fp,fileRefSize) || !SDFRead(fp,fileSpread) || !SDFRead(fp,numGlyphs))
+            throw 1;
+        // Fields for a different setup are no use to us
+        if (fileRefSize != refSize || fileSpread != spread)
+            throw 1;
+
+        for (uint32_t ii=0;ii<numGlyphs;ii++)
+        {
+            uint32_t keyLen,glyph;
+            if (!SDFRead(fp,keyLen) || keyLen > 1024)
+                throw 1;
+            std::string fontKey(keyLen,' ');
+            if ((keyLen > 0 && fread(&fontKey[0], 1, keyLen, fp) != keyLen) || !SDFRead(fp,glyph))
+                throw 1;
+
+            SDFGlyph sdfGlyph;
+            int32_t width,height;
+            float metrics[6];
+            if (!SDFRead(fp,width) || !SDFRead(fp,height) || width < 0 || height < 0 || width > 4096 || height > 4096 ||
+                fread(metrics, sizeof(float), 6, fp) != 6)
+                throw 1;
+            sdfGlyph.width = width;
+            sdfGlyph.height = height;
+            sdfGlyph.size = Point2f(metrics[0],metrics[1]);
+            sdfGlyph.offset = Point2f(metrics[2],metrics[3]);
+            sdfGlyph.textureOffset = Point2f(metrics[4],metrics[5]);
+            sdfGlyph.field.resize(width*height);
+            if (!sdfGlyph.field.empty() && fread(&sdfGlyph.field[0], 1, sdfGlyph.field.size(), fp) != sdfGlyph.field.size())
+                throw 1;
+
+            newGlyphs[GlyphKey(fontKey,glyph)] = sdfGlyph;
+        }
+        ret = true;
+    }
+    catch (...)
+    {
+    }
+    fclose(fp);
+
+    // Anything we built since takes precedence
+    if (ret)
+        glyphs.insert(newGlyphs.begin(),newGlyphs.end());
+
+    return ret;
+}
+
+bool SDFGlyphCache::writeToFile(const std::string &fileName)
+{
+    const std::string tmpName = fileName + ".tmp";
+    FILE *fp = fopen(tmpName.c_str(), "wb");
+    if (!fp)
+        return false;
+
+    bool ret = fwrite(SDFCacheMagic, 1, sizeof(SDFCacheMagic), fp) == sizeof(SDFCacheMagic) &&
+                SDFWrite(fp,SDFCacheVersion) && SDFWrite(fp,refSize) && SDFWrite(fp,(int32_t)spread) &&
+                SDFWrite(fp,(uint32_t)glyphs.size());
+    for (auto it = glyphs.begin();ret && it != glyphs.end();++it)
+    {
+        const std::string &fontKey = it->first.first;
+        const SDFGlyph &sdfGlyph = it->second;
+        const float metrics[6] = {sdfGlyph.size.x(),sdfGlyph.size.y(),sdfGlyph.offset.x(),sdfGlyph.offset.y(),
+                                  sdfGlyph.textureOffset.x(),sdfGlyph.textureOffset.y()};
+        ret = SDFWrite(fp,(uint32_t)fontKey.size()) &&
+              fwrite(fontKey.data(), 1, fontKey.size(), fp) == fontKey.size() &&
+              SDFWrite(fp,it->first.second) &&
+              SDFWrite(fp,(int32_t)sdfGlyph.width) && SDFWrite(fp,(int32_t)sdfGlyph.height) &&
+              fwrite(metrics, sizeof(float), 6, fp) == 6 &&
+              fwrite(sdfGlyph.field.data(), 1, sdfGlyph.field.size(), fp) == sdfGlyph.field.size();
+    }
+    if (fclose(fp) != 0)
+        ret = false;
+
+    if (!ret || rename(tmpName.c_str(), fileName.c_str()) != 0)
+    {
+        remove(tmpName.c_str());
+        return false;
+    }
+    dirty = false;
+
+    return true;
+}
+
+}
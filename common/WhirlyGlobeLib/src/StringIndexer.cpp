@@ -25,6 +25,38 @@
 
 namespace WhirlyKit {
     
+// Entries in the first segment.  Each after that doubles.
+static const unsigned int SegmentBaseBits = 6;
+// Marks an indexed name we haven't worked out yet
+static const StringIdentity UnknownStringID = (StringIdentity)-1;
+
+StringIndexer::Entry::Entry()
+: indexedID(UnknownStringID)
+{
+}
+
+StringIndexer::HashTable::HashTable(unsigned int size)
+: mask(size-1), slots(new std::atomic<uint64_t>[size])
+{
+    for (unsigned int ii=0;ii<size;ii++)
+        slots[ii].store(0,std::memory_order_relaxed);
+}
+
+StringIndexer::StringIndexer()
+: numStrings(0)
+{
+    for (unsigned int ii=0;ii<NumSegments;ii++)
+        segments[ii].store(NULL,std::memory_order_relaxed);
+    tables.push_back(std::unique_ptr<HashTable>(new HashTable(256)));
+    table.store(tables.back().get(),std::memory_order_release);
+}
+
+StringIndexer::~StringIndexer()
+{
+    for (unsigned int ii=0;ii<NumSegments;ii++)
+        delete [] segments[ii].load(std::memory_order_relaxed);
+}
+
 StringIndexer &StringIndexer::getInstance()
 {
     static StringIndexer instance;
@@ -32,33 +64,123 @@ StringIndexer &StringIndexer::getInstance()
     return instance;
 }
 
+// FNV-1a
+uint32_t StringIndexer::hashString(const std::string &str)
+{
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : str)
+    {
+        hash ^= c;
+        hash *= 16777619u;
+    }
+    
+    return hash;
+}
+
+StringIndexer::Entry *StringIndexer::getEntry(StringIdentity strID)
+{
+    const unsigned int seg = 31 - __builtin_clz((unsigned int)(strID >> SegmentBaseBits) + 1);
+    const StringIdentity segStart = ((StringIdentity)1 << SegmentBaseBits) * (((StringIdentity)1 << seg) - 1);
+    
+    return &segments[seg].load(std::memory_order_acquire)[strID - segStart];
+}
+
+bool StringIndexer::lookup(const std::string &str,uint32_t hash,StringIdentity &strID)
+{
+    HashTable *curTable = table.load(std::memory_order_acquire);
+    for (unsigned int which = hash & curTable->mask;;which = (which+1) & curTable->mask)
+    {
+        const uint64_t slot = curTable->slots[which].load(std::memory_order_acquire);
+        if (slot == 0)
+            return false;
+        if ((uint32_t)(slot >> 32) == hash)
+        {
+            const StringIdentity thisID = (StringIdentity)(slot & 0xFFFFFFFF) - 1;
+            if (getEntry(thisID)->str == str)
+            {
+                strID = thisID;
+                return true;
+            }
+        }
+    }
+}
+
+void StringIndexer::insertLocked(HashTable *inTable,uint32_t hash,StringIdentity strID)
+{
+    unsigned int which = hash & inTable->mask;
+    while (inTable->slots[which].load(std::memory_order_relaxed) != 0)
+        which = (which+1) & inTable->mask;
+    inTable->slots[which].store(((uint64_t)hash << 32) | (uint64_t)(strID+1),std::memory_order_release);
+}
+
 StringIdentity StringIndexer::getStringID(const std::string &str)
 {
     StringIndexer &index = getInstance();
     
+    // Most of the time it's already there
+    const uint32_t hash = hashString(str);
+    StringIdentity strID;
+    if (index.lookup(str,hash,strID))
+        return strID;
+    
     std::lock_guard<std::mutex> lock(index.mutex);
     
-    auto it = index.stringToIdent.find(str);
-    if (it != index.stringToIdent.end())
-        return it->second;
+    // Someone else may have just added it
+    if (index.lookup(str,hash,strID))
+        return strID;
     
-    int strID = index.identToString.size();
-    index.identToString.push_back(str);
-    index.stringToIdent[str] = strID;
+    // Fill in the entry first, so it's there before anyone can find it
+    strID = index.numStrings.load(std::memory_order_relaxed);
+    const unsigned int seg = 31 - __builtin_clz((unsigned int)(strID >> SegmentBaseBits) + 1);
+    if (!index.segments[seg].load(std::memory_order_relaxed))
+        index.segments[seg].store(new Entry[(StringIdentity)1 << (SegmentBaseBits+seg)],std::memory_order_release);
+    index.getEntry(strID)->str = str;
+    index.numStrings.store(strID+1,std::memory_order_release);
+    
+    // Keep the table under half full.  A new one gets everything and then replaces the old.
+    HashTable *curTable = index.table.load(std::memory_order_relaxed);
+    if (2*(strID+1) > curTable->mask+1)
+    {
+        HashTable *newTable = new HashTable(2*(curTable->mask+1));
+        for (StringIdentity oldID=0;oldID<strID;oldID++)
+            index.insertLocked(newTable,hashString(index.getEntry(oldID)->str),oldID);
+        index.tables.push_back(std::unique_ptr<HashTable>(newTable));
+        index.table.store(newTable,std::memory_order_release);
+        curTable = newTable;
+    }
+    index.insertLocked(curTable,hash,strID);
     
     return strID;
 }
 
-std::string StringIndexer::getString(StringIdentity strID)
+const std::string &StringIndexer::getString(StringIdentity strID)
 {
+    static const std::string emptyStr;
     StringIndexer &index = getInstance();
     
-    std::lock_guard<std::mutex> lock(index.mutex);
+    if (strID >= index.numStrings.load(std::memory_order_acquire))
+        return emptyStr;
+    
+    return index.getEntry(strID)->str;
+}
+
+StringIdentity StringIndexer::getIndexedStringID(StringIdentity strID)
+{
+    StringIndexer &index = getInstance();
     
-    if (strID >= index.identToString.size())
-        return "";
+    if (strID >= index.numStrings.load(std::memory_order_acquire))
+        return getStringID("[0]");
+    
+    // Work it out the first time.  Doing it twice on different threads is harmless.
+    Entry *entry = index.getEntry(strID);
+    StringIdentity indexedID = entry->indexedID.load(std::memory_order_acquire);
+    if (indexedID == UnknownStringID)
+    {
+        indexedID = getStringID(entry->str + "[0]");
+        entry->indexedID.store(indexedID,std::memory_order_release);
+    }
     
-    return index.identToString[strID];
+    return indexedID;
 }
     
 // Shared global string IDs speed things up a lot
@@ -115,6 +237,7 @@ StringIdentity a_modelCenterNameID;
 StringIdentity a_useInstanceColorNameID;
 StringIdentity a_instanceColorNameID;
 StringIdentity a_modelDirNameID;
+StringIdentity a_sdfParamsNameID;
 
 // Turn the string names into IDs, but just once
 static bool stringsSetup = false;
@@ -192,6 +315,7 @@ void SetupDrawableStrings()
     a_useInstanceColorNameID = StringIndexer::getStringID("a_useInstanceColor");
     a_instanceColorNameID = StringIndexer::getStringID("a_instanceColor");
     a_modelDirNameID = StringIndexer::getStringID("a_modelDir");
+    a_sdfParamsNameID = StringIndexer::getStringID("a_sdfParams");
 
     stringsSetup = true;
 }
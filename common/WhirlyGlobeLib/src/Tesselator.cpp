@@ -19,6 +19,8 @@
  */
 
 #import <list>
+#import <limits>
+#import <memory>
 #import "Tesselator.h"
 #import "glues.h"
 
@@ -32,35 +34,21 @@ namespace WhirlyKit
 typedef struct
 {
     Point3fVector pts;
-    std::vector<std::vector<int>> tris;
-//    std::vector<int> vertIDs;
+    // Flat list of triangle vertices, three at a time
+    std::vector<int> tris;
     bool newVert;
 } TriangulationInfo;
     
 // Called for every vertex
 static void vertexCallback(int which,TriangulationInfo *triInfo)
 {
-//    triInfo->vertIDs.push_back(which);
-    std::vector<int> *tri = &(triInfo->tris.back());
-    if (tri->size() == 3)
-    {
-        triInfo->tris.resize(triInfo->tris.size()+1);
-        tri = &(triInfo->tris.back());
-    }
-    tri->push_back(which);
+    triInfo->tris.push_back(which);
 }
     
 // We need to add a new vertex
 static void combineCallback(const GLfloat newVertex[3], const int neighborVertex[4],
                                 const GLfloat neighborWeight[4], GLfloat **outData, TriangulationInfo *triInfo)
 {
-//    int neighbors[4];
-//    for (unsigned int ii=0;ii<4;ii++)
-//        neighbors[ii] = neighborVertex[ii];
-//    Point3f p0 = triInfo->pts[neighbors[0]];
-//    Point3f p1 = triInfo->pts[neighbors[1]];
-//    NSLog(@"NewVertex = (%f,%f), neighorVertex = (%d,%d,%d,%d), weights = (%f,%f,%f,%f)\n\tp0 = (%f,%f), p1 = (%f,%f)",newVertex[0],newVertex[1],neighbors[0],neighbors[1],neighbors[2],neighbors[3],neighborWeight[0],neighborWeight[1],neighborWeight[2],neighborWeight[3],p0.x(),p0.y(),p1.x(),p1.y());
-    
     triInfo->pts.push_back(Point3f(newVertex[0],newVertex[1],0.0));
     *outData = (GLfloat *)(triInfo->pts.size()-1);
     
@@ -69,7 +57,8 @@ static void combineCallback(const GLfloat newVertex[3], const int neighborVertex
 
 static void beginCallback(GLenum type,TriangulationInfo *triInfo)
 {
-    triInfo->tris.resize(triInfo->tris.size()+1);
+    // Toss anything left over from a partial primitive
+    triInfo->tris.resize(triInfo->tris.size() - triInfo->tris.size() % 3);
 }
     
 static void endCallback(TriangulationInfo *triInfo)
@@ -87,6 +76,690 @@ static void errorCallback(GLenum error,TriangulationInfo *triInfo)
 }
     
 static const float PolyScale2 = 1e6;
+
+// If the ear clipper's area is off by more than this fraction, we fall back to libtess
+static const double EarcutAreaTolerance = 1e-4;
+
+/* Ear clipping tesselator.
+   This follows the approach in Mapbox's earcut: a doubly linked ring per loop,
+   holes bridged into the outer ring, a z-order curve to speed up the ear checks
+   on bigger polygons, and a couple of fallback passes for messier input.
+ */
+class EarcutNode
+{
+public:
+    int i;
+    double x,y;
+    EarcutNode *prev,*next;
+    int32_t z;
+    EarcutNode *prevZ,*nextZ;
+    bool steiner;
+};
+
+class Earcut
+{
+public:
+    // Triangulate the flat list of coordinates.  Holes start at the given point indices.
+    void run(const std::vector<double> &data,const std::vector<int> &holeIndices,std::vector<int> &triangles)
+    {
+        numNodes = 0;
+        const int outerLen = holeIndices.empty() ? (int)data.size() : holeIndices[0]*2;
+        EarcutNode *outerNode = linkedList(data,0,outerLen,true);
+        if (!outerNode || outerNode->next == outerNode->prev)
+            return;
+
+        if (!holeIndices.empty())
+            outerNode = eliminateHoles(data,holeIndices,outerNode);
+
+        // Hash the bigger ones on a z-order curve
+        double minX = 0.0, minY = 0.0, invSize = 0.0;
+        if ((int)data.size() > 80*2)
+        {
+            minX = data[0];  minY = data[1];
+            double maxX = minX, maxY = minY;
+            for (int ii=2;ii<outerLen;ii+=2)
+            {
+                minX = std::min(minX,data[ii]);  minY = std::min(minY,data[ii+1]);
+                maxX = std::max(maxX,data[ii]);  maxY = std::max(maxY,data[ii+1]);
+            }
+            invSize = std::max(maxX - minX,maxY - minY);
+            invSize = invSize != 0.0 ? 32767.0 / invSize : 0.0;
+        }
+
+        earcutLinked(outerNode,triangles,minX,minY,invSize,0);
+    }
+
+protected:
+    EarcutNode *createNode(int i,double x,double y)
+    {
+        // Nodes live in blocks we keep around between runs
+        const size_t blockSize = 256;
+        if (numNodes == blocks.size()*blockSize)
+            blocks.push_back(std::unique_ptr<EarcutNode[]>(new EarcutNode[blockSize]));
+        EarcutNode *node = &blocks[numNodes/blockSize][numNodes%blockSize];
+        numNodes++;
+        node->i = i;  node->x = x;  node->y = y;
+        node->prev = node->next = NULL;
+        node->z = 0;
+        node->prevZ = node->nextZ = NULL;
+        node->steiner = false;
+        return node;
+    }
+
+    EarcutNode *insertNode(int i,double x,double y,EarcutNode *last)
+    {
+        EarcutNode *p = createNode(i,x,y);
+        if (!last)
+        {
+            p->prev = p;
+            p->next = p;
+        } else {
+            p->next = last->next;
+            p->prev = last;
+            last->next->prev = p;
+            last->next = p;
+        }
+        return p;
+    }
+
+    static void removeNode(EarcutNode *p)
+    {
+        p->next->prev = p->prev;
+        p->prev->next = p->next;
+        if (p->prevZ)
+            p->prevZ->nextZ = p->nextZ;
+        if (p->nextZ)
+            p->nextZ->prevZ = p->prevZ;
+    }
+
+    static double signedArea(const std::vector<double> &data,int start,int end)
+    {
+        double sum = 0.0;
+        for (int i=start,j=end-2;i<end;i+=2)
+        {
+            sum += (data[j] - data[i]) * (data[i+1] + data[j+1]);
+            j = i;
+        }
+        return sum;
+    }
+
+    // Build a ring with the given winding
+    EarcutNode *linkedList(const std::vector<double> &data,int start,int end,bool clockwise)
+    {
+        EarcutNode *last = NULL;
+        if (clockwise == (signedArea(data,start,end) > 0))
+        {
+            for (int i=start;i<end;i+=2)
+                last = insertNode(i/2,data[i],data[i+1],last);
+        } else {
+            for (int i=end-2;i>=start;i-=2)
+                last = insertNode(i/2,data[i],data[i+1],last);
+        }
+
+        if (last && equals(last,last->next))
+        {
+            removeNode(last);
+            last = last->next;
+        }
+
+        return last;
+    }
+
+    // Get rid of duplicate and collinear points
+    static EarcutNode *filterPoints(EarcutNode *start,EarcutNode *end = NULL)
+    {
+        if (!start)
+            return start;
+        if (!end)
+            end = start;
+
+        EarcutNode *p = start;
+        bool again;
+        do {
+            again = false;
+            if (!p->steiner && (equals(p,p->next) || area(p->prev,p,p->next) == 0.0))
+            {
+                removeNode(p);
+                p = end = p->prev;
+                if (p == p->next)
+                    break;
+                again = true;
+            } else
+                p = p->next;
+        } while (again || p != end);
+
+        return end;
+    }
+
+    void earcutLinked(EarcutNode *ear,std::vector<int> &triangles,double minX,double minY,double invSize,int pass)
+    {
+        if (!ear)
+            return;
+
+        if (!pass && invSize != 0.0)
+            indexCurve(ear,minX,minY,invSize);
+
+        EarcutNode *stop = ear;
+        while (ear->prev != ear->next)
+        {
+            EarcutNode *prev = ear->prev;
+            EarcutNode *next = ear->next;
+
+            if (invSize != 0.0 ? isEarHashed(ear,minX,minY,invSize) : isEar(ear))
+            {
+                triangles.push_back(prev->i);
+                triangles.push_back(ear->i);
+                triangles.push_back(next->i);
+                removeNode(ear);
+
+                // Skipping the next vertex leads to less sliver triangles
+                ear = next->next;
+                stop = next->next;
+                continue;
+            }
+
+            ear = next;
+
+            // Went all the way around without finding an ear
+            if (ear == stop)
+            {
+                if (!pass)
+                    earcutLinked(filterPoints(ear),triangles,minX,minY,invSize,1);
+                else if (pass == 1)
+                {
+                    ear = cureLocalIntersections(filterPoints(ear),triangles);
+                    earcutLinked(ear,triangles,minX,minY,invSize,2);
+                } else if (pass == 2)
+                    splitEarcut(ear,triangles,minX,minY,invSize);
+                break;
+            }
+        }
+    }
+
+    static bool isEar(EarcutNode *ear)
+    {
+        const EarcutNode *a = ear->prev, *b = ear, *c = ear->next;
+        if (area(a,b,c) >= 0.0)
+            return false;
+
+        const double x0 = std::min(a->x,std::min(b->x,c->x)), y0 = std::min(a->y,std::min(b->y,c->y));
+        const double x1 = std::max(a->x,std::max(b->x,c->x)), y1 = std::max(a->y,std::max(b->y,c->y));
+
+        const EarcutNode *p = c->next;
+        while (p != a)
+        {
+            if (p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1 &&
+                pointInTriangle(a->x,a->y,b->x,b->y,c->x,c->y,p->x,p->y) &&
+                area(p->prev,p,p->next) >= 0.0)
+                return false;
+            p = p->next;
+        }
+
+        return true;
+    }
+
+    static bool isEarHashed(EarcutNode *ear,double minX,double minY,double invSize)
+    {
+        const EarcutNode *a = ear->prev, *b = ear, *c = ear->next;
+        if (area(a,b,c) >= 0.0)
+            return false;
+
+        const double x0 = std::min(a->x,std::min(b->x,c->x)), y0 = std::min(a->y,std::min(b->y,c->y));
+        const double x1 = std::max(a->x,std::max(b->x,c->x)), y1 = std::max(a->y,std::max(b->y,c->y));
+        const int32_t minZ = zOrder(x0,y0,minX,minY,invSize);
+        const int32_t maxZ = zOrder(x1,y1,minX,minY,invSize);
+
+        auto blocks = [&](const EarcutNode *p) -> bool
+        {
+            return p->x >= x0 && p->x <= x1 && p->y >= y0 && p->y <= y1 && p != a && p != c &&
+                pointInTriangle(a->x,a->y,b->x,b->y,c->x,c->y,p->x,p->y) &&
+                area(p->prev,p,p->next) >= 0.0;
+        };
+
+        // Look both ways along the z-order curve
+        const EarcutNode *p = ear->prevZ, *n = ear->nextZ;
+        while (p && p->z >= minZ && n && n->z <= maxZ)
+        {
+            if (blocks(p))
+                return false;
+            p = p->prevZ;
+            if (blocks(n))
+                return false;
+            n = n->nextZ;
+        }
+        while (p && p->z >= minZ)
+        {
+            if (blocks(p))
+                return false;
+            p = p->prevZ;
+        }
+        while (n && n->z <= maxZ)
+        {
+            if (blocks(n))
+                return false;
+            n = n->nextZ;
+        }
+
+        return true;
+    }
+
+    // Go through the ring and fix small self-intersections
+    EarcutNode *cureLocalIntersections(EarcutNode *start,std::vector<int> &triangles)
+    {
+        EarcutNode *p = start;
+        do {
+            EarcutNode *a = p->prev, *b = p->next->next;
+            if (!equals(a,b) && intersects(a,p,p->next,b) && locallyInside(a,b) && locallyInside(b,a))
+            {
+                triangles.push_back(a->i);
+                triangles.push_back(p->i);
+                triangles.push_back(b->i);
+                removeNode(p);
+                removeNode(p->next);
+                p = start = b;
+            }
+            p = p->next;
+        } while (p != start);
+
+        return filterPoints(p);
+    }
+
+    // Split the polygon in two along a valid diagonal and do each half
+    void splitEarcut(EarcutNode *start,std::vector<int> &triangles,double minX,double minY,double invSize)
+    {
+        EarcutNode *a = start;
+        do {
+            EarcutNode *b = a->next->next;
+            while (b != a->prev)
+            {
+                if (a->i != b->i && isValidDiagonal(a,b))
+                {
+                    EarcutNode *c = splitPolygon(a,b);
+                    a = filterPoints(a,a->next);
+                    c = filterPoints(c,c->next);
+                    earcutLinked(a,triangles,minX,minY,invSize,0);
+                    earcutLinked(c,triangles,minX,minY,invSize,0);
+                    return;
+                }
+                b = b->next;
+            }
+            a = a->next;
+        } while (a != start);
+    }
+
+    // Link each hole into the outer ring, left to right
+    EarcutNode *eliminateHoles(const std::vector<double> &data,const std::vector<int> &holeIndices,EarcutNode *outerNode)
+    {
+        std::vector<EarcutNode *> queue;
+        queue.reserve(holeIndices.size());
+        for (unsigned int ii=0;ii<holeIndices.size();ii++)
+        {
+            const int start = holeIndices[ii]*2;
+            const int end = ii < holeIndices.size()-1 ? holeIndices[ii+1]*2 : (int)data.size();
+            EarcutNode *list = linkedList(data,start,end,false);
+            if (!list)
+                continue;
+            if (list == list->next)
+                list->steiner = true;
+            queue.push_back(getLeftmost(list));
+        }
+        std::sort(queue.begin(),queue.end(),[](const EarcutNode *a,const EarcutNode *b) { return a->x < b->x; });
+
+        for (EarcutNode *hole : queue)
+            outerNode = eliminateHole(hole,outerNode);
+
+        return outerNode;
+    }
+
+    EarcutNode *eliminateHole(EarcutNode *hole,EarcutNode *outerNode)
+    {
+        EarcutNode *bridge = findHoleBridge(hole,outerNode);
+        if (!bridge)
+            return outerNode;
+
+        EarcutNode *bridgeReverse = splitPolygon(bridge,hole);
+        filterPoints(bridgeReverse,bridgeReverse->next);
+        return filterPoints(bridge,bridge->next);
+    }
+
+    // Find a point on the outer ring we can connect the hole to
+    static EarcutNode *findHoleBridge(EarcutNode *hole,EarcutNode *outerNode)
+    {
+        EarcutNode *p = outerNode;
+        const double hx = hole->x, hy = hole->y;
+        double qx = -std::numeric_limits<double>::infinity();
+        EarcutNode *m = NULL;
+
+        // Find a segment intersected by a ray from the hole's leftmost point to the left
+        do {
+            if (hy <= p->y && hy >= p->next->y && p->next->y != p->y)
+            {
+                const double x = p->x + (hy - p->y) * (p->next->x - p->x) / (p->next->y - p->y);
+                if (x <= hx && x > qx)
+                {
+                    qx = x;
+                    m = p->x < p->next->x ? p : p->next;
+                    if (x == hx)
+                        return m;
+                }
+            }
+            p = p->next;
+        } while (p != outerNode);
+
+        if (!m)
+            return NULL;
+
+        // Look for points inside the triangle of the hole point, the intersection and the endpoint.
+        // If there are any, take the one with the smallest angle to the ray.
+        const EarcutNode *stop = m;
+        const double mx = m->x, my = m->y;
+        double tanMin = std::numeric_limits<double>::infinity();
+        p = m;
+        do {
+            if (hx >= p->x && p->x >= mx && hx != p->x &&
+                pointInTriangle(hy < my ? hx : qx,hy,mx,my,hy < my ? qx : hx,hy,p->x,p->y))
+            {
+                const double tan = std::abs(hy - p->y) / (hx - p->x);
+                if (locallyInside(p,hole) &&
+                    (tan < tanMin || (tan == tanMin && (p->x > m->x || (p->x == m->x && sectorContainsSector(m,p))))))
+                {
+                    m = p;
+                    tanMin = tan;
+                }
+            }
+            p = p->next;
+        } while (p != stop);
+
+        return m;
+    }
+
+    static bool sectorContainsSector(const EarcutNode *m,const EarcutNode *p)
+    {
+        return area(m->prev,m,p->prev) < 0.0 && area(p->next,m,m->next) < 0.0;
+    }
+
+    // Link the nodes along a z-order curve
+    static void indexCurve(EarcutNode *start,double minX,double minY,double invSize)
+    {
+        EarcutNode *p = start;
+        do {
+            if (p->z == 0)
+                p->z = zOrder(p->x,p->y,minX,minY,invSize);
+            p->prevZ = p->prev;
+            p->nextZ = p->next;
+            p = p->next;
+        } while (p != start);
+
+        p->prevZ->nextZ = NULL;
+        p->prevZ = NULL;
+
+        sortLinked(p);
+    }
+
+    // Merge sort on the z links
+    static EarcutNode *sortLinked(EarcutNode *list)
+    {
+        int inSize = 1;
+        int numMerges;
+        do {
+            EarcutNode *p = list, *tail = NULL;
+            list = NULL;
+            numMerges = 0;
+
+            while (p)
+            {
+                numMerges++;
+                EarcutNode *q = p;
+                int pSize = 0;
+                for (int i=0;i<inSize;i++)
+                {
+                    pSize++;
+                    q = q->nextZ;
+                    if (!q)
+                        break;
+                }
+                int qSize = inSize;
+
+                while (pSize > 0 || (qSize > 0 && q))
+                {
+                    EarcutNode *e;
+                    if (pSize != 0 && (qSize == 0 || !q || p->z <= q->z))
+                    {
+                        e = p;
+                        p = p->nextZ;
+                        pSize--;
+                    } else {
+                        e = q;
+                        q = q->nextZ;
+                        qSize--;
+                    }
+
+                    if (tail)
+                        tail->nextZ = e;
+                    else
+                        list = e;
+                    e->prevZ = tail;
+                    tail = e;
+                }
+
+                p = q;
+            }
+
+            tail->nextZ = NULL;
+            inSize *= 2;
+        } while (numMerges > 1);
+
+        return list;
+    }
+
+    static int32_t zOrder(double px,double py,double minX,double minY,double invSize)
+    {
+        uint32_t x = (uint32_t)((px - minX) * invSize);
+        uint32_t y = (uint32_t)((py - minY) * invSize);
+
+        x = (x | (x << 8)) & 0x00FF00FF;
+        x = (x | (x << 4)) & 0x0F0F0F0F;
+        x = (x | (x << 2)) & 0x33333333;
+        x = (x | (x << 1)) & 0x55555555;
+
+        y = (y | (y << 8)) & 0x00FF00FF;
+        y = (y | (y << 4)) & 0x0F0F0F0F;
+        y = (y | (y << 2)) & 0x33333333;
+        y = (y | (y << 1)) & 0x55555555;
+
+        return (int32_t)(x | (y << 1));
+    }
+
+    static EarcutNode *getLeftmost(EarcutNode *start)
+    {
+        EarcutNode *p = start, *leftmost = start;
+        do {
+            if (p->x < leftmost->x || (p->x == leftmost->x && p->y < leftmost->y))
+                leftmost = p;
+            p = p->next;
+        } while (p != start);
+
+        return leftmost;
+    }
+
+    static bool pointInTriangle(double ax,double ay,double bx,double by,double cx,double cy,double px,double py)
+    {
+        return (cx - px) * (ay - py) >= (ax - px) * (cy - py) &&
+               (ax - px) * (by - py) >= (bx - px) * (ay - py) &&
+               (bx - px) * (cy - py) >= (cx - px) * (by - py);
+    }
+
+    static bool isValidDiagonal(const EarcutNode *a,const EarcutNode *b)
+    {
+        return a->next->i != b->i && a->prev->i != b->i && !intersectsPolygon(a,b) &&
+            ((locallyInside(a,b) && locallyInside(b,a) && middleInside(a,b) &&
+              (area(a->prev,a,b->prev) != 0.0 || area(a,b->prev,b) != 0.0)) ||
+             (equals(a,b) && area(a->prev,a,a->next) > 0.0 && area(b->prev,b,b->next) > 0.0));
+    }
+
+    static double area(const EarcutNode *p,const EarcutNode *q,const EarcutNode *r)
+    {
+        return (q->y - p->y) * (r->x - q->x) - (q->x - p->x) * (r->y - q->y);
+    }
+
+    static bool equals(const EarcutNode *p1,const EarcutNode *p2)
+    {
+        return p1->x == p2->x && p1->y == p2->y;
+    }
+
+    static int sign(double val)
+    {
+        return val > 0.0 ? 1 : (val < 0.0 ? -1 : 0);
+    }
+
+    static bool onSegment(const EarcutNode *p,const EarcutNode *q,const EarcutNode *r)
+    {
+        return q->x <= std::max(p->x,r->x) && q->x >= std::min(p->x,r->x) &&
+               q->y <= std::max(p->y,r->y) && q->y >= std::min(p->y,r->y);
+    }
+
+    static bool intersects(const EarcutNode *p1,const EarcutNode *q1,const EarcutNode *p2,const EarcutNode *q2)
+    {
+        const int o1 = sign(area(p1,q1,p2));
+        const int o2 = sign(area(p1,q1,q2));
+        const int o3 = sign(area(p2,q2,p1));
+        const int o4 = sign(area(p2,q2,q1));
+
+        if (o1 != o2 && o3 != o4)
+            return true;
+        if (o1 == 0 && onSegment(p1,p2,q1))
+            return true;
+        if (o2 == 0 && onSegment(p1,q2,q1))
+            return true;
+        if (o3 == 0 && onSegment(p2,p1,q2))
+            return true;
+        if (o4 == 0 && onSegment(p2,q1,q2))
+            return true;
+
+        return false;
+    }
+
+    static bool intersectsPolygon(const EarcutNode *a,const EarcutNode *b)
+    {
+        const EarcutNode *p = a;
+        do {
+            if (p->i != a->i && p->next->i != a->i && p->i != b->i && p->next->i != b->i &&
+                intersects(p,p->next,a,b))
+                return true;
+            p = p->next;
+        } while (p != a);
+
+        return false;
+    }
+
+    static bool locallyInside(const EarcutNode *a,const EarcutNode *b)
+    {
+        return area(a->prev,a,a->next) < 0.0 ?
+            area(a,b,a->next) >= 0.0 && area(a,a->prev,b) >= 0.0 :
+            area(a,b,a->prev) < 0.0 || area(a,a->next,b) < 0.0;
+    }
+
+    static bool middleInside(const EarcutNode *a,const EarcutNode *b)
+    {
+        const EarcutNode *p = a;
+        bool inside = false;
+        const double px = (a->x + b->x) / 2.0, py = (a->y + b->y) / 2.0;
+        do {
+            if (((p->y > py) != (p->next->y > py)) && p->next->y != p->y &&
+                (px < (p->next->x - p->x) * (py - p->y) / (p->next->y - p->y) + p->x))
+                inside = !inside;
+            p = p->next;
+        } while (p != a);
+
+        return inside;
+    }
+
+    // Connect two points with a bridge, splitting the ring in two
+    EarcutNode *splitPolygon(EarcutNode *a,EarcutNode *b)
+    {
+        EarcutNode *a2 = createNode(a->i,a->x,a->y);
+        EarcutNode *b2 = createNode(b->i,b->x,b->y);
+        EarcutNode *an = a->next;
+        EarcutNode *bp = b->prev;
+
+        a->next = b;
+        b->prev = a;
+
+        a2->next = an;
+        an->prev = a2;
+
+        b2->next = a2;
+        a2->prev = b2;
+
+        bp->next = b2;
+        b2->prev = bp;
+
+        return b2;
+    }
+
+    std::vector<std::unique_ptr<EarcutNode[]> > blocks;
+    size_t numNodes;
+};
+
+/* Everything we need to tesselate, kept around per thread.
+   Creating a GLU tesselator for every polygon adds up.
+  */
+class TesselatorContext
+{
+public:
+    TesselatorContext()
+    {
+        tess = gluNewTess();
+        gluTessCallback(tess, GLU_TESS_VERTEX_DATA, (GLvoid (*) ()) &vertexCallback);
+        gluTessCallback(tess, GLU_TESS_EDGE_FLAG_DATA, (GLvoid (*) ()) &edgeFlagCallback);
+        gluTessCallback(tess, GLU_TESS_COMBINE_DATA, (GLvoid (*) ()) &combineCallback);
+        gluTessCallback(tess, GLU_TESS_ERROR_DATA, (GLvoid (*) ()) &errorCallback);
+        gluTessCallback(tess, GLU_TESS_BEGIN_DATA, (GLvoid (*) ()) &beginCallback);
+        gluTessCallback(tess, GLU_TESS_END_DATA, (GLvoid (*) ()) &endCallback);
+    }
+
+    ~TesselatorContext()
+    {
+        gluDeleteTess(tess);
+    }
+
+    GLUtesselator *tess;
+    TriangulationInfo tessInfo;
+
+    Earcut earcut;
+    Point2fVector pts;
+    std::vector<double> coords;
+    std::vector<int> holeIndices;
+    std::vector<int> tris;
+};
+
+static TesselatorContext &GetTesselatorContext()
+{
+    static thread_local TesselatorContext context;
+    return context;
+}
+
+// Add triangles to the output, making sure they all face the same way
+static void AddTriangles(const std::vector<int> &triIdx,int startPoint,VectorTrianglesRef tris)
+{
+    tris->tris.reserve(tris->tris.size() + triIdx.size()/3);
+    for (unsigned int ii=0;ii+2<triIdx.size();ii+=3)
+    {
+        VectorTriangles::Triangle triOut;
+        for (unsigned int jj=0;jj<3;jj++)
+            triOut.pts[jj] = triIdx[ii+jj]+startPoint;
+
+        // Make sure this is pointed up
+        const Point3f &pt0 = tris->pts[triOut.pts[0]];
+        const Point3f &pt1 = tris->pts[triOut.pts[1]];
+        const Point3f &pt2 = tris->pts[triOut.pts[2]];
+        const float normZ = (pt1.x()-pt0.x())*(pt2.y()-pt0.y()) - (pt1.y()-pt0.y())*(pt2.x()-pt0.x());
+        if (normZ >= 0.0)
+            std::swap(triOut.pts[0],triOut.pts[2]);
+
+        tris->tris.push_back(triOut);
+    }
+}
     
 void TesselateRing(const WhirlyKit::VectorRing &ring,VectorTrianglesRef tris)
 {
@@ -96,26 +769,110 @@ void TesselateRing(const WhirlyKit::VectorRing &ring,VectorTrianglesRef tris)
 }
     
 void TesselateLoops(const std::vector<VectorRing> &loops,VectorTrianglesRef tris)
+{
+    if (loops.size() < 1)
+        return;
+    if (loops[0].size() < 1)
+        return;
+
+    // Most polygons are simple enough for the ear clipper
+    if (!TesselateLoopsEarcut(loops, tris))
+        TesselateLoopsLibtess(loops, tris);
+}
+
+bool TesselateLoopsEarcut(const std::vector<VectorRing> &loops,VectorTrianglesRef tris)
+{
+    if (loops.size() < 1)
+        return true;
+    if (loops[0].size() < 1)
+        return true;
+
+    TesselatorContext &context = GetTesselatorContext();
+    context.pts.clear();
+    context.coords.clear();
+    context.holeIndices.clear();
+    context.tris.clear();
+
+    // Same cleanup as for libtess.  We also figure out what the area ought to be.
+    const Point2f org = (loops[0])[0];
+    double expectedArea = 0.0;
+    for (unsigned int li=0;li<loops.size();li++)
+    {
+        const VectorRing &ring = loops[li];
+        const size_t startPt = context.pts.size();
+        for (unsigned int ii=0;ii<ring.size();ii++)
+        {
+            const Point2f &pt = ring[ii];
+            if (ii==ring.size()-1 && pt.x() == ring[0].x() && pt.y() == ring[0].y())
+                continue;
+            if (ii > 0)
+            {
+                const Point2f &prevPt = ring[ii-1];
+                if (pt.x() == prevPt.x() && pt.y() == prevPt.y())
+                    continue;
+            }
+            context.pts.push_back(pt);
+        }
+        if (context.pts.size() == startPt)
+            continue;
+        if (li > 0)
+            context.holeIndices.push_back((int)startPt);
+
+        double ringArea = 0.0;
+        for (size_t ii=startPt;ii<context.pts.size();ii++)
+        {
+            const double x = context.pts[ii].x() - org.x(), y = context.pts[ii].y() - org.y();
+            context.coords.push_back(x);
+            context.coords.push_back(y);
+        }
+        for (size_t ii=startPt,jj=context.pts.size()-1;ii<context.pts.size();jj=ii++)
+            ringArea += context.coords[2*jj]*context.coords[2*ii+1] - context.coords[2*ii]*context.coords[2*jj+1];
+        ringArea = std::abs(ringArea/2.0);
+        expectedArea += li == 0 ? ringArea : -ringArea;
+    }
+    if (context.pts.size() < 3)
+        return true;
+
+    context.earcut.run(context.coords,context.holeIndices,context.tris);
+
+    // Self-intersections and holes that stray outside will show up in the area
+    double area = 0.0;
+    for (unsigned int ii=0;ii+2<context.tris.size();ii+=3)
+    {
+        const double *a = &context.coords[2*context.tris[ii]];
+        const double *b = &context.coords[2*context.tris[ii+1]];
+        const double *c = &context.coords[2*context.tris[ii+2]];
+        area += std::abs((b[0]-a[0])*(c[1]-a[1]) - (b[1]-a[1])*(c[0]-a[0])) / 2.0;
+    }
+    if (expectedArea <= 0.0 || std::abs(area - expectedArea) > EarcutAreaTolerance * expectedArea)
+        return false;
+
+    const int startPoint = (int)(tris->pts.size());
+    tris->pts.reserve(tris->pts.size() + context.pts.size());
+    for (const Point2f &pt : context.pts)
+        tris->pts.push_back(Point3f(pt.x(),pt.y(),0.0));
+    AddTriangles(context.tris,startPoint,tris);
+
+    return true;
+}
+
+void TesselateLoopsLibtess(const std::vector<VectorRing> &loops,VectorTrianglesRef tris)
 {
     if (loops.size() < 1)
         return;
     if (loops[0].size() < 1)
         return;
     
-    GLUtesselator *tess = gluNewTess();
-    
-    TriangulationInfo tessInfo;
+    TesselatorContext &context = GetTesselatorContext();
+    GLUtesselator *tess = context.tess;
+    TriangulationInfo &tessInfo = context.tessInfo;
+    tessInfo.pts.clear();
+    tessInfo.tris.clear();
     int totPoints = 0;
     for (unsigned int ii=0;ii<loops.size();ii++)
         totPoints += loops[ii].size();
     tessInfo.pts.reserve(totPoints);
     tessInfo.newVert = false;
-    gluTessCallback(tess, GLU_TESS_VERTEX_DATA, (GLvoid (*) ()) &vertexCallback);
-    gluTessCallback(tess, GLU_TESS_EDGE_FLAG_DATA, (GLvoid (*) ()) &edgeFlagCallback);
-    gluTessCallback(tess, GLU_TESS_COMBINE_DATA, (GLvoid (*) ()) &combineCallback);
-    gluTessCallback(tess, GLU_TESS_ERROR_DATA, (GLvoid (*) ()) &errorCallback);
-    gluTessCallback(tess, GLU_TESS_BEGIN_DATA, (GLvoid (*) ()) &beginCallback);
-    gluTessCallback(tess, GLU_TESS_END_DATA, (GLvoid (*) ()) &endCallback);
     
     gluTessBeginPolygon(tess,&tessInfo);
     
@@ -143,17 +900,13 @@ void TesselateLoops(const std::vector<VectorRing> &loops,VectorTrianglesRef tris
             coords[2] = 0.0;
             gluTessVertex(tess,coords,(void *)tessInfo.pts.size());
             tessInfo.pts.push_back(Point3f(coords[0],coords[1],0.0));
-            //        printf("%d: (%f,%f)\n",ii, coords[0],coords[1]);
         }
         
         gluTessEndContour(tess);
     }
     gluTessEndPolygon(tess);
     
-    gluDeleteTess(tess);
-    
     // Convert to triangles
-    //    printf("  ");
     int startPoint = (int)(tris->pts.size());
     for (unsigned int ii=0;ii<tessInfo.pts.size();ii++)
     {
@@ -161,33 +914,8 @@ void TesselateLoops(const std::vector<VectorRing> &loops,VectorTrianglesRef tris
         tris->pts.push_back(Point3f(pt.x()/PolyScale2+org.x(),pt.y()/PolyScale2+org.y(),0.0));
     }
     
-    // Convert to triangles
-    for (unsigned int ii=0;ii<tessInfo.tris.size();ii++)
-    {
-        std::vector<int> &tri = tessInfo.tris[ii];
-        if (tri.size() == 3)
-        {
-            VectorTriangles::Triangle triOut;
-            for (unsigned int jj=0;jj<3;jj++)
-            {
-                triOut.pts[jj] = tri[jj]+startPoint;
-            }
-            
-            // Make sure this is pointed up
-            Point3f pts[3];
-            for (unsigned int jj=0;jj<3;jj++)
-                pts[jj] = tris->pts[triOut.pts[jj]];
-            Vector3f norm = (pts[1]-pts[0]).cross(pts[2]-pts[0]);
-            if (norm.z() >= 0.0)
-            {
-                int tmp = triOut.pts[0];
-                triOut.pts[0] = triOut.pts[2];
-                triOut.pts[2] = tmp;
-            }
-            
-            tris->tris.push_back(triOut);
-        }
-    }
+    tessInfo.tris.resize(tessInfo.tris.size() - tessInfo.tris.size() % 3);
+    AddTriangles(tessInfo.tris,startPoint,tris);
 }
 
 }
@@ -19,6 +19,8 @@
  */
 
 #import "Texture.h"
+#import "PixelConversion.h"
+#import "MipmapGenerator.h"
 #import "WhirlyKitLog.h"
 
 using namespace WhirlyKit;
@@ -28,44 +30,21 @@ namespace WhirlyKit
 {
 
 // Convert a buffer in RGBA to 2-byte 565
-// Code courtesy: http://stackoverflow.com/questions/7930148/opengl-es-on-ios-texture-loading-how-do-i-get-from-a-rgba8888-png-file-to-a-r
 RawDataRef ConvertRGBATo565(RawDataRef inData)
 {
     uint32_t pixelCount = inData->getLen()/4;
     void *temp = malloc(pixelCount * 2);
-    const uint32_t *inPixel32  = (uint32_t *)inData->getRawData();
-    uint16_t *outPixel16 = (uint16_t *)temp;
-    
-    for(uint32_t i=0; i<pixelCount; i++, inPixel32++)
-    {
-        uint32_t r = (((*inPixel32 >> 0)  & 0xFF) >> 3);
-        uint32_t g = (((*inPixel32 >> 8)  & 0xFF) >> 2);
-        uint32_t b = (((*inPixel32 >> 16) & 0xFF) >> 3);
-        
-        *outPixel16++ = (r << 11) | (g << 5) | (b << 0);
-    }
+    ConvertRGBAPixelRun(TexTypeShort565, WKSingleRGB, inData->getRawData(), (unsigned char *)temp, pixelCount);
     
     return RawDataRef(new RawDataWrapper(temp,pixelCount*2,true));
 }
 
-
 // Convert a buffer in RGBA to 2-byte 4444
 RawDataRef ConvertRGBATo4444(RawDataRef inData)
 {
     uint32_t pixelCount = inData->getLen()/4;
     void *temp = malloc(pixelCount * 2);
-    const uint32_t *inPixel32  = (uint32_t *)inData->getRawData();
-    uint16_t *outPixel16 = (uint16_t *)temp;
-    
-    for(uint32_t i=0; i<pixelCount; i++, inPixel32++)
-    {
-        uint32_t r = (((*inPixel32 >> 0)  & 0xFF) >> 4);
-        uint32_t g = (((*inPixel32 >> 8)  & 0xFF) >> 4);
-        uint32_t b = (((*inPixel32 >> 16) & 0xFF) >> 4);
-        uint32_t a = (((*inPixel32 >> 24) & 0xFF) >> 4);
-        
-        *outPixel16++ = (r << 12) | (g << 8) | (b << 4) | (a<< 0);
-    }
+    ConvertRGBAPixelRun(TexTypeShort4444, WKSingleRGB, inData->getRawData(), (unsigned char *)temp, pixelCount);
     
     return RawDataRef(new RawDataWrapper(temp,pixelCount*2,true));
 }
@@ -75,18 +54,7 @@ RawDataRef ConvertRGBATo5551(RawDataRef inData)
 {
     uint32_t pixelCount = inData->getLen()/4;
     void *temp = malloc(pixelCount * 2);
-    uint32_t *inPixel32  = (uint32_t *)inData->getRawData();
-    uint16_t *outPixel16 = (uint16_t *)temp;
-    
-    for(uint32_t i=0; i<pixelCount; i++, inPixel32++)
-    {
-        uint32_t r = (((*inPixel32 >> 0)  & 0xFF) >> 3);
-        uint32_t g = (((*inPixel32 >> 8)  & 0xFF) >> 3);
-        uint32_t b = (((*inPixel32 >> 16) & 0xFF) >> 3);
-        uint32_t a = (((*inPixel32 >> 24) & 0xFF) >> 7);
-        
-        *outPixel16++ = (r << 11) | (g << 6) | (b << 1) | (a << 0);
-    }
+    ConvertRGBAPixelRun(TexTypeShort5551, WKSingleRGB, inData->getRawData(), (unsigned char *)temp, pixelCount);
     
     return RawDataRef(new RawDataWrapper(temp,pixelCount*2,true));
 }
@@ -151,26 +119,7 @@ RawDataRef ConvertRGBATo16(RawDataRef inData,int width,int height,bool pad)
     int outWidth = width + extra;
 
     unsigned char *temp = (unsigned char *)malloc(outWidth*height*2);
-    bzero(temp,outWidth*height*2);
-    
-    uint32_t *inPixel32row  = (uint32_t *)inData->getRawData();
-    uint8_t *outPixel8row = (uint8_t *)temp;
-    for (int32_t h=0;h<height;h++) {
-        uint32_t *inPixel32 = inPixel32row;
-        uint8_t *outPixel8 = outPixel8row;
-        for (int32_t w=0;w<width;w++) {
-            uint32_t r = ((*inPixel32 >> 0)  & 0xFF);
-            uint32_t g = ((*inPixel32 >> 8)  & 0xFF);
-            outPixel8[0] = r;
-            outPixel8[1] = g;
-            
-            inPixel32++;
-            outPixel8+=2;
-        }
-        
-        inPixel32row += width;
-        outPixel8row += 2*outWidth;
-    }
+    ConvertRGBAPixels(TexTypeDoubleChannel, WKSingleRGB, inData->getRawData(), width, height, temp, 2*outWidth);
     
     return RawDataRef(new RawDataWrapper(temp,outWidth*height*2,true));
 }
@@ -180,36 +129,7 @@ RawDataRef ConvertRGBATo8(RawDataRef inData,WKSingleByteSource source)
 {
     uint32_t pixelCount = inData->getLen()/4;
     void *temp = malloc(pixelCount);
-    uint32_t *inPixel32  = (uint32_t *)inData->getRawData();
-    uint8_t *outPixel8 = (uint8_t *)temp;
-    
-    for(uint32_t i=0; i<pixelCount; i++, inPixel32++)
-    {
-        uint32_t r = ((*inPixel32 >> 0)  & 0xFF);
-        uint32_t g = ((*inPixel32 >> 8)  & 0xFF);
-        uint32_t b = ((*inPixel32 >> 16) & 0xFF);
-        uint32_t a = ((*inPixel32 >> 24) & 0xFF);
-        int sum = 0;
-        switch (source)
-        {
-            case WKSingleRed:
-                sum = r;
-                break;
-            case WKSingleGreen:
-                sum = g;
-                break;
-            case WKSingleBlue:
-                sum = b;
-                break;
-            case WKSingleRGB:
-                sum = ((int)r + (int)g + (int)b)/3;
-                break;
-            case WKSingleAlpha:
-                sum = a;
-                break;
-        }
-        *outPixel8++ = (uint8_t)sum;
-    }
+    ConvertRGBAPixelRun(TexTypeSingleChannel, source, inData->getRawData(), (unsigned char *)temp, pixelCount);
     
     return RawDataRef(new RawDataWrapper(temp,pixelCount,true));
 }
@@ -227,19 +147,23 @@ TextureBase::~TextureBase()
 {
 }
 
+void TextureBase::prepareForRenderer(const RenderSetupInfo *setupInfo)
+{
+}
+
 Texture::Texture()
-: TextureBase(""), isPVRTC(false), isPKM(false), usesMipmaps(false), wrapU(false), wrapV(false), format(TexTypeUnsignedByte), byteSource(WKSingleRGB), interpType(TexInterpLinear), isEmptyTexture(false)
+: TextureBase(""), isPVRTC(false), isPKM(false), usesMipmaps(false), wrapU(false), wrapV(false), format(TexTypeUnsignedByte), byteSource(WKSingleRGB), interpType(TexInterpLinear), isEmptyTexture(false), texDataConverted(false), convertThreads(1)
 {    
 }
 	
 Texture::Texture(const std::string &name)
-	: TextureBase(name), isPVRTC(false), isPKM(false), usesMipmaps(false), wrapU(false), wrapV(false), format(TexTypeUnsignedByte), byteSource(WKSingleRGB), interpType(TexInterpLinear), isEmptyTexture(false)
+	: TextureBase(name), isPVRTC(false), isPKM(false), usesMipmaps(false), wrapU(false), wrapV(false), format(TexTypeUnsignedByte), byteSource(WKSingleRGB), interpType(TexInterpLinear), isEmptyTexture(false), texDataConverted(false), convertThreads(1)
 {
 }
 	
 // Construct with raw texture data
 Texture::Texture(const std::string &name,RawDataRef texData,bool isPVRTC)
-	: TextureBase(name), texData(texData), isPVRTC(isPVRTC), isPKM(false), usesMipmaps(false), wrapU(false), wrapV(false), format(TexTypeUnsignedByte), byteSource(WKSingleRGB), interpType(TexInterpLinear), isEmptyTexture(false)
+	: TextureBase(name), texData(texData), isPVRTC(isPVRTC), isPKM(false), usesMipmaps(false), wrapU(false), wrapV(false), format(TexTypeUnsignedByte), byteSource(WKSingleRGB), interpType(TexInterpLinear), isEmptyTexture(false), texDataConverted(false), convertThreads(1)
 { 
 }
 
@@ -250,19 +174,50 @@ Texture::~Texture()
 void Texture::setRawData(RawData *rawData,int inWidth,int inHeight)
 {
     texData = RawDataRef(rawData);
+    texDataConverted = false;
+    mipLevels.clear();
     width = inWidth;
     height = inHeight;
 }
 
+RawDataRef Texture::convertRGBA()
+{
+    const int bytesPerPixel = PixelConversionBytesPerPixel(format);
+    if (format == TexTypeUnsignedByte || bytesPerPixel == 0 || texData->getLen() != (unsigned long)width*height*4)
+        return RawDataRef();
+    // Two channel rows are padded out to 32 bits
+    const int outRowBytes = (format == TexTypeDoubleChannel) ? 2*(width + width%2) : width*bytesPerPixel;
+    const unsigned long outLen = (unsigned long)outRowBytes*height;
+
+    // If no one else is holding on to the data, we can convert it where it sits
+    MutableRawData *mutableData = dynamic_cast<MutableRawData *>(texData.get());
+    if (mutableData && texData.use_count() == 1 && convertThreads <= 1)
+    {
+        unsigned char *pixels = mutableData->getMutableRawData();
+        ConvertRGBAPixels(format, byteSource, pixels, width, height, pixels, outRowBytes, 1);
+        mutableData->resize(outLen);
+        texDataConverted = true;
+        return texData;
+    }
+
+    unsigned char *temp = (unsigned char *)malloc(outLen);
+    ConvertRGBAPixels(format, byteSource, texData->getRawData(), width, height, temp, outRowBytes, convertThreads);
+
+    return RawDataRef(new RawDataWrapper(temp,outLen,true));
+}
+
 RawDataRef Texture::processData()
 {
     if (!texData)
         return NULL;
     
-	if (isPVRTC || isPKM)
+	if (isPVRTC || isPKM || texDataConverted)
 	{
         return texData;
 	} else {
+        if (RawDataRef convertedData = convertRGBA())
+            return convertedData;
+        
         // Depending on the format, we may need to mess around with the bytes
         switch (format)
         {
@@ -301,10 +256,56 @@ RawDataRef Texture::processData()
     return RawDataRef();
 }
     
+bool Texture::compressETC2(ETC2Quality quality,int numThreads)
+{
+    if (!texData || isPVRTC || isPKM || usesMipmaps || texData->getLen() != (unsigned long)width*height*4)
+        return false;
+    switch (format)
+    {
+        case TexTypeUnsignedByte:
+        case TexTypeShort565:
+        case TexTypeShort4444:
+        case TexTypeShort5551:
+            break;
+        default:
+            return false;
+    }
+
+    const unsigned char *pixels = texData->getRawData();
+    RawDataRef pkmData = ETC2EncodePKM(pixels, width, height, !ETC2IsOpaque(pixels,width,height), quality, numThreads);
+    if (!pkmData)
+        return false;
+    setPKMData(pkmData);
+
+    return true;
+}
+
 void Texture::setPKMData(RawDataRef inData)
 {
     texData = inData;
+    texDataConverted = false;
+    mipLevels.clear();
     isPKM = true;
 }
 
+bool Texture::buildMipmaps(bool sRGB)
+{
+    if (!texData || isPVRTC || isPKM || texDataConverted || texData->getLen() != (unsigned long)width*height*4)
+        return false;
+
+    std::vector<RawDataRef> levels;
+    if (!BuildMipmapChain(texData->getRawData(), width, height, format, byteSource, sRGB, levels))
+        return false;
+    // RGBA comes back without a base level, since it's what we've already got
+    if (levels[0])
+    {
+        texData = levels[0];
+        texDataConverted = true;
+    }
+    mipLevels.assign(levels.begin()+1,levels.end());
+    usesMipmaps = true;
+
+    return true;
+}
+
 }
@@ -100,6 +100,49 @@ unsigned char *TextureGLES::ResolvePKM(RawDataRef texData,int &pkmType,int &size
     return (unsigned char*)&header[16];
 }
 
+// Upload a single level in whatever format we're using
+void TextureGLES::uploadLevel(int level,int levelWidth,int levelHeight,const void *data)
+{
+    // Depending on the format, we may need to mess around with the bytes
+    switch (format)
+    {
+        case TexTypeUnsignedByte:
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, levelWidth, levelHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+            break;
+        case TexTypeShort565:
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RGB, levelWidth, levelHeight, 0, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, data);
+            break;
+        case TexTypeShort4444:
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, levelWidth, levelHeight, 0, GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, data);
+            break;
+        case TexTypeShort5551:
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, levelWidth, levelHeight, 0, GL_RGBA, GL_UNSIGNED_SHORT_5_5_5_1, data);
+            break;
+        case TexTypeSingleChannel:
+            glTexImage2D(GL_TEXTURE_2D, level, GL_ALPHA, levelWidth, levelHeight, 0, GL_ALPHA, GL_UNSIGNED_BYTE, data);
+            break;
+        case TexTypeDoubleChannel:
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RG8, levelWidth, levelHeight, 0, GL_RG, GL_UNSIGNED_BYTE, data);
+            break;
+        default:
+            wkLogLevel(Error, "Unknown texture type %d for GLES",(int)format);
+            break;
+    }
+}
+
+void TextureGLES::prepareForRenderer(const RenderSetupInfo *setupInfo)
+{
+    if (!texData || isPVRTC || isPKM || texDataConverted)
+        return;
+    
+    // createInRenderer() will use this as is
+    if (RawDataRef convertedData = processData())
+    {
+        texData = convertedData;
+        texDataConverted = true;
+    }
+}
+
 // Define the texture in OpenGL
 bool TextureGLES::createInRenderer(const RenderSetupInfo *inSetupInfo)
 {
@@ -157,54 +200,19 @@ bool TextureGLES::createInRenderer(const RenderSetupInfo *inSetupInfo)
         glCompressedTexImage2D(GL_TEXTURE_2D, 0, compressedType, width, height, 0, size, rawData);
         CheckGLError("Texture::createInGL() glCompressedTexImage2D()");
     } else {
-        // Depending on the format, we may need to mess around with the bytes
-        switch (format)
-        {
-            case TexTypeUnsignedByte:
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
-                             (convertedData ? convertedData->getRawData() : NULL));
-                break;
-            case TexTypeShort565:
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_SHORT_5_6_5,
-                             (convertedData ? convertedData->getRawData() : NULL));
-                break;
-            case TexTypeShort4444:
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4,
-                             (convertedData ? convertedData->getRawData() : NULL));
-                break;
-            case TexTypeShort5551:
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_SHORT_5_5_5_1,
-                             (convertedData ? convertedData->getRawData() : NULL));
-                break;
-            case TexTypeSingleChannel:
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, width, height, 0, GL_ALPHA, GL_UNSIGNED_BYTE,
-                             (convertedData ? convertedData->getRawData() : NULL));
-                break;
-            case TexTypeDoubleChannel:
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RG8, width, height, 0, GL_RG, GL_UNSIGNED_BYTE,
-                             (convertedData ? convertedData->getRawData() : NULL));
-                break;
-            default:
-                wkLogLevel(Error, "Unknown texture type %d for GLES",(int)format);
-                // Note: Porting
-//            case GL_COMPRESSED_RGB8_ETC2:
-//                glCompressedTexImage2D(GL_TEXTURE_2D, 0, GL_COMPRESSED_RGB8_ETC2, width, height, 0,
-//                                       (GLsizei)(convertedData ? convertedData->getLen() : 0),
-//                                       (convertedData ? convertedData->getRawData() : NULL));
-//                break;
-//            case GL_DEPTH_COMPONENT16:
-//                glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT16, width, height, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_SHORT,
-//                             (convertedData ? convertedData->getRawData() : NULL));
-//                break;
-        }
+        uploadLevel(0, width, height, convertedData ? convertedData->getRawData() : NULL);
+        // Levels built on the loader thread go straight up
+        for (unsigned int ii=0;ii<mipLevels.size();ii++)
+            uploadLevel(ii+1, std::max(1u,width >> (ii+1)), std::max(1u,height >> (ii+1)), mipLevels[ii]->getRawData());
         CheckGLError("Texture::createInGL() glTexImage2D()");
     }
     
-    if (usesMipmaps)
+    if (usesMipmaps && mipLevels.empty())
         glGenerateMipmap(GL_TEXTURE_2D);
     
     // Once we've moved it over to OpenGL, let's get rid of this copy
     texData.reset();
+    mipLevels.clear();
     
     return true;
 }
@@ -0,0 +1,886 @@
+/*
+ *  TileGeometryCache.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <stdio.h>
+#import <time.h>
+#import <algorithm>
+#import "TileGeometryCache.h"
+#import "MapboxVectorTileParser.h"
+#import "MapboxVectorStyleSetC.h"
+#import "BasicDrawableBuilder.h"
+#import "WideVectorDrawableBuilder.h"
+#import "SceneRenderer.h"
+#import "WhirlyKitLog.h"
+
+using namespace Eigen;
+
+namespace WhirlyKit
+{
+
+// Spill file version.  Bump this if the layout changes.
+static const unsigned int TileGeometryCacheFileVersion = 2;
+
+// Write a single plain value
+template<typename T> static void WriteValue(FILE *fp,const T &val)
+{
+    if (fwrite(&val,sizeof(T),1,fp) != 1)
+        throw 1;
+}
+
+// Read a single plain value
+template<typename T> static void ReadValue(FILE *fp,T &val)
+{
+    if (fread(&val,sizeof(T),1,fp) != 1)
+        throw 1;
+}
+
+// Write an array of plain values, preceded by its size
+template<typename T> static void WriteArray(FILE *fp,const std::vector<T> &vals)
+{
+    unsigned int num = (unsigned int)vals.size();
+    WriteValue(fp,num);
+    if (num > 0 && fwrite(&vals[0],sizeof(T),num,fp) != num)
+        throw 1;
+}
+
+// Read an array of plain values, preceded by its size
+template<typename T> static void ReadArray(FILE *fp,std::vector<T> &vals)
+{
+    unsigned int num;
+    ReadValue(fp,num);
+    vals.resize(num);
+    if (num > 0 && fread(&vals[0],sizeof(T),num,fp) != num)
+        throw 1;
+}
+
+static void WriteString(FILE *fp,const std::string &str)
+{
+    unsigned int len = (unsigned int)str.size();
+    WriteValue(fp,len);
+    if (len > 0 && fwrite(str.c_str(),1,len,fp) != len)
+        throw 1;
+}
+
+static void ReadString(FILE *fp,std::string &str)
+{
+    unsigned int len;
+    ReadValue(fp,len);
+    str.resize(len);
+    if (len > 0 && fread(&str[0],1,len,fp) != len)
+        throw 1;
+}
+
+TileGeometryCache::Stats::Stats()
+: hits(0), diskHits(0), partialHits(0), misses(0),
+  stores(0), partialStores(0), evictions(0), spills(0),
+  memoryUsed(0), diskUsed(0), numInMemory(0), numOnDisk(0)
+{
+}
+
+double TileGeometryCache::Stats::hitRate() const
+{
+    const unsigned long long lookups = hits + diskHits + misses;
+    if (lookups == 0)
+        return 0.0;
+
+    return (double)(hits + diskHits) / (double)lookups;
+}
+
+TileGeometryCache::DrawableData::DrawableData()
+: type(Triangles), on(true), startEnable(0.0), endEnable(0.0), fadeUp(0.0), fadeDown(0.0),
+  minVisible(DrawVisibleInvalid), maxVisible(DrawVisibleInvalid),
+  minVisibleFadeBand(0.0), maxVisibleFadeBand(0.0),
+  minViewerDist(DrawVisibleInvalid), maxViewerDist(DrawVisibleInvalid), viewerCenter(0.0,0.0,0.0),
+  drawPriority(0), drawOffset(0.0), isAlpha(false), motion(false), extraFrames(0),
+  programId(EmptyIdentity), renderTargetID(EmptyIdentity),
+  lineWidth(1.0), requestZBuffer(false), writeZBuffer(true), hasMatrix(false),
+  color(255,255,255,255), hasOverrideColor(false), clipCoords(false),
+  colorEntry(-1), normalEntry(-1),
+  hasWideTweaker(false), realWidthSet(false), realWidth(0.0), edgeSize(0.0), tweakLineWidth(1.0), texRepeat(1.0),
+  tweakColor(255,255,255,255)
+{
+    mat.setIdentity();
+}
+
+bool TileGeometryCache::DrawableData::copyFrom(BasicDrawable *draw)
+{
+    // Metal keeps its uniforms in blocks we can't copy
+    if (!draw->uniBlocks.empty())
+        return false;
+
+    // If the drawable doesn't still have its geometry, we can't do anything
+    if (!draw->getGeometry(points,tris))
+        return false;
+
+    name = draw->name;
+    type = draw->type;
+    on = draw->on;
+    startEnable = draw->startEnable;  endEnable = draw->endEnable;
+    fadeUp = draw->fadeUp;  fadeDown = draw->fadeDown;
+    minVisible = draw->minVisible;  maxVisible = draw->maxVisible;
+    minVisibleFadeBand = draw->minVisibleFadeBand;  maxVisibleFadeBand = draw->maxVisibleFadeBand;
+    minViewerDist = draw->minViewerDist;  maxViewerDist = draw->maxViewerDist;
+    viewerCenter = draw->viewerCenter;
+    drawPriority = draw->drawPriority;
+    drawOffset = draw->drawOffset;
+    isAlpha = draw->isAlpha;
+    motion = draw->motion;
+    extraFrames = draw->extraFrames;
+    programId = draw->programId;
+    renderTargetID = draw->renderTargetID;
+    localMbr = draw->localMbr;
+    lineWidth = draw->lineWidth;
+    requestZBuffer = draw->requestZBuffer;
+    writeZBuffer = draw->writeZBuffer;
+    hasMatrix = draw->hasMatrix;
+    mat = draw->mat;
+    color = draw->color;
+    hasOverrideColor = draw->hasOverrideColor;
+    clipCoords = draw->clipCoords;
+    colorEntry = draw->colorEntry;
+    normalEntry = draw->normalEntry;
+    texInfo = draw->texInfo;
+    uniforms = draw->uniforms;
+
+    // Copy the attribute arrays wholesale
+    attrs.resize(draw->vertexAttributes.size());
+    for (unsigned int ii=0;ii<draw->vertexAttributes.size();ii++)
+    {
+        VertexAttribute *attr = draw->vertexAttributes[ii];
+        AttributeData &attrData = attrs[ii];
+        attrData.dataType = attr->dataType;
+        attrData.nameID = attr->nameID;
+        memcpy(attrData.defaultData,&attr->defaultData,sizeof(attrData.defaultData));
+        attrData.numElements = attr->numElements();
+        if (attrData.numElements > 0)
+        {
+            const unsigned char *attrPtr = (const unsigned char *)attr->addressForElement(0);
+            attrData.data.assign(attrPtr,attrPtr+attrData.numElements*attr->size());
+        }
+    }
+
+    // Wide vectors use a tweaker, which we can write out
+    tweakers = draw->tweakers;
+    for (auto tweaker : tweakers)
+    {
+        WideVectorTweaker *wideTweak = dynamic_cast<WideVectorTweaker *>(tweaker.get());
+        if (wideTweak)
+        {
+            hasWideTweaker = true;
+            realWidthSet = wideTweak->realWidthSet;
+            realWidth = wideTweak->realWidth;
+            edgeSize = wideTweak->edgeSize;
+            tweakLineWidth = wideTweak->lineWidth;
+            texRepeat = wideTweak->texRepeat;
+            tweakColor = wideTweak->color;
+        }
+    }
+
+    return true;
+}
+
+size_t TileGeometryCache::DrawableData::getSize() const
+{
+    size_t size = sizeof(DrawableData) + name.size();
+    size += points.size() * sizeof(Vector3f);
+    size += tris.size() * sizeof(BasicDrawable::Triangle);
+    size += texInfo.size() * sizeof(BasicDrawable::TexInfo);
+    size += uniforms.size() * sizeof(SingleVertexAttribute);
+    for (const AttributeData &attrData : attrs)
+        size += sizeof(AttributeData) + attrData.data.size();
+
+    return size;
+}
+
+TileGeometryCache::ComponentData::ComponentData()
+: vectorOffset(0.0,0.0), enable(false)
+{
+}
+
+TileGeometryCache::StyleEntry::StyleEntry()
+: styleID(0)
+{
+}
+
+size_t TileGeometryCache::StyleEntry::getSize() const
+{
+    size_t size = sizeof(StyleEntry);
+    for (const DrawableData &drawData : drawables)
+        size += drawData.getSize();
+    for (const ComponentData &compData : compObjs)
+        size += sizeof(ComponentData) + compData.drawables.size() * sizeof(int);
+
+    return size;
+}
+
+TileGeometryCache::TileEntry::TileEntry()
+: complete(true), canSpill(true), size(0)
+{
+}
+
+const TileGeometryCache::StyleEntry *TileGeometryCache::TileEntry::findStyle(long long styleID) const
+{
+    auto it = std::lower_bound(styles.begin(),styles.end(),styleID,
+                               [](const StyleEntry &styleEntry,long long styleID) { return styleEntry.styleID < styleID; });
+    if (it == styles.end() || it->styleID != styleID)
+        return NULL;
+
+    return &(*it);
+}
+
+size_t TileGeometryCache::TileEntry::getSize() const
+{
+    size_t size = sizeof(TileEntry);
+    for (const StyleEntry &styleEntry : styles)
+        size += styleEntry.getSize();
+
+        return size;
+    }
+
+    bool TileGeometryCache::TileEntry::write(FILE *fp) const
+    {
+        try {
+            WriteValue(fp,TileGeometryCacheFileVersion);
+            WriteValue(fp,complete);
+
+            unsigned int numStyles = (unsigned int)styles.size();
+            WriteValue(fp,numStyles);
+            for (const StyleEntry &styleEntry : styles)
+            {
+            WriteValue(fp,styleEntry.styleID);
+
+            unsigned int numDrawables = (unsigned int)styleEntry.drawables.size();
+            WriteValue(fp,numDrawables);
+            for (const DrawableData &drawData : styleEntry.drawables)
+            {
+                WriteString(fp,drawData.name);
+                WriteValue(fp,drawData.type);
+                WriteValue(fp,drawData.on);
+                WriteValue(fp,drawData.startEnable);  WriteValue(fp,drawData.endEnable);
+                WriteValue(fp,drawData.fadeUp);  WriteValue(fp,drawData.fadeDown);
+                WriteValue(fp,drawData.minVisible);  WriteValue(fp,drawData.maxVisible);
+                WriteValue(fp,drawData.minVisibleFadeBand);  WriteValue(fp,drawData.maxVisibleFadeBand);
+                WriteValue(fp,drawData.minViewerDist);  WriteValue(fp,drawData.maxViewerDist);
+                WriteValue(fp,drawData.viewerCenter);
+                WriteValue(fp,drawData.drawPriority);
+                WriteValue(fp,drawData.drawOffset);
+                WriteValue(fp,drawData.isAlpha);
+                WriteValue(fp,drawData.motion);
+                WriteValue(fp,drawData.extraFrames);
+                WriteValue(fp,drawData.programId);
+                WriteValue(fp,drawData.renderTargetID);
+                WriteValue(fp,drawData.localMbr);
+                WriteValue(fp,drawData.lineWidth);
+                WriteValue(fp,drawData.requestZBuffer);  WriteValue(fp,drawData.writeZBuffer);
+                WriteValue(fp,drawData.hasMatrix);
+                WriteValue(fp,drawData.mat);
+                WriteValue(fp,drawData.color);
+                WriteValue(fp,drawData.hasOverrideColor);
+                WriteValue(fp,drawData.clipCoords);
+                WriteValue(fp,drawData.colorEntry);  WriteValue(fp,drawData.normalEntry);
+                WriteArray(fp,drawData.texInfo);
+
+                unsigned int numUniforms = (unsigned int)drawData.uniforms.size();
+                WriteValue(fp,numUniforms);
+                for (const SingleVertexAttribute &uni : drawData.uniforms)
+                {
+                    WriteValue(fp,uni.nameID);
+                    WriteValue(fp,uni.type);
+                    WriteValue(fp,uni.data);
+                }
+
+                WriteArray(fp,drawData.points);
+                WriteArray(fp,drawData.tris);
+
+                unsigned int numAttrs = (unsigned int)drawData.attrs.size();
+                WriteValue(fp,numAttrs);
+                for (const AttributeData &attrData : drawData.attrs)
+                {
+                    WriteValue(fp,attrData.dataType);
+                    WriteValue(fp,attrData.nameID);
+                    WriteValue(fp,attrData.defaultData);
+                    WriteValue(fp,attrData.numElements);
+                    WriteArray(fp,attrData.data);
+                }
+
+                WriteValue(fp,drawData.hasWideTweaker);
+                WriteValue(fp,drawData.realWidthSet);
+                WriteValue(fp,drawData.realWidth);
+                WriteValue(fp,drawData.edgeSize);
+                WriteValue(fp,drawData.tweakLineWidth);
+                WriteValue(fp,drawData.texRepeat);
+                WriteValue(fp,drawData.tweakColor);
+            }
+
+            unsigned int numCompObjs = (unsigned int)styleEntry.compObjs.size();
+            WriteValue(fp,numCompObjs);
+            for (const ComponentData &compData : styleEntry.compObjs)
+            {
+                WriteArray(fp,compData.drawables);
+                WriteValue(fp,compData.vectorOffset);
+                WriteValue(fp,compData.enable);
+            }
+        }
+    }
+    catch (...)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+bool TileGeometryCache::TileEntry::read(FILE *fp)
+{
+    try {
+        unsigned int version;
+        ReadValue(fp,version);
+        if (version != TileGeometryCacheFileVersion)
+            throw 1;
+        ReadValue(fp,complete);
+
+        unsigned int numStyles;
+        ReadValue(fp,numStyles);
+        styles.resize(numStyles);
+        for (StyleEntry &styleEntry : styles)
+        {
+            ReadValue(fp,styleEntry.styleID);
+
+            unsigned int numDrawables;
+            ReadValue(fp,numDrawables);
+            styleEntry.drawables.resize(numDrawables);
+            for (DrawableData &drawData : styleEntry.drawables)
+            {
+                ReadString(fp,drawData.name);
+                ReadValue(fp,drawData.type);
+                ReadValue(fp,drawData.on);
+                ReadValue(fp,drawData.startEnable);  ReadValue(fp,drawData.endEnable);
+                ReadValue(fp,drawData.fadeUp);  ReadValue(fp,drawData.fadeDown);
+                ReadValue(fp,drawData.minVisible);  ReadValue(fp,drawData.maxVisible);
+                ReadValue(fp,drawData.minVisibleFadeBand);  ReadValue(fp,drawData.maxVisibleFadeBand);
+                ReadValue(fp,drawData.minViewerDist);  ReadValue(fp,drawData.maxViewerDist);
+                ReadValue(fp,drawData.viewerCenter);
+                ReadValue(fp,drawData.drawPriority);
+                ReadValue(fp,drawData.drawOffset);
+                ReadValue(fp,drawData.isAlpha);
+                ReadValue(fp,drawData.motion);
+                ReadValue(fp,drawData.extraFrames);
+                ReadValue(fp,drawData.programId);
+                ReadValue(fp,drawData.renderTargetID);
+                ReadValue(fp,drawData.localMbr);
+                ReadValue(fp,drawData.lineWidth);
+                ReadValue(fp,drawData.requestZBuffer);  ReadValue(fp,drawData.writeZBuffer);
+                ReadValue(fp,drawData.hasMatrix);
+                ReadValue(fp,drawData.mat);
+                ReadValue(fp,drawData.color);
+                ReadValue(fp,drawData.hasOverrideColor);
+                ReadValue(fp,drawData.clipCoords);
+                ReadValue(fp,drawData.colorEntry);  ReadValue(fp,drawData.normalEntry);
+                ReadArray(fp,drawData.texInfo);
+
+                unsigned int numUniforms;
+                ReadValue(fp,numUniforms);
+                for (unsigned int ii=0;ii<numUniforms;ii++)
+                {
+                    SingleVertexAttribute uni;
+                    ReadValue(fp,uni.nameID);
+                    ReadValue(fp,uni.type);
+                    ReadValue(fp,uni.data);
+                    drawData.uniforms.insert(uni);
+                }
+
+                ReadArray(fp,drawData.points);
+                ReadArray(fp,drawData.tris);
+
+                unsigned int numAttrs;
+                ReadValue(fp,numAttrs);
+                drawData.attrs.resize(numAttrs);
+                for (AttributeData &attrData : drawData.attrs)
+                {
+                    ReadValue(fp,attrData.dataType);
+                    ReadValue(fp,attrData.nameID);
+                    ReadValue(fp,attrData.defaultData);
+                    ReadValue(fp,attrData.numElements);
+                    ReadArray(fp,attrData.data);
+                }
+
+                ReadValue(fp,drawData.hasWideTweaker);
+                ReadValue(fp,drawData.realWidthSet);
+                ReadValue(fp,drawData.realWidth);
+                ReadValue(fp,drawData.edgeSize);
+                ReadValue(fp,drawData.tweakLineWidth);
+                ReadValue(fp,drawData.texRepeat);
+                ReadValue(fp,drawData.tweakColor);
+            }
+
+            unsigned int numCompObjs;
+            ReadValue(fp,numCompObjs);
+            styleEntry.compObjs.resize(numCompObjs);
+            for (ComponentData &compData : styleEntry.compObjs)
+            {
+                ReadArray(fp,compData.drawables);
+                ReadValue(fp,compData.vectorOffset);
+                ReadValue(fp,compData.enable);
+                // A damaged file shouldn't send us off the end
+                for (int which : compData.drawables)
+                    if (which < 0 || which >= (int)numDrawables)
+                        throw 1;
+            }
+        }
+    }
+    catch (...)
+    {
+        return false;
+    }
+
+    size = getSize();
+    return true;
+}
+
+bool TileGeometryCache::Key::operator < (const Key &that) const
+{
+    if (ident == that.ident)
+    {
+        if (styleGeneration == that.styleGeneration)
+            return dataHash < that.dataHash;
+        return styleGeneration < that.styleGeneration;
+    }
+    return ident < that.ident;
+}
+
+TileGeometryCache::TileGeometryCache(size_t memoryBudget,size_t diskBudget,const std::string &spillDir)
+: memoryBudget(memoryBudget), diskBudget(diskBudget), spillDir(spillDir)
+{
+    char sessionStr[64];
+    snprintf(sessionStr,sizeof(sessionStr),"%lx_%lx",(unsigned long)time(NULL),(unsigned long)(size_t)this);
+    sessionName = sessionStr;
+}
+
+TileGeometryCache::~TileGeometryCache()
+{
+    clear();
+}
+
+void TileGeometryCache::setMemoryBudget(size_t inMemoryBudget)
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+    memoryBudget = inMemoryBudget;
+    enforceBudgetsLocked();
+}
+
+void TileGeometryCache::setDiskBudget(size_t inDiskBudget)
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+    diskBudget = inDiskBudget;
+    enforceBudgetsLocked();
+}
+
+TileGeometryCache::Stats TileGeometryCache::getStats()
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+    return stats;
+}
+
+void TileGeometryCache::resetStats()
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+    stats.hits = 0;  stats.diskHits = 0;  stats.partialHits = 0;  stats.misses = 0;
+    stats.stores = 0;  stats.partialStores = 0;  stats.evictions = 0;  stats.spills = 0;
+}
+
+void TileGeometryCache::clear()
+{
+    std::lock_guard<std::mutex> guardLock(lock);
+
+    for (auto it = slots.begin(); it != slots.end(); ++it)
+        if (it->second.diskSize > 0)
+            remove(fileNameForKey(it->first).c_str());
+    slots.clear();
+    memLRU.clear();
+    diskLRU.clear();
+    stats.memoryUsed = 0;  stats.diskUsed = 0;
+    stats.numInMemory = 0;  stats.numOnDisk = 0;
+}
+
+unsigned long long TileGeometryCache::hashData(RawData *rawData)
+{
+    // 64 bit FNV-1a
+    unsigned long long hash = 14695981039346656037ULL;
+    const unsigned char *bytes = rawData->getRawData();
+    const unsigned long len = rawData->getLen();
+    for (unsigned long ii=0;ii<len;ii++)
+    {
+        hash ^= bytes[ii];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+std::string TileGeometryCache::fileNameForKey(const Key &key) const
+{
+    char fileName[256];
+    snprintf(fileName,sizeof(fileName),"wkgeom_%s_%d_%d_%d_%d_%llx.bin",sessionName.c_str(),
+             key.ident.level,key.ident.x,key.ident.y,key.styleGeneration,key.dataHash);
+
+    return spillDir + "/" + fileName;
+}
+
+void TileGeometryCache::removeDiskLocked(SlotMap::iterator it)
+{
+    Slot &slot = it->second;
+    if (slot.diskSize == 0)
+        return;
+
+    remove(fileNameForKey(it->first).c_str());
+    diskLRU.erase(slot.diskIt);
+    stats.diskUsed -= slot.diskSize;
+    stats.numOnDisk--;
+    slot.diskSize = 0;
+}
+
+void TileGeometryCache::enforceBudgetsLocked()
+{
+    // Push the least recently used out of memory, onto disk if we can
+    while (stats.memoryUsed > memoryBudget && !memLRU.empty())
+    {
+        Key key = memLRU.back();
+        memLRU.pop_back();
+        auto it = slots.find(key);
+        if (it == slots.end())
+            continue;
+        Slot &slot = it->second;
+        stats.memoryUsed -= slot.entry->size;
+        stats.numInMemory--;
+        stats.evictions++;
+
+        if (slot.diskSize == 0 && diskBudget > 0 && !spillDir.empty() &&
+            slot.entry->canSpill && slot.entry->size <= diskBudget)
+        {
+            const std::string fileName = fileNameForKey(key);
+            FILE *fp = fopen(fileName.c_str(),"wb");
+            if (fp)
+            {
+                bool success = slot.entry->write(fp);
+                long fileSize = ftell(fp);
+                fclose(fp);
+                if (success && fileSize > 0)
+                {
+                    slot.diskSize = fileSize;
+                    diskLRU.push_front(key);
+                    slot.diskIt = diskLRU.begin();
+                    stats.diskUsed += slot.diskSize;
+                    stats.numOnDisk++;
+                    stats.spills++;
+                } else {
+                    wkLogLevel(Warn,"TileGeometryCache: Failed to write %s",fileName.c_str());
+                    remove(fileName.c_str());
+                }
+            }
+        }
+
+        slot.entry.reset();
+        if (slot.diskSize == 0)
+            slots.erase(it);
+    }
+
+    // And then the least recently used off disk
+    while (stats.diskUsed > diskBudget && !diskLRU.empty())
+    {
+        auto it = slots.find(diskLRU.back());
+        if (it == slots.end())
+        {
+            diskLRU.pop_back();
+            continue;
+        }
+        removeDiskLocked(it);
+        if (!it->second.entry)
+            slots.erase(it);
+    }
+}
+
+BasicDrawable *TileGeometryCache::buildDrawable(SceneRenderer *renderer,const DrawableData &drawData)
+{
+    BasicDrawableBuilderRef builder = renderer->makeBasicDrawableBuilder(drawData.name);
+    BasicDrawable *draw = builder->basicDraw;
+
+    // Replace the standard attributes with exactly what we had
+    for (VertexAttribute *attr : draw->vertexAttributes)
+        delete attr;
+    draw->vertexAttributes.clear();
+    for (const AttributeData &attrData : drawData.attrs)
+    {
+        int which = builder->addAttribute(attrData.dataType,attrData.nameID,attrData.numElements);
+        VertexAttribute *attr = draw->vertexAttributes[which];
+        memcpy(&attr->defaultData,attrData.defaultData,sizeof(attr->defaultData));
+        if (attrData.numElements > 0)
+        {
+            attr->resize(attrData.numElements);
+            memcpy(attr->addressForElement(0),&attrData.data[0],attrData.data.size());
+        }
+    }
+    draw->colorEntry = drawData.colorEntry;
+    draw->normalEntry = drawData.normalEntry;
+    draw->texInfo = drawData.texInfo;
+
+    builder->points = drawData.points;
+    builder->tris = drawData.tris;
+
+    draw->type = drawData.type;
+    draw->on = drawData.on;
+    draw->startEnable = drawData.startEnable;  draw->endEnable = drawData.endEnable;
+    draw->fadeUp = drawData.fadeUp;  draw->fadeDown = drawData.fadeDown;
+    draw->minVisible = drawData.minVisible;  draw->maxVisible = drawData.maxVisible;
+    draw->minVisibleFadeBand = drawData.minVisibleFadeBand;  draw->maxVisibleFadeBand = drawData.maxVisibleFadeBand;
+    draw->minViewerDist = drawData.minViewerDist;  draw->maxViewerDist = drawData.maxViewerDist;
+    draw->viewerCenter = drawData.viewerCenter;
+    draw->drawPriority = drawData.drawPriority;
+    draw->drawOffset = drawData.drawOffset;
+    draw->isAlpha = drawData.isAlpha;
+    draw->motion = drawData.motion;
+    draw->extraFrames = drawData.extraFrames;
+    draw->programId = drawData.programId;
+    draw->renderTargetID = drawData.renderTargetID;
+    draw->localMbr = drawData.localMbr;
+    draw->lineWidth = drawData.lineWidth;
+    draw->requestZBuffer = drawData.requestZBuffer;
+    draw->writeZBuffer = drawData.writeZBuffer;
+    draw->hasMatrix = drawData.hasMatrix;
+    draw->mat = drawData.mat;
+    draw->color = drawData.color;
+    draw->hasOverrideColor = drawData.hasOverrideColor;
+    draw->clipCoords = drawData.clipCoords;
+    draw->uniforms = drawData.uniforms;
+
+    // Tweakers can be shared if we've still got them, otherwise we make a new one
+    if (!drawData.tweakers.empty())
+    {
+        for (auto tweaker : drawData.tweakers)
+            draw->addTweaker(tweaker);
+    } else if (drawData.hasWideTweaker) {
+        WideVectorDrawableBuilderRef wideBuilder = renderer->makeWideVectorDrawableBuilder(drawData.name);
+        WideVectorTweaker *tweak = wideBuilder->makeTweaker();
+        tweak->realWidthSet = drawData.realWidthSet;
+        tweak->realWidth = drawData.realWidth;
+        tweak->edgeSize = drawData.edgeSize;
+        tweak->lineWidth = drawData.tweakLineWidth;
+        tweak->texRepeat = drawData.texRepeat;
+        tweak->color = drawData.tweakColor;
+        draw->addTweaker(DrawableTweakerRef(tweak));
+    }
+
+    return builder->getDrawable();
+}
+
+TileGeometryCache::TileEntryRef TileGeometryCache::findTile(const QuadTreeIdentifier &ident,int styleGeneration,unsigned long long dataHash)
+{
+    const Key key(ident,styleGeneration,dataHash);
+    TileEntryRef entry;
+    std::string fileName;
+    {
+        std::lock_guard<std::mutex> guardLock(lock);
+
+        auto it = slots.find(key);
+        if (it == slots.end())
+        {
+            stats.misses++;
+            return TileEntryRef();
+        }
+        Slot &slot = it->second;
+        if (slot.entry)
+        {
+            memLRU.splice(memLRU.begin(),memLRU,slot.memIt);
+            entry = slot.entry;
+            stats.hits++;
+            if (!entry->complete)
+                stats.partialHits++;
+            return entry;
+        }
+        fileName = fileNameForKey(key);
+    }
+
+    // Read it back from disk without holding the lock
+    TileEntryRef diskEntry(new TileEntry());
+    bool success = false;
+    FILE *fp = fopen(fileName.c_str(),"rb");
+    if (fp)
+    {
+        success = diskEntry->read(fp);
+        fclose(fp);
+    }
+
+    std::lock_guard<std::mutex> guardLock(lock);
+    auto it = slots.find(key);
+    if (!success)
+    {
+        if (it != slots.end() && !it->second.entry)
+        {
+            removeDiskLocked(it);
+            slots.erase(it);
+        }
+        stats.misses++;
+        return TileEntryRef();
+    }
+
+    stats.diskHits++;
+    if (!diskEntry->complete)
+        stats.partialHits++;
+    if (it != slots.end())
+    {
+        Slot &slot = it->second;
+        if (slot.entry)
+            diskEntry = slot.entry;
+        else {
+            // Bring it back into memory, but keep the disk copy in case it's evicted again
+            slot.entry = diskEntry;
+            memLRU.push_front(key);
+            slot.memIt = memLRU.begin();
+            stats.memoryUsed += diskEntry->size;
+            stats.numInMemory++;
+            if (slot.diskSize > 0)
+                diskLRU.splice(diskLRU.begin(),diskLRU,slot.diskIt);
+            enforceBudgetsLocked();
+        }
+    }
+
+    return diskEntry;
+}
+
+void TileGeometryCache::restoreStyle(PlatformThreadInfo *inst,const StyleEntry &styleEntry,
+                                     MapboxVectorStyleSetImpl *styleSet,VectorTileData *styleData)
+{
+    SceneRenderer *renderer = styleSet->vecManage->getSceneRenderer();
+
+    // Rebuild the drawables with new IDs
+    std::vector<SimpleIdentity> drawIDs(styleEntry.drawables.size());
+    for (unsigned int ii=0;ii<styleEntry.drawables.size();ii++)
+    {
+        BasicDrawable *draw = buildDrawable(renderer,styleEntry.drawables[ii]);
+        drawIDs[ii] = draw->getId();
+        styleData->changes.push_back(new AddDrawableReq(draw));
+    }
+
+    // And the component objects that own them
+    for (const ComponentData &compData : styleEntry.compObjs)
+    {
+        ComponentObjectRef compObj = styleSet->makeComponentObject(inst);
+        for (int which : compData.drawables)
+            compObj->drawIDs.insert(drawIDs[which]);
+        compObj->vectorOffset = compData.vectorOffset;
+        compObj->enable = compData.enable;
+        styleSet->compManage->addComponentObject(compObj);
+        styleData->compObjs.push_back(compObj);
+    }
+}
+
+bool TileGeometryCache::TileEntry::addStyle(long long styleID,MapboxVectorStyleSetImpl *styleSet,VectorTileData *styleData)
+{
+    StyleEntry styleEntry;
+    styleEntry.styleID = styleID;
+    if (!styleData->images.empty() || !styleData->vecObjs.empty())
+        return false;
+
+    // Copy out the drawables
+    bool styleCanSpill = true;
+    std::map<SimpleIdentity,int> drawIndex;
+    for (ChangeRequest *change : styleData->changes)
+    {
+        AddDrawableReq *drawReq = dynamic_cast<AddDrawableReq *>(change);
+        BasicDrawable *draw = drawReq ? dynamic_cast<BasicDrawable *>(drawReq->getDrawable().get()) : NULL;
+        if (!draw)
+            return false;
+
+        styleEntry.drawables.resize(styleEntry.drawables.size()+1);
+        DrawableData &drawData = styleEntry.drawables.back();
+        if (!drawData.copyFrom(draw))
+            return false;
+        // Any tweaker other than the wide vector one can only live in memory
+        if (drawData.tweakers.size() > (drawData.hasWideTweaker ? 1 : 0))
+            styleCanSpill = false;
+
+        drawIndex[draw->getId()] = (int)(styleEntry.drawables.size()-1);
+    }
+
+    // Component objects can only refer to those drawables
+    std::set<int> claimed;
+    for (ComponentObjectRef compObj : styleData->compObjs)
+    {
+        if (!compObj->markerIDs.empty() || !compObj->labelIDs.empty() || !compObj->shapeIDs.empty() ||
+            !compObj->chunkIDs.empty() || !compObj->loftIDs.empty() || !compObj->billIDs.empty() ||
+            !compObj->geomIDs.empty() || !compObj->partSysIDs.empty() || !compObj->selectIDs.empty() ||
+            !compObj->drawStringIDs.empty() || !compObj->vecObjs.empty() || compObj->isSelectable)
+            return false;
+
+        SimpleIDSet drawIDs = compObj->drawIDs;
+        if (!compObj->vectorIDs.empty() && styleSet->vecManage)
+            styleSet->vecManage->getDrawIDs(compObj->vectorIDs,drawIDs);
+        if (!compObj->wideVectorIDs.empty() && styleSet->wideVecManage)
+            styleSet->wideVecManage->getDrawIDs(compObj->wideVectorIDs,drawIDs);
+
+        ComponentData compData;
+        for (SimpleIdentity drawID : drawIDs)
+        {
+            auto it = drawIndex.find(drawID);
+            if (it == drawIndex.end())
+                return false;
+            compData.drawables.push_back(it->second);
+            claimed.insert(it->second);
+        }
+        compData.vectorOffset = compObj->vectorOffset;
+        compData.enable = compObj->enable;
+        styleEntry.compObjs.push_back(compData);
+    }
+
+    // Every drawable has to belong to something or we'd never clean it up
+    if (claimed.size() != styleEntry.drawables.size())
+        return false;
+
+    auto it = std::lower_bound(styles.begin(),styles.end(),styleID,
+                               [](const StyleEntry &styleEntry,long long styleID) { return styleEntry.styleID < styleID; });
+    styles.insert(it,std::move(styleEntry));
+    canSpill = canSpill && styleCanSpill;
+
+    return true;
+}
+
+void TileGeometryCache::addTile(const QuadTreeIdentifier &ident,int styleGeneration,unsigned long long dataHash,TileEntryRef entry)
+{
+    const Key key(ident,styleGeneration,dataHash);
+    entry->size = entry->getSize();
+
+    std::lock_guard<std::mutex> guardLock(lock);
+
+    // Someone else may have beat us to it
+    if (slots.find(key) != slots.end())
+        return;
+
+    Slot &slot = slots[key];
+    slot.entry = entry;
+    memLRU.push_front(key);
+    slot.memIt = memLRU.begin();
+    stats.memoryUsed += entry->size;
+    stats.numInMemory++;
+    stats.stores++;
+    if (!entry->complete)
+        stats.partialStores++;
+    enforceBudgetsLocked();
+}
+
+}
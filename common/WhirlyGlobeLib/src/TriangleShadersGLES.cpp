@@ -233,11 +233,12 @@ void main()
    {
      vec4 ambient = vec4(0.0,0.0,0.0,0.0);
      vec4 diffuse = vec4(0.0,0.0,0.0,0.0);
+     vec3 instNorm = normalize((a_singleMatrix * vec4(a_normal.xyz, 0.0)).xyz);
      for (int ii=0;ii<8;ii++)
      {
         if (ii>=u_numLights)
            break;
-        vec3 adjNorm = light[ii].viewdepend > 0.0 ? normalize((u_mvpMatrix * vec4(a_normal.xyz, 0.0)).xyz) : a_normal.xzy;
+        vec3 adjNorm = light[ii].viewdepend > 0.0 ? normalize((u_mvpMatrix * vec4(instNorm, 0.0)).xyz) : instNorm.xzy;
         float ndotl;
 //        float ndoth;\n
         ndotl = max(0.0, dot(adjNorm, light[ii].direction));
@@ -0,0 +1,877 @@
+/*
+ *  VectorIndexedFile.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <stdio.h>
+#import <fcntl.h>
+#import <unistd.h>
+#import <sys/mman.h>
+#import <sys/stat.h>
+#import <unordered_map>
+#import "VectorIndexedFile.h"
+#import "PackedRTree.h"
+#import "WhirlyKitLog.h"
+
+using namespace Eigen;
+
+namespace WhirlyKit
+{
+
+/* The file is a fixed header followed by sections, each aligned to 8 bytes.
+   Features are stored in Hilbert order of their bounding box centers, so the
+   leaves of the packed R-tree are just the features in file order.
+   Inner nodes follow, one level at a time, with the root last.
+ */
+
+// Number of children per R-tree node
+static const uint32_t VectorIndexedNodeSize = 16;
+
+typedef struct
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t numFeatures;
+    uint32_t numColumns;
+    uint32_t nodeSize;
+    uint32_t numNodes;
+    uint32_t numLevels;
+    uint32_t pad;
+    float bounds[4];
+    uint64_t featureOffset,ringOffset,pointOffset,meshPointOffset,triOffset;
+    uint64_t levelOffset,nodeOffset,columnOffset,stringOffset;
+    uint64_t fileSize;
+} VectorIndexedHeader;
+
+// For triangle meshes, firstRing and numRings refer to the mesh points instead
+typedef struct
+{
+    uint32_t type;
+    uint32_t firstRing,numRings;
+    uint32_t firstTri,numTris;
+    uint32_t pad;
+    float mbr[4];
+} VectorIndexedFeature;
+
+typedef struct
+{
+    uint32_t firstPoint,numPoints;
+} VectorIndexedRing;
+
+// Index is the feature for leaves and the first child for everything else
+typedef struct
+{
+    float mbr[4];
+    uint32_t index;
+} VectorIndexedNode;
+
+typedef struct
+{
+    uint32_t nameOffset;
+    uint32_t type;
+    uint64_t presentOffset,dataOffset;
+} VectorIndexedColumn;
+
+static const char VectorIndexedMagic[4] = {'W','K','V','I'};
+
+static uint64_t AlignOffset(uint64_t offset)
+{
+    return (offset + 7) & ~(uint64_t)7;
+}
+
+// Write a section, padded out to its aligned offset first
+static void WriteSection(FILE *fp,uint64_t &where,uint64_t offset,const void *data,size_t len)
+{
+    static const char zeros[8] = {0,0,0,0,0,0,0,0};
+    if (offset > where)
+    {
+        if (fwrite(zeros,1,offset-where,fp) != offset-where)
+            throw 1;
+        where = offset;
+    }
+    if (len > 0 && fwrite(data,1,len,fp) != len)
+        throw 1;
+    where += len;
+}
+
+// Values for a single column while we're writing
+class ColumnBuilder
+{
+public:
+    ColumnBuilder() : type(DictTypeNone) { }
+
+    std::string name;
+    DictionaryType type;
+    std::vector<unsigned char> present;
+    std::vector<unsigned char> data;
+    uint64_t presentOffset,dataOffset;
+};
+
+// Collects strings, sharing the duplicates
+class StringPool
+{
+public:
+    StringPool() { add(""); }
+
+    uint32_t add(const std::string &str)
+    {
+        auto it = offsets.find(str);
+        if (it != offsets.end())
+            return it->second;
+        uint32_t offset = (uint32_t)pool.size();
+        pool.insert(pool.end(),str.begin(),str.end());
+        pool.push_back(0);
+        offsets[str] = offset;
+        return offset;
+    }
+
+    std::vector<char> pool;
+    std::unordered_map<std::string,uint32_t> offsets;
+};
+
+template<typename T> static void AppendValue(std::vector<unsigned char> &data,const T &val)
+{
+    const unsigned char *ptr = (const unsigned char *)&val;
+    data.insert(data.end(),ptr,ptr+sizeof(T));
+}
+
+bool VectorWriteIndexedFile(const std::string &fileName,const ShapeSet &shapes)
+{
+    // Sort out the features and their bounds
+    class FeatureInfo
+    {
+    public:
+        VectorShapeRef shape;
+        VectorIndexedShapeType type;
+        float mbr[4];
+        uint32_t hilbert;
+    };
+    std::vector<FeatureInfo> feats;
+    feats.reserve(shapes.size());
+    float bounds[4] = {MAXFLOAT,MAXFLOAT,-MAXFLOAT,-MAXFLOAT};
+    for (auto shape : shapes)
+    {
+        FeatureInfo feat;
+        feat.shape = shape;
+        feat.mbr[0] = MAXFLOAT;  feat.mbr[1] = MAXFLOAT;  feat.mbr[2] = -MAXFLOAT;  feat.mbr[3] = -MAXFLOAT;
+        auto addPt = [&feat](float x,float y)
+        {
+            feat.mbr[0] = std::min(feat.mbr[0],x);  feat.mbr[1] = std::min(feat.mbr[1],y);
+            feat.mbr[2] = std::max(feat.mbr[2],x);  feat.mbr[3] = std::max(feat.mbr[3],y);
+        };
+
+        if (VectorPointsRef pts = std::dynamic_pointer_cast<VectorPoints>(shape))
+        {
+            feat.type = VectorIndexedPoints;
+            for (const Point2f &pt : pts->pts)
+                addPt(pt.x(),pt.y());
+        } else if (VectorLinearRef lin = std::dynamic_pointer_cast<VectorLinear>(shape))
+        {
+            feat.type = VectorIndexedLinear;
+            for (const Point2f &pt : lin->pts)
+                addPt(pt.x(),pt.y());
+        } else if (VectorArealRef ar = std::dynamic_pointer_cast<VectorAreal>(shape))
+        {
+            feat.type = VectorIndexedAreal;
+            for (const VectorRing &ring : ar->loops)
+                for (const Point2f &pt : ring)
+                    addPt(pt.x(),pt.y());
+        } else if (VectorTrianglesRef mesh = std::dynamic_pointer_cast<VectorTriangles>(shape))
+        {
+            feat.type = VectorIndexedTriangles;
+            for (const Point3f &pt : mesh->pts)
+                addPt(pt.x(),pt.y());
+        } else {
+            wkLogLevel(Warn,"VectorWriteIndexedFile: Unsupported shape type");
+            return false;
+        }
+        if (feat.mbr[0] <= feat.mbr[2])
+            PackedRTreeExpand(bounds,feat.mbr);
+        feats.push_back(feat);
+    }
+    if (feats.empty())
+    {
+        bounds[0] = 0.0;  bounds[1] = 0.0;  bounds[2] = 0.0;  bounds[3] = 0.0;
+    }
+
+    // Sort along the Hilbert curve so nearby features are nearby in the file
+    const float spanX = std::max(bounds[2] - bounds[0],1e-20f);
+    const float spanY = std::max(bounds[3] - bounds[1],1e-20f);
+    for (FeatureInfo &feat : feats)
+    {
+        float midX = feat.mbr[0] <= feat.mbr[2] ? (feat.mbr[0] + feat.mbr[2])/2.0 : bounds[0];
+        float midY = feat.mbr[1] <= feat.mbr[3] ? (feat.mbr[1] + feat.mbr[3])/2.0 : bounds[1];
+        feat.hilbert = HilbertIndexFraction((midX - bounds[0]) / spanX,(midY - bounds[1]) / spanY);
+    }
+    std::stable_sort(feats.begin(),feats.end(),
+                     [](const FeatureInfo &a,const FeatureInfo &b) { return a.hilbert < b.hilbert; });
+
+    // Geometry goes into flat arrays
+    std::vector<VectorIndexedFeature> featRecs(feats.size());
+    std::vector<VectorIndexedRing> rings;
+    Point2fVector points;
+    std::vector<Point3f> meshPoints;
+    std::vector<int32_t> tris;
+    auto addRing = [&rings,&points](const VectorRing &ring)
+    {
+        VectorIndexedRing ringRec;
+        ringRec.firstPoint = (uint32_t)points.size();
+        ringRec.numPoints = (uint32_t)ring.size();
+        points.insert(points.end(),ring.begin(),ring.end());
+        rings.push_back(ringRec);
+    };
+    for (unsigned int ii=0;ii<feats.size();ii++)
+    {
+        const FeatureInfo &feat = feats[ii];
+        VectorIndexedFeature &rec = featRecs[ii];
+        memset(&rec,0,sizeof(rec));
+        rec.type = feat.type;
+        memcpy(rec.mbr,feat.mbr,sizeof(rec.mbr));
+        rec.firstRing = (uint32_t)rings.size();
+        switch (feat.type)
+        {
+            case VectorIndexedPoints:
+                addRing(((VectorPoints *)feat.shape.get())->pts);
+                rec.numRings = 1;
+                break;
+            case VectorIndexedLinear:
+                addRing(((VectorLinear *)feat.shape.get())->pts);
+                rec.numRings = 1;
+                break;
+            case VectorIndexedAreal:
+            {
+                VectorAreal *ar = (VectorAreal *)feat.shape.get();
+                for (const VectorRing &ring : ar->loops)
+                    addRing(ring);
+                rec.numRings = (uint32_t)ar->loops.size();
+            }
+                break;
+            case VectorIndexedTriangles:
+            {
+                VectorTriangles *mesh = (VectorTriangles *)feat.shape.get();
+                rec.firstRing = (uint32_t)meshPoints.size();
+                rec.numRings = (uint32_t)mesh->pts.size();
+                meshPoints.insert(meshPoints.end(),mesh->pts.begin(),mesh->pts.end());
+                rec.firstTri = (uint32_t)(tris.size()/3);
+                rec.numTris = (uint32_t)mesh->tris.size();
+                for (const VectorTriangles::Triangle &tri : mesh->tris)
+                    tris.insert(tris.end(),tri.pts,tri.pts+3);
+            }
+                break;
+        }
+    }
+
+    // Packed R-tree.  Leaves are the features in order, then each level up.
+    std::vector<VectorIndexedNode> nodes(feats.size());
+    for (unsigned int ii=0;ii<feats.size();ii++)
+    {
+        memcpy(nodes[ii].mbr,featRecs[ii].mbr,sizeof(nodes[ii].mbr));
+        nodes[ii].index = ii;
+    }
+    std::vector<uint32_t> levelBounds;
+    PackedRTreeBuild(nodes,levelBounds,VectorIndexedNodeSize);
+
+    // Attributes go into columns
+    StringPool strings;
+    std::vector<ColumnBuilder> columns;
+    std::map<std::string,int> columnsByName;
+    for (const FeatureInfo &feat : feats)
+    {
+        MutableDictionaryRef dict = feat.shape->getAttrDict();
+        if (!dict)
+            continue;
+        for (const std::string &key : dict->getKeys())
+        {
+            DictionaryType type = dict->getType(key);
+            if (type != DictTypeString && type != DictTypeInt && type != DictTypeIdentity && type != DictTypeDouble)
+                continue;
+            auto it = columnsByName.find(key);
+            if (it == columnsByName.end())
+            {
+                columnsByName[key] = (int)columns.size();
+                ColumnBuilder column;
+                column.name = key;
+                column.type = type;
+                columns.push_back(column);
+            } else {
+                // Ints and doubles can mix, which makes it a double column
+                ColumnBuilder &column = columns[it->second];
+                if ((column.type == DictTypeInt && type == DictTypeDouble) ||
+                    (column.type == DictTypeDouble && type == DictTypeInt))
+                    column.type = DictTypeDouble;
+            }
+        }
+    }
+    for (ColumnBuilder &column : columns)
+    {
+        column.present.resize(feats.size(),0);
+        for (unsigned int ii=0;ii<feats.size();ii++)
+        {
+            MutableDictionaryRef dict = feats[ii].shape->getAttrDict();
+            DictionaryType type = dict ? dict->getType(column.name) : DictTypeNone;
+            bool present = (type == column.type) || (column.type == DictTypeDouble && type == DictTypeInt);
+            column.present[ii] = present;
+            switch (column.type)
+            {
+                case DictTypeString:
+                    AppendValue(column.data,present ? strings.add(dict->getString(column.name)) : (uint32_t)0);
+                    break;
+                case DictTypeInt:
+                    AppendValue(column.data,present ? (int32_t)dict->getInt(column.name) : (int32_t)0);
+                    break;
+                case DictTypeIdentity:
+                    AppendValue(column.data,present ? (uint64_t)dict->getIdentity(column.name) : (uint64_t)0);
+                    break;
+                case DictTypeDouble:
+                    AppendValue(column.data,present ? dict->getDouble(column.name) : 0.0);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    std::vector<VectorIndexedColumn> columnRecs(columns.size());
+    for (unsigned int ii=0;ii<columns.size();ii++)
+    {
+        columnRecs[ii].nameOffset = strings.add(columns[ii].name);
+        columnRecs[ii].type = columns[ii].type;
+    }
+
+    // Work out where everything goes
+    VectorIndexedHeader header;
+    memset(&header,0,sizeof(header));
+    memcpy(header.magic,VectorIndexedMagic,sizeof(header.magic));
+    header.version = VectorIndexedFileVersion;
+    header.numFeatures = (uint32_t)feats.size();
+    header.numColumns = (uint32_t)columns.size();
+    header.nodeSize = VectorIndexedNodeSize;
+    header.numNodes = (uint32_t)nodes.size();
+    header.numLevels = (uint32_t)levelBounds.size();
+    memcpy(header.bounds,bounds,sizeof(bounds));
+    uint64_t offset = sizeof(header);
+    auto place = [&offset](uint64_t &secOffset,size_t len)
+    {
+        secOffset = AlignOffset(offset);
+        offset = secOffset + len;
+    };
+    place(header.featureOffset,featRecs.size()*sizeof(VectorIndexedFeature));
+    place(header.ringOffset,rings.size()*sizeof(VectorIndexedRing));
+    place(header.pointOffset,points.size()*2*sizeof(float));
+    place(header.meshPointOffset,meshPoints.size()*3*sizeof(float));
+    place(header.triOffset,tris.size()*sizeof(int32_t));
+    place(header.levelOffset,levelBounds.size()*sizeof(uint32_t));
+    place(header.nodeOffset,nodes.size()*sizeof(VectorIndexedNode));
+    place(header.columnOffset,columnRecs.size()*sizeof(VectorIndexedColumn));
+    for (unsigned int ii=0;ii<columns.size();ii++)
+    {
+        place(columns[ii].presentOffset,columns[ii].present.size());
+        place(columns[ii].dataOffset,columns[ii].data.size());
+        columnRecs[ii].presentOffset = columns[ii].presentOffset;
+        columnRecs[ii].dataOffset = columns[ii].dataOffset;
+    }
+    place(header.stringOffset,strings.pool.size());
+    header.fileSize = offset;
+
+    FILE *fp = fopen(fileName.c_str(),"wb");
+    if (!fp)
+        return false;
+
+    try {
+        uint64_t where = 0;
+        WriteSection(fp,where,0,&header,sizeof(header));
+        WriteSection(fp,where,header.featureOffset,featRecs.empty() ? NULL : &featRecs[0],featRecs.size()*sizeof(VectorIndexedFeature));
+        WriteSection(fp,where,header.ringOffset,rings.empty() ? NULL : &rings[0],rings.size()*sizeof(VectorIndexedRing));
+        for (unsigned int ii=0;ii<points.size();ii++)
+        {
+            float pt[2] = {points[ii].x(),points[ii].y()};
+            WriteSection(fp,where,ii == 0 ? header.pointOffset : where,pt,sizeof(pt));
+        }
+        for (unsigned int ii=0;ii<meshPoints.size();ii++)
+        {
+            float pt[3] = {meshPoints[ii].x(),meshPoints[ii].y(),meshPoints[ii].z()};
+            WriteSection(fp,where,ii == 0 ? header.meshPointOffset : where,pt,sizeof(pt));
+        }
+        WriteSection(fp,where,header.triOffset,tris.empty() ? NULL : &tris[0],tris.size()*sizeof(int32_t));
+        WriteSection(fp,where,header.levelOffset,levelBounds.empty() ? NULL : &levelBounds[0],levelBounds.size()*sizeof(uint32_t));
+        WriteSection(fp,where,header.nodeOffset,nodes.empty() ? NULL : &nodes[0],nodes.size()*sizeof(VectorIndexedNode));
+        WriteSection(fp,where,header.columnOffset,columnRecs.empty() ? NULL : &columnRecs[0],columnRecs.size()*sizeof(VectorIndexedColumn));
+        for (const ColumnBuilder &column : columns)
+        {
+            WriteSection(fp,where,column.presentOffset,column.present.empty() ? NULL : &column.present[0],column.present.size());
+            WriteSection(fp,where,column.dataOffset,column.data.empty() ? NULL : &column.data[0],column.data.size());
+        }
+        WriteSection(fp,where,header.stringOffset,&strings.pool[0],strings.pool.size());
+    }
+    catch (...)
+    {
+        fclose(fp);
+        return false;
+    }
+
+    fclose(fp);
+    return true;
+}
+
+VectorShapeView::VectorShapeView()
+: file(NULL), index(0)
+{
+}
+
+VectorIndexedShapeType VectorShapeView::getType() const
+{
+    return (VectorIndexedShapeType)((const VectorIndexedFeature *)file->features)[index].type;
+}
+
+Mbr VectorShapeView::getMbr() const
+{
+    const float *mbr = ((const VectorIndexedFeature *)file->features)[index].mbr;
+    return Mbr(Point2f(mbr[0],mbr[1]),Point2f(mbr[2],mbr[3]));
+}
+
+unsigned int VectorShapeView::getNumRings() const
+{
+    const VectorIndexedFeature &feat = ((const VectorIndexedFeature *)file->features)[index];
+    return feat.type == VectorIndexedTriangles ? 0 : feat.numRings;
+}
+
+unsigned int VectorShapeView::getRingSize(unsigned int which) const
+{
+    const VectorIndexedFeature &feat = ((const VectorIndexedFeature *)file->features)[index];
+    return ((const VectorIndexedRing *)file->rings)[feat.firstRing+which].numPoints;
+}
+
+const Point2f *VectorShapeView::getRingPoints(unsigned int which) const
+{
+    const VectorIndexedFeature &feat = ((const VectorIndexedFeature *)file->features)[index];
+    return file->points + ((const VectorIndexedRing *)file->rings)[feat.firstRing+which].firstPoint;
+}
+
+unsigned int VectorShapeView::getNumMeshPoints() const
+{
+    const VectorIndexedFeature &feat = ((const VectorIndexedFeature *)file->features)[index];
+    return feat.type == VectorIndexedTriangles ? feat.numRings : 0;
+}
+
+const Point3f *VectorShapeView::getMeshPoints() const
+{
+    const VectorIndexedFeature &feat = ((const VectorIndexedFeature *)file->features)[index];
+    return file->meshPoints + feat.firstRing;
+}
+
+unsigned int VectorShapeView::getNumTriangles() const
+{
+    return ((const VectorIndexedFeature *)file->features)[index].numTris;
+}
+
+const int32_t *VectorShapeView::getTriangles() const
+{
+    const VectorIndexedFeature &feat = ((const VectorIndexedFeature *)file->features)[index];
+    return file->tris + 3*feat.firstTri;
+}
+
+VectorIndexedFile::VectorIndexedFile(const std::string &fileName)
+: mapData(NULL), mapSize(0), valid(false), where(0),
+  header(NULL), features(NULL), rings(NULL), points(NULL), meshPoints(NULL), tris(NULL),
+  levelBounds(NULL), nodes(NULL), columns(NULL), strings(NULL),
+  maxRings(0), maxPoints(0), maxMeshPoints(0), maxTris(0), stringsLen(0)
+{
+    int fd = open(fileName.c_str(),O_RDONLY);
+    if (fd < 0)
+        return;
+    struct stat fileStat;
+    if (fstat(fd,&fileStat) != 0 || fileStat.st_size < (off_t)sizeof(VectorIndexedHeader))
+    {
+        close(fd);
+        return;
+    }
+    mapSize = fileStat.st_size;
+    mapData = mmap(NULL,mapSize,PROT_READ,MAP_PRIVATE,fd,0);
+    close(fd);
+    if (mapData == MAP_FAILED)
+    {
+        mapData = NULL;
+        return;
+    }
+
+    // Make sure everything fits in the file before we trust it
+    const VectorIndexedHeader *head = (const VectorIndexedHeader *)mapData;
+    if (memcmp(head->magic,VectorIndexedMagic,sizeof(head->magic)) || head->version != VectorIndexedFileVersion ||
+        head->fileSize > mapSize || head->nodeSize < 2)
+    {
+        wkLogLevel(Warn,"VectorIndexedFile: Not a valid file or unsupported version: %s",fileName.c_str());
+        return;
+    }
+    // Sections have to fit in the file.  Individual features are checked as we get to them.
+    if (head->featureOffset + (uint64_t)head->numFeatures*sizeof(VectorIndexedFeature) > mapSize ||
+        head->levelOffset + (uint64_t)head->numLevels*sizeof(uint32_t) > mapSize ||
+        head->nodeOffset + (uint64_t)head->numNodes*sizeof(VectorIndexedNode) > mapSize ||
+        head->columnOffset + (uint64_t)head->numColumns*sizeof(VectorIndexedColumn) > mapSize ||
+        head->stringOffset >= mapSize)
+        return;
+    // The leaves are the features, then each level up to a root on its own
+    const uint32_t *levels = (const uint32_t *)dataAt(head->levelOffset);
+    if (!PackedRTreeCheckLevels(levels,head->numLevels,head->numNodes) ||
+        (head->numNodes > 0 && levels[0] != head->numFeatures))
+    {
+        wkLogLevel(Warn,"VectorIndexedFile: Bad index in %s",fileName.c_str());
+        return;
+    }
+    // Geometry sections run up to the next one, in the order the writer puts them
+    auto numRecs = [this](uint64_t offset,uint64_t nextOffset,size_t recSize) -> uint64_t
+    {
+        nextOffset = std::min(nextOffset,(uint64_t)mapSize);
+        return offset <= nextOffset ? (nextOffset - offset) / recSize : 0;
+    };
+    maxRings = numRecs(head->ringOffset,head->pointOffset,sizeof(VectorIndexedRing));
+    maxPoints = numRecs(head->pointOffset,head->meshPointOffset,2*sizeof(float));
+    maxMeshPoints = numRecs(head->meshPointOffset,head->triOffset,3*sizeof(float));
+    maxTris = numRecs(head->triOffset,head->levelOffset,3*sizeof(int32_t));
+    const VectorIndexedColumn *colRecs = (const VectorIndexedColumn *)dataAt(head->columnOffset);
+    for (unsigned int ii=0;ii<head->numColumns;ii++)
+    {
+        size_t valSize = 0;
+        switch (colRecs[ii].type)
+        {
+            case DictTypeString:  valSize = sizeof(uint32_t);  break;
+            case DictTypeInt:  valSize = sizeof(int32_t);  break;
+            case DictTypeIdentity:  valSize = sizeof(uint64_t);  break;
+            case DictTypeDouble:  valSize = sizeof(double);  break;
+            default:
+                return;
+        }
+        if (colRecs[ii].presentOffset + head->numFeatures > mapSize ||
+            colRecs[ii].dataOffset + (uint64_t)head->numFeatures*valSize > mapSize)
+            return;
+    }
+    // The string pool has to end with a terminator so we can't run off the end
+    if (((const char *)mapData)[mapSize-1] != 0)
+        return;
+
+    header = head;
+    features = dataAt(head->featureOffset);
+    rings = dataAt(head->ringOffset);
+    points = (const Point2f *)dataAt(head->pointOffset);
+    meshPoints = (const Point3f *)dataAt(head->meshPointOffset);
+    tris = (const int32_t *)dataAt(head->triOffset);
+    levelBounds = levels;
+    nodes = dataAt(head->nodeOffset);
+    columns = colRecs;
+    strings = (const char *)dataAt(head->stringOffset);
+    stringsLen = mapSize - head->stringOffset;
+    valid = true;
+}
+
+VectorIndexedFile::~VectorIndexedFile()
+{
+    if (mapData)
+        munmap(mapData,mapSize);
+    mapData = NULL;
+}
+
+bool VectorIndexedFile::isValid()
+{
+    return valid;
+}
+
+unsigned int VectorIndexedFile::getNumObjects()
+{
+    return valid ? ((const VectorIndexedHeader *)header)->numFeatures : 0;
+}
+
+Mbr VectorIndexedFile::getBounds() const
+{
+    if (!valid)
+        return Mbr();
+    const float *bounds = ((const VectorIndexedHeader *)header)->bounds;
+    return Mbr(Point2f(bounds[0],bounds[1]),Point2f(bounds[2],bounds[3]));
+}
+
+void VectorIndexedFile::queryMbr(const Mbr &mbr,std::vector<unsigned int> &indices) const
+{
+    const VectorIndexedHeader *head = (const VectorIndexedHeader *)header;
+    if (!valid || head->numNodes == 0 || !mbr.valid())
+        return;
+
+    const float query[4] = {mbr.ll().x(),mbr.ll().y(),mbr.ur().x(),mbr.ur().y()};
+    PackedRTreeQuery((const VectorIndexedNode *)nodes,levelBounds,head->numLevels,head->nodeSize,head->numFeatures,query,indices);
+
+    std::sort(indices.begin(),indices.end());
+}
+
+void VectorIndexedFile::getObjectsInMbr(const Mbr &mbr,const StringSet *filter,ShapeSet &shapes)
+{
+    std::vector<unsigned int> indices;
+    queryMbr(mbr,indices);
+    for (unsigned int which : indices)
+    {
+        VectorShapeRef shape = getObjectByIndex(which,filter);
+        if (shape)
+            shapes.insert(shape);
+    }
+}
+
+bool VectorIndexedFile::checkFeature(unsigned int which) const
+{
+    const VectorIndexedFeature &feat = ((const VectorIndexedFeature *)features)[which];
+    switch (feat.type)
+    {
+        case VectorIndexedPoints:
+        case VectorIndexedLinear:
+            if (feat.numRings != 1)
+                return false;
+            // Fall through
+        case VectorIndexedAreal:
+        {
+            if ((uint64_t)feat.firstRing + feat.numRings > maxRings)
+                return false;
+            const VectorIndexedRing *ringRecs = (const VectorIndexedRing *)rings + feat.firstRing;
+            for (unsigned int ii=0;ii<feat.numRings;ii++)
+                if ((uint64_t)ringRecs[ii].firstPoint + ringRecs[ii].numPoints > maxPoints)
+                    return false;
+            return true;
+        }
+        case VectorIndexedTriangles:
+        {
+            if ((uint64_t)feat.firstRing + feat.numRings > maxMeshPoints ||
+                (uint64_t)feat.firstTri + feat.numTris > maxTris)
+                return false;
+            // Triangles index the feature's own mesh points
+            const int32_t *triIdx = tris + 3*(uint64_t)feat.firstTri;
+            for (uint64_t ii=0;ii<3*(uint64_t)feat.numTris;ii++)
+                if (triIdx[ii] < 0 || (uint32_t)triIdx[ii] >= feat.numRings)
+                    return false;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+VectorShapeView VectorIndexedFile::getShapeView(unsigned int which) const
+{
+    VectorShapeView view;
+    if (valid && which < ((const VectorIndexedHeader *)header)->numFeatures && checkFeature(which))
+    {
+        view.file = this;
+        view.index = which;
+    }
+
+    return view;
+}
+
+unsigned int VectorIndexedFile::getNumColumns() const
+{
+    return valid ? ((const VectorIndexedHeader *)header)->numColumns : 0;
+}
+
+const char *VectorIndexedFile::stringAt(uint32_t offset) const
+{
+    // The file ends in a terminator, so anything in range is a proper string
+    return offset < stringsLen ? strings + offset : "";
+}
+
+const char *VectorIndexedFile::getColumnName(unsigned int col) const
+{
+    return stringAt(((const VectorIndexedColumn *)columns)[col].nameOffset);
+}
+
+int VectorIndexedFile::findColumn(const std::string &name) const
+{
+    const unsigned int numColumns = getNumColumns();
+    for (unsigned int ii=0;ii<numColumns;ii++)
+        if (name == getColumnName(ii))
+            return ii;
+
+    return -1;
+}
+
+DictionaryType VectorIndexedFile::getColumnType(unsigned int col) const
+{
+    return (DictionaryType)((const VectorIndexedColumn *)columns)[col].type;
+}
+
+bool VectorIndexedFile::hasValue(unsigned int col,unsigned int which) const
+{
+    return dataAt(((const VectorIndexedColumn *)columns)[col].presentOffset)[which] != 0;
+}
+
+int VectorIndexedFile::getInt(unsigned int col,unsigned int which) const
+{
+    const VectorIndexedColumn &column = ((const VectorIndexedColumn *)columns)[col];
+    switch (column.type)
+    {
+        case DictTypeInt:
+            return ((const int32_t *)dataAt(column.dataOffset))[which];
+        case DictTypeDouble:
+            return (int)((const double *)dataAt(column.dataOffset))[which];
+        case DictTypeIdentity:
+            return (int)((const uint64_t *)dataAt(column.dataOffset))[which];
+        default:
+            return 0;
+    }
+}
+
+SimpleIdentity VectorIndexedFile::getIdentity(unsigned int col,unsigned int which) const
+{
+    const VectorIndexedColumn &column = ((const VectorIndexedColumn *)columns)[col];
+    if (column.type == DictTypeIdentity)
+        return ((const uint64_t *)dataAt(column.dataOffset))[which];
+
+    return (SimpleIdentity)getInt(col,which);
+}
+
+double VectorIndexedFile::getDouble(unsigned int col,unsigned int which) const
+{
+    const VectorIndexedColumn &column = ((const VectorIndexedColumn *)columns)[col];
+    if (column.type == DictTypeDouble)
+        return ((const double *)dataAt(column.dataOffset))[which];
+
+    return getInt(col,which);
+}
+
+const char *VectorIndexedFile::getString(unsigned int col,unsigned int which) const
+{
+    const VectorIndexedColumn &column = ((const VectorIndexedColumn *)columns)[col];
+    if (column.type != DictTypeString)
+        return "";
+
+    return stringAt(((const uint32_t *)dataAt(column.dataOffset))[which]);
+}
+
+VectorShapeRef VectorIndexedFile::getNextObject(const StringSet *filter)
+{
+    if (!valid || where >= getNumObjects())
+        return VectorShapeRef();
+
+    return getObjectByIndex(where++,filter);
+}
+
+VectorShapeRef VectorIndexedFile::getObjectByIndex(unsigned int vecIndex,const StringSet *filter)
+{
+    VectorShapeView view = getShapeView(vecIndex);
+    if (!view.isValid())
+        return VectorShapeRef();
+
+    VectorShapeRef shape;
+    switch (view.getType())
+    {
+        case VectorIndexedPoints:
+        {
+            VectorPointsRef pts = VectorPoints::createPoints();
+            const Point2f *ringPts = view.getRingPoints(0);
+            pts->pts.assign(ringPts,ringPts+view.getRingSize(0));
+            pts->initGeoMbr();
+            shape = pts;
+        }
+            break;
+        case VectorIndexedLinear:
+        {
+            VectorLinearRef lin = VectorLinear::createLinear();
+            const Point2f *ringPts = view.getRingPoints(0);
+            lin->pts.assign(ringPts,ringPts+view.getRingSize(0));
+            lin->initGeoMbr();
+            shape = lin;
+        }
+            break;
+        case VectorIndexedAreal:
+        {
+            VectorArealRef ar = VectorAreal::createAreal();
+            ar->loops.resize(view.getNumRings());
+            for (unsigned int ii=0;ii<ar->loops.size();ii++)
+            {
+                const Point2f *ringPts = view.getRingPoints(ii);
+                ar->loops[ii].assign(ringPts,ringPts+view.getRingSize(ii));
+            }
+            ar->initGeoMbr();
+            shape = ar;
+        }
+            break;
+        case VectorIndexedTriangles:
+        {
+            VectorTrianglesRef mesh = VectorTriangles::createTriangles();
+            const Point3f *meshPts = view.getMeshPoints();
+            mesh->pts.assign(meshPts,meshPts+view.getNumMeshPoints());
+            const int32_t *triIdx = view.getTriangles();
+            mesh->tris.resize(view.getNumTriangles());
+            for (unsigned int ii=0;ii<mesh->tris.size();ii++)
+                for (unsigned int jj=0;jj<3;jj++)
+                    mesh->tris[ii].pts[jj] = triIdx[3*ii+jj];
+            mesh->initGeoMbr();
+            shape = mesh;
+        }
+            break;
+        default:
+            return VectorShapeRef();
+    }
+
+    // Copy over the attributes we want
+    MutableDictionaryRef dict = MutableDictionaryMake();
+    const unsigned int numColumns = getNumColumns();
+    for (unsigned int col=0;col<numColumns;col++)
+    {
+        if (!hasValue(col,vecIndex))
+            continue;
+        const char *name = getColumnName(col);
+        if (filter && filter->find(name) == filter->end())
+            continue;
+        switch (getColumnType(col))
+        {
+            case DictTypeString:
+                dict->setString(name,getString(col,vecIndex));
+                break;
+            case DictTypeInt:
+                dict->setInt(name,getInt(col,vecIndex));
+                break;
+            case DictTypeIdentity:
+                dict->setIdentifiable(name,getIdentity(col,vecIndex));
+                break;
+            case DictTypeDouble:
+                dict->setDouble(name,getDouble(col,vecIndex));
+                break;
+            default:
+                break;
+        }
+    }
+    shape->setAttrDict(dict);
+
+    return shape;
+}
+
+bool VectorReadFile(const std::string &fileName,ShapeSet &shapes)
+{
+    VectorIndexedFile vecFile(fileName);
+    if (!vecFile.isValid())
+        return false;
+
+    const unsigned int numObjects = vecFile.getNumObjects();
+    for (unsigned int ii=0;ii<numObjects;ii++)
+    {
+        VectorShapeRef shape = vecFile.getObjectByIndex(ii,NULL);
+        if (shape)
+            shapes.insert(shape);
+    }
+
+    return true;
+}
+
+bool VectorWriteFile(const std::string &fileName,ShapeSet &shapes)
+{
+    return VectorWriteIndexedFile(fileName,shapes);
+}
+
+}
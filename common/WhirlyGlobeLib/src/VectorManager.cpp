@@ -37,7 +37,8 @@ VectorInfo::VectorInfo()
 : filled(false), sample(false), texId(EmptyIdentity), texScale(1.0,1.0),
 subdivEps(0.0), gridSubdiv(false), texProj(TextureProjectionNone),
 color(RGBAColor(255,255,255,255)), lineWidth(1.0),
-centered(true), vecCenterSet(false), vecCenter(0.0,0.0)
+centered(true), vecCenterSet(false), vecCenter(0.0,0.0),
+simplifyTolerance(0.0), simplifyLevel(-1), simplifyType(VectorSimplifyDouglasPeucker)
 {
 }
 
@@ -68,6 +69,10 @@ VectorInfo::VectorInfo(const Dictionary &dict)
         vecCenter.x() = dict.getDouble(MaplyVecCenterX);
         vecCenter.x() = dict.getDouble(MaplyVecCenterY);
     }
+    simplifyTolerance = dict.getDouble(MaplyVecSimplifyTolerance,0.0);
+    simplifyLevel = dict.getInt(MaplyVecSimplifyLevel,-1);
+    std::string simplifyTypeStr = dict.getString(MaplyVecSimplifyType);
+    simplifyType = !simplifyTypeStr.compare(MaplyVecSimplifyVisvalingam) ? VectorSimplifyVisvalingam : VectorSimplifyDouglasPeucker;
 }
     
 // Really Android?  Really?
@@ -135,7 +140,7 @@ public:
     void addPoints(VectorRing3d &inPts,bool closed,MutableDictionaryRef attrs)
     {
         VectorRing pts;
-        pts.reserve(pts.size());
+        pts.reserve(inPts.size());
         for (const auto &pt : inPts)
             pts.push_back(Point2f(pt.x(),pt.y()));
         
@@ -166,6 +171,9 @@ public:
         }
         drawMbr.addPoints(pts);
         
+        // Build up the vertices here and hand them over all at once
+        linePts.clear();
+        lineNorms.clear();
         Point3f prevPt,prevNorm,firstPt,firstNorm;
         for (unsigned int jj=0;jj<pts.size();jj++)
         {
@@ -182,22 +190,15 @@ public:
             // Depending on the type, we do this differently
             if (primType == Points)
             {
-                drawable->addPoint(pt);
-                if (doColor)
-                   drawable->addColor(ringColor);
-                drawable->addNormal(norm);
+                linePts.push_back(pt);
+                lineNorms.push_back(norm);
             } else {
                 if (jj > 0)
                 {
-                    drawable->addPoint(prevPt);
-                    drawable->addPoint(pt);
-                    if (doColor)
-                    {
-                        drawable->addColor(ringColor);
-                        drawable->addColor(ringColor);
-                    }
-                    drawable->addNormal(prevNorm);
-                    drawable->addNormal(norm);
+                    linePts.push_back(prevPt);
+                    linePts.push_back(pt);
+                    lineNorms.push_back(prevNorm);
+                    lineNorms.push_back(norm);
                 } else {
                     firstPt = pt;
                     firstNorm = norm;
@@ -210,16 +211,16 @@ public:
         // Close the loop
         if (closed && primType == Lines)
         {
-            drawable->addPoint(prevPt);
-            drawable->addPoint(firstPt);
-            if (doColor)
-            {
-                drawable->addColor(ringColor);
-                drawable->addColor(ringColor);
-            }
-            drawable->addNormal(prevNorm);
-            drawable->addNormal(firstNorm);
+            linePts.push_back(prevPt);
+            linePts.push_back(firstPt);
+            lineNorms.push_back(prevNorm);
+            lineNorms.push_back(firstNorm);
         }
+        
+        drawable->addPoints(linePts.data(),(unsigned int)linePts.size());
+        if (doColor)
+            drawable->addColors(ringColor,(unsigned int)linePts.size());
+        drawable->addNormals(lineNorms.data(),(unsigned int)lineNorms.size());
     }
     
     void flush()
@@ -261,6 +262,8 @@ protected:
     Point2d geoCenter;
     bool centerValid;
     GeometryType primType;
+    // Reused between rings
+    Point3fVector linePts,lineNorms;
 };
 
 /* Drawable Builder (Triangle version)
@@ -331,9 +334,11 @@ public:
         // Grid subdivision is done here
         std::vector<VectorRing> inRings;
         if (vecInfo->subdivEps > 0.0 && vecInfo->gridSubdiv)
+        {
+            GridClipper clipper(Point2f(0.0,0.0), Point2f(vecInfo->subdivEps,vecInfo->subdivEps));
             for (unsigned int ii=0;ii<rings.size();ii++)
-                ClipLoopToGrid(rings[ii], Point2f(0.0,0.0), Point2f(vecInfo->subdivEps,vecInfo->subdivEps), inRings);
-        else
+                clipper.clipLoop(rings[ii], inRings);
+        } else
             inRings = rings;
         VectorTrianglesRef mesh(VectorTriangles::createTriangles());
         TesselateLoops(inRings, mesh);
@@ -354,9 +359,10 @@ public:
             centroid.y() = attrs->getDouble(MaplyVecCenterY);
         }
         
+        VectorRing pts;
         for (unsigned int ir=0;ir<mesh->tris.size();ir++)
         {
-            VectorRing pts;
+            pts.clear();
             mesh->getTriangle(ir, pts);
             // Decide if we'll appending to an existing drawable or
             //  create a new one
@@ -401,10 +407,9 @@ public:
             }
             
             // Generate the textures coordinates
-            std::vector<TexCoord> texCoords;
+            texCoords.clear();
             if (doTexCoords)
             {
-                texCoords.reserve(pts.size());
                 TexCoord minCoord(MAXFLOAT,MAXFLOAT);
                 for (unsigned int jj=0;jj<pts.size();jj++)
                 {
@@ -448,7 +453,9 @@ public:
                 }
             }
             
-            // Add the points
+            // Work out the points, then add them all at once
+            triPts.clear();
+            triNorms.clear();
             for (unsigned int jj=0;jj<pts.size();jj++)
             {
                 // Convert to real world coordinates and offset from the globe
@@ -456,19 +463,16 @@ public:
                 Point2d geoCoordD(geoPt.x()+geoCenter.x(),geoPt.y()+geoCenter.y());
                 Point3d localPt = coordAdapter->getCoordSystem()->geographicToLocal(geoCoordD);
                 Point3d norm3d = coordAdapter->normalForLocal(localPt);
-                Point3f norm(norm3d.x(),norm3d.y(),norm3d.z());
+                triNorms.push_back(Point3f(norm3d.x(),norm3d.y(),norm3d.z()));
                 Point3d pt3d = coordAdapter->localToDisplay(localPt) - center;
-                Point3f pt(pt3d.x(),pt3d.y(),pt3d.z());
-                
-                drawable->addPoint(pt);
-                if (doColor)
-                    drawable->addColor(ringColor);
-                drawable->addNormal(norm);
-                if (doTexCoords)
-                {
-                    drawable->addTexCoord(0, texCoords[jj]);
-                }
+                triPts.push_back(Point3f(pt3d.x(),pt3d.y(),pt3d.z()));
             }
+            drawable->addPoints(triPts.data(),(unsigned int)triPts.size());
+            if (doColor)
+                drawable->addColors(ringColor,(unsigned int)triPts.size());
+            drawable->addNormals(triNorms.data(),(unsigned int)triNorms.size());
+            if (doTexCoords)
+                drawable->addTexCoords(0,texCoords.data(),(unsigned int)texCoords.size());
             
             // Add the triangles
             // Note: Should be reusing vertex indices
@@ -526,6 +530,9 @@ protected:
     bool centerValid;
     BasicDrawableBuilderRef drawable;
     const VectorInfo *vecInfo;
+    // Reused between triangles
+    Point3fVector triPts,triNorms;
+    std::vector<TexCoord> texCoords;
 };
 
 VectorManager::VectorManager()
@@ -545,6 +552,14 @@ SimpleIdentity VectorManager::addVectors(ShapeSet *shapes, const VectorInfo &vec
     if (shapes->empty())
         return EmptyIdentity;
     
+    // Drop the vertices we won't see at this level
+    ShapeSet simpleShapes;
+    if (vecInfo.simplifyTolerance > 0.0 && vecInfo.simplifyLevel >= 0)
+    {
+        VectorSimplifyShapes(*shapes, simpleShapes, VectorSimplifyToleranceForLevel(vecInfo.simplifyTolerance, vecInfo.simplifyLevel), vecInfo.simplifyType);
+        shapes = &simpleShapes;
+    }
+    
     VectorSceneRep *sceneRep = new VectorSceneRep();
     sceneRep->fade = vecInfo.fade;
 
@@ -832,4 +847,20 @@ void VectorManager::enableVectors(SimpleIDSet &vecIDs,bool enable,ChangeSet &cha
     }    
 }
 
+void VectorManager::getDrawIDs(const SimpleIDSet &vecIDs,SimpleIDSet &drawIDs)
+{
+    std::lock_guard<std::mutex> guardLock(vectorLock);
+
+    for (SimpleIdentity vecID : vecIDs)
+    {
+        VectorSceneRep dummyRep(vecID);
+        VectorSceneRepSet::iterator it = vectorReps.find(&dummyRep);
+        if (it != vectorReps.end())
+        {
+            drawIDs.insert((*it)->drawIDs.begin(),(*it)->drawIDs.end());
+            drawIDs.insert((*it)->instIDs.begin(),(*it)->instIDs.end());
+        }
+    }
+}
+
 }
@@ -1153,9 +1153,25 @@ VectorObjectRef VectorObject::tesselate()
     return newVec;
 }
     
+VectorObjectRef VectorObject::simplify(double tolerance,VectorSimplifyType type,const Mbr &keepMbr)
+{
+    VectorObjectRef newVec(new VectorObject());
+    newVec->selectable = selectable;
+
+    VectorSimplifyShapes(shapes, newVec->shapes, tolerance, type, true, keepMbr);
+    
+    return newVec;
+}
+
+VectorObjectRef VectorObject::simplifyForLevel(float pixels,int level,VectorSimplifyType type,const Mbr &keepMbr)
+{
+    return simplify(VectorSimplifyToleranceForLevel(pixels, level), type, keepMbr);
+}
+    
 VectorObjectRef VectorObject::clipToGrid(const Point2d &gridSize)
 {
     VectorObjectRef newVec(new VectorObject());
+    GridClipper clipper(Point2f(0.0,0.0), Point2f(gridSize.x(),gridSize.y()));
 
     for (ShapeSet::iterator it = shapes.begin();it!=shapes.end();it++)
     {
@@ -1163,7 +1179,7 @@ VectorObjectRef VectorObject::clipToGrid(const Point2d &gridSize)
         if (ar)
         {
             std::vector<VectorRing> newLoops;
-            ClipLoopsToGrid(ar->loops, Point2f(0.0,0.0), Point2f(gridSize.x(),gridSize.y()), newLoops);
+            clipper.clipLoops(ar->loops, newLoops);
             for (unsigned int jj=0;jj<newLoops.size();jj++)
             {
                 VectorArealRef newAr = VectorAreal::createAreal();
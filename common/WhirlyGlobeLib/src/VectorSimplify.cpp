@@ -0,0 +1,432 @@
+/*
+ *  VectorSimplify.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <string.h>
+#import <algorithm>
+#import <queue>
+#import <unordered_map>
+#import "VectorSimplify.h"
+
+namespace WhirlyKit
+{
+
+// Don't scale the tolerance down past this latitude
+static const double kMaxSimplifyLat = 85.0 / 180.0 * M_PI;
+
+double VectorSimplifyToleranceForLevel(float pixels,int level,int tileSize)
+{
+    if (pixels <= 0.0 || level < 0 || tileSize <= 0)
+        return 0.0;
+
+    return pixels * 2.0 * M_PI / ((double)tileSize * (double)(1 << std::min(level,30)));
+}
+
+// Squared distance from a point to a segment
+static double DistToSegmentSquared(const Point2f &pt,const Point2f &p0,const Point2f &p1)
+{
+    const double dx = (double)p1.x() - p0.x(), dy = (double)p1.y() - p0.y();
+    double px = (double)pt.x() - p0.x(), py = (double)pt.y() - p0.y();
+    const double len2 = dx*dx + dy*dy;
+    if (len2 > 0.0)
+    {
+        const double t = std::max(0.0,std::min(1.0,(px*dx + py*dy) / len2));
+        px -= t*dx;  py -= t*dy;
+    }
+
+    return px*px + py*py;
+}
+
+// Twice the area of the triangle
+static double TriangleArea2(const Point2f &p0,const Point2f &p1,const Point2f &p2)
+{
+    return std::abs(((double)p1.x() - p0.x()) * ((double)p2.y() - p0.y()) -
+                    ((double)p2.x() - p0.x()) * ((double)p1.y() - p0.y()));
+}
+
+static void SimplifyDouglasPeucker(const VectorRing &inPts,VectorRing &outPts,double tolerance)
+{
+    const int num = inPts.size();
+    std::vector<bool> keep(num,false);
+    keep[0] = keep[num-1] = true;
+
+    const double tol2 = tolerance * tolerance;
+    std::vector<std::pair<int,int> > stack;
+    stack.push_back(std::make_pair(0,num-1));
+    while (!stack.empty())
+    {
+        const std::pair<int,int> span = stack.back();
+        stack.pop_back();
+
+        double maxDist = -1.0;
+        int which = -1;
+        for (int ii=span.first+1;ii<span.second;ii++)
+        {
+            const double dist = DistToSegmentSquared(inPts[ii],inPts[span.first],inPts[span.second]);
+            if (dist > maxDist)
+            {
+                maxDist = dist;
+                which = ii;
+            }
+        }
+
+        if (which >= 0 && maxDist > tol2)
+        {
+            keep[which] = true;
+            stack.push_back(std::make_pair(span.first,which));
+            stack.push_back(std::make_pair(which,span.second));
+        }
+    }
+
+    outPts.clear();
+    for (int ii=0;ii<num;ii++)
+        if (keep[ii])
+            outPts.push_back(inPts[ii]);
+}
+
+static void SimplifyVisvalingam(const VectorRing &inPts,VectorRing &outPts,double tolerance)
+{
+    const int num = inPts.size();
+    const double maxArea2 = tolerance * tolerance;
+
+    std::vector<int> prev(num),next(num);
+    std::vector<double> area(num,0.0);
+    std::vector<int> version(num,0);
+    for (int ii=0;ii<num;ii++)
+    {
+        prev[ii] = ii-1;
+        next[ii] = ii+1;
+    }
+
+    // Smallest area on top
+    typedef std::pair<double,std::pair<int,int> > Entry;
+    std::priority_queue<Entry,std::vector<Entry>,std::greater<Entry> > heap;
+    for (int ii=1;ii<num-1;ii++)
+    {
+        area[ii] = TriangleArea2(inPts[ii-1],inPts[ii],inPts[ii+1]);
+        heap.push(Entry(area[ii],std::make_pair(ii,0)));
+    }
+
+    std::vector<bool> removed(num,false);
+    while (!heap.empty())
+    {
+        const Entry entry = heap.top();
+        heap.pop();
+        const int which = entry.second.first;
+        if (removed[which] || entry.second.second != version[which])
+            continue;
+        if (entry.first >= maxArea2)
+            break;
+
+        // Take the point out and update its neighbors
+        removed[which] = true;
+        const int p = prev[which], n = next[which];
+        next[p] = n;
+        prev[n] = p;
+        const int neighbors[2] = {p,n};
+        for (int ni : neighbors)
+        {
+            if (ni <= 0 || ni >= num-1)
+                continue;
+            // Areas never go down, so a removed point doesn't make its neighbors easier to remove
+            area[ni] = std::max(entry.first,TriangleArea2(inPts[prev[ni]],inPts[ni],inPts[next[ni]]));
+            version[ni]++;
+            heap.push(Entry(area[ni],std::make_pair(ni,version[ni])));
+        }
+    }
+
+    outPts.clear();
+    for (int ii=0;ii<num;ii++)
+        if (!removed[ii])
+            outPts.push_back(inPts[ii]);
+}
+
+void VectorSimplifyPoints(const VectorRing &inPts,VectorRing &outPts,double tolerance,VectorSimplifyType type)
+{
+    if (inPts.size() < 3 || tolerance <= 0.0)
+    {
+        outPts = inPts;
+        return;
+    }
+
+    switch (type)
+    {
+        case VectorSimplifyDouglasPeucker:
+            SimplifyDouglasPeucker(inPts,outPts,tolerance);
+            break;
+        case VectorSimplifyVisvalingam:
+            SimplifyVisvalingam(inPts,outPts,tolerance);
+            break;
+    }
+}
+
+// Exact key for a point, used to find where features come together
+static inline uint64_t SimplifyPointKey(const Point2f &pt)
+{
+    uint32_t x,y;
+    memcpy(&x,&pt.x(),sizeof(x));
+    memcpy(&y,&pt.y(),sizeof(y));
+    return ((uint64_t)x << 32) | y;
+}
+
+static inline bool SimplifyPointLess(const Point2f &a,const Point2f &b)
+{
+    if (a.x() == b.x())
+        return a.y() < b.y();
+    return a.x() < b.x();
+}
+
+// Tracks the distinct neighbors of a point across all the rings
+// More than two and it's where boundaries join or split
+class SimplifyNode
+{
+public:
+    SimplifyNode() : numNeighbors(0), junction(false) { }
+
+    void addNeighbor(uint64_t key)
+    {
+        if (junction)
+            return;
+        for (int ii=0;ii<numNeighbors;ii++)
+            if (neighbors[ii] == key)
+                return;
+        if (numNeighbors < 2)
+            neighbors[numNeighbors++] = key;
+        else
+            junction = true;
+    }
+
+    uint64_t neighbors[2];
+    int numNeighbors;
+    bool junction;
+};
+
+// A ring we're working on
+class SimplifyRing
+{
+public:
+    SimplifyRing(VectorRing *pts,bool closed) : pts(pts), closed(closed), explicitClose(false) { }
+
+    VectorRing *pts;
+    bool closed;
+    // First point repeated at the end
+    bool explicitClose;
+};
+
+// Simplify a single run between junctions.
+// Runs are always done in the same direction so that a boundary shared by
+//  two features comes out the same in both.
+static void SimplifyChain(const Point2f *pts,int num,double tolerance,VectorSimplifyType type,bool geographic,VectorRing &outPts)
+{
+    bool reverse = SimplifyPointLess(pts[num-1],pts[0]);
+    if (!reverse && num > 2 && pts[num-1] == pts[0])
+        reverse = SimplifyPointLess(pts[num-2],pts[1]);
+
+    VectorRing chain(pts,pts+num);
+    if (reverse)
+        std::reverse(chain.begin(),chain.end());
+
+    // Mercator stretches things toward the poles, so we need to be more careful there
+    if (geographic)
+    {
+        double maxLat = 0.0;
+        for (const Point2f &pt : chain)
+            maxLat = std::max(maxLat,(double)std::abs(pt.y()));
+        tolerance *= cos(std::min(maxLat,kMaxSimplifyLat));
+    }
+
+    VectorSimplifyPoints(chain,outPts,tolerance,type);
+    if (reverse)
+        std::reverse(outPts.begin(),outPts.end());
+}
+
+static void SimplifyRingPoints(SimplifyRing &ring,const std::unordered_map<uint64_t,SimplifyNode> &nodes,
+                               double tolerance,VectorSimplifyType type,bool geographic)
+{
+    VectorRing &pts = *ring.pts;
+    const int num = pts.size();
+    if ((ring.closed && num < 4) || (!ring.closed && num < 3))
+        return;
+
+    // Where the runs start and end
+    std::vector<int> junctions;
+    for (int ii=0;ii<num;ii++)
+    {
+        if (!ring.closed && (ii == 0 || ii == num-1))
+            junctions.push_back(ii);
+        else {
+            auto it = nodes.find(SimplifyPointKey(pts[ii]));
+            if (it != nodes.end() && it->second.junction)
+                junctions.push_back(ii);
+        }
+    }
+
+    VectorRing outPts,chainPts;
+    outPts.reserve(num);
+    if (ring.closed)
+    {
+        // A loop touching nothing else starts and ends at its lowest point
+        if (junctions.empty())
+        {
+            int which = 0;
+            for (int ii=1;ii<num;ii++)
+                if (SimplifyPointLess(pts[ii],pts[which]))
+                    which = ii;
+            junctions.push_back(which);
+        }
+
+        // Each run wraps around to the next junction
+        VectorRing chain;
+        for (unsigned int ji=0;ji<junctions.size();ji++)
+        {
+            const int start = junctions[ji];
+            const int end = (ji+1 < junctions.size()) ? junctions[ji+1] : junctions[0] + num;
+            chain.clear();
+            for (int ii=start;ii<=end;ii++)
+                chain.push_back(pts[ii % num]);
+            SimplifyChain(&chain[0],chain.size(),tolerance,type,geographic,chainPts);
+            outPts.insert(outPts.end(),chainPts.begin(),chainPts.end()-1);
+        }
+    } else {
+        outPts.push_back(pts[0]);
+        for (unsigned int ji=0;ji<junctions.size()-1;ji++)
+        {
+            const int start = junctions[ji];
+            const int end = junctions[ji+1];
+            SimplifyChain(&pts[start],end-start+1,tolerance,type,geographic,chainPts);
+            outPts.insert(outPts.end(),chainPts.begin()+1,chainPts.end());
+        }
+    }
+
+    pts = outPts;
+}
+
+void VectorSimplifyShapes(const ShapeSet &inShapes,ShapeSet &outShapes,double tolerance,VectorSimplifyType type,
+                          bool geographic,const Mbr &keepMbr)
+{
+    if (tolerance <= 0.0)
+    {
+        outShapes.insert(inShapes.begin(),inShapes.end());
+        return;
+    }
+
+    // Copy the shapes we'll be changing
+    std::vector<VectorLinearRef> lins;
+    std::vector<VectorArealRef> ars;
+    std::vector<SimplifyRing> rings;
+    for (auto shape : inShapes)
+    {
+        if (VectorLinearRef lin = std::dynamic_pointer_cast<VectorLinear>(shape))
+        {
+            VectorLinearRef newLin = VectorLinear::createLinear();
+            newLin->setAttrDict(lin->getAttrDict());
+            newLin->pts = lin->pts;
+            lins.push_back(newLin);
+        } else if (VectorArealRef ar = std::dynamic_pointer_cast<VectorAreal>(shape))
+        {
+            VectorArealRef newAr = VectorAreal::createAreal();
+            newAr->setAttrDict(ar->getAttrDict());
+            newAr->loops = ar->loops;
+            ars.push_back(newAr);
+        } else
+            outShapes.insert(shape);
+    }
+    for (auto lin : lins)
+        rings.push_back(SimplifyRing(&lin->pts,false));
+    for (auto ar : ars)
+        for (auto &loop : ar->loops)
+            rings.push_back(SimplifyRing(&loop,true));
+
+    // Work out where the boundaries come together and split apart
+    std::unordered_map<uint64_t,SimplifyNode> nodes;
+    const bool useMbr = keepMbr.valid();
+    // Points on the edge went through a float conversion, so allow a little slop
+    const float mbrEps = useMbr ? std::max(1e-4 * std::max(keepMbr.ur().x() - keepMbr.ll().x(),keepMbr.ur().y() - keepMbr.ll().y()),1e-6) : 0.0;
+    for (auto &ring : rings)
+    {
+        VectorRing &pts = *ring.pts;
+        if (ring.closed && pts.size() > 1 && pts.front() == pts.back())
+        {
+            ring.explicitClose = true;
+            pts.pop_back();
+        }
+        const int num = pts.size();
+        for (int ii=0;ii<num;ii++)
+        {
+            SimplifyNode &node = nodes[SimplifyPointKey(pts[ii])];
+            if (ring.closed)
+            {
+                node.addNeighbor(SimplifyPointKey(pts[(ii+num-1)%num]));
+                node.addNeighbor(SimplifyPointKey(pts[(ii+1)%num]));
+            } else {
+                if (ii == 0 || ii == num-1)
+                    node.junction = true;
+                if (ii > 0)
+                    node.addNeighbor(SimplifyPointKey(pts[ii-1]));
+                if (ii < num-1)
+                    node.addNeighbor(SimplifyPointKey(pts[ii+1]));
+            }
+
+            // Keep anything on the edge of the tile
+            if (useMbr)
+            {
+                const Point2f &pt = pts[ii];
+                if (std::abs(pt.x() - keepMbr.ll().x()) <= mbrEps || std::abs(pt.x() - keepMbr.ur().x()) <= mbrEps ||
+                    std::abs(pt.y() - keepMbr.ll().y()) <= mbrEps || std::abs(pt.y() - keepMbr.ur().y()) <= mbrEps)
+                    node.junction = true;
+            }
+        }
+    }
+
+    for (auto &ring : rings)
+    {
+        SimplifyRingPoints(ring,nodes,tolerance,type,geographic);
+        if (ring.explicitClose && !ring.pts->empty())
+            ring.pts->push_back(ring.pts->front());
+    }
+
+    // Toss anything that collapsed
+    for (auto lin : lins)
+        if (lin->pts.size() > 1)
+        {
+            lin->initGeoMbr();
+            outShapes.insert(lin);
+        }
+    for (auto ar : ars)
+    {
+        std::vector<VectorRing> loops;
+        for (unsigned int ii=0;ii<ar->loops.size();ii++)
+        {
+            const VectorRing &loop = ar->loops[ii];
+            const int minPts = (loop.size() > 1 && loop.front() == loop.back()) ? 4 : 3;
+            if ((int)loop.size() >= minPts)
+                loops.push_back(loop);
+            else if (ii == 0)
+                break;
+        }
+        if (!loops.empty())
+        {
+            ar->loops = loops;
+            ar->initGeoMbr();
+            outShapes.insert(ar);
+        }
+    }
+}
+
+}
@@ -120,8 +120,8 @@ void VertexAttribute::addVector4f(const Eigen::Vector4f &vec)
         return;
     
     if (!data)
-        data = new std::vector<Vector4f>();
-    std::vector<Vector4f> *vecs = (std::vector<Vector4f> *)data;
+        data = new Vector4fVector();
+    Vector4fVector *vecs = (Vector4fVector *)data;
     (*vecs).push_back(vec);
 }
 
@@ -155,8 +155,8 @@ void VertexAttribute::reserve(int size)
         case BDFloat4Type:
         {
             if (!data)
-                data = new std::vector<Vector4f>();
-            std::vector<Vector4f> *vecs = (std::vector<Vector4f> *)data;
+                data = new Vector4fVector();
+            Vector4fVector *vecs = (Vector4fVector *)data;
             vecs->reserve(size);
         }
             break;
@@ -205,6 +205,64 @@ void VertexAttribute::reserve(int size)
     }
 }
 
+/// Resize the data array
+void VertexAttribute::resize(int size)
+{
+    switch (dataType)
+    {
+        case BDFloat4Type:
+        {
+            if (!data)
+                data = new Vector4fVector();
+            Vector4fVector *vecs = (Vector4fVector *)data;
+            vecs->resize(size);
+        }
+            break;
+        case BDFloat3Type:
+        {
+            if (!data)
+                data = new std::vector<Vector3f>();
+            std::vector<Vector3f> *vecs = (std::vector<Vector3f> *)data;
+            vecs->resize(size);
+        }
+            break;
+        case BDFloat2Type:
+        {
+            if (!data)
+                data = new std::vector<Vector2f>();
+            std::vector<Vector2f> *vecs = (std::vector<Vector2f> *)data;
+            vecs->resize(size);
+        }
+            break;
+        case BDChar4Type:
+        {
+            if (!data)
+                data = new std::vector<RGBAColor>();
+            std::vector<RGBAColor> *colors = (std::vector<RGBAColor> *)data;
+            colors->resize(size);
+        }
+            break;
+        case BDFloatType:
+        {
+            if (!data)
+                data = new std::vector<float>();
+            std::vector<float> *floats = (std::vector<float> *)data;
+            floats->resize(size);
+        }
+            break;
+        case BDIntType:
+        {
+            if (!data)
+                data = new std::vector<int>();
+            std::vector<int> *ints = (std::vector<int> *)data;
+            ints->resize(size);
+        }
+            break;
+        case BDDataTypeMax:
+            break;
+    }
+}
+
 /// Number of elements in our array
 int VertexAttribute::numElements() const
 {
@@ -215,7 +273,7 @@ int VertexAttribute::numElements() const
     {
         case BDFloat4Type:
         {
-            std::vector<Vector4f> *vecs = (std::vector<Vector4f> *)data;
+            Vector4fVector *vecs = (Vector4fVector *)data;
             return (int)vecs->size();
         }
             break;
@@ -377,7 +435,7 @@ void VertexAttribute::clear()
         {
             case BDFloat4Type:
             {
-                std::vector<Vector4f> *vecs = (std::vector<Vector4f> *)data;
+                Vector4fVector *vecs = (Vector4fVector *)data;
                 delete vecs;
             }
                 break;
@@ -425,7 +483,7 @@ void *VertexAttribute::addressForElement(int which)
     {
         case BDFloat4Type:
         {
-            std::vector<Vector4f> *vecs = (std::vector<Vector4f> *)data;
+            Vector4fVector *vecs = (Vector4fVector *)data;
             return &(*vecs)[which];;
         }
             break;
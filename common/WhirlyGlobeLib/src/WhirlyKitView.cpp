@@ -40,12 +40,13 @@ View::View()
     centerOffset = Point2d(0.0,0.0);
     lastChangedTime = TimeGetCurrent();
     continuousZoom = false;
+    viewStateVersion = 0;
 }
     
 View::View(const View &that)
     : fieldOfView(that.fieldOfView), nearPlane(that.nearPlane), imagePlaneSize(that.imagePlaneSize),
     farPlane(that.farPlane), lastChangedTime(that.lastChangedTime), continuousZoom(that.continuousZoom),
-    coordAdapter(that.coordAdapter)
+    coordAdapter(that.coordAdapter), viewStateVersion(0)
 {
 }
     
@@ -129,7 +130,7 @@ Eigen::Matrix4d View::calcProjectionMatrix(Point2f frameBufferSize,float margin)
     return projMat;
 }
 
-void View::getOffsetMatrices(std::vector<Eigen::Matrix4d> &offsetMatrices,const WhirlyKit::Point2f &frameBufferSize,float bufferX)
+void View::getOffsetMatrices(Matrix4dVector &offsetMatrices,const WhirlyKit::Point2f &frameBufferSize,float bufferX)
 {
     Eigen::Matrix4d ident;
     offsetMatrices.push_back(ident.Identity());
@@ -272,12 +273,58 @@ void View::runViewUpdates()
         (*it)->viewUpdated(this);
 }
 
+bool View::ViewStateInputs::operator == (const ViewStateInputs &that) const
+{
+    if (renderer != that.renderer || frameSize != that.frameSize ||
+        fieldOfView != that.fieldOfView || imagePlaneSize != that.imagePlaneSize ||
+        nearPlane != that.nearPlane || farPlane != that.farPlane ||
+        offsetMatrices.size() != that.offsetMatrices.size())
+        return false;
+    if (modelMatrix != that.modelMatrix || viewMatrix != that.viewMatrix)
+        return false;
+    for (unsigned int ii=0;ii<offsetMatrices.size();ii++)
+        if (offsetMatrices[ii] != that.offsetMatrices[ii])
+            return false;
+    
+    return true;
+}
+
+ViewStateRef View::getViewState(SceneRenderer *renderer)
+{
+    // Everything the view state is built from.  Cheap next to all the inverses.
+    ViewStateInputs inputs;
+    inputs.renderer = renderer;
+    inputs.frameSize = renderer->getFramebufferSize();
+    inputs.modelMatrix = calcModelMatrix();
+    inputs.viewMatrix = calcViewMatrix();
+    getOffsetMatrices(inputs.offsetMatrices, inputs.frameSize, 0.0);
+    inputs.fieldOfView = fieldOfView;
+    inputs.imagePlaneSize = imagePlaneSize;
+    inputs.nearPlane = nearPlane;
+    inputs.farPlane = farPlane;
+    
+    std::lock_guard<std::mutex> guardLock(viewStateLock);
+    if (viewState && inputs == viewStateInputs)
+        return viewState;
+    
+    ViewStateRef newViewState = makeViewState(renderer);
+    // Filled in now so no one has to fill it in lazily on a shared copy
+    newViewState->calcFrustumWidth(inputs.frameSize.x(), inputs.frameSize.y());
+    newViewState->version = ++viewStateVersion;
+    viewState = newViewState;
+    viewStateInputs = inputs;
+    
+    return viewState;
+}
+
 ViewState::ViewState(WhirlyKit::View *view,SceneRenderer *renderer)
+: version(0)
 {
+    // The view matrices are rigid (plus a scale at most), so we can skip the general inverses
     modelMatrix = view->calcModelMatrix();
-    invModelMatrix = modelMatrix.inverse();
+    invModelMatrix = AffineInverse(modelMatrix);
     
-    std::vector<Eigen::Matrix4d> offMatrices;
+    Matrix4dVector offMatrices;
     Point2f frameSize = renderer->getFramebufferSize();
     view->getOffsetMatrices(offMatrices, frameSize, 0.0);
     viewMatrices.resize(offMatrices.size());
@@ -287,15 +334,15 @@ ViewState::ViewState(WhirlyKit::View *view,SceneRenderer *renderer)
     fullNormalMatrices.resize(offMatrices.size());
     
     projMatrix = view->calcProjectionMatrix(renderer->getFramebufferSize(),0.0);
-    invProjMatrix = projMatrix.inverse();
+    invProjMatrix = PerspectiveInverse(projMatrix);
     Eigen::Matrix4d baseViewMatrix = view->calcViewMatrix();
     for (unsigned int ii=0;ii<offMatrices.size();ii++)
     {
         viewMatrices[ii] = baseViewMatrix * offMatrices[ii];
-        invViewMatrices[ii] = viewMatrices[ii].inverse();
+        invViewMatrices[ii] = AffineInverse(viewMatrices[ii]);
         fullMatrices[ii] = viewMatrices[ii] * modelMatrix;
-        invFullMatrices[ii] = fullMatrices[ii].inverse();
-        fullNormalMatrices[ii] = fullMatrices[ii].inverse().transpose();
+        invFullMatrices[ii] = AffineInverse(fullMatrices[ii]);
+        fullNormalMatrices[ii] = invFullMatrices[ii].transpose();
     }
     
     fieldOfView = view->fieldOfView;
@@ -387,6 +434,10 @@ Point2f ViewState::pointOnScreenFromDisplay(const Point3d &worldLoc,const Eigen:
 
 bool ViewState::isSameAs(WhirlyKit::ViewState *other)
 {
+    // Shared copies from the same view
+    if (this == other)
+        return true;
+    
     if (fieldOfView != other->fieldOfView || imagePlaneSize != other->imagePlaneSize ||
         nearPlane != other->nearPlane || farPlane != other->farPlane)
         return false;
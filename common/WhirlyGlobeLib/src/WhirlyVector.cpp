@@ -488,6 +488,41 @@ Eigen::Matrix4f Matrix4dToMatrix4f(const Eigen::Matrix4d &inMat)
     return outMat;
 }
 
+Eigen::Matrix4d AffineInverse(const Eigen::Matrix4d &inMat)
+{
+    if (inMat(3,0) != 0.0 || inMat(3,1) != 0.0 || inMat(3,2) != 0.0 || inMat(3,3) != 1.0)
+        return inMat.inverse();
+
+    const Matrix3d invRot = inMat.topLeftCorner<3,3>().inverse();
+    Matrix4d outMat;
+    outMat.topLeftCorner<3,3>() = invRot;
+    outMat.topRightCorner<3,1>() = -invRot * inMat.topRightCorner<3,1>();
+    outMat.row(3) << 0.0, 0.0, 0.0, 1.0;
+    
+    return outMat;
+}
+
+Eigen::Matrix4d PerspectiveInverse(const Eigen::Matrix4d &inMat)
+{
+    // Only the scale, center and depth terms can be set
+    if (inMat(0,1) != 0.0 || inMat(0,3) != 0.0 || inMat(1,0) != 0.0 || inMat(1,3) != 0.0 ||
+        inMat(2,0) != 0.0 || inMat(2,1) != 0.0 || inMat(3,0) != 0.0 || inMat(3,1) != 0.0 ||
+        inMat(3,2) != -1.0 || inMat(3,3) != 0.0 ||
+        inMat(0,0) == 0.0 || inMat(1,1) == 0.0 || inMat(2,3) == 0.0)
+        return inMat.inverse();
+
+    Matrix4d outMat = Matrix4d::Zero();
+    outMat(0,0) = 1.0 / inMat(0,0);
+    outMat(0,3) = inMat(0,2) / inMat(0,0);
+    outMat(1,1) = 1.0 / inMat(1,1);
+    outMat(1,3) = inMat(1,2) / inMat(1,1);
+    outMat(2,3) = -1.0;
+    outMat(3,2) = 1.0 / inMat(2,3);
+    outMat(3,3) = inMat(2,2) / inMat(2,3);
+    
+    return outMat;
+}
+
 /// Floats to doubles
 Eigen::Vector2d Vector2fToVector2d(const Eigen::Vector2f &inVec)
 {
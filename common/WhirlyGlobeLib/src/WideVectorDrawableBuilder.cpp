@@ -55,6 +55,10 @@ void WideVectorDrawableBuilder::Init(unsigned int numVert,unsigned int numTri,bo
     tex_index = addAttribute(BDFloat4Type, StringIndexer::getStringID("a_texinfo"),numVert);
     n0_index = addAttribute(BDFloat3Type, StringIndexer::getStringID("a_n0"),numVert);
     c0_index = addAttribute(BDFloatType, StringIndexer::getStringID("a_c0"),numVert);
+    p1_attr = getAttributeHandle<Eigen::Vector3f>(p1_index);
+    tex_attr = getAttributeHandle<Eigen::Vector4f>(tex_index);
+    n0_attr = getAttributeHandle<Eigen::Vector3f>(n0_index);
+    c0_attr = getAttributeHandle<float>(c0_index);
 }
     
 void WideVectorDrawableBuilder::setColor(RGBAColor inColor)
@@ -84,6 +88,14 @@ unsigned int WideVectorDrawableBuilder::addPoint(const Point3f &pt)
 #endif
     return BasicDrawableBuilder::addPoint(pt);
 }
+
+unsigned int WideVectorDrawableBuilder::addPoints(const Point3f *pts,unsigned int numPts)
+{
+#ifdef WIDEVECDEBUG
+    locPts.insert(locPts.end(),pts,pts+numPts);
+#endif
+    return BasicDrawableBuilder::addPoints(pts,numPts);
+}
     
 void WideVectorDrawableBuilder::addNormal(const Point3f &norm)
 {
@@ -101,9 +113,15 @@ void WideVectorDrawableBuilder::addNormal(const Point3d &norm)
     }
 }
 
+void WideVectorDrawableBuilder::addNormals(const Point3f &norm,unsigned int numNorms)
+{
+    if (globeMode)
+        BasicDrawableBuilder::addNormals(norm,numNorms);
+}
+
 void WideVectorDrawableBuilder::add_p1(const Point3f &pt)
 {
-    addAttributeValue(p1_index, pt);
+    p1_attr.add(pt);
 #ifdef WIDEVECDEBUG
     p1.push_back(pt);
 #endif
@@ -111,14 +129,14 @@ void WideVectorDrawableBuilder::add_p1(const Point3f &pt)
 
 void WideVectorDrawableBuilder::add_texInfo(float texX,float texYmin,float texYmax,float texOffset)
 {
-    addAttributeValue(tex_index, Vector4f(texX,texYmin,texYmax,texOffset));
+    tex_attr.add(Vector4f(texX,texYmin,texYmax,texOffset));
 #ifdef WIDEVECDEBUG
 #endif
 }
 
 void WideVectorDrawableBuilder::add_n0(const Point3f &dir)
 {
-    addAttributeValue(n0_index, dir);
+    n0_attr.add(dir);
 #ifdef WIDEVECDEBUG
     n0.push_back(dir);
 #endif
@@ -126,7 +144,7 @@ void WideVectorDrawableBuilder::add_n0(const Point3f &dir)
 
 void WideVectorDrawableBuilder::add_c0(float val)
 {
-    addAttributeValue(c0_index, val);
+    c0_attr.add(val);
 #ifdef WIDEVECDEBUG
     c0.push_back(val);
 #endif
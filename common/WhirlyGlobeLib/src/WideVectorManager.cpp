@@ -33,7 +33,8 @@ WideVectorInfo::WideVectorInfo()
 : color(255,255,255,255), width(2.0),
 repeatSize(32.0), edgeSize(1.0), subdivEps(0.0),
 coordType(WideVecCoordScreen), joinType(WideVecMiterJoin), capType(WideVecButtCap),
-texID(EmptyIdentity), miterLimit(2.0)
+texID(EmptyIdentity), miterLimit(2.0),
+simplifyTolerance(0.0), simplifyLevel(-1), simplifyType(VectorSimplifyDouglasPeucker)
 {    
 }
     
@@ -60,6 +61,10 @@ WideVectorInfo::WideVectorInfo(const Dictionary &dict)
     repeatSize = dict.getDouble(MaplyWideVecTexRepeatLen,32);
     edgeSize = dict.getDouble(MaplyWideVecEdgeFalloff,1.0);
     miterLimit = dict.getDouble(MaplyWideVecMiterLimit,2.0);
+    simplifyTolerance = dict.getDouble(MaplyVecSimplifyTolerance,0.0);
+    simplifyLevel = dict.getInt(MaplyVecSimplifyLevel,-1);
+    std::string simplifyTypeStr = dict.getString(MaplyVecSimplifyType);
+    simplifyType = !simplifyTypeStr.compare(MaplyVecSimplifyVisvalingam) ? VectorSimplifyVisvalingam : VectorSimplifyDouglasPeucker;
 }
 
 // Turn this on for smaller texture lengths
@@ -165,38 +170,39 @@ public:
     // Add a rectangle to the wide drawable
     void addWideRect(WideVectorDrawableBuilderRef drawable,InterPoint *verts,const Point3d &up)
     {
-        int startPt = drawable->getNumPoints();
-
+        Point3f pts[4];
         for (unsigned int vi=0;vi<4;vi++)
         {
             InterPoint &vert = verts[vi];
-            drawable->addPoint(Vector3dToVector3f(vert.org));
-            drawable->addNormal(up);
+            pts[vi] = Vector3dToVector3f(vert.org);
             drawable->add_p1(Vector3dToVector3f(vert.dest));
             drawable->add_n0(Vector3dToVector3f(vert.n));
             drawable->add_c0(vert.c);
             drawable->add_texInfo(vert.texX,vert.texYmin,vert.texYmax,vert.texOffset);
         }
+        int startPt = drawable->addPoints(pts,4);
+        drawable->addNormals(Vector3dToVector3f(up),4);
 
-        drawable->addTriangle(BasicDrawable::Triangle(startPt+0,startPt+1,startPt+3));
-        drawable->addTriangle(BasicDrawable::Triangle(startPt+1,startPt+2,startPt+3));
+        BasicDrawable::Triangle tris[2] = {BasicDrawable::Triangle(startPt+0,startPt+1,startPt+3),
+                                           BasicDrawable::Triangle(startPt+1,startPt+2,startPt+3)};
+        drawable->addTriangles(tris,2);
     }
     
     // Add a triangle to the wide drawable
     void addWideTri(WideVectorDrawableBuilderRef drawable,InterPoint *verts,const Point3d &up)
     {
-        int startPt = drawable->getNumPoints();
-
+        Point3f pts[3];
         for (unsigned int vi=0;vi<3;vi++)
         {
             InterPoint &vert = verts[vi];
-            drawable->addPoint(Vector3dToVector3f(vert.org));
-            drawable->addNormal(up);
+            pts[vi] = Vector3dToVector3f(vert.org);
             drawable->add_p1(Vector3dToVector3f(vert.dest));
             drawable->add_n0(Vector3dToVector3f(vert.n));
             drawable->add_c0(vert.c);
             drawable->add_texInfo(vert.texX,vert.texYmin,vert.texYmax,vert.texOffset);
         }
+        int startPt = drawable->addPoints(pts,3);
+        drawable->addNormals(Vector3dToVector3f(up),3);
         
         drawable->addTriangle(BasicDrawable::Triangle(startPt+0,startPt+1,startPt+2));
     }
@@ -749,6 +755,14 @@ SimpleIdentity WideVectorManager::addVectors(ShapeSet *shapes,const WideVectorIn
 {
     WideVectorDrawableConstructor builder(renderer,scene,&vecInfo);
     
+    // Drop the vertices we won't see at this level
+    ShapeSet simpleShapes;
+    if (vecInfo.simplifyTolerance > 0.0 && vecInfo.simplifyLevel >= 0)
+    {
+        VectorSimplifyShapes(*shapes, simpleShapes, VectorSimplifyToleranceForLevel(vecInfo.simplifyTolerance, vecInfo.simplifyLevel), vecInfo.simplifyType);
+        shapes = &simpleShapes;
+    }
+    
     // Calculate a center for this geometry
     GeoMbr geoMbr;
     for (ShapeSet::iterator it = shapes->begin(); it != shapes->end(); ++it)
@@ -826,6 +840,22 @@ void WideVectorManager::enableVectors(SimpleIDSet &vecIDs,bool enable,ChangeSet
         }
     }
 }
+
+void WideVectorManager::getDrawIDs(const SimpleIDSet &vecIDs,SimpleIDSet &drawIDs)
+{
+    std::lock_guard<std::mutex> guardLock(vecLock);
+
+    for (SimpleIdentity vecID : vecIDs)
+    {
+        WideVectorSceneRep dummyRep(vecID);
+        WideVectorSceneRepSet::iterator it = sceneReps.find(&dummyRep);
+        if (it != sceneReps.end())
+        {
+            drawIDs.insert((*it)->drawIDs.begin(),(*it)->drawIDs.end());
+            drawIDs.insert((*it)->instIDs.begin(),(*it)->instIDs.end());
+        }
+    }
+}
     
 SimpleIdentity WideVectorManager::instanceVectors(SimpleIdentity vecID,const WideVectorInfo &vecInfo,ChangeSet &changes)
 {
@@ -0,0 +1,112 @@
+/*
+ *  WorkerPool.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import "WorkerPool.h"
+
+namespace WhirlyKit
+{
+
+WorkerPool::WorkerPool(int numThreads)
+    : job(NULL), numTasks(0), nextTask(0), tasksDone(0), generation(0), shutdown(false)
+{
+    for (int ii=1;ii<numThreads;ii++)
+        workers.push_back(std::thread(&WorkerPool::workerMain,this));
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> guardLock(lock);
+        shutdown = true;
+    }
+    workCond.notify_all();
+    for (auto &worker : workers)
+        worker.join();
+}
+
+void WorkerPool::run(int inNumTasks,const std::function<void(int)> &func)
+{
+    if (inNumTasks <= 0)
+        return;
+    // Not worth waking anyone up
+    if (workers.empty() || inNumTasks == 1)
+    {
+        for (int ii=0;ii<inNumTasks;ii++)
+            func(ii);
+        return;
+    }
+
+    std::lock_guard<std::mutex> runGuard(runLock);
+    {
+        std::lock_guard<std::mutex> guardLock(lock);
+        job = &func;
+        numTasks = inNumTasks;
+        nextTask = 0;
+        tasksDone = 0;
+        generation++;
+    }
+    workCond.notify_all();
+
+    runTasks();
+
+    std::unique_lock<std::mutex> guardLock(lock);
+    doneCond.wait(guardLock,[this]{ return tasksDone == numTasks; });
+    job = NULL;
+}
+
+void WorkerPool::runTasks()
+{
+    while (true)
+    {
+        const std::function<void(int)> *thisJob = NULL;
+        int task = 0;
+        {
+            std::lock_guard<std::mutex> guardLock(lock);
+            if (!job || nextTask >= numTasks)
+                return;
+            thisJob = job;
+            task = nextTask++;
+        }
+
+        (*thisJob)(task);
+
+        std::lock_guard<std::mutex> guardLock(lock);
+        if (++tasksDone == numTasks)
+            doneCond.notify_all();
+    }
+}
+
+void WorkerPool::workerMain()
+{
+    unsigned int lastGeneration = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> guardLock(lock);
+            workCond.wait(guardLock,[&]{ return shutdown || generation != lastGeneration; });
+            if (shutdown)
+                return;
+            lastGeneration = generation;
+        }
+        runTasks();
+    }
+}
+
+}
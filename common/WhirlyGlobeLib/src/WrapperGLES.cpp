@@ -21,7 +21,13 @@
 #import <string.h>
 #import "WrapperGLES.h"
 
-#ifdef __ANDROID__
+#if defined(WHIRLYKIT_HEADLESS)
+
+// The stub does what Android does
+bool hasVertexArraySupport = false;
+bool hasMapBufferSupport = false;
+
+#elif defined(__ANDROID__)
 
 bool hasVertexArraySupport = false;
 bool hasMapBufferSupport = false;
@@ -55,7 +55,12 @@
     #endif
 
     #define json_nothrow throw()
-    #define json_throws(x) throw(x)
+    // C++17 dropped throw(x), throw() is still allowed
+    #if __cplusplus >= 201703L
+	   #define json_throws(x)
+    #else
+	   #define json_throws(x) throw(x)
+    #endif
 
     #ifdef JSON_LESS_MEMORY
 	   #define PACKED(x) :x __attribute__ ((packed))
@@ -251,6 +251,16 @@ extern NSString* const kMaplySubdivStatic;
 extern NSString* const kMaplySubdivSimple;
 /// Clip features along a grid of the given size
 extern NSString* const kMaplySubdivGrid;
+/// If set, simplify the vectors to this many screen pixels at kMaplyVecSimplifyLevel
+extern NSString* const kMaplyVecSimplifyTolerance;
+/// Zoom level the simplification tolerance is measured at
+extern NSString* const kMaplyVecSimplifyLevel;
+/// Simplification algorithm.  kMaplyVecSimplifyDouglasPeucker is the default.
+extern NSString* const kMaplyVecSimplifyType;
+/// Douglas-Peucker line simplification
+extern NSString* const kMaplyVecSimplifyDouglasPeucker;
+/// Visvalingam-Whyatt line simplification
+extern NSString* const kMaplyVecSimplifyVisvalingam;
 /// Used to turn off selection in vectors
 extern NSString* const kMaplySelectable;
 
@@ -309,6 +319,8 @@ extern NSString* const kMaplyShapeSampleX;
 extern NSString* const kMaplyShapeSampleY;
 /// If set to true, we'll tessellate a shape using the opposite vertex ordering
 extern NSString* const kMaplyShapeInsideOut;
+/// If set to true, spheres, cylinders and circles share a unit mesh and are drawn as instances
+extern NSString* const kMaplyShapeInstanced;
 /// Center for the shape geometry
 extern NSString* const kMaplyShapeCenterX;
 extern NSString* const kMaplyShapeCenterY;
@@ -408,6 +408,9 @@
  |kMaplyFilled|NSNumber boolean|If set, the areal geometry will be tesselated, taking holes into account.  The resulting triangles will be displayed instead of the vectors.|
  |kMaplySubdivType|NSString|When present, this requests that the geometry be broken up to follow the globe (really only makes sense there).  It can be set to kMaplySubdivGreatCircle or kMaplySubdivSimple which do a great circle subdivision and a simple 3-space subdivision respectively.  If the key is missing, we do no subdivision at all.|
  |kMaplySubdivEpsilon|NSNumber|If there's a kMaplySubdivType set this is the epsilon we'll pass into the subdivision routine.  The value is in display coordinates. 0.01 is a reasonable value.  Smaller results in more subdivision.|
+ |kMaplyVecSimplifyTolerance|NSNumber|If set, linear and areal features are simplified to this many screen pixels at kMaplyVecSimplifyLevel.  Boundaries shared between features stay shared.  Off by default.|
+ |kMaplyVecSimplifyLevel|NSNumber|The zoom level kMaplyVecSimplifyTolerance is measured at.  Required for simplification.|
+ |kMaplyVecSimplifyType|NSString|Either kMaplyVecSimplifyDouglasPeucker (the default) or kMaplyVecSimplifyVisvalingam.|
  |kMaplyVecTexture|UIImage|If set and the kMaplyFilled attribute is set, we will apply the given texture across any areal features.  How the texture is applied can be controlled by kMaplyVecTexScaleX, kMaplyVecTexScaleY, kMaplyVecCenterX, kMaplyVecCenterY, and kMaplyVecTextureProjection|
  |kMaplyVecTexScaleX,kMaplyVecTexScaleY|NSNumber|These control the scale of the texture application.  We'll multiply by these numbers before generating texture coordinates from the vertices.|
  |kMaplyVecCenterX,kMaplyVecCenterY|NSNumber|These control the center of a texture application.  If not set we'll use the areal's centroid.  If set, we'll use these instead.  They should be in local coordinates (probably geographic radians).|
@@ -484,6 +487,9 @@
  |kMaplyWideVecCoordType|NSNumber|Vectors can be widened in real coordinates (kMaplyWideVecCoordTypeReal) or screen coordinates (kMaplyWideVecCoordTypeScreen).  In the latter case they stay the same size now matter how you zoom.|
  |kMaplyWideVecJoinType|NSNumber|When lines meet in a join there are several options for representing them.  These include kMaplyWideVecMiterJoin, which is a simple miter join and kMaplyWideVecBevelJoin which is a more complicated bevel.  See http://www.w3.org/TR/SVG/painting.html#StrokeLinejoinProperty for how these look.|
  |kMaplyWideVecMiterLimit|NSNumber|When using miter joins you can trigger them at a certain threshold.|
+ |kMaplyVecSimplifyTolerance|NSNumber|If set, linear and areal features are simplified to this many screen pixels at kMaplyVecSimplifyLevel.  Boundaries shared between features stay shared.  Off by default.|
+ |kMaplyVecSimplifyLevel|NSNumber|The zoom level kMaplyVecSimplifyTolerance is measured at.  Required for simplification.|
+ |kMaplyVecSimplifyType|NSString|Either kMaplyVecSimplifyDouglasPeucker (the default) or kMaplyVecSimplifyVisvalingam.|
  |kMaplyWideVecTexRepeatLen|NSNumber|This is the repeat size for a texture applied along the widened line.  For kMaplyWideVecCoordTypeScreen this is pixels.|
  |kMaplyVecTexture|UIImage or MaplyTexture|This the texture to be applied to the widened vector.|
  |kMaplyMinVis|NSNumber|This is viewer height above the globe or map.  The vectors will only be visible if the user is above this height.  Off by default.|
@@ -568,6 +574,7 @@
  |kMaplyShapeSampleX|NSNumber|Number of samples to use in one direction when converting to polygons.|
  |kMaplyShapeSampleY|NSNumber|Number of samples to use in the other direction when converting to polygons.|
  |kMaplyShapeInsideOut|NSNumber boolean|If set to YES, we'll make the spheres inside out and such.  Set to NO by default.|
+ |kMaplyShapeInstanced|NSNumber boolean|If set to YES, spheres, cylinders and circles are drawn as instances of a shared mesh.  Much cheaper for large numbers of shapes.  Set to NO by default.|
  |kMaplyMinVis|NSNumber|This is viewer height above the globe or map.  The shapes will only be visible if the user is above this height.  Off by default.|
  |kMaplyMaxVis|NSNumber|This is viewer height above the globe or map.  The shapes will only be visible if the user is below this height.  Off by default.|
  |kMaplyMinViewerDist|NSNumber|Minimum distance from the viewer at which to display object(s).|
@@ -1347,6 +1354,23 @@
 /// Turn on/off performance output (goes to the log periodically).
 @property (nonatomic,assign) bool performanceOutput;
 
+/** 
+    Turn on/off frame tracing.
+    
+    This records timings for the render, layer and loader threads along with a few counters.
+    Turning it on clears out anything recorded before.  It's cheap, but not free.
+  */
+@property (nonatomic,assign) bool frameTrace;
+
+/** 
+    Write out the frame trace recorded so far.
+    
+    The output is Chrome trace event JSON, which can be loaded into chrome://tracing or Perfetto.
+    
+    @return Returns false if the file couldn't be written.
+  */
+- (bool)writeFrameTrace:(NSString *__nonnull)fileName;
+
 /** 
     See derived class method.
  */
@@ -77,6 +77,12 @@
 /// If we're using widened vectors, only activate them for strokes wider than this.  Defaults to zero.
 @property (nonatomic) float wideVecCuttoff;
 
+/// If set, simplify linear and areal features to this many pixels before building them.  Off (0) by default.
+@property (nonatomic) float simplifyTolerance;
+
+/// Tiles at or past this level aren't simplified since they'll be overzoomed.  -1 (the default) means no limit.
+@property (nonatomic) int simplifyMaxLevel;
+
 /// If set, this is the shader we'll use on the areal features.
 @property (nonatomic,strong) NSString * _Nullable arealShaderName;
 
@@ -110,6 +110,24 @@ typedef NS_ENUM(NSInteger, MaplyParticleSystemType) {
   */
 @property (nonatomic,assign) bool continuousUpdate;
 
+/**
+    Move the particles on the CPU rather than with a position shader.
+ 
+    The particles are moved in a straight line from a_position along a_dir (or a_velocity) and
+    the results are uploaded every frame.  If there's a float a_age attribute it will be set to
+    the particle's age, from 0 to 1.  Use this where the device can't run a position shader.
+ 
+    Off by default.
+  */
+@property (nonatomic,assign) bool cpuCalculation;
+
+/**
+    Number of threads to use for CPU calculation.
+ 
+    Batches are split up between this many threads.  Defaults to 1.
+  */
+@property (nonatomic,assign) int cpuThreads;
+
 /** 
     Initialize a particle system with a name.
     
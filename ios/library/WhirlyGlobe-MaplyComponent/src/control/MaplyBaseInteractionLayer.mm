@@ -2924,6 +2924,8 @@ typedef std::set<GeomModelInstances *,struct GeomModelInstancesCmp> GeomModelIns
         wkPartSys.vertexSize = partSys.vertexSize;
         wkPartSys.baseTime = partSys.baseTime;
         wkPartSys.continuousUpdate = partSys.continuousUpdate;
+        wkPartSys.cpuCalculation = partSys.cpuCalculation;
+        wkPartSys.cpuThreads = partSys.cpuThreads;
         wkPartSys.zBufferRead = [inDesc[kMaplyZBufferRead] boolValue];
         wkPartSys.zBufferWrite = [inDesc[kMaplyZBufferWrite] boolValue];
         wkPartSys.renderTargetID = partSys.renderTargetID;
@@ -3470,7 +3472,7 @@ typedef std::set<GeomModelInstances *,struct GeomModelInstancesCmp> GeomModelIns
     
     pt = visualView->unwrapCoordinate(pt);
     
-    ViewStateRef viewState = vc->renderControl->visualView->makeViewState(vc->renderControl->sceneRenderer.get());
+    ViewStateRef viewState = vc->renderControl->visualView->getViewState(vc->renderControl->sceneRenderer.get());
     
     auto rets = compManager->findVectors(Point2d(pt.x(),pt.y()),20.0,viewState,vc->renderControl->sceneRenderer->getFramebufferSizeScaled(),multi);
     
@@ -479,6 +479,24 @@ static const float PerfOutputDelay = 15.0;
     return _performanceOutput;
 }
 
+- (void)setFrameTrace:(bool)frameTrace
+{
+    FrameTrace::setEnabled(frameTrace);
+}
+
+- (bool)frameTrace
+{
+    return FrameTrace::isEnabled();
+}
+
+- (bool)writeFrameTrace:(NSString *)fileName
+{
+    if (!fileName)
+        return false;
+    
+    return FrameTrace::writeChromeTrace([fileName UTF8String]);
+}
+
 // Build an array of lights and send them down all at once
 - (void)updateLights
 {
@@ -225,6 +225,16 @@ NSString* const kMaplySubdivStatic = @"static";
 NSString* const kMaplySubdivSimple = MaplySubdivSimple;
 /// Clip features along a grid of the given size
 NSString* const kMaplySubdivGrid = MaplySubdivGrid;
+/// If set, simplify the vectors to this many screen pixels at kMaplyVecSimplifyLevel
+NSString* const kMaplyVecSimplifyTolerance = MaplyVecSimplifyTolerance;
+/// Zoom level the simplification tolerance is measured at
+NSString* const kMaplyVecSimplifyLevel = MaplyVecSimplifyLevel;
+/// Simplification algorithm.  kMaplyVecSimplifyDouglasPeucker is the default.
+NSString* const kMaplyVecSimplifyType = MaplyVecSimplifyType;
+/// Douglas-Peucker line simplification
+NSString* const kMaplyVecSimplifyDouglasPeucker = MaplyVecSimplifyDouglasPeucker;
+/// Visvalingam-Whyatt line simplification
+NSString* const kMaplyVecSimplifyVisvalingam = MaplyVecSimplifyVisvalingam;
 /// Used to turn off selection in vectors
 NSString* const kMaplySelectable = @"selectable";
 
@@ -281,6 +291,7 @@ NSString* const kMaplyShapeSampleX = @"shapesamplex";
 NSString* const kMaplyShapeSampleY = @"shapesampley";
 /// If set to true, we'll tessellate a shape using the opposite vertex ordering
 NSString* const kMaplyShapeInsideOut = MaplyShapeInsideOut;
+NSString* const kMaplyShapeInstanced = MaplyShapeInstanced;
 /// Center for the shape geometry
 NSString* const kMaplyShapeCenterX = MaplyShapeCenterX;
 NSString* const kMaplyShapeCenterY = MaplyShapeCenterY;
@@ -159,7 +159,7 @@ using namespace WhirlyGlobe;
 {
     SelectionManager *selectManager = (SelectionManager *)scene->getManager(kWKSelectionManager);
     std::vector<SelectionManager::SelectedObject> selectedObjs;
-    selectManager->pickObjects(Point2f(screenPoint.x,screenPoint.y),10.0,globeView->makeViewState(layerThread.renderer),selectedObjs);
+    selectManager->pickObjects(Point2f(screenPoint.x,screenPoint.y),10.0,globeView->getViewState(layerThread.renderer),selectedObjs);
     
     NSMutableArray *retSelectArr = [NSMutableArray array];
     if (!selectedObjs.empty())
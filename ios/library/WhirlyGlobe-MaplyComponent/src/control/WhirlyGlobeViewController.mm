@@ -1533,7 +1533,7 @@ public:
     
     // Look for the object, returns an ID
     SelectionManager *selectManager = (SelectionManager *)renderControl->scene->getManager(kWKSelectionManager);
-    SimpleIdentity objId = selectManager->pickObject(Point2f(screenPt.x,screenPt.y), 10.0, globeView->makeViewState(renderControl->sceneRenderer.get()));
+    SimpleIdentity objId = selectManager->pickObject(Point2f(screenPt.x,screenPt.y), 10.0, globeView->getViewState(renderControl->sceneRenderer.get()));
     
     if (objId != EmptyIdentity)
     {
@@ -140,7 +140,7 @@ void ViewPlacementManager::updateLocations(RendererFrameInfo *frameInfo)
     frameMbr.ll() = Point2f(0 - marginX,0 - marginY);
     frameMbr.ur() = Point2f(frameInfo->sceneRenderer->framebufferWidth + marginX,frameInfo->sceneRenderer->framebufferHeight + marginY);
     
-    std::vector<Eigen::Matrix4d> modelAndViewMats; // modelAndViewNormalMats;
+    Matrix4dVector modelAndViewMats; // modelAndViewNormalMats;
     for (unsigned int offi=0;offi<frameInfo->offsetMatrices.size();offi++)
     {
         // Project the world location to the screen
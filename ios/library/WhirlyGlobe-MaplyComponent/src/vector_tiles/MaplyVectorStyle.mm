@@ -200,6 +200,26 @@ using namespace WhirlyKit;
     return impl->wideVecCuttoff;
 }
 
+- (void)setSimplifyTolerance:(float)simplifyTolerance
+{
+    impl->simplifyTolerance = simplifyTolerance;
+}
+
+- (float)simplifyTolerance
+{
+    return impl->simplifyTolerance;
+}
+
+- (void)setSimplifyMaxLevel:(int)simplifyMaxLevel
+{
+    impl->simplifyMaxLevel = simplifyMaxLevel;
+}
+
+- (int)simplifyMaxLevel
+{
+    return impl->simplifyMaxLevel;
+}
+
 - (void)setArealShaderName:(NSString *)arealShaderName
 {
     if (arealShaderName)
@@ -79,6 +79,8 @@ using namespace WhirlyKit;
     _renderTargetID = EmptyIdentity;
     _numRegAttrs = 0;
     _vertexSize = 0;
+    _cpuCalculation = false;
+    _cpuThreads = 1;
     
     return self;
 }
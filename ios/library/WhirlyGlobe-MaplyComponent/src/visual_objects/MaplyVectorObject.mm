@@ -425,7 +425,7 @@ using namespace WhirlyGlobe;
     if (!vc->renderControl || !vc->renderControl->visualView)
         return false;
     
-    ViewStateRef viewState = vc->renderControl->visualView->makeViewState(vc->renderControl->sceneRenderer.get());
+    ViewStateRef viewState = vc->renderControl->visualView->getViewState(vc->renderControl->sceneRenderer.get());
 
     return vObj->pointNearLinear(Point2d(coord.x,coord.y),maxDistance,viewState,vc->renderControl->sceneRenderer->getFramebufferSizeScaled());
 }
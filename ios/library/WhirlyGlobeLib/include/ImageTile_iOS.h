@@ -40,7 +40,7 @@ public:
     virtual Texture *buildTexture();
     
     /// Generate the texture and then store it
-    Texture *prebuildTexture();
+    virtual Texture *prebuildTexture();
     
     /// Stop keeping track of texture if you were
     virtual void clearTexture();
@@ -255,8 +255,7 @@ void BasicDrawableInstanceMTL::draw(RendererFrameInfoMTL *frameInfo,id<MTLRender
     
     [cmdEncode setRenderPipelineState:renderState];
     
-    // TODO: Fill this in
-    float fade = 1.0;
+    float fade = calcFade(frameInfo);
         
     // Sometimes it's just boring geometry and the texture's in the base
     // Sometimes we're doing something clever and it's in the instance
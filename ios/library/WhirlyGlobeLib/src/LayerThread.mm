@@ -24,6 +24,7 @@
 #import "Platform.h"
 #import "SceneRendererGLES_iOS.h"
 #import "SceneRendererMTL.h"
+#import "FrameTrace.h"
 
 using namespace WhirlyKit;
 
@@ -193,6 +194,8 @@ using namespace WhirlyKit;
         // Note: Hey, should we be deleting these?
         return;
     
+    FrameTraceScope traceScope(TraceLayerFlush);
+    
     if (_glContext)
         [EAGLContext setCurrentContext:_glContext];
 
@@ -278,6 +281,8 @@ using namespace WhirlyKit;
 
     existenceLock.lock();
 
+    FrameTrace::setThreadName("Layer Thread");
+
     // This should be the default context.  If you change it yourself, change it back
     if (_glContext)
         [EAGLContext setCurrentContext:_glContext];
@@ -103,7 +103,7 @@ public:
         layerThread = inLayerThread;
         view = inView;
         watchers = [NSMutableArray array];
-        lastViewState = inView->makeViewState(layerThread.renderer);
+        lastViewState = inView->getViewState(layerThread.renderer);
         viewWatchWrapper.viewWatcher = self;
         inView->addWatcher(&viewWatchWrapper);
     }
@@ -131,7 +131,7 @@ public:
     
     if (!lastViewState && layerThread.renderer->framebufferWidth != 0)
     {
-        lastViewState = view->makeViewState(layerThread.renderer);
+        lastViewState = view->getViewState(layerThread.renderer);
     }
     
     // Make sure it gets a starting update
@@ -189,7 +189,7 @@ public:
         return;
     }
 
-    ViewStateRef viewState = view->makeViewState(layerThread.renderer);
+    ViewStateRef viewState = view->getViewState(layerThread.renderer);
     
     //    lastViewState = viewState;
     @synchronized(self)
@@ -233,6 +233,16 @@ void ParticleSystemDrawableMTL::draw(RendererFrameInfoMTL *frameInfo,id<MTLRende
     SceneMTL *scene = (SceneMTL *)inScene;
     SceneRendererMTL *sceneRender = (SceneRendererMTL *)frameInfo->sceneRenderer;
     
+    // Move the particles ourselves, straight into the shared buffer, as addAttributeData() does
+    if (cpuSim && pointBuffer[curPointBuffer] && lastUpdateTime < frameInfo->currentTime) {
+        unsigned char *contents = (unsigned char *)[pointBuffer[curPointBuffer] contents];
+        cpuSim->update(frameInfo->currentTime,[contents](int offset,const void *data,int len)
+                       {
+                           memcpy(contents + offset, data, len);
+                       });
+        lastUpdateTime = frameInfo->currentTime;
+    }
+
     // Render state is pretty simple, so apply that
     id<MTLRenderPipelineState> renderState = getRenderPipelineState(sceneRender,frameInfo);
     [cmdEncode setRenderPipelineState:renderState];
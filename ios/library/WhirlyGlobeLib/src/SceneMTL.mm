@@ -77,6 +77,7 @@ void SceneMTL::teardown()
             draw->teardownForRenderer((RenderSetupInfoMTL *)setupInfo,this);
     }
     drawables.clear();
+    visibilityIndex.clear();
     for (auto it : textures) {
         it.second->destroyInRenderer(setupInfo,this);
     }
@@ -29,6 +29,7 @@
 #import "DynamicTextureAtlasMTL.h"
 #import "MaplyView.h"
 #import "WhirlyKitLog.h"
+#import "FrameTrace.h"
 #import "DefaultShadersMTL.h"
 #import "RawData_NSData.h"
 #import "RenderTargetMTL.h"
@@ -311,11 +312,18 @@ void SceneRendererMTL::render(TimeInterval duration,
     
     lastDraw = now;
     
+    if (FrameTrace::isEnabled())
+        FrameTrace::setThreadName("Render");
+
     if (perfInterval > 0)
         perfTimer.startTiming("Render Frame");
     
+    FrameTrace::begin(TraceRenderFrame);
+    
     if (perfInterval > 0)
         perfTimer.startTiming("Render Setup");
+    
+    FrameTrace::begin(TraceRenderSetup);
 
     // See if we're dealing with a globe or map view
     Maply::MapView *mapView = dynamic_cast<Maply::MapView *>(theView);
@@ -346,6 +354,8 @@ void SceneRendererMTL::render(TimeInterval duration,
     if (perfInterval > 0)
         perfTimer.stopTiming("Render Setup");
 
+    FrameTrace::end(TraceRenderSetup);
+
     // Note: Make this more general
     auto defaultTarget = renderTargets.back();
     auto clearColor = defaultTarget->clearColor;
@@ -403,6 +413,8 @@ void SceneRendererMTL::render(TimeInterval duration,
     if (perfInterval > 0)
         perfTimer.startTiming("Scene preprocessing");
     
+    FrameTrace::begin(TraceScenePreprocess);
+    
     // Run the preprocess for the changes.  These modify things the active models need.
     int numPreProcessChanges = preProcessScene(now);;
     
@@ -412,9 +424,13 @@ void SceneRendererMTL::render(TimeInterval duration,
     if (perfInterval > 0)
         perfTimer.stopTiming("Scene preprocessing");
     
+    FrameTrace::end(TraceScenePreprocess);
+    
     if (perfInterval > 0)
         perfTimer.startTiming("Active Model Runs");
     
+    FrameTrace::begin(TraceActiveModels);
+    
     // Let the active models to their thing
     // That thing had better not take too long
     for (auto activeModel : scene->activeModels) {
@@ -426,12 +442,17 @@ void SceneRendererMTL::render(TimeInterval duration,
     if (perfInterval > 0)
         perfTimer.stopTiming("Active Model Runs");
     
+    FrameTrace::end(TraceActiveModels);
+    
     if (perfInterval > 0)
         perfTimer.addCount("Scene changes", (int)scene->changeRequests.size());
+    FrameTrace::setCount(TraceChangeQueue, scene->changeRequests.size());
     
     if (perfInterval > 0)
         perfTimer.startTiming("Scene processing");
     
+    FrameTrace::begin(TraceSceneChanges);
+    
     // Merge any outstanding changes into the scenegraph
     processScene(now);
     
@@ -441,14 +462,16 @@ void SceneRendererMTL::render(TimeInterval duration,
     if (perfInterval > 0)
         perfTimer.stopTiming("Scene processing");
     
+    FrameTrace::end(TraceSceneChanges);
+    
     // Work through the available offset matrices (only 1 if we're not wrapping)
-    std::vector<Matrix4d> &offsetMats = baseFrameInfo.offsetMatrices;
+    Matrix4dVector &offsetMats = baseFrameInfo.offsetMatrices;
     std::vector<RendererFrameInfoMTL> offFrameInfos;
     // Turn these drawables in to a vector
-    std::vector<Matrix4d> mvpMats;
-    std::vector<Matrix4d> mvpInvMats;
-    std::vector<Matrix4f> mvpMats4f;
-    std::vector<Matrix4f> mvpInvMats4f;
+    Matrix4dVector mvpMats;
+    Matrix4dVector mvpInvMats;
+    Matrix4fVector mvpMats4f;
+    Matrix4fVector mvpInvMats4f;
     mvpMats.resize(offsetMats.size());
     mvpInvMats.resize(offsetMats.size());
     mvpMats4f.resize(offsetMats.size());
@@ -483,6 +506,7 @@ void SceneRendererMTL::render(TimeInterval duration,
     for (auto &workGroup : workGroups) {
         if (perfInterval > 0)
             perfTimer.startTiming("Work Group: " + workGroup->name);
+        FrameTrace::begin(TraceDrawExecution);
 
         for (auto &targetContainer : workGroup->renderTargetContainers) {
             RenderTargetMTLRef renderTarget;
@@ -717,10 +741,16 @@ void SceneRendererMTL::render(TimeInterval duration,
                 
         if (perfInterval > 0)
             perfTimer.stopTiming("Work Group: " + workGroup->name);
+                
+        FrameTrace::end(TraceDrawExecution);
     }
         
+    FrameTrace::setCount(TraceDrawablesDrawn, numDrawables);
+    
     if (perfInterval > 0)
         perfTimer.stopTiming("Render Frame");
+        
+    FrameTrace::end(TraceRenderFrame);
     
     // Update the frames per sec
     if (perfInterval > 0 && frameCount > perfInterval)
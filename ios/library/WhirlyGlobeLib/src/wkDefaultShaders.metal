@@ -377,8 +377,9 @@ vertex ProjVertexTriB vertexTri_model(VertexTriB vert [[stage_in]],
     
     outVert.position = uniforms.mvpMatrix * float4(vertPos,1.0);
     float4 color = uniMI.useInstanceColor ? inst.color : vert.color;
+    float3 instNorm = normalize((inst.mat * float4(vert.normal,0.0)).xyz);
     outVert.color = resolveLighting(vert.position,
-                                    vert.normal,
+                                    instNorm,
                                     color,
                                     lighting,
                                     uniforms.mvpMatrix) * uniDrawState.fade;
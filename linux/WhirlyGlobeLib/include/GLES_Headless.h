@@ -0,0 +1,275 @@
+/*
+ *  GLES_Headless.h
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** The subset of OpenGL ES 3 the toolkit uses, for headless builds.
+    There's no driver behind this.  The calls are implemented in GLES_Headless.cpp
+    which hands out object IDs, keeps track of buffer and texture sizes, and
+    counts what would have been drawn.
+  */
+
+typedef unsigned int GLenum;
+typedef unsigned char GLboolean;
+typedef unsigned int GLbitfield;
+typedef void GLvoid;
+typedef signed char GLbyte;
+typedef short GLshort;
+typedef int GLint;
+typedef int GLsizei;
+typedef unsigned char GLubyte;
+typedef unsigned short GLushort;
+typedef unsigned int GLuint;
+typedef float GLfloat;
+typedef float GLclampf;
+typedef char GLchar;
+typedef ptrdiff_t GLintptr;
+typedef ptrdiff_t GLsizeiptr;
+
+#define GL_FALSE                            0
+#define GL_TRUE                             1
+#define GL_NO_ERROR                         0
+#define GL_ONE                              1
+
+#define GL_POINTS                           0x0000
+#define GL_LINES                            0x0001
+#define GL_LINE_LOOP                        0x0002
+#define GL_LINE_STRIP                       0x0003
+#define GL_TRIANGLES                        0x0004
+#define GL_TRIANGLE_STRIP                   0x0005
+#define GL_TRIANGLE_FAN                     0x0006
+
+#define GL_DEPTH_BUFFER_BIT                 0x00000100
+#define GL_COLOR_BUFFER_BIT                 0x00004000
+#define GL_MAP_READ_BIT                     0x0001
+#define GL_MAP_WRITE_BIT                    0x0002
+
+#define GL_LESS                             0x0201
+#define GL_ALWAYS                           0x0207
+#define GL_ONE_MINUS_SRC_ALPHA              0x0303
+#define GL_CULL_FACE                        0x0B44
+#define GL_DEPTH_TEST                       0x0B71
+#define GL_BLEND                            0x0BE2
+#define GL_TEXTURE_2D                       0x0DE1
+
+#define GL_BYTE                             0x1400
+#define GL_UNSIGNED_BYTE                    0x1401
+#define GL_SHORT                            0x1402
+#define GL_UNSIGNED_SHORT                   0x1403
+#define GL_INT                              0x1404
+#define GL_UNSIGNED_INT                     0x1405
+#define GL_FLOAT                            0x1406
+
+#define GL_DEPTH_COMPONENT                  0x1902
+#define GL_ALPHA                            0x1906
+#define GL_RGB                              0x1907
+#define GL_RGBA                             0x1908
+#define GL_LUMINANCE                        0x1909
+#define GL_LUMINANCE_ALPHA                  0x190A
+#define GL_UNSIGNED_SHORT_4_4_4_4           0x8033
+#define GL_UNSIGNED_SHORT_5_5_5_1           0x8034
+#define GL_UNSIGNED_SHORT_5_6_5             0x8363
+#define GL_RG                               0x8227
+#define GL_R8                               0x8229
+#define GL_RG8                              0x822B
+
+#define GL_NEAREST                          0x2600
+#define GL_LINEAR                           0x2601
+#define GL_NEAREST_MIPMAP_NEAREST           0x2700
+#define GL_LINEAR_MIPMAP_NEAREST            0x2701
+#define GL_NEAREST_MIPMAP_LINEAR            0x2702
+#define GL_LINEAR_MIPMAP_LINEAR             0x2703
+#define GL_TEXTURE_MAG_FILTER               0x2800
+#define GL_TEXTURE_MIN_FILTER               0x2801
+#define GL_TEXTURE_WRAP_S                   0x2802
+#define GL_TEXTURE_WRAP_T                   0x2803
+#define GL_REPEAT                           0x2901
+#define GL_CLAMP_TO_EDGE                    0x812F
+#define GL_DEPTH_COMPONENT16                0x81A5
+#define GL_TEXTURE0                         0x84C0
+
+#define GL_ARRAY_BUFFER                     0x8892
+#define GL_ELEMENT_ARRAY_BUFFER             0x8893
+#define GL_WRITE_ONLY_OES                   0x88B9
+#define GL_STATIC_DRAW                      0x88E4
+#define GL_DYNAMIC_DRAW                     0x88E8
+
+#define GL_FRAGMENT_SHADER                  0x8B30
+#define GL_VERTEX_SHADER                    0x8B31
+#define GL_FLOAT_VEC2                       0x8B50
+#define GL_FLOAT_VEC3                       0x8B51
+#define GL_FLOAT_VEC4                       0x8B52
+#define GL_INT_VEC2                         0x8B53
+#define GL_INT_VEC3                         0x8B54
+#define GL_INT_VEC4                         0x8B55
+#define GL_BOOL                             0x8B56
+#define GL_FLOAT_MAT2                       0x8B5A
+#define GL_FLOAT_MAT3                       0x8B5B
+#define GL_FLOAT_MAT4                       0x8B5C
+#define GL_SAMPLER_2D                       0x8B5E
+#define GL_COMPILE_STATUS                   0x8B81
+#define GL_LINK_STATUS                      0x8B82
+#define GL_INFO_LOG_LENGTH                  0x8B84
+#define GL_ACTIVE_UNIFORMS                  0x8B86
+#define GL_ACTIVE_ATTRIBUTES                0x8B89
+
+#define GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG  0x8C00
+#define GL_RASTERIZER_DISCARD               0x8C89
+#define GL_SEPARATE_ATTRIBS                 0x8C8D
+#define GL_TRANSFORM_FEEDBACK_BUFFER        0x8C8E
+#define GL_FRAMEBUFFER_BINDING              0x8CA6
+#define GL_RENDERBUFFER_BINDING             0x8CA7
+#define GL_FRAMEBUFFER_COMPLETE             0x8CD5
+#define GL_COLOR_ATTACHMENT0                0x8CE0
+#define GL_DEPTH_ATTACHMENT                 0x8D00
+#define GL_FRAMEBUFFER                      0x8D40
+#define GL_RENDERBUFFER                     0x8D41
+
+#define GL_COMPRESSED_R11_EAC               0x9270
+#define GL_COMPRESSED_SIGNED_R11_EAC        0x9271
+#define GL_COMPRESSED_RG11_EAC              0x9272
+#define GL_COMPRESSED_SIGNED_RG11_EAC       0x9273
+#define GL_COMPRESSED_RGB8_ETC2             0x9274
+#define GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 0x9276
+#define GL_COMPRESSED_RGBA8_ETC2_EAC        0x9278
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void glActiveTexture(GLenum texture);
+void glAttachShader(GLuint program,GLuint shader);
+void glBeginTransformFeedback(GLenum primitiveMode);
+void glBindBuffer(GLenum target,GLuint buffer);
+void glBindBufferBase(GLenum target,GLuint index,GLuint buffer);
+void glBindBufferRange(GLenum target,GLuint index,GLuint buffer,GLintptr offset,GLsizeiptr size);
+void glBindFramebuffer(GLenum target,GLuint framebuffer);
+void glBindRenderbuffer(GLenum target,GLuint renderbuffer);
+void glBindTexture(GLenum target,GLuint texture);
+void glBindVertexArray(GLuint array);
+void glBlendFunc(GLenum sfactor,GLenum dfactor);
+void glBufferData(GLenum target,GLsizeiptr size,const void *data,GLenum usage);
+void glBufferSubData(GLenum target,GLintptr offset,GLsizeiptr size,const void *data);
+GLenum glCheckFramebufferStatus(GLenum target);
+void glClear(GLbitfield mask);
+void glClearColor(GLfloat red,GLfloat green,GLfloat blue,GLfloat alpha);
+void glCompileShader(GLuint shader);
+void glCompressedTexImage2D(GLenum target,GLint level,GLenum internalformat,GLsizei width,GLsizei height,GLint border,GLsizei imageSize,const void *data);
+void glCompressedTexSubImage2D(GLenum target,GLint level,GLint xoffset,GLint yoffset,GLsizei width,GLsizei height,GLenum format,GLsizei imageSize,const void *data);
+GLuint glCreateProgram(void);
+GLuint glCreateShader(GLenum type);
+void glDeleteBuffers(GLsizei n,const GLuint *buffers);
+void glDeleteFramebuffers(GLsizei n,const GLuint *framebuffers);
+void glDeleteProgram(GLuint program);
+void glDeleteRenderbuffers(GLsizei n,const GLuint *renderbuffers);
+void glDeleteShader(GLuint shader);
+void glDeleteTextures(GLsizei n,const GLuint *textures);
+void glDeleteVertexArrays(GLsizei n,const GLuint *arrays);
+void glDepthFunc(GLenum func);
+void glDepthMask(GLboolean flag);
+void glDisable(GLenum cap);
+void glDisableVertexAttribArray(GLuint index);
+void glDrawArrays(GLenum mode,GLint first,GLsizei count);
+void glDrawArraysInstanced(GLenum mode,GLint first,GLsizei count,GLsizei instancecount);
+void glDrawElements(GLenum mode,GLsizei count,GLenum type,const void *indices);
+void glDrawElementsInstanced(GLenum mode,GLsizei count,GLenum type,const void *indices,GLsizei instancecount);
+void glEnable(GLenum cap);
+void glEnableVertexAttribArray(GLuint index);
+void glEndTransformFeedback(void);
+void glFinish(void);
+void glFlush(void);
+void glFramebufferRenderbuffer(GLenum target,GLenum attachment,GLenum renderbuffertarget,GLuint renderbuffer);
+void glFramebufferTexture2D(GLenum target,GLenum attachment,GLenum textarget,GLuint texture,GLint level);
+void glGenBuffers(GLsizei n,GLuint *buffers);
+void glGenFramebuffers(GLsizei n,GLuint *framebuffers);
+void glGenRenderbuffers(GLsizei n,GLuint *renderbuffers);
+void glGenTextures(GLsizei n,GLuint *textures);
+void glGenVertexArrays(GLsizei n,GLuint *arrays);
+void glGenerateMipmap(GLenum target);
+void glGetActiveAttrib(GLuint program,GLuint index,GLsizei bufSize,GLsizei *length,GLint *size,GLenum *type,GLchar *name);
+void glGetActiveUniform(GLuint program,GLuint index,GLsizei bufSize,GLsizei *length,GLint *size,GLenum *type,GLchar *name);
+GLint glGetAttribLocation(GLuint program,const GLchar *name);
+GLenum glGetError(void);
+void glGetIntegerv(GLenum pname,GLint *data);
+void glGetProgramInfoLog(GLuint program,GLsizei bufSize,GLsizei *length,GLchar *infoLog);
+void glGetProgramiv(GLuint program,GLenum pname,GLint *params);
+void glGetShaderInfoLog(GLuint shader,GLsizei bufSize,GLsizei *length,GLchar *infoLog);
+void glGetShaderiv(GLuint shader,GLenum pname,GLint *params);
+GLint glGetUniformLocation(GLuint program,const GLchar *name);
+void glInvalidateFramebuffer(GLenum target,GLsizei numAttachments,const GLenum *attachments);
+void glLineWidth(GLfloat width);
+void glLinkProgram(GLuint program);
+void *glMapBufferOES(GLenum target,GLenum access);
+void *glMapBufferRange(GLenum target,GLintptr offset,GLsizeiptr length,GLbitfield access);
+void glReadPixels(GLint x,GLint y,GLsizei width,GLsizei height,GLenum format,GLenum type,void *pixels);
+void glRenderbufferStorage(GLenum target,GLenum internalformat,GLsizei width,GLsizei height);
+void glShaderSource(GLuint shader,GLsizei count,const GLchar *const*string,const GLint *length);
+void glTexImage2D(GLenum target,GLint level,GLint internalformat,GLsizei width,GLsizei height,GLint border,GLenum format,GLenum type,const void *pixels);
+void glTexParameteri(GLenum target,GLenum pname,GLint param);
+void glTexSubImage2D(GLenum target,GLint level,GLint xoffset,GLint yoffset,GLsizei width,GLsizei height,GLenum format,GLenum type,const void *pixels);
+void glTransformFeedbackVaryings(GLuint program,GLsizei count,const GLchar *const*varyings,GLenum bufferMode);
+void glUniform1f(GLint location,GLfloat v0);
+void glUniform1i(GLint location,GLint v0);
+void glUniform2f(GLint location,GLfloat v0,GLfloat v1);
+void glUniform3f(GLint location,GLfloat v0,GLfloat v1,GLfloat v2);
+void glUniform4f(GLint location,GLfloat v0,GLfloat v1,GLfloat v2,GLfloat v3);
+void glUniformMatrix4fv(GLint location,GLsizei count,GLboolean transpose,const GLfloat *value);
+GLboolean glUnmapBuffer(GLenum target);
+GLboolean glUnmapBufferOES(GLenum target);
+void glUseProgram(GLuint program);
+void glVertexAttrib1f(GLuint index,GLfloat x);
+void glVertexAttrib2f(GLuint index,GLfloat x,GLfloat y);
+void glVertexAttrib3f(GLuint index,GLfloat x,GLfloat y,GLfloat z);
+void glVertexAttrib4f(GLuint index,GLfloat x,GLfloat y,GLfloat z,GLfloat w);
+void glVertexAttribDivisor(GLuint index,GLuint divisor);
+void glVertexAttribPointer(GLuint index,GLint size,GLenum type,GLboolean normalized,GLsizei stride,const void *pointer);
+void glViewport(GLint x,GLint y,GLsizei width,GLsizei height);
+
+#ifdef __cplusplus
+}
+
+/// What the headless GLES stub has been asked to do
+class GLESHeadlessStats
+{
+public:
+    GLESHeadlessStats();
+
+    /// Every GL call
+    uint64_t calls;
+    /// Draw calls and the primitives (points, lines or triangles) they covered
+    uint64_t drawCalls,primitives;
+    /// Uniforms and attributes set
+    uint64_t uniformCalls;
+    /// Bytes handed over in buffer and texture data calls
+    uint64_t bufferUploadBytes,textureUploadBytes;
+    /// Current number of objects and the bytes they'd occupy
+    uint64_t numBuffers,bufferBytes;
+    uint64_t numTextures,textureBytes;
+    uint64_t numPrograms;
+};
+
+/// Copy of the stats so far
+GLESHeadlessStats GLESHeadlessGetStats();
+
+/// Zero out the call counts.  Object counts and sizes are kept.
+void GLESHeadlessResetCounts();
+
+#endif
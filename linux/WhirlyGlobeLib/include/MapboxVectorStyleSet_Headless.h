@@ -0,0 +1,71 @@
+/*
+ *  MapboxVectorStyleSet_Headless.h
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import "WhirlyGlobe.h"
+
+namespace WhirlyKit
+{
+
+/// There are no fonts in a headless build, so labels are laid out but never get any glyphs
+class SingleLabel_Headless : public SingleLabel
+{
+public:
+    virtual std::vector<DrawableString *> generateDrawableStrings(PlatformThreadInfo *threadInfo,const LabelInfo *,FontTextureManager *fontTexManager,float &lineHeight,ChangeSet &changes);
+};
+
+/// Headless version of the Mapbox Vector Style Set
+/// Just implements the platform local stuff, and that minimally
+class MapboxVectorStyleSetImpl_Headless : public MapboxVectorStyleSetImpl
+{
+public:
+    MapboxVectorStyleSetImpl_Headless(Scene *scene,CoordSystem *coordSys,VectorStyleSettingsImplRef settings);
+    ~MapboxVectorStyleSetImpl_Headless();
+
+    /** Platform specific implementation **/
+
+    /// No circle textures, as on Android
+    virtual SimpleIdentity makeCircleTexture(PlatformThreadInfo *inst,
+            double radius,
+            const RGBAColor &fillColor,
+            const RGBAColor &strokeColor,
+            float strokeWidth,
+            Point2f *circleSize);
+
+    /// No line textures, as on Android
+    virtual SimpleIdentity makeLineTexture(PlatformThreadInfo *inst,const std::vector<double> &dashComponents);
+
+    /// A plain LabelInfo at the given size
+    virtual LabelInfoRef makeLabelInfo(PlatformThreadInfo *inst,const std::string &fontName,float fontSize);
+
+    /// A label with no glyphs
+    virtual SingleLabelRef makeSingleLabel(PlatformThreadInfo *inst,const std::string &text);
+
+    /// Create a component object
+    virtual ComponentObjectRef makeComponentObject(PlatformThreadInfo *inst);
+
+    /// Rough width of the given line of text, assuming glyphs are half as wide as they are tall
+    virtual double calculateTextWidth(PlatformThreadInfo *inInst,LabelInfoRef labelInfo,const std::string &testStr);
+
+    /// Nothing is selectable
+    virtual void addSelectionObject(SimpleIdentity selectID,VectorObjectRef vecObj,ComponentObjectRef compObj);
+};
+typedef std::shared_ptr<MapboxVectorStyleSetImpl_Headless> MapboxVectorStyleSetImpl_HeadlessRef;
+
+}
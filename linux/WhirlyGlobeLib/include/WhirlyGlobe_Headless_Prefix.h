@@ -0,0 +1,37 @@
+/*
+ *  WhirlyGlobe_Headless_Prefix.h
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+// Prefix header for the C++ sources in the headless build, as the .pch is on iOS.
+// The toolkit is built against libc++ on iOS and Android, which pulls in more of
+//  the standard library from each header than libstdc++ does.
+
+#include <math.h>
+#include <string.h>
+#include <limits.h>
+#include <float.h>
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
@@ -0,0 +1,744 @@
+/*
+ *  GLES_Headless.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <string.h>
+#import <mutex>
+#import <string>
+#import <vector>
+#import <unordered_map>
+#import "GLES_Headless.h"
+
+GLESHeadlessStats::GLESHeadlessStats()
+: calls(0), drawCalls(0), primitives(0), uniformCalls(0),
+  bufferUploadBytes(0), textureUploadBytes(0),
+  numBuffers(0), bufferBytes(0), numTextures(0), textureBytes(0), numPrograms(0)
+{
+}
+
+namespace
+{
+
+// A uniform or attribute pulled out of the shader source
+class HeadlessVariable
+{
+public:
+    std::string name;
+    GLenum type;
+    GLint size;
+};
+
+class HeadlessProgram
+{
+public:
+    std::vector<GLuint> shaders;
+    std::vector<HeadlessVariable> uniforms,attrs;
+};
+
+class HeadlessShader
+{
+public:
+    GLenum type;
+    std::string source;
+};
+
+// Everything the stub knows about.  Contexts can be shared between threads, so this is locked.
+class HeadlessState
+{
+public:
+    HeadlessState() : nextID(1), arrayBuffer(0), elementBuffer(0), texture(0), framebuffer(0), renderbuffer(0) { }
+
+    GLuint genID() { return nextID++; }
+
+    GLuint &boundBuffer(GLenum target) { return target == GL_ELEMENT_ARRAY_BUFFER ? elementBuffer : arrayBuffer; }
+
+    std::mutex lock;
+    GLuint nextID;
+    GLuint arrayBuffer,elementBuffer,texture,framebuffer,renderbuffer;
+    std::unordered_map<GLuint,uint64_t> buffers,textures;
+    std::unordered_map<GLuint,HeadlessShader> shaders;
+    std::unordered_map<GLuint,HeadlessProgram> programs;
+    std::unordered_map<GLenum,std::vector<unsigned char> > mapped;
+    GLESHeadlessStats stats;
+};
+
+HeadlessState &GetState()
+{
+    static HeadlessState *state = new HeadlessState();
+    return *state;
+}
+
+#define HEADLESS_CALL HeadlessState &state = GetState(); std::lock_guard<std::mutex> guardLock(state.lock); state.stats.calls++
+
+GLenum HeadlessType(const std::string &type)
+{
+    static const std::unordered_map<std::string,GLenum> types = {
+        {"float",GL_FLOAT}, {"vec2",GL_FLOAT_VEC2}, {"vec3",GL_FLOAT_VEC3}, {"vec4",GL_FLOAT_VEC4},
+        {"int",GL_INT}, {"ivec2",GL_INT_VEC2}, {"ivec3",GL_INT_VEC3}, {"ivec4",GL_INT_VEC4},
+        {"bool",GL_BOOL}, {"mat2",GL_FLOAT_MAT2}, {"mat3",GL_FLOAT_MAT3}, {"mat4",GL_FLOAT_MAT4},
+        {"sampler2D",GL_SAMPLER_2D}
+    };
+    auto it = types.find(type);
+    return it == types.end() ? 0 : it->second;
+}
+
+// Pick the uniforms and attributes out of the shader source, roughly as a real compiler would report them.
+// Structs aren't expanded, so their members won't be found.
+void HeadlessParseShader(const HeadlessShader &shader,HeadlessProgram &prog)
+{
+    std::string src;
+    src.reserve(shader.source.size());
+    for (size_t pos = 0;pos < shader.source.size();)
+    {
+        // Drop comments
+        if (shader.source.compare(pos,2,"//") == 0)
+        {
+            pos = shader.source.find('\n',pos);
+            if (pos == std::string::npos)
+                break;
+            continue;
+        }
+        src += shader.source[pos++];
+    }
+
+    for (size_t start = 0;start < src.size();)
+    {
+        size_t end = src.find_first_of(";{}",start);
+        if (end == std::string::npos)
+            end = src.size();
+
+        std::vector<std::string> tokens;
+        std::string token;
+        for (size_t ii=start;ii<end;ii++)
+        {
+            const char c = src[ii];
+            if (isspace(c) || c == '#')
+            {
+                if (!token.empty())
+                    tokens.push_back(token);
+                token.clear();
+                // Preprocessor lines aren't statements
+                if (c == '#')
+                {
+                    ii = src.find('\n',ii);
+                    if (ii == std::string::npos || ii >= end)
+                        break;
+                }
+            } else
+                token += c;
+        }
+        if (!token.empty())
+            tokens.push_back(token);
+        start = end+1;
+
+        if (tokens.size() < 3)
+            continue;
+        std::vector<HeadlessVariable> *vars = NULL;
+        if (tokens[0] == "uniform")
+            vars = &prog.uniforms;
+        else if (shader.type == GL_VERTEX_SHADER && (tokens[0] == "attribute" || tokens[0] == "in"))
+            vars = &prog.attrs;
+        if (!vars)
+            continue;
+        size_t which = 1;
+        while (which < tokens.size()-1 && (tokens[which] == "highp" || tokens[which] == "mediump" || tokens[which] == "lowp"))
+            which++;
+        const GLenum type = HeadlessType(tokens[which]);
+        if (!type || which+1 >= tokens.size())
+            continue;
+
+        HeadlessVariable var;
+        var.type = type;
+        var.size = 1;
+        var.name = tokens[which+1];
+        const size_t bracket = var.name.find('[');
+        if (bracket != std::string::npos)
+        {
+            var.size = std::max(1,atoi(var.name.c_str()+bracket+1));
+            var.name = var.name.substr(0,bracket) + "[0]";
+        }
+        bool found = false;
+        for (const auto &other : *vars)
+            found |= other.name == var.name;
+        if (!found)
+            vars->push_back(var);
+    }
+}
+
+uint64_t HeadlessTexBytes(GLsizei width,GLsizei height,GLenum format,GLenum type)
+{
+    int comps = 4;
+    switch (format)
+    {
+        case GL_ALPHA:
+        case GL_LUMINANCE:
+        case GL_DEPTH_COMPONENT:
+            comps = 1;
+            break;
+        case GL_RG:
+        case GL_LUMINANCE_ALPHA:
+            comps = 2;
+            break;
+        case GL_RGB:
+            comps = 3;
+            break;
+    }
+    int bytes = comps;
+    switch (type)
+    {
+        case GL_UNSIGNED_SHORT_4_4_4_4:
+        case GL_UNSIGNED_SHORT_5_5_5_1:
+        case GL_UNSIGNED_SHORT_5_6_5:
+            bytes = 2;
+            break;
+        case GL_UNSIGNED_SHORT:
+        case GL_SHORT:
+            bytes = 2 * comps;
+            break;
+        case GL_FLOAT:
+        case GL_INT:
+        case GL_UNSIGNED_INT:
+            bytes = 4 * comps;
+            break;
+    }
+
+    return (uint64_t)width * height * bytes;
+}
+
+void HeadlessSetTexture(HeadlessState &state,GLint level,uint64_t bytes)
+{
+    auto it = state.textures.find(state.texture);
+    if (it == state.textures.end())
+        return;
+    // Mipmap levels add to the base
+    if (level == 0)
+    {
+        state.stats.textureBytes -= it->second;
+        it->second = 0;
+    }
+    it->second += bytes;
+    state.stats.textureBytes += bytes;
+    state.stats.textureUploadBytes += bytes;
+}
+
+uint64_t HeadlessPrimitives(GLenum mode,GLsizei count)
+{
+    switch (mode)
+    {
+        case GL_TRIANGLES:
+            return count / 3;
+        case GL_TRIANGLE_STRIP:
+            return count > 2 ? count - 2 : 0;
+        case GL_LINES:
+            return count / 2;
+        default:
+            return count;
+    }
+}
+
+}
+
+GLESHeadlessStats GLESHeadlessGetStats()
+{
+    HeadlessState &state = GetState();
+    std::lock_guard<std::mutex> guardLock(state.lock);
+    return state.stats;
+}
+
+void GLESHeadlessResetCounts()
+{
+    HeadlessState &state = GetState();
+    std::lock_guard<std::mutex> guardLock(state.lock);
+    state.stats.calls = 0;
+    state.stats.drawCalls = 0;
+    state.stats.primitives = 0;
+    state.stats.uniformCalls = 0;
+    state.stats.bufferUploadBytes = 0;
+    state.stats.textureUploadBytes = 0;
+}
+
+extern "C" {
+
+// State we don't track
+
+void glActiveTexture(GLenum texture) { HEADLESS_CALL; }
+void glBeginTransformFeedback(GLenum primitiveMode) { HEADLESS_CALL; }
+void glBindBufferBase(GLenum target,GLuint index,GLuint buffer) { HEADLESS_CALL; }
+void glBindBufferRange(GLenum target,GLuint index,GLuint buffer,GLintptr offset,GLsizeiptr size) { HEADLESS_CALL; }
+void glBindVertexArray(GLuint array) { HEADLESS_CALL; }
+void glBlendFunc(GLenum sfactor,GLenum dfactor) { HEADLESS_CALL; }
+void glClear(GLbitfield mask) { HEADLESS_CALL; }
+void glClearColor(GLfloat red,GLfloat green,GLfloat blue,GLfloat alpha) { HEADLESS_CALL; }
+void glCompileShader(GLuint shader) { HEADLESS_CALL; }
+void glDepthFunc(GLenum func) { HEADLESS_CALL; }
+void glDepthMask(GLboolean flag) { HEADLESS_CALL; }
+void glDisable(GLenum cap) { HEADLESS_CALL; }
+void glDisableVertexAttribArray(GLuint index) { HEADLESS_CALL; }
+void glEnable(GLenum cap) { HEADLESS_CALL; }
+void glEnableVertexAttribArray(GLuint index) { HEADLESS_CALL; }
+void glEndTransformFeedback(void) { HEADLESS_CALL; }
+void glFinish(void) { HEADLESS_CALL; }
+void glFlush(void) { HEADLESS_CALL; }
+void glFramebufferRenderbuffer(GLenum target,GLenum attachment,GLenum renderbuffertarget,GLuint renderbuffer) { HEADLESS_CALL; }
+void glFramebufferTexture2D(GLenum target,GLenum attachment,GLenum textarget,GLuint texture,GLint level) { HEADLESS_CALL; }
+void glGenerateMipmap(GLenum target) { HEADLESS_CALL; }
+void glInvalidateFramebuffer(GLenum target,GLsizei numAttachments,const GLenum *attachments) { HEADLESS_CALL; }
+void glLineWidth(GLfloat width) { HEADLESS_CALL; }
+void glRenderbufferStorage(GLenum target,GLenum internalformat,GLsizei width,GLsizei height) { HEADLESS_CALL; }
+void glTexParameteri(GLenum target,GLenum pname,GLint param) { HEADLESS_CALL; }
+void glTransformFeedbackVaryings(GLuint program,GLsizei count,const GLchar *const*varyings,GLenum bufferMode) { HEADLESS_CALL; }
+void glUseProgram(GLuint program) { HEADLESS_CALL; }
+void glVertexAttribDivisor(GLuint index,GLuint divisor) { HEADLESS_CALL; }
+void glVertexAttribPointer(GLuint index,GLint size,GLenum type,GLboolean normalized,GLsizei stride,const void *pointer) { HEADLESS_CALL; }
+void glViewport(GLint x,GLint y,GLsizei width,GLsizei height) { HEADLESS_CALL; }
+
+GLenum glGetError(void) { return GL_NO_ERROR; }
+GLenum glCheckFramebufferStatus(GLenum target) { HEADLESS_CALL; return GL_FRAMEBUFFER_COMPLETE; }
+
+// Uniforms and attributes
+
+void glUniform1f(GLint location,GLfloat v0) { HEADLESS_CALL; state.stats.uniformCalls++; }
+void glUniform1i(GLint location,GLint v0) { HEADLESS_CALL; state.stats.uniformCalls++; }
+void glUniform2f(GLint location,GLfloat v0,GLfloat v1) { HEADLESS_CALL; state.stats.uniformCalls++; }
+void glUniform3f(GLint location,GLfloat v0,GLfloat v1,GLfloat v2) { HEADLESS_CALL; state.stats.uniformCalls++; }
+void glUniform4f(GLint location,GLfloat v0,GLfloat v1,GLfloat v2,GLfloat v3) { HEADLESS_CALL; state.stats.uniformCalls++; }
+void glUniformMatrix4fv(GLint location,GLsizei count,GLboolean transpose,const GLfloat *value) { HEADLESS_CALL; state.stats.uniformCalls++; }
+void glVertexAttrib1f(GLuint index,GLfloat x) { HEADLESS_CALL; state.stats.uniformCalls++; }
+void glVertexAttrib2f(GLuint index,GLfloat x,GLfloat y) { HEADLESS_CALL; state.stats.uniformCalls++; }
+void glVertexAttrib3f(GLuint index,GLfloat x,GLfloat y,GLfloat z) { HEADLESS_CALL; state.stats.uniformCalls++; }
+void glVertexAttrib4f(GLuint index,GLfloat x,GLfloat y,GLfloat z,GLfloat w) { HEADLESS_CALL; state.stats.uniformCalls++; }
+
+// Drawing
+
+void glDrawArrays(GLenum mode,GLint first,GLsizei count)
+{
+    HEADLESS_CALL;
+    state.stats.drawCalls++;
+    state.stats.primitives += HeadlessPrimitives(mode, count);
+}
+
+void glDrawArraysInstanced(GLenum mode,GLint first,GLsizei count,GLsizei instancecount)
+{
+    HEADLESS_CALL;
+    state.stats.drawCalls++;
+    state.stats.primitives += HeadlessPrimitives(mode, count) * instancecount;
+}
+
+void glDrawElements(GLenum mode,GLsizei count,GLenum type,const void *indices)
+{
+    HEADLESS_CALL;
+    state.stats.drawCalls++;
+    state.stats.primitives += HeadlessPrimitives(mode, count);
+}
+
+void glDrawElementsInstanced(GLenum mode,GLsizei count,GLenum type,const void *indices,GLsizei instancecount)
+{
+    HEADLESS_CALL;
+    state.stats.drawCalls++;
+    state.stats.primitives += HeadlessPrimitives(mode, count) * instancecount;
+}
+
+void glReadPixels(GLint x,GLint y,GLsizei width,GLsizei height,GLenum format,GLenum type,void *pixels)
+{
+    HEADLESS_CALL;
+    if (pixels)
+        memset(pixels, 0, HeadlessTexBytes(width, height, format, type));
+}
+
+void glGetIntegerv(GLenum pname,GLint *data)
+{
+    HEADLESS_CALL;
+    switch (pname)
+    {
+        case GL_FRAMEBUFFER_BINDING:
+            *data = state.framebuffer;
+            break;
+        case GL_RENDERBUFFER_BINDING:
+            *data = state.renderbuffer;
+            break;
+        default:
+            *data = 0;
+            break;
+    }
+}
+
+// Buffers
+
+void glGenBuffers(GLsizei n,GLuint *buffers)
+{
+    HEADLESS_CALL;
+    for (int ii=0;ii<n;ii++)
+    {
+        buffers[ii] = state.genID();
+        state.buffers[buffers[ii]] = 0;
+        state.stats.numBuffers++;
+    }
+}
+
+void glDeleteBuffers(GLsizei n,const GLuint *buffers)
+{
+    HEADLESS_CALL;
+    for (int ii=0;ii<n;ii++)
+    {
+        auto it = state.buffers.find(buffers[ii]);
+        if (it == state.buffers.end())
+            continue;
+        state.stats.bufferBytes -= it->second;
+        state.stats.numBuffers--;
+        state.buffers.erase(it);
+    }
+}
+
+void glBindBuffer(GLenum target,GLuint buffer)
+{
+    HEADLESS_CALL;
+    state.boundBuffer(target) = buffer;
+}
+
+void glBufferData(GLenum target,GLsizeiptr size,const void *data,GLenum usage)
+{
+    HEADLESS_CALL;
+    auto it = state.buffers.find(state.boundBuffer(target));
+    if (it == state.buffers.end())
+        return;
+    state.stats.bufferBytes += size - it->second;
+    it->second = size;
+    if (data)
+        state.stats.bufferUploadBytes += size;
+}
+
+void glBufferSubData(GLenum target,GLintptr offset,GLsizeiptr size,const void *data)
+{
+    HEADLESS_CALL;
+    state.stats.bufferUploadBytes += size;
+}
+
+void *glMapBufferRange(GLenum target,GLintptr offset,GLsizeiptr length,GLbitfield access)
+{
+    HEADLESS_CALL;
+    std::vector<unsigned char> &mapped = state.mapped[target];
+    mapped.resize(length);
+    return mapped.data();
+}
+
+void *glMapBufferOES(GLenum target,GLenum access)
+{
+    HEADLESS_CALL;
+    auto it = state.buffers.find(state.boundBuffer(target));
+    std::vector<unsigned char> &mapped = state.mapped[target];
+    mapped.resize(it == state.buffers.end() ? 0 : it->second);
+    return mapped.data();
+}
+
+GLboolean glUnmapBuffer(GLenum target)
+{
+    HEADLESS_CALL;
+    std::vector<unsigned char> &mapped = state.mapped[target];
+    state.stats.bufferUploadBytes += mapped.size();
+    mapped.clear();
+    return GL_TRUE;
+}
+
+GLboolean glUnmapBufferOES(GLenum target)
+{
+    return glUnmapBuffer(target);
+}
+
+// Textures
+
+void glGenTextures(GLsizei n,GLuint *textures)
+{
+    HEADLESS_CALL;
+    for (int ii=0;ii<n;ii++)
+    {
+        textures[ii] = state.genID();
+        state.textures[textures[ii]] = 0;
+        state.stats.numTextures++;
+    }
+}
+
+void glDeleteTextures(GLsizei n,const GLuint *textures)
+{
+    HEADLESS_CALL;
+    for (int ii=0;ii<n;ii++)
+    {
+        auto it = state.textures.find(textures[ii]);
+        if (it == state.textures.end())
+            continue;
+        state.stats.textureBytes -= it->second;
+        state.stats.numTextures--;
+        state.textures.erase(it);
+    }
+}
+
+void glBindTexture(GLenum target,GLuint texture)
+{
+    HEADLESS_CALL;
+    state.texture = texture;
+}
+
+void glTexImage2D(GLenum target,GLint level,GLint internalformat,GLsizei width,GLsizei height,GLint border,GLenum format,GLenum type,const void *pixels)
+{
+    HEADLESS_CALL;
+    HeadlessSetTexture(state, level, HeadlessTexBytes(width, height, format, type));
+}
+
+void glTexSubImage2D(GLenum target,GLint level,GLint xoffset,GLint yoffset,GLsizei width,GLsizei height,GLenum format,GLenum type,const void *pixels)
+{
+    HEADLESS_CALL;
+    state.stats.textureUploadBytes += HeadlessTexBytes(width, height, format, type);
+}
+
+void glCompressedTexImage2D(GLenum target,GLint level,GLenum internalformat,GLsizei width,GLsizei height,GLint border,GLsizei imageSize,const void *data)
+{
+    HEADLESS_CALL;
+    HeadlessSetTexture(state, level, imageSize);
+}
+
+void glCompressedTexSubImage2D(GLenum target,GLint level,GLint xoffset,GLint yoffset,GLsizei width,GLsizei height,GLenum format,GLsizei imageSize,const void *data)
+{
+    HEADLESS_CALL;
+    state.stats.textureUploadBytes += imageSize;
+}
+
+// Framebuffers and renderbuffers
+
+void glGenFramebuffers(GLsizei n,GLuint *framebuffers)
+{
+    HEADLESS_CALL;
+    for (int ii=0;ii<n;ii++)
+        framebuffers[ii] = state.genID();
+}
+
+void glDeleteFramebuffers(GLsizei n,const GLuint *framebuffers) { HEADLESS_CALL; }
+
+void glBindFramebuffer(GLenum target,GLuint framebuffer)
+{
+    HEADLESS_CALL;
+    state.framebuffer = framebuffer;
+}
+
+void glGenRenderbuffers(GLsizei n,GLuint *renderbuffers)
+{
+    HEADLESS_CALL;
+    for (int ii=0;ii<n;ii++)
+        renderbuffers[ii] = state.genID();
+}
+
+void glDeleteRenderbuffers(GLsizei n,const GLuint *renderbuffers) { HEADLESS_CALL; }
+
+void glBindRenderbuffer(GLenum target,GLuint renderbuffer)
+{
+    HEADLESS_CALL;
+    state.renderbuffer = renderbuffer;
+}
+
+void glGenVertexArrays(GLsizei n,GLuint *arrays)
+{
+    HEADLESS_CALL;
+    for (int ii=0;ii<n;ii++)
+        arrays[ii] = state.genID();
+}
+
+void glDeleteVertexArrays(GLsizei n,const GLuint *arrays) { HEADLESS_CALL; }
+
+// Shaders and programs
+
+GLuint glCreateShader(GLenum type)
+{
+    HEADLESS_CALL;
+    const GLuint shader = state.genID();
+    state.shaders[shader].type = type;
+    return shader;
+}
+
+void glDeleteShader(GLuint shader)
+{
+    HEADLESS_CALL;
+    state.shaders.erase(shader);
+}
+
+void glShaderSource(GLuint shader,GLsizei count,const GLchar *const*string,const GLint *length)
+{
+    HEADLESS_CALL;
+    auto it = state.shaders.find(shader);
+    if (it == state.shaders.end())
+        return;
+    it->second.source.clear();
+    for (int ii=0;ii<count;ii++)
+    {
+        if (length && length[ii] >= 0)
+            it->second.source.append(string[ii],length[ii]);
+        else
+            it->second.source.append(string[ii]);
+    }
+}
+
+void glGetShaderiv(GLuint shader,GLenum pname,GLint *params)
+{
+    HEADLESS_CALL;
+    *params = (pname == GL_COMPILE_STATUS) ? GL_TRUE : 0;
+}
+
+void glGetShaderInfoLog(GLuint shader,GLsizei bufSize,GLsizei *length,GLchar *infoLog)
+{
+    HEADLESS_CALL;
+    if (length)
+        *length = 0;
+    if (infoLog && bufSize > 0)
+        infoLog[0] = 0;
+}
+
+GLuint glCreateProgram(void)
+{
+    HEADLESS_CALL;
+    const GLuint program = state.genID();
+    state.programs[program];
+    state.stats.numPrograms++;
+    return program;
+}
+
+void glDeleteProgram(GLuint program)
+{
+    HEADLESS_CALL;
+    if (state.programs.erase(program))
+        state.stats.numPrograms--;
+}
+
+void glAttachShader(GLuint program,GLuint shader)
+{
+    HEADLESS_CALL;
+    auto it = state.programs.find(program);
+    if (it != state.programs.end())
+        it->second.shaders.push_back(shader);
+}
+
+void glLinkProgram(GLuint program)
+{
+    HEADLESS_CALL;
+    auto it = state.programs.find(program);
+    if (it == state.programs.end())
+        return;
+    HeadlessProgram &prog = it->second;
+    prog.uniforms.clear();
+    prog.attrs.clear();
+    for (GLuint shader : prog.shaders)
+    {
+        auto sit = state.shaders.find(shader);
+        if (sit != state.shaders.end())
+            HeadlessParseShader(sit->second, prog);
+    }
+}
+
+void glGetProgramiv(GLuint program,GLenum pname,GLint *params)
+{
+    HEADLESS_CALL;
+    auto it = state.programs.find(program);
+    switch (pname)
+    {
+        case GL_LINK_STATUS:
+            *params = it != state.programs.end() ? GL_TRUE : GL_FALSE;
+            break;
+        case GL_ACTIVE_UNIFORMS:
+            *params = it != state.programs.end() ? (GLint)it->second.uniforms.size() : 0;
+            break;
+        case GL_ACTIVE_ATTRIBUTES:
+            *params = it != state.programs.end() ? (GLint)it->second.attrs.size() : 0;
+            break;
+        default:
+            *params = 0;
+            break;
+    }
+}
+
+void glGetProgramInfoLog(GLuint program,GLsizei bufSize,GLsizei *length,GLchar *infoLog)
+{
+    HEADLESS_CALL;
+    if (length)
+        *length = 0;
+    if (infoLog && bufSize > 0)
+        infoLog[0] = 0;
+}
+
+static void HeadlessGetActive(const std::vector<HeadlessVariable> &vars,GLuint index,GLsizei bufSize,GLsizei *length,GLint *size,GLenum *type,GLchar *name)
+{
+    if (index >= vars.size())
+        return;
+    const HeadlessVariable &var = vars[index];
+    const size_t len = std::min((size_t)std::max(bufSize-1,0),var.name.size());
+    if (name && bufSize > 0)
+    {
+        memcpy(name, var.name.c_str(), len);
+        name[len] = 0;
+    }
+    if (length)
+        *length = (GLsizei)len;
+    if (size)
+        *size = var.size;
+    if (type)
+        *type = var.type;
+}
+
+static GLint HeadlessLocation(const std::vector<HeadlessVariable> &vars,const GLchar *name)
+{
+    const std::string nameStr(name);
+    for (unsigned int ii=0;ii<vars.size();ii++)
+    {
+        const std::string &varName = vars[ii].name;
+        if (varName == nameStr)
+            return ii;
+        // Arrays can be looked up by their base name too
+        if (varName.size() > 3 && varName.compare(varName.size()-3,3,"[0]") == 0 &&
+            varName.compare(0,varName.size()-3,nameStr) == 0)
+            return ii;
+    }
+    return -1;
+}
+
+void glGetActiveUniform(GLuint program,GLuint index,GLsizei bufSize,GLsizei *length,GLint *size,GLenum *type,GLchar *name)
+{
+    HEADLESS_CALL;
+    auto it = state.programs.find(program);
+    if (it != state.programs.end())
+        HeadlessGetActive(it->second.uniforms, index, bufSize, length, size, type, name);
+}
+
+void glGetActiveAttrib(GLuint program,GLuint index,GLsizei bufSize,GLsizei *length,GLint *size,GLenum *type,GLchar *name)
+{
+    HEADLESS_CALL;
+    auto it = state.programs.find(program);
+    if (it != state.programs.end())
+        HeadlessGetActive(it->second.attrs, index, bufSize, length, size, type, name);
+}
+
+GLint glGetUniformLocation(GLuint program,const GLchar *name)
+{
+    HEADLESS_CALL;
+    auto it = state.programs.find(program);
+    return it != state.programs.end() ? HeadlessLocation(it->second.uniforms, name) : -1;
+}
+
+GLint glGetAttribLocation(GLuint program,const GLchar *name)
+{
+    HEADLESS_CALL;
+    auto it = state.programs.find(program);
+    return it != state.programs.end() ? HeadlessLocation(it->second.attrs, name) : -1;
+}
+
+}
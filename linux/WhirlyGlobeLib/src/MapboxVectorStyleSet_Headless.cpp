@@ -0,0 +1,83 @@
+/*
+ *  MapboxVectorStyleSet_Headless.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import "MapboxVectorStyleSet_Headless.h"
+
+namespace WhirlyKit
+{
+
+std::vector<DrawableString *> SingleLabel_Headless::generateDrawableStrings(PlatformThreadInfo *threadInfo,const LabelInfo *,FontTextureManager *fontTexManager,float &lineHeight,ChangeSet &changes)
+{
+    return std::vector<DrawableString *>();
+}
+
+MapboxVectorStyleSetImpl_Headless::MapboxVectorStyleSetImpl_Headless(Scene *scene,CoordSystem *coordSys,VectorStyleSettingsImplRef settings)
+: MapboxVectorStyleSetImpl(scene,coordSys,settings)
+{
+}
+
+MapboxVectorStyleSetImpl_Headless::~MapboxVectorStyleSetImpl_Headless()
+{
+}
+
+SimpleIdentity MapboxVectorStyleSetImpl_Headless::makeCircleTexture(PlatformThreadInfo *inInst,
+        double radius,
+        const RGBAColor &fillColor,
+        const RGBAColor &strokeColor,
+        float strokeWidth,
+        Point2f *circleSize)
+{
+    return EmptyIdentity;
+}
+
+SimpleIdentity MapboxVectorStyleSetImpl_Headless::makeLineTexture(PlatformThreadInfo *inInst,const std::vector<double> &dashComponents)
+{
+    return EmptyIdentity;
+}
+
+LabelInfoRef MapboxVectorStyleSetImpl_Headless::makeLabelInfo(PlatformThreadInfo *inInst,const std::string &fontName,float fontSize)
+{
+    LabelInfoRef labelInfo(new LabelInfo(true));
+    labelInfo->fontPointSize = fontSize;
+    labelInfo->programID = screenMarkerProgramID;
+
+    return labelInfo;
+}
+
+SingleLabelRef MapboxVectorStyleSetImpl_Headless::makeSingleLabel(PlatformThreadInfo *inInst,const std::string &text)
+{
+    return SingleLabelRef(new SingleLabel_Headless());
+}
+
+ComponentObjectRef MapboxVectorStyleSetImpl_Headless::makeComponentObject(PlatformThreadInfo *inInst)
+{
+    return ComponentObjectRef(new ComponentObject());
+}
+
+double MapboxVectorStyleSetImpl_Headless::calculateTextWidth(PlatformThreadInfo *inInst,LabelInfoRef labelInfo,const std::string &text)
+{
+    return 0.5 * labelInfo->fontPointSize * text.size();
+}
+
+void MapboxVectorStyleSetImpl_Headless::addSelectionObject(SimpleIdentity selectID,VectorObjectRef vecObj,ComponentObjectRef compObj)
+{
+}
+
+}
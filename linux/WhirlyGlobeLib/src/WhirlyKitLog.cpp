@@ -0,0 +1,55 @@
+/*
+ *  WhirlyKitLog.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <cstdio>
+#import <cstdarg>
+#import <stdlib.h>
+#import "WhirlyKitLog.h"
+
+// Anything below this isn't printed.  Benchmarks don't want the chatter.
+static WKLogLevel minLogLevel = Info;
+
+static const char *levels[] = {"Verbose","Debug","Info","Warn","Error"};
+
+void wkLog(const char *formatStr,...)
+{
+    va_list args;
+
+    va_start(args, formatStr);
+    fprintf(stderr, "Maply: ");
+    vfprintf(stderr, formatStr, args);
+    fprintf(stderr, "\n");
+    va_end(args);
+}
+
+void wkLogLevel(WKLogLevel level,const char *formatStr,...)
+{
+    if (level < minLogLevel)
+        return;
+
+    va_list args;
+    va_start(args, formatStr);
+
+    fprintf(stderr, "Maply %s: ", (level >= Verbose && level <= Error) ? levels[level] : "");
+    vfprintf(stderr, formatStr, args);
+    fprintf(stderr, "\n");
+
+    va_end(args);
+}
@@ -0,0 +1,42 @@
+/*
+ *  platform.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <time.h>
+#import "Platform.h"
+
+namespace WhirlyKit
+{
+
+// Return current time in seconds as a double
+TimeInterval TimeGetCurrent()
+{
+    struct timespec tp;
+    clock_gettime(CLOCK_REALTIME, &tp);
+
+    return (double)tp.tv_sec + tp.tv_nsec * (double)1e-9;
+}
+
+// Nothing to scale for offscreen rendering
+float DeviceScreenScale()
+{
+    return 1.0;
+}
+
+}
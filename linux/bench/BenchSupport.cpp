@@ -0,0 +1,304 @@
+/*
+ *  BenchSupport.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <stdio.h>
+#import <string.h>
+#import <zlib.h>
+#import <algorithm>
+#import "BenchSupport.h"
+
+namespace WhirlyKit
+{
+
+const char *BenchDefaultStyle = R"({
+  "version": 8,
+  "name": "Bench",
+  "layers": [
+    {"id": "background", "type": "background", "paint": {"background-color": "#f2efe9"}},
+    {"id": "water", "type": "fill", "source-layer": "water", "paint": {"fill-color": "#a0c8f0"}},
+    {"id": "park", "type": "fill", "source-layer": "landuse", "filter": ["==", "class", "park"],
+     "paint": {"fill-color": "#c8e6a0", "fill-outline-color": "#a0c880"}},
+    {"id": "residential", "type": "fill", "source-layer": "landuse", "filter": ["==", "class", "residential"],
+     "paint": {"fill-color": "#e8e0d8"}},
+    {"id": "building", "type": "fill", "source-layer": "building", "minzoom": 13,
+     "paint": {"fill-color": "#d8d0c8", "fill-outline-color": "#c0b8b0"}},
+    {"id": "road-minor", "type": "line", "source-layer": "road", "filter": ["==", "class", "minor"],
+     "paint": {"line-color": "#ffffff", "line-width": {"base": 1.4, "stops": [[10, 0.5], [18, 12]]}}},
+    {"id": "road-major", "type": "line", "source-layer": "road", "filter": ["in", "class", "primary", "motorway"],
+     "layout": {"line-join": "round"},
+     "paint": {"line-color": "#f8c060", "line-width": {"base": 1.4, "stops": [[5, 1], [18, 20]]}}},
+    {"id": "label", "type": "symbol", "source-layer": "place",
+     "layout": {"text-field": "{name}", "text-size": 12}}
+  ]
+})";
+
+double BenchStage::total() const
+{
+    double sum = 0.0;
+    for (double sample : samples)
+        sum += sample;
+    return sum;
+}
+
+double BenchStage::percentile(double p) const
+{
+    if (samples.empty())
+        return 0.0;
+    std::vector<double> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    return sorted[std::min(sorted.size()-1,(size_t)(p * sorted.size()))];
+}
+
+void BenchStage::report() const
+{
+    if (samples.empty())
+    {
+        printf("%-14s %8d\n", name.c_str(), 0);
+        return;
+    }
+    const double sum = total();
+    printf("%-14s %8d %10.1f %8.3f %8.3f %8.3f %8.3f\n", name.c_str(), (int)samples.size(), sum,
+           sum / samples.size(), percentile(0.5), percentile(0.95), percentile(1.0));
+}
+
+double BenchSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::vector<unsigned char> SyntheticTileSource::makeTile(const QuadTreeIdentifier &ident)
+{
+    std::mt19937 rng((unsigned int)(seed * 73856093) ^ (ident.x * 19349663) ^ (ident.y * 83492791) ^ (ident.level * 2654435761u));
+    vector_tile::Tile tile;
+
+    // Detail goes up with the zoom level, as with real data
+    const int detail = std::min(ident.level,14);
+
+    vector_tile::Tile_Layer *water = startLayer(tile, "water");
+    for (int ii=0;ii<1+detail/4;ii++)
+        addPolygon(water, rng, 400 + rng() % 1200, 24 + detail * 4, -1);
+
+    vector_tile::Tile_Layer *landuse = startLayer(tile, "landuse");
+    landuse->add_keys("class");
+    landuse->add_values()->set_string_value("park");
+    landuse->add_values()->set_string_value("residential");
+    const int blocks = 2 + detail;
+    for (int ix=0;ix<blocks;ix++)
+        for (int iy=0;iy<blocks;iy++)
+        {
+            if (rng() % 3 == 0)
+                continue;
+            const int cell = 4096 / blocks;
+            addRect(landuse, ix * cell + 8, iy * cell + 8, cell - 16, cell - 16, rng() % 2);
+        }
+
+    vector_tile::Tile_Layer *road = startLayer(tile, "road");
+    road->add_keys("class");
+    road->add_values()->set_string_value("motorway");
+    road->add_values()->set_string_value("primary");
+    road->add_values()->set_string_value("minor");
+    for (int ii=0;ii<4+detail*6;ii++)
+        addLine(road, rng, 2 + rng() % (4 + detail), ii < 2 ? 0 : (ii < 6 ? 1 : 2));
+
+    if (ident.level >= 12)
+    {
+        vector_tile::Tile_Layer *building = startLayer(tile, "building");
+        for (int ii=0;ii<detail*30;ii++)
+            addRect(building, rng() % 4000, rng() % 4000, 10 + rng() % 80, 10 + rng() % 80, -1);
+    }
+
+    vector_tile::Tile_Layer *place = startLayer(tile, "place");
+    place->add_keys("name");
+    for (int ii=0;ii<1+detail/2;ii++)
+    {
+        place->add_values()->set_string_value("Place " + std::to_string(ii));
+        vector_tile::Tile_Feature *feat = place->add_features();
+        feat->set_type(vector_tile::Tile_GeomType_POINT);
+        feat->add_tags(0);
+        feat->add_tags(ii);
+        feat->add_geometry(command(1,1));
+        feat->add_geometry(zigzag(rng() % 4096));
+        feat->add_geometry(zigzag(rng() % 4096));
+    }
+
+    std::string data;
+    tile.SerializeToString(&data);
+    return std::vector<unsigned char>(data.begin(),data.end());
+}
+
+vector_tile::Tile_Layer *SyntheticTileSource::startLayer(vector_tile::Tile &tile,const char *name)
+{
+    vector_tile::Tile_Layer *layer = tile.add_layers();
+    layer->set_version(2);
+    layer->set_name(name);
+    layer->set_extent(4096);
+    return layer;
+}
+
+// Geometry is relative to the last point, which carries across parts
+void SyntheticTileSource::addRing(vector_tile::Tile_Feature *feat,const std::vector<Eigen::Vector2i> &pts,int &lastX,int &lastY)
+{
+    feat->add_geometry(command(1,1));
+    feat->add_geometry(zigzag(pts[0].x()-lastX));
+    feat->add_geometry(zigzag(pts[0].y()-lastY));
+    feat->add_geometry(command(2,(int)pts.size()-1));
+    for (unsigned int ii=1;ii<pts.size();ii++)
+    {
+        feat->add_geometry(zigzag(pts[ii].x()-pts[ii-1].x()));
+        feat->add_geometry(zigzag(pts[ii].y()-pts[ii-1].y()));
+    }
+    lastX = pts.back().x();  lastY = pts.back().y();
+}
+
+void SyntheticTileSource::addTag(vector_tile::Tile_Feature *feat,int value)
+{
+    if (value < 0)
+        return;
+    feat->add_tags(0);
+    feat->add_tags(value);
+}
+
+void SyntheticTileSource::addRect(vector_tile::Tile_Layer *layer,int x,int y,int width,int height,int value)
+{
+    vector_tile::Tile_Feature *feat = layer->add_features();
+    feat->set_type(vector_tile::Tile_GeomType_POLYGON);
+    addTag(feat, value);
+    // Clockwise in tile coordinates (y down) is an outer ring
+    std::vector<Eigen::Vector2i> pts = {Eigen::Vector2i(x,y),Eigen::Vector2i(x+width,y),Eigen::Vector2i(x+width,y+height),Eigen::Vector2i(x,y+height)};
+    int lastX = 0, lastY = 0;
+    addRing(feat, pts, lastX, lastY);
+    feat->add_geometry(command(7,1));
+}
+
+// A lumpy blob around a random center
+void SyntheticTileSource::addPolygon(vector_tile::Tile_Layer *layer,std::mt19937 &rng,int radius,int numPts,int value)
+{
+    vector_tile::Tile_Feature *feat = layer->add_features();
+    feat->set_type(vector_tile::Tile_GeomType_POLYGON);
+    addTag(feat, value);
+    const int cx = rng() % 4096, cy = rng() % 4096;
+    std::vector<Eigen::Vector2i> pts;
+    for (int ii=0;ii<numPts;ii++)
+    {
+        const double ang = 2.0 * M_PI * ii / numPts;
+        const double rad = radius * (0.6 + 0.4 * (rng() % 1000) / 1000.0);
+        pts.push_back(Eigen::Vector2i(cx + (int)(rad * cos(ang)),cy + (int)(rad * sin(ang))));
+    }
+    int lastX = 0, lastY = 0;
+    addRing(feat, pts, lastX, lastY);
+    feat->add_geometry(command(7,1));
+}
+
+// A wandering line that may wander off the tile, as roads do
+void SyntheticTileSource::addLine(vector_tile::Tile_Layer *layer,std::mt19937 &rng,int numPts,int value)
+{
+    vector_tile::Tile_Feature *feat = layer->add_features();
+    feat->set_type(vector_tile::Tile_GeomType_LINESTRING);
+    addTag(feat, value);
+    std::vector<Eigen::Vector2i> pts;
+    Eigen::Vector2i pt(rng() % 4096,rng() % 4096);
+    const double dir = 2.0 * M_PI * (rng() % 1000) / 1000.0;
+    for (int ii=0;ii<numPts;ii++)
+    {
+        pts.push_back(pt);
+        const double ang = dir + ((int)(rng() % 1000) - 500) / 1000.0;
+        const int len = 100 + rng() % 600;
+        pt = Eigen::Vector2i(pt.x() + (int)(len * cos(ang)),pt.y() + (int)(len * sin(ang)));
+    }
+    int lastX = 0, lastY = 0;
+    addRing(feat, pts, lastX, lastY);
+}
+
+bool ReadTileFile(const std::string &fileName,std::vector<unsigned char> &data)
+{
+    FILE *fp = fopen(fileName.c_str(), "rb");
+    if (!fp)
+        return false;
+    std::vector<unsigned char> raw;
+    unsigned char buf[64*1024];
+    size_t len;
+    while ((len = fread(buf, 1, sizeof(buf), fp)) > 0)
+        raw.insert(raw.end(), buf, buf+len);
+    fclose(fp);
+
+    if (raw.size() < 2 || raw[0] != 0x1f || raw[1] != 0x8b)
+    {
+        data.swap(raw);
+        return true;
+    }
+
+    z_stream strm;
+    memset(&strm, 0, sizeof(strm));
+    if (inflateInit2(&strm, 16+MAX_WBITS) != Z_OK)
+        return false;
+    strm.next_in = raw.data();
+    strm.avail_in = (uInt)raw.size();
+    data.clear();
+    int ret = Z_OK;
+    while (ret == Z_OK)
+    {
+        strm.next_out = buf;
+        strm.avail_out = sizeof(buf);
+        ret = inflate(&strm, Z_NO_FLUSH);
+        data.insert(data.end(), buf, buf + sizeof(buf) - strm.avail_out);
+    }
+    inflateEnd(&strm);
+
+    return ret == Z_STREAM_END;
+}
+
+bool WriteTileFile(const std::string &fileName,const std::vector<unsigned char> &data)
+{
+    FILE *fp = fopen(fileName.c_str(), "wb");
+    if (!fp)
+        return false;
+    const bool ret = fwrite(data.data(), 1, data.size(), fp) == data.size();
+    fclose(fp);
+
+    return ret;
+}
+
+std::string BenchAndroidAssetDir()
+{
+    const std::string srcFile = __FILE__;
+    const std::string srcDir = srcFile.substr(0,srcFile.find_last_of('/')+1);
+    return srcDir + "../../android/apps/AutoTesterAndroid/app/src/main/assets/";
+}
+
+void BenchAddPrograms(Scene *scene,SceneRendererGLES *renderer)
+{
+    const std::vector<std::pair<std::string,ProgramGLES *> > programs = {
+        {MaplyNoBackfaceLineShader,BuildDefaultLineShaderNoCullingGLES(MaplyNoBackfaceLineShader,renderer)},
+        {MaplyDefaultLineShader,BuildDefaultLineShaderNoCullingGLES(MaplyDefaultLineShader,renderer)},
+        {MaplyDefaultTriangleShader,BuildDefaultTriShaderLightingGLES(MaplyDefaultTriangleShader,renderer)},
+        {MaplyNoLightTriangleShader,BuildDefaultTriShaderNoLightingGLES(MaplyNoLightTriangleShader,renderer)},
+        {MaplyDefaultTriMultiTexShader,BuildDefaultTriShaderMultitexGLES(MaplyDefaultTriMultiTexShader,renderer)},
+        {MaplyDefaultWideVectorShader,BuildWideVectorProgramGLES(MaplyDefaultWideVectorShader,renderer)},
+        {MaplyScreenSpaceDefaultShader,BuildScreenSpaceProgramGLES(MaplyScreenSpaceDefaultShader,renderer)},
+        {MaplyScreenSpaceDefaultMotionShader,BuildScreenSpaceMotionProgramGLES(MaplyScreenSpaceDefaultMotionShader,renderer)},
+        {MaplyScreenSpaceSDFShader,BuildScreenSpaceSDFProgramGLES(MaplyScreenSpaceSDFShader,renderer)},
+        {MaplyScreenSpaceSDFMotionShader,BuildScreenSpaceSDFMotionProgramGLES(MaplyScreenSpaceSDFMotionShader,renderer)}
+    };
+    for (auto prog : programs)
+        if (prog.second)
+            scene->addProgram(ProgramRef(prog.second));
+}
+
+}
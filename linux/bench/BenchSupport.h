@@ -0,0 +1,97 @@
+/*
+ *  BenchSupport.h
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <chrono>
+#import <random>
+#import <string>
+#import <vector>
+#import "WhirlyGlobe.h"
+
+namespace WhirlyKit
+{
+
+/// Mapbox GL style that matches the layers in the synthetic tiles
+extern const char *BenchDefaultStyle;
+
+/// Times for one stage of the engine, one sample per call
+class BenchStage
+{
+public:
+    BenchStage(const std::string &name) : name(name) { }
+
+    void add(double ms) { samples.push_back(ms); }
+
+    /// Total of all the samples
+    double total() const;
+
+    /// Sample at the given fraction (0-1) of the way through the sorted samples
+    double percentile(double p) const;
+
+    /// Print a row of the stage table
+    void report() const;
+
+    std::string name;
+    std::vector<double> samples;
+};
+
+/// Milliseconds since the given time
+double BenchSince(std::chrono::steady_clock::time_point start);
+
+/** Builds Mapbox Vector Tiles with roughly the mix of features a city map has.
+    The contents only depend on the tile ID and the seed.
+  */
+class SyntheticTileSource
+{
+public:
+    SyntheticTileSource(int seed) : seed(seed) { }
+
+    /// Encoded tile for the given ID
+    std::vector<unsigned char> makeTile(const QuadTreeIdentifier &ident);
+
+protected:
+    static uint32_t command(int cmd,int count) { return (cmd & 0x7) | (count << 3); }
+    static uint32_t zigzag(int val) { return (val << 1) ^ (val >> 31); }
+
+    vector_tile::Tile_Layer *startLayer(vector_tile::Tile &tile,const char *name);
+    // Geometry is relative to the last point, which carries across parts
+    void addRing(vector_tile::Tile_Feature *feat,const std::vector<Eigen::Vector2i> &pts,int &lastX,int &lastY);
+    void addTag(vector_tile::Tile_Feature *feat,int value);
+    void addRect(vector_tile::Tile_Layer *layer,int x,int y,int width,int height,int value);
+    // A lumpy blob around a random center
+    void addPolygon(vector_tile::Tile_Layer *layer,std::mt19937 &rng,int radius,int numPts,int value);
+    // A wandering line that may wander off the tile, as roads do
+    void addLine(vector_tile::Tile_Layer *layer,std::mt19937 &rng,int numPts,int value);
+
+    int seed;
+};
+
+/// Read a whole file, unzipping it if need be
+bool ReadTileFile(const std::string &fileName,std::vector<unsigned char> &data);
+
+/// Write a whole file
+bool WriteTileFile(const std::string &fileName,const std::vector<unsigned char> &data);
+
+/// Assets for the Android AutoTester, which has some GeoJSON we can use.  Found relative to the source.
+std::string BenchAndroidAssetDir();
+
+/// Add the shaders the Mapbox styles look for to the scene
+void BenchAddPrograms(Scene *scene,SceneRendererGLES *renderer);
+
+}
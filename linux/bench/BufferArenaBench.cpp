@@ -0,0 +1,230 @@
+/*
+ *  BufferArenaBench.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <math.h>
+#import <stdio.h>
+#import <stdlib.h>
+#import <chrono>
+#import <deque>
+#import <map>
+#import <random>
+#import <set>
+#import <string>
+#import <vector>
+#import "WhirlyGlobe.h"
+#import "BufferArena.h"
+#import "BenchSupport.h"
+
+using namespace WhirlyKit;
+
+/** Runs the shared buffer allocator through tiles loading and unloading,
+    the way drawables come and go while panning around a vector map.
+
+    There's no GL here.  A stub source hands out buffer IDs and we check
+    every allocation against the others in its buffer, failing if any overlap
+    or if buffers are left behind at the end.
+  */
+
+static const char *BenchUsage =
+"usage: wgmaply_arenabench [options]\n"
+"  --tiles N         Tiles loaded at once (200)\n"
+"  --drawables N     Drawables per tile (40)\n"
+"  --steps N         Tiles swapped out and in (5000)\n"
+"  --arena KB        Shared buffer size (4096)\n"
+"  --seed N          Seed for the drawable sizes (1)\n";
+
+// Hands out IDs and keeps track of what's live
+class StubArenaSource : public BufferArenaSource
+{
+public:
+    StubArenaSource() : nextID(1), bad(false) { }
+
+    virtual unsigned int createArenaBuffer(size_t size)
+    {
+        live.insert(nextID);
+        return nextID++;
+    }
+
+    virtual void releaseArenaBuffer(unsigned int bufferID)
+    {
+        if (!live.erase(bufferID))
+            bad = true;
+    }
+
+    unsigned int nextID;
+    std::set<unsigned int> live;
+    bool bad;
+};
+
+// Everything handed out, by buffer and offset
+typedef std::map<std::pair<unsigned int,size_t>,size_t> AllocMap;
+
+static bool CheckAlloc(const AllocMap &allocs,const BufferArenaAlloc &alloc,size_t arenaSize)
+{
+    if (alloc.offset % 16 != 0 || alloc.offset + alloc.size > arenaSize || alloc.size < alloc.requestedSize)
+        return false;
+    auto it = allocs.lower_bound(std::make_pair(alloc.bufferID,alloc.offset));
+    if (it != allocs.end() && it->first.first == alloc.bufferID && it->first.second < alloc.offset + alloc.size)
+        return false;
+    if (it != allocs.begin())
+    {
+        --it;
+        if (it->first.first == alloc.bufferID && it->first.second + it->second > alloc.offset)
+            return false;
+    }
+    return true;
+}
+
+// Mostly small, with a long tail, like the drawables out of a vector tile
+static size_t DrawableSize(std::mt19937 &rng)
+{
+    std::lognormal_distribution<double> dist(8.5,1.3);
+    return std::max((size_t)64,std::min((size_t)(2*1024*1024),(size_t)dist(rng)));
+}
+
+int main(int argc,char *argv[])
+{
+    int numTiles = 200, numDrawables = 40, numSteps = 5000, arenaKB = 4096, seed = 1;
+    for (int ii=1;ii<argc;ii++)
+    {
+        const std::string arg = argv[ii];
+        if (arg == "--tiles" && ii+1 < argc)
+            numTiles = std::max(1,atoi(argv[++ii]));
+        else if (arg == "--drawables" && ii+1 < argc)
+            numDrawables = std::max(1,atoi(argv[++ii]));
+        else if (arg == "--steps" && ii+1 < argc)
+            numSteps = std::max(1,atoi(argv[++ii]));
+        else if (arg == "--arena" && ii+1 < argc)
+            arenaKB = std::max(64,atoi(argv[++ii]));
+        else if (arg == "--seed" && ii+1 < argc)
+            seed = atoi(argv[++ii]);
+        else {
+            fprintf(stderr, "%s", BenchUsage);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    const size_t arenaSize = (size_t)arenaKB * 1024;
+
+    StubArenaSource source;
+    std::mt19937 rng(seed);
+    AllocMap liveAllocs;
+    // Drawables too big for the arenas get their own buffer, as they would in the renderer
+    int numDedicated = 0, maxDedicated = 0;
+    bool overlap = false;
+    BenchStage allocStage("allocate"), freeStage("free");
+    std::vector<double> utilization;
+    int peakArenas = 0;
+    {
+        BufferArenaAllocator allocator(&source,arenaSize);
+        std::deque<std::vector<BufferArenaAlloc> > tiles;
+        
+        for (int step=0;step<numTiles+numSteps;step++)
+        {
+            // Drop the oldest tile once we're full
+            if ((int)tiles.size() >= numTiles)
+            {
+                auto start = std::chrono::steady_clock::now();
+                for (const BufferArenaAlloc &alloc : tiles.front())
+                    allocator.free(alloc);
+                freeStage.add(BenchSince(start));
+                for (const BufferArenaAlloc &alloc : tiles.front())
+                    liveAllocs.erase(std::make_pair(alloc.bufferID,alloc.offset));
+                numDedicated -= numDrawables - (int)tiles.front().size();
+                tiles.pop_front();
+            }
+
+            std::vector<size_t> sizes(numDrawables);
+            for (size_t &size : sizes)
+                size = DrawableSize(rng);
+            std::vector<BufferArenaAlloc> tile;
+            tile.reserve(numDrawables);
+            auto start = std::chrono::steady_clock::now();
+            for (size_t size : sizes)
+            {
+                BufferArenaAlloc alloc = allocator.allocate(size);
+                if (alloc.valid())
+                    tile.push_back(alloc);
+            }
+            allocStage.add(BenchSince(start));
+            numDedicated += numDrawables - (int)tile.size();
+            maxDedicated = std::max(maxDedicated,numDedicated);
+
+            for (const BufferArenaAlloc &alloc : tile)
+            {
+                if (!CheckAlloc(liveAllocs,alloc,arenaSize))
+                    overlap = true;
+                liveAllocs[std::make_pair(alloc.bufferID,alloc.offset)] = alloc.size;
+            }
+            tiles.push_back(tile);
+
+            if (step >= numTiles)
+            {
+                const BufferArenaStats stats = allocator.getStats();
+                utilization.push_back(stats.utilization());
+                peakArenas = std::max(peakArenas,stats.numArenas);
+            }
+        }
+
+        const BufferArenaStats stats = allocator.getStats();
+        const int numAllocs = numTiles * numDrawables;
+        printf("%d tiles of %d drawables, %d tiles swapped, %d KB shared buffers\n\n", numTiles, numDrawables, numSteps, arenaKB);
+        printf("%-14s %8s %10s %8s %8s %8s %8s\n", "stage", "count", "total ms", "mean", "p50", "p95", "max");
+        allocStage.report();
+        freeStage.report();
+        printf("\n%.0f ns per allocation, %.0f ns per free\n",
+               1e6 * allocStage.total() / (allocStage.samples.size() * numDrawables),
+               1e6 * freeStage.total() / (freeStage.samples.size() * numDrawables));
+
+        double meanUtil = 0.0, minUtil = 1.0;
+        for (double util : utilization)
+        {
+            meanUtil += util;
+            minUtil = std::min(minUtil,util);
+        }
+        meanUtil /= std::max((size_t)1,utilization.size());
+        printf("buffers: %d shared (peak %d) + %d dedicated, against %d with one per drawable\n",
+               stats.numArenas, peakArenas, numDedicated, numAllocs);
+        printf("utilization: %.1f%% now, %.1f%% mean, %.1f%% min while swapping\n",
+               100.0*stats.utilization(), 100.0*meanUtil, 100.0*minUtil);
+        printf("size class overhead: %.1f%%, %d free blocks, largest %.1f KB\n",
+               stats.usedBytes > 0 ? 100.0 * (stats.usedBytes - stats.requestedBytes) / stats.usedBytes : 0.0,
+               stats.numFreeBlocks, stats.largestFreeBlock / 1024.0);
+        printf("shared buffers created %d, released %d\n", stats.arenasCreated, stats.arenasReleased);
+
+        // Everything goes back and the source should end up empty
+        for (auto &tile : tiles)
+            for (const BufferArenaAlloc &alloc : tile)
+                allocator.free(alloc);
+        allocator.trim();
+    }
+
+    if (overlap)
+    {
+        fprintf(stderr, "Allocations overlap\n");
+        return 1;
+    }
+    if (source.bad || !source.live.empty())
+    {
+        fprintf(stderr, "%d shared buffers left over\n", (int)source.live.size());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,196 @@
+/*
+ *  DrawableBuilderBench.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <math.h>
+#import <stdio.h>
+#import <stdlib.h>
+#import <chrono>
+#import <string>
+#import <vector>
+#import "WhirlyGlobe.h"
+#import "SceneRenderer_Headless.h"
+#import "BenchSupport.h"
+
+using namespace WhirlyKit;
+
+/** Fills drawable builders the way the tile and vector builders do, once a vertex
+    at a time and once with the bulk calls, and times the difference.
+
+    Each drawable is a grid like a globe tile chunk, with normals, one set of
+    texture coordinates, colors and an extra float3 attribute like the wide vectors use.
+  */
+
+static const char *BenchUsage =
+"usage: wgmaply_builderbench [options]\n"
+"  --drawables N     Drawables built per pass (200)\n"
+"  --grid N          Grid cells on a side (32)\n"
+"  --repeat N        Passes (5)\n";
+
+// Source data for one drawable
+class BenchGrid
+{
+public:
+    BenchGrid(int size)
+    {
+        for (int iy=0;iy<=size;iy++)
+            for (int ix=0;ix<=size;ix++)
+            {
+                const float x = ix/(float)size, y = iy/(float)size;
+                pts.push_back(Point3f(x,y,0.1f*sinf(x*y)));
+                norms.push_back(Point3f(0.0,0.0,1.0));
+                texCoords.push_back(TexCoord(x,1.0-y));
+                colors.push_back(RGBAColor(255,(int)(255*x),(int)(255*y),255));
+                extra.push_back(Point3f(y,x,1.0));
+            }
+        for (int iy=0;iy<size;iy++)
+            for (int ix=0;ix<size;ix++)
+            {
+                const int v0 = iy*(size+1)+ix;
+                tris.push_back(BasicDrawable::Triangle(v0,v0+1,v0+size+2));
+                tris.push_back(BasicDrawable::Triangle(v0,v0+size+2,v0+size+1));
+            }
+    }
+
+    Point3fVector pts,norms,extra;
+    std::vector<TexCoord> texCoords;
+    std::vector<RGBAColor> colors;
+    std::vector<BasicDrawable::Triangle> tris;
+};
+
+// The way the builders worked, one call per value
+static void BuildPerVertex(BasicDrawableBuilderRef draw,int extraID,const BenchGrid &grid)
+{
+    for (unsigned int ii=0;ii<grid.pts.size();ii++)
+    {
+        draw->addPoint(grid.pts[ii]);
+        draw->addNormal(grid.norms[ii]);
+        draw->addTexCoord(0,grid.texCoords[ii]);
+        draw->addColor(grid.colors[ii]);
+        draw->addAttributeValue(extraID,grid.extra[ii]);
+    }
+    for (const BasicDrawable::Triangle &tri : grid.tris)
+        draw->addTriangle(tri);
+}
+
+// Reserve by layout, then one call per run
+static void BuildBulk(BasicDrawableBuilderRef draw,int extraID,const BenchGrid &grid)
+{
+    const unsigned int numPts = grid.pts.size();
+    draw->setupTexCoordEntry(0,0);
+    draw->reserveLayout(numPts,grid.tris.size());
+    draw->addPoints(grid.pts.data(),numPts);
+    draw->addNormals(grid.norms.data(),numPts);
+    draw->addTexCoords(0,grid.texCoords.data(),numPts);
+    draw->addColors(grid.colors.data(),numPts);
+    draw->getAttributeHandle<Eigen::Vector3f>(extraID).add(grid.extra.begin(),grid.extra.end());
+    draw->addTriangles(grid.tris.data(),grid.tris.size());
+}
+
+// Still one value at a time, but through a typed handle, as the wide vector builder does
+static void BuildHandles(BasicDrawableBuilderRef draw,int extraID,const BenchGrid &grid)
+{
+    VertexAttributeHandle<Eigen::Vector3f> extraAttr = draw->getAttributeHandle<Eigen::Vector3f>(extraID);
+    for (unsigned int ii=0;ii<grid.pts.size();ii++)
+        extraAttr.add(grid.extra[ii]);
+}
+
+// Just the extra attribute, one checked call at a time
+static void BuildAttrValues(BasicDrawableBuilderRef draw,int extraID,const BenchGrid &grid)
+{
+    for (unsigned int ii=0;ii<grid.pts.size();ii++)
+        draw->addAttributeValue(extraID,grid.extra[ii]);
+}
+
+typedef void (*BuildFunc)(BasicDrawableBuilderRef draw,int extraID,const BenchGrid &grid);
+
+int main(int argc,char *argv[])
+{
+    int numDrawables = 200, gridSize = 32, numRepeat = 5;
+    for (int ii=1;ii<argc;ii++)
+    {
+        const std::string arg = argv[ii];
+        if (arg == "--drawables" && ii+1 < argc)
+            numDrawables = std::max(1,atoi(argv[++ii]));
+        else if (arg == "--grid" && ii+1 < argc)
+            gridSize = std::max(1,atoi(argv[++ii]));
+        else if (arg == "--repeat" && ii+1 < argc)
+            numRepeat = std::max(1,atoi(argv[++ii]));
+        else {
+            fprintf(stderr, "%s", BenchUsage);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    SceneRendererGLES_Headless *renderer = new SceneRendererGLES_Headless(64, 64);
+    const StringIdentity extraNameID = StringIndexer::getStringID("a_benchExtra");
+    BenchGrid grid(gridSize);
+
+    BenchStage perVertexStage("per vertex"), bulkStage("bulk"), attrValueStage("attr values"), handleStage("attr handle");
+    struct {
+        BenchStage *stage;
+        BuildFunc func;
+    } modes[] = {{&perVertexStage,BuildPerVertex},{&bulkStage,BuildBulk},{&attrValueStage,BuildAttrValues},{&handleStage,BuildHandles}};
+
+    bool mismatch = false;
+    for (int pass=0;pass<numRepeat;pass++)
+        for (auto &mode : modes)
+        {
+            std::vector<BasicDrawableBuilderRef> draws(numDrawables);
+            std::vector<int> extraIDs(numDrawables);
+            for (int ii=0;ii<numDrawables;ii++)
+            {
+                draws[ii] = renderer->makeBasicDrawableBuilder("Builder Bench");
+                extraIDs[ii] = draws[ii]->addAttribute(BDFloat3Type,extraNameID);
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            for (int ii=0;ii<numDrawables;ii++)
+                mode.func(draws[ii],extraIDs[ii],grid);
+            mode.stage->add(BenchSince(start));
+
+            // The full builds have to come out the same size
+            if (mode.func == BuildPerVertex || mode.func == BuildBulk)
+                for (auto draw : draws)
+                    if (draw->getNumPoints() != grid.pts.size() || draw->getNumTris() != grid.tris.size())
+                        mismatch = true;
+        }
+
+    const double vertsPerPass = (double)numDrawables * grid.pts.size();
+    printf("%d drawables of %d vertices and %d triangles, %d passes\n\n", numDrawables, (int)grid.pts.size(), (int)grid.tris.size(), numRepeat);
+    printf("%-14s %8s %10s %8s %8s %8s %8s\n", "stage", "count", "total ms", "mean", "p50", "p95", "max");
+    for (auto &mode : modes)
+        mode.stage->report();
+    printf("\n");
+    for (auto &mode : modes)
+        printf("%-14s %.1f Mverts/s\n", mode.stage->name.c_str(), vertsPerPass / (mode.stage->percentile(0.5) * 1000.0));
+    printf("bulk speedup: %.2fx, handle speedup on one attribute: %.2fx\n",
+           perVertexStage.percentile(0.5) / bulkStage.percentile(0.5),
+           attrValueStage.percentile(0.5) / handleStage.percentile(0.5));
+
+    delete renderer;
+
+    if (mismatch)
+    {
+        fprintf(stderr, "Bulk and per vertex builds don't match\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,262 @@
+/*
+ *  ETC2Bench.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <math.h>
+#import <stdio.h>
+#import <stdlib.h>
+#import <string.h>
+#import <chrono>
+#import <random>
+#import <string>
+#import <vector>
+#import "WhirlyGlobe.h"
+#import "ETC2Encoder.h"
+#import "BenchSupport.h"
+
+using namespace WhirlyKit;
+
+/** Measures the ETC2 encoder: quality (PSNR against the original) and
+    throughput for each quality setting, plus the block search with and
+    without SIMD.  The scalar and SIMD blocks are compared byte for byte
+    and we fail if they differ.
+
+    Images are synthetic unless raw RGBA is passed in with --raw.
+  */
+
+static const char *BenchUsage =
+"usage: wgmaply_etcbench [options]\n"
+"  --size N          Synthetic image size on a side (256)\n"
+"  --raw FILE        Raw RGBA image to use instead of the synthetic ones\n"
+"  --width W         Width of the raw image\n"
+"  --height H        Height of the raw image\n"
+"  --repeat N        Encodes per timing (3)\n"
+"  --seed N          Seed for the synthetic images (1)\n";
+
+class ETCBenchImage
+{
+public:
+    std::string name;
+    int width,height;
+    std::vector<unsigned char> rgba;
+};
+
+// Smooth, noisy color like aerial imagery
+static void MakeImageryImage(ETCBenchImage &img,std::mt19937 &rng)
+{
+    std::uniform_int_distribution<int> noise(-6,6);
+    for (int y=0;y<img.height;y++)
+        for (int x=0;x<img.width;x++)
+        {
+            unsigned char *pix = &img.rgba[(y*img.width+x)*4];
+            const double v = sin(x*0.031) * cos(y*0.027) + 0.5*sin((x+y)*0.11);
+            pix[0] = std::max(0,std::min(255,(int)(90 + 40*v) + noise(rng)));
+            pix[1] = std::max(0,std::min(255,(int)(110 + 50*v) + noise(rng)));
+            pix[2] = std::max(0,std::min(255,(int)(70 + 30*sin(y*0.05)) + noise(rng)));
+            pix[3] = 255;
+        }
+}
+
+// Flat areas split up by hard edged lines, like a rendered map
+static void MakeMapImage(ETCBenchImage &img,std::mt19937 &rng)
+{
+    static const unsigned char colors[4][3] = {{242,239,233},{170,211,223},{200,250,204},{224,223,223}};
+    for (int y=0;y<img.height;y++)
+        for (int x=0;x<img.width;x++)
+        {
+            unsigned char *pix = &img.rgba[(y*img.width+x)*4];
+            const unsigned char *color = colors[((x/37) + (y/29)*3) % 4];
+            const bool road = (x % 64) < 3 || ((x + 2*y) % 97) < 4;
+            pix[0] = road ? 255 : color[0];
+            pix[1] = road ? 204 : color[1];
+            pix[2] = road ? 102 : color[2];
+            pix[3] = 255;
+        }
+}
+
+// A weather style overlay with soft edged transparency
+static void MakeOverlayImage(ETCBenchImage &img,std::mt19937 &rng)
+{
+    std::uniform_real_distribution<double> center(0.0,1.0);
+    double cx[6],cy[6];
+    for (int ii=0;ii<6;ii++)
+    {
+        cx[ii] = center(rng) * img.width;
+        cy[ii] = center(rng) * img.height;
+    }
+    for (int y=0;y<img.height;y++)
+        for (int x=0;x<img.width;x++)
+        {
+            double val = 0.0;
+            for (int ii=0;ii<6;ii++)
+                val += exp(-((x-cx[ii])*(x-cx[ii]) + (y-cy[ii])*(y-cy[ii])) / (img.width*img.width/40.0));
+            val = std::min(1.0,val);
+            unsigned char *pix = &img.rgba[(y*img.width+x)*4];
+            pix[0] = (unsigned char)(255*val);
+            pix[1] = (unsigned char)(255*(1.0-val));
+            pix[2] = 64;
+            pix[3] = (unsigned char)(200*val);
+        }
+}
+
+// Peak signal to noise ratio over the given channels
+static double PSNR(const ETCBenchImage &img,const std::vector<unsigned char> &decoded,int startChan,int numChan)
+{
+    double sum = 0.0;
+    const size_t numPixels = (size_t)img.width*img.height;
+    for (size_t ii=0;ii<numPixels;ii++)
+        for (int c=startChan;c<startChan+numChan;c++)
+        {
+            const double diff = (double)img.rgba[ii*4+c] - decoded[ii*4+c];
+            sum += diff*diff;
+        }
+    const double mse = sum / (numPixels*numChan);
+    return mse > 0.0 ? 10.0 * log10(255.0*255.0 / mse) : 99.0;
+}
+
+int main(int argc,char *argv[])
+{
+    int size = 256, repeat = 3, seed = 1;
+    std::string rawFile;
+    int rawWidth = 0, rawHeight = 0;
+    for (int ii=1;ii<argc;ii++)
+    {
+        const std::string arg = argv[ii];
+        if (arg == "--size" && ii+1 < argc)
+            size = std::max(4,atoi(argv[++ii]));
+        else if (arg == "--raw" && ii+1 < argc)
+            rawFile = argv[++ii];
+        else if (arg == "--width" && ii+1 < argc)
+            rawWidth = atoi(argv[++ii]);
+        else if (arg == "--height" && ii+1 < argc)
+            rawHeight = atoi(argv[++ii]);
+        else if (arg == "--repeat" && ii+1 < argc)
+            repeat = std::max(1,atoi(argv[++ii]));
+        else if (arg == "--seed" && ii+1 < argc)
+            seed = atoi(argv[++ii]);
+        else {
+            fprintf(stderr, "%s", BenchUsage);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    std::vector<ETCBenchImage> images;
+    if (!rawFile.empty())
+    {
+        ETCBenchImage img;
+        img.name = rawFile;
+        img.width = rawWidth;  img.height = rawHeight;
+        std::vector<unsigned char> data;
+        if (rawWidth <= 0 || rawHeight <= 0 || !ReadTileFile(rawFile, data) || data.size() < (size_t)rawWidth*rawHeight*4)
+        {
+            fprintf(stderr, "Couldn't read %dx%d RGBA from %s\n", rawWidth, rawHeight, rawFile.c_str());
+            return 1;
+        }
+        img.rgba.assign(data.begin(), data.begin() + (size_t)rawWidth*rawHeight*4);
+        images.push_back(img);
+    } else {
+        std::mt19937 rng(seed);
+        const char *names[3] = {"imagery","map","overlay"};
+        for (int which=0;which<3;which++)
+        {
+            ETCBenchImage img;
+            img.name = names[which];
+            img.width = img.height = size;
+            img.rgba.resize((size_t)size*size*4);
+            switch (which)
+            {
+                case 0: MakeImageryImage(img, rng); break;
+                case 1: MakeMapImage(img, rng); break;
+                case 2: MakeOverlayImage(img, rng); break;
+            }
+            images.push_back(img);
+        }
+    }
+
+    static const char *qualityNames[3] = {"fast","normal","high"};
+    bool mismatch = false;
+
+    printf("%-10s %-7s %6s %10s %9s %9s %10s\n", "image", "quality", "format", "ms/image", "Mpix/s", "RGB PSNR", "alpha PSNR");
+    for (const auto &img : images)
+    {
+        const bool withAlpha = !ETC2IsOpaque(&img.rgba[0], img.width, img.height);
+        for (int quality=ETC2QualityFast;quality<=ETC2QualityHigh;quality++)
+        {
+            RawDataRef pkmData;
+            const auto start = std::chrono::steady_clock::now();
+            for (int ii=0;ii<repeat;ii++)
+                pkmData = ETC2EncodePKM(&img.rgba[0], img.width, img.height, withAlpha, (ETC2Quality)quality);
+            const double ms = BenchSince(start) / repeat;
+
+            std::vector<unsigned char> decoded;
+            int width,height;
+            if (!pkmData || !ETC2DecodePKM(pkmData, decoded, width, height))
+            {
+                fprintf(stderr, "%s: couldn't decode what we encoded\n", img.name.c_str());
+                return 1;
+            }
+            printf("%-10s %-7s %6s %10.2f %9.2f %9.2f", img.name.c_str(), qualityNames[quality], withAlpha ? "RGBA" : "RGB",
+                   ms, img.width*img.height / (ms * 1000.0), PSNR(img, decoded, 0, 3));
+            if (withAlpha)
+                printf(" %10.2f\n", PSNR(img, decoded, 3, 1));
+            else
+                printf(" %10s\n", "-");
+        }
+        printf("%-10s %.1f KB as RGBA, %.1f KB as ETC2\n", "", img.width*img.height*4 / 1024.0,
+               (img.width+3)/4 * ((img.height+3)/4) * (withAlpha ? 16 : 8) / 1024.0);
+    }
+
+    // Block search on its own, with and without SIMD
+    printf("\n%-10s %-7s %12s %12s\n", "image", "quality", "scalar Mpix/s", "SIMD Mpix/s");
+    for (const auto &img : images)
+    {
+        // Gather the blocks up front so we're only timing the search
+        const int blocksWide = img.width/4, blocksHigh = img.height/4;
+        std::vector<unsigned char> blocks((size_t)blocksWide*blocksHigh*64);
+        for (int by=0;by<blocksHigh;by++)
+            for (int bx=0;bx<blocksWide;bx++)
+                for (int y=0;y<4;y++)
+                    memcpy(&blocks[((size_t)(by*blocksWide+bx)*16 + y*4)*4], &img.rgba[((size_t)(by*4+y)*img.width + bx*4)*4], 16);
+        const size_t numBlocks = (size_t)blocksWide*blocksHigh;
+        std::vector<unsigned char> scalarOut(numBlocks*8),simdOut(numBlocks*8);
+
+        for (int quality=ETC2QualityFast;quality<=ETC2QualityHigh;quality++)
+        {
+            double rates[2];
+            for (int simd=0;simd<2;simd++)
+            {
+                unsigned char *out = simd ? &simdOut[0] : &scalarOut[0];
+                const auto start = std::chrono::steady_clock::now();
+                for (int ii=0;ii<repeat;ii++)
+                    for (size_t bb=0;bb<numBlocks;bb++)
+                        ETC2EncodeRGBBlock(&blocks[bb*64], &out[bb*8], (ETC2Quality)quality, simd);
+                const double ms = BenchSince(start) / repeat;
+                rates[simd] = numBlocks*16 / (ms * 1000.0);
+            }
+            if (memcmp(&scalarOut[0], &simdOut[0], scalarOut.size()))
+            {
+                fprintf(stderr, "%s: scalar and SIMD blocks differ at %s quality\n", img.name.c_str(), qualityNames[quality]);
+                mismatch = true;
+            }
+            printf("%-10s %-7s %12.2f %12.2f\n", img.name.c_str(), qualityNames[quality], rates[0], rates[1]);
+        }
+    }
+
+    return mismatch ? 1 : 0;
+}
@@ -0,0 +1,277 @@
+/*
+ *  GeoJSONBench.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <stdio.h>
+#import <stdlib.h>
+#import <dirent.h>
+#import <algorithm>
+#import <chrono>
+#import <string>
+#import <vector>
+#import "WhirlyGlobe.h"
+#import "GeoJSONStreamParser.h"
+#import "BenchSupport.h"
+
+using namespace WhirlyKit;
+
+/** Checks the streaming GeoJSON parser against the DOM one.
+
+    Every .geojson and .json file under the given directories goes through
+    VectorParseGeoJSONStream() and VectorParseGeoJSON().  The shapes that come
+    back are written out with their exact coordinates and attributes, sorted,
+    and compared, so we fail on any difference at all.  Files neither of them
+    can parse (style sheets, say) are just counted.  We also time both.
+  */
+
+static const char *BenchUsage =
+"usage: wgmaply_geojsonbench [options] [dir or file ...]\n"
+"  --repeat N       Parses of each file per timing (3)\n"
+"  Defaults to the Android AutoTester's assets\n";
+
+static bool EndsWith(const std::string &str,const std::string &suffix)
+{
+    return str.size() >= suffix.size() && str.compare(str.size()-suffix.size(),suffix.size(),suffix) == 0;
+}
+
+static void FindFiles(const std::string &path,std::vector<std::string> &files)
+{
+    DIR *dir = opendir(path.c_str());
+    if (!dir)
+    {
+        files.push_back(path);
+        return;
+    }
+    while (struct dirent *ent = readdir(dir))
+    {
+        const std::string name = ent->d_name;
+        if (name == "." || name == "..")
+            continue;
+        const std::string full = path + "/" + name;
+        if (ent->d_type == DT_DIR)
+            FindFiles(full,files);
+        else if (EndsWith(name,".geojson") || EndsWith(name,".json"))
+            files.push_back(full);
+    }
+    closedir(dir);
+}
+
+static void DumpEntry(const DictionaryEntryRef &entry,std::string &out);
+
+static void DumpDict(const DictionaryRef &dict,std::string &out)
+{
+    std::vector<std::string> keys = dict->getKeys();
+    std::sort(keys.begin(),keys.end());
+    out += "{";
+    for (const auto &key : keys)
+    {
+        out += key + "=";
+        DumpEntry(dict->getEntry(key),out);
+        out += ";";
+    }
+    out += "}";
+}
+
+static void DumpEntry(const DictionaryEntryRef &entry,std::string &out)
+{
+    char buf[64];
+    switch (entry ? entry->getType() : DictTypeNone)
+    {
+        case DictTypeString:
+            out += "s:" + entry->getString();
+            break;
+        case DictTypeInt:
+            snprintf(buf, sizeof(buf), "i:%d", entry->getInt());
+            out += buf;
+            break;
+        case DictTypeIdentity:
+            snprintf(buf, sizeof(buf), "id:%llu", (unsigned long long)entry->getIdentity());
+            out += buf;
+            break;
+        case DictTypeDouble:
+            snprintf(buf, sizeof(buf), "d:%a", entry->getDouble());
+            out += buf;
+            break;
+        case DictTypeDictionary:
+            DumpDict(entry->getDict(),out);
+            break;
+        case DictTypeArray:
+            out += "[";
+            for (const auto &sub : entry->getArray())
+            {
+                DumpEntry(sub,out);
+                out += ",";
+            }
+            out += "]";
+            break;
+        default:
+            out += "none";
+            break;
+    }
+}
+
+template<typename Ring> static void DumpRing(const Ring &ring,std::string &out)
+{
+    char buf[128];
+    out += "(";
+    for (const auto &pt : ring)
+    {
+        for (int ii=0;ii<pt.size();ii++)
+        {
+            snprintf(buf, sizeof(buf), ii == 0 ? "%a" : " %a", (double)pt[ii]);
+            out += buf;
+        }
+        out += ",";
+    }
+    out += ")";
+}
+
+// Exact text for each shape, sorted, since the sets don't come back in any order
+static std::vector<std::string> DumpShapes(const ShapeSet &shapes)
+{
+    std::vector<std::string> dumps;
+    dumps.reserve(shapes.size());
+    for (const auto &shape : shapes)
+    {
+        std::string out;
+        if (auto areal = std::dynamic_pointer_cast<VectorAreal>(shape))
+        {
+            out = "areal";
+            for (const auto &loop : areal->loops)
+                DumpRing(loop,out);
+        } else if (auto lin = std::dynamic_pointer_cast<VectorLinear>(shape))
+        {
+            out = "linear";
+            DumpRing(lin->pts,out);
+        } else if (auto lin3d = std::dynamic_pointer_cast<VectorLinear3d>(shape))
+        {
+            out = "linear3d";
+            DumpRing(lin3d->pts,out);
+        } else if (auto pts = std::dynamic_pointer_cast<VectorPoints>(shape))
+        {
+            out = "points";
+            DumpRing(pts->pts,out);
+        } else
+            out = "unknown";
+        if (shape->getAttrDict())
+            DumpDict(shape->getAttrDict(),out);
+        dumps.push_back(out);
+    }
+    std::sort(dumps.begin(),dumps.end());
+    return dumps;
+}
+
+int main(int argc,char *argv[])
+{
+    std::vector<std::string> paths;
+    int repeat = 3;
+    for (int ii=1;ii<argc;ii++)
+    {
+        const std::string arg = argv[ii];
+        if (arg == "--repeat" && ii+1 < argc)
+            repeat = std::max(1,atoi(argv[++ii]));
+        else if (arg.empty() || arg[0] == '-') {
+            fprintf(stderr, "%s", BenchUsage);
+            return arg == "--help" ? 0 : 1;
+        } else
+            paths.push_back(arg);
+    }
+    if (paths.empty())
+        paths.push_back(BenchAndroidAssetDir());
+
+    std::vector<std::string> files;
+    for (const auto &path : paths)
+        FindFiles(path,files);
+    std::sort(files.begin(),files.end());
+
+    int numSame = 0,numDiff = 0,numUnparsed = 0;
+    size_t totalBytes = 0,totalShapes = 0;
+    double streamMs = 0.0,domMs = 0.0;
+    for (const auto &fileName : files)
+    {
+        std::vector<unsigned char> data;
+        if (!ReadTileFile(fileName, data))
+        {
+            fprintf(stderr, "%s: couldn't read\n", fileName.c_str());
+            numDiff++;
+            continue;
+        }
+        const std::string str(data.begin(),data.end());
+
+        ShapeSet streamShapes,domShapes;
+        std::string streamCrs,domCrs;
+        const bool streamOk = VectorParseGeoJSONStream(streamShapes,str,streamCrs);
+        const bool domOk = VectorParseGeoJSON(domShapes,str,domCrs);
+        if (!streamOk && !domOk)
+        {
+            numUnparsed++;
+            continue;
+        }
+        if (streamOk != domOk)
+        {
+            fprintf(stderr, "%s: only the %s parser succeeded\n", fileName.c_str(), streamOk ? "streaming" : "DOM");
+            numDiff++;
+            continue;
+        }
+
+        const std::vector<std::string> streamDump = DumpShapes(streamShapes);
+        const std::vector<std::string> domDump = DumpShapes(domShapes);
+        if (streamCrs != domCrs || streamDump != domDump)
+        {
+            fprintf(stderr, "%s: %d shapes streamed, %d from the DOM parser", fileName.c_str(),
+                    (int)streamDump.size(), (int)domDump.size());
+            if (streamCrs != domCrs)
+                fprintf(stderr, ", CRS %s vs %s", streamCrs.c_str(), domCrs.c_str());
+            const auto diff = std::mismatch(streamDump.begin(),streamDump.end(),domDump.begin(),domDump.end());
+            if (diff.first != streamDump.end())
+                fprintf(stderr, "\n  stream: %.200s", diff.first->c_str());
+            if (diff.second != domDump.end())
+                fprintf(stderr, "\n  DOM:    %.200s", diff.second->c_str());
+            fprintf(stderr, "\n");
+            numDiff++;
+            continue;
+        }
+        numSame++;
+        totalBytes += str.size();
+        totalShapes += streamDump.size();
+
+        auto start = std::chrono::steady_clock::now();
+        for (int ri=0;ri<repeat;ri++)
+        {
+            ShapeSet shapes;
+            VectorParseGeoJSONStream(shapes,str,streamCrs);
+        }
+        streamMs += BenchSince(start) / repeat;
+        start = std::chrono::steady_clock::now();
+        for (int ri=0;ri<repeat;ri++)
+        {
+            ShapeSet shapes;
+            VectorParseGeoJSON(shapes,str,domCrs);
+        }
+        domMs += BenchSince(start) / repeat;
+    }
+
+    printf("%d files: %d match, %d differ, %d neither parser reads\n", (int)files.size(), numSame, numDiff, numUnparsed);
+    printf("%d shapes, %.1f MB in the matching files\n", (int)totalShapes, totalBytes / (1024.0*1024.0));
+    printf("%-10s %10s %10s\n", "parser", "total ms", "MB/s");
+    printf("%-10s %10.1f %10.1f\n", "stream", streamMs, streamMs > 0.0 ? totalBytes / (1024.0*1024.0) / (streamMs / 1000.0) : 0.0);
+    printf("%-10s %10.1f %10.1f\n", "DOM", domMs, domMs > 0.0 ? totalBytes / (1024.0*1024.0) / (domMs / 1000.0) : 0.0);
+
+    return numDiff > 0 || files.empty() ? 1 : 0;
+}
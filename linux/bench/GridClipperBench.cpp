@@ -0,0 +1,376 @@
+/*
+ *  GridClipperBench.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <stdio.h>
+#import <stdlib.h>
+#import <string.h>
+#import <math.h>
+#import <chrono>
+#import <string>
+#import <vector>
+#import "WhirlyGlobe.h"
+#import "GridClipper.h"
+#import "clipper.hpp"
+#import "BenchSupport.h"
+
+using namespace WhirlyKit;
+
+/** Compares GridClipper against the strip clipping it replaced.
+
+    The areal features from a GeoJSON file are clipped to grids of a few sizes
+    the old way, a strip at a time with a float round trip between, and with
+    GridClipper.  We report the time for each, the number of rings they come
+    back with and how far their total area is from that of the input.
+
+    Open lines are clipped to a box with the old Cohen-Sutherland loop and
+    with ClipLoopToMbr(), which should match exactly.  We fail if they don't.
+  */
+
+static const char *BenchUsage =
+"usage: wgmaply_clipbench [options]\n"
+"  --geojson FILE   Areal features to clip (AutoTester's belfast_ireland_landusages.geojson)\n"
+"  --grids LIST     Comma separated grid spacings in radians (2e-5,1e-4,5e-4)\n"
+"  --repeat N       Passes over the features per timing (3)\n";
+
+// The old clipping, kept here for comparison
+namespace OldGridClip
+{
+
+using namespace ClipperLib;
+
+static const float PolyScale = 1e14;
+
+typedef int OutCode;
+static const int INSIDE = 0, LEFT = 1, RIGHT = 2, BOTTOM = 4, TOP = 8;
+
+static OutCode ComputeOutCode(double x, double y, const Mbr &mbr)
+{
+    OutCode code = INSIDE;
+    if (x < mbr.ll().x())
+        code |= LEFT;
+    else if (x > mbr.ur().x())
+        code |= RIGHT;
+    if (y < mbr.ll().y())
+        code |= BOTTOM;
+    else if (y > mbr.ur().y())
+        code |= TOP;
+    return code;
+}
+
+static void LinearClipToMbr(const VectorRing &ring,const Mbr &mbr,std::vector<VectorRing> &rets)
+{
+    VectorRing outRing;
+    for (unsigned int ii=1;ii<ring.size();ii++)
+    {
+        Point2f p0 = ring[ii - 1];
+        Point2f p1 = ring[ii];
+        OutCode outcode0 = ComputeOutCode(p0.x(), p0.y(), mbr);
+        OutCode outcode1 = ComputeOutCode(p1.x(), p1.y(), mbr);
+        bool accept = false;
+
+        while (true) {
+            if (!(outcode0 | outcode1)) {
+                accept = true;
+                break;
+            } else if (outcode0 & outcode1) {
+                break;
+            } else {
+                double x=0.0, y=0.0;
+                OutCode outcodeOut = outcode0 ? outcode0 : outcode1;
+                if (outcodeOut & TOP) {
+                    x = p0.x() + (p1.x() - p0.x()) * (mbr.ur().y() - p0.y()) / (p1.y() - p0.y());
+                    y = mbr.ur().y();
+                } else if (outcodeOut & BOTTOM) {
+                    x = p0.x() + (p1.x() - p0.x()) * (mbr.ll().y() - p0.y()) / (p1.y() - p0.y());
+                    y = mbr.ll().y();
+                } else if (outcodeOut & RIGHT) {
+                    y = p0.y() + (p1.y() - p0.y()) * (mbr.ur().x() - p0.x()) / (p1.x() - p0.x());
+                    x = mbr.ur().x();
+                } else if (outcodeOut & LEFT) {
+                    y = p0.y() + (p1.y() - p0.y()) * (mbr.ll().x() - p0.x()) / (p1.x() - p0.x());
+                    x = mbr.ll().x();
+                }
+                if (outcodeOut == outcode0) {
+                    p0.x() = x;
+                    p0.y() = y;
+                    outcode0 = ComputeOutCode(p0.x(), p0.y(), mbr);
+                } else {
+                    p1.x() = x;
+                    p1.y() = y;
+                    outcode1 = ComputeOutCode(p1.x(), p1.y(), mbr);
+                }
+            }
+        }
+        if (accept) {
+            if (outRing.size() > 1 && outRing[outRing.size() - 1] != p0)
+            {
+                rets.push_back(outRing);
+                outRing = VectorRing();
+            }
+            if(outRing.size() == 0) {
+                outRing.push_back(p0);
+            }
+            outRing.push_back(p1);
+        }
+    }
+
+    if (outRing.size() > 1)
+        rets.push_back(outRing);
+}
+
+static Path MbrPath(const Mbr &mbr)
+{
+    Path clip(4);
+    clip[0] = IntPoint(mbr.ll().x()*PolyScale,mbr.ll().y()*PolyScale);
+    clip[1] = IntPoint(mbr.ur().x()*PolyScale,mbr.ll().y()*PolyScale);
+    clip[2] = IntPoint(mbr.ur().x()*PolyScale,mbr.ur().y()*PolyScale);
+    clip[3] = IntPoint(mbr.ll().x()*PolyScale,mbr.ur().y()*PolyScale);
+    return clip;
+}
+
+static bool ClipLoopsToMbr(const VectorRing *rings,int numRings,const Mbr &mbr,std::vector<VectorRing> &rets)
+{
+    Clipper c;
+    for (int ri=0;ri<numRings;ri++)
+    {
+        const VectorRing &ring = rings[ri];
+        Path subject(ring.size());
+        for (unsigned int ii=0;ii<ring.size();ii++)
+        {
+            const Point2f &pt = ring[ii];
+            subject[ii] = IntPoint(pt.x()*PolyScale,pt.y()*PolyScale);
+        }
+        c.AddPath(subject, ptSubject, true);
+    }
+    c.AddPath(MbrPath(mbr), ptClip, true);
+    Paths solution;
+    if (!c.Execute(ctIntersection, solution))
+        return false;
+
+    for (unsigned int ii=0;ii<solution.size();ii++)
+    {
+        Path &outPoly = solution[ii];
+        VectorRing outRing;
+        for (unsigned jj=0;jj<outPoly.size();jj++)
+        {
+            IntPoint &outPt = outPoly[jj];
+            outRing.push_back(Point2f(outPt.X/PolyScale,outPt.Y/PolyScale));
+        }
+        if (outRing.size() > 2)
+            rets.push_back(outRing);
+    }
+    return true;
+}
+
+// The single loop and multiple loop versions only differed in the first clip
+static bool ClipLoopsToGrid(const std::vector<VectorRing> &rings,Point2f org,Point2f spacing,std::vector<VectorRing> &rets)
+{
+    Mbr mbr;
+    for (const auto &ring : rings)
+        mbr.addPoints(ring);
+    int startRet = (int)(rets.size());
+
+    int ll_ix = (int)std::floor((mbr.ll().x()-org.x())/spacing.x());
+    int ll_iy = (int)std::floor((mbr.ll().y()-org.y())/spacing.y());
+    int ur_ix = (int)std::ceil((mbr.ur().x()-org.x())/spacing.x());
+    int ur_iy = (int)std::ceil((mbr.ur().y()-org.y())/spacing.y());
+
+    for (int ix=ll_ix;ix<=ur_ix;ix++)
+    {
+        Point2f l0(ix*spacing.x()+org.x(),mbr.ll().y());
+        Point2f l1((ix+1)*spacing.x()+org.x(),mbr.ur().y());
+        Mbr left(l0,l1);
+
+        std::vector<VectorRing> leftStrip;
+        ClipLoopsToMbr(&rings[0],rings.size(),left,leftStrip);
+
+        for (int iy=ll_iy;iy<=ur_iy;iy++)
+        {
+            Point2f b0(mbr.ll().x(),iy*spacing.y()+org.y());
+            Point2f b1(mbr.ur().x(),(iy+1)*spacing.y()+org.y());
+            Mbr bot(b0,b1);
+            for (unsigned int ic=0;ic<leftStrip.size();ic++)
+                ClipLoopsToMbr(&leftStrip[ic],1,bot,rets);
+        }
+    }
+
+    for (unsigned int ii=startRet;ii<rets.size();ii++)
+    {
+        VectorRing &theRing = rets[ii];
+        std::reverse(theRing.begin(),theRing.end());
+    }
+
+    return true;
+}
+
+}
+
+static std::vector<double> ParseDoubleList(const char *str)
+{
+    std::vector<double> vals;
+    for (const char *s = str; *s; )
+    {
+        vals.push_back(atof(s));
+        const char *comma = strchr(s, ',');
+        if (!comma)
+            break;
+        s = comma+1;
+    }
+    return vals;
+}
+
+// Signed area in double, relative to the first point.  The coordinates are
+//  radians and the cells tiny, so CalcLoopArea() loses most of the digits.
+static double RingArea(const VectorRing &ring)
+{
+    if (ring.empty())
+        return 0.0;
+    const Point2d org = ring[0].cast<double>();
+    double area = 0.0;
+    for (size_t ii=0,jj=ring.size()-1;ii<ring.size();jj=ii++)
+    {
+        const Point2d a = ring[jj].cast<double>() - org, b = ring[ii].cast<double>() - org;
+        area += a.x()*b.y() - b.x()*a.y();
+    }
+    return area / 2.0;
+}
+
+// Holes come back wound the other way, so the signed areas add up
+static double TotalArea(const std::vector<VectorRing> &rings)
+{
+    double area = 0.0;
+    for (const auto &ring : rings)
+        area += RingArea(ring);
+    return fabs(area);
+}
+
+int main(int argc,char *argv[])
+{
+    std::string fileName = BenchAndroidAssetDir() + "belfast_ireland_landusages.geojson";
+    std::vector<double> grids = {2e-5,1e-4,5e-4};
+    int repeat = 3;
+    for (int ii=1;ii<argc;ii++)
+    {
+        const std::string arg = argv[ii];
+        if (arg == "--geojson" && ii+1 < argc)
+            fileName = argv[++ii];
+        else if (arg == "--grids" && ii+1 < argc)
+            grids = ParseDoubleList(argv[++ii]);
+        else if (arg == "--repeat" && ii+1 < argc)
+            repeat = std::max(1,atoi(argv[++ii]));
+        else {
+            fprintf(stderr, "%s", BenchUsage);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    std::vector<unsigned char> data;
+    ShapeSet shapes;
+    std::string crs;
+    if (!ReadTileFile(fileName, data) ||
+        !VectorParseGeoJSON(shapes, std::string(data.begin(),data.end()), crs))
+    {
+        fprintf(stderr, "Couldn't read GeoJSON from %s\n", fileName.c_str());
+        return 1;
+    }
+    std::vector<std::vector<VectorRing> > features;
+    Mbr dataMbr;
+    int numPts = 0;
+    double inArea = 0.0;
+    for (const auto &shape : shapes)
+    {
+        VectorArealRef areal = std::dynamic_pointer_cast<VectorAreal>(shape);
+        if (!areal || areal->loops.empty())
+            continue;
+        features.push_back(areal->loops);
+        for (unsigned int li=0;li<areal->loops.size();li++)
+            inArea += li == 0 ? fabs(RingArea(areal->loops[li])) : -fabs(RingArea(areal->loops[li]));
+        for (const auto &loop : areal->loops)
+        {
+            dataMbr.addPoints(loop);
+            numPts += loop.size();
+        }
+    }
+    printf("%s: %d polygons, %d points\n\n", fileName.c_str(), (int)features.size(), numPts);
+    if (features.empty() || inArea <= 0.0)
+    {
+        fprintf(stderr, "No areal features to clip\n");
+        return 1;
+    }
+
+    // Area is relative to what went in, which is what both should come back with
+    printf("%-8s %10s %10s %8s %8s %10s %10s\n", "grid", "old ms", "new ms", "old ring", "new ring", "old area", "new area");
+    for (double grid : grids)
+    {
+        const Point2f org(0.0,0.0),spacing(grid,grid);
+        std::vector<VectorRing> oldRets,newRets;
+        auto start = std::chrono::steady_clock::now();
+        for (int ri=0;ri<repeat;ri++)
+        {
+            oldRets.clear();
+            for (const auto &loops : features)
+                OldGridClip::ClipLoopsToGrid(loops,org,spacing,oldRets);
+        }
+        const double oldMs = BenchSince(start) / repeat;
+
+        // One clipper for the whole batch, the way the vector manager uses it
+        start = std::chrono::steady_clock::now();
+        for (int ri=0;ri<repeat;ri++)
+        {
+            newRets.clear();
+            GridClipper clipper(org,spacing);
+            for (const auto &loops : features)
+                clipper.clipLoops(loops,newRets);
+        }
+        const double newMs = BenchSince(start) / repeat;
+
+        const double oldArea = TotalArea(oldRets), newArea = TotalArea(newRets);
+        printf("%-8g %10.1f %10.1f %8d %8d %10.2e %10.2e\n", grid, oldMs, newMs, (int)oldRets.size(), (int)newRets.size(),
+               (oldArea - inArea) / inArea, (newArea - inArea) / inArea);
+    }
+
+    // Open lines through a box in the middle of the data
+    const Point2f mid = dataMbr.mid(), span = dataMbr.ur() - dataMbr.ll();
+    const Mbr box(mid - span/4.0, mid + span/4.0);
+    std::vector<VectorRing> oldLines,newLines;
+    auto start = std::chrono::steady_clock::now();
+    for (int ri=0;ri<repeat;ri++)
+    {
+        oldLines.clear();
+        for (const auto &loops : features)
+            OldGridClip::LinearClipToMbr(loops[0],box,oldLines);
+    }
+    const double oldMs = BenchSince(start) / repeat;
+    start = std::chrono::steady_clock::now();
+    for (int ri=0;ri<repeat;ri++)
+    {
+        newLines.clear();
+        for (const auto &loops : features)
+            ClipLoopToMbr(loops[0],box,false,newLines);
+    }
+    const double newMs = BenchSince(start) / repeat;
+    const bool linesMatch = oldLines == newLines;
+    printf("%-8s %10.2f %10.2f %8d %8d %10s\n", "linear", oldMs, newMs, (int)oldLines.size(), (int)newLines.size(),
+           linesMatch ? "same" : "DIFFERENT");
+    if (!linesMatch)
+        fprintf(stderr, "Open line clipping differs from the old version\n");
+
+    return linesMatch ? 0 : 1;
+}
@@ -0,0 +1,697 @@
+/*
+ *  MapboxVectorBench.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <dirent.h>
+#import <stdio.h>
+#import <stdlib.h>
+#import <string.h>
+#import <sys/resource.h>
+#import <sys/stat.h>
+#import <algorithm>
+#import <atomic>
+#import <chrono>
+#import <map>
+#import <new>
+#import <string>
+#import <thread>
+#import <vector>
+#import "WhirlyGlobe.h"
+#import "SceneRenderer_Headless.h"
+#import "MapboxVectorStyleSet_Headless.h"
+#import "Dictionary_Android.h"
+#import "BenchSupport.h"
+
+using namespace WhirlyKit;
+
+/** Runs a corpus of vector tiles through the Mapbox vector tile pipeline
+    (protobuf parse, style filtering and the style layers' buildObjects)
+    and reports how fast it went, single and multi-threaded.
+
+    The corpus is a directory laid out as {z}/{x}/{y}.mvt (or .pbf, gzipped or not).
+    If there isn't one, a synthetic corpus is generated, which can be written out
+    with --write-corpus and replayed later.  The whole corpus is read into memory
+    before anything is timed.
+
+    Results are printed as a table and can be written as JSON with --json
+    so they can be compared from release to release.
+  */
+
+static const char *BenchUsage =
+"usage: wgmaply_mvtbench [options]\n"
+"  --tiles DIR         Corpus of DIR/{z}/{x}/{y}.mvt (or .pbf).  Synthesized if missing.\n"
+"  --style FILE        Mapbox GL style JSON.  A built in style matching the synthetic tiles by default.\n"
+"  --threads LIST      Comma separated thread counts to run with (1 and the number of cores)\n"
+"  --repeat N          Passes over the corpus for each thread count (3)\n"
+"  --warmup N          Untimed passes before the first run (1)\n"
+"  --json FILE         Write the results as JSON to FILE, or - for stdout\n"
+"  --geomcache MB      Keep finished geometry in a cache of MB megabytes (off)\n"
+"  --write-corpus DIR  Write the synthetic corpus to DIR and stop\n"
+"Synthetic corpus:\n"
+"  --lon L --lat L     Center of the corpus, in degrees (-0.1276, 51.5072)\n"
+"  --minzoom Z         Lowest level (10)\n"
+"  --maxzoom Z         Highest level (14)\n"
+"  --span N            Tiles on a side at each level (4)\n"
+"  --seed N            Seed for the synthetic tiles (1)\n";
+
+class MVTBenchOptions
+{
+public:
+    MVTBenchOptions()
+    : repeat(3), warmup(1), geomCacheMB(0), lon(-0.1276), lat(51.5072), minZoom(10), maxZoom(14), span(4), seed(1) { }
+
+    std::string tileDir,styleFile,jsonFile,writeDir;
+    std::vector<int> threads;
+    int repeat,warmup;
+    int geomCacheMB;
+    double lon,lat;
+    int minZoom,maxZoom;
+    int span;
+    int seed;
+};
+
+static bool ParseOptions(int argc,char *argv[],MVTBenchOptions &opts)
+{
+    for (int ii=1;ii<argc;ii+=2)
+    {
+        const std::string arg = argv[ii];
+        const char *next = (ii+1 < argc) ? argv[ii+1] : NULL;
+        if (arg == "--help" || arg == "-h" || !next) {
+            return false;
+        } else if (arg == "--tiles") {
+            opts.tileDir = next;
+        } else if (arg == "--style") {
+            opts.styleFile = next;
+        } else if (arg == "--json") {
+            opts.jsonFile = next;
+        } else if (arg == "--write-corpus") {
+            opts.writeDir = next;
+        } else if (arg == "--threads") {
+            opts.threads.clear();
+            for (const char *str = next;*str;)
+            {
+                const int num = atoi(str);
+                if (num <= 0)
+                    return false;
+                opts.threads.push_back(num);
+                str = strchr(str, ',');
+                if (!str)
+                    break;
+                str++;
+            }
+        } else if (arg == "--repeat") {
+            opts.repeat = std::max(1,atoi(next));
+        } else if (arg == "--warmup") {
+            opts.warmup = std::max(0,atoi(next));
+        } else if (arg == "--geomcache") {
+            opts.geomCacheMB = std::max(0,atoi(next));
+        } else if (arg == "--lon") {
+            opts.lon = atof(next);
+        } else if (arg == "--lat") {
+            opts.lat = atof(next);
+        } else if (arg == "--minzoom") {
+            opts.minZoom = atoi(next);
+        } else if (arg == "--maxzoom") {
+            opts.maxZoom = atoi(next);
+        } else if (arg == "--span") {
+            opts.span = std::max(1,atoi(next));
+        } else if (arg == "--seed") {
+            opts.seed = atoi(next);
+        } else
+            return false;
+    }
+
+    opts.minZoom = std::max(0,std::min(opts.minZoom,22));
+    opts.maxZoom = std::max(opts.minZoom,std::min(opts.maxZoom,22));
+    if (opts.threads.empty())
+    {
+        opts.threads.push_back(1);
+        const int numCores = (int)std::thread::hardware_concurrency();
+        opts.threads.push_back(std::max(2,numCores));
+    }
+    return true;
+}
+
+// Allocation counting.  Every operator new in the process comes through here.
+// Memory from malloc directly (including Eigen's aligned allocations) isn't counted.
+static thread_local uint64_t benchAllocCount = 0;
+static thread_local uint64_t benchAllocBytes = 0;
+
+void *operator new(size_t size)
+{
+    benchAllocCount++;
+    benchAllocBytes += size;
+    void *ptr = malloc(size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size,const std::nothrow_t &) noexcept
+{
+    benchAllocCount++;
+    benchAllocBytes += size;
+    return malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size,const std::nothrow_t &tag) noexcept
+{
+    return operator new(size,tag);
+}
+
+void operator delete(void *ptr) noexcept { free(ptr); }
+void operator delete[](void *ptr) noexcept { free(ptr); }
+void operator delete(void *ptr,size_t) noexcept { free(ptr); }
+void operator delete[](void *ptr,size_t) noexcept { free(ptr); }
+void operator delete(void *ptr,const std::nothrow_t &) noexcept { free(ptr); }
+void operator delete[](void *ptr,const std::nothrow_t &) noexcept { free(ptr); }
+
+/// Peak resident set size of the process, in kilobytes
+static long BenchPeakRSS()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return usage.ru_maxrss;
+}
+
+/// A tile in the corpus, already read into memory
+class MVTBenchTile
+{
+public:
+    QuadTreeIdentifier ident;
+    MbrD bbox,geoBBox;
+    std::vector<unsigned char> data;
+    int numFeatures;
+};
+
+/// Time spent in a single style's buildObjects
+class MVTBenchStyleStats
+{
+public:
+    MVTBenchStyleStats() : calls(0), features(0), ms(0.0) { }
+
+    int calls;
+    int features;
+    double ms;
+};
+
+/// What one worker thread saw.  Only that thread touches it until it's done.
+class MVTBenchWorker
+{
+public:
+    MVTBenchWorker() : tileStage("tile"), features(0), allocs(0), allocBytes(0) { }
+
+    BenchStage tileStage;
+    uint64_t features;
+    uint64_t allocs,allocBytes;
+    std::map<long long,MVTBenchStyleStats> styles;
+};
+
+static thread_local MVTBenchWorker *benchWorker = NULL;
+
+/// Parser that times each style's build as it goes by
+class MVTBenchParser : public MapboxVectorTileParser
+{
+public:
+    MVTBenchParser(VectorStyleDelegateImplRef styleDelegate) : MapboxVectorTileParser(styleDelegate) { }
+
+    virtual void buildForStyle(PlatformThreadInfo *styleInst,
+                               long long styleID,
+                               std::vector<VectorObjectRef> &vecObjs,
+                               VectorTileDataRef data) override
+    {
+        const auto start = std::chrono::steady_clock::now();
+        MapboxVectorTileParser::buildForStyle(styleInst, styleID, vecObjs, data);
+        if (benchWorker)
+        {
+            MVTBenchStyleStats &stats = benchWorker->styles[styleID];
+            stats.calls++;
+            stats.features += (int)vecObjs.size();
+            stats.ms += BenchSince(start);
+        }
+    }
+};
+
+/// Results for one thread count
+class MVTBenchRun
+{
+public:
+    MVTBenchRun() : numThreads(0), tiles(0), wallMS(0.0), peakRSS(0) { }
+
+    int numThreads;
+    int tiles;
+    double wallMS;
+    long peakRSS;
+    MVTBenchWorker total;
+};
+
+/// Tile bounds in the local (spherical mercator) system and geographic
+static void MVTBenchTileBounds(CoordSystem *coordSys,MVTBenchTile &tile)
+{
+    const QuadTreeIdentifier &ident = tile.ident;
+    const double tileSize = 2.0 * M_PI / (1 << ident.level);
+    tile.bbox = MbrD(Point2d(ident.x * tileSize - M_PI,ident.y * tileSize - M_PI),
+                     Point2d((ident.x+1) * tileSize - M_PI,(ident.y+1) * tileSize - M_PI));
+    const GeoCoord geoLL = coordSys->localToGeographic(Point3d(tile.bbox.ll().x(),tile.bbox.ll().y(),0.0));
+    const GeoCoord geoUR = coordSys->localToGeographic(Point3d(tile.bbox.ur().x(),tile.bbox.ur().y(),0.0));
+    tile.geoBBox = MbrD(Point2d(geoLL.x(),geoLL.y()),Point2d(geoUR.x(),geoUR.y()));
+}
+
+/// Numeric entries in a directory
+static std::vector<int> MVTBenchListDir(const std::string &dirName,bool files)
+{
+    std::vector<int> entries;
+    DIR *dir = opendir(dirName.c_str());
+    if (!dir)
+        return entries;
+    while (struct dirent *ent = readdir(dir))
+    {
+        const char *name = ent->d_name;
+        if (name[0] < '0' || name[0] > '9')
+            continue;
+        const char *ext = strchr(name, '.');
+        if (files != (ext != NULL))
+            continue;
+        if (files && strcmp(ext, ".mvt") != 0 && strcmp(ext, ".pbf") != 0)
+            continue;
+        entries.push_back(atoi(name));
+    }
+    closedir(dir);
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+    return entries;
+}
+
+/// Read every tile under the directory.  The directory is in the usual web (top down) order.
+static bool MVTBenchReadCorpus(const std::string &tileDir,std::vector<MVTBenchTile> &tiles)
+{
+    for (int level : MVTBenchListDir(tileDir, false))
+    {
+        const std::string levelDir = tileDir + "/" + std::to_string(level);
+        for (int x : MVTBenchListDir(levelDir, false))
+        {
+            const std::string colDir = levelDir + "/" + std::to_string(x);
+            for (int y : MVTBenchListDir(colDir, true))
+            {
+                MVTBenchTile tile;
+                tile.ident = QuadTreeIdentifier(x,(1<<level)-1-y,level);
+                const std::string base = colDir + "/" + std::to_string(y);
+                if (!ReadTileFile(base + ".mvt", tile.data) && !ReadTileFile(base + ".pbf", tile.data))
+                {
+                    fprintf(stderr, "Can't read tile %s\n", base.c_str());
+                    return false;
+                }
+                tiles.push_back(tile);
+            }
+        }
+    }
+
+    return true;
+}
+
+/// A square of tiles around the center at each level
+static void MVTBenchMakeCorpus(const MVTBenchOptions &opts,CoordSystem *coordSys,std::vector<MVTBenchTile> &tiles)
+{
+    SyntheticTileSource synthSource(opts.seed);
+    const Point3d center = coordSys->geographicToLocal3d(GeoCoord::CoordFromDegrees(opts.lon, opts.lat));
+    for (int level=opts.minZoom;level<=opts.maxZoom;level++)
+    {
+        const int numTiles = 1 << level;
+        const int span = std::min(opts.span,numTiles);
+        const double tileSize = 2.0 * M_PI / numTiles;
+        const int startX = std::max(0,std::min(numTiles-span,(int)floor((center.x() + M_PI) / tileSize) - span/2));
+        const int startY = std::max(0,std::min(numTiles-span,(int)floor((center.y() + M_PI) / tileSize) - span/2));
+        for (int ix=startX;ix<startX+span;ix++)
+            for (int iy=startY;iy<startY+span;iy++)
+            {
+                MVTBenchTile tile;
+                tile.ident = QuadTreeIdentifier(ix,iy,level);
+                tile.data = synthSource.makeTile(tile.ident);
+                tiles.push_back(tile);
+            }
+    }
+}
+
+static bool MVTBenchWriteCorpus(const std::string &outDir,const std::vector<MVTBenchTile> &tiles)
+{
+    mkdir(outDir.c_str(), 0755);
+    for (const MVTBenchTile &tile : tiles)
+    {
+        const std::string levelDir = outDir + "/" + std::to_string(tile.ident.level);
+        const std::string colDir = levelDir + "/" + std::to_string(tile.ident.x);
+        mkdir(levelDir.c_str(), 0755);
+        mkdir(colDir.c_str(), 0755);
+        const std::string fileName = colDir + "/" + std::to_string((1<<tile.ident.level)-1-tile.ident.y) + ".mvt";
+        if (!WriteTileFile(fileName, tile.data))
+        {
+            fprintf(stderr, "Can't write %s\n", fileName.c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// Features in the tile, whether or not the style wants them
+static int MVTBenchCountFeatures(const std::vector<unsigned char> &data)
+{
+    vector_tile::Tile tile;
+    if (!tile.ParseFromArray(data.data(), (int)data.size()))
+        return 0;
+    int count = 0;
+    for (int ii=0;ii<tile.layers_size();ii++)
+        count += tile.layers(ii).features_size();
+    return count;
+}
+
+/// Parse and build a single tile, then throw away the results
+static void MVTBenchRunTile(MVTBenchParser &parser,ComponentManager *compManager,PlatformThreadInfo *threadInfo,
+                            const MVTBenchTile &tile,MVTBenchWorker *worker)
+{
+    VectorTileDataRef tileData(new VectorTileData());
+    tileData->ident = tile.ident;
+    tileData->bbox = tile.bbox;
+    tileData->geoBBox = tile.geoBBox;
+
+    const uint64_t startAllocs = benchAllocCount, startAllocBytes = benchAllocBytes;
+    const auto start = std::chrono::steady_clock::now();
+    RawDataWrapper rawData((void *)tile.data.data(),tile.data.size(),false);
+    parser.parse(threadInfo, &rawData, tileData.get());
+    if (worker)
+    {
+        worker->tileStage.add(BenchSince(start));
+        worker->allocs += benchAllocCount - startAllocs;
+        worker->allocBytes += benchAllocBytes - startAllocBytes;
+        worker->features += tile.numFeatures;
+    }
+
+    // Nothing gets to the scene.  The managers still have to forget about it.
+    ChangeSet changes;
+    compManager->removeComponentObjects(threadInfo, tileData->compObjs, changes);
+    changes.insert(changes.end(), tileData->changes.begin(), tileData->changes.end());
+    tileData->changes.clear();
+    for (auto change : changes)
+        delete change;
+}
+
+/// Run the corpus through the given number of threads, each pulling the next tile as it goes
+static void MVTBenchRunThreads(MVTBenchParser &parser,ComponentManager *compManager,const std::vector<MVTBenchTile> &tiles,
+                               int numThreads,int repeat,MVTBenchRun *run)
+{
+    std::atomic<int> next(0);
+    const int numJobs = (int)tiles.size() * repeat;
+    std::vector<MVTBenchWorker> workers(numThreads);
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int ii=0;ii<numThreads;ii++)
+        threads.push_back(std::thread([&,ii]{
+            PlatformThreadInfo threadInfo;
+            MVTBenchWorker *worker = run ? &workers[ii] : NULL;
+            benchWorker = worker;
+            int which;
+            while ((which = next.fetch_add(1)) < numJobs)
+                MVTBenchRunTile(parser, compManager, &threadInfo, tiles[which % tiles.size()], worker);
+            benchWorker = NULL;
+        }));
+    for (auto &thread : threads)
+        thread.join();
+    if (!run)
+        return;
+
+    run->numThreads = numThreads;
+    run->tiles = numJobs;
+    run->wallMS = BenchSince(start);
+    run->peakRSS = BenchPeakRSS();
+    for (const MVTBenchWorker &worker : workers)
+    {
+        run->total.tileStage.samples.insert(run->total.tileStage.samples.end(), worker.tileStage.samples.begin(), worker.tileStage.samples.end());
+        run->total.features += worker.features;
+        run->total.allocs += worker.allocs;
+        run->total.allocBytes += worker.allocBytes;
+        for (const auto &it : worker.styles)
+        {
+            MVTBenchStyleStats &stats = run->total.styles[it.first];
+            stats.calls += it.second.calls;
+            stats.features += it.second.features;
+            stats.ms += it.second.ms;
+        }
+    }
+}
+
+/// Name of the style layer as it appears in the style sheet
+static std::string MVTBenchStyleName(VectorStyleDelegateImplRef styleSet,long long styleID)
+{
+    auto layer = std::dynamic_pointer_cast<MapboxVectorStyleLayer>(styleSet->styleForUUID(styleID));
+    if (layer && !layer->ident.empty())
+        return layer->ident;
+    return std::to_string(styleID);
+}
+
+static void MVTBenchAppendString(std::string &str,const std::string &what)
+{
+    str += '"';
+    for (char c : what)
+    {
+        if (c == '"' || c == '\\')
+            str += '\\';
+        if ((unsigned char)c >= 0x20)
+            str += c;
+    }
+    str += '"';
+}
+
+static void MVTBenchAppendNumber(std::string &str,const char *name,double val,bool comma = true)
+{
+    char buf[128];
+    snprintf(buf, sizeof(buf), "\"%s\":%.6g%s", name, val, comma ? "," : "");
+    str += buf;
+}
+
+static std::string MVTBenchJSON(const MVTBenchOptions &opts,const std::string &source,const std::vector<MVTBenchTile> &tiles,
+                                long baseRSS,VectorStyleDelegateImplRef styleSet,const std::vector<MVTBenchRun> &runs)
+{
+    uint64_t corpusFeatures = 0, corpusBytes = 0;
+    for (const MVTBenchTile &tile : tiles)
+    {
+        corpusFeatures += tile.numFeatures;
+        corpusBytes += tile.data.size();
+    }
+
+    std::string str = "{\"benchmark\":\"mvt\",\"format\":1,\"style\":";
+    MVTBenchAppendString(str, opts.styleFile.empty() ? "built-in" : opts.styleFile);
+    str += ",\"corpus\":{\"source\":";
+    MVTBenchAppendString(str, source);
+    str += ",";
+    MVTBenchAppendNumber(str, "tiles", tiles.size());
+    MVTBenchAppendNumber(str, "features", corpusFeatures);
+    MVTBenchAppendNumber(str, "bytes", corpusBytes, false);
+    str += "},";
+    MVTBenchAppendNumber(str, "repeat", opts.repeat);
+    MVTBenchAppendNumber(str, "base_rss_kb", baseRSS);
+    str += "\"runs\":[";
+    for (unsigned int ii=0;ii<runs.size();ii++)
+    {
+        const MVTBenchRun &run = runs[ii];
+        const BenchStage &stage = run.total.tileStage;
+        if (ii > 0)
+            str += ",";
+        str += "{";
+        MVTBenchAppendNumber(str, "threads", run.numThreads);
+        MVTBenchAppendNumber(str, "tiles", run.tiles);
+        MVTBenchAppendNumber(str, "wall_ms", run.wallMS);
+        MVTBenchAppendNumber(str, "tiles_per_sec", run.tiles / (run.wallMS / 1000.0));
+        MVTBenchAppendNumber(str, "features_per_sec", run.total.features / (run.wallMS / 1000.0));
+        str += "\"tile_ms\":{";
+        MVTBenchAppendNumber(str, "mean", stage.total() / std::max(1,(int)stage.samples.size()));
+        MVTBenchAppendNumber(str, "p50", stage.percentile(0.5));
+        MVTBenchAppendNumber(str, "p95", stage.percentile(0.95));
+        MVTBenchAppendNumber(str, "max", stage.percentile(1.0), false);
+        str += "},";
+        MVTBenchAppendNumber(str, "allocs_per_tile", run.total.allocs / (double)std::max(1,run.tiles));
+        MVTBenchAppendNumber(str, "alloc_bytes_per_tile", run.total.allocBytes / (double)std::max(1,run.tiles));
+        MVTBenchAppendNumber(str, "peak_rss_kb", run.peakRSS);
+        str += "\"styles\":[";
+        bool first = true;
+        for (const auto &it : run.total.styles)
+        {
+            if (!first)
+                str += ",";
+            first = false;
+            str += "{\"id\":";
+            MVTBenchAppendString(str, MVTBenchStyleName(styleSet, it.first));
+            str += ",";
+            MVTBenchAppendNumber(str, "calls", it.second.calls);
+            MVTBenchAppendNumber(str, "features", it.second.features);
+            MVTBenchAppendNumber(str, "total_ms", it.second.ms);
+            MVTBenchAppendNumber(str, "ms_per_tile", it.second.ms / std::max(1,run.tiles), false);
+            str += "}";
+        }
+        str += "]}";
+    }
+    str += "]}\n";
+
+    return str;
+}
+
+int main(int argc,char *argv[])
+{
+    MVTBenchOptions opts;
+    if (!ParseOptions(argc, argv, opts))
+    {
+        fprintf(stderr, "%s", BenchUsage);
+        return 1;
+    }
+
+    // The styles want a scene with the usual shaders in it, but nothing is drawn
+    CoordSystemDisplayAdapter *coordAdapter = new SphericalMercatorDisplayAdapter(0.0, GeoCoord::CoordFromDegrees(-180,-90), GeoCoord::CoordFromDegrees(180,90));
+    CoordSystem *coordSys = coordAdapter->getCoordSystem();
+    SceneRendererGLES_Headless *renderer = new SceneRendererGLES_Headless(256, 256);
+    Scene *scene = new SceneGLES(coordAdapter);
+    renderer->setScene(scene);
+    BenchAddPrograms(scene, renderer);
+
+    // Corpus
+    std::vector<MVTBenchTile> tiles;
+    std::string source = "synthetic";
+    if (!opts.tileDir.empty())
+    {
+        source = opts.tileDir;
+        if (!MVTBenchReadCorpus(opts.tileDir, tiles))
+            return 1;
+    } else
+        MVTBenchMakeCorpus(opts, coordSys, tiles);
+    if (tiles.empty())
+    {
+        fprintf(stderr, "No tiles in %s\n", opts.tileDir.c_str());
+        return 1;
+    }
+    if (!opts.writeDir.empty())
+    {
+        if (!MVTBenchWriteCorpus(opts.writeDir, tiles))
+            return 1;
+        printf("wrote %d tiles to %s\n", (int)tiles.size(), opts.writeDir.c_str());
+        return 0;
+    }
+    for (MVTBenchTile &tile : tiles)
+    {
+        MVTBenchTileBounds(coordSys, tile);
+        tile.numFeatures = MVTBenchCountFeatures(tile.data);
+    }
+
+    // Style
+    std::string styleJSON = BenchDefaultStyle;
+    if (!opts.styleFile.empty())
+    {
+        std::vector<unsigned char> styleData;
+        if (!ReadTileFile(opts.styleFile, styleData))
+        {
+            fprintf(stderr, "Can't read style %s\n", opts.styleFile.c_str());
+            return 1;
+        }
+        styleJSON = std::string(styleData.begin(),styleData.end());
+    }
+    PlatformThreadInfo threadInfo;
+    MutableDictionary_AndroidRef styleDict(new MutableDictionary_Android());
+    if (!styleDict->parseJSON(styleJSON))
+    {
+        fprintf(stderr, "Can't parse style JSON\n");
+        return 1;
+    }
+    MapboxVectorStyleSetImpl_HeadlessRef styleSet(new MapboxVectorStyleSetImpl_Headless(scene,coordSys,VectorStyleSettingsImplRef(new VectorStyleSettingsImpl(1.0))));
+    if (!styleSet->parse(&threadInfo, styleDict))
+    {
+        fprintf(stderr, "Can't set up style\n");
+        return 1;
+    }
+    MVTBenchParser parser(styleSet);
+    parser.localCoords = false;
+    if (opts.geomCacheMB > 0)
+        parser.setGeometryCache(TileGeometryCacheRef(new TileGeometryCache((size_t)opts.geomCacheMB * 1024 * 1024)));
+    ComponentManager *compManager = (ComponentManager *)scene->getManager(kWKComponentManager);
+
+    // Warm up so the first run doesn't pay for first touches
+    for (int ii=0;ii<opts.warmup;ii++)
+        MVTBenchRunThreads(parser, compManager, tiles, 1, 1, NULL);
+    const long baseRSS = BenchPeakRSS();
+
+    std::vector<MVTBenchRun> runs(opts.threads.size());
+    for (unsigned int ii=0;ii<opts.threads.size();ii++)
+        MVTBenchRunThreads(parser, compManager, tiles, opts.threads[ii], opts.repeat, &runs[ii]);
+
+    const std::string json = MVTBenchJSON(opts, source, tiles, baseRSS, styleSet, runs);
+    if (opts.jsonFile == "-")
+    {
+        fputs(json.c_str(), stdout);
+    } else {
+        uint64_t corpusFeatures = 0;
+        for (const MVTBenchTile &tile : tiles)
+            corpusFeatures += tile.numFeatures;
+        printf("wgmaply_mvtbench: %d tiles, %llu features, %s corpus, %d passes\n\n", (int)tiles.size(),
+               (unsigned long long)corpusFeatures, source.c_str(), opts.repeat);
+        printf("%7s %9s %12s %9s %9s %9s %11s %14s %11s\n", "threads", "tiles/s", "features/s", "mean ms", "p50 ms", "p95 ms",
+               "allocs/tile", "KB allocd/tile", "peak RSS MB");
+        for (const MVTBenchRun &run : runs)
+        {
+            const BenchStage &stage = run.total.tileStage;
+            printf("%7d %9.1f %12.0f %9.3f %9.3f %9.3f %11.0f %14.1f %11.1f\n", run.numThreads, run.tiles / (run.wallMS / 1000.0),
+                   run.total.features / (run.wallMS / 1000.0), stage.total() / std::max(1,(int)stage.samples.size()),
+                   stage.percentile(0.5), stage.percentile(0.95), run.total.allocs / (double)std::max(1,run.tiles),
+                   run.total.allocBytes / 1024.0 / std::max(1,run.tiles), run.peakRSS / 1024.0);
+        }
+
+        // Per style numbers from the single threaded run, which has the least contention
+        const MVTBenchRun &styleRun = runs.front();
+        printf("\n%-24s %8s %10s %10s %12s\n", "style", "calls", "features", "total ms", "ms/tile");
+        for (const auto &it : styleRun.total.styles)
+            printf("%-24s %8d %10d %10.1f %12.4f\n", MVTBenchStyleName(styleSet, it.first).c_str(), it.second.calls,
+                   it.second.features, it.second.ms, it.second.ms / std::max(1,styleRun.tiles));
+
+        if (parser.getGeometryCache())
+        {
+            const TileGeometryCache::Stats stats = parser.getGeometryCache()->getStats();
+            printf("\ngeometry cache: %.1f%% hit rate, %llu of %llu hits partial, %llu of %llu stores partial, %.1f MB in %d tiles\n",
+                   100.0 * stats.hitRate(), stats.partialHits, stats.hits + stats.diskHits, stats.partialStores, stats.stores,
+                   stats.memoryUsed / (1024.0 * 1024.0), stats.numInMemory);
+        }
+
+        if (!opts.jsonFile.empty())
+        {
+            if (WriteTileFile(opts.jsonFile, std::vector<unsigned char>(json.begin(),json.end())))
+                printf("\nresults written to %s\n", opts.jsonFile.c_str());
+            else
+                fprintf(stderr, "Can't write results to %s\n", opts.jsonFile.c_str());
+        }
+    }
+
+    parser.styleDelegate = NULL;
+    styleSet = NULL;
+    delete scene;
+    delete renderer;
+    delete coordAdapter;
+
+    return 0;
+}
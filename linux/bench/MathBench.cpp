@@ -0,0 +1,225 @@
+/*
+ *  MathBench.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <stdio.h>
+#import <stdlib.h>
+#import <math.h>
+#import <chrono>
+#import <random>
+#import <string>
+#import <vector>
+#import "WhirlyGlobe.h"
+#import "SceneRenderer_Headless.h"
+#import "BenchSupport.h"
+
+using namespace WhirlyKit;
+using namespace Eigen;
+
+/** Times the view math that runs every frame, for comparing builds with
+    and without WGMAPLY_VECTORIZE_MATH.
+
+    A globe view is flown around and each frame we time:
+      the matrix setup at the top of SceneRendererGLES::render(),
+      a whole render() of an empty scene, which is mostly that setup,
+      making a view state, which is what layout and the loaders work from,
+      DisplaySolid construction, importance and on screen checks for a set of tiles,
+      and CheckPointAndNormFacing, float and double, over points on the globe.
+    The checksum at the end only depends on the math, so both builds should
+    print about the same one.
+  */
+
+static const char *BenchUsage =
+"usage: wgmaply_mathbench [options]\n"
+"  --frames N       Frames along the camera path (300)\n"
+"  --points N       Points for the facing checks (20000)\n"
+"  --level N        Tiles at this level go through DisplaySolid (4)\n"
+"  --size WxH       Framebuffer size (1024x768)\n";
+
+// The matrix work SceneRendererGLES::render() does before it looks at the scene
+static double RenderMatrixSetup(View *theView,const Point2f &frameSize)
+{
+    Eigen::Matrix4d modelTrans4d = theView->calcModelMatrix();
+    Eigen::Matrix4f modelTrans = Matrix4dToMatrix4f(modelTrans4d);
+    Eigen::Matrix4d viewTrans4d = theView->calcViewMatrix();
+    Eigen::Matrix4f viewTrans = Matrix4dToMatrix4f(viewTrans4d);
+    Eigen::Matrix4d projMat4d = theView->calcProjectionMatrix(frameSize,0.0);
+    Eigen::Matrix4f projMat = Matrix4dToMatrix4f(projMat4d);
+    Eigen::Matrix4f modelAndViewMat = viewTrans * modelTrans;
+    Eigen::Matrix4d modelAndViewMat4d = viewTrans4d * modelTrans4d;
+    Eigen::Matrix4d pvMat = projMat4d * viewTrans4d;
+    Eigen::Matrix4f mvpMat = projMat * (modelAndViewMat);
+    Eigen::Matrix4f mvpNormalMat4f = mvpMat.inverse().transpose();
+    Eigen::Matrix4d modelAndViewNormalMat4d = modelAndViewMat4d.inverse().transpose();
+    Eigen::Matrix4f mvpInvMat = mvpMat.inverse();
+    Matrix4f pvMat4f = Matrix4dToMatrix4f(pvMat);
+    Matrix4dVector offsetMatrices;
+    Point2f frameSizeCopy = frameSize;
+    theView->getOffsetMatrices(offsetMatrices, frameSize, 0.0);
+    Point2d screenSize = theView->screenSizeInDisplayCoords(frameSizeCopy);
+    Eigen::Matrix4f modelTransInv = modelTrans.inverse();
+    Vector4f eyeVec4 = modelTransInv * Vector4f(0,0,1,0);
+    Eigen::Matrix4f fullTransInv = modelAndViewMat.inverse();
+    Vector4f fullEyeVec4 = fullTransInv * Vector4f(0,0,1,0);
+    Vector4d eyeVec4d = modelTrans4d.inverse() * Vector4d(0,0,1,0.0);
+
+    // Something from everything, so none of it gets optimized out
+    return mvpNormalMat4f(0,0) + modelAndViewNormalMat4d(1,1) + mvpInvMat(2,2) + pvMat4f(3,3) +
+           offsetMatrices.size() + screenSize.x() + eyeVec4.z() + fullEyeVec4.z() + eyeVec4d.z();
+}
+
+int main(int argc,char *argv[])
+{
+    int frames = 300;
+    int numPoints = 20000;
+    int level = 4;
+    int width = 1024, height = 768;
+    for (int ii=1;ii<argc;ii++)
+    {
+        const std::string arg = argv[ii];
+        if (arg == "--frames" && ii+1 < argc)
+            frames = std::max(1,atoi(argv[++ii]));
+        else if (arg == "--points" && ii+1 < argc)
+            numPoints = std::max(1,atoi(argv[++ii]));
+        else if (arg == "--level" && ii+1 < argc)
+            level = std::min(std::max(0,atoi(argv[++ii])),8);
+        else if (arg == "--size" && ii+1 < argc && sscanf(argv[ii+1], "%dx%d", &width, &height) == 2)
+            ii++;
+        else {
+            fprintf(stderr, "%s", BenchUsage);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+#if defined(WHIRLYKIT_VECTORIZE_MATH)
+    const char *mode = "vectorized";
+#else
+    const char *mode = "scalar";
+#endif
+#if defined(EIGEN_VECTORIZE)
+    const char *eigenMode = "on";
+#else
+    const char *eigenMode = "off";
+#endif
+    printf("math: %s, Eigen vectorization %s, C++ %ld\n\n", mode, eigenMode, (long)__cplusplus);
+
+    // Same setup as a globe on the platforms
+    CoordSystemDisplayAdapter *coordAdapter = new FakeGeocentricDisplayAdapter();
+    CoordSystem *coordSys = coordAdapter->getCoordSystem();
+    WhirlyGlobe::GlobeView *globeView = new WhirlyGlobe::GlobeView(coordAdapter);
+    SceneRendererGLES_Headless *renderer = new SceneRendererGLES_Headless(width, height);
+    SceneGLES *scene = new SceneGLES(coordAdapter);
+    renderer->setScene(scene);
+    renderer->setView(globeView);
+    const Point2f frameSize(width,height);
+
+    // Every tile at the given level
+    std::vector<std::pair<QuadTreeIdentifier,Mbr> > tiles;
+    const int numTiles = 1<<level;
+    for (int ty=0;ty<numTiles;ty++)
+        for (int tx=0;tx<numTiles;tx++)
+        {
+            const double cellX = 2.0 * M_PI / numTiles, cellY = M_PI / numTiles;
+            const Point2f ll(-M_PI + tx * cellX, -M_PI/2.0 + ty * cellY);
+            tiles.push_back(std::make_pair(QuadTreeIdentifier(tx,ty,level),Mbr(ll,ll + Point2f(cellX,cellY))));
+        }
+
+    // Points on the globe, where the normal is the point
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> unit(-1.0,1.0);
+    Point3fVector ptsf,normsf;
+    Point3dVector ptsd,normsd;
+    for (int ii=0;ii<numPoints;ii++)
+    {
+        const Point3d pt = Point3d(unit(rng),unit(rng),unit(rng)).normalized();
+        ptsd.push_back(pt);
+        normsd.push_back(pt);
+        ptsf.push_back(pt.cast<float>());
+        normsf.push_back(pt.cast<float>());
+    }
+
+    BenchStage setupStage("matrix setup"),renderStage("render"),viewStateStage("view state");
+    BenchStage solidStage("display solid"),facingFStage("facing float"),facingDStage("facing double");
+    double checksum = 0.0;
+    int numOnScreen = 0,numFacing = 0;
+    for (int frame=0;frame<frames;frame++)
+    {
+        // Circle around while zooming in and out
+        const double t = (double)frame / frames;
+        const GeoCoord loc = GeoCoord::CoordFromDegrees(-180.0 + 360.0 * t, 60.0 * sin(4.0 * M_PI * t));
+        globeView->setRotQuat(globeView->makeRotationToGeoCoord(loc, true), false);
+        globeView->setHeightAboveGlobe(0.05 + 1.5 * (0.5 + 0.5 * cos(6.0 * M_PI * t)), false);
+
+        auto start = std::chrono::steady_clock::now();
+        checksum += RenderMatrixSetup(globeView,frameSize);
+        setupStage.add(BenchSince(start));
+
+        start = std::chrono::steady_clock::now();
+        renderer->render(1/60.0);
+        renderStage.add(BenchSince(start));
+
+        start = std::chrono::steady_clock::now();
+        ViewStateRef viewState = globeView->makeViewState(renderer);
+        viewStateStage.add(BenchSince(start));
+
+        start = std::chrono::steady_clock::now();
+        for (const auto &tile : tiles)
+        {
+            DisplaySolid solid(tile.first,tile.second,0.0,0.0,coordSys,coordAdapter);
+            if (!solid.valid)
+                continue;
+            checksum += solid.importanceForViewState(viewState.get(),frameSize);
+            if (solid.isOnScreenForViewState(viewState.get(),frameSize))
+                numOnScreen++;
+        }
+        solidStage.add(BenchSince(start));
+
+        const Eigen::Matrix4d &mvMat4d = viewState->fullMatrices[0];
+        const Eigen::Matrix4d &mvNormalMat4d = viewState->fullNormalMatrices[0];
+        const Eigen::Matrix4f mvMat = Matrix4dToMatrix4f(mvMat4d);
+        const Eigen::Matrix4f mvNormalMat = Matrix4dToMatrix4f(mvNormalMat4d);
+        start = std::chrono::steady_clock::now();
+        for (int ii=0;ii<numPoints;ii++)
+            if (CheckPointAndNormFacing(ptsf[ii],normsf[ii],mvMat,mvNormalMat) > 0.0)
+                numFacing++;
+        facingFStage.add(BenchSince(start));
+
+        start = std::chrono::steady_clock::now();
+        for (int ii=0;ii<numPoints;ii++)
+            if (CheckPointAndNormFacing(ptsd[ii],normsd[ii],mvMat4d,mvNormalMat4d) > 0.0)
+                numFacing++;
+        facingDStage.add(BenchSince(start));
+    }
+
+    printf("%-14s %8s %10s %8s %8s %8s %8s\n", "stage", "count", "total ms", "mean", "p50", "p95", "max");
+    setupStage.report();
+    renderStage.report();
+    viewStateStage.report();
+    solidStage.report();
+    facingFStage.report();
+    facingDStage.report();
+    printf("\n%d tiles on screen, %d points facing, checksum %.6g\n", numOnScreen, numFacing, checksum);
+
+    delete scene;
+    delete renderer;
+    delete globeView;
+    delete coordAdapter;
+
+    return 0;
+}
@@ -0,0 +1,172 @@
+/*
+ *  ParticleBench.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <stdio.h>
+#import <stdlib.h>
+#import <string.h>
+#import <chrono>
+#import <random>
+#import <string>
+#import <vector>
+#import "WhirlyGlobe.h"
+#import "ParticleSystemCPU.h"
+#import "BenchSupport.h"
+
+using namespace WhirlyKit;
+
+/** Steps a CPU particle system through ParticleSystemCPU::update().
+
+    The SIMD and scalar kernels are run side by side first and the vertex data
+    they hand back for upload is compared byte for byte.  We fail if it differs.
+    Then the SIMD kernels are timed for each of the thread counts.
+  */
+
+static const char *BenchUsage =
+"usage: wgmaply_particlebench [options]\n"
+"  --particles N    Total particles (1048576)\n"
+"  --batch N        Particles per batch (16384)\n"
+"  --threads LIST   Comma separated thread counts (1,2,4)\n"
+"  --steps N        Updates per timing (60)\n";
+
+static std::vector<int> ParseList(const char *str)
+{
+    std::vector<int> vals;
+    for (const char *s = str; *s; )
+    {
+        vals.push_back(atoi(s));
+        const char *comma = strchr(s, ',');
+        if (!comma)
+            break;
+        s = comma+1;
+    }
+    return vals;
+}
+
+// Position and direction, like the particle examples, plus the age we fill in
+static std::vector<SingleVertexAttributeInfo> ParticleAttrs()
+{
+    return {SingleVertexAttributeInfo(a_PositionNameID,BDFloat3Type),
+            SingleVertexAttributeInfo(a_dirNameID,BDFloat3Type),
+            SingleVertexAttributeInfo(StringIndexer::getStringID("a_age"),BDFloatType)};
+}
+
+// Fill every batch with the same random particles, so two systems start out identical
+static ParticleSystemCPURef MakeSystem(int numParticles,int batchSize,int numThreads,bool allowSIMD)
+{
+    const auto attrs = ParticleAttrs();
+    int vertexSize = 0;
+    for (const auto &attr : attrs)
+        vertexSize += attr.size();
+    ParticleSystemCPURef system(new ParticleSystemCPU(attrs,vertexSize,numParticles,batchSize,10.0,0.0,numThreads));
+    if (!system->isValid())
+        return ParticleSystemCPURef();
+    system->setAllowSIMD(allowSIMD);
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> unit(-1.0,1.0);
+    std::vector<float> pos(batchSize*3),dir(batchSize*3);
+    const int numBatches = numParticles / batchSize;
+    for (int bi=0;bi<numBatches;bi++)
+    {
+        for (auto &val : pos)
+            val = unit(rng);
+        for (auto &val : dir)
+            val = unit(rng) * 0.1f;
+        // Stagger the start times so the batches age differently
+        system->addBatch(bi,{&pos[0],&dir[0],NULL},bi * 0.05);
+    }
+
+    return system;
+}
+
+int main(int argc,char *argv[])
+{
+    int numParticles = 1<<20;
+    int batchSize = 16384;
+    std::vector<int> threads = {1,2,4};
+    int steps = 60;
+    for (int ii=1;ii<argc;ii++)
+    {
+        const std::string arg = argv[ii];
+        if (arg == "--particles" && ii+1 < argc)
+            numParticles = std::max(1,atoi(argv[++ii]));
+        else if (arg == "--batch" && ii+1 < argc)
+            batchSize = std::max(1,atoi(argv[++ii]));
+        else if (arg == "--threads" && ii+1 < argc)
+            threads = ParseList(argv[++ii]);
+        else if (arg == "--steps" && ii+1 < argc)
+            steps = std::max(1,atoi(argv[++ii]));
+        else {
+            fprintf(stderr, "%s", BenchUsage);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    // Check the kernels against each other with the bytes we'd upload
+    ParticleSystemCPURef scalarSys = MakeSystem(numParticles,batchSize,1,false);
+    ParticleSystemCPURef simdSys = MakeSystem(numParticles,batchSize,1,true);
+    if (!scalarSys || !simdSys)
+    {
+        fprintf(stderr, "Couldn't set up %d particles in batches of %d\n", numParticles, batchSize);
+        return 1;
+    }
+    std::vector<unsigned char> scalarOut,simdOut;
+    auto gather = [](std::vector<unsigned char> &out) {
+        return [&out](int offset,const void *data,int len) {
+            if (out.size() < (size_t)(offset + len))
+                out.resize(offset + len);
+            memcpy(&out[offset], data, len);
+        };
+    };
+    bool mismatch = false;
+    for (int si=1;si<=steps && !mismatch;si++)
+    {
+        const TimeInterval now = si / 60.0;
+        const int scalarLive = scalarSys->update(now,gather(scalarOut));
+        const int simdLive = simdSys->update(now,gather(simdOut));
+        if (scalarLive != simdLive || scalarOut != simdOut)
+        {
+            fprintf(stderr, "Scalar and SIMD kernels differ at step %d (%d and %d live)\n", si, scalarLive, simdLive);
+            mismatch = true;
+        }
+    }
+    scalarSys.reset();
+    simdSys.reset();
+
+    printf("%-8s %8s %10s %10s %14s\n", "kernel", "threads", "particles", "ms/step", "particles/s");
+    for (int pass=0;pass<2;pass++)
+    {
+        const bool allowSIMD = pass == 1;
+        for (int numThreads : threads)
+        {
+            ParticleSystemCPURef system = MakeSystem(numParticles,batchSize,numThreads,allowSIMD);
+            system->update(0.0,ParticleSystemCPU::UploadFunc());
+            long long moved = 0;
+            const auto start = std::chrono::steady_clock::now();
+            for (int si=1;si<=steps;si++)
+                moved += system->update(si / 60.0,ParticleSystemCPU::UploadFunc());
+            const double ms = BenchSince(start);
+            printf("%-8s %8d %10d %10.2f %14.0f\n", allowSIMD ? "simd" : "scalar", numThreads, numParticles,
+                   ms / steps, ms > 0.0 ? moved / (ms / 1000.0) : 0.0);
+        }
+    }
+
+    return mismatch ? 1 : 0;
+}
@@ -0,0 +1,226 @@
+/*
+ *  PixelConversionBench.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <stdio.h>
+#import <stdlib.h>
+#import <string.h>
+#import <chrono>
+#import <random>
+#import <string>
+#import <vector>
+#import "WhirlyGlobe.h"
+#import "PixelConversion.h"
+#import "MipmapGenerator.h"
+#import "BenchSupport.h"
+
+using namespace WhirlyKit;
+
+/** Times the RGBA to 16 and 8 bit texture conversions.
+
+    Each format is run with the scalar loop, the SIMD kernels, the SIMD kernels
+    in place and split across threads.  The scalar and SIMD results are compared
+    byte for byte first, and we fail if they differ.
+ 
+    After that it times the mipmap chains, both the 2x2 downsample on its own
+    and a full 565 chain built in one pass versus shrinking first and converting after.
+  */
+
+static const char *BenchUsage =
+"usage: wgmaply_pixelbench [options]\n"
+"  --sizes LIST     Comma separated image sizes on a side (256,512,2048)\n"
+"  --threads LIST   Comma separated thread counts for the banded runs (2,4)\n"
+"  --repeat N       Conversions per timing (20)\n";
+
+class PixelBenchFormat
+{
+public:
+    const char *name;
+    TextureType format;
+    WKSingleByteSource source;
+};
+
+static const PixelBenchFormat PixelBenchFormats[] = {
+    {"565",TexTypeShort565,WKSingleRGB},
+    {"4444",TexTypeShort4444,WKSingleRGB},
+    {"5551",TexTypeShort5551,WKSingleRGB},
+    {"RG",TexTypeDoubleChannel,WKSingleRGB},
+    {"A",TexTypeSingleChannel,WKSingleAlpha},
+    {"R",TexTypeSingleChannel,WKSingleRed},
+    {"RGB",TexTypeSingleChannel,WKSingleRGB},
+};
+
+static std::vector<int> ParseList(const char *str)
+{
+    std::vector<int> vals;
+    for (const char *s = str; *s; )
+    {
+        vals.push_back(atoi(s));
+        const char *comma = strchr(s, ',');
+        if (!comma)
+            break;
+        s = comma+1;
+    }
+    return vals;
+}
+
+// Megapixels per second for repeat conversions
+template<typename Func> static double TimeConversions(int repeat,int numPixels,Func func)
+{
+    func();
+    const auto start = std::chrono::steady_clock::now();
+    for (int ii=0;ii<repeat;ii++)
+        func();
+    const double ms = BenchSince(start);
+    return ms > 0.0 ? (double)numPixels * repeat / (ms * 1000.0) : 0.0;
+}
+
+int main(int argc,char *argv[])
+{
+    std::vector<int> sizes = {256,512,2048};
+    std::vector<int> threads = {2,4};
+    int repeat = 20;
+    for (int ii=1;ii<argc;ii++)
+    {
+        const std::string arg = argv[ii];
+        if (arg == "--sizes" && ii+1 < argc)
+            sizes = ParseList(argv[++ii]);
+        else if (arg == "--threads" && ii+1 < argc)
+            threads = ParseList(argv[++ii]);
+        else if (arg == "--repeat" && ii+1 < argc)
+            repeat = std::max(1,atoi(argv[++ii]));
+        else {
+            fprintf(stderr, "%s", BenchUsage);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    std::mt19937 rng(1);
+    bool mismatch = false;
+
+    printf("%-6s %6s %10s %10s %10s", "format", "size", "scalar", "simd", "in place");
+    for (int numThreads : threads)
+        printf(" %7d thr", numThreads);
+    printf("   (Mpix/s)\n");
+
+    for (int size : sizes)
+    {
+        const int numPixels = size*size;
+        std::vector<unsigned char> rgba(numPixels*4);
+        for (auto &val : rgba)
+            val = rng() & 0xff;
+        std::vector<unsigned char> work(rgba.size());
+        std::vector<unsigned char> scalarOut(numPixels*2),simdOut(numPixels*2);
+
+        for (const auto &fmt : PixelBenchFormats)
+        {
+            const int outRowBytes = size * PixelConversionBytesPerPixel(fmt.format);
+
+            // Odd lengths, so we hit the scalar tail too
+            const int checkPixels = numPixels - 7;
+            ConvertRGBAPixelRun(fmt.format, fmt.source, &rgba[0], &scalarOut[0], checkPixels, false);
+            ConvertRGBAPixelRun(fmt.format, fmt.source, &rgba[0], &simdOut[0], checkPixels, true);
+            memcpy(&work[0], &rgba[0], rgba.size());
+            ConvertRGBAPixelRun(fmt.format, fmt.source, &work[0], &work[0], checkPixels, true);
+            const size_t checkLen = (size_t)checkPixels * PixelConversionBytesPerPixel(fmt.format);
+            if (memcmp(&scalarOut[0], &simdOut[0], checkLen) || memcmp(&scalarOut[0], &work[0], checkLen))
+            {
+                fprintf(stderr, "%s: scalar and SIMD conversions differ at size %d\n", fmt.name, size);
+                mismatch = true;
+            }
+
+            const double scalarRate = TimeConversions(repeat, numPixels, [&]{
+                ConvertRGBAPixelRun(fmt.format, fmt.source, &rgba[0], &scalarOut[0], numPixels, false);
+            });
+            const double simdRate = TimeConversions(repeat, numPixels, [&]{
+                ConvertRGBAPixels(fmt.format, fmt.source, &rgba[0], size, size, &simdOut[0], outRowBytes, 1);
+            });
+            // The copy back in is part of what we time, so this is pessimistic
+            const double inPlaceRate = TimeConversions(repeat, numPixels, [&]{
+                memcpy(&work[0], &rgba[0], rgba.size());
+                ConvertRGBAPixels(fmt.format, fmt.source, &work[0], size, size, &work[0], outRowBytes, 1);
+            });
+            printf("%-6s %6d %10.1f %10.1f %10.1f", fmt.name, size, scalarRate, simdRate, inPlaceRate);
+            for (int numThreads : threads)
+            {
+                const double rate = TimeConversions(repeat, numPixels, [&]{
+                    ConvertRGBAPixels(fmt.format, fmt.source, &rgba[0], size, size, &simdOut[0], outRowBytes, numThreads);
+                });
+                printf(" %11.1f", rate);
+            }
+            printf("\n");
+        }
+    }
+
+    printf("\n%-6s %6s %10s %10s %10s %10s %10s %10s   (Mpix/s of the base level)\n", "mipmap", "size",
+           "box", "box simd", "sRGB", "sRGB simd", "chain", "separate");
+    for (int size : sizes)
+    {
+        const int numPixels = size*size;
+        std::vector<unsigned char> rgba(numPixels*4);
+        for (auto &val : rgba)
+            val = rng() & 0xff;
+        std::vector<unsigned char> scalarOut(numPixels),simdOut(numPixels);
+        const int halfSize = std::max(1,size/2);
+
+        double downRates[4];
+        for (int which=0;which<4;which++)
+        {
+            const bool sRGB = which >= 2, allowSIMD = which % 2;
+            downRates[which] = TimeConversions(repeat, numPixels, [&]{
+                DownsampleRGBA(&rgba[0], size, size, allowSIMD ? &simdOut[0] : &scalarOut[0], sRGB, allowSIMD);
+            });
+            if (allowSIMD && memcmp(&scalarOut[0], &simdOut[0], halfSize*halfSize*4))
+            {
+                fprintf(stderr, "mipmap: scalar and SIMD %s downsamples differ at size %d\n", sRGB ? "sRGB" : "box", size);
+                mismatch = true;
+            }
+        }
+
+        std::vector<RawDataRef> levels;
+        const double chainRate = TimeConversions(repeat, numPixels, [&]{
+            BuildMipmapChain(&rgba[0], size, size, TexTypeShort565, WKSingleRGB, false, levels);
+        });
+        // The way you'd do it without the combined pass: shrink everything, then convert each level
+        const double separateRate = TimeConversions(repeat, numPixels, [&]{
+            const int numLevels = MipmapNumLevels(size,size);
+            std::vector<std::vector<unsigned char> > rgbaLevels(numLevels);
+            std::vector<RawDataRef> convLevels(numLevels);
+            for (int level=1;level<numLevels;level++)
+            {
+                const int levelSize = MipmapLevelSize(size,level), prevSize = MipmapLevelSize(size,level-1);
+                rgbaLevels[level].resize(levelSize*levelSize*4);
+                DownsampleRGBA(level == 1 ? &rgba[0] : &rgbaLevels[level-1][0], prevSize, prevSize, &rgbaLevels[level][0], false);
+            }
+            for (int level=0;level<numLevels;level++)
+            {
+                const int levelSize = MipmapLevelSize(size,level);
+                const int rowBytes = MipmapRowBytes(TexTypeShort565,levelSize);
+                unsigned char *converted = (unsigned char *)malloc(rowBytes*levelSize);
+                ConvertRGBAPixels(TexTypeShort565, WKSingleRGB, level == 0 ? &rgba[0] : &rgbaLevels[level][0], levelSize, levelSize, converted, rowBytes, 1);
+                convLevels[level] = RawDataRef(new RawDataWrapper(converted,rowBytes*levelSize,true));
+            }
+        });
+
+        printf("%-6s %6d %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n", "", size,
+               downRates[0], downRates[1], downRates[2], downRates[3], chainRate, separateRate);
+    }
+
+    return mismatch ? 1 : 0;
+}
@@ -0,0 +1,161 @@
+/*
+ *  ProjectionBench.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <stdio.h>
+#import <stdlib.h>
+#import <math.h>
+#import <chrono>
+#import <random>
+#import <string>
+#import <thread>
+#import <vector>
+#import "WhirlyGlobe.h"
+#import "SceneRenderer_Headless.h"
+#import "BenchSupport.h"
+
+using namespace WhirlyKit;
+
+/** Times ScreenProjectionCache::project() on the calling thread against
+    the same cache split across its worker threads.
+
+    Layout projects every object it's tracking once per view change, so
+    each round alternates between two view states to force a reprojection.
+    The "new cache" row makes a fresh cache each round, which starts the
+    threads each time, to show what keeping them around saves.
+    The threaded results have to match the single threaded ones.
+    The cache won't use more threads than the hardware has, so run this
+    on a multi core machine to see the split.
+  */
+
+static const char *BenchUsage =
+"usage: wgmaply_projbench [options]\n"
+"  --points N       World locations to project (100000)\n"
+"  --rounds N       Projections per mode (200)\n"
+"  --threads N      Threads for the threaded modes (4)\n"
+"  --size WxH       Framebuffer size (1024x768)\n";
+
+int main(int argc,char *argv[])
+{
+    int numPoints = 100000;
+    int rounds = 200;
+    int numThreads = 4;
+    int width = 1024, height = 768;
+    for (int ii=1;ii<argc;ii++)
+    {
+        const std::string arg = argv[ii];
+        if (arg == "--points" && ii+1 < argc)
+            numPoints = std::max(1,atoi(argv[++ii]));
+        else if (arg == "--rounds" && ii+1 < argc)
+            rounds = std::max(1,atoi(argv[++ii]));
+        else if (arg == "--threads" && ii+1 < argc)
+            numThreads = std::max(2,atoi(argv[++ii]));
+        else if (arg == "--size" && ii+1 < argc && sscanf(argv[ii+1], "%dx%d", &width, &height) == 2)
+            ii++;
+        else {
+            fprintf(stderr, "%s", BenchUsage);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    CoordSystemDisplayAdapter *coordAdapter = new FakeGeocentricDisplayAdapter();
+    WhirlyGlobe::GlobeView *globeView = new WhirlyGlobe::GlobeView(coordAdapter);
+    SceneRendererGLES_Headless *renderer = new SceneRendererGLES_Headless(width, height);
+    SceneGLES *scene = new SceneGLES(coordAdapter);
+    renderer->setScene(scene);
+    renderer->setView(globeView);
+    const Point2f frameSize(width,height);
+
+    // Two nearby views, so both have plenty on screen
+    ViewStateRef viewStates[2];
+    for (int vi=0;vi<2;vi++)
+    {
+        const GeoCoord loc = GeoCoord::CoordFromDegrees(-0.1276 + vi, 51.5072);
+        globeView->setRotQuat(globeView->makeRotationToGeoCoord(loc, true), false);
+        globeView->setHeightAboveGlobe(0.5, false);
+        viewStates[vi] = globeView->makeViewState(renderer);
+    }
+
+    // Points on the globe
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> unit(-1.0,1.0);
+    Point3dVector pts;
+    pts.reserve(numPoints);
+    for (int ii=0;ii<numPoints;ii++)
+        pts.push_back(Point3d(unit(rng),unit(rng),unit(rng)).normalized());
+    auto fillCache = [&pts](ScreenProjectionCache &cache)
+    {
+        cache.reserve(pts.size());
+        for (const Point3d &pt : pts)
+            cache.addWorldLoc(pt);
+    };
+
+    ScreenProjectionCache singleCache,pooledCache;
+    singleCache.setMaxThreads(1);
+    pooledCache.setMaxThreads(numThreads);
+    fillCache(singleCache);
+    fillCache(pooledCache);
+
+    BenchStage singleStage("calling thread"),pooledStage("worker pool"),freshStage("new cache");
+    int mismatches = 0;
+    for (int round=0;round<rounds;round++)
+    {
+        ViewStateRef viewState = viewStates[round % 2];
+
+        auto start = std::chrono::steady_clock::now();
+        singleCache.project(viewState, frameSize, true);
+        singleStage.add(BenchSince(start));
+
+        start = std::chrono::steady_clock::now();
+        pooledCache.project(viewState, frameSize, true);
+        pooledStage.add(BenchSince(start));
+
+        // Starts its threads from scratch
+        ScreenProjectionCache freshCache;
+        freshCache.setMaxThreads(numThreads);
+        fillCache(freshCache);
+        start = std::chrono::steady_clock::now();
+        freshCache.project(viewState, frameSize, true);
+        freshStage.add(BenchSince(start));
+
+        for (int offi=0;offi<singleCache.getNumOffsets();offi++)
+            for (int ii=0;ii<numPoints;ii++)
+                if (singleCache.getScreenPt(ii,offi) != pooledCache.getScreenPt(ii,offi) ||
+                    singleCache.isFacing(ii,offi) != pooledCache.isFacing(ii,offi))
+                    mismatches++;
+    }
+
+    printf("%d points, %d threads, %u hardware threads\n", numPoints, numThreads, std::thread::hardware_concurrency());
+    if (std::thread::hardware_concurrency() < 2)
+        printf("only one hardware thread, so the threaded modes stay on the calling thread\n");
+    printf("\n");
+    printf("%-14s %8s %10s %8s %8s %8s %8s\n", "stage", "count", "total ms", "mean", "p50", "p95", "max");
+    singleStage.report();
+    pooledStage.report();
+    freshStage.report();
+    printf("\nworker pool speedup: %.2fx, %d mismatched projections\n",
+           singleStage.percentile(0.5) / std::max(pooledStage.percentile(0.5),1e-9), mismatches);
+
+    delete scene;
+    delete renderer;
+    delete globeView;
+    delete coordAdapter;
+
+    return mismatches > 0 ? 1 : 0;
+}
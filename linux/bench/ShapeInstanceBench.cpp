@@ -0,0 +1,256 @@
+/*
+ *  ShapeInstanceBench.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <stdio.h>
+#import <stdlib.h>
+#import <atomic>
+#import <chrono>
+#import <random>
+#import <string>
+#import <thread>
+#import <vector>
+#import "WhirlyGlobe.h"
+#import "SceneRenderer_Headless.h"
+#import "GLES_Headless.h"
+#import "BenchSupport.h"
+
+using namespace WhirlyKit;
+
+/** Compares spheres, cylinders and circles built as real geometry against
+    instances of the shared unit meshes (ShapeInfo::instanced).
+
+    For each mode the shapes go in as a number of groups and we time the
+    ShapeManager calls, then the frame that merges the changes.  The drawables
+    added and the GL buffer bytes that result tell us what it costs in memory.
+
+    After that a few threads add instanced shapes at once, all sharing one new
+    unit mesh.  Their changes go to the scene in the order they finish, with a
+    frame after each, and every instance has to find its master drawable.
+    We fail if one doesn't.
+  */
+
+static const char *BenchUsage =
+"usage: wgmaply_shapebench [options]\n"
+"  --shapes N       Shapes per mode (20000)\n"
+"  --groups N       ShapeManager calls they're split across (50)\n"
+"  --samples N      Tesselation of each shape (16)\n"
+"  --threads N      Threads adding at once for the master drawable check (4)\n"
+"  --rounds N       Times to run the master drawable check (20)\n";
+
+// A mix of the shapes that can be instanced, scattered over the globe
+static std::vector<Shape *> MakeShapes(std::mt19937 &rng,int numShapes,int samples)
+{
+    std::uniform_real_distribution<double> lon(-M_PI,M_PI),lat(-M_PI/3.0,M_PI/3.0),size(0.0005,0.005);
+    std::vector<Shape *> shapes;
+    for (int ii=0;ii<numShapes;ii++)
+    {
+        const GeoCoord loc(lon(rng),lat(rng));
+        switch (ii % 3)
+        {
+            case 0:
+            {
+                Sphere *sphere = new Sphere();
+                sphere->loc = loc;
+                sphere->radius = size(rng);
+                sphere->sampleX = sphere->sampleY = samples;
+                shapes.push_back(sphere);
+            }
+                break;
+            case 1:
+            {
+                Cylinder *cyl = new Cylinder();
+                cyl->loc = loc;
+                cyl->radius = size(rng);
+                cyl->height = 2.0 * cyl->radius;
+                cyl->sampleX = samples;
+                shapes.push_back(cyl);
+            }
+                break;
+            default:
+            {
+                Circle *circle = new Circle();
+                circle->loc = loc;
+                circle->radius = size(rng);
+                circle->sampleX = samples;
+                shapes.push_back(circle);
+            }
+                break;
+        }
+    }
+    return shapes;
+}
+
+static int CountAdds(const ChangeSet &changes)
+{
+    int count = 0;
+    for (auto change : changes)
+        if (dynamic_cast<AddDrawableReq *>(change))
+            count++;
+    return count;
+}
+
+// Master drawables the instances in the changes point to
+static void FindMasters(const ChangeSet &changes,SimpleIDSet &masterIDs)
+{
+    for (auto change : changes)
+        if (AddDrawableReq *req = dynamic_cast<AddDrawableReq *>(change))
+            if (BasicDrawableInstance *drawInst = dynamic_cast<BasicDrawableInstance *>(req->getDrawable().get()))
+                masterIDs.insert(drawInst->getMasterID());
+}
+
+int main(int argc,char *argv[])
+{
+    int numShapes = 20000;
+    int numGroups = 50;
+    int samples = 16;
+    int numThreads = 4;
+    int rounds = 20;
+    for (int ii=1;ii<argc;ii++)
+    {
+        const std::string arg = argv[ii];
+        if (arg == "--shapes" && ii+1 < argc)
+            numShapes = std::max(1,atoi(argv[++ii]));
+        else if (arg == "--groups" && ii+1 < argc)
+            numGroups = std::max(1,atoi(argv[++ii]));
+        else if (arg == "--samples" && ii+1 < argc)
+            samples = std::max(3,atoi(argv[++ii]));
+        else if (arg == "--threads" && ii+1 < argc)
+            numThreads = std::max(2,atoi(argv[++ii]));
+        else if (arg == "--rounds" && ii+1 < argc)
+            rounds = std::max(1,atoi(argv[++ii]));
+        else {
+            fprintf(stderr, "%s", BenchUsage);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    // Same setup as a globe on the platforms
+    CoordSystemDisplayAdapter *coordAdapter = new FakeGeocentricDisplayAdapter();
+    WhirlyGlobe::GlobeView *globeView = new WhirlyGlobe::GlobeView(coordAdapter);
+    SceneRendererGLES_Headless *renderer = new SceneRendererGLES_Headless(1024, 768);
+    SceneGLES *scene = new SceneGLES(coordAdapter);
+    renderer->setScene(scene);
+    renderer->setView(globeView);
+    BenchAddPrograms(scene, renderer);
+    scene->addProgram(ProgramRef(BuildDefaultTriShaderModelGLES(MaplyDefaultModelTriShader,renderer)));
+    Program *triProg = scene->findProgramByName(MaplyDefaultTriangleShader);
+    ShapeManager *shapeManager = (ShapeManager *)scene->getManager(kWKShapeManager);
+    renderer->render(1/60.0);
+
+    printf("shapes: %d in %d groups, %d samples, a third each spheres, cylinders and circles\n\n", numShapes, numGroups, samples);
+    printf("%-10s %10s %10s %10s %10s %12s %12s\n", "mode", "build ms", "merge ms", "remove ms", "drawables", "GL MB", "upload MB");
+
+    for (int instanced=0;instanced<2;instanced++)
+    {
+        ShapeInfo shapeInfo;
+        shapeInfo.instanced = instanced;
+        shapeInfo.color = RGBAColor(255,128,0,255);
+        if (triProg)
+            shapeInfo.programID = triProg->getId();
+
+        // Same shapes for both modes
+        std::mt19937 rng(1);
+        const GLESHeadlessStats before = GLESHeadlessGetStats();
+        double buildMs = 0.0;
+        int numDrawables = 0;
+        SimpleIDSet shapeIDs;
+        ChangeSet changes;
+        for (int group=0;group<numGroups;group++)
+        {
+            const int count = numShapes / numGroups + (group < numShapes % numGroups ? 1 : 0);
+            std::vector<Shape *> shapes = MakeShapes(rng, count, samples);
+            const auto start = std::chrono::steady_clock::now();
+            shapeIDs.insert(shapeManager->addShapes(shapes, shapeInfo, changes));
+            buildMs += BenchSince(start);
+            for (auto shape : shapes)
+                delete shape;
+        }
+        numDrawables = CountAdds(changes);
+        scene->addChangeRequests(changes);
+
+        auto start = std::chrono::steady_clock::now();
+        renderer->render(1/60.0);
+        const double mergeMs = BenchSince(start);
+        const GLESHeadlessStats after = GLESHeadlessGetStats();
+
+        start = std::chrono::steady_clock::now();
+        ChangeSet remChanges;
+        shapeManager->removeShapes(shapeIDs, remChanges);
+        scene->addChangeRequests(remChanges);
+        renderer->render(1/60.0);
+        const double removeMs = BenchSince(start);
+
+        printf("%-10s %10.1f %10.1f %10.1f %10d %12.2f %12.2f\n", instanced ? "instanced" : "geometry",
+               buildMs, mergeMs, removeMs, numDrawables,
+               ((double)after.bufferBytes - (double)before.bufferBytes) / (1024.0*1024.0),
+               (after.bufferUploadBytes - before.bufferUploadBytes) / (1024.0*1024.0));
+    }
+
+    // Threads racing to be the one that makes a new unit mesh
+    ShapeInfo shapeInfo;
+    shapeInfo.instanced = true;
+    int numMissing = 0;
+    for (int round=0;round<rounds;round++)
+    {
+        std::vector<ChangeSet> threadChanges(numThreads);
+        std::vector<SimpleIdentity> threadShapeIDs(numThreads);
+        std::vector<int> finishOrder(numThreads);
+        std::atomic<int> numFinished(0);
+        std::vector<std::thread> threads;
+        for (int which=0;which<numThreads;which++)
+            threads.push_back(std::thread([&,which]{
+                std::mt19937 rng(round * numThreads + which);
+                // New tesselation each round, so the mesh has to be made again
+                std::vector<Shape *> shapes = MakeShapes(rng, 30, samples + 1 + round);
+                threadShapeIDs[which] = shapeManager->addShapes(shapes, shapeInfo, threadChanges[which]);
+                for (auto shape : shapes)
+                    delete shape;
+                finishOrder[numFinished++] = which;
+            }));
+        for (auto &thread : threads)
+            thread.join();
+
+        SimpleIDSet roundShapeIDs;
+        for (int which : finishOrder)
+        {
+            SimpleIDSet masterIDs;
+            FindMasters(threadChanges[which], masterIDs);
+            scene->addChangeRequests(threadChanges[which]);
+            renderer->render(1/60.0);
+            for (auto masterID : masterIDs)
+                if (!scene->getDrawable(masterID))
+                    numMissing++;
+            roundShapeIDs.insert(threadShapeIDs[which]);
+        }
+
+        ChangeSet remChanges;
+        shapeManager->removeShapes(roundShapeIDs, remChanges);
+        scene->addChangeRequests(remChanges);
+        renderer->render(1/60.0);
+    }
+    printf("\nmaster drawable check: %d rounds of %d threads, %d instance drawables without their master\n", rounds, numThreads, numMissing);
+
+    delete scene;
+    delete renderer;
+    delete globeView;
+    delete coordAdapter;
+
+    return numMissing > 0 ? 1 : 0;
+}
@@ -0,0 +1,239 @@
+/*
+ *  TesselatorBench.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <stdio.h>
+#import <stdlib.h>
+#import <math.h>
+#import <chrono>
+#import <random>
+#import <string>
+#import <vector>
+#import "WhirlyGlobe.h"
+#import "Tesselator.h"
+#import "BenchSupport.h"
+
+using namespace WhirlyKit;
+
+/** Runs a fixed polygon corpus through the ear clipper and libtess.
+
+    Wherever the ear clipper accepts a polygon we compare its area against
+    what libtess made of the same loops and fail if they differ.  We also count
+    how often the ear clipper turns a polygon down, which is when TesselateLoops
+    falls back to libtess, and time both paths and the combined one.
+  */
+
+static const char *BenchUsage =
+"usage: wgmaply_tessbench [options]\n"
+"  --count N        Polygons of each kind (200)\n"
+"  --repeat N       Passes over the corpus per timing (5)\n"
+"  --seed N         Corpus seed (1)\n";
+
+// Same sort of numbers we see for geographic data in radians
+static const double CorpusRadius = 0.01;
+
+// Libtess works in float, scaled, so we don't expect much better than this
+static const double AreaTolerance = 1e-3;
+
+class TessBenchKind
+{
+public:
+    TessBenchKind(const char *name) : name(name), fallbacks(0) { }
+
+    const char *name;
+    std::vector<std::vector<VectorRing> > polys;
+    int fallbacks;
+};
+
+// A lumpy ring around the center.  Angles only go one way, so it doesn't cross itself.
+static VectorRing MakeBlob(std::mt19937 &rng,const Point2d &center,double radius,int numPts,double lumpiness,bool clockwise)
+{
+    std::uniform_real_distribution<double> unit(0.0,1.0);
+    VectorRing ring;
+    ring.reserve(numPts+1);
+    for (int ii=0;ii<numPts;ii++)
+    {
+        const double ang = (clockwise ? -2.0 : 2.0) * M_PI * ii / numPts;
+        const double rad = radius * (1.0 - lumpiness * unit(rng));
+        ring.push_back(Point2f(center.x() + rad * cos(ang),center.y() + rad * sin(ang)));
+    }
+    // Closed the way the GeoJSON and shapefile readers hand them to us
+    ring.push_back(ring[0]);
+    return ring;
+}
+
+static void MakeCorpus(int seed,int count,std::vector<TessBenchKind> &kinds)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0,1.0);
+    auto center = [&]{ return Point2d(-2.0 + unit(rng), 0.5 + unit(rng)); };
+
+    kinds.push_back(TessBenchKind("convex"));
+    for (int ii=0;ii<count;ii++)
+        kinds.back().polys.push_back({MakeBlob(rng,center(),CorpusRadius,4+rng()%60,0.0,false)});
+
+    kinds.push_back(TessBenchKind("lumpy"));
+    for (int ii=0;ii<count;ii++)
+        kinds.back().polys.push_back({MakeBlob(rng,center(),CorpusRadius,16+rng()%496,0.5,false)});
+
+    // Holes sit inside the part of the outer ring the lumps can't reach
+    kinds.push_back(TessBenchKind("holes"));
+    for (int ii=0;ii<count;ii++)
+    {
+        const Point2d org = center();
+        std::vector<VectorRing> loops = {MakeBlob(rng,org,CorpusRadius,64+rng()%192,0.3,false)};
+        const int numHoles = 1+rng()%4;
+        for (int hi=0;hi<numHoles;hi++)
+        {
+            const double ang = 2.0 * M_PI * hi / numHoles;
+            const Point2d holeCenter = org + Point2d(cos(ang),sin(ang)) * CorpusRadius * 0.4;
+            loops.push_back(MakeBlob(rng,holeCenter,CorpusRadius*0.15,8+rng()%24,0.3,true));
+        }
+        kinds.back().polys.push_back(loops);
+    }
+
+    // Figure eights.  The ear clipper gets the area wrong and we fall back.
+    kinds.push_back(TessBenchKind("crossed"));
+    for (int ii=0;ii<count;ii++)
+    {
+        const Point2d org = center();
+        const int numPts = 8+rng()%56;
+        VectorRing ring;
+        for (int pi=0;pi<numPts;pi++)
+        {
+            const double t = 2.0 * M_PI * pi / numPts;
+            ring.push_back(Point2f(org.x() + CorpusRadius * sin(t),org.y() + CorpusRadius * sin(t) * cos(t)));
+        }
+        ring.push_back(ring[0]);
+        kinds.back().polys.push_back({ring});
+    }
+
+    // A hole that wandered outside the outer ring, which bad data does
+    kinds.push_back(TessBenchKind("stray hole"));
+    for (int ii=0;ii<count;ii++)
+    {
+        const Point2d org = center();
+        const Point2d holeCenter = org + Point2d(CorpusRadius * 0.9,0.0);
+        kinds.back().polys.push_back({MakeBlob(rng,org,CorpusRadius,32+rng()%96,0.2,false),
+                                      MakeBlob(rng,holeCenter,CorpusRadius*0.3,8+rng()%24,0.0,true)});
+    }
+}
+
+static double TriangleArea(const VectorTrianglesRef &tris)
+{
+    double area = 0.0;
+    for (const auto &tri : tris->tris)
+    {
+        const Point3f &a = tris->pts[tri.pts[0]], &b = tris->pts[tri.pts[1]], &c = tris->pts[tri.pts[2]];
+        area += fabs(((double)b.x()-a.x())*((double)c.y()-a.y()) - ((double)b.y()-a.y())*((double)c.x()-a.x())) / 2.0;
+    }
+    return area;
+}
+
+static void ClearTriangles(const VectorTrianglesRef &tris)
+{
+    tris->pts.clear();
+    tris->tris.clear();
+}
+
+// Polygons per second for repeat passes over the given polygons
+template<typename Func> static double TimePolygons(int repeat,const std::vector<std::vector<VectorRing> > &polys,Func func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int ii=0;ii<repeat;ii++)
+        for (const auto &loops : polys)
+            func(loops);
+    const double ms = BenchSince(start);
+    return ms > 0.0 ? (double)polys.size() * repeat / (ms / 1000.0) : 0.0;
+}
+
+int main(int argc,char *argv[])
+{
+    int count = 200;
+    int repeat = 5;
+    int seed = 1;
+    for (int ii=1;ii<argc;ii++)
+    {
+        const std::string arg = argv[ii];
+        if (arg == "--count" && ii+1 < argc)
+            count = std::max(1,atoi(argv[++ii]));
+        else if (arg == "--repeat" && ii+1 < argc)
+            repeat = std::max(1,atoi(argv[++ii]));
+        else if (arg == "--seed" && ii+1 < argc)
+            seed = atoi(argv[++ii]);
+        else {
+            fprintf(stderr, "%s", BenchUsage);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    std::vector<TessBenchKind> kinds;
+    MakeCorpus(seed,count,kinds);
+
+    // Check the ear clipper against libtess wherever it says it did the job
+    VectorTrianglesRef earTris = VectorTriangles::createTriangles();
+    VectorTrianglesRef libTris = VectorTriangles::createTriangles();
+    int mismatches = 0;
+    for (auto &kind : kinds)
+    {
+        for (unsigned int pi=0;pi<kind.polys.size();pi++)
+        {
+            ClearTriangles(earTris);
+            ClearTriangles(libTris);
+            const bool accepted = TesselateLoopsEarcut(kind.polys[pi],earTris);
+            TesselateLoopsLibtess(kind.polys[pi],libTris);
+            if (!accepted)
+            {
+                kind.fallbacks++;
+                continue;
+            }
+            const double earArea = TriangleArea(earTris), libArea = TriangleArea(libTris);
+            if (fabs(earArea - libArea) > AreaTolerance * libArea)
+            {
+                fprintf(stderr, "%s %d: ear clipper area %g, libtess area %g\n", kind.name, pi, earArea, libArea);
+                mismatches++;
+            }
+        }
+    }
+
+    VectorTrianglesRef tris = VectorTriangles::createTriangles();
+    printf("%-10s %6s %9s %12s %12s %12s   (polygons/s)\n", "kind", "count", "fallback", "earcut", "libtess", "combined");
+    for (const auto &kind : kinds)
+    {
+        // Ear clipper times include the ones it gives up on, since we pay for those too
+        const double earRate = TimePolygons(repeat, kind.polys, [&](const std::vector<VectorRing> &loops){
+            ClearTriangles(tris);
+            TesselateLoopsEarcut(loops,tris);
+        });
+        const double libRate = TimePolygons(repeat, kind.polys, [&](const std::vector<VectorRing> &loops){
+            ClearTriangles(tris);
+            TesselateLoopsLibtess(loops,tris);
+        });
+        const double combinedRate = TimePolygons(repeat, kind.polys, [&](const std::vector<VectorRing> &loops){
+            ClearTriangles(tris);
+            TesselateLoops(loops,tris);
+        });
+        printf("%-10s %6d %9d %12.0f %12.0f %12.0f\n", kind.name, (int)kind.polys.size(), kind.fallbacks,
+               earRate, libRate, combinedRate);
+    }
+
+    if (mismatches > 0)
+        fprintf(stderr, "%d polygons where the ear clipper and libtess disagree on area\n", mismatches);
+    return mismatches > 0 ? 1 : 0;
+}
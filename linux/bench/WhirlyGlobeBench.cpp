@@ -0,0 +1,405 @@
+/*
+ *  WhirlyGlobeBench.cpp
+ *  WhirlyGlobeLib
+ *
+ *  Created by Steve Gifford on 10/19/26.
+ *  Copyright 2011-2020 mousebird consulting.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#import <stdio.h>
+#import <stdlib.h>
+#import <string.h>
+#import <algorithm>
+#import <chrono>
+#import <map>
+#import <string>
+#import <vector>
+#import "WhirlyGlobe.h"
+#import "GLES_Headless.h"
+#import "SceneRenderer_Headless.h"
+#import "MapboxVectorStyleSet_Headless.h"
+#import "Dictionary_Android.h"
+#import "BenchSupport.h"
+
+using namespace WhirlyKit;
+
+/** Replays a camera path over a map of vector (and optionally image) tiles
+    and reports how long each stage of the engine took.
+
+    Everything runs on one thread (plus any --prepare-threads), in the same order every time, with the scene
+    clock driven by the frame number.  Two runs over the same tiles do the same work.
+
+    Tiles come from a directory laid out as {z}/{x}/{y}.mvt (or .pbf, gzipped or not)
+    or are synthesized if there isn't one.  Image tiles are always synthesized,
+    since there's no image decoder in the toolkit itself.
+  */
+
+static const char *BenchUsage =
+"usage: wgmaply_bench [options]\n"
+"  --tiles DIR      Read vector tiles from DIR/{z}/{x}/{y}.mvt (or .pbf).  Synthesized if missing.\n"
+"  --style FILE     Mapbox GL style JSON.  A built in style matching the synthetic tiles by default.\n"
+"  --frames N       Number of frames in the camera path (600)\n"
+"  --size WxH       Framebuffer size (1024x768)\n"
+"  --lon L --lat L  Where the camera path is centered, in degrees (-0.1276, 51.5072)\n"
+"  --minzoom Z      Zoom level at the ends of the path (3)\n"
+"  --maxzoom Z      Zoom level in the middle of the path (14)\n"
+"  --images         Overlay synthesized image tiles\n"
+"  --seed N         Seed for the synthetic tiles (1)\n"
+"  --no-sub-buffers Give each drawable its own GL buffer rather than packing them into shared ones\n"
+"  --prepare-threads N  Build drawable buffers and convert textures on N threads ahead of the renderer (0)\n"
+"  --trace FILE     Write a Chrome trace of the run\n";
+
+class BenchOptions
+{
+public:
+    BenchOptions()
+    : numFrames(600), width(1024), height(768), lon(-0.1276), lat(51.5072),
+      minZoom(3), maxZoom(14), images(false), subBuffers(true), prepareThreads(0), seed(1) { }
+
+    std::string tileDir,styleFile,traceFile;
+    int numFrames;
+    int width,height;
+    double lon,lat;
+    int minZoom,maxZoom;
+    bool images;
+    bool subBuffers;
+    int prepareThreads;
+    int seed;
+};
+
+static bool ParseOptions(int argc,char *argv[],BenchOptions &opts)
+{
+    for (int ii=1;ii<argc;ii++)
+    {
+        const std::string arg = argv[ii];
+        const char *next = (ii+1 < argc) ? argv[ii+1] : NULL;
+        bool usedNext = true;
+        if (arg == "--images")
+        {
+            opts.images = true;
+            usedNext = false;
+        } else if (arg == "--no-sub-buffers") {
+            opts.subBuffers = false;
+            usedNext = false;
+        } else if (arg == "--help" || arg == "-h" || !next) {
+            return false;
+        } else if (arg == "--tiles") {
+            opts.tileDir = next;
+        } else if (arg == "--style") {
+            opts.styleFile = next;
+        } else if (arg == "--trace") {
+            opts.traceFile = next;
+        } else if (arg == "--frames") {
+            opts.numFrames = std::max(1,atoi(next));
+        } else if (arg == "--size") {
+            if (sscanf(next, "%dx%d", &opts.width, &opts.height) != 2 || opts.width <= 0 || opts.height <= 0)
+                return false;
+        } else if (arg == "--lon") {
+            opts.lon = atof(next);
+        } else if (arg == "--lat") {
+            opts.lat = atof(next);
+        } else if (arg == "--minzoom") {
+            opts.minZoom = atoi(next);
+        } else if (arg == "--maxzoom") {
+            opts.maxZoom = atoi(next);
+        } else if (arg == "--seed") {
+            opts.seed = atoi(next);
+        } else if (arg == "--prepare-threads") {
+            opts.prepareThreads = std::max(0,atoi(next));
+        } else
+            return false;
+        if (usedNext)
+            ii++;
+    }
+
+    opts.minZoom = std::max(0,std::min(opts.minZoom,22));
+    opts.maxZoom = std::max(opts.minZoom,std::min(opts.maxZoom,22));
+    return true;
+}
+
+/// What we've got for a tile that's on screen
+class BenchTile
+{
+public:
+    BenchTile() : chunkID(EmptyIdentity), texID(EmptyIdentity) { }
+
+    VectorTileDataRef tileData;
+    SimpleIdentity chunkID,texID;
+};
+
+int main(int argc,char *argv[])
+{
+    BenchOptions opts;
+    if (!ParseOptions(argc, argv, opts))
+    {
+        fprintf(stderr, "%s", BenchUsage);
+        return 1;
+    }
+    if (!opts.traceFile.empty())
+        FrameTrace::setEnabled(true);
+
+    // Same setup as a flat map on the platforms
+    CoordSystemDisplayAdapter *coordAdapter = new SphericalMercatorDisplayAdapter(0.0, GeoCoord::CoordFromDegrees(-180,-90), GeoCoord::CoordFromDegrees(180,90));
+    CoordSystem *coordSys = coordAdapter->getCoordSystem();
+    Maply::MapView *mapView = new Maply::MapView(coordAdapter);
+    SceneRendererGLES_Headless *renderer = new SceneRendererGLES_Headless(opts.width, opts.height);
+    SceneGLES *scene = new SceneGLES(coordAdapter);
+    scene->getMemManager()->setUseSubBuffers(opts.subBuffers);
+    renderer->setScene(scene);
+    scene->setPrepareThreads(opts.prepareThreads);
+    renderer->setView(mapView);
+    renderer->setClearColor(RGBAColor(242,239,233,255));
+
+    // The shaders the style needs
+    BenchAddPrograms(scene, renderer);
+    Program *imageProg = scene->findProgramByName(MaplyDefaultTriMultiTexShader);
+
+    // Style
+    std::string styleJSON = BenchDefaultStyle;
+    if (!opts.styleFile.empty())
+    {
+        std::vector<unsigned char> styleData;
+        if (!ReadTileFile(opts.styleFile, styleData))
+        {
+            fprintf(stderr, "Can't read style %s\n", opts.styleFile.c_str());
+            return 1;
+        }
+        styleJSON = std::string(styleData.begin(),styleData.end());
+    }
+    PlatformThreadInfo threadInfo;
+    MutableDictionary_AndroidRef styleDict(new MutableDictionary_Android());
+    if (!styleDict->parseJSON(styleJSON))
+    {
+        fprintf(stderr, "Can't parse style JSON\n");
+        return 1;
+    }
+    MapboxVectorStyleSetImpl_HeadlessRef styleSet(new MapboxVectorStyleSetImpl_Headless(scene,coordSys,VectorStyleSettingsImplRef(new VectorStyleSettingsImpl(1.0))));
+    if (!styleSet->parse(&threadInfo, styleDict))
+    {
+        fprintf(stderr, "Can't set up style\n");
+        return 1;
+    }
+    MapboxVectorTileParser parser(styleSet);
+    parser.localCoords = false;
+
+    ComponentManager *compManager = (ComponentManager *)scene->getManager(kWKComponentManager);
+    LayoutManager *layoutManager = (LayoutManager *)scene->getManager(kWKLayoutManager);
+    SphericalChunkManager *chunkManager = (SphericalChunkManager *)scene->getManager(kWKSphericalChunkManager);
+    SyntheticTileSource synthSource(opts.seed);
+
+    BenchStage loadStage("load"), parseStage("parse+build"), imageStage("image build"), removeStage("remove");
+    BenchStage layoutStage("layout"), renderStage("render"), frameStage("frame");
+    int tilesLoaded = 0, tilesMissing = 0, tilesRemoved = 0, maxTilesVisible = 0;
+
+    std::map<QuadTreeIdentifier,BenchTile> tiles;
+    const double tanHalfFov = tan(mapView->fieldOfView / 2.0);
+    const Point3d center = coordAdapter->localToDisplay(coordSys->geographicToLocal3d(GeoCoord::CoordFromDegrees(opts.lon, opts.lat)));
+    GLESHeadlessResetCounts();
+
+    for (int frame=0;frame<opts.numFrames;frame++)
+    {
+        const auto frameStart = std::chrono::steady_clock::now();
+        const double t = opts.numFrames > 1 ? frame / (double)(opts.numFrames-1) : 0.0;
+
+        // Zoom in for the first third, pan across at the bottom for the middle third, and back out
+        double zoom,pan;
+        if (t < 1.0/3.0)
+        {
+            zoom = opts.minZoom + (opts.maxZoom - opts.minZoom) * (t * 3.0);
+            pan = 0.0;
+        } else if (t < 2.0/3.0) {
+            zoom = opts.maxZoom;
+            pan = (t - 1.0/3.0) * 3.0;
+        } else {
+            zoom = opts.maxZoom - (opts.maxZoom - opts.minZoom) * ((t - 2.0/3.0) * 3.0);
+            pan = 1.0;
+        }
+        // Pan across 8 tiles at the deepest level
+        const double tileSpan = 2.0 * M_PI / (1 << opts.maxZoom);
+        const Point3d loc(center.x() + pan * 8.0 * tileSpan, center.y() + pan * 3.0 * tileSpan, 0.0);
+        // Height that shows the screen width worth of 256 pixel tiles at this zoom
+        const double viewWidth = 2.0 * M_PI / pow(2.0,zoom) * opts.width / 256.0;
+        mapView->setLoc(Point3d(loc.x(), loc.y(), viewWidth / (2.0 * tanHalfFov)));
+        scene->setCurrentTime(1.0 + frame / 60.0);
+
+        // Tiles that cover the screen at this level
+        const int level = std::max(0,std::min((int)floor(zoom + 0.5),opts.maxZoom));
+        const int numTiles = 1 << level;
+        const double tileSize = 2.0 * M_PI / numTiles;
+        const double halfWidth = viewWidth / 2.0, halfHeight = halfWidth * opts.height / opts.width;
+        const int minX = std::max(0,(int)floor((loc.x() - halfWidth + M_PI) / tileSize));
+        const int maxX = std::min(numTiles-1,(int)floor((loc.x() + halfWidth + M_PI) / tileSize));
+        const int minY = std::max(0,(int)floor((loc.y() - halfHeight + M_PI) / tileSize));
+        const int maxY = std::min(numTiles-1,(int)floor((loc.y() + halfHeight + M_PI) / tileSize));
+        std::set<QuadTreeIdentifier> wanted;
+        for (int ix=minX;ix<=maxX;ix++)
+            for (int iy=minY;iy<=maxY;iy++)
+                wanted.insert(QuadTreeIdentifier(ix,iy,level));
+        maxTilesVisible = std::max(maxTilesVisible,(int)wanted.size());
+
+        ChangeSet changes;
+
+        // Get rid of what's no longer on screen
+        for (auto it = tiles.begin();it != tiles.end();)
+        {
+            if (wanted.find(it->first) != wanted.end())
+            {
+                ++it;
+                continue;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            compManager->removeComponentObjects(&threadInfo, it->second.tileData->compObjs, changes);
+            if (it->second.chunkID != EmptyIdentity)
+            {
+                SimpleIDSet chunkIDs = {it->second.chunkID};
+                chunkManager->removeChunks(chunkIDs, changes);
+                changes.push_back(new RemTextureReq(it->second.texID));
+            }
+            removeStage.add(BenchSince(start));
+            tilesRemoved++;
+            it = tiles.erase(it);
+        }
+
+        // Load up anything new
+        for (const QuadTreeIdentifier &ident : wanted)
+        {
+            if (tiles.find(ident) != tiles.end())
+                continue;
+            BenchTile &tile = tiles[ident];
+
+            auto start = std::chrono::steady_clock::now();
+            std::vector<unsigned char> data;
+            if (!opts.tileDir.empty())
+            {
+                // The directory is in the usual web (top down) order
+                const std::string base = opts.tileDir + "/" + std::to_string(ident.level) + "/" + std::to_string(ident.x) + "/" +
+                                         std::to_string(numTiles - 1 - ident.y);
+                if (!ReadTileFile(base + ".mvt", data) && !ReadTileFile(base + ".pbf", data))
+                    tilesMissing++;
+            } else
+                data = synthSource.makeTile(ident);
+            loadStage.add(BenchSince(start));
+
+            const MbrD mbr(Point2d(ident.x * tileSize - M_PI,ident.y * tileSize - M_PI),
+                           Point2d((ident.x+1) * tileSize - M_PI,(ident.y+1) * tileSize - M_PI));
+            tile.tileData = VectorTileDataRef(new VectorTileData());
+            tile.tileData->ident = ident;
+            tile.tileData->bbox = mbr;
+            const GeoCoord geoLL = coordSys->localToGeographic(Point3d(mbr.ll().x(),mbr.ll().y(),0.0));
+            const GeoCoord geoUR = coordSys->localToGeographic(Point3d(mbr.ur().x(),mbr.ur().y(),0.0));
+            tile.tileData->geoBBox = MbrD(Point2d(geoLL.x(),geoLL.y()),Point2d(geoUR.x(),geoUR.y()));
+            if (!data.empty())
+            {
+                start = std::chrono::steady_clock::now();
+                RawDataWrapper rawData(data.data(),data.size(),false);
+                parser.parse(&threadInfo, &rawData, tile.tileData.get());
+                changes.insert(changes.end(), tile.tileData->changes.begin(), tile.tileData->changes.end());
+                tile.tileData->changes.clear();
+                parseStage.add(BenchSince(start));
+                tilesLoaded++;
+            }
+
+            if (opts.images && chunkManager)
+            {
+                start = std::chrono::steady_clock::now();
+                // A gradient that differs per tile, so nothing can be shared
+                const int texSize = 256;
+                std::vector<unsigned char> pixels(texSize*texSize*4);
+                for (int iy=0;iy<texSize;iy++)
+                    for (int ix=0;ix<texSize;ix++)
+                    {
+                        unsigned char *pix = &pixels[(iy*texSize+ix)*4];
+                        pix[0] = (unsigned char)(ix + ident.x * 37);
+                        pix[1] = (unsigned char)(iy + ident.y * 53);
+                        pix[2] = (unsigned char)(ident.level * 17);
+                        pix[3] = 255;
+                    }
+                TextureGLES *tex = new TextureGLES("Bench Image Tile",RawDataRef(new MutableRawData(pixels.data(),(unsigned int)pixels.size())),false);
+                tex->setWidth(texSize);
+                tex->setHeight(texSize);
+                tile.texID = tex->getId();
+                changes.push_back(new AddTextureReq(tex));
+
+                SphericalChunk chunk;
+                chunk.mbr = Mbr(Point2f(geoLL.x(),geoLL.y()),Point2f(geoUR.x(),geoUR.y()));
+                chunk.texIDs.push_back(tile.texID);
+                SphericalChunkInfo chunkInfo;
+                chunkInfo.drawPriority = 0;
+                if (imageProg)
+                    chunkInfo.programID = imageProg->getId();
+                tile.chunkID = chunkManager->addChunks({chunk}, chunkInfo, changes);
+                imageStage.add(BenchSince(start));
+            }
+        }
+        scene->addChangeRequests(changes);
+
+        // Layout normally runs on its own schedule, here it's every frame
+        if (layoutManager)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            ChangeSet layoutChanges;
+            layoutManager->updateLayout(mapView->getViewState(renderer), layoutChanges);
+            scene->addChangeRequests(layoutChanges);
+            layoutStage.add(BenchSince(start));
+        }
+
+        // Renders and merges all those changes
+        const auto renderStart = std::chrono::steady_clock::now();
+        renderer->render(1/60.0);
+        renderStage.add(BenchSince(renderStart));
+
+        frameStage.add(BenchSince(frameStart));
+    }
+
+    const GLESHeadlessStats stats = GLESHeadlessGetStats();
+    printf("wgmaply_bench: %d frames at %dx%d, zoom %d to %d, %s tiles%s\n", opts.numFrames, opts.width, opts.height,
+           opts.minZoom, opts.maxZoom, opts.tileDir.empty() ? "synthetic" : opts.tileDir.c_str(), opts.images ? " plus images" : "");
+    printf("tiles: %d loaded, %d missing, %d removed, %d visible at most\n\n", tilesLoaded, tilesMissing, tilesRemoved, maxTilesVisible);
+    printf("%-14s %8s %10s %8s %8s %8s %8s\n", "stage", "count", "total ms", "mean", "p50", "p95", "max");
+    for (const BenchStage *stage : {&loadStage,&parseStage,&imageStage,&removeStage,&layoutStage,&renderStage,&frameStage})
+        stage->report();
+    printf("\nGL: %.1f draw calls/frame, %.0f primitives/frame, %llu calls total\n",
+           stats.drawCalls / (double)opts.numFrames, stats.primitives / (double)opts.numFrames, (unsigned long long)stats.calls);
+    printf("GL uploads: %.1f MB buffers, %.1f MB textures\n", stats.bufferUploadBytes / (1024.0*1024.0), stats.textureUploadBytes / (1024.0*1024.0));
+    printf("GL resident: %llu buffers (%.1f MB), %llu textures (%.1f MB), %llu programs\n",
+           (unsigned long long)stats.numBuffers, stats.bufferBytes / (1024.0*1024.0),
+           (unsigned long long)stats.numTextures, stats.textureBytes / (1024.0*1024.0), (unsigned long long)stats.numPrograms);
+    const BufferArenaStats arenaStats = scene->getMemManager()->getSubBufferStats();
+    printf("GL shared buffers: %d holding %d drawables, %.1f%% used\n", arenaStats.numArenas, arenaStats.numAllocs, 100.0*arenaStats.utilization());
+    int numPreparedAhead = 0, numPreparedInline = 0;
+    scene->getPrepareStats(numPreparedAhead, numPreparedInline, false);
+    printf("changes prepared: %d on %d threads, %d on the render thread\n", numPreparedAhead, opts.prepareThreads, numPreparedInline);
+    printf("render thread: %.3f ms per tile loaded\n", renderStage.total() / std::max(1,tilesLoaded));
+    printf("frames presented: %d\n", renderer->getNumFramesPresented());
+
+    if (!opts.traceFile.empty())
+    {
+        if (FrameTrace::writeChromeTrace(opts.traceFile))
+            printf("trace written to %s\n", opts.traceFile.c_str());
+        else
+            fprintf(stderr, "Can't write trace to %s\n", opts.traceFile.c_str());
+    }
+
+    // The scene cleans up its own drawables and textures
+    tiles.clear();
+    parser.styleDelegate = NULL;
+    styleSet = NULL;
+    delete scene;
+    delete renderer;
+    delete mapView;
+    delete coordAdapter;
+
+    return 0;
+}